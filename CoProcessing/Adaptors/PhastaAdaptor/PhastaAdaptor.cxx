@@ -21,6 +21,7 @@
 #include "vtkCPAdaptorAPI.h"
 #include "vtkCPDataDescription.h"
 #include "vtkCPInputDataDescription.h"
+#include "vtkCPMappedArrayTemplate.h"
 #include "vtkCPProcessor.h"
 #include "vtkDoubleArray.h"
 #include "vtkFieldData.h"
@@ -136,16 +137,12 @@ extern "C" void addfields(
   //velocity
   if(idd->IsFieldNeeded("velocity"))
     {
-    vtkDoubleArray* velocity = vtkDoubleArray::New();
+    // the velocity components are stored one after the other with a
+    // leading dimension of nshg so wrap them without copying.
+    vtkCPMappedArrayTemplate<double>* velocity =
+      vtkCPMappedArrayTemplate<double>::New();
     velocity->SetName("velocity");
-    velocity->SetNumberOfComponents(3);
-    velocity->SetNumberOfTuples(NumberOfNodes);
-    for (vtkIdType idx=0; idx<NumberOfNodes; idx++)
-      {
-      velocity->SetTuple3(idx, dofArray[idx],
-                          dofArray[idx+ *nshg],
-                          dofArray[idx+ *nshg*2]);
-      }
+    velocity->SetStridedArray(dofArray, NumberOfNodes, 3, 1, *nshg);
     UnstructuredGrid->GetPointData()->AddArray(velocity);
     velocity->Delete();
     }
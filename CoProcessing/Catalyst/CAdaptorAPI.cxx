@@ -15,6 +15,9 @@
 #include "CAdaptorAPI.h"
 
 #include "vtkCPAdaptorAPI.h"
+#include "vtkSetGet.h"
+
+#include <string>
 
 // call at the start of the simulation
 void coprocessorinitialize()
@@ -51,3 +54,39 @@ void coprocess()
 {
   vtkCPAdaptorAPI::CoProcess();
 }
+
+namespace
+{
+  void AddMappedFieldInternal(char* name, int* nameLength,
+    int* association, double* data, int* numTuples, int* numComponents,
+    int* tupleStride, int* componentStride, bool appendChunk)
+    {
+    if(name == NULL || *nameLength <= 0)
+      {
+      vtkGenericWarningMacro("Bad field name or length.");
+      return;
+      }
+    // Fortran strings are not null terminated.
+    std::string fieldName(name, *nameLength);
+    vtkCPAdaptorAPI::AddMappedField(fieldName.c_str(), *association, data,
+      *numTuples, *numComponents, *tupleStride, *componentStride, appendChunk);
+    }
+}
+
+// add a field owned by the simulation without copying it
+void addmappedfield(char* name, int* nameLength,
+  int* association, double* data, int* numTuples, int* numComponents,
+  int* tupleStride, int* componentStride)
+{
+  AddMappedFieldInternal(name, nameLength, association, data, numTuples,
+    numComponents, tupleStride, componentStride, false);
+}
+
+// append a chunk to a field owned by the simulation without copying it
+void addmappedfieldchunk(char* name, int* nameLength,
+  int* association, double* data, int* numTuples, int* numComponents,
+  int* tupleStride, int* componentStride)
+{
+  AddMappedFieldInternal(name, nameLength, association, data, numTuples,
+    numComponents, tupleStride, componentStride, true);
+}
@@ -47,6 +47,24 @@ extern "C" {
   // has been filled in elsewhere.
   void VTKPVCATALYST_EXPORT coprocess();
 
+  // add a double precision field owned by the simulation to the grid
+  // without copying it. association is 0 for point data and 1 for cell
+  // data. value c of tuple i is read from
+  // data[i*tupleStride + c*componentStride], e.g. a Fortran array
+  // a(numTuples,3) uses tupleStride=1 and componentStride=numTuples while
+  // a(3,numTuples) uses tupleStride=3 and componentStride=1. the memory
+  // must stay valid until coprocess() returns.
+  void VTKPVCATALYST_EXPORT addmappedfield(char* name, int* nameLength,
+    int* association, double* data, int* numTuples, int* numComponents,
+    int* tupleStride, int* componentStride);
+
+  // same as addmappedfield() but appends the tuples after the ones of the
+  // field with the same name that was already added this time step. this
+  // is used when a field is stored in several separate allocations.
+  void VTKPVCATALYST_EXPORT addmappedfieldchunk(char* name, int* nameLength,
+    int* association, double* data, int* numTuples, int* numComponents,
+    int* tupleStride, int* componentStride);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
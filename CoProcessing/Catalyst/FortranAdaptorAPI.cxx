@@ -12,12 +12,57 @@
      PURPOSE.  See the above copyright notice for more information.
 
 =========================================================================*/
+#include "FortranAdaptorAPI.h"
+
 // CATALYST_FORTRAN_USING_MANGLING is defined when Fortran names are mangled. If
 // not, then we don't add another implementation for the API routes thus avoid
 // duplicate implementations.
 #ifdef CATALYST_FORTRAN_USING_MANGLING
-
-#include "FortranAdaptorAPI.h"
 #include "CAdaptorAPI.cxx"
-
 #endif
+
+#include "vtkCPAdaptorAPI.h"
+#include "vtkSetGet.h"
+
+#include <string>
+
+namespace
+{
+  void AddMappedFortranFieldInternal(char* name, int* nameLength,
+    int* association, double* data, int* leadingDimension, int* numTuples,
+    int* numComponents, bool appendChunk)
+    {
+    if(name == NULL || *nameLength <= 0)
+      {
+      vtkGenericWarningMacro("Bad field name or length.");
+      return;
+      }
+    if(*leadingDimension < *numTuples)
+      {
+      vtkGenericWarningMacro("Leading dimension of " << *leadingDimension
+        << " is smaller than the number of tuples " << *numTuples << ".");
+      return;
+      }
+    // Fortran strings are not null terminated.
+    std::string fieldName(name, *nameLength);
+    vtkCPAdaptorAPI::AddMappedField(fieldName.c_str(), *association, data,
+      *numTuples, *numComponents, 1, *leadingDimension, appendChunk);
+    }
+}
+
+// add a column-major field owned by the simulation without copying it
+void addmappedfortranfield(char* name, int* nameLength, int* association,
+  double* data, int* leadingDimension, int* numTuples, int* numComponents)
+{
+  AddMappedFortranFieldInternal(name, nameLength, association, data,
+    leadingDimension, numTuples, numComponents, false);
+}
+
+// append a chunk to a column-major field owned by the simulation
+void addmappedfortranfieldchunk(char* name, int* nameLength,
+  int* association, double* data, int* leadingDimension, int* numTuples,
+  int* numComponents)
+{
+  AddMappedFortranFieldInternal(name, nameLength, association, data,
+    leadingDimension, numTuples, numComponents, true);
+}
@@ -26,5 +26,30 @@
 
 #include "CAdaptorAPI.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  // add a column-major double precision field a(leadingDimension,*) owned
+  // by the simulation to the grid without copying it. the first numTuples
+  // rows of the first numComponents columns are used, i.e. value c of tuple
+  // i is a(i+1,c+1). association is 0 for point data and 1 for cell data.
+  // arrays declared as a(numComponents,numTuples) are passed to
+  // addmappedfield() with tupleStride=numComponents and componentStride=1
+  // instead. the memory must stay valid until coprocess() returns.
+  void VTKPVCATALYST_EXPORT addmappedfortranfield(char* name,
+    int* nameLength, int* association, double* data, int* leadingDimension,
+    int* numTuples, int* numComponents);
+
+  // same as addmappedfortranfield() but appends the tuples after the ones of
+  // the field with the same name that was already added this time step.
+  void VTKPVCATALYST_EXPORT addmappedfortranfieldchunk(char* name,
+    int* nameLength, int* association, double* data, int* leadingDimension,
+    int* numTuples, int* numComponents);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
 #endif
 // VTK-HeaderTest-Exclude: FortranAdaptorAPI.h
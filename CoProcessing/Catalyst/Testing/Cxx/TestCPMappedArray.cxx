@@ -0,0 +1,176 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestCPMappedArray.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkCPMappedArrayTemplate exposes SOA, strided and multi-chunk
+// simulation memory with the same values as a packed vtkDoubleArray and that
+// GetVoidPointer() only materializes the data once per modification.
+
+#include "vtkCPMappedArrayTemplate.h"
+#include "vtkDoubleArray.h"
+#include "vtkNew.h"
+
+#include <iostream>
+#include <vector>
+
+namespace
+{
+  const int NumberOfTuples = 10;
+
+  double Expected(vtkIdType tuple, int comp)
+    {
+    return 100.0 * tuple + comp;
+    }
+
+  bool CheckArray(vtkCPMappedArrayTemplate<double>* array, const char* label)
+    {
+    if (array->GetNumberOfTuples() != NumberOfTuples ||
+      array->GetNumberOfComponents() != 3)
+      {
+      std::cerr << label << ": wrong dimensions "
+                << array->GetNumberOfTuples() << "x"
+                << array->GetNumberOfComponents() << std::endl;
+      return false;
+      }
+    double tuple[3];
+    for (vtkIdType i = 0; i < NumberOfTuples; ++i)
+      {
+      array->GetTuple(i, tuple);
+      for (int c = 0; c < 3; ++c)
+        {
+        if (tuple[c] != Expected(i, c) ||
+          array->GetValue(i * 3 + c) != Expected(i, c))
+          {
+          std::cerr << label << ": bad value at tuple " << i
+                    << " component " << c << std::endl;
+          return false;
+          }
+        }
+      }
+    double* contiguous = static_cast<double*>(array->GetVoidPointer(0));
+    for (vtkIdType i = 0; i < NumberOfTuples * 3; ++i)
+      {
+      if (contiguous[i] != Expected(i / 3, i % 3))
+        {
+        std::cerr << label << ": bad contiguous value at " << i << std::endl;
+        return false;
+        }
+      }
+    return true;
+    }
+}
+
+int TestCPMappedArray(int, char*[])
+{
+  // Fortran style a(NumberOfTuples,3).
+  std::vector<double> soa(NumberOfTuples * 3);
+  // Array of structures with one extra padding value per tuple.
+  std::vector<double> aos(NumberOfTuples * 4);
+  for (vtkIdType i = 0; i < NumberOfTuples; ++i)
+    {
+    for (int c = 0; c < 3; ++c)
+      {
+      soa[c * NumberOfTuples + i] = Expected(i, c);
+      aos[i * 4 + c] = Expected(i, c);
+      }
+    aos[i * 4 + 3] = -1;
+    }
+
+  vtkNew<vtkCPMappedArrayTemplate<double> > array;
+
+  std::vector<double*> components;
+  for (int c = 0; c < 3; ++c)
+    {
+    components.push_back(&soa[c * NumberOfTuples]);
+    }
+  array->SetSOAArrays(components, NumberOfTuples);
+  if (!CheckArray(array.GetPointer(), "SOA"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  array->SetStridedArray(&soa[0], NumberOfTuples, 3, 1, NumberOfTuples);
+  if (!CheckArray(array.GetPointer(), "Fortran"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  array->SetStridedArray(&aos[0], NumberOfTuples, 3, 4, 1);
+  if (!CheckArray(array.GetPointer(), "AOS"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Split the tuples over two chunks of different layouts.
+  const int split = 4;
+  array->SetStridedArray(&aos[0], split, 3, 4, 1);
+  std::vector<double*> tail;
+  for (int c = 0; c < 3; ++c)
+    {
+    tail.push_back(&soa[c * NumberOfTuples + split]);
+    }
+  array->AddSOAChunk(tail, NumberOfTuples - split);
+  if (array->GetNumberOfChunks() != 2 ||
+    !CheckArray(array.GetPointer(), "Chunks"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Range and lookup queries walk across the chunk boundary.
+  vtkNew<vtkDoubleArray> range;
+  range->SetNumberOfComponents(3);
+  range->SetNumberOfTuples(NumberOfTuples);
+  array->GetTuples(0, NumberOfTuples - 1, range.GetPointer());
+  for (vtkIdType i = 0; i < NumberOfTuples * 3; ++i)
+    {
+    if (range->GetValue(i) != Expected(i / 3, i % 3))
+      {
+      std::cerr << "GetTuples: bad value at " << i << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  if (array->LookupValue(Expected(split + 1, 2)) != (split + 1) * 3 + 2)
+    {
+    std::cerr << "LookupValue failed across chunks." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Repeated requests must reuse the contiguous copy until modified.
+  int count = array->GetMaterializationCount();
+  array->GetVoidPointer(0);
+  array->GetVoidPointer(5);
+  if (array->GetMaterializationCount() != count)
+    {
+    std::cerr << "GetVoidPointer materialized the data again." << std::endl;
+    return EXIT_FAILURE;
+    }
+  array->Modified();
+  array->GetVoidPointer(0);
+  if (array->GetMaterializationCount() != count + 1)
+    {
+    std::cerr << "Modified() did not invalidate the contiguous copy."
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The values are shared with the simulation memory.
+  soa[NumberOfTuples - 1] = 42;
+  if (array->GetValue((NumberOfTuples - 1) * 3) != 42)
+    {
+    std::cerr << "Array does not reference the simulation memory."
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -18,10 +18,12 @@
 #include "vtkCompositeDataIterator.h"
 #include "vtkCPDataDescription.h"
 #include "vtkCPInputDataDescription.h"
+#include "vtkCPMappedArrayTemplate.h"
 #include "vtkCPProcessor.h"
 #include "vtkDataSet.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkPointData.h"
+#include "vtkSmartPointer.h"
 
 #include <iostream>
 
@@ -165,3 +167,46 @@ void vtkCPAdaptorAPI::CoProcess()
   // Reset time data.
   vtkCPAdaptorAPI::IsTimeDataSet = false;
 }
+
+//-----------------------------------------------------------------------------
+void vtkCPAdaptorAPI::AddMappedField(const char* name, int association,
+  double* data, vtkIdType numTuples, int numComponents, vtkIdType tupleStride,
+  vtkIdType componentStride, bool appendChunk)
+{
+  if(!vtkCPAdaptorAPI::IsTimeDataSet)
+    {
+    vtkGenericWarningMacro("Time data not set.");
+    return;
+    }
+  vtkCPInputDataDescription* idd =
+    vtkCPAdaptorAPI::CoProcessorData->GetInputDescriptionByName("input");
+  if(!idd->IsFieldNeeded(name))
+    {
+    return;
+    }
+  vtkDataSet* grid = vtkDataSet::SafeDownCast(idd->GetGrid());
+  if(!grid)
+    {
+    vtkGenericWarningMacro("No vtkDataSet grid to attach field data to.");
+    return;
+    }
+  vtkFieldData* fieldData = association == 0 ?
+    static_cast<vtkFieldData*>(grid->GetPointData()) :
+    static_cast<vtkFieldData*>(grid->GetCellData());
+
+  typedef vtkCPMappedArrayTemplate<double> ArrayType;
+  ArrayType* existing = appendChunk ?
+    ArrayType::SafeDownCast(fieldData->GetAbstractArray(name)) : NULL;
+  if(existing)
+    {
+    existing->AddStridedChunk(
+      data, numTuples, numComponents, tupleStride, componentStride);
+    return;
+    }
+
+  vtkSmartPointer<ArrayType> array = vtkSmartPointer<ArrayType>::New();
+  array->SetName(name);
+  array->SetStridedArray(
+    data, numTuples, numComponents, tupleStride, componentStride);
+  fieldData->AddArray(array);
+}
@@ -49,6 +49,17 @@ public:
   /// has been filled in elsewhere.
   static void CoProcess();
 
+  /// wraps a double precision field owned by the simulation as a point
+  /// (association 0) or cell (association 1) array of the "input" grid
+  /// without copying it (see vtkCPMappedArrayTemplate). value c of tuple i
+  /// is read from data[i*tupleStride + c*componentStride]. when appendChunk
+  /// is true the tuples are appended to the already added array with the
+  /// same name instead of replacing it. nothing is done if the field is not
+  /// needed by any pipeline this time step.
+  static void AddMappedField(const char* name, int association, double* data,
+    vtkIdType numTuples, int numComponents, vtkIdType tupleStride,
+    vtkIdType componentStride, bool appendChunk);
+
   /// provides access to the vtkCPDataDescription instance.
   static vtkCPDataDescription* GetCoProcessorData()
     { return vtkCPAdaptorAPI::CoProcessorData; }
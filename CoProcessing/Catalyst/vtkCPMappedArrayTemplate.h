@@ -0,0 +1,239 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkCPMappedArrayTemplate.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkCPMappedArrayTemplate - zero-copy read-only view of simulation
+// memory.
+//
+// .SECTION Description
+// vtkCPMappedArrayTemplate wraps field data owned by a simulation code
+// without copying it into a vtkDataArrayTemplate. The wrapped memory is
+// described as one or more chunks of consecutive tuples. Within a chunk every
+// component has its own base pointer and all components share the same tuple
+// stride (in number of values). This covers the common layouts:
+//
+// @verbatim
+// * structure-of-arrays : one pointer per component, tuple stride 1
+//                         (SetSOAArrays()).
+// * array-of-structures : base + c for component c, tuple stride equal to
+//                         the number of values in the struct
+//                         (SetStridedArray()).
+// * Fortran a(ld,ncomp) : base + c*ld for component c, tuple stride 1
+//                         (SetStridedArray()).
+// * Fortran a(ncomp,n)  : base + c for component c, tuple stride ncomp
+//                         (SetStridedArray()).
+// @endverbatim
+//
+// Additional chunks can be appended with AddSOAChunk() and AddStridedChunk()
+// when a field is split over several allocations, e.g. one per material or
+// per local block. The array never frees the wrapped memory.
+//
+// Filters that require contiguous memory obtain it through GetVoidPointer().
+// The contiguous copy is materialized lazily on first request and reused
+// until the array is modified, i.e. typically once per time step. Adaptors
+// that keep the same array object across time steps must call Modified()
+// (or reset the layout) after the simulation has updated the wrapped memory.
+//
+// The array is read-only: all methods that would change the number of
+// tuples or the values print an error.
+
+#ifndef __vtkCPMappedArrayTemplate_h
+#define __vtkCPMappedArrayTemplate_h
+
+#include "vtkMappedDataArray.h"
+#include "vtkPVCatalystModule.h" // For export macro
+
+#include "vtkTypeTemplate.h" // For templated vtkObject API
+#include "vtkObjectFactory.h" // for vtkStandardNewBodyMacro
+
+#include <vector> // For chunk storage
+
+template <class Scalar>
+class vtkCPMappedArrayTemplate:
+  public vtkTypeTemplate<vtkCPMappedArrayTemplate<Scalar>,
+                         vtkMappedDataArray<Scalar> >
+{
+public:
+  vtkMappedDataArrayNewInstanceMacro(vtkCPMappedArrayTemplate<Scalar>)
+  static vtkCPMappedArrayTemplate *New();
+  virtual void PrintSelf(ostream &os, vtkIndent indent);
+
+  // Description:
+  // Wrap a structure-of-arrays field: arrays[c] points to the numTuples
+  // contiguous values of component c. Any previously set chunks are
+  // discarded.
+  void SetSOAArrays(const std::vector<Scalar*>& arrays, vtkIdType numTuples);
+
+  // Description:
+  // Wrap a strided field. Value c of tuple i is located at
+  // data[i*tupleStride + c*componentStride]. An array-of-structures layout
+  // uses componentStride=1 and tupleStride>=numComponents, a Fortran
+  // column-major a(ld,numComponents) uses tupleStride=1 and
+  // componentStride=ld. Any previously set chunks are discarded.
+  void SetStridedArray(Scalar* data, vtkIdType numTuples, int numComponents,
+                       vtkIdType tupleStride, vtkIdType componentStride);
+
+  // Description:
+  // Append a chunk of tuples after the already wrapped ones. The number of
+  // components must match the previous chunks.
+  void AddSOAChunk(const std::vector<Scalar*>& arrays, vtkIdType numTuples);
+  void AddStridedChunk(Scalar* data, vtkIdType numTuples, int numComponents,
+                       vtkIdType tupleStride, vtkIdType componentStride);
+
+  // Description:
+  // Returns the number of wrapped memory chunks.
+  int GetNumberOfChunks()
+    { return static_cast<int>(this->Chunks.size()); }
+
+  // Description:
+  // Returns the number of times the contiguous copy was (re)generated for
+  // GetVoidPointer() since the array was created. Useful to verify that
+  // consumers do not force repeated materialization.
+  vtkGetMacro(MaterializationCount, int);
+
+  // Description:
+  // Returns a pointer to a contiguous copy of the wrapped data. The copy
+  // is only rebuilt when the array has been modified since the last call,
+  // and its allocation is reused when the size does not change.
+  void* GetVoidPointer(vtkIdType id);
+
+  // Description:
+  // Copy the wrapped values into a contiguous, tuple-interleaved buffer.
+  void ExportToVoidPointer(void *ptr);
+
+  // Reimplemented virtuals -- see superclasses for descriptions:
+  void Initialize();
+  void GetTuples(vtkIdList *ptIds, vtkAbstractArray *output);
+  void GetTuples(vtkIdType p1, vtkIdType p2, vtkAbstractArray *output);
+  void Squeeze();
+  vtkArrayIterator *NewIterator();
+  vtkIdType LookupValue(vtkVariant value);
+  void LookupValue(vtkVariant value, vtkIdList *ids);
+  vtkVariant GetVariantValue(vtkIdType idx);
+  void ClearLookup();
+  double* GetTuple(vtkIdType i);
+  void GetTuple(vtkIdType i, double *tuple);
+  vtkIdType LookupTypedValue(Scalar value);
+  void LookupTypedValue(Scalar value, vtkIdList *ids);
+  Scalar GetValue(vtkIdType idx);
+  Scalar& GetValueReference(vtkIdType idx);
+  void GetTupleValue(vtkIdType idx, Scalar *t);
+
+  // Description:
+  // This container is read only -- this method does nothing but print an
+  // error.
+  int Allocate(vtkIdType sz, vtkIdType ext);
+  int Resize(vtkIdType numTuples);
+  void SetNumberOfTuples(vtkIdType number);
+  void SetTuple(vtkIdType i, vtkIdType j, vtkAbstractArray *source);
+  void SetTuple(vtkIdType i, const float *source);
+  void SetTuple(vtkIdType i, const double *source);
+  void InsertTuple(vtkIdType i, vtkIdType j, vtkAbstractArray *source);
+  void InsertTuple(vtkIdType i, const float *source);
+  void InsertTuple(vtkIdType i, const double *source);
+  void InsertTuples(vtkIdList *dstIds, vtkIdList *srcIds,
+                    vtkAbstractArray *source);
+  void InsertTuples(vtkIdType dstStart, vtkIdType n, vtkIdType srcStart,
+                    vtkAbstractArray* source);
+  vtkIdType InsertNextTuple(vtkIdType j, vtkAbstractArray *source);
+  vtkIdType InsertNextTuple(const float *source);
+  vtkIdType InsertNextTuple(const double *source);
+  void DeepCopy(vtkAbstractArray *aa);
+  void DeepCopy(vtkDataArray *da);
+  void InterpolateTuple(vtkIdType i, vtkIdList *ptIndices,
+                        vtkAbstractArray* source,  double* weights);
+  void InterpolateTuple(vtkIdType i, vtkIdType id1, vtkAbstractArray *source1,
+                        vtkIdType id2, vtkAbstractArray *source2, double t);
+  void SetVariantValue(vtkIdType idx, vtkVariant value);
+  void InsertVariantValue(vtkIdType idx, vtkVariant value);
+  void RemoveTuple(vtkIdType id);
+  void RemoveFirstTuple();
+  void RemoveLastTuple();
+  void SetTupleValue(vtkIdType i, const Scalar *t);
+  void InsertTupleValue(vtkIdType i, const Scalar *t);
+  vtkIdType InsertNextTupleValue(const Scalar *t);
+  void SetValue(vtkIdType idx, Scalar value);
+  vtkIdType InsertNextValue(Scalar v);
+  void InsertValue(vtkIdType idx, Scalar v);
+
+protected:
+  vtkCPMappedArrayTemplate();
+  ~vtkCPMappedArrayTemplate();
+
+  //BTX
+  struct Chunk
+    {
+    // base pointer of every component of the first tuple in the chunk.
+    std::vector<Scalar*> Components;
+    // distance, in values, between two consecutive tuples.
+    vtkIdType TupleStride;
+    // global index of the first tuple of the chunk.
+    vtkIdType FirstTuple;
+    vtkIdType NumberOfTuples;
+    };
+  std::vector<Chunk> Chunks;
+  //ETX
+
+  // Description:
+  // Append a chunk and update the array size.
+  void AppendChunk(const Chunk& chunk, int numComponents);
+
+  // Description:
+  // Returns the chunk containing tuple tupleIdx. The chunk at index hint is
+  // tried first, otherwise a binary search is done and hint is updated, so
+  // that sequential accesses are O(1). The hint is owned by the caller so
+  // that concurrent reads do not share any state.
+  const Chunk& FindChunk(vtkIdType tupleIdx, size_t& hint) const;
+
+  // Description:
+  // Copies tuple tupleIdx into tuple, converting the values to OutType.
+  template <class OutType>
+  void CopyTuple(vtkIdType tupleIdx, OutType* tuple, size_t& hint) const
+    {
+    const Chunk& chunk = this->FindChunk(tupleIdx, hint);
+    const vtkIdType offset = (tupleIdx - chunk.FirstTuple) * chunk.TupleStride;
+    for (int c = 0; c < this->NumberOfComponents; ++c)
+      {
+      tuple[c] = static_cast<OutType>(chunk.Components[c][offset]);
+      }
+    }
+
+  // Description:
+  // Returns a reference to the value at component comp of tuple tupleIdx.
+  Scalar& ValueAt(vtkIdType tupleIdx, int comp) const
+    {
+    size_t hint = 0;
+    const Chunk& chunk = this->FindChunk(tupleIdx, hint);
+    return chunk.Components[comp][
+      (tupleIdx - chunk.FirstTuple) * chunk.TupleStride];
+    }
+
+private:
+  vtkCPMappedArrayTemplate(const vtkCPMappedArrayTemplate &); // Not implemented.
+  void operator=(const vtkCPMappedArrayTemplate &); // Not implemented.
+
+  vtkIdType Lookup(const Scalar &val, vtkIdType startIndex);
+  void ReadOnlyError(const char* method);
+
+  std::vector<double> TempTuple;
+
+  Scalar *Materialized;
+  vtkIdType MaterializedSize;
+  unsigned long MaterializedTime;
+  int MaterializationCount;
+};
+
+#include "vtkCPMappedArrayTemplate.txx"
+
+#endif //__vtkCPMappedArrayTemplate_h
+// VTK-HeaderTest-Exclude: vtkCPMappedArrayTemplate.h
@@ -0,0 +1,674 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkCPMappedArrayTemplate.txx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#ifndef __vtkCPMappedArrayTemplate_txx
+#define __vtkCPMappedArrayTemplate_txx
+
+#include "vtkCPMappedArrayTemplate.h"
+
+#include "vtkIdList.h"
+#include "vtkObjectFactory.h"
+#include "vtkVariant.h"
+#include "vtkVariantCast.h"
+
+#include <cstring>
+
+//------------------------------------------------------------------------------
+// Can't use vtkStandardNewMacro with a templated class.
+template <class Scalar> vtkCPMappedArrayTemplate<Scalar> *
+vtkCPMappedArrayTemplate<Scalar>::New()
+{
+  VTK_STANDARD_NEW_BODY(vtkCPMappedArrayTemplate<Scalar>)
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::PrintSelf(ostream &os, vtkIndent indent)
+{
+  this->vtkCPMappedArrayTemplate<Scalar>::Superclass::PrintSelf(
+        os, indent);
+
+  os << indent << "Number of chunks: " << this->Chunks.size() << endl;
+  for (size_t cc = 0; cc < this->Chunks.size(); ++cc)
+    {
+    const Chunk& chunk = this->Chunks[cc];
+    os << indent.GetNextIndent() << "Chunk " << cc
+       << ": first tuple " << chunk.FirstTuple
+       << ", tuples " << chunk.NumberOfTuples
+       << ", tuple stride " << chunk.TupleStride << endl;
+    }
+  os << indent << "MaterializationCount: "
+     << this->MaterializationCount << endl;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::SetSOAArrays(const std::vector<Scalar*>& arrays, vtkIdType numTuples)
+{
+  this->Initialize();
+  this->AddSOAChunk(arrays, numTuples);
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::SetStridedArray(Scalar* data, vtkIdType numTuples, int numComponents,
+                  vtkIdType tupleStride, vtkIdType componentStride)
+{
+  this->Initialize();
+  this->AddStridedChunk(data, numTuples, numComponents, tupleStride,
+                        componentStride);
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::AddSOAChunk(const std::vector<Scalar*>& arrays, vtkIdType numTuples)
+{
+  Chunk chunk;
+  chunk.Components = arrays;
+  chunk.TupleStride = 1;
+  chunk.NumberOfTuples = numTuples;
+  this->AppendChunk(chunk, static_cast<int>(arrays.size()));
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::AddStridedChunk(Scalar* data, vtkIdType numTuples, int numComponents,
+                  vtkIdType tupleStride, vtkIdType componentStride)
+{
+  Chunk chunk;
+  chunk.Components.resize(numComponents);
+  for (int c = 0; c < numComponents; ++c)
+    {
+    chunk.Components[c] = data + c * componentStride;
+    }
+  chunk.TupleStride = tupleStride;
+  chunk.NumberOfTuples = numTuples;
+  this->AppendChunk(chunk, numComponents);
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::AppendChunk(const Chunk& chunk, int numComponents)
+{
+  if (numComponents < 1)
+    {
+    vtkErrorMacro("A chunk needs at least one component.");
+    return;
+    }
+  if (!this->Chunks.empty() && numComponents != this->NumberOfComponents)
+    {
+    vtkErrorMacro("Chunk has " << numComponents << " components, expected "
+                  << this->NumberOfComponents << ".");
+    return;
+    }
+
+  vtkIdType numTuples = this->GetNumberOfTuples();
+  this->Chunks.push_back(chunk);
+  this->Chunks.back().FirstTuple = numTuples;
+
+  this->NumberOfComponents = numComponents;
+  this->TempTuple.resize(numComponents);
+  this->Size = (numTuples + chunk.NumberOfTuples) * numComponents;
+  this->MaxId = this->Size - 1;
+  this->Modified();
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar>
+const typename vtkCPMappedArrayTemplate<Scalar>::Chunk&
+vtkCPMappedArrayTemplate<Scalar>::FindChunk(vtkIdType tupleIdx,
+                                            size_t& hint) const
+{
+  if (hint < this->Chunks.size())
+    {
+    const Chunk& last = this->Chunks[hint];
+    if (tupleIdx >= last.FirstTuple &&
+        tupleIdx < last.FirstTuple + last.NumberOfTuples)
+      {
+      return last;
+      }
+    }
+
+  // Chunks are sorted by FirstTuple, find the last one starting at or before
+  // tupleIdx.
+  size_t lo = 0;
+  size_t hi = this->Chunks.size();
+  while (hi - lo > 1)
+    {
+    size_t mid = (lo + hi) / 2;
+    if (this->Chunks[mid].FirstTuple <= tupleIdx)
+      {
+      lo = mid;
+      }
+    else
+      {
+      hi = mid;
+      }
+    }
+  hint = lo;
+  return this->Chunks[lo];
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void* vtkCPMappedArrayTemplate<Scalar>
+::GetVoidPointer(vtkIdType id)
+{
+  if (this->Chunks.empty())
+    {
+    return NULL;
+    }
+
+  if (!this->Materialized || this->MaterializedTime < this->GetMTime())
+    {
+    vtkIdType size = this->GetNumberOfTuples() * this->NumberOfComponents;
+    if (this->Materialized && this->MaterializedSize != size)
+      {
+      delete [] this->Materialized;
+      this->Materialized = NULL;
+      }
+    if (!this->Materialized)
+      {
+      this->Materialized = new Scalar[size];
+      this->MaterializedSize = size;
+      }
+    this->ExportToVoidPointer(this->Materialized);
+    this->MaterializedTime = this->GetMTime();
+    ++this->MaterializationCount;
+    }
+  return static_cast<void*>(this->Materialized + id);
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::ExportToVoidPointer(void *voidPtr)
+{
+  Scalar *ptr = static_cast<Scalar*>(voidPtr);
+  if (!ptr)
+    {
+    return;
+    }
+
+  const int numComp = this->NumberOfComponents;
+  for (size_t cc = 0; cc < this->Chunks.size(); ++cc)
+    {
+    const Chunk& chunk = this->Chunks[cc];
+    Scalar* out = ptr + chunk.FirstTuple * numComp;
+
+    // A packed array-of-structures chunk already has the VTK layout.
+    bool packed = (chunk.TupleStride == numComp);
+    for (int c = 1; packed && c < numComp; ++c)
+      {
+      packed = (chunk.Components[c] == chunk.Components[0] + c);
+      }
+    if (packed)
+      {
+      memcpy(out, chunk.Components[0],
+             chunk.NumberOfTuples * numComp * sizeof(Scalar));
+      continue;
+      }
+
+    // Otherwise scatter component by component so that each source stream
+    // is read sequentially.
+    for (int c = 0; c < numComp; ++c)
+      {
+      const Scalar* in = chunk.Components[c];
+      const vtkIdType stride = chunk.TupleStride;
+      for (vtkIdType t = 0; t < chunk.NumberOfTuples; ++t)
+        {
+        out[t * numComp + c] = in[t * stride];
+        }
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::Initialize()
+{
+  this->Chunks.clear();
+  delete [] this->Materialized;
+  this->Materialized = NULL;
+  this->MaterializedSize = 0;
+  this->MaterializedTime = 0;
+  this->MaxId = -1;
+  this->Size = 0;
+  this->NumberOfComponents = 1;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::GetTuples(vtkIdList *ptIds, vtkAbstractArray *output)
+{
+  vtkDataArray *outArray = vtkDataArray::SafeDownCast(output);
+  if (!outArray)
+    {
+    vtkWarningMacro(<<"Input is not a vtkDataArray");
+    return;
+    }
+
+  vtkIdType numTuples = ptIds->GetNumberOfIds();
+
+  outArray->SetNumberOfComponents(this->NumberOfComponents);
+  outArray->SetNumberOfTuples(numTuples);
+
+  std::vector<double> tuple(this->NumberOfComponents);
+  size_t hint = 0;
+  for (vtkIdType i = 0; i < numTuples; ++i)
+    {
+    this->CopyTuple(ptIds->GetId(i), &tuple[0], hint);
+    outArray->SetTuple(i, &tuple[0]);
+    }
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::GetTuples(vtkIdType p1, vtkIdType p2, vtkAbstractArray *output)
+{
+  vtkDataArray *da = vtkDataArray::SafeDownCast(output);
+  if (!da)
+    {
+    vtkErrorMacro(<<"Input is not a vtkDataArray");
+    return;
+    }
+
+  if (da->GetNumberOfComponents() != this->GetNumberOfComponents())
+    {
+    vtkErrorMacro(<<"Incorrect number of components in input array.");
+    return;
+    }
+
+  std::vector<double> tuple(this->NumberOfComponents);
+  size_t hint = 0;
+  for (vtkIdType daTupleId = 0; p1 <= p2; ++p1)
+    {
+    this->CopyTuple(p1, &tuple[0], hint);
+    da->SetTuple(daTupleId++, &tuple[0]);
+    }
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::Squeeze()
+{
+  // noop
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> vtkArrayIterator*
+vtkCPMappedArrayTemplate<Scalar>::NewIterator()
+{
+  vtkErrorMacro(<<"Not implemented.");
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> vtkIdType vtkCPMappedArrayTemplate<Scalar>
+::LookupValue(vtkVariant value)
+{
+  bool valid = true;
+  Scalar val = vtkVariantCast<Scalar>(value, &valid);
+  if (valid)
+    {
+    return this->Lookup(val, 0);
+    }
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::LookupValue(vtkVariant value, vtkIdList *ids)
+{
+  bool valid = true;
+  Scalar val = vtkVariantCast<Scalar>(value, &valid);
+  ids->Reset();
+  if (valid)
+    {
+    vtkIdType index = 0;
+    while ((index = this->Lookup(val, index)) >= 0)
+      {
+      ids->InsertNextId(index++);
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> vtkVariant vtkCPMappedArrayTemplate<Scalar>
+::GetVariantValue(vtkIdType idx)
+{
+  return vtkVariant(this->GetValueReference(idx));
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::ClearLookup()
+{
+  // no fast lookup implemented
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> double* vtkCPMappedArrayTemplate<Scalar>
+::GetTuple(vtkIdType i)
+{
+  this->GetTuple(i, &this->TempTuple[0]);
+  return &this->TempTuple[0];
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::GetTuple(vtkIdType i, double *tuple)
+{
+  size_t hint = 0;
+  this->CopyTuple(i, tuple, hint);
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> vtkIdType vtkCPMappedArrayTemplate<Scalar>
+::LookupTypedValue(Scalar value)
+{
+  return this->Lookup(value, 0);
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::LookupTypedValue(Scalar value, vtkIdList *ids)
+{
+  ids->Reset();
+  vtkIdType index = 0;
+  while ((index = this->Lookup(value, index)) >= 0)
+    {
+    ids->InsertNextId(index++);
+    }
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> Scalar vtkCPMappedArrayTemplate<Scalar>
+::GetValue(vtkIdType idx)
+{
+  return this->GetValueReference(idx);
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> Scalar& vtkCPMappedArrayTemplate<Scalar>
+::GetValueReference(vtkIdType idx)
+{
+  const vtkIdType tuple = idx / this->NumberOfComponents;
+  const int comp = static_cast<int>(idx % this->NumberOfComponents);
+  return this->ValueAt(tuple, comp);
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::GetTupleValue(vtkIdType tupleId, Scalar *tuple)
+{
+  size_t hint = 0;
+  this->CopyTuple(tupleId, tuple, hint);
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::ReadOnlyError(const char* method)
+{
+  vtkErrorMacro(<< method << ": Read only container.");
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> int vtkCPMappedArrayTemplate<Scalar>
+::Allocate(vtkIdType, vtkIdType)
+{
+  this->ReadOnlyError("Allocate");
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> int vtkCPMappedArrayTemplate<Scalar>
+::Resize(vtkIdType)
+{
+  this->ReadOnlyError("Resize");
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::SetNumberOfTuples(vtkIdType)
+{
+  this->ReadOnlyError("SetNumberOfTuples");
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::SetTuple(vtkIdType, vtkIdType, vtkAbstractArray *)
+{
+  this->ReadOnlyError("SetTuple");
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::SetTuple(vtkIdType, const float *)
+{
+  this->ReadOnlyError("SetTuple");
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::SetTuple(vtkIdType, const double *)
+{
+  this->ReadOnlyError("SetTuple");
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::InsertTuple(vtkIdType, vtkIdType, vtkAbstractArray *)
+{
+  this->ReadOnlyError("InsertTuple");
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::InsertTuple(vtkIdType, const float *)
+{
+  this->ReadOnlyError("InsertTuple");
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::InsertTuple(vtkIdType, const double *)
+{
+  this->ReadOnlyError("InsertTuple");
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::InsertTuples(vtkIdList *, vtkIdList *, vtkAbstractArray *)
+{
+  this->ReadOnlyError("InsertTuples");
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::InsertTuples(vtkIdType, vtkIdType, vtkIdType, vtkAbstractArray *)
+{
+  this->ReadOnlyError("InsertTuples");
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> vtkIdType vtkCPMappedArrayTemplate<Scalar>
+::InsertNextTuple(vtkIdType, vtkAbstractArray *)
+{
+  this->ReadOnlyError("InsertNextTuple");
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> vtkIdType vtkCPMappedArrayTemplate<Scalar>
+::InsertNextTuple(const float *)
+{
+  this->ReadOnlyError("InsertNextTuple");
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> vtkIdType vtkCPMappedArrayTemplate<Scalar>
+::InsertNextTuple(const double *)
+{
+  this->ReadOnlyError("InsertNextTuple");
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::DeepCopy(vtkAbstractArray *)
+{
+  this->ReadOnlyError("DeepCopy");
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::DeepCopy(vtkDataArray *)
+{
+  this->ReadOnlyError("DeepCopy");
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::InterpolateTuple(vtkIdType, vtkIdList *, vtkAbstractArray *, double *)
+{
+  this->ReadOnlyError("InterpolateTuple");
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::InterpolateTuple(vtkIdType, vtkIdType, vtkAbstractArray*, vtkIdType,
+                   vtkAbstractArray*, double)
+{
+  this->ReadOnlyError("InterpolateTuple");
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::SetVariantValue(vtkIdType, vtkVariant)
+{
+  this->ReadOnlyError("SetVariantValue");
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::InsertVariantValue(vtkIdType, vtkVariant)
+{
+  this->ReadOnlyError("InsertVariantValue");
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::RemoveTuple(vtkIdType)
+{
+  this->ReadOnlyError("RemoveTuple");
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::RemoveFirstTuple()
+{
+  this->ReadOnlyError("RemoveFirstTuple");
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::RemoveLastTuple()
+{
+  this->ReadOnlyError("RemoveLastTuple");
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::SetTupleValue(vtkIdType, const Scalar*)
+{
+  this->ReadOnlyError("SetTupleValue");
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::InsertTupleValue(vtkIdType, const Scalar*)
+{
+  this->ReadOnlyError("InsertTupleValue");
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> vtkIdType vtkCPMappedArrayTemplate<Scalar>
+::InsertNextTupleValue(const Scalar *)
+{
+  this->ReadOnlyError("InsertNextTupleValue");
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::SetValue(vtkIdType, Scalar)
+{
+  this->ReadOnlyError("SetValue");
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> vtkIdType vtkCPMappedArrayTemplate<Scalar>
+::InsertNextValue(Scalar)
+{
+  this->ReadOnlyError("InsertNextValue");
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPMappedArrayTemplate<Scalar>
+::InsertValue(vtkIdType, Scalar)
+{
+  this->ReadOnlyError("InsertValue");
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> vtkCPMappedArrayTemplate<Scalar>
+::vtkCPMappedArrayTemplate()
+  : TempTuple(1),
+    Materialized(NULL),
+    MaterializedSize(0),
+    MaterializedTime(0),
+    MaterializationCount(0)
+{
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> vtkCPMappedArrayTemplate<Scalar>
+::~vtkCPMappedArrayTemplate()
+{
+  delete [] this->Materialized;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> vtkIdType vtkCPMappedArrayTemplate<Scalar>
+::Lookup(const Scalar &val, vtkIdType index)
+{
+  const int numComp = this->NumberOfComponents;
+  const vtkIdType numValues = this->GetNumberOfTuples() * numComp;
+  size_t hint = 0;
+  for (; index < numValues; ++index)
+    {
+    const vtkIdType tupleIdx = index / numComp;
+    const Chunk& chunk = this->FindChunk(tupleIdx, hint);
+    if (chunk.Components[index % numComp][
+          (tupleIdx - chunk.FirstTuple) * chunk.TupleStride] == val)
+      {
+      return index;
+      }
+    }
+  return -1;
+}
+
+#endif //__vtkCPMappedArrayTemplate_txx
@@ -12,6 +12,7 @@
   PURPOSE.  See the above copyright notice for more information.
 
   =========================================================================*/
+#include "vtkPython.h" // must be first
 #include "vtkCPPythonScriptPipeline.h"
 
 #include "vtkCPDataDescription.h"
@@ -25,7 +26,9 @@
 #include "vtkPythonInterpreter.h"
 #include "vtkSMObject.h"
 #include "vtkSMProxyManager.h"
+#include "vtkSmartPyObject.h"
 
+#include <stdlib.h>
 #include <string>
 #include <vtksys/SystemTools.hxx>
 #include <vtksys/ios/sstream>
@@ -37,7 +40,7 @@ extern "C" {
 namespace
 {
 //----------------------------------------------------------------------------
-  void InitializePython()
+  void InitializePythonInterpreter()
   {
     static bool initialized = false;
     if (initialized)
@@ -51,6 +54,19 @@ namespace
     vtkPVInitializePythonModules();
 
     vtkPythonInterpreter::Initialize();
+  }
+
+//----------------------------------------------------------------------------
+  void InitializePython()
+  {
+    static bool initialized = false;
+    if (initialized)
+      {
+      return;
+      }
+    initialized = true;
+
+    InitializePythonInterpreter();
 
     vtksys_ios::ostringstream loadPythonModules;
     loadPythonModules
@@ -68,6 +84,129 @@ namespace
     vtkPythonInterpreter::RunSimpleString(loadPythonModules.str().c_str());
   }
 
+//----------------------------------------------------------------------------
+  // Run on process 0 once the script has been loaded. Collects the bytecode
+  // of the script and of every pure Python module imported so far (paraview,
+  // paraview.simple, vtk, the standard library modules they use, ...) into a
+  // single marshaled dictionary. Failed imports, which Python caches as None
+  // in sys.modules, are recorded as well so that the other processes do not
+  // probe the file system for them either.
+  const char* BundleBuilderSource =
+    "def _vtkCPBuildBytecodeBundle(scriptName, fileName):\n"
+    "  import marshal, os, sys\n"
+    "  modules = {}\n"
+    "  missing = []\n"
+    "  with open(fileName, 'rU') as f:\n"
+    "    modules[scriptName] = (False, scriptName + '.py',\n"
+    "      compile(f.read(), scriptName + '.py', 'exec'))\n"
+    "  for name, module in sys.modules.items():\n"
+    "    if module is None:\n"
+    "      missing.append(name)\n"
+    "      continue\n"
+    "    fname = getattr(module, '__file__', None)\n"
+    "    if name == scriptName or not fname:\n"
+    "      continue\n"
+    "    if fname.endswith('.pyc') or fname.endswith('.pyo'):\n"
+    "      fname = fname[:-1]\n"
+    "    if not fname.endswith('.py') or not os.path.isfile(fname):\n"
+    "      continue\n"
+    "    try:\n"
+    "      with open(fname, 'rU') as f:\n"
+    "        code = compile(f.read(), fname, 'exec')\n"
+    "    except Exception:\n"
+    "      continue\n"
+    "    isPackage = os.path.basename(fname) == '__init__.py'\n"
+    "    modules[name] = (isPackage, fname, code)\n"
+    "  return marshal.dumps((modules, missing))\n";
+
+  // Run on the other processes before anything is imported. Installs an
+  // import hook that serves the modules in the bundle from memory.
+  const char* BundleImporterSource =
+    "class _vtkCPBytecodeBundleImporter(object):\n"
+    "  def __init__(self, modules):\n"
+    "    self.Modules = modules\n"
+    "  def find_module(self, fullname, path=None):\n"
+    "    if fullname in self.Modules:\n"
+    "      return self\n"
+    "    return None\n"
+    "  def load_module(self, fullname):\n"
+    "    import imp, os, sys\n"
+    "    if fullname in sys.modules:\n"
+    "      return sys.modules[fullname]\n"
+    "    isPackage, fname, code = self.Modules[fullname]\n"
+    "    module = imp.new_module(fullname)\n"
+    "    module.__file__ = fname\n"
+    "    module.__loader__ = self\n"
+    "    if isPackage:\n"
+    "      module.__path__ = [os.path.dirname(fname)]\n"
+    "      module.__package__ = fullname\n"
+    "    else:\n"
+    "      module.__package__ = fullname.rpartition('.')[0]\n"
+    "    sys.modules[fullname] = module\n"
+    "    try:\n"
+    "      exec code in module.__dict__\n"
+    "    except:\n"
+    "      del sys.modules[fullname]\n"
+    "      raise\n"
+    "    return module\n"
+    "\n"
+    "def _vtkCPInstallBytecodeBundle(data):\n"
+    "  import marshal, sys\n"
+    "  modules, missing = marshal.loads(data)\n"
+    "  for name in missing:\n"
+    "    sys.modules.setdefault(name, None)\n"
+    "  sys.meta_path.insert(0, _vtkCPBytecodeBundleImporter(modules))\n";
+
+//----------------------------------------------------------------------------
+  PyObject* GetMainFunction(const char* source, const char* name)
+  {
+    vtkPythonInterpreter::RunSimpleString(source);
+    PyObject* mainModule = PyImport_AddModule("__main__");
+    return mainModule?
+      PyDict_GetItemString(PyModule_GetDict(mainModule), name) : NULL;
+  }
+
+//----------------------------------------------------------------------------
+  bool BuildBytecodeBundle(const std::string& scriptName,
+    const char* fileName, std::string& bundle)
+  {
+    PyObject* builder = GetMainFunction(
+      BundleBuilderSource, "_vtkCPBuildBytecodeBundle");
+    if (!builder)
+      {
+      return false;
+      }
+    vtkSmartPyObject result(PyObject_CallFunction(builder,
+        const_cast<char*>("ss"), scriptName.c_str(), fileName));
+    if (!result || !PyString_Check(result))
+      {
+      PyErr_Print();
+      return false;
+      }
+    bundle.assign(PyString_AsString(result), PyString_Size(result));
+    return true;
+  }
+
+//----------------------------------------------------------------------------
+  bool InstallBytecodeBundle(const std::string& bundle)
+  {
+    PyObject* installer = GetMainFunction(
+      BundleImporterSource, "_vtkCPInstallBytecodeBundle");
+    if (!installer)
+      {
+      return false;
+      }
+    vtkSmartPyObject result(PyObject_CallFunction(installer,
+        const_cast<char*>("s#"), bundle.c_str(),
+        static_cast<int>(bundle.size())));
+    if (!result)
+      {
+      PyErr_Print();
+      return false;
+      }
+    return true;
+  }
+
 //----------------------------------------------------------------------------
   // for things like programmable filters that have a '\n' in their strings,
   // we need to fix them to have \\n so that everything works smoothly
@@ -85,6 +224,8 @@ namespace
   }
 }
 
+bool vtkCPPythonScriptPipeline::UseBytecodeBundle = false;
+
 vtkStandardNewMacro(vtkCPPythonScriptPipeline);
 //----------------------------------------------------------------------------
 vtkCPPythonScriptPipeline::vtkCPPythonScriptPipeline()
@@ -101,23 +242,37 @@ vtkCPPythonScriptPipeline::~vtkCPPythonScriptPipeline()
 //----------------------------------------------------------------------------
 int vtkCPPythonScriptPipeline::Initialize(const char* fileName)
 {
-  // only process 0 checks if the file exists and broadcasts that information
-  // to the other processes
-  int fileExists = 0;
+  // only process 0 checks if the file exists and whether to use a bytecode
+  // bundle and broadcasts that information to the other processes
+  int flags[2] = {0, 0};
   vtkMultiProcessController* controller =
     vtkMultiProcessController::GetGlobalController();
-  if(controller->GetLocalProcessId()==0)
+  int rank = controller->GetLocalProcessId();
+  if(rank==0)
     {
-    fileExists = vtksys::SystemTools::FileExists(fileName, true);
+    flags[0] = vtksys::SystemTools::FileExists(fileName, true);
+    flags[1] = controller->GetNumberOfProcesses() > 1 &&
+      (vtkCPPythonScriptPipeline::UseBytecodeBundle ||
+       getenv("PV_CATALYST_BYTECODE_BUNDLE") != NULL);
     }
-  controller->Broadcast(&fileExists, 1, 0);
-  if(fileExists == 0)
+  controller->Broadcast(flags, 2, 0);
+  if(flags[0] == 0)
     {
     vtkErrorMacro("Could not find file " << fileName);
     return 0;
     }
+  bool useBundle = (flags[1] != 0);
 
-  InitializePython();
+  // with a bytecode bundle, the other processes must not import anything
+  // until the bundle is installed.
+  if (rank == 0 || !useBundle)
+    {
+    InitializePython();
+    }
+  else
+    {
+    InitializePythonInterpreter();
+    }
 
   // for now do not check on filename extension:
   //vtksys::SystemTools::GetFilenameLastExtension(FileName) == ".py" == 0)
@@ -133,7 +288,6 @@ int vtkCPPythonScriptPipeline::Initialize(const char* fileName)
   // we need to add the script path to PYTHONPATH
   char* scriptPath = NULL;
 
-  int rank = controller->GetLocalProcessId();
   int scriptSizes[2] = {0, 0};
   if(rank == 0)
     {
@@ -211,7 +365,50 @@ int vtkCPPythonScriptPipeline::Initialize(const char* fileName)
   delete[] scriptPath;
   delete[] scriptText;
 
-  vtkPythonInterpreter::RunSimpleString(loadPythonModules.str().c_str());
+  if (!useBundle)
+    {
+    vtkPythonInterpreter::RunSimpleString(loadPythonModules.str().c_str());
+    return 1;
+    }
+
+  // Process 0 loads the script, which imports paraview.simple etc. from the
+  // file system, then sends the bytecode of everything that was imported to
+  // the other processes which then load the script without touching the file
+  // system for pure Python modules. Extension modules are still loaded from
+  // disk unless they are built in (static builds).
+  std::string bundle;
+  if (rank == 0)
+    {
+    vtkPythonInterpreter::RunSimpleString(loadPythonModules.str().c_str());
+    if (!BuildBytecodeBundle(fileNameName, fileName, bundle))
+      {
+      vtkWarningMacro("Failed to create the Python bytecode bundle. "
+        "Other processes will import modules from the file system.");
+      bundle.clear();
+      }
+    }
+  int bundleSize = static_cast<int>(bundle.size());
+  controller->Broadcast(&bundleSize, 1, 0);
+  if (bundleSize > 0)
+    {
+    bundle.resize(bundleSize);
+    controller->Broadcast(&bundle[0], bundleSize, 0);
+    }
+  if (rank != 0)
+    {
+    if (bundleSize > 0 && InstallBytecodeBundle(bundle))
+      {
+      InitializePython();
+      vtksys_ios::ostringstream importScript;
+      importScript << "import " << fileNameName << std::endl;
+      vtkPythonInterpreter::RunSimpleString(importScript.str().c_str());
+      }
+    else
+      {
+      InitializePython();
+      vtkPythonInterpreter::RunSimpleString(loadPythonModules.str().c_str());
+      }
+    }
   return 1;
 }
 
@@ -305,4 +502,6 @@ void vtkCPPythonScriptPipeline::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "PythonScriptName: " << this->PythonScriptName << "\n";
+  os << indent << "UseBytecodeBundle: "
+     << vtkCPPythonScriptPipeline::UseBytecodeBundle << "\n";
 }
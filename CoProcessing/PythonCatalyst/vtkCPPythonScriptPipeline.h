@@ -37,6 +37,17 @@ public:
   /// python script. Returns 1 for success and 0 for failure.
   int Initialize(const char* fileName);
 
+  /// When enabled (or when the PV_CATALYST_BYTECODE_BUNDLE environment
+  /// variable is set on process 0), Initialize() only imports the script and
+  /// the modules it uses on process 0. Their bytecode is then broadcast as a
+  /// single bundle and served from memory by an import hook on the other
+  /// processes, avoiding file system metadata storms on large runs. Only
+  /// relevant in parallel. Off by default.
+  static void SetUseBytecodeBundle(bool val)
+    { vtkCPPythonScriptPipeline::UseBytecodeBundle = val; }
+  static bool GetUseBytecodeBundle()
+    { return vtkCPPythonScriptPipeline::UseBytecodeBundle; }
+
   /// Configuration Step:
   /// The coprocessor first determines if any coprocessing needs to be done
   /// at this TimeStep/Time combination returning 1 if it does and 0
@@ -71,6 +82,8 @@ private:
   /// The name of the python script (without the path or extension)
   /// that is used as the namespace of the functions of the script.
   char* PythonScriptName;
+
+  static bool UseBytecodeBundle;
 };
 
 #endif
@@ -0,0 +1,120 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestAnimationEncoderWriter.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the writers used by the encoder threads of
+// vtkSMAnimationSceneImageWriter produce the same files as the configured
+// image writer.
+
+#include "vtkImageData.h"
+#include "vtkJPEGWriter.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkSmartPointer.h"
+#include "vtkSMAnimationSceneImageWriter.h"
+#include "vtkTIFFWriter.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <iostream>
+
+namespace
+{
+  // Exposes the writer setup of vtkSMAnimationSceneImageWriter.
+  class vtkTestAnimationImageWriter : public vtkSMAnimationSceneImageWriter
+  {
+  public:
+    static vtkTestAnimationImageWriter* New();
+    vtkTypeMacro(vtkTestAnimationImageWriter, vtkSMAnimationSceneImageWriter);
+
+    void SetWriter(vtkImageWriter* writer)
+      { this->SetImageWriter(writer); }
+    vtkImageWriter* NewClone()
+      { return this->NewEncoderWriter(); }
+  };
+  vtkStandardNewMacro(vtkTestAnimationImageWriter);
+
+  vtkUnsignedCharArray* Encode(vtkJPEGWriter* writer, vtkImageData* image)
+    {
+    writer->SetInputData(image);
+    writer->Write();
+    return writer->GetResult();
+    }
+}
+
+int TestAnimationEncoderWriter(int, char*[])
+{
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(64, 64, 1);
+  image->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+  unsigned char* pixels =
+    static_cast<unsigned char*>(image->GetScalarPointer());
+  for (int cc = 0; cc < 64 * 64 * 3; ++cc)
+    {
+    pixels[cc] = static_cast<unsigned char>((cc * 7) % 251);
+    }
+
+  vtkNew<vtkTestAnimationImageWriter> animationWriter;
+
+  vtkNew<vtkJPEGWriter> jpeg;
+  jpeg->SetQuality(10);
+  jpeg->ProgressiveOff();
+  jpeg->WriteToMemoryOn();
+  animationWriter->SetWriter(jpeg.GetPointer());
+
+  vtkSmartPointer<vtkJPEGWriter> clone;
+  clone.TakeReference(
+    vtkJPEGWriter::SafeDownCast(animationWriter->NewClone()));
+  if (!clone || clone->GetQuality() != 10 || clone->GetProgressive() ||
+    !clone->GetWriteToMemory())
+    {
+    std::cerr << "JPEG settings were not copied to the encoder writer."
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkNew<vtkUnsignedCharArray> expected;
+  expected->DeepCopy(Encode(jpeg.GetPointer(), image.GetPointer()));
+  vtkUnsignedCharArray* result = Encode(clone, image.GetPointer());
+  if (result->GetNumberOfTuples() != expected->GetNumberOfTuples())
+    {
+    std::cerr << "Encoder writer produced " << result->GetNumberOfTuples()
+              << " bytes instead of " << expected->GetNumberOfTuples()
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+  for (vtkIdType cc = 0; cc < expected->GetNumberOfTuples(); ++cc)
+    {
+    if (result->GetValue(cc) != expected->GetValue(cc))
+      {
+      std::cerr << "Encoder writer output differs at byte " << cc
+                << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  vtkNew<vtkTIFFWriter> tiff;
+  tiff->SetCompressionToLZW();
+  animationWriter->SetWriter(tiff.GetPointer());
+  vtkSmartPointer<vtkTIFFWriter> tiffClone;
+  tiffClone.TakeReference(
+    vtkTIFFWriter::SafeDownCast(animationWriter->NewClone()));
+  if (!tiffClone || tiffClone->GetCompression() != vtkTIFFWriter::LZW)
+    {
+    std::cerr << "TIFF compression was not copied to the encoder writer."
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  animationWriter->SetWriter(NULL);
+  return EXIT_SUCCESS;
+}
@@ -14,16 +14,20 @@
 =========================================================================*/
 #include "vtkSMAnimationSceneImageWriter.h"
 
+#include "vtkConditionVariable.h"
 #include "vtkErrorCode.h"
 #include "vtkGenericMovieWriter.h"
 #include "vtkImageData.h"
 #include "vtkImageIterator.h"
 #include "vtkImageWriter.h"
 #include "vtkJPEGWriter.h"
+#include "vtkMutexLock.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkObjectFactory.h"
 #include "vtkPNGWriter.h"
 #include "vtkPVConfig.h"
+#include "vtkPVEventTraceLog.h"
 #include "vtkSMAnimationScene.h"
 #include "vtkSmartPointer.h"
 #include "vtkSMIntVectorProperty.h"
@@ -33,14 +37,19 @@
 #include "vtkSMViewLayoutProxy.h"
 #include "vtkSMViewProxy.h"
 #include "vtkTIFFWriter.h"
+#include "vtkTimerLog.h"
 #include "vtkToolkits.h"
+#include "vtkUnsignedCharArray.h"
 
 #ifdef VTK_USE_MPEG2_ENCODER
 # include "vtkMPEG2Writer.h"
 #endif
 
 #include <algorithm>
+#include <cstdio>
+#include <deque>
 #include <string>
+#include <vector>
 #include <vtksys/SystemTools.hxx>
 
 #ifdef _WIN32
@@ -56,6 +65,63 @@
 #  include "vtkOggTheoraWriter.h"
 #endif
 
+namespace
+{
+  // PNG and JPEG writers can encode to memory, which lets us write the file
+  // ourselves and time compression and I/O separately.
+  void vtkEnableWriteToMemory(vtkImageWriter* writer)
+    {
+    if (vtkPNGWriter* png = vtkPNGWriter::SafeDownCast(writer))
+      {
+      png->WriteToMemoryOn();
+      }
+    else if (vtkJPEGWriter* jpeg = vtkJPEGWriter::SafeDownCast(writer))
+      {
+      jpeg->WriteToMemoryOn();
+      }
+    }
+
+  vtkUnsignedCharArray* vtkGetWriteToMemoryResult(vtkImageWriter* writer)
+    {
+    if (vtkPNGWriter* png = vtkPNGWriter::SafeDownCast(writer))
+      {
+      return png->GetWriteToMemory()? png->GetResult() : NULL;
+      }
+    else if (vtkJPEGWriter* jpeg = vtkJPEGWriter::SafeDownCast(writer))
+      {
+      return jpeg->GetWriteToMemory()? jpeg->GetResult() : NULL;
+      }
+    return NULL;
+    }
+}
+
+class vtkSMAnimationSceneImageWriter::vtkInternals
+{
+public:
+  struct vtkFrame
+    {
+    vtkSmartPointer<vtkImageData> Image;
+    std::string FileName;
+    };
+
+  vtkNew<vtkMultiThreader> Threader;
+  vtkNew<vtkMutexLock> Mutex;
+  vtkNew<vtkConditionVariable> FrameQueued;
+  vtkNew<vtkConditionVariable> FrameDequeued;
+
+  // All of the following are protected by Mutex while encoder threads run.
+  std::deque<vtkFrame> Queue;
+  std::vector<int> ThreadIds;
+  std::vector<vtkSmartPointer<vtkImageWriter> > Writers;
+  size_t NextWriter;
+  bool Stop;
+  int ErrorCode;
+
+  vtkInternals() : NextWriter(0), Stop(false), ErrorCode(0)
+    {
+    }
+};
+
 vtkStandardNewMacro(vtkSMAnimationSceneImageWriter);
 vtkCxxSetObjectMacro(vtkSMAnimationSceneImageWriter,
   ImageWriter, vtkImageWriter);
@@ -85,11 +151,25 @@ vtkSMAnimationSceneImageWriter::vtkSMAnimationSceneImageWriter()
 
   this->BackgroundColor[0] = this->BackgroundColor[1] =
     this->BackgroundColor[2] = 0.0;
+
+  this->NumberOfEncoderThreads = 2;
+  this->MaximumQueuedFrames = 4;
+  this->CaptureTime = 0.0;
+  this->EncodeTime = 0.0;
+  this->WriteTime = 0.0;
+  this->QueueWaitTime = 0.0;
+  this->NumberOfFramesWritten = 0;
+
+  this->Internals = new vtkInternals();
 }
 
 //-----------------------------------------------------------------------------
 vtkSMAnimationSceneImageWriter::~vtkSMAnimationSceneImageWriter()
 {
+  this->StopEncoderThreads();
+  delete this->Internals;
+  this->Internals = NULL;
+
   this->SetMovieWriter(0);
   this->SetImageWriter(0);
 
@@ -122,6 +202,13 @@ bool vtkSMAnimationSceneImageWriter::SaveInitialize(int startCount)
 
   this->FileCount = startCount;
 
+  this->CaptureTime = 0.0;
+  this->EncodeTime = 0.0;
+  this->WriteTime = 0.0;
+  this->QueueWaitTime = 0.0;
+  this->NumberOfFramesWritten = 0;
+  this->StartEncoderThreads();
+
 #if !defined(__APPLE__)
   // Iterate over all views and enable offscreen rendering. This avoid toggling
   // of the offscreen rendering flag on every frame.
@@ -200,6 +287,7 @@ void vtkSMAnimationSceneImageWriter::Merge(vtkImageData* dest, vtkImageData* src
 //-----------------------------------------------------------------------------
 bool vtkSMAnimationSceneImageWriter::SaveFrame(double vtkNotUsed(time))
 {
+  double captureStart = vtkTimerLog::GetUniversalTime();
   vtkSmartPointer<vtkImageData> combinedImage;
   unsigned int num_modules = this->AnimationScene->GetNumberOfViewProxies();
   if (num_modules > 1)
@@ -228,28 +316,114 @@ bool vtkSMAnimationSceneImageWriter::SaveFrame(double vtkNotUsed(time))
       }
     combinedImage.TakeReference(capture);
     }
+  this->CaptureTime += vtkTimerLog::GetUniversalTime() - captureStart;
 
-  int errcode = 0;
+  // Image files are named in frame order, irrespective of the order in which
+  // the encoder threads complete them.
+  std::string filename;
   if (this->ImageWriter)
     {
     char number[1024];
     sprintf(number, ".%04d", this->FileCount);
-    std::string filename = this->Prefix;
+    filename = this->Prefix;
     filename = filename + number + this->Suffix;
-    this->ImageWriter->SetInputData(combinedImage);
-    this->ImageWriter->SetFileName(filename.c_str());
-    this->ImageWriter->Write();
-    this->ImageWriter->SetInputData(0);
+    }
 
-    errcode = this->ImageWriter->GetErrorCode();
-    this->FileCount = (!errcode)? this->FileCount + 1 : this->FileCount;
+  int errcode = 0;
+  if (this->Internals->ThreadIds.empty())
+    {
+    errcode = this->WriteFrame(combinedImage, this->ImageWriter,
+      filename.c_str());
+    if (!errcode && this->ImageWriter)
+      {
+      this->FileCount++;
+      }
+    }
+  else
+    {
+    vtkInternals::vtkFrame frame;
+    frame.Image = combinedImage;
+    frame.FileName = filename;
+
+    vtkInternals* internals = this->Internals;
+    internals->Mutex->Lock();
+    double waitStart = vtkTimerLog::GetUniversalTime();
+    while (!internals->ErrorCode &&
+      static_cast<int>(internals->Queue.size()) >= this->MaximumQueuedFrames)
+      {
+      internals->FrameDequeued->Wait(internals->Mutex.GetPointer());
+      }
+    this->QueueWaitTime += vtkTimerLog::GetUniversalTime() - waitStart;
+    errcode = internals->ErrorCode;
+    if (!errcode)
+      {
+      internals->Queue.push_back(frame);
+      }
+    internals->Mutex->Unlock();
+    internals->FrameQueued->Signal();
+
+    if (!errcode && this->ImageWriter)
+      {
+      this->FileCount++;
+      }
+    }
+  combinedImage = 0;
 
+  if (errcode)
+    {
+    this->ErrorCode = errcode;
+    return false;
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+int vtkSMAnimationSceneImageWriter::WriteFrame(vtkImageData* image,
+  vtkImageWriter* imageWriter, const char* filename)
+{
+  vtkPVEventTraceScope scope("vtkSMAnimationSceneImageWriter::WriteFrame");
+
+  int errcode = 0;
+  double encodeTime = 0.0;
+  double writeTime = 0.0;
+  double start = vtkTimerLog::GetUniversalTime();
+  if (imageWriter)
+    {
+    imageWriter->SetInputData(image);
+    imageWriter->SetFileName(filename);
+    imageWriter->Write();
+    imageWriter->SetInputData(0);
+    errcode = imageWriter->GetErrorCode();
+    encodeTime = vtkTimerLog::GetUniversalTime() - start;
+
+    vtkUnsignedCharArray* encoded = vtkGetWriteToMemoryResult(imageWriter);
+    if (!errcode && encoded)
+      {
+      start = vtkTimerLog::GetUniversalTime();
+      size_t length = static_cast<size_t>(encoded->GetNumberOfTuples() *
+        encoded->GetNumberOfComponents());
+      FILE* fp = fopen(filename, "wb");
+      if (!fp)
+        {
+        errcode = vtkErrorCode::CannotOpenFileError;
+        }
+      else
+        {
+        if (fwrite(encoded->GetPointer(0), 1, length, fp) != length)
+          {
+          errcode = vtkErrorCode::OutOfDiskSpaceError;
+          }
+        fclose(fp);
+        }
+      writeTime = vtkTimerLog::GetUniversalTime() - start;
+      }
     }
   else if (this->MovieWriter)
     {
-    this->MovieWriter->SetInputData(combinedImage);
+    this->MovieWriter->SetInputData(image);
     this->MovieWriter->Write();
     this->MovieWriter->SetInputData(0);
+    encodeTime = vtkTimerLog::GetUniversalTime() - start;
 
     int alg_error = this->MovieWriter->GetErrorCode();
     int movie_error = this->MovieWriter->GetError();
@@ -274,14 +448,157 @@ bool vtkSMAnimationSceneImageWriter::SaveFrame(double vtkNotUsed(time))
       errcode = alg_error;
       }
     }
-  combinedImage = 0;
 
-  if (errcode)
+  this->Internals->Mutex->Lock();
+  this->EncodeTime += encodeTime;
+  this->WriteTime += writeTime;
+  this->NumberOfFramesWritten += errcode? 0 : 1;
+  this->Internals->Mutex->Unlock();
+  return errcode;
+}
+
+//-----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkSMAnimationSceneImageWriter::EncoderThread(
+  void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkSMAnimationSceneImageWriter* self =
+    static_cast<vtkSMAnimationSceneImageWriter*>(info->UserData);
+  vtkInternals* internals = self->Internals;
+
+  internals->Mutex->Lock();
+  // each thread encodes images with its own writer; movies have a single
+  // encoder thread which uses the MovieWriter.
+  vtkImageWriter* writer = NULL;
+  if (internals->NextWriter < internals->Writers.size())
     {
-    this->ErrorCode = errcode;
-    return false;
+    writer = internals->Writers[internals->NextWriter++];
+    }
+  while (true)
+    {
+    while (internals->Queue.empty() && !internals->Stop)
+      {
+      internals->FrameQueued->Wait(internals->Mutex.GetPointer());
+      }
+    if (internals->Queue.empty())
+      {
+      // stopped and the queue has been drained.
+      break;
+      }
+    vtkInternals::vtkFrame frame = internals->Queue.front();
+    internals->Queue.pop_front();
+    // once a frame failed, remaining frames are discarded.
+    bool skip = (internals->ErrorCode != 0);
+    internals->Mutex->Unlock();
+    internals->FrameDequeued->Signal();
+
+    int errcode = skip? 0 :
+      self->WriteFrame(frame.Image, writer, frame.FileName.c_str());
+    frame.Image = NULL;
+
+    internals->Mutex->Lock();
+    if (errcode && !internals->ErrorCode)
+      {
+      internals->ErrorCode = errcode;
+      }
+    }
+  internals->Mutex->Unlock();
+  // wake up the animation if it is waiting on a full queue after an error.
+  internals->FrameDequeued->Broadcast();
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//-----------------------------------------------------------------------------
+vtkImageWriter* vtkSMAnimationSceneImageWriter::NewEncoderWriter()
+{
+  if (!this->ImageWriter)
+    {
+    return NULL;
+    }
+
+  vtkImageWriter* writer = this->ImageWriter->NewInstance();
+  writer->SetFileDimensionality(this->ImageWriter->GetFileDimensionality());
+  if (vtkJPEGWriter* jpeg = vtkJPEGWriter::SafeDownCast(this->ImageWriter))
+    {
+    vtkJPEGWriter* clone = vtkJPEGWriter::SafeDownCast(writer);
+    clone->SetQuality(jpeg->GetQuality());
+    clone->SetProgressive(jpeg->GetProgressive());
+    clone->SetWriteToMemory(jpeg->GetWriteToMemory());
+    }
+  else if (vtkPNGWriter* png = vtkPNGWriter::SafeDownCast(this->ImageWriter))
+    {
+    vtkPNGWriter::SafeDownCast(writer)->SetWriteToMemory(
+      png->GetWriteToMemory());
+    }
+  else if (vtkTIFFWriter* tiff = vtkTIFFWriter::SafeDownCast(this->ImageWriter))
+    {
+    vtkTIFFWriter::SafeDownCast(writer)->SetCompression(
+      tiff->GetCompression());
+    }
+  return writer;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSMAnimationSceneImageWriter::StartEncoderThreads()
+{
+  vtkInternals* internals = this->Internals;
+  internals->Queue.clear();
+  internals->Writers.clear();
+  internals->NextWriter = 0;
+  internals->Stop = false;
+  internals->ErrorCode = 0;
+
+  int numThreads = this->NumberOfEncoderThreads;
+  if (numThreads == 0 || (!this->ImageWriter && !this->MovieWriter))
+    {
+    return;
+    }
+
+  if (this->ImageWriter)
+    {
+    for (int cc=0; cc < numThreads; cc++)
+      {
+      vtkSmartPointer<vtkImageWriter> writer;
+      writer.TakeReference(this->NewEncoderWriter());
+      internals->Writers.push_back(writer);
+      }
+    }
+  else
+    {
+    // movie encoders need the frames in order.
+    numThreads = 1;
+    }
+
+  for (int cc=0; cc < numThreads; cc++)
+    {
+    internals->ThreadIds.push_back(internals->Threader->SpawnThread(
+        &vtkSMAnimationSceneImageWriter::EncoderThread, this));
     }
-  return true;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSMAnimationSceneImageWriter::StopEncoderThreads()
+{
+  vtkInternals* internals = this->Internals;
+  if (internals->ThreadIds.empty())
+    {
+    return;
+    }
+
+  internals->Mutex->Lock();
+  internals->Stop = true;
+  internals->Mutex->Unlock();
+  internals->FrameQueued->Broadcast();
+
+  for (size_t cc=0; cc < internals->ThreadIds.size(); cc++)
+    {
+    // joins the thread.
+    internals->Threader->TerminateThread(internals->ThreadIds[cc]);
+    }
+  internals->ThreadIds.clear();
+  internals->Writers.clear();
+  internals->Queue.clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -289,6 +606,25 @@ bool vtkSMAnimationSceneImageWriter::SaveFinalize()
 {
   this->AnimationScene->SetOverrideStillRender(0);
 
+  // wait for all queued frames to be written.
+  this->StopEncoderThreads();
+  bool status = true;
+  if (this->Internals->ErrorCode)
+    {
+    this->ErrorCode = this->Internals->ErrorCode;
+    status = false;
+    }
+
+  vtkTimerLog::FormatAndMarkEvent(
+    "Save animation: %d frames, capture %.3fs, encode %.3fs, write %.3fs, "
+    "queue wait %.3fs", this->NumberOfFramesWritten, this->CaptureTime,
+    this->EncodeTime, this->WriteTime, this->QueueWaitTime);
+  vtkDebugMacro("Saved " << this->NumberOfFramesWritten << " frames. "
+    << "Capture: " << this->CaptureTime << "s, "
+    << "Encode: " << this->EncodeTime << "s, "
+    << "Write: " << this->WriteTime << "s, "
+    << "Queue wait: " << this->QueueWaitTime << "s");
+
   // TODO: If save failed, we must remove the partially
   // written files.
   if (this->MovieWriter)
@@ -312,7 +648,7 @@ bool vtkSMAnimationSceneImageWriter::SaveFinalize()
       }
     }
 #endif
-  return true;
+  return status;
 }
 
 //-----------------------------------------------------------------------------
@@ -388,6 +724,7 @@ bool vtkSMAnimationSceneImageWriter::CreateWriter()
 
   if (iwriter)
     {
+    vtkEnableWriteToMemory(iwriter);
     this->SetImageWriter(iwriter);
     iwriter->Delete();
 
@@ -455,6 +792,15 @@ void vtkSMAnimationSceneImageWriter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Subsampling: " << this->Subsampling << endl;
   os << indent << "ErrorCode: " << this->ErrorCode << endl;
   os << indent << "FrameRate: " << this->FrameRate << endl;
+  os << indent << "NumberOfEncoderThreads: "
+    << this->NumberOfEncoderThreads << endl;
+  os << indent << "MaximumQueuedFrames: " << this->MaximumQueuedFrames << endl;
+  os << indent << "CaptureTime: " << this->CaptureTime << endl;
+  os << indent << "EncodeTime: " << this->EncodeTime << endl;
+  os << indent << "WriteTime: " << this->WriteTime << endl;
+  os << indent << "QueueWaitTime: " << this->QueueWaitTime << endl;
+  os << indent << "NumberOfFramesWritten: "
+    << this->NumberOfFramesWritten << endl;
   os << indent << "BackgroundColor: " << this->BackgroundColor[0]
     << ", " << this->BackgroundColor[1] << ", " << this->BackgroundColor[2]
     << endl;
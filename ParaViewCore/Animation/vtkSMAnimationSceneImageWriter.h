@@ -24,12 +24,21 @@
 // This class does not support changing the dimensions of the view, one has to 
 // do that before calling Save(). It only provides Magnification which can scale 
 // the size using integral scale factor.
+//
+// Captured frames are handed to a bounded queue (see MaximumQueuedFrames)
+// served by NumberOfEncoderThreads threads, so that rendering the next frame
+// overlaps compressing and writing the previous ones. Image files may be
+// completed out of order but are always named in frame order. Movie formats
+// are encoded by a single thread since frames must reach the encoder in order.
+// Timings for capture, encoding and file I/O are accumulated during Save() and
+// reported through vtkTimerLog when saving finishes.
 
 #ifndef __vtkSMAnimationSceneImageWriter_h
 #define __vtkSMAnimationSceneImageWriter_h
 
 #include "vtkPVAnimationModule.h" //needed for exports
 #include "vtkSMAnimationSceneWriter.h"
+#include "vtkMultiThreader.h" // for VTK_THREAD_RETURN_TYPE
 
 class vtkGenericMovieWriter;
 class vtkImageData;
@@ -94,6 +103,34 @@ public:
   vtkSetMacro(FrameRate, double);
   vtkGetMacro(FrameRate, double);
 
+  // Description:
+  // Get/Set the number of threads used to encode and write image files.
+  // When set to 0, frames are written synchronously, before the animation
+  // advances to the next frame. Movie files always use a single encoder
+  // thread unless set to 0. Default is 2.
+  vtkSetClampMacro(NumberOfEncoderThreads, int, 0, 64);
+  vtkGetMacro(NumberOfEncoderThreads, int);
+
+  // Description:
+  // Get/Set the maximum number of captured frames waiting to be encoded. When
+  // the queue is full, the animation waits for the encoder threads to catch
+  // up, which bounds the memory used. Default is 4.
+  vtkSetClampMacro(MaximumQueuedFrames, int, 1, VTK_INT_MAX);
+  vtkGetMacro(MaximumQueuedFrames, int);
+
+  // Description:
+  // Statistics from the last Save(), in seconds. CaptureTime is the time spent
+  // rendering and reading back the views, EncodeTime the time spent
+  // compressing frames, WriteTime the time spent writing encoded bytes to disk
+  // (included in EncodeTime for writers that cannot encode to memory) and
+  // QueueWaitTime the time the animation was stalled on a full queue. Encode
+  // and write times are summed over all encoder threads.
+  vtkGetMacro(CaptureTime, double);
+  vtkGetMacro(EncodeTime, double);
+  vtkGetMacro(WriteTime, double);
+  vtkGetMacro(QueueWaitTime, double);
+  vtkGetMacro(NumberOfFramesWritten, int);
+
 
   // Description:
   // Convenience method used to merge a smaller image (\c src) into a 
@@ -133,6 +170,24 @@ protected:
 
   vtkImageData* NewFrame();
 
+  // Description:
+  // Encode and write a single frame, using the given image writer or the
+  // movie writer when imageWriter is NULL. Returns the error code. Called
+  // from the encoder threads when NumberOfEncoderThreads > 0.
+  int WriteFrame(vtkImageData* image, vtkImageWriter* imageWriter,
+    const char* filename);
+
+  // Description:
+  // Returns a new writer of the same type as ImageWriter and with the same
+  // settings (e.g. JPEG quality, TIFF compression), for use by an encoder
+  // thread. Returns NULL when there is no ImageWriter.
+  vtkImageWriter* NewEncoderWriter();
+
+  // Description:
+  // Start/stop the encoder threads.
+  void StartEncoderThreads();
+  void StopEncoderThreads();
+
   vtkSetVector2Macro(ActualSize, int);
   int ActualSize[2];
   int Quality;
@@ -150,6 +205,14 @@ protected:
   double BackgroundColor[3];
   double FrameRate;
 
+  int NumberOfEncoderThreads;
+  int MaximumQueuedFrames;
+  double CaptureTime;
+  double EncodeTime;
+  double WriteTime;
+  double QueueWaitTime;
+  int NumberOfFramesWritten;
+
   vtkImageWriter* ImageWriter;
   vtkGenericMovieWriter* MovieWriter;
 
@@ -158,6 +221,10 @@ protected:
 private:
   vtkSMAnimationSceneImageWriter(const vtkSMAnimationSceneImageWriter&); // Not implemented.
   void operator=(const vtkSMAnimationSceneImageWriter&); // Not implemented.
+
+  class vtkInternals;
+  vtkInternals* Internals;
+  static VTK_THREAD_RETURN_TYPE EncoderThread(void* arg);
 };
 
 
@@ -0,0 +1,225 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVInformationCodec.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Round-trips the information types exchanged between client and server
+// through vtkPVInformationCodec, both in full and as deltas, and checks that
+// a delta that cannot be applied is rejected and invalidates the cache entry.
+
+#include "vtkClientServerStream.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPVArrayInformation.h"
+#include "vtkPVClassNameInformation.h"
+#include "vtkPVDataInformation.h"
+#include "vtkPVDataSetAttributesInformation.h"
+#include "vtkPVDataSizeInformation.h"
+#include "vtkPVInformationCodec.h"
+#include "vtkPVSession.h"
+#include "vtkSmartPointer.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  const int NumberOfBlocks = 20;
+
+  vtkSmartPointer<vtkPolyData> NewBlock(int block, double scale)
+    {
+    vtkNew<vtkPoints> points;
+    vtkNew<vtkFloatArray> pressure;
+    pressure->SetName("Pressure");
+    vtkNew<vtkDoubleArray> velocity;
+    velocity->SetName("Velocity");
+    velocity->SetNumberOfComponents(3);
+    velocity->SetComponentName(0, "U");
+    velocity->SetComponentName(1, "V");
+    velocity->SetComponentName(2, "W");
+    for (int cc = 0; cc < 100; ++cc)
+      {
+      points->InsertNextPoint(cc, block, 0.5 * cc);
+      pressure->InsertNextValue(static_cast<float>(scale * (cc + block)));
+      velocity->InsertNextTuple3(cc, -block, scale);
+      }
+    vtkSmartPointer<vtkPolyData> pd = vtkSmartPointer<vtkPolyData>::New();
+    pd->SetPoints(points.GetPointer());
+    pd->GetPointData()->AddArray(pressure.GetPointer());
+    pd->GetPointData()->AddArray(velocity.GetPointer());
+    return pd;
+    }
+
+  vtkSmartPointer<vtkMultiBlockDataSet> NewDataSet(double scale)
+    {
+    vtkSmartPointer<vtkMultiBlockDataSet> mb =
+      vtkSmartPointer<vtkMultiBlockDataSet>::New();
+    for (int cc = 0; cc < NumberOfBlocks; ++cc)
+      {
+      mb->SetBlock(cc, NewBlock(cc, scale));
+      }
+    vtkNew<vtkImageData> image;
+    image->SetDimensions(4, 5, 6);
+    vtkNew<vtkIntArray> ids;
+    ids->SetName("Ids");
+    for (int cc = 0; cc < 4 * 5 * 6; ++cc)
+      {
+      ids->InsertNextValue(cc);
+      }
+    image->GetPointData()->SetScalars(ids.GetPointer());
+    mb->SetBlock(NumberOfBlocks, image.GetPointer());
+    return mb;
+    }
+
+  std::vector<unsigned char> GetStreamData(vtkPVInformation* info)
+    {
+    vtkClientServerStream css;
+    info->CopyToStream(&css);
+    const unsigned char* data;
+    size_t length;
+    css.GetData(&data, &length);
+    return std::vector<unsigned char>(data, data + length);
+    }
+
+  // Checks that info survives Encode()/Decode() unchanged.
+  bool RoundTrip(vtkPVInformation* info)
+    {
+    std::vector<unsigned char> buffer;
+    vtkPVInformationCodec::CopyToBuffer(info, buffer);
+    vtkSmartPointer<vtkPVInformation> copy;
+    copy.TakeReference(info->NewInstance());
+    if (buffer.empty() || !vtkPVInformationCodec::CopyFromBuffer(
+        copy, &buffer[0], buffer.size()))
+      {
+      std::cerr << "Failed to decode " << info->GetClassName() << std::endl;
+      return false;
+      }
+    if (GetStreamData(copy) != GetStreamData(info))
+      {
+      std::cerr << info->GetClassName() << " changed in the round trip."
+                << std::endl;
+      return false;
+      }
+    return true;
+    }
+}
+
+int TestPVInformationCodec(int, char*[])
+{
+  vtkSmartPointer<vtkMultiBlockDataSet> data = NewDataSet(1.0);
+
+  vtkNew<vtkPVDataInformation> dataInfo;
+  dataInfo->CopyFromObject(data);
+  vtkNew<vtkPVDataSetAttributesInformation> attributesInfo;
+  attributesInfo->CopyFromDataSetAttributes(
+    vtkPolyData::SafeDownCast(data->GetBlock(0))->GetPointData());
+  vtkNew<vtkPVArrayInformation> arrayInfo;
+  arrayInfo->CopyFromObject(
+    vtkPolyData::SafeDownCast(data->GetBlock(0))->GetPointData()->
+    GetArray("Velocity"));
+  vtkNew<vtkPVClassNameInformation> classNameInfo;
+  classNameInfo->CopyFromObject(data);
+  vtkNew<vtkPVDataSizeInformation> dataSizeInfo;
+  dataSizeInfo->CopyFromObject(data);
+
+  vtkPVInformation* infos[] = {
+    dataInfo.GetPointer(), attributesInfo.GetPointer(),
+    arrayInfo.GetPointer(), classNameInfo.GetPointer(),
+    dataSizeInfo.GetPointer() };
+  for (size_t cc = 0; cc < sizeof(infos) / sizeof(infos[0]); ++cc)
+    {
+    if (!RoundTrip(infos[cc]))
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  // The array names repeated in every block are only stored once.
+  std::vector<unsigned char> buffer;
+  vtkPVInformationCodec::CopyToBuffer(dataInfo.GetPointer(), buffer);
+  if (buffer.size() >= GetStreamData(dataInfo.GetPointer()).size())
+    {
+    std::cerr << "Columnar encoding is not smaller than the raw stream: "
+              << buffer.size() << " bytes." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Full reply, then a delta after the values changed.
+  vtkNew<vtkPVInformationCodec> server;
+  vtkNew<vtkPVInformationCodec> client;
+  const std::string key = vtkPVInformationCodec::GetRequestKey(
+    dataInfo.GetPointer(), vtkPVSession::DATA_SERVER, 1);
+
+  std::vector<unsigned char> reply;
+  server->EncodeReply(key, client->GetCachedVersion(key),
+    dataInfo.GetPointer(), reply);
+  vtkNew<vtkPVDataInformation> received;
+  if (!client->DecodeReply(key, &reply[0], reply.size(),
+      received.GetPointer()) ||
+    GetStreamData(received.GetPointer()) !=
+    GetStreamData(dataInfo.GetPointer()) ||
+    client->GetCachedVersion(key) == 0)
+    {
+    std::cerr << "Full reply was not decoded correctly." << std::endl;
+    return EXIT_FAILURE;
+    }
+  const size_t fullSize = reply.size();
+
+  vtkNew<vtkPVDataInformation> modifiedInfo;
+  modifiedInfo->CopyFromObject(NewDataSet(2.0));
+  server->EncodeReply(key, client->GetCachedVersion(key),
+    modifiedInfo.GetPointer(), reply);
+  if (reply.size() >= fullSize)
+    {
+    std::cerr << "Delta reply (" << reply.size()
+              << " bytes) is not smaller than the full reply (" << fullSize
+              << " bytes)." << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::vector<unsigned char> delta = reply;
+  vtkNew<vtkPVDataInformation> updated;
+  if (!client->DecodeReply(key, &reply[0], reply.size(),
+      updated.GetPointer()) ||
+    GetStreamData(updated.GetPointer()) !=
+    GetStreamData(modifiedInfo.GetPointer()))
+    {
+    std::cerr << "Delta reply was not decoded correctly." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // A client whose cached buffer does not match the base of the delta must
+  // reject it and drop its entry so that the full information is requested.
+  vtkNew<vtkPVInformationCodec> staleClient;
+  server->EncodeReply(key, 0, dataInfo.GetPointer(), reply);
+  staleClient->DecodeReply(key, &reply[0], reply.size(),
+    received.GetPointer());
+  server->EncodeReply(key, 0, modifiedInfo.GetPointer(), reply);
+  staleClient->DecodeReply(key, &reply[0], reply.size(),
+    received.GetPointer());
+  if (staleClient->DecodeReply(key, &delta[0], delta.size(),
+      received.GetPointer()) ||
+    staleClient->GetCachedVersion(key) != 0)
+    {
+    std::cerr << "A delta against another base was accepted." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,232 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestTimeParallelExtractArraysOverTime.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Extracts two points over time with vtkPVExtractArraysOverTime in
+// time-parallel mode and checks that the tables gathered on the root process
+// are identical to the ones of a serial extraction.
+
+#include "vtkCompositeDataSet.h"
+#include "vtkDoubleArray.h"
+#include "vtkDummyController.h"
+#include "vtkIdTypeArray.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMPIController.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkPVExtractArraysOverTime.h"
+#include "vtkSelection.h"
+#include "vtkSelectionNode.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTable.h"
+
+#include <iostream>
+#include <string>
+
+namespace
+{
+  const int NumberOfPoints = 40;
+  const int NumberOfTimeSteps = 10;
+
+  // Points with global ids whose "Value" depends on the time and the id. Any
+  // piece can be produced.
+  class vtkTemporalPointSource : public vtkPolyDataAlgorithm
+  {
+  public:
+    static vtkTemporalPointSource* New();
+    vtkTypeMacro(vtkTemporalPointSource, vtkPolyDataAlgorithm);
+
+  protected:
+    vtkTemporalPointSource() { this->SetNumberOfInputPorts(0); }
+
+    int RequestInformation(vtkInformation*, vtkInformationVector**,
+      vtkInformationVector* outputVector)
+      {
+      vtkInformation* outInfo = outputVector->GetInformationObject(0);
+      double times[NumberOfTimeSteps];
+      for (int cc = 0; cc < NumberOfTimeSteps; ++cc)
+        {
+        times[cc] = 0.5 * cc;
+        }
+      outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(), times,
+        NumberOfTimeSteps);
+      double range[2] = { times[0], times[NumberOfTimeSteps - 1] };
+      outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), range, 2);
+      outInfo->Set(vtkStreamingDemandDrivenPipeline::MAXIMUM_NUMBER_OF_PIECES(),
+        -1);
+      return 1;
+      }
+
+    int RequestData(vtkInformation*, vtkInformationVector**,
+      vtkInformationVector* outputVector)
+      {
+      vtkInformation* outInfo = outputVector->GetInformationObject(0);
+      double time = outInfo->Get(
+        vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP());
+      int piece = outInfo->Get(
+        vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER());
+      int numPieces = outInfo->Get(
+        vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES());
+
+      vtkNew<vtkPoints> points;
+      vtkNew<vtkIdTypeArray> ids;
+      ids->SetName("GlobalIds");
+      vtkNew<vtkDoubleArray> values;
+      values->SetName("Value");
+      for (int id = piece * NumberOfPoints / numPieces;
+        id < (piece + 1) * NumberOfPoints / numPieces; ++id)
+        {
+        points->InsertNextPoint(id, 0, 0);
+        ids->InsertNextValue(id);
+        values->InsertNextValue(100.0 * time + id);
+        }
+
+      vtkPolyData* output = vtkPolyData::GetData(outInfo);
+      output->SetPoints(points.GetPointer());
+      output->GetPointData()->SetGlobalIds(ids.GetPointer());
+      output->GetPointData()->AddArray(values.GetPointer());
+      output->GetInformation()->Set(vtkDataObject::DATA_TIME_STEP(), time);
+      return 1;
+      }
+  };
+  vtkStandardNewMacro(vtkTemporalPointSource);
+
+  void Extract(vtkMultiProcessController* controller, int groupSize,
+    vtkMultiBlockDataSet* result)
+    {
+    vtkNew<vtkSelectionNode> node;
+    node->SetContentType(vtkSelectionNode::GLOBALIDS);
+    node->SetFieldType(vtkSelectionNode::POINT);
+    vtkNew<vtkIdTypeArray> ids;
+    ids->InsertNextValue(3);
+    ids->InsertNextValue(NumberOfPoints - 5);
+    node->SetSelectionList(ids.GetPointer());
+    vtkNew<vtkSelection> selection;
+    selection->AddNode(node.GetPointer());
+
+    vtkNew<vtkTemporalPointSource> source;
+    vtkNew<vtkPVExtractArraysOverTime> extract;
+    extract->SetController(controller);
+    extract->SetTimeParallelGroupSize(groupSize);
+    extract->SetInputConnection(0, source->GetOutputPort());
+    extract->SetInputData(1, selection.GetPointer());
+    extract->UpdateInformation();
+    vtkStreamingDemandDrivenPipeline::SafeDownCast(extract->GetExecutive())->
+      SetUpdateExtent(0, controller->GetLocalProcessId(),
+        controller->GetNumberOfProcesses(), 0);
+    extract->Update();
+    result->ShallowCopy(extract->GetOutputDataObject(0));
+    }
+
+  bool SameTables(vtkTable* expected, vtkTable* actual, const char* name)
+    {
+    if (!actual || expected->GetNumberOfRows() != actual->GetNumberOfRows())
+      {
+      std::cerr << name << ": missing or wrong number of rows." << std::endl;
+      return false;
+      }
+    vtkDataSetAttributes* rows = expected->GetRowData();
+    for (int col = 0; col < rows->GetNumberOfArrays(); ++col)
+      {
+      vtkDataArray* column = rows->GetArray(col);
+      vtkDataArray* other = column?
+        actual->GetRowData()->GetArray(column->GetName()) : NULL;
+      if (!column)
+        {
+        continue;
+        }
+      if (!other ||
+        other->GetNumberOfComponents() != column->GetNumberOfComponents())
+        {
+        std::cerr << name << ": column " << column->GetName()
+                  << " is missing." << std::endl;
+        return false;
+        }
+      for (vtkIdType row = 0; row < column->GetNumberOfTuples(); ++row)
+        {
+        for (int comp = 0; comp < column->GetNumberOfComponents(); ++comp)
+          {
+          if (column->GetComponent(row, comp) != other->GetComponent(row, comp))
+            {
+            std::cerr << name << ": column " << column->GetName()
+                      << " differs at row " << row << std::endl;
+            return false;
+            }
+          }
+        }
+      }
+    return true;
+    }
+}
+
+int TestTimeParallelExtractArraysOverTime(int argc, char* argv[])
+{
+  vtkNew<vtkMPIController> controller;
+  controller->Initialize(&argc, &argv, 0);
+  vtkMultiProcessController::SetGlobalController(controller.GetPointer());
+  const int rank = controller->GetLocalProcessId();
+
+  // reference: the root process extracts all the points on its own.
+  vtkNew<vtkMultiBlockDataSet> expected;
+  if (rank == 0)
+    {
+    vtkNew<vtkDummyController> serial;
+    Extract(serial.GetPointer(), 0, expected.GetPointer());
+    }
+
+  // each process is a group of its own and handles a range of time steps.
+  vtkNew<vtkMultiBlockDataSet> actual;
+  Extract(controller.GetPointer(), 1, actual.GetPointer());
+
+  int status = 1;
+  if (rank == 0)
+    {
+    if (expected->GetNumberOfBlocks() != 2 ||
+      actual->GetNumberOfBlocks() != expected->GetNumberOfBlocks())
+      {
+      std::cerr << "Expected 2 blocks, got " << expected->GetNumberOfBlocks()
+                << " and " << actual->GetNumberOfBlocks() << std::endl;
+      status = 0;
+      }
+    for (unsigned int cc = 0; status && cc < expected->GetNumberOfBlocks();
+      ++cc)
+      {
+      const char* name =
+        expected->GetMetaData(cc)->Get(vtkCompositeDataSet::NAME());
+      vtkTable* match = NULL;
+      for (unsigned int other = 0; other < actual->GetNumberOfBlocks();
+        ++other)
+        {
+        const char* otherName =
+          actual->GetMetaData(other)->Get(vtkCompositeDataSet::NAME());
+        if (name && otherName && std::string(name) == otherName)
+          {
+          match = vtkTable::SafeDownCast(actual->GetBlock(other));
+          }
+        }
+      status = SameTables(vtkTable::SafeDownCast(expected->GetBlock(cc)),
+        match, name? name : "(unnamed)")? 1 : 0;
+      }
+    }
+  controller->Broadcast(&status, 1, 0);
+
+  vtkMultiProcessController::SetGlobalController(NULL);
+  controller->Finalize();
+  return status? EXIT_SUCCESS : EXIT_FAILURE;
+}
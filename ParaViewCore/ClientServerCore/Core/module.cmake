@@ -34,6 +34,8 @@ vtk_module(vtkPVClientServerCoreCore
   # This ensures that CS wrappings will be generated 
     vtkUtilitiesWrapClientServer
     ${__compile_dependencies}
+  TEST_DEPENDS
+    vtkTestingCore
   TEST_LABELS
     PARAVIEW
   KIT
@@ -14,9 +14,115 @@
 =========================================================================*/
 #include "vtkPVExtractArraysOverTime.h"
 
+#include "vtkCompositeDataSet.h"
+#include "vtkDataArray.h"
+#include "vtkDataSetAttributes.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkMultiProcessController.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVExtractSelection.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTable.h"
+#include "vtkVariant.h"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+class vtkPVExtractArraysOverTime::vtkInternals
+{
+public:
+  // Controller for the processes of the local group, NULL when time-parallel
+  // execution is not in use.
+  vtkSmartPointer<vtkMultiProcessController> GroupController;
+  vtkMultiProcessController* PartitionedController;
+  int GroupSize;
+  int NumberOfGroups;
+  int GroupId;
+
+  // Time steps of the input and the first time step of each group (with an
+  // extra entry for the end).
+  std::vector<double> TimeSteps;
+  std::vector<int> GroupOffsets;
+
+  vtkInternals() : PartitionedController(NULL), GroupSize(0),
+    NumberOfGroups(0), GroupId(0)
+    {
+    }
+
+  void Reset()
+    {
+    this->GroupController = NULL;
+    this->PartitionedController = NULL;
+    this->GroupSize = this->NumberOfGroups = this->GroupId = 0;
+    this->GroupOffsets.clear();
+    }
+
+  int GetTimeStepOffset() const
+    {
+    return this->GroupController? this->GroupOffsets[this->GroupId] : 0;
+    }
+};
+
+namespace
+{
+  enum
+    {
+    TIME_GROUP_DATA = 9822
+    };
+
+  std::string GetBlockName(vtkMultiBlockDataSet* mb, unsigned int index)
+    {
+    vtkInformation* metadata = mb->HasMetaData(index)?
+      mb->GetMetaData(index) : NULL;
+    if (metadata && metadata->Has(vtkCompositeDataSet::NAME()))
+      {
+      return metadata->Get(vtkCompositeDataSet::NAME());
+      }
+    return "Block " + vtkVariant(index).ToString();
+    }
+
+  // Appends `count` rows to `dest`, taken from `source` when it provides them
+  // or filled with zeros otherwise (which also marks them invalid in the
+  // vtkValidPointMask array).
+  void AppendRows(vtkAbstractArray* dest, vtkAbstractArray* source,
+    vtkIdType count)
+    {
+    if (source && source->GetNumberOfTuples() == count &&
+      source->GetNumberOfComponents() == dest->GetNumberOfComponents())
+      {
+      for (vtkIdType cc = 0; cc < count; ++cc)
+        {
+        dest->InsertNextTuple(cc, source);
+        }
+      return;
+      }
+
+    vtkDataArray* da = vtkDataArray::SafeDownCast(dest);
+    std::vector<double> zeros(dest->GetNumberOfComponents(), 0.0);
+    for (vtkIdType cc = 0; cc < count; ++cc)
+      {
+      if (da)
+        {
+        da->InsertNextTuple(zeros.empty()? NULL : &zeros[0]);
+        }
+      else
+        {
+        vtkIdType start =
+          dest->GetNumberOfTuples() * dest->GetNumberOfComponents();
+        for (int comp = 0; comp < dest->GetNumberOfComponents(); ++comp)
+          {
+          dest->InsertVariantValue(start + comp, vtkVariant());
+          }
+        }
+      }
+    }
+}
 
 vtkStandardNewMacro(vtkPVExtractArraysOverTime);
 
@@ -25,15 +131,246 @@ vtkPVExtractArraysOverTime::vtkPVExtractArraysOverTime()
 {
   vtkNew<vtkPVExtractSelection> se;
   this->SetSelectionExtractor(se.GetPointer());
+  this->TimeParallelGroupSize = 0;
+  this->Internals = new vtkInternals();
 }
 
 //----------------------------------------------------------------------------
 vtkPVExtractArraysOverTime::~vtkPVExtractArraysOverTime()
 {
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVExtractArraysOverTime::RequestInformation(vtkInformation* request,
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  if (!this->Superclass::RequestInformation(request, inputVector, outputVector))
+    {
+    return 0;
+    }
+
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  this->Internals->TimeSteps.clear();
+  if (inInfo->Has(vtkStreamingDemandDrivenPipeline::TIME_STEPS()))
+    {
+    const double* inTimes =
+      inInfo->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+    this->Internals->TimeSteps.assign(inTimes,
+      inTimes + inInfo->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS()));
+    }
+  this->SetupTimeGroups(static_cast<int>(this->Internals->TimeSteps.size()));
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVExtractArraysOverTime::SetupTimeGroups(int numberOfTimeSteps)
+{
+  vtkInternals& internals = *this->Internals;
+  int numProcs = this->Controller?
+    this->Controller->GetNumberOfProcesses() : 1;
+  if (this->TimeParallelGroupSize <= 0 ||
+    this->TimeParallelGroupSize >= numProcs || numberOfTimeSteps <= 1)
+    {
+    internals.Reset();
+    return;
+    }
+
+  // there's no point in having more groups than time steps.
+  int groupSize = this->TimeParallelGroupSize;
+  int numGroups = std::min(numProcs / groupSize, numberOfTimeSteps);
+  int rank = this->Controller->GetLocalProcessId();
+  int groupId = std::min(rank / groupSize, numGroups - 1);
+
+  if (!internals.GroupController ||
+    internals.PartitionedController != this->Controller ||
+    internals.GroupSize != groupSize || internals.NumberOfGroups != numGroups)
+    {
+    vtkMultiProcessController* group =
+      this->Controller->PartitionController(groupId, rank);
+    if (!group)
+      {
+      vtkWarningMacro("Failed to split the processes in time-parallel groups. "
+        "Time steps will be processed sequentially.");
+      internals.Reset();
+      return;
+      }
+    internals.GroupController.TakeReference(group);
+    internals.PartitionedController = this->Controller;
+    internals.GroupSize = groupSize;
+    internals.NumberOfGroups = numGroups;
+    internals.GroupId = groupId;
+    }
+
+  internals.GroupOffsets.resize(numGroups + 1);
+  for (int cc = 0; cc <= numGroups; ++cc)
+    {
+    internals.GroupOffsets[cc] = static_cast<int>(
+      (static_cast<vtkIdType>(numberOfTimeSteps) * cc) / numGroups);
+    }
+
+  // the superclass iterates over NumberOfTimeSteps steps; restrict it to the
+  // steps of this group. RequestUpdateExtent() offsets the requested times.
+  this->NumberOfTimeSteps = internals.GroupOffsets[groupId + 1] -
+    internals.GroupOffsets[groupId];
+}
+
+//----------------------------------------------------------------------------
+int vtkPVExtractArraysOverTime::RequestUpdateExtent(vtkInformation* request,
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  if (!this->Superclass::RequestUpdateExtent(request, inputVector, outputVector))
+    {
+    return 0;
+    }
+
+  vtkInternals& internals = *this->Internals;
+  if (!internals.GroupController)
+    {
+    return 1;
+    }
+
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  int index = internals.GetTimeStepOffset() + this->CurrentTimeIndex;
+  if (index < static_cast<int>(internals.TimeSteps.size()))
+    {
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP(),
+      internals.TimeSteps[index]);
+    }
+
+  // the processes of a group share the pieces of the input.
+  inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER(),
+    internals.GroupController->GetLocalProcessId());
+  inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES(),
+    internals.GroupController->GetNumberOfProcesses());
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVExtractArraysOverTime::PostExecute(vtkInformation* request,
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkInternals& internals = *this->Internals;
+  if (!internals.GroupController)
+    {
+    this->Superclass::PostExecute(request, inputVector, outputVector);
+    return;
+    }
+
+  // merge the pieces within the group on the group's root, then gather the
+  // groups.
+  vtkMultiProcessController* controller = this->Controller;
+  this->Controller = internals.GroupController;
+  this->Superclass::PostExecute(request, inputVector, outputVector);
+  this->Controller = controller;
+
+  this->GatherTimeGroups(vtkMultiBlockDataSet::GetData(outputVector, 0));
+}
+
+//----------------------------------------------------------------------------
+void vtkPVExtractArraysOverTime::GatherTimeGroups(vtkMultiBlockDataSet* output)
+{
+  vtkInternals& internals = *this->Internals;
+  int rank = this->Controller->GetLocalProcessId();
+  if (rank != 0)
+    {
+    // only the root of each group has data.
+    if (internals.GroupController->GetLocalProcessId() == 0)
+      {
+      this->Controller->Send(output, 0, TIME_GROUP_DATA);
+      output->Initialize();
+      }
+    return;
+    }
+
+  std::vector<vtkSmartPointer<vtkMultiBlockDataSet> > groups(
+    internals.NumberOfGroups);
+  groups[0] = vtkSmartPointer<vtkMultiBlockDataSet>::New();
+  groups[0]->ShallowCopy(output);
+  for (int cc = 1; cc < internals.NumberOfGroups; ++cc)
+    {
+    groups[cc] = vtkSmartPointer<vtkMultiBlockDataSet>::New();
+    this->Controller->Receive(groups[cc], cc * internals.GroupSize,
+      TIME_GROUP_DATA);
+    }
+
+  // match the tables of the groups by block name, in order of appearance.
+  std::vector<std::string> names;
+  std::map<std::string, std::vector<vtkTable*> > tables;
+  for (int cc = 0; cc < internals.NumberOfGroups; ++cc)
+    {
+    for (unsigned int block = 0; block < groups[cc]->GetNumberOfBlocks();
+      ++block)
+      {
+      vtkTable* table = vtkTable::SafeDownCast(groups[cc]->GetBlock(block));
+      if (!table)
+        {
+        continue;
+        }
+      std::string name = GetBlockName(groups[cc], block);
+      if (tables.find(name) == tables.end())
+        {
+        names.push_back(name);
+        tables[name].resize(internals.NumberOfGroups, NULL);
+        }
+      tables[name][cc] = table;
+      }
+    }
+
+  output->Initialize();
+  output->SetNumberOfBlocks(static_cast<unsigned int>(names.size()));
+  for (size_t cc = 0; cc < names.size(); ++cc)
+    {
+    const std::vector<vtkTable*>& parts = tables[names[cc]];
+    vtkTable* first = NULL;
+    for (size_t part = 0; !first && part < parts.size(); ++part)
+      {
+      first = parts[part];
+      }
+
+    vtkNew<vtkTable> table;
+    vtkDataSetAttributes* rowData = first->GetRowData();
+    for (int col = 0; col < rowData->GetNumberOfArrays(); ++col)
+      {
+      vtkAbstractArray* source = rowData->GetAbstractArray(col);
+      vtkAbstractArray* column = source->NewInstance();
+      column->SetName(source->GetName());
+      column->SetNumberOfComponents(source->GetNumberOfComponents());
+      column->Allocate(static_cast<vtkIdType>(internals.TimeSteps.size()) *
+        source->GetNumberOfComponents());
+      for (int group = 0; group < internals.NumberOfGroups; ++group)
+        {
+        AppendRows(column,
+          parts[group]? parts[group]->GetRowData()->GetAbstractArray(
+            source->GetName()) : NULL,
+          internals.GroupOffsets[group + 1] - internals.GroupOffsets[group]);
+        }
+      table->AddColumn(column);
+      column->Delete();
+      }
+
+    // rows for which a group had no data are not filled in; use the input
+    // time steps for the time column.
+    vtkDataArray* time = table->GetRowData()->GetArray("Time");
+    if (time && time->GetNumberOfTuples() ==
+      static_cast<vtkIdType>(internals.TimeSteps.size()))
+      {
+      for (vtkIdType row = 0; row < time->GetNumberOfTuples(); ++row)
+        {
+        time->SetTuple1(row, internals.TimeSteps[row]);
+        }
+      }
+
+    output->SetBlock(static_cast<unsigned int>(cc), table.GetPointer());
+    output->GetMetaData(static_cast<unsigned int>(cc))->Set(
+      vtkCompositeDataSet::NAME(), names[cc].c_str());
+    }
 }
 
 //----------------------------------------------------------------------------
 void vtkPVExtractArraysOverTime::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+  os << indent << "TimeParallelGroupSize: "
+     << this->TimeParallelGroupSize << endl;
 }
@@ -18,6 +18,12 @@
 // that overrides the default SelectionExtractor with a vtkPVExtractSelection
 // instance.
 // This enables query selections to be extracted at each time step.
+//
+// In addition, vtkPVExtractArraysOverTime supports a time-parallel mode (see
+// SetTimeParallelGroupSize()) in which the processes are split into groups
+// that each iterate over a contiguous range of the time steps, with the
+// processes of a group sharing the spatial pieces of the input. The rows
+// extracted by each group are gathered on the root process at the end.
 // .SECTION See Also
 // vtkExtractArraysOverTime
 // vtkPExtractArraysOverTime
@@ -28,6 +34,8 @@
 #include "vtkPVClientServerCoreCoreModule.h" // For export macro
 #include "vtkPExtractArraysOverTime.h"
 
+class vtkMultiBlockDataSet;
+
 class VTKPVCLIENTSERVERCORECORE_EXPORT vtkPVExtractArraysOverTime : public vtkPExtractArraysOverTime
 {
 public:
@@ -35,13 +43,49 @@ public:
   vtkTypeMacro(vtkPVExtractArraysOverTime,vtkPExtractArraysOverTime);
   void PrintSelf(ostream& os, vtkIndent indent);
 
+  // Description:
+  // Number of processes in each time-parallel group. When set to a value
+  // smaller than the number of processes, the processes are split into
+  // groups of this size (the remaining processes join the last group) and
+  // each group extracts a contiguous range of the time steps, requesting
+  // pieces of the input among its own processes only. 0 (the default)
+  // disables time-parallel execution.
+  // Since the processes of different groups execute the upstream pipeline for
+  // different time steps, this must only be used when the upstream pipeline
+  // does not communicate across processes (e.g. readers that can provide any
+  // piece followed by filters that do not exchange data).
+  vtkSetClampMacro(TimeParallelGroupSize, int, 0, VTK_INT_MAX);
+  vtkGetMacro(TimeParallelGroupSize, int);
+
 protected:
   vtkPVExtractArraysOverTime();
   ~vtkPVExtractArraysOverTime();
 
+  virtual int RequestInformation(vtkInformation* request,
+    vtkInformationVector** inputVector, vtkInformationVector* outputVector);
+  virtual int RequestUpdateExtent(vtkInformation* request,
+    vtkInformationVector** inputVector, vtkInformationVector* outputVector);
+  virtual void PostExecute(vtkInformation* request,
+    vtkInformationVector** inputVector, vtkInformationVector* outputVector);
+
+  // Description:
+  // Sets up the time-parallel groups for the given total number of time steps
+  // and restricts NumberOfTimeSteps to the steps of the local group.
+  void SetupTimeGroups(int numberOfTimeSteps);
+
+  // Description:
+  // Gathers the rows extracted by all time-parallel groups on the root
+  // process, in time step order.
+  void GatherTimeGroups(vtkMultiBlockDataSet* output);
+
+  int TimeParallelGroupSize;
+
 private:
   vtkPVExtractArraysOverTime(const vtkPVExtractArraysOverTime&);  // Not implemented.
   void operator=(const vtkPVExtractArraysOverTime&);  // Not implemented.
+
+  class vtkInternals;
+  vtkInternals* Internals;
 };
 
 #endif // __vtkPVExtractArraysOverTime_h
@@ -0,0 +1,1200 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVInformationCodec.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVInformationCodec.h"
+
+#include "vtkByteSwap.h"
+#include "vtkClientServerStream.h"
+#include "vtkMultiProcessStream.h"
+#include "vtkObjectFactory.h"
+#include "vtkPVInformation.h"
+
+#include <algorithm>
+#include <map>
+#include <string.h>
+#include <vtksys/ios/sstream>
+
+namespace
+{
+  // A columnar buffer is laid out as:
+  //   "PVCI", format version, byte order, number of columns,
+  //   then for each column its length (varint) followed by its bytes.
+  // A delta is laid out as:
+  //   "PVCD", format version, base length (varint), base checksum,
+  //   number of sections (varint), then for each section a mode byte
+  //   followed by the data for that mode.
+  // The sections of a columnar buffer are its header and its columns; any
+  // other buffer is a single section.
+  const unsigned char ColumnarMagic[4] = { 'P', 'V', 'C', 'I' };
+  const unsigned char DeltaMagic[4] = { 'P', 'V', 'C', 'D' };
+  const unsigned char FormatVersion = 1;
+  const size_t ColumnarHeaderSize = 7;
+  const size_t DeltaBlockSize = 32;
+
+  // Or'ed to the uint8_array type for unsigned char arrays that hold a
+  // nested stream.
+  const unsigned char NestedStreamFlag = 0x80;
+
+  enum
+    {
+    STRUCTURE = 0,
+    STRINGS,
+    VALUES1,
+    VALUES2,
+    VALUES4,
+    VALUES8,
+    NUMBER_OF_COLUMNS
+    };
+
+  enum
+    {
+    SECTION_UNCHANGED = 0,
+    SECTION_REPLACED,
+    SECTION_PATCHED
+    };
+
+  typedef std::vector<std::pair<const unsigned char*, size_t> > SectionsType;
+
+  //----------------------------------------------------------------------------
+  unsigned char GetNativeByteOrder()
+    {
+#ifdef VTK_WORDS_BIGENDIAN
+    return 1;
+#else
+    return 0;
+#endif
+    }
+
+  //----------------------------------------------------------------------------
+  int GetValueColumn(size_t size)
+    {
+    switch (size)
+      {
+    case 1: return VALUES1;
+    case 2: return VALUES2;
+    case 4: return VALUES4;
+    default: return VALUES8;
+      }
+    }
+
+  //----------------------------------------------------------------------------
+  void AppendBytes(std::vector<unsigned char>& out, const void* data,
+    size_t length)
+    {
+    if (length > 0)
+      {
+      const unsigned char* bytes = static_cast<const unsigned char*>(data);
+      out.insert(out.end(), bytes, bytes + length);
+      }
+    }
+
+  //----------------------------------------------------------------------------
+  void AppendVarInt(std::vector<unsigned char>& out, vtkTypeUInt64 value)
+    {
+    while (value >= 0x80)
+      {
+      out.push_back(static_cast<unsigned char>(value | 0x80));
+      value >>= 7;
+      }
+    out.push_back(static_cast<unsigned char>(value));
+    }
+
+  //----------------------------------------------------------------------------
+  // Fixed size integers that are not part of a columnar buffer are always
+  // written little-endian.
+  void AppendUInt32(std::vector<unsigned char>& out, vtkTypeUInt32 value)
+    {
+    for (int cc = 0; cc < 4; ++cc)
+      {
+      out.push_back(static_cast<unsigned char>(value >> (8 * cc)));
+      }
+    }
+
+  //----------------------------------------------------------------------------
+  vtkTypeUInt32 ReadUInt32(const unsigned char* data)
+    {
+    vtkTypeUInt32 value = 0;
+    for (int cc = 0; cc < 4; ++cc)
+      {
+      value |= static_cast<vtkTypeUInt32>(data[cc]) << (8 * cc);
+      }
+    return value;
+    }
+
+  //----------------------------------------------------------------------------
+  // FNV-1a, used to make sure a delta is applied to the right base.
+  vtkTypeUInt32 ComputeChecksum(const std::vector<unsigned char>& data)
+    {
+    vtkTypeUInt32 hash = 2166136261u;
+    for (size_t cc = 0; cc < data.size(); ++cc)
+      {
+      hash = (hash ^ data[cc]) * 16777619u;
+      }
+    return hash;
+    }
+
+  //----------------------------------------------------------------------------
+  bool HasMagic(const unsigned char* data, size_t length,
+    const unsigned char magic[4])
+    {
+    return data && length >= 5 && memcmp(data, magic, 4) == 0 &&
+      data[4] == FormatVersion;
+    }
+
+  //----------------------------------------------------------------------------
+  // Bounds-checked reader over a byte range.
+  class vtkByteReader
+    {
+  public:
+    vtkByteReader() : Data(NULL), Length(0), Position(0) {}
+    vtkByteReader(const unsigned char* data, size_t length)
+      : Data(data), Length(length), Position(0) {}
+
+    bool AtEnd() const
+      { return this->Position == this->Length; }
+
+    const unsigned char* Read(size_t length)
+      {
+      if (length > this->Length - this->Position)
+        {
+        return NULL;
+        }
+      const unsigned char* ptr = this->Data + this->Position;
+      this->Position += length;
+      return ptr;
+      }
+
+    const unsigned char* ReadArray(vtkTypeUInt64 count, size_t size)
+      {
+      if (count > (this->Length - this->Position) / size)
+        {
+        return NULL;
+        }
+      return this->Read(static_cast<size_t>(count) * size);
+      }
+
+    bool ReadByte(unsigned char& value)
+      {
+      const unsigned char* ptr = this->Read(1);
+      if (!ptr)
+        {
+        return false;
+        }
+      value = *ptr;
+      return true;
+      }
+
+    bool ReadVarInt(vtkTypeUInt64& value)
+      {
+      value = 0;
+      for (int shift = 0; shift < 64; shift += 7)
+        {
+        unsigned char byte;
+        if (!this->ReadByte(byte))
+          {
+          return false;
+          }
+        value |= static_cast<vtkTypeUInt64>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+          {
+          return true;
+          }
+        }
+      return false;
+      }
+
+  private:
+    const unsigned char* Data;
+    size_t Length;
+    size_t Position;
+    };
+
+  //----------------------------------------------------------------------------
+  class vtkColumnarEncoder
+    {
+  public:
+    vtkColumnarEncoder() : NumberOfStrings(0) {}
+
+    //--------------------------------------------------------------------------
+    bool EncodeStream(const vtkClientServerStream& css)
+      {
+      std::vector<unsigned char>& structure = this->Columns[STRUCTURE];
+      int numMessages = css.GetNumberOfMessages();
+      AppendVarInt(structure, static_cast<vtkTypeUInt64>(numMessages));
+      for (int msg = 0; msg < numMessages; ++msg)
+        {
+        structure.push_back(static_cast<unsigned char>(css.GetCommand(msg)));
+        int numArgs = css.GetNumberOfArguments(msg);
+        AppendVarInt(structure, static_cast<vtkTypeUInt64>(numArgs));
+        for (int arg = 0; arg < numArgs; ++arg)
+          {
+          if (!this->EncodeArgument(css, msg, arg))
+            {
+            return false;
+            }
+          }
+        }
+      return true;
+      }
+
+    //--------------------------------------------------------------------------
+    void GetBuffer(std::vector<unsigned char>& buffer)
+      {
+      size_t total = ColumnarHeaderSize;
+      for (int cc = 0; cc < NUMBER_OF_COLUMNS; ++cc)
+        {
+        total += this->Columns[cc].size() + 10;
+        }
+      buffer.clear();
+      buffer.reserve(total);
+      AppendBytes(buffer, ColumnarMagic, 4);
+      buffer.push_back(FormatVersion);
+      buffer.push_back(GetNativeByteOrder());
+      buffer.push_back(static_cast<unsigned char>(NUMBER_OF_COLUMNS));
+      for (int cc = 0; cc < NUMBER_OF_COLUMNS; ++cc)
+        {
+        AppendVarInt(buffer, this->Columns[cc].size());
+        AppendBytes(buffer, this->Columns[cc].empty()? NULL :
+          &this->Columns[cc][0], this->Columns[cc].size());
+        }
+      }
+
+  private:
+    std::vector<unsigned char> Columns[NUMBER_OF_COLUMNS];
+    std::map<std::string, vtkTypeUInt64> StringIds;
+    vtkTypeUInt64 NumberOfStrings;
+
+    //--------------------------------------------------------------------------
+    template <class T>
+    bool EncodeValue(const vtkClientServerStream& css, int msg, int arg)
+      {
+      T value;
+      if (!css.GetArgument(msg, arg, &value))
+        {
+        return false;
+        }
+      AppendBytes(this->Columns[GetValueColumn(sizeof(T))], &value, sizeof(T));
+      return true;
+      }
+
+    //--------------------------------------------------------------------------
+    template <class T>
+    bool EncodeArray(const vtkClientServerStream& css, int msg, int arg)
+      {
+      vtkTypeUInt32 length;
+      if (!css.GetArgumentLength(msg, arg, &length))
+        {
+        return false;
+        }
+      AppendVarInt(this->Columns[STRUCTURE], length);
+      if (length == 0)
+        {
+        return true;
+        }
+      std::vector<T> values(length);
+      if (!css.GetArgument(msg, arg, &values[0], length))
+        {
+        return false;
+        }
+      AppendBytes(this->Columns[GetValueColumn(sizeof(T))], &values[0],
+        length * sizeof(T));
+      return true;
+      }
+
+    //--------------------------------------------------------------------------
+    // vtkPVInformation subclasses nest the streams of their sub-information
+    // objects as unsigned char arrays. Flatten those into the columns.
+    bool EncodeUnsignedCharArray(
+      const vtkClientServerStream& css, int msg, int arg)
+      {
+      vtkTypeUInt32 length;
+      if (!css.GetArgumentLength(msg, arg, &length))
+        {
+        return false;
+        }
+      if (length > 0)
+        {
+        std::vector<unsigned char> bytes(length);
+        if (!css.GetArgument(msg, arg, &bytes[0], length))
+          {
+          return false;
+          }
+        vtkClientServerStream nested;
+        if (nested.SetData(&bytes[0], length) &&
+          nested.GetNumberOfMessages() > 0)
+          {
+          this->Columns[STRUCTURE].back() |= NestedStreamFlag;
+          return this->EncodeStream(nested);
+          }
+        AppendVarInt(this->Columns[STRUCTURE], length);
+        AppendBytes(this->Columns[VALUES1], &bytes[0], length);
+        return true;
+        }
+      AppendVarInt(this->Columns[STRUCTURE], 0);
+      return true;
+      }
+
+    //--------------------------------------------------------------------------
+    bool EncodeString(const vtkClientServerStream& css, int msg, int arg)
+      {
+      const char* value = NULL;
+      if (!css.GetArgument(msg, arg, &value))
+        {
+        return false;
+        }
+      // id 0 is the NULL string.
+      vtkTypeUInt64 id = 0;
+      if (value)
+        {
+        std::string key(value);
+        std::map<std::string, vtkTypeUInt64>::iterator iter =
+          this->StringIds.find(key);
+        if (iter != this->StringIds.end())
+          {
+          id = iter->second;
+          }
+        else
+          {
+          id = ++this->NumberOfStrings;
+          this->StringIds[key] = id;
+          AppendVarInt(this->Columns[STRINGS], key.size());
+          AppendBytes(this->Columns[STRINGS], key.c_str(), key.size());
+          }
+        }
+      AppendVarInt(this->Columns[STRUCTURE], id);
+      return true;
+      }
+
+    //--------------------------------------------------------------------------
+    bool EncodeArgument(const vtkClientServerStream& css, int msg, int arg)
+      {
+      vtkClientServerStream::Types type = css.GetArgumentType(msg, arg);
+      this->Columns[STRUCTURE].push_back(static_cast<unsigned char>(type));
+      switch (type)
+        {
+      case vtkClientServerStream::int8_value:
+        return this->EncodeValue<vtkTypeInt8>(css, msg, arg);
+      case vtkClientServerStream::int8_array:
+        return this->EncodeArray<vtkTypeInt8>(css, msg, arg);
+      case vtkClientServerStream::int16_value:
+        return this->EncodeValue<vtkTypeInt16>(css, msg, arg);
+      case vtkClientServerStream::int16_array:
+        return this->EncodeArray<vtkTypeInt16>(css, msg, arg);
+      case vtkClientServerStream::int32_value:
+        return this->EncodeValue<vtkTypeInt32>(css, msg, arg);
+      case vtkClientServerStream::int32_array:
+        return this->EncodeArray<vtkTypeInt32>(css, msg, arg);
+      case vtkClientServerStream::int64_value:
+        return this->EncodeValue<vtkTypeInt64>(css, msg, arg);
+      case vtkClientServerStream::int64_array:
+        return this->EncodeArray<vtkTypeInt64>(css, msg, arg);
+      case vtkClientServerStream::uint8_value:
+        return this->EncodeValue<vtkTypeUInt8>(css, msg, arg);
+      case vtkClientServerStream::uint8_array:
+        return this->EncodeUnsignedCharArray(css, msg, arg);
+      case vtkClientServerStream::uint16_value:
+        return this->EncodeValue<vtkTypeUInt16>(css, msg, arg);
+      case vtkClientServerStream::uint16_array:
+        return this->EncodeArray<vtkTypeUInt16>(css, msg, arg);
+      case vtkClientServerStream::uint32_value:
+        return this->EncodeValue<vtkTypeUInt32>(css, msg, arg);
+      case vtkClientServerStream::uint32_array:
+        return this->EncodeArray<vtkTypeUInt32>(css, msg, arg);
+      case vtkClientServerStream::uint64_value:
+        return this->EncodeValue<vtkTypeUInt64>(css, msg, arg);
+      case vtkClientServerStream::uint64_array:
+        return this->EncodeArray<vtkTypeUInt64>(css, msg, arg);
+      case vtkClientServerStream::float32_value:
+        return this->EncodeValue<vtkTypeFloat32>(css, msg, arg);
+      case vtkClientServerStream::float32_array:
+        return this->EncodeArray<vtkTypeFloat32>(css, msg, arg);
+      case vtkClientServerStream::float64_value:
+        return this->EncodeValue<vtkTypeFloat64>(css, msg, arg);
+      case vtkClientServerStream::float64_array:
+        return this->EncodeArray<vtkTypeFloat64>(css, msg, arg);
+      case vtkClientServerStream::bool_value:
+        {
+        bool value;
+        if (!css.GetArgument(msg, arg, &value))
+          {
+          return false;
+          }
+        this->Columns[VALUES1].push_back(value? 1 : 0);
+        return true;
+        }
+      case vtkClientServerStream::string_value:
+        return this->EncodeString(css, msg, arg);
+      case vtkClientServerStream::id_value:
+        {
+        vtkClientServerID id;
+        if (!css.GetArgument(msg, arg, &id))
+          {
+          return false;
+          }
+        AppendBytes(this->Columns[VALUES4], &id.ID, sizeof(id.ID));
+        return true;
+        }
+      case vtkClientServerStream::stream_value:
+        {
+        vtkClientServerStream nested;
+        return css.GetArgument(msg, arg, &nested) != 0 &&
+          this->EncodeStream(nested);
+        }
+      case vtkClientServerStream::LastResult:
+        return true;
+      default:
+        // object pointers cannot be transported.
+        return false;
+        }
+      }
+    };
+
+  //----------------------------------------------------------------------------
+  class vtkColumnarDecoder
+    {
+  public:
+    vtkColumnarDecoder() : Swap(false) {}
+
+    //--------------------------------------------------------------------------
+    bool Initialize(const unsigned char* data, size_t length)
+      {
+      if (!HasMagic(data, length, ColumnarMagic) ||
+        length < ColumnarHeaderSize ||
+        data[6] != static_cast<unsigned char>(NUMBER_OF_COLUMNS))
+        {
+        return false;
+        }
+      this->Swap = (data[5] != GetNativeByteOrder());
+
+      vtkByteReader reader(data + ColumnarHeaderSize,
+        length - ColumnarHeaderSize);
+      for (int cc = 0; cc < NUMBER_OF_COLUMNS; ++cc)
+        {
+        vtkTypeUInt64 columnLength;
+        const unsigned char* column;
+        if (!reader.ReadVarInt(columnLength) ||
+          (column = reader.ReadArray(columnLength, 1)) == NULL)
+          {
+          return false;
+          }
+        this->Columns[cc] = vtkByteReader(column,
+          static_cast<size_t>(columnLength));
+        }
+
+      vtkByteReader& strings = this->Columns[STRINGS];
+      while (!strings.AtEnd())
+        {
+        vtkTypeUInt64 stringLength;
+        const unsigned char* str;
+        if (!strings.ReadVarInt(stringLength) ||
+          (str = strings.ReadArray(stringLength, 1)) == NULL)
+          {
+          return false;
+          }
+        this->Strings.push_back(std::string(reinterpret_cast<const char*>(str),
+            static_cast<size_t>(stringLength)));
+        }
+      return reader.AtEnd();
+      }
+
+    //--------------------------------------------------------------------------
+    bool DecodeStream(vtkClientServerStream& css)
+      {
+      vtkByteReader& structure = this->Columns[STRUCTURE];
+      vtkTypeUInt64 numMessages;
+      if (!structure.ReadVarInt(numMessages))
+        {
+        return false;
+        }
+      for (vtkTypeUInt64 msg = 0; msg < numMessages; ++msg)
+        {
+        unsigned char command;
+        vtkTypeUInt64 numArgs;
+        if (!structure.ReadByte(command) ||
+          command >= vtkClientServerStream::EndOfCommands ||
+          !structure.ReadVarInt(numArgs))
+          {
+          return false;
+          }
+        css << static_cast<vtkClientServerStream::Commands>(command);
+        for (vtkTypeUInt64 arg = 0; arg < numArgs; ++arg)
+          {
+          unsigned char type;
+          if (!structure.ReadByte(type) || !this->DecodeArgument(css, type))
+            {
+            return false;
+            }
+          }
+        css << vtkClientServerStream::End;
+        }
+      return true;
+      }
+
+    //--------------------------------------------------------------------------
+    bool AtEnd() const
+      {
+      return this->Columns[STRUCTURE].AtEnd();
+      }
+
+  private:
+    vtkByteReader Columns[NUMBER_OF_COLUMNS];
+    std::vector<std::string> Strings;
+    bool Swap;
+
+    //--------------------------------------------------------------------------
+    template <class T>
+    bool DecodeValue(vtkClientServerStream& css)
+      {
+      const unsigned char* ptr =
+        this->Columns[GetValueColumn(sizeof(T))].Read(sizeof(T));
+      if (!ptr)
+        {
+        return false;
+        }
+      T value;
+      memcpy(&value, ptr, sizeof(T));
+      if (this->Swap && sizeof(T) > 1)
+        {
+        vtkByteSwap::SwapVoidRange(&value, 1, sizeof(T));
+        }
+      css << value;
+      return true;
+      }
+
+    //--------------------------------------------------------------------------
+    template <class T>
+    bool DecodeArray(vtkClientServerStream& css)
+      {
+      vtkTypeUInt64 length;
+      const unsigned char* ptr;
+      if (!this->Columns[STRUCTURE].ReadVarInt(length) ||
+        length > static_cast<vtkTypeUInt64>(VTK_INT_MAX) ||
+        (ptr = this->Columns[GetValueColumn(sizeof(T))].ReadArray(
+            length, sizeof(T))) == NULL)
+        {
+        return false;
+        }
+      std::vector<T> values(length > 0? static_cast<size_t>(length) : 1);
+      memcpy(&values[0], ptr, static_cast<size_t>(length) * sizeof(T));
+      if (this->Swap && sizeof(T) > 1)
+        {
+        vtkByteSwap::SwapVoidRange(&values[0], static_cast<size_t>(length),
+          sizeof(T));
+        }
+      css << vtkClientServerStream::InsertArray(&values[0],
+        static_cast<int>(length));
+      return true;
+      }
+
+    //--------------------------------------------------------------------------
+    bool DecodeArgument(vtkClientServerStream& css, unsigned char type)
+      {
+      switch (type)
+        {
+      case vtkClientServerStream::int8_value:
+        return this->DecodeValue<vtkTypeInt8>(css);
+      case vtkClientServerStream::int8_array:
+        return this->DecodeArray<vtkTypeInt8>(css);
+      case vtkClientServerStream::int16_value:
+        return this->DecodeValue<vtkTypeInt16>(css);
+      case vtkClientServerStream::int16_array:
+        return this->DecodeArray<vtkTypeInt16>(css);
+      case vtkClientServerStream::int32_value:
+        return this->DecodeValue<vtkTypeInt32>(css);
+      case vtkClientServerStream::int32_array:
+        return this->DecodeArray<vtkTypeInt32>(css);
+      case vtkClientServerStream::int64_value:
+        return this->DecodeValue<vtkTypeInt64>(css);
+      case vtkClientServerStream::int64_array:
+        return this->DecodeArray<vtkTypeInt64>(css);
+      case vtkClientServerStream::uint8_value:
+        return this->DecodeValue<vtkTypeUInt8>(css);
+      case vtkClientServerStream::uint8_array:
+        return this->DecodeArray<vtkTypeUInt8>(css);
+      case vtkClientServerStream::uint16_value:
+        return this->DecodeValue<vtkTypeUInt16>(css);
+      case vtkClientServerStream::uint16_array:
+        return this->DecodeArray<vtkTypeUInt16>(css);
+      case vtkClientServerStream::uint32_value:
+        return this->DecodeValue<vtkTypeUInt32>(css);
+      case vtkClientServerStream::uint32_array:
+        return this->DecodeArray<vtkTypeUInt32>(css);
+      case vtkClientServerStream::uint64_value:
+        return this->DecodeValue<vtkTypeUInt64>(css);
+      case vtkClientServerStream::uint64_array:
+        return this->DecodeArray<vtkTypeUInt64>(css);
+      case vtkClientServerStream::float32_value:
+        return this->DecodeValue<vtkTypeFloat32>(css);
+      case vtkClientServerStream::float32_array:
+        return this->DecodeArray<vtkTypeFloat32>(css);
+      case vtkClientServerStream::float64_value:
+        return this->DecodeValue<vtkTypeFloat64>(css);
+      case vtkClientServerStream::float64_array:
+        return this->DecodeArray<vtkTypeFloat64>(css);
+      case vtkClientServerStream::bool_value:
+        {
+        unsigned char value;
+        if (!this->Columns[VALUES1].ReadByte(value))
+          {
+          return false;
+          }
+        css << (value != 0);
+        return true;
+        }
+      case vtkClientServerStream::string_value:
+        {
+        vtkTypeUInt64 id;
+        if (!this->Columns[STRUCTURE].ReadVarInt(id) ||
+          id > this->Strings.size())
+          {
+          return false;
+          }
+        css << (id == 0? static_cast<const char*>(NULL) :
+          this->Strings[static_cast<size_t>(id - 1)].c_str());
+        return true;
+        }
+      case vtkClientServerStream::id_value:
+        {
+        const unsigned char* ptr = this->Columns[VALUES4].Read(4);
+        if (!ptr)
+          {
+          return false;
+          }
+        vtkClientServerID id;
+        memcpy(&id.ID, ptr, sizeof(id.ID));
+        if (this->Swap)
+          {
+          vtkByteSwap::SwapVoidRange(&id.ID, 1, sizeof(id.ID));
+          }
+        css << id;
+        return true;
+        }
+      case vtkClientServerStream::stream_value:
+        {
+        vtkClientServerStream nested;
+        if (!this->DecodeStream(nested))
+          {
+          return false;
+          }
+        css << nested;
+        return true;
+        }
+      case vtkClientServerStream::uint8_array | NestedStreamFlag:
+        {
+        vtkClientServerStream nested;
+        const unsigned char* data;
+        size_t length;
+        if (!this->DecodeStream(nested) || !nested.GetData(&data, &length))
+          {
+          return false;
+          }
+        css << vtkClientServerStream::InsertArray(data,
+          static_cast<int>(length));
+        return true;
+        }
+      case vtkClientServerStream::LastResult:
+        css << vtkClientServerStream::LastResult;
+        return true;
+      default:
+        return false;
+        }
+      }
+    };
+
+  //----------------------------------------------------------------------------
+  void SplitSections(const std::vector<unsigned char>& buffer,
+    SectionsType& sections)
+    {
+    sections.clear();
+    const unsigned char* data = buffer.empty()? NULL : &buffer[0];
+    if (HasMagic(data, buffer.size(), ColumnarMagic) &&
+      buffer.size() >= ColumnarHeaderSize)
+      {
+      sections.push_back(std::make_pair(data, ColumnarHeaderSize));
+      vtkByteReader reader(data + ColumnarHeaderSize,
+        buffer.size() - ColumnarHeaderSize);
+      bool valid = true;
+      while (valid && !reader.AtEnd())
+        {
+        vtkTypeUInt64 length;
+        const unsigned char* column;
+        valid = reader.ReadVarInt(length) &&
+          (column = reader.ReadArray(length, 1)) != NULL;
+        if (valid)
+          {
+          sections.push_back(
+            std::make_pair(column, static_cast<size_t>(length)));
+          }
+        }
+      if (valid)
+        {
+        return;
+        }
+      sections.clear();
+      }
+    sections.push_back(std::make_pair(data, buffer.size()));
+    }
+
+  //----------------------------------------------------------------------------
+  void JoinSections(const std::vector<std::vector<unsigned char> >& sections,
+    std::vector<unsigned char>& buffer)
+    {
+    buffer.clear();
+    for (size_t cc = 0; cc < sections.size(); ++cc)
+      {
+      if (cc > 0)
+        {
+        AppendVarInt(buffer, sections[cc].size());
+        }
+      AppendBytes(buffer, sections[cc].empty()? NULL : &sections[cc][0],
+        sections[cc].size());
+      }
+    }
+}
+
+//****************************************************************************
+class vtkPVInformationCodec::vtkInternals
+{
+public:
+  struct vtkEntry
+    {
+    vtkTypeUInt32 Version;
+    vtkTypeUInt64 LastUse;
+    std::vector<unsigned char> Buffer;
+    };
+  typedef std::map<std::string, vtkEntry> EntriesType;
+  EntriesType Entries;
+  vtkTypeUInt32 NextVersion;
+  vtkTypeUInt64 UseCounter;
+
+  vtkInternals() : NextVersion(1), UseCounter(0)
+    {
+    }
+
+  void Store(const std::string& key, vtkTypeUInt32 version,
+    std::vector<unsigned char>& buffer, int maxEntries)
+    {
+    if (maxEntries <= 0)
+      {
+      return;
+      }
+    vtkEntry& entry = this->Entries[key];
+    entry.Version = version;
+    entry.LastUse = ++this->UseCounter;
+    entry.Buffer.swap(buffer);
+
+    // discard the least recently used entries.
+    while (this->Entries.size() > static_cast<size_t>(maxEntries))
+      {
+      EntriesType::iterator oldest = this->Entries.begin();
+      for (EntriesType::iterator iter = this->Entries.begin();
+        iter != this->Entries.end(); ++iter)
+        {
+        if (iter->second.LastUse < oldest->second.LastUse)
+          {
+          oldest = iter;
+          }
+        }
+      this->Entries.erase(oldest);
+      }
+    }
+};
+
+vtkStandardNewMacro(vtkPVInformationCodec);
+//----------------------------------------------------------------------------
+vtkPVInformationCodec::vtkPVInformationCodec()
+{
+  this->MaximumNumberOfCachedEntries = 128;
+  this->Internals = new vtkInternals();
+}
+
+//----------------------------------------------------------------------------
+vtkPVInformationCodec::~vtkPVInformationCodec()
+{
+  delete this->Internals;
+  this->Internals = NULL;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVInformationCodec::ClearCache()
+{
+  this->Internals->Entries.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVInformationCodec::Encode(const vtkClientServerStream& css,
+  std::vector<unsigned char>& buffer)
+{
+  vtkColumnarEncoder encoder;
+  if (encoder.EncodeStream(css))
+    {
+    encoder.GetBuffer(buffer);
+    return;
+    }
+
+  // fall back to the raw stream.
+  const unsigned char* data;
+  size_t length;
+  buffer.clear();
+  if (css.GetData(&data, &length))
+    {
+    AppendBytes(buffer, data, length);
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVInformationCodec::Decode(const unsigned char* data, size_t length,
+  vtkClientServerStream& css)
+{
+  css.Reset();
+  if (!HasMagic(data, length, ColumnarMagic))
+    {
+    return css.SetData(data, length) != 0;
+    }
+
+  vtkColumnarDecoder decoder;
+  if (!decoder.Initialize(data, length) || !decoder.DecodeStream(css) ||
+    !decoder.AtEnd())
+    {
+    css.Reset();
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVInformationCodec::CopyToBuffer(vtkPVInformation* info,
+  std::vector<unsigned char>& buffer)
+{
+  vtkClientServerStream css;
+  info->CopyToStream(&css);
+  vtkPVInformationCodec::Encode(css, buffer);
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVInformationCodec::CopyFromBuffer(vtkPVInformation* info,
+  const unsigned char* data, size_t length)
+{
+  vtkClientServerStream css;
+  if (!vtkPVInformationCodec::Decode(data, length, css))
+    {
+    return false;
+    }
+  info->CopyFromStream(&css);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVInformationCodec::EncodeDelta(
+  const std::vector<unsigned char>& base,
+  const std::vector<unsigned char>& current,
+  std::vector<unsigned char>& delta)
+{
+  delta.clear();
+  AppendBytes(delta, DeltaMagic, 4);
+  delta.push_back(FormatVersion);
+  AppendVarInt(delta, base.size());
+  AppendUInt32(delta, ComputeChecksum(base));
+
+  SectionsType baseSections, currentSections;
+  SplitSections(base, baseSections);
+  SplitSections(current, currentSections);
+  bool sameLayout = (baseSections.size() == currentSections.size());
+
+  AppendVarInt(delta, currentSections.size());
+  std::vector<unsigned char> patch;
+  for (size_t cc = 0; cc < currentSections.size(); ++cc)
+    {
+    const unsigned char* data = currentSections[cc].first;
+    size_t length = currentSections[cc].second;
+    if (sameLayout && baseSections[cc].second == length)
+      {
+      const unsigned char* baseData = baseSections[cc].first;
+      if (length == 0 || memcmp(baseData, data, length) == 0)
+        {
+        delta.push_back(SECTION_UNCHANGED);
+        continue;
+        }
+
+      // send runs of blocks that differ, as (blocks skipped, blocks sent).
+      patch.clear();
+      size_t numBlocks = (length + DeltaBlockSize - 1) / DeltaBlockSize;
+      size_t numRuns = 0;
+      size_t previousEnd = 0;
+      size_t block = 0;
+      while (block < numBlocks)
+        {
+        size_t start = block;
+        while (block < numBlocks)
+          {
+          size_t offset = block * DeltaBlockSize;
+          size_t size = std::min(DeltaBlockSize, length - offset);
+          if (memcmp(baseData + offset, data + offset, size) == 0)
+            {
+            break;
+            }
+          ++block;
+          }
+        if (block > start)
+          {
+          size_t offset = start * DeltaBlockSize;
+          size_t end = std::min(block * DeltaBlockSize, length);
+          AppendVarInt(patch, start - previousEnd);
+          AppendVarInt(patch, block - start);
+          AppendBytes(patch, data + offset, end - offset);
+          previousEnd = block;
+          ++numRuns;
+          }
+        else
+          {
+          ++block;
+          }
+        }
+      if (patch.size() < length)
+        {
+        delta.push_back(SECTION_PATCHED);
+        AppendVarInt(delta, numRuns);
+        AppendBytes(delta, &patch[0], patch.size());
+        continue;
+        }
+      }
+    delta.push_back(SECTION_REPLACED);
+    AppendVarInt(delta, length);
+    AppendBytes(delta, data, length);
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVInformationCodec::ApplyDelta(
+  const std::vector<unsigned char>& base,
+  const unsigned char* delta, size_t length,
+  std::vector<unsigned char>& current)
+{
+  if (!HasMagic(delta, length, DeltaMagic))
+    {
+    return false;
+    }
+  vtkByteReader reader(delta + 5, length - 5);
+  vtkTypeUInt64 baseLength;
+  const unsigned char* checksum;
+  if (!reader.ReadVarInt(baseLength) || baseLength != base.size() ||
+    (checksum = reader.Read(4)) == NULL ||
+    ReadUInt32(checksum) != ComputeChecksum(base))
+    {
+    return false;
+    }
+
+  SectionsType baseSections;
+  SplitSections(base, baseSections);
+
+  vtkTypeUInt64 numSections;
+  if (!reader.ReadVarInt(numSections) || numSections > length)
+    {
+    return false;
+    }
+  bool sameLayout = (numSections == baseSections.size());
+
+  std::vector<std::vector<unsigned char> > sections(
+    static_cast<size_t>(numSections));
+  for (size_t cc = 0; cc < sections.size(); ++cc)
+    {
+    unsigned char mode;
+    if (!reader.ReadByte(mode))
+      {
+      return false;
+      }
+    std::vector<unsigned char>& section = sections[cc];
+    if (mode == SECTION_REPLACED)
+      {
+      vtkTypeUInt64 sectionLength;
+      const unsigned char* data;
+      if (!reader.ReadVarInt(sectionLength) ||
+        (data = reader.ReadArray(sectionLength, 1)) == NULL)
+        {
+        return false;
+        }
+      section.assign(data, data + sectionLength);
+      continue;
+      }
+    if (!sameLayout ||
+      (mode != SECTION_UNCHANGED && mode != SECTION_PATCHED))
+      {
+      return false;
+      }
+
+    section.assign(baseSections[cc].first,
+      baseSections[cc].first + baseSections[cc].second);
+    if (mode == SECTION_PATCHED)
+      {
+      vtkTypeUInt64 numRuns;
+      if (!reader.ReadVarInt(numRuns))
+        {
+        return false;
+        }
+      size_t block = 0;
+      for (vtkTypeUInt64 run = 0; run < numRuns; ++run)
+        {
+        vtkTypeUInt64 skip, count;
+        if (!reader.ReadVarInt(skip) || !reader.ReadVarInt(count) ||
+          skip > section.size() || count > section.size())
+          {
+          return false;
+          }
+        block += static_cast<size_t>(skip);
+        size_t offset = block * DeltaBlockSize;
+        if (offset >= section.size())
+          {
+          return false;
+          }
+        block += static_cast<size_t>(count);
+        size_t end = std::min(block * DeltaBlockSize, section.size());
+        const unsigned char* data = reader.Read(end - offset);
+        if (!data)
+          {
+          return false;
+          }
+        memcpy(&section[offset], data, end - offset);
+        }
+      }
+    }
+  if (!reader.AtEnd())
+    {
+    return false;
+    }
+  JoinSections(sections, current);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+std::string vtkPVInformationCodec::GetRequestKey(vtkPVInformation* info,
+  vtkTypeUInt32 location, vtkTypeUInt32 globalid)
+{
+  vtkMultiProcessStream parameters;
+  info->CopyParametersToStream(parameters);
+  std::vector<unsigned char> raw;
+  parameters.GetRawData(raw);
+
+  vtksys_ios::ostringstream key;
+  key << info->GetClassName() << ":" << location << ":" << globalid << ":";
+  std::string result = key.str();
+  result.append(raw.begin(), raw.end());
+  return result;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVInformationCodec::EncodeReply(const std::string& key,
+  vtkTypeUInt32 clientVersion, vtkPVInformation* info,
+  std::vector<unsigned char>& reply)
+{
+  std::vector<unsigned char> buffer;
+  vtkPVInformationCodec::CopyToBuffer(info, buffer);
+
+  vtkTypeUInt32 version = this->Internals->NextVersion++;
+  if (this->Internals->NextVersion == 0)
+    {
+    // 0 means "nothing cached".
+    this->Internals->NextVersion = 1;
+    }
+
+  reply.clear();
+  AppendUInt32(reply, version);
+
+  vtkInternals::EntriesType::iterator iter =
+    this->Internals->Entries.find(key);
+  bool sent = false;
+  if (clientVersion != 0 && iter != this->Internals->Entries.end() &&
+    iter->second.Version == clientVersion)
+    {
+    std::vector<unsigned char> delta;
+    vtkPVInformationCodec::EncodeDelta(iter->second.Buffer, buffer, delta);
+    if (delta.size() < buffer.size())
+      {
+      AppendBytes(reply, &delta[0], delta.size());
+      sent = true;
+      }
+    }
+  if (!sent)
+    {
+    AppendBytes(reply, buffer.empty()? NULL : &buffer[0], buffer.size());
+    }
+
+  this->Internals->Store(key, version, buffer,
+    this->MaximumNumberOfCachedEntries);
+}
+
+//----------------------------------------------------------------------------
+vtkTypeUInt32 vtkPVInformationCodec::GetCachedVersion(const std::string& key)
+{
+  vtkInternals::EntriesType::iterator iter =
+    this->Internals->Entries.find(key);
+  return iter != this->Internals->Entries.end()? iter->second.Version : 0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVInformationCodec::DecodeReply(const std::string& key,
+  const unsigned char* data, size_t length, vtkPVInformation* info)
+{
+  if (!data || length < 4)
+    {
+    vtkErrorMacro("Invalid information reply.");
+    return false;
+    }
+  vtkTypeUInt32 version = ReadUInt32(data);
+  data += 4;
+  length -= 4;
+
+  std::vector<unsigned char> buffer;
+  vtkInternals::EntriesType::iterator iter =
+    this->Internals->Entries.find(key);
+  if (HasMagic(data, length, DeltaMagic))
+    {
+    if (iter == this->Internals->Entries.end() ||
+      !vtkPVInformationCodec::ApplyDelta(
+        iter->second.Buffer, data, length, buffer))
+      {
+      // the caller is expected to request the full information again.
+      vtkDebugMacro("Failed to apply information delta for " << key);
+      if (iter != this->Internals->Entries.end())
+        {
+        this->Internals->Entries.erase(iter);
+        }
+      return false;
+      }
+    }
+  else
+    {
+    buffer.assign(data, data + length);
+    }
+
+  if (buffer.empty() || !vtkPVInformationCodec::CopyFromBuffer(
+      info, &buffer[0], buffer.size()))
+    {
+    vtkErrorMacro("Failed to decode information.");
+    this->Internals->Entries.erase(key);
+    return false;
+    }
+  this->Internals->Store(key, version, buffer,
+    this->MaximumNumberOfCachedEntries);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVInformationCodec::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "MaximumNumberOfCachedEntries: "
+     << this->MaximumNumberOfCachedEntries << endl;
+  os << indent << "NumberOfCachedEntries: "
+     << this->Internals->Entries.size() << endl;
+}
@@ -0,0 +1,146 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVInformationCodec.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVInformationCodec - compact binary transport for vtkPVInformation.
+// .SECTION Description
+// vtkPVInformationCodec converts the vtkClientServerStream produced by
+// vtkPVInformation::CopyToStream() into a columnar binary buffer and back.
+// The buffer splits the stream into a structure column (commands, argument
+// types and lengths), a string table in which every distinct string (array
+// names, component names, class names, etc.) is stored once and packed
+// columns of 1, 2, 4 and 8 byte values. Nested streams, which
+// vtkPVDataInformation and friends insert as unsigned char arrays, are
+// flattened into the same columns so that e.g. the array names of all blocks
+// of a multiblock dataset share a single string table entry.
+//
+// Streams that cannot be transcoded (for example ones carrying object
+// pointers) are passed through as raw vtkClientServerStream data; Decode()
+// accepts both forms.
+//
+// In addition, an instance of vtkPVInformationCodec keeps the last buffer
+// exchanged for every key (typically the information class, the object and
+// the gathering parameters) so that the server can send only the blocks of
+// each column that changed since the version the client already has. See
+// EncodeReply() and DecodeReply().
+
+#ifndef __vtkPVInformationCodec_h
+#define __vtkPVInformationCodec_h
+
+#include "vtkObject.h"
+#include "vtkPVClientServerCoreCoreModule.h" //needed for exports
+
+//BTX
+#include <string> // needed for std::string
+#include <vector> // needed for std::vector
+//ETX
+
+class vtkClientServerStream;
+class vtkPVInformation;
+
+class VTKPVCLIENTSERVERCORECORE_EXPORT vtkPVInformationCodec : public vtkObject
+{
+public:
+  static vtkPVInformationCodec* New();
+  vtkTypeMacro(vtkPVInformationCodec, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Maximum number of keys for which the last exchanged buffer is kept.
+  // The least recently used entry is discarded when the limit is exceeded.
+  // Default is 128.
+  vtkSetClampMacro(MaximumNumberOfCachedEntries, int, 0, VTK_INT_MAX);
+  vtkGetMacro(MaximumNumberOfCachedEntries, int);
+
+  // Description:
+  // Discard all cached buffers.
+  void ClearCache();
+
+  //BTX
+  // Description:
+  // Encode the stream in the columnar format. If the stream cannot be
+  // transcoded, the raw stream data is returned instead.
+  static void Encode(const vtkClientServerStream& css,
+    std::vector<unsigned char>& buffer);
+
+  // Description:
+  // Reconstruct a stream from a buffer produced by Encode() (or from raw
+  // vtkClientServerStream data). Returns false if the buffer is invalid.
+  static bool Decode(const unsigned char* data, size_t length,
+    vtkClientServerStream& css);
+
+  // Description:
+  // Convenience methods to serialize an information object with
+  // CopyToStream()/CopyFromStream() through Encode()/Decode().
+  static void CopyToBuffer(vtkPVInformation* info,
+    std::vector<unsigned char>& buffer);
+  static bool CopyFromBuffer(vtkPVInformation* info,
+    const unsigned char* data, size_t length);
+
+  // Description:
+  // Compute a delta that turns `base` into `current`. Unchanged columns are
+  // omitted and columns of the same size only carry the blocks that changed.
+  static void EncodeDelta(const std::vector<unsigned char>& base,
+    const std::vector<unsigned char>& current,
+    std::vector<unsigned char>& delta);
+
+  // Description:
+  // Apply a delta produced by EncodeDelta() to `base`. Returns false if the
+  // delta is invalid or was not computed against `base`.
+  static bool ApplyDelta(const std::vector<unsigned char>& base,
+    const unsigned char* delta, size_t length,
+    std::vector<unsigned char>& current);
+
+  // Description:
+  // Returns the cache key for gathering `info` (with its current gathering
+  // parameters) from the object `globalid` at `location`.
+  static std::string GetRequestKey(vtkPVInformation* info,
+    vtkTypeUInt32 location, vtkTypeUInt32 globalid);
+
+  // Description:
+  // Server side: serialize `info` for the client and store the result under
+  // `key`. `clientVersion` is the version the client holds for `key` (0 if
+  // none); when it matches the cached version only a delta is sent.
+  void EncodeReply(const std::string& key, vtkTypeUInt32 clientVersion,
+    vtkPVInformation* info, std::vector<unsigned char>& reply);
+
+  // Description:
+  // Client side: returns the version of the buffer cached for `key`, to be
+  // sent along with the request, or 0 if none is cached.
+  vtkTypeUInt32 GetCachedVersion(const std::string& key);
+
+  // Description:
+  // Client side: update the cache entry for `key` from a reply produced by
+  // EncodeReply() and deserialize it into `info`. On failure, e.g. when a
+  // delta was computed against a version that is no longer cached, the
+  // entry for `key` is discarded and false is returned; the caller should
+  // then request the information again with version 0 to get it in full.
+  bool DecodeReply(const std::string& key, const unsigned char* data,
+    size_t length, vtkPVInformation* info);
+  //ETX
+
+protected:
+  vtkPVInformationCodec();
+  ~vtkPVInformationCodec();
+
+  int MaximumNumberOfCachedEntries;
+
+private:
+  vtkPVInformationCodec(const vtkPVInformationCodec&); // Not implemented
+  void operator=(const vtkPVInformationCodec&); // Not implemented
+
+  class vtkInternals;
+  vtkInternals* Internals;
+};
+
+#endif
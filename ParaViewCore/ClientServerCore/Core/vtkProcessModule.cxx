@@ -27,11 +27,13 @@
 #include "vtkOutputWindow.h"
 #include "vtkPVConfig.h"
 #include "vtkPVConfig.h"
+#include "vtkPVEventTraceLog.h"
 #include "vtkPVOptions.h"
 #include "vtkSessionIterator.h"
 #include "vtkStdString.h"
 #include "vtkTCPNetworkAccessManager.h"
 
+#include <vtksys/ios/sstream>
 #include <vtksys/SystemTools.hxx>
 
 #ifdef PARAVIEW_USE_MPI
@@ -89,6 +91,26 @@ private:
   ~vtkPVGenericOutputWindow() {}
   };
   vtkStandardNewMacro(vtkPVGenericOutputWindow);
+
+  // Name used for the process type in event trace files.
+  const char* vtkGetTraceProcessTypeName(vtkProcessModule::ProcessTypes type)
+    {
+    switch (type)
+      {
+    case vtkProcessModule::PROCESS_CLIENT:
+      return "client";
+    case vtkProcessModule::PROCESS_SERVER:
+      return "server";
+    case vtkProcessModule::PROCESS_DATA_SERVER:
+      return "dataserver";
+    case vtkProcessModule::PROCESS_RENDER_SERVER:
+      return "renderserver";
+    case vtkProcessModule::PROCESS_BATCH:
+      return "batch";
+    default:
+      return "process";
+      }
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -186,6 +208,17 @@ bool vtkProcessModule::Initialize(ProcessTypes type, int &argc, char** &argv)
   vtkMultiProcessController::SetGlobalController(
     vtkProcessModule::GlobalController);
 
+  // Record an event trace for each rank when requested. The trace is written
+  // out in vtkProcessModule::Finalize().
+  if (vtksys::SystemTools::GetEnv("PV_EVENT_TRACE_PREFIX"))
+    {
+    vtkPVEventTraceLog::SetRank(
+      vtkProcessModule::GlobalController->GetLocalProcessId());
+    vtkPVEventTraceLog::SetProcessType(
+      type, vtkGetTraceProcessTypeName(type));
+    vtkPVEventTraceLog::SetEnabled(true);
+    }
+
   // Hack to support -display parameter.  vtkPVOptions requires parameters to be
   // specified as -option=value, but it is generally expected that X window
   // programs allow you to set the display as -display host:port (i.e. without
@@ -295,6 +328,20 @@ bool vtkProcessModule::Finalize()
   // destroy the process-module.
   vtkProcessModule::Singleton = NULL;
 
+  const char* tracePrefix = vtksys::SystemTools::GetEnv("PV_EVENT_TRACE_PREFIX");
+  if (tracePrefix && vtkPVEventTraceLog::GetEnabled())
+    {
+    // the process type may have been changed by UpdateProcessType().
+    vtkPVEventTraceLog::SetProcessType(vtkProcessModule::ProcessType,
+      vtkGetTraceProcessTypeName(vtkProcessModule::ProcessType));
+    vtksys_ios::ostringstream traceFile;
+    traceFile << tracePrefix << "."
+              << vtkPVEventTraceLog::GetProcessTypeName() << "."
+              << vtkPVEventTraceLog::GetRank() << ".json";
+    vtkPVEventTraceLog::WriteChromeTrace(traceFile.str().c_str());
+    vtkPVEventTraceLog::SetEnabled(false);
+    }
+
   // We don't really need to call SetGlobalController(NULL) since
   // it's really stored with a weak pointer.  We set it to null anyways
   // in case it gets changed later to reference counting the pointer
@@ -48,8 +48,10 @@
 
 #include <vtksys/SystemTools.hxx>
 #include <vtksys/RegularExpression.hxx>
+#include <algorithm>
 #include <set>
 #include <string>
+#include <vector>
 
 vtkStandardNewMacro(vtkPVFileInformation);
 
@@ -366,6 +368,41 @@ class vtkPVFileInformationSet :
 {
 };
 
+//-----------------------------------------------------------------------------
+// Directory entry of a paged listing, ordered by case-insensitive key like
+// the file dialog, then by key and by name.
+struct vtkPVFileInformationPageEntry
+{
+  std::string LowerCaseKey;
+  std::string Key;
+  std::string Name;
+  vtkSmartPointer<vtkPVFileInformation> Info;
+
+  bool operator<(const vtkPVFileInformationPageEntry& other) const
+    {
+    if (this->LowerCaseKey != other.LowerCaseKey)
+      {
+      return this->LowerCaseKey < other.LowerCaseKey;
+      }
+    return this->Key < other.Key ||
+      (this->Key == other.Key && this->Name < other.Name);
+    }
+};
+
+//-----------------------------------------------------------------------------
+// Key under which the entries of a paged listing are sorted: files of a
+// sequence share the sequence name, other entries use their own name.
+static std::string vtkPVFileInformationGetPageKey(
+  vtkFileSequenceParser* parser, vtkPVFileInformation* entry)
+{
+  if (!vtkPVFileInformation::IsDirectory(entry->GetType()) &&
+    parser->ParseFileSequence(entry->GetName()))
+    {
+    return parser->GetSequenceName();
+    }
+  return entry->GetName();
+}
+
 //-----------------------------------------------------------------------------
 vtkPVFileInformation::vtkPVFileInformation()
 {
@@ -377,6 +414,8 @@ vtkPVFileInformation::vtkPVFileInformation()
   this->FullPath = NULL;
   this->FastFileTypeDetection = 0;
   this->Hidden = false;
+  this->TotalNumberOfEntries = 0;
+  this->NextPageOffset = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -465,15 +504,108 @@ void vtkPVFileInformation::CopyFromObject(vtkObject* object)
 
   if (this->IsDirectory(this->Type) && helper->GetDirectoryListing())
     {
+    if (helper->GetDirectoryListingPageSize() > 0)
+      {
+      this->GetDirectoryListingPage(helper,
+        helper->GetDirectoryListingOffset(),
+        helper->GetDirectoryListingPageSize());
+      return;
+      }
+
     // Since we want a directory listing, we now to platform specific listing
     // with intelligent pattern matching hee-haa.
+    vtkPVFileInformationSet info_set;
+#if defined(_WIN32)
+    this->GetWindowsDirectoryEntries(info_set);
+#else
+    this->GetDirectoryEntries(info_set);
+#endif
+    this->TotalNumberOfEntries = static_cast<int>(info_set.size());
+    this->NextPageOffset = this->TotalNumberOfEntries;
+    this->AddDirectoryEntries(info_set);
+    }
+
+}
+
+//-----------------------------------------------------------------------------
+void vtkPVFileInformation::GetDirectoryListingPage(
+  vtkPVFileInformationHelper* helper, int offset, int pageSize)
+{
+  vtkCollection* entries = helper->GetCursorEntries();
+  const char* cursorDirectory = helper->GetCursorDirectory();
+  if (offset == 0 || !cursorDirectory ||
+    strcmp(cursorDirectory, this->FullPath) != 0 ||
+    offset != helper->GetCursorOffset())
+    {
+    // (Re)start the cursor. The entries are only listed here: file types are
+    // detected and file groups created one page at a time. They are sorted
+    // so that the files of a sequence are contiguous, in the order of the
+    // file dialog so that it can append each page to the listed entries.
+    vtkPVFileInformationSet info_set;
 #if defined(_WIN32)
-    this->GetWindowsDirectoryListing();
+    this->GetWindowsDirectoryEntries(info_set);
 #else
-    this->GetDirectoryListing();
+    this->GetDirectoryEntries(info_set);
 #endif
+    std::vector<vtkPVFileInformationPageEntry> sorted;
+    sorted.reserve(info_set.size());
+    for (vtkPVFileInformationSet::iterator iter = info_set.begin();
+      iter != info_set.end(); ++iter)
+      {
+      vtkPVFileInformationPageEntry entry;
+      entry.Key = vtkPVFileInformationGetPageKey(this->SequenceParser, *iter);
+      entry.LowerCaseKey = vtksys::SystemTools::LowerCase(entry.Key);
+      entry.Name = (*iter)->GetName();
+      entry.Info = *iter;
+      sorted.push_back(entry);
+      }
+    std::sort(sorted.begin(), sorted.end());
+
+    entries->RemoveAllItems();
+    for (size_t cc = 0; cc < sorted.size(); ++cc)
+      {
+      entries->AddItem(sorted[cc].Info);
+      }
+    helper->SetCursorDirectory(this->FullPath);
+    }
+
+  int total = entries->GetNumberOfItems();
+  int begin = offset < total? offset : total;
+  int end = (total - begin > pageSize)? begin + pageSize : total;
+  if (end < total && end > begin)
+    {
+    // do not split a file group between pages.
+    std::string lastKey = vtkPVFileInformationGetPageKey(this->SequenceParser,
+      vtkPVFileInformation::SafeDownCast(entries->GetItemAsObject(end - 1)));
+    while (end < total && lastKey == vtkPVFileInformationGetPageKey(
+        this->SequenceParser,
+        vtkPVFileInformation::SafeDownCast(entries->GetItemAsObject(end))))
+      {
+      ++end;
+      }
+    }
+
+  vtkPVFileInformationSet page;
+  for (int cc = begin; cc < end; cc++)
+    {
+    page.insert(vtkPVFileInformation::SafeDownCast(
+        entries->GetItemAsObject(cc)));
     }
+  this->AddDirectoryEntries(page);
+  this->TotalNumberOfEntries = total;
+  this->NextPageOffset = end;
 
+  if (end < total)
+    {
+    helper->SetCursorOffset(end);
+    }
+  else
+    {
+    // the listing is complete, release the cursor.
+    entries->RemoveAllItems();
+    helper->SetCursorDirectory(0);
+    helper->SetCursorOffset(0);
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -674,11 +806,10 @@ void vtkPVFileInformation::GetSpecialDirectories()
 }
 
 //-----------------------------------------------------------------------------
-void vtkPVFileInformation::GetWindowsDirectoryListing()
+void vtkPVFileInformation::GetWindowsDirectoryEntries(
+  vtkPVFileInformationSet& info_set)
 {
 #if defined(_WIN32)
-  vtkPVFileInformationSet info_set;
-
   if(IsNetworkPath(this->FullPath))
     {
     std::vector<std::string> shares;
@@ -698,13 +829,6 @@ void vtkPVFileInformation::GetWindowsDirectoryListing()
         info->Delete();
         }
       }
-    this->OrganizeCollection(info_set);
-
-    for (vtkPVFileInformationSet::iterator iter = info_set.begin();
-      iter != info_set.end(); ++iter)
-      {
-      this->Contents->AddItem(*iter);
-      }
     return;
     }
 
@@ -737,13 +861,6 @@ void vtkPVFileInformation::GetWindowsDirectoryListing()
 
     if(didListing)
       {
-      this->OrganizeCollection(info_set);
-
-      for (vtkPVFileInformationSet::iterator iter = info_set.begin();
-        iter != info_set.end(); ++iter)
-        {
-        this->Contents->AddItem(*iter);
-        }
       return;
       }
     // fall through for normal file listing that works after shares are
@@ -828,17 +945,9 @@ void vtkPVFileInformation::GetWindowsDirectoryListing()
     {
     vtkErrorMacro("Error calling FindClose.");
     }
-
-  this->OrganizeCollection(info_set);
-
-  for (vtkPVFileInformationSet::iterator iter = info_set.begin();
-    iter != info_set.end(); ++iter)
-    {
-    this->Contents->AddItem(*iter);
-    }
-
 #else
-  vtkErrorMacro("GetWindowsDirectoryListing cannot be called on non-Windows systems.");
+  (void)info_set;
+  vtkErrorMacro("GetWindowsDirectoryEntries cannot be called on non-Windows systems.");
 #endif
 }
 
@@ -852,16 +961,17 @@ support and glibc/Linux system headers:
 #endif
 
 //-----------------------------------------------------------------------------
-void vtkPVFileInformation::GetDirectoryListing()
+void vtkPVFileInformation::GetDirectoryEntries(
+  vtkPVFileInformationSet& info_set)
 {
 #if defined(_WIN32)
 
-  vtkErrorMacro("GetDirectoryListing() cannot be called on Windows systems.");
+  (void)info_set;
+  vtkErrorMacro("GetDirectoryEntries() cannot be called on Windows systems.");
   return;
 
 #else
 
-  vtkPVFileInformationSet info_set;
   std::string prefix = this->FullPath;
   vtkPVFileInformationAddTerminatingSlash(prefix);
 
@@ -897,10 +1007,17 @@ void vtkPVFileInformation::GetDirectoryListing()
     info->Type = DIRECTORY;
     }
 #else
-  if ( d->d_type & DT_DIR )
+  // Use the type reported by the directory entry to avoid a stat() per file.
+  // Links and file systems that do not report types (DT_UNKNOWN) are left
+  // to DetectType().
+  if ( d->d_type == DT_DIR )
     {
     info->Type = DIRECTORY;
     }
+  else if ( d->d_type == DT_REG && this->FastFileTypeDetection )
+    {
+    info->Type = SINGLE_FILE;
+    }
 #endif
 
     info->FastFileTypeDetection = this->FastFileTypeDetection;
@@ -908,9 +1025,22 @@ void vtkPVFileInformation::GetDirectoryListing()
     info->Delete();
     }
   closedir(dir);
+#endif
+}
 
+//-----------------------------------------------------------------------------
+void vtkPVFileInformation::AddDirectoryEntries(
+  vtkPVFileInformationSet& info_set)
+{
   this->OrganizeCollection(info_set);
 
+#if defined(_WIN32)
+  for (vtkPVFileInformationSet::iterator iter = info_set.begin();
+    iter != info_set.end(); ++iter)
+    {
+    this->Contents->AddItem(*iter);
+    }
+#else
   // Now we detect the file types for items.
   // We dissolve any groups that contain non-file items.
 
@@ -1106,6 +1236,8 @@ void vtkPVFileInformation::CopyToStream(vtkClientServerStream* stream)
     << this->FullPath
     << this->Type
     << this->Hidden
+    << this->TotalNumberOfEntries
+    << this->NextPageOffset
     << this->Contents->GetNumberOfItems();
 
   vtkSmartPointer<vtkCollectionIterator> iter;
@@ -1152,8 +1284,20 @@ void vtkPVFileInformation::CopyFromStream(const vtkClientServerStream* css)
     return;
     }
 
+  if (!css->GetArgument(0, 4, &this->TotalNumberOfEntries))
+    {
+    vtkErrorMacro("Error parsing TotalNumberOfEntries.");
+    return;
+    }
+
+  if (!css->GetArgument(0, 5, &this->NextPageOffset))
+    {
+    vtkErrorMacro("Error parsing NextPageOffset.");
+    return;
+    }
+
   int num_of_children =0;
-  if (!css->GetArgument(0, 4, &num_of_children))
+  if (!css->GetArgument(0, 6, &num_of_children))
     {
     vtkErrorMacro("Error parsing Number of children.");
     return;
@@ -1162,7 +1306,7 @@ void vtkPVFileInformation::CopyFromStream(const vtkClientServerStream* css)
     {
     vtkPVFileInformation* child = vtkPVFileInformation::New();
     vtkClientServerStream childStream;
-    if (!css->GetArgument(0, 5+cc, &childStream))
+    if (!css->GetArgument(0, 7+cc, &childStream))
       {
       vtkErrorMacro("Error parsing child #" << cc);
       return;
@@ -1180,6 +1324,8 @@ void vtkPVFileInformation::Initialize()
   this->SetFullPath(0);
   this->Type = INVALID;
   this->Hidden = false;
+  this->TotalNumberOfEntries = 0;
+  this->NextPageOffset = 0;
   this->Contents->RemoveAllItems();
 }
 
@@ -1210,6 +1356,8 @@ void vtkPVFileInformation::PrintSelf(ostream& os, vtkIndent indent)
     }
   os << indent << "Hidden: "<< this->Hidden << endl;
   os << indent << "FastFileTypeDetection: " << this->FastFileTypeDetection << endl;
+  os << indent << "TotalNumberOfEntries: " << this->TotalNumberOfEntries << endl;
+  os << indent << "NextPageOffset: " << this->NextPageOffset << endl;
 
   for (int cc=0; cc < this->Contents->GetNumberOfItems(); cc++)
     {
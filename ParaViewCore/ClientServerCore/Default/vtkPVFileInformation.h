@@ -30,6 +30,7 @@
 class vtkCollection;
 class vtkPVFileInformationSet;
 class vtkFileSequenceParser;
+class vtkPVFileInformationHelper;
 
 class VTKPVCLIENTSERVERCOREDEFAULT_EXPORT vtkPVFileInformation : public vtkPVInformation
 {
@@ -100,6 +101,15 @@ public:
   // for the contents of this directory if Type = DIRECTORY
   // or the contents of this file group if Type ==FILE_GROUP.
   vtkGetObjectMacro(Contents, vtkCollection);
+
+  // Description:
+  // Get the number of entries of the directory, counting each file of a
+  // sequence. When only a page of the listing was requested (see
+  // vtkPVFileInformationHelper::SetDirectoryListingPageSize()),
+  // NextPageOffset is the offset of the entry following the page, and is
+  // equal to TotalNumberOfEntries after the last page.
+  vtkGetMacro(TotalNumberOfEntries, int);
+  vtkGetMacro(NextPageOffset, int);
 //BTX
 protected:
   vtkPVFileInformation();
@@ -112,12 +122,26 @@ protected:
   char* FullPath; // Full path for this file/directory.
   int Type;       // Type i.e. File/Directory/FileGroup.
   bool Hidden;    // If file/directory is hidden
+  int TotalNumberOfEntries; // Number of entries in the full listing.
+  int NextPageOffset; // Offset of the entry following the listed page.
 
   vtkSetStringMacro(Name);
   vtkSetStringMacro(FullPath);
 
-  void GetWindowsDirectoryListing();
-  void GetDirectoryListing();
+  // Fill the set with the entries of this directory, without creating file
+  // groups.
+  void GetWindowsDirectoryEntries(vtkPVFileInformationSet& info_set);
+  void GetDirectoryEntries(vtkPVFileInformationSet& info_set);
+
+  // Creates the file groups, detects the types of the entries and adds them
+  // to Contents.
+  void AddDirectoryEntries(vtkPVFileInformationSet& info_set);
+
+  // Adds a page of the entries of this directory to Contents, extended so
+  // that file groups are not split. The entries are listed at the first page
+  // and kept by the helper for the following ones.
+  void GetDirectoryListingPage(vtkPVFileInformationHelper* helper,
+    int offset, int pageSize);
 
   // Goes thru the collection of vtkPVFileInformation objects
   // are creates file groups, if possible.
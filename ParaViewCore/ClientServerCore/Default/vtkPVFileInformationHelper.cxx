@@ -14,6 +14,7 @@
 =========================================================================*/
 #include "vtkPVFileInformationHelper.h"
 
+#include "vtkCollection.h"
 #include "vtkObjectFactory.h"
 
 #include <vtksys/SystemTools.hxx>
@@ -29,6 +30,11 @@ vtkPVFileInformationHelper::vtkPVFileInformationHelper()
   this->SetPath(".");
   this->PathSeparator = 0;
   this->FastFileTypeDetection = 1;
+  this->DirectoryListingOffset = 0;
+  this->DirectoryListingPageSize = 0;
+  this->CursorEntries = vtkCollection::New();
+  this->CursorDirectory = 0;
+  this->CursorOffset = 0;
 #if defined(_WIN32) && !defined(__CYGWIN__)
   this->SetPathSeparator("\\");
 #else
@@ -42,6 +48,8 @@ vtkPVFileInformationHelper::~vtkPVFileInformationHelper()
   this->SetPath(0);
   this->SetPathSeparator(0);
   this->SetWorkingDirectory(0);
+  this->SetCursorDirectory(0);
+  this->CursorEntries->Delete();
 }
 
 //-----------------------------------------------------------------------------
@@ -69,4 +77,8 @@ void vtkPVFileInformationHelper::PrintSelf(ostream& os, vtkIndent indent)
     <<  (this->PathSeparator? this->PathSeparator : "(null)") << endl;
   os << indent << "FastFileTypeDetection: "
     << this->FastFileTypeDetection << endl;
+  os << indent << "DirectoryListingOffset: "
+    << this->DirectoryListingOffset << endl;
+  os << indent << "DirectoryListingPageSize: "
+    << this->DirectoryListingPageSize << endl;
 }
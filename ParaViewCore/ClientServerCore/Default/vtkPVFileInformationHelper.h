@@ -28,6 +28,8 @@
 #include "vtkPVClientServerCoreDefaultModule.h" //needed for exports
 #include "vtkObject.h"
 
+class vtkCollection;
+
 class VTKPVCLIENTSERVERCOREDEFAULT_EXPORT vtkPVFileInformationHelper : public vtkObject
 {
 public:
@@ -76,10 +78,35 @@ public:
   // whenever a group of files is encountered, we verify
   // the type/accessibility of only the first file in the group
   // and assume that all other have similar permissions.
+  // Also, the type reported by the directory entries is trusted for regular
+  // files and directories instead of checking each file.
   // On by default.
   vtkGetMacro(FastFileTypeDetection, int);
   vtkSetMacro(FastFileTypeDetection, int);
 
+  // Description:
+  // When DirectoryListingPageSize is greater than 0, only the directory
+  // entries from DirectoryListingOffset on are returned, about
+  // DirectoryListingPageSize at a time (see
+  // vtkPVFileInformation::GetNextPageOffset()). The entries are listed when
+  // the offset is 0 and kept by this helper until the last page has been
+  // requested. 0 (default) returns all entries.
+  vtkGetMacro(DirectoryListingOffset, int);
+  vtkSetClampMacro(DirectoryListingOffset, int, 0, VTK_INT_MAX);
+  vtkGetMacro(DirectoryListingPageSize, int);
+  vtkSetClampMacro(DirectoryListingPageSize, int, 0, VTK_INT_MAX);
+
+//BTX
+  // Description:
+  // State of the paged directory listing, used by vtkPVFileInformation: the
+  // directory being listed, its entries and the offset of the next page.
+  vtkCollection* GetCursorEntries() { return this->CursorEntries; }
+  vtkSetStringMacro(CursorDirectory);
+  vtkGetStringMacro(CursorDirectory);
+  vtkSetMacro(CursorOffset, int);
+  vtkGetMacro(CursorOffset, int);
+//ETX
+
   // Description:
   // Returns the platform specific path separator.
   vtkGetStringMacro(PathSeparator);
@@ -101,6 +128,12 @@ protected:
   int DirectoryListing;
   int SpecialDirectories;
   int FastFileTypeDetection;
+  int DirectoryListingOffset;
+  int DirectoryListingPageSize;
+
+  vtkCollection* CursorEntries;
+  char* CursorDirectory;
+  int CursorOffset;
 
   char* PathSeparator;
   vtkSetStringMacro(PathSeparator);
@@ -0,0 +1,149 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestAMRStreamingBlockCache.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the bookkeeping of vtkAMRStreamingBlockCache and that blocks are
+// evicted farthest from the view frustum first.
+
+#include "vtkAMRStreamingBlockCache.h"
+#include "vtkCamera.h"
+#include "vtkDoubleArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkUniformGrid.h"
+
+namespace
+{
+  // A 16^3 points block with a scalar array starting at x.
+  vtkSmartPointer<vtkUniformGrid> NewBlock(double x, double y, double z)
+    {
+    vtkSmartPointer<vtkUniformGrid> grid =
+      vtkSmartPointer<vtkUniformGrid>::New();
+    grid->SetOrigin(x, y, z);
+    grid->SetSpacing(0.1, 0.1, 0.1);
+    grid->SetDimensions(16, 16, 16);
+    vtkNew<vtkDoubleArray> scalars;
+    scalars->SetName("Scalars");
+    scalars->SetNumberOfTuples(grid->GetNumberOfPoints());
+    scalars->FillComponent(0, x);
+    grid->GetPointData()->SetScalars(scalars.GetPointer());
+    return grid;
+    }
+
+  bool CheckBlocks(vtkAMRStreamingBlockCache* cache,
+    vtkSmartPointer<vtkUniformGrid> blocks[3], bool expected0,
+    bool expected1, bool expected2, const char* what)
+    {
+    bool expected[3] = { expected0, expected1, expected2 };
+    unsigned long memory = 0;
+    unsigned int count = 0;
+    for (unsigned int cc = 0; cc < 3; ++cc)
+      {
+      vtkUniformGrid* block = cache->GetBlock(cc + 1);
+      if ((block != NULL) != expected[cc] ||
+        (block != NULL && block != blocks[cc].GetPointer()))
+        {
+        cerr << what << ": block " << cc + 1 << " should "
+          << (expected[cc]? "" : "not ") << "be cached." << endl;
+        return false;
+        }
+      memory += expected[cc]? blocks[cc]->GetActualMemorySize() : 0;
+      count += expected[cc]? 1 : 0;
+      }
+    if (cache->GetNumberOfBlocks() != count || cache->GetMemorySize() != memory)
+      {
+      cerr << what << ": " << cache->GetNumberOfBlocks() << " blocks using "
+        << cache->GetMemorySize() << " KiB instead of " << count
+        << " blocks using " << memory << " KiB." << endl;
+      return false;
+      }
+    return true;
+    }
+}
+
+int TestAMRStreamingBlockCache(int, char*[])
+{
+  // Block 1 is in front of the camera, block 2 is just outside of the view
+  // frustum and block 3 far away from it.
+  vtkSmartPointer<vtkUniformGrid> blocks[3] = {
+    NewBlock(0, 0, 0), NewBlock(5, 0, 0), NewBlock(50, 0, 0) };
+
+  vtkNew<vtkCamera> camera;
+  camera->SetFocalPoint(0.75, 0.75, 0.75);
+  camera->SetPosition(0.75, 0.75, 6);
+  camera->SetViewUp(0, 1, 0);
+  camera->SetClippingRange(0.1, 100);
+  double planes[24];
+  camera->GetFrustumPlanes(1.0, planes);
+
+  vtkNew<vtkAMRStreamingBlockCache> cache;
+  if (!CheckBlocks(cache.GetPointer(), blocks, false, false, false, "Empty"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  for (unsigned int cc = 0; cc < 3; ++cc)
+    {
+    cache->AddBlock(cc + 1, blocks[cc]);
+    }
+  // blocks already in the cache are not replaced.
+  vtkSmartPointer<vtkUniformGrid> other = NewBlock(0, 0, 0);
+  cache->AddBlock(1, other);
+  cache->AddBlock(4, NULL);
+  if (!CheckBlocks(cache.GetPointer(), blocks, true, true, true, "Added"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // nothing to do within budget.
+  cache->EvictBlocks(planes, cache->GetMemorySize());
+  if (!CheckBlocks(cache.GetPointer(), blocks, true, true, true, "In budget"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  cache->EvictBlocks(planes, cache->GetMemorySize() - 1);
+  if (!CheckBlocks(cache.GetPointer(), blocks, true, true, false,
+      "One block over budget"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  cache->EvictBlocks(planes, blocks[0]->GetActualMemorySize());
+  if (!CheckBlocks(cache.GetPointer(), blocks, true, false, false,
+      "Room for one block"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  cache->EvictBlocks(planes, 0);
+  if (!CheckBlocks(cache.GetPointer(), blocks, false, false, false,
+      "No budget"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  for (unsigned int cc = 0; cc < 3; ++cc)
+    {
+    cache->AddBlock(cc + 1, blocks[cc]);
+    }
+  cache->Initialize();
+  if (!CheckBlocks(cache.GetPointer(), blocks, false, false, false,
+      "Initialize()"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,157 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestCompositeStreamingPriorityQueue.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the order in which vtkCompositeStreamingPriorityQueue hands out the
+// leaves of composite meta-data: bigger blocks first until view planes are
+// known, then the block the camera looks at, and never the same block twice.
+
+#include "vtkCamera.h"
+#include "vtkCompositeStreamingPriorityQueue.h"
+#include "vtkInformation.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+
+#include <vector>
+
+namespace
+{
+  // Meta-data leaves (flat indices 1 to 4) from the smallest to the biggest.
+  const double BlockBounds[4][6] = {
+    { 0, 1, 0, 1, 0, 1 },
+    { -20, -18, 0, 2, 0, 2 },
+    { 10, 14, 0, 4, 0, 4 },
+    { 0, 8, 20, 28, 0, 8 } };
+
+  void InitializeMetaData(vtkMultiBlockDataSet* metadata, bool bounds)
+    {
+    metadata->SetNumberOfBlocks(4);
+    for (unsigned int cc = 0; cc < 4; ++cc)
+      {
+      metadata->SetBlock(cc, NULL);
+      if (bounds)
+        {
+        metadata->GetMetaData(cc)->Set(
+          vtkStreamingDemandDrivenPipeline::BOUNDS(), BlockBounds[cc], 6);
+        }
+      }
+    }
+
+  std::vector<unsigned int> PopAll(vtkCompositeStreamingPriorityQueue* queue)
+    {
+    std::vector<unsigned int> order;
+    while (!queue->IsEmpty())
+      {
+      order.push_back(queue->Pop());
+      }
+    return order;
+    }
+
+  bool CheckOrder(const std::vector<unsigned int>& order,
+    const unsigned int* expected, size_t count, const char* what)
+    {
+    if (order != std::vector<unsigned int>(expected, expected + count))
+      {
+      cerr << what << ": got";
+      for (size_t cc = 0; cc < order.size(); ++cc)
+        {
+        cerr << " " << order[cc];
+        }
+      cerr << endl;
+      return false;
+      }
+    return true;
+    }
+}
+
+int TestCompositeStreamingPriorityQueue(int, char*[])
+{
+  // Meta-data without bounds for every leaf cannot be streamed.
+  vtkNew<vtkMultiBlockDataSet> empty;
+  vtkNew<vtkMultiBlockDataSet> noBounds;
+  InitializeMetaData(noBounds.GetPointer(), false);
+  vtkNew<vtkMultiBlockDataSet> partialBounds;
+  InitializeMetaData(partialBounds.GetPointer(), true);
+  partialBounds->GetMetaData(2u)->Remove(
+    vtkStreamingDemandDrivenPipeline::BOUNDS());
+  vtkNew<vtkMultiBlockDataSet> metadata;
+  InitializeMetaData(metadata.GetPointer(), true);
+  if (vtkCompositeStreamingPriorityQueue::HasBlockBounds(NULL) ||
+    vtkCompositeStreamingPriorityQueue::HasBlockBounds(empty.GetPointer()) ||
+    vtkCompositeStreamingPriorityQueue::HasBlockBounds(noBounds.GetPointer()) ||
+    vtkCompositeStreamingPriorityQueue::HasBlockBounds(
+      partialBounds.GetPointer()) ||
+    !vtkCompositeStreamingPriorityQueue::HasBlockBounds(metadata.GetPointer()))
+    {
+    cerr << "HasBlockBounds() is wrong." << endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkNew<vtkCompositeStreamingPriorityQueue> queue;
+  queue->SetController(NULL);
+
+  // Without view planes, bigger blocks come first.
+  queue->Initialize(metadata.GetPointer());
+  const unsigned int bySize[4] = { 4, 3, 2, 1 };
+  if (!CheckOrder(PopAll(queue.GetPointer()), bySize, 4, "Order by size"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Looking down at the smallest block, it comes first and the blocks outside
+  // of the view frustum come last.
+  vtkNew<vtkCamera> camera;
+  camera->SetFocalPoint(0.5, 0.5, 0.5);
+  camera->SetPosition(0.5, 0.5, 5);
+  camera->SetViewUp(0, 1, 0);
+  camera->SetClippingRange(0.1, 100);
+  double planes[24];
+  camera->GetFrustumPlanes(1.0, planes);
+
+  queue->Reinitialize();
+  queue->Update(planes);
+  std::vector<unsigned int> order = PopAll(queue.GetPointer());
+  if (order.size() != 4 || order[0] != 1)
+    {
+    cerr << "The visible block should come first." << endl;
+    return EXIT_FAILURE;
+    }
+
+  // Blocks already popped are not handed out again when the view changes.
+  queue->Reinitialize();
+  if (queue->Pop() != 4)
+    {
+    cerr << "The biggest block should come first after Reinitialize()." << endl;
+    return EXIT_FAILURE;
+    }
+  queue->Update(planes);
+  order = PopAll(queue.GetPointer());
+  if (order.size() != 3 || order[0] != 1 || order[1] == 4 || order[2] == 4)
+    {
+    cerr << "Popped blocks should not be queued again by Update()." << endl;
+    return EXIT_FAILURE;
+    }
+
+  // Blocks outside of the clamp bounds are dropped.
+  double clamp[6] = { -1, 2, -1, 2, -1, 2 };
+  queue->Reinitialize();
+  queue->Update(planes, clamp);
+  const unsigned int clamped[1] = { 1 };
+  if (!CheckOrder(PopAll(queue.GetPointer()), clamped, 1, "Clamped blocks"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
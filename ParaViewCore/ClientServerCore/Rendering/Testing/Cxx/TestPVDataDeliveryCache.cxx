@@ -0,0 +1,188 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVDataDeliveryCache.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the keys computed by vtkPVDataDeliveryCache for marshalled data, the
+// least recently used eviction, the size limit and the delivery counters.
+
+#include "vtkCharArray.h"
+#include "vtkCommunicator.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPVDataDeliveryCache.h"
+#include "vtkSmartPointer.h"
+
+#include <string>
+
+namespace
+{
+  // A point cloud of n points starting at x.
+  vtkSmartPointer<vtkPolyData> NewData(double x, int n = 10000)
+    {
+    vtkNew<vtkPoints> points;
+    points->SetDataTypeToDouble();
+    for (int cc = 0; cc < n; ++cc)
+      {
+      points->InsertNextPoint(x + cc, 0, 0);
+      }
+    vtkSmartPointer<vtkPolyData> data = vtkSmartPointer<vtkPolyData>::New();
+    data->SetPoints(points.GetPointer());
+    return data;
+    }
+
+  std::string ComputeKey(vtkDataObject* data)
+    {
+    vtkNew<vtkCharArray> buffer;
+    vtkCommunicator::MarshalDataObject(data, buffer.GetPointer());
+    return vtkPVDataDeliveryCache::ComputeKey(
+      buffer->GetPointer(0), buffer->GetNumberOfTuples());
+    }
+
+  bool CheckCached(vtkPVDataDeliveryCache* cache, const std::string keys[3],
+    vtkSmartPointer<vtkPolyData> data[3], bool expected0, bool expected1,
+    bool expected2, const char* what)
+    {
+    bool expected[3] = { expected0, expected1, expected2 };
+    unsigned long size = 0;
+    for (int cc = 0; cc < 3; ++cc)
+      {
+      // Find() changes the order of eviction, the callers account for it.
+      vtkPolyData* cached = vtkPolyData::SafeDownCast(cache->Find(keys[cc]));
+      if ((cached != NULL) != expected[cc])
+        {
+        cerr << what << ": data " << cc << " should "
+          << (expected[cc]? "" : "not ") << "be cached." << endl;
+        return false;
+        }
+      if (cached && (cached == data[cc].GetPointer() ||
+          cached->GetNumberOfPoints() != data[cc]->GetNumberOfPoints() ||
+          cached->GetPoint(0)[0] != data[cc]->GetPoint(0)[0]))
+        {
+        cerr << what << ": data " << cc << " should be a copy." << endl;
+        return false;
+        }
+      size += expected[cc]? data[cc]->GetActualMemorySize() : 0;
+      }
+    if (cache->GetSize() != size)
+      {
+      cerr << what << ": size is " << cache->GetSize() << " KiB instead of "
+        << size << " KiB." << endl;
+      return false;
+      }
+    return true;
+    }
+}
+
+int TestPVDataDeliveryCache(int, char*[])
+{
+  if (vtkPVDataDeliveryCache::ComputeKey("", 0) !=
+    "d41d8cd98f00b204e9800998ecf8427e" ||
+    vtkPVDataDeliveryCache::ComputeKey("abc", 3) !=
+    "900150983cd24fb0d6963f7d28e17f72")
+    {
+    cerr << "ComputeKey() is not the MD5 digest of the buffer." << endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkSmartPointer<vtkPolyData> data[3] = {
+    NewData(0), NewData(1), NewData(2) };
+  std::string keys[3] = {
+    ComputeKey(data[0]), ComputeKey(data[1]), ComputeKey(data[2]) };
+  if (keys[0] == keys[1] || keys[1] == keys[2] ||
+    ComputeKey(NewData(0)) != keys[0])
+    {
+    cerr << "Keys should only depend on the content of the data." << endl;
+    return EXIT_FAILURE;
+    }
+
+  // Room for two of the three data.
+  vtkNew<vtkPVDataDeliveryCache> cache;
+  unsigned long size = data[0]->GetActualMemorySize();
+  cache->SetMaximumSize(2 * size + size / 2);
+  cache->Add(keys[0], data[0]);
+  cache->Add(keys[1], data[1]);
+  cache->Add(keys[1], data[2]);
+  cache->Add(keys[2], NULL);
+  if (!CheckCached(cache.GetPointer(), keys, data, true, true, false, "Added"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // 1 was found last, 0 is discarded first.
+  cache->Add(keys[2], data[2]);
+  if (!CheckCached(cache.GetPointer(), keys, data, false, true, true,
+      "Least recently used discarded"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Finding 1 makes 2 the least recently used.
+  cache->Find(keys[1]);
+  cache->Add(keys[0], data[0]);
+  if (!CheckCached(cache.GetPointer(), keys, data, true, true, false,
+      "Least recently found discarded"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Shrinking the cache discards the least recently used data.
+  cache->SetMaximumSize(size + size / 2);
+  if (!CheckCached(cache.GetPointer(), keys, data, false, true, false,
+      "Shrunk"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Data bigger than the cache is not added, and does not flush the cache.
+  vtkSmartPointer<vtkPolyData> big = NewData(0, 20000);
+  std::string bigKey = ComputeKey(big);
+  cache->Add(bigKey, big);
+  if (cache->Find(bigKey) != NULL ||
+    !CheckCached(cache.GetPointer(), keys, data, false, true, false,
+      "Too big"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  cache->SetMaximumSize(4 * size);
+  for (int cc = 0; cc < 3; ++cc)
+    {
+    cache->Add(keys[cc], data[cc]);
+    }
+  cache->Clear();
+  if (!CheckCached(cache.GetPointer(), keys, data, false, false, false,
+      "Clear()"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  cache->RecordDelivery(true, 100);
+  cache->RecordDelivery(true, 20);
+  cache->RecordDelivery(false, 3);
+  if (cache->GetNumberOfHits() != 2 || cache->GetBytesAvoided() != 120 ||
+    cache->GetNumberOfMisses() != 1 || cache->GetBytesDelivered() != 3)
+    {
+    cerr << "Wrong delivery counters." << endl;
+    return EXIT_FAILURE;
+    }
+  cache->ResetCounters();
+  if (cache->GetNumberOfHits() != 0 || cache->GetBytesAvoided() != 0 ||
+    cache->GetNumberOfMisses() != 0 || cache->GetBytesDelivered() != 0)
+    {
+    cerr << "ResetCounters() should reset all the counters." << endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
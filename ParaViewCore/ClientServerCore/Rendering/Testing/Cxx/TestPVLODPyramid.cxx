@@ -0,0 +1,224 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVLODPyramid.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Builds vtkPVLODPyramid for a quad mesh and for a multiblock dataset, checks
+// the decimated levels (input points only, no collapsed cells, coarser with
+// every level, data passed through) and when the pyramid is rebuilt.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPVLODPyramid.h"
+
+namespace
+{
+  // A mesh of n x n quads in the z=0 plane, with PointValue = x + 2y and
+  // CellId arrays.
+  void BuildMesh(vtkPolyData* mesh, int n)
+    {
+    vtkNew<vtkPoints> points;
+    points->SetDataTypeToDouble();
+    vtkNew<vtkDoubleArray> pointValues;
+    pointValues->SetName("PointValue");
+    for (int j = 0; j <= n; ++j)
+      {
+      for (int i = 0; i <= n; ++i)
+        {
+        double x = static_cast<double>(i) / n;
+        double y = static_cast<double>(j) / n;
+        points->InsertNextPoint(x, y, 0);
+        pointValues->InsertNextValue(x + 2 * y);
+        }
+      }
+    vtkNew<vtkCellArray> polys;
+    vtkNew<vtkIdTypeArray> cellIds;
+    cellIds->SetName("CellId");
+    for (int j = 0; j < n; ++j)
+      {
+      for (int i = 0; i < n; ++i)
+        {
+        vtkIdType p0 = i + (n + 1) * j;
+        vtkIdType quad[4] = { p0, p0 + 1, p0 + n + 2, p0 + n + 1 };
+        cellIds->InsertNextValue(polys->InsertNextCell(4, quad));
+        }
+      }
+    mesh->SetPoints(points.GetPointer());
+    mesh->SetPolys(polys.GetPointer());
+    mesh->GetPointData()->AddArray(pointValues.GetPointer());
+    mesh->GetCellData()->AddArray(cellIds.GetPointer());
+    }
+
+  // Checks a level decimated from a mesh built by BuildMesh().
+  bool CheckLevel(vtkPolyData* level, vtkPolyData* mesh, int divisions,
+    vtkIdType maxNumberOfPoints)
+    {
+    vtkIdType numPts = level? level->GetNumberOfPoints() : 0;
+    if (numPts == 0 || numPts > maxNumberOfPoints ||
+      numPts > static_cast<vtkIdType>(divisions) * divisions ||
+      level->GetNumberOfPolys() == 0 ||
+      level->GetNumberOfPolys() != level->GetNumberOfCells())
+      {
+      cerr << "Wrong number of points (" << numPts << ") or cells." << endl;
+      return false;
+      }
+
+    // points are input points, with their data.
+    vtkDataArray* pointValues =
+      level->GetPointData()->GetArray("PointValue");
+    for (vtkIdType cc = 0; pointValues && cc < numPts; ++cc)
+      {
+      double x[3];
+      level->GetPoint(cc, x);
+      if (pointValues->GetTuple1(cc) != x[0] + 2 * x[1] || x[2] != 0)
+        {
+        pointValues = NULL;
+        }
+      }
+    if (!pointValues)
+      {
+      cerr << "Points should be input points with their data." << endl;
+      return false;
+      }
+
+    // triangles that did not collapse, with the data of an input cell.
+    vtkDataArray* cellIds = level->GetCellData()->GetArray("CellId");
+    vtkCellArray* polys = level->GetPolys();
+    vtkIdType npts;
+    vtkIdType* ids;
+    vtkIdType cellId = 0;
+    for (polys->InitTraversal(); polys->GetNextCell(npts, ids); ++cellId)
+      {
+      if (npts != 3 || ids[0] == ids[1] || ids[1] == ids[2] ||
+        ids[0] == ids[2] || !cellIds ||
+        cellIds->GetTuple1(cellId) < 0 ||
+        cellIds->GetTuple1(cellId) >= mesh->GetNumberOfCells())
+        {
+        cerr << "Cell " << cellId << " is not a valid triangle." << endl;
+        return false;
+        }
+      }
+    return true;
+    }
+}
+
+int TestPVLODPyramid(int, char*[])
+{
+  if (vtkPVLODPyramid::GetNumberOfDivisions(1.0, 0) != 160 ||
+    vtkPVLODPyramid::GetNumberOfDivisions(1.0, 1) != 85 ||
+    vtkPVLODPyramid::GetNumberOfDivisions(0.5, 2) != 28)
+    {
+    cerr << "Wrong number of divisions." << endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkNew<vtkPVLODPyramid> pyramid;
+  if (pyramid->GetNumberOfLevels() != 0 || pyramid->GetLevel(0) != NULL)
+    {
+    cerr << "The pyramid should be empty." << endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkNew<vtkPolyData> mesh;
+  BuildMesh(mesh.GetPointer(), 200);
+
+  const double resolution = 0.5;
+  if (!pyramid->Build(mesh.GetPointer(), resolution, 3) ||
+    pyramid->GetNumberOfLevels() != 3)
+    {
+    cerr << "The pyramid should have been built with 3 levels." << endl;
+    return EXIT_FAILURE;
+    }
+  vtkIdType maxNumberOfPoints = mesh->GetNumberOfPoints() - 1;
+  for (int level = 0; level < 3; ++level)
+    {
+    vtkPolyData* pd = vtkPolyData::SafeDownCast(pyramid->GetLevel(level));
+    if (!CheckLevel(pd, mesh.GetPointer(),
+        vtkPVLODPyramid::GetNumberOfDivisions(resolution, level),
+        maxNumberOfPoints))
+      {
+      cerr << "Level " << level << " is wrong." << endl;
+      return EXIT_FAILURE;
+      }
+    maxNumberOfPoints = pd->GetNumberOfPoints() - 1;
+    }
+  if (pyramid->GetLevel(-1) != pyramid->GetLevel(0) ||
+    pyramid->GetLevel(5) != pyramid->GetLevel(2))
+    {
+    cerr << "GetLevel() should clamp the level." << endl;
+    return EXIT_FAILURE;
+    }
+
+  // Only rebuilt when something changes.
+  vtkDataObject* level0 = pyramid->GetLevel(0);
+  if (pyramid->Build(mesh.GetPointer(), resolution, 3) ||
+    pyramid->GetLevel(0) != level0)
+    {
+    cerr << "The pyramid should not have been rebuilt." << endl;
+    return EXIT_FAILURE;
+    }
+  mesh->Modified();
+  if (!pyramid->Build(mesh.GetPointer(), resolution, 3) ||
+    !pyramid->Build(mesh.GetPointer(), 2 * resolution, 3) ||
+    !pyramid->Build(mesh.GetPointer(), 2 * resolution, 2) ||
+    pyramid->GetNumberOfLevels() != 2)
+    {
+    cerr << "The pyramid should have been rebuilt." << endl;
+    return EXIT_FAILURE;
+    }
+
+  // Polygonal leaves are decimated, the others are left empty.
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(2, 2, 2);
+  vtkNew<vtkMultiBlockDataSet> mb;
+  mb->SetNumberOfBlocks(2);
+  mb->SetBlock(0, mesh.GetPointer());
+  mb->SetBlock(1, image.GetPointer());
+  if (!pyramid->Build(mb.GetPointer(), resolution, 2) ||
+    pyramid->GetNumberOfLevels() != 2)
+    {
+    cerr << "The pyramid should have been built for the multiblock." << endl;
+    return EXIT_FAILURE;
+    }
+  for (int level = 0; level < 2; ++level)
+    {
+    vtkMultiBlockDataSet* output =
+      vtkMultiBlockDataSet::SafeDownCast(pyramid->GetLevel(level));
+    if (!output || output->GetNumberOfBlocks() != 2 ||
+      output->GetBlock(1) != NULL ||
+      !CheckLevel(vtkPolyData::SafeDownCast(output->GetBlock(0)),
+        mesh.GetPointer(),
+        vtkPVLODPyramid::GetNumberOfDivisions(resolution, level),
+        mesh->GetNumberOfPoints() - 1))
+      {
+      cerr << "Level " << level << " of the multiblock is wrong." << endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  pyramid->Initialize();
+  if (pyramid->GetNumberOfLevels() != 0 || pyramid->GetLevel(0) != NULL)
+    {
+    cerr << "Initialize() should release the pyramid." << endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
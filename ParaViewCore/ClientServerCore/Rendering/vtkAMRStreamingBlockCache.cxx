@@ -0,0 +1,165 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkAMRStreamingBlockCache.h"
+
+#include "vtkObjectFactory.h"
+#include "vtkSmartPointer.h"
+#include "vtkUniformGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <vector>
+
+namespace
+{
+  // Returns how far the block is outside the view frustum (negative when the
+  // block is, at least partially, inside). Like vtkComputeScreenCoverage(),
+  // the block is approximated by its bounding sphere.
+  double vtkDistanceFromFrustum(const double planes[24], const double bounds[6])
+    {
+    double center[3];
+    center[0] = (bounds[0] + bounds[1]) / 2.0;
+    center[1] = (bounds[2] + bounds[3]) / 2.0;
+    center[2] = (bounds[4] + bounds[5]) / 2.0;
+    double radius = 0.5 * sqrt(
+      ( bounds[1] - bounds[0] ) * ( bounds[1] - bounds[0] ) +
+      ( bounds[3] - bounds[2] ) * ( bounds[3] - bounds[2] ) +
+      ( bounds[5] - bounds[4] ) * ( bounds[5] - bounds[4] ) );
+
+    double distance = -VTK_DOUBLE_MAX;
+    for (int i = 0; i < 6; i++)
+      {
+      double d = planes[i*4 + 0] * center[0] +
+        planes[i*4 + 1] * center[1] +
+        planes[i*4 + 2] * center[2] +
+        planes[i*4 + 3];
+      distance = std::max(distance, -d - radius);
+      }
+    return distance;
+    }
+}
+
+class vtkAMRStreamingBlockCache::vtkInternals
+{
+public:
+  struct vtkCachedBlock
+    {
+    vtkSmartPointer<vtkUniformGrid> Grid;
+    unsigned long Size; // in KiB.
+    double Bounds[6];
+    };
+  typedef std::map<unsigned int, vtkCachedBlock> BlockCacheType;
+
+  // Blocks keyed by composite id.
+  BlockCacheType BlockCache;
+  unsigned long MemorySize; // in KiB.
+
+  vtkInternals() : MemorySize(0) {}
+};
+
+vtkStandardNewMacro(vtkAMRStreamingBlockCache);
+//----------------------------------------------------------------------------
+vtkAMRStreamingBlockCache::vtkAMRStreamingBlockCache()
+{
+  this->Internals = new vtkInternals();
+}
+
+//----------------------------------------------------------------------------
+vtkAMRStreamingBlockCache::~vtkAMRStreamingBlockCache()
+{
+  delete this->Internals;
+  this->Internals = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkAMRStreamingBlockCache::Initialize()
+{
+  this->Internals->BlockCache.clear();
+  this->Internals->MemorySize = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkAMRStreamingBlockCache::AddBlock(unsigned int cid, vtkUniformGrid* grid)
+{
+  if (!grid || this->HasBlock(cid))
+    {
+    return;
+    }
+  vtkInternals::vtkCachedBlock& block = this->Internals->BlockCache[cid];
+  block.Grid = grid;
+  block.Size = grid->GetActualMemorySize();
+  grid->GetBounds(block.Bounds);
+  this->Internals->MemorySize += block.Size;
+}
+
+//----------------------------------------------------------------------------
+vtkUniformGrid* vtkAMRStreamingBlockCache::GetBlock(unsigned int cid)
+{
+  vtkInternals::BlockCacheType::iterator iter =
+    this->Internals->BlockCache.find(cid);
+  return iter != this->Internals->BlockCache.end()?
+    iter->second.Grid.GetPointer() : NULL;
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkAMRStreamingBlockCache::GetNumberOfBlocks()
+{
+  return static_cast<unsigned int>(this->Internals->BlockCache.size());
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkAMRStreamingBlockCache::GetMemorySize()
+{
+  return this->Internals->MemorySize;
+}
+
+//----------------------------------------------------------------------------
+void vtkAMRStreamingBlockCache::EvictBlocks(
+  const double view_planes[24], unsigned long budget)
+{
+  if (this->Internals->MemorySize <= budget)
+    {
+    return;
+    }
+
+  std::vector<std::pair<double, unsigned int> > order;
+  order.reserve(this->Internals->BlockCache.size());
+  for (vtkInternals::BlockCacheType::iterator iter =
+    this->Internals->BlockCache.begin();
+    iter != this->Internals->BlockCache.end(); ++iter)
+    {
+    order.push_back(std::pair<double, unsigned int>(
+        vtkDistanceFromFrustum(view_planes, iter->second.Bounds),
+        iter->first));
+    }
+  std::sort(order.begin(), order.end());
+  while (this->Internals->MemorySize > budget && !order.empty())
+    {
+    vtkInternals::BlockCacheType::iterator iter =
+      this->Internals->BlockCache.find(order.back().second);
+    this->Internals->MemorySize -= iter->second.Size;
+    this->Internals->BlockCache.erase(iter);
+    order.pop_back();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkAMRStreamingBlockCache::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfBlocks: " << this->GetNumberOfBlocks() << endl;
+  os << indent << "MemorySize: " << this->GetMemorySize() << endl;
+}
@@ -0,0 +1,83 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkAMRStreamingBlockCache - keeps AMR blocks read while streaming.
+// .SECTION Description
+// vtkAMRStreamingBlockCache is used by vtkAMRStreamingVolumeRepresentation to
+// keep the blocks read while streaming, so that they don't need to be read
+// again when streaming restarts after the camera moved. Blocks are identified
+// by their composite id (see vtkAMRInformation::GetIndex()). The cache itself
+// is unbounded; EvictBlocks() brings it back within a memory budget by
+// evicting the blocks farthest from the view frustum first.
+// .SECTION See Also
+// vtkAMRStreamingVolumeRepresentation, vtkAMRStreamingPriorityQueue.
+
+#ifndef __vtkAMRStreamingBlockCache_h
+#define __vtkAMRStreamingBlockCache_h
+
+#include "vtkPVClientServerCoreRenderingModule.h" // for export macros
+#include "vtkObject.h"
+
+class vtkUniformGrid;
+
+class VTKPVCLIENTSERVERCORERENDERING_EXPORT vtkAMRStreamingBlockCache : public vtkObject
+{
+public:
+  static vtkAMRStreamingBlockCache* New();
+  vtkTypeMacro(vtkAMRStreamingBlockCache, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Removes all blocks from the cache.
+  void Initialize();
+
+  // Description:
+  // Adds a block to the cache. Blocks already in the cache are not replaced.
+  void AddBlock(unsigned int cid, vtkUniformGrid* grid);
+
+  // Description:
+  // Returns the block with the given composite id, or NULL if it is not in
+  // the cache.
+  vtkUniformGrid* GetBlock(unsigned int cid);
+  bool HasBlock(unsigned int cid)
+    { return this->GetBlock(cid) != NULL; }
+
+  // Description:
+  // Returns the number of blocks in the cache and their total memory size
+  // (in KiB, as reported by vtkDataObject::GetActualMemorySize()).
+  unsigned int GetNumberOfBlocks();
+  unsigned long GetMemorySize();
+
+  // Description:
+  // Evicts blocks until the memory size is at most budget (in KiB). Blocks
+  // are evicted in decreasing order of their distance outside the view
+  // frustum given by view_planes (see vtkCamera::GetFrustumPlanes()), each
+  // block being approximated by its bounding sphere.
+  void EvictBlocks(const double view_planes[24], unsigned long budget);
+
+//BTX
+protected:
+  vtkAMRStreamingBlockCache();
+  ~vtkAMRStreamingBlockCache();
+
+private:
+  vtkAMRStreamingBlockCache(const vtkAMRStreamingBlockCache&); // Not implemented
+  void operator=(const vtkAMRStreamingBlockCache&); // Not implemented
+
+  class vtkInternals;
+  vtkInternals* Internals;
+//ETX
+};
+
+#endif
@@ -15,12 +15,15 @@
 #include "vtkAMRStreamingVolumeRepresentation.h"
 
 #include "vtkAlgorithmOutput.h"
+#include "vtkAMRInformation.h"
+#include "vtkAMRStreamingBlockCache.h"
 #include "vtkAMRStreamingPriorityQueue.h"
 #include "vtkAMRVolumeMapper.h"
 #include "vtkCompositeDataPipeline.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
 #include "vtkOverlappingAMR.h"
 #include "vtkPVLODVolume.h"
@@ -31,8 +34,29 @@
 #include "vtkResampledAMRImageSource.h"
 #include "vtkSmartVolumeMapper.h"
 #include "vtkUniformGrid.h"
+#include "vtkUniformGridAMRDataIterator.h"
 #include "vtkVolumeProperty.h"
 
+#include <algorithm>
+#include <assert.h>
+#include <vector>
+
+class vtkAMRStreamingVolumeRepresentation::vtkInternals
+{
+public:
+  // Blocks popped from the priority queue in the current streaming pass that
+  // are provided from the BlockCache rather than by the input pipeline.
+  std::vector<unsigned int> CachedBlocksRequested;
+
+  // View planes for the current streaming pass.
+  double ViewPlanes[24];
+
+  vtkInternals()
+    {
+    std::fill(this->ViewPlanes, this->ViewPlanes + 24, 0.0);
+    }
+};
+
 vtkStandardNewMacro(vtkAMRStreamingVolumeRepresentation);
 //----------------------------------------------------------------------------
 vtkAMRStreamingVolumeRepresentation::vtkAMRStreamingVolumeRepresentation()
@@ -41,6 +65,7 @@ vtkAMRStreamingVolumeRepresentation::vtkAMRStreamingVolumeRepresentation()
   this->InStreamingUpdate = false;
 
   this->PriorityQueue = vtkSmartPointer<vtkAMRStreamingPriorityQueue>::New();
+  this->BlockCache = vtkSmartPointer<vtkAMRStreamingBlockCache>::New();
   this->Resampler = vtkSmartPointer<vtkResampledAMRImageSource>::New();
   this->Resampler->SetMaxDimensions(32, 32, 32);
 
@@ -56,11 +81,15 @@ vtkAMRStreamingVolumeRepresentation::vtkAMRStreamingVolumeRepresentation()
     vtkAMRStreamingVolumeRepresentation::RESAMPLE_OVER_DATA_BOUNDS;
 
   this->StreamingRequestSize = 50;
+  this->BlockCacheSize = 256;
+  this->Internals = new vtkInternals();
 }
 
 //----------------------------------------------------------------------------
 vtkAMRStreamingVolumeRepresentation::~vtkAMRStreamingVolumeRepresentation()
 {
+  delete this->Internals;
+  this->Internals = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -104,6 +133,7 @@ void vtkAMRStreamingVolumeRepresentation::PrintSelf(ostream& os, vtkIndent inden
     }
   os << indent << "StreamingRequestSize: "
     << this->StreamingRequestSize << endl;
+  os << indent << "BlockCacheSize: " << this->BlockCacheSize << endl;
 }
 
 //----------------------------------------------------------------------------
@@ -236,18 +266,42 @@ int vtkAMRStreamingVolumeRepresentation::RequestUpdateExtent(
         assert(this->PriorityQueue->IsEmpty() == false);
         assert(this->StreamingRequestSize > 0);
 
-        int *request_ids = new int[this->StreamingRequestSize];
-        for (int jj=0; jj < this->StreamingRequestSize; jj++)
+        // Blocks that are in the block cache are not requested again. When
+        // running on a single process, they don't count towards the request
+        // size either. In parallel, all processes must pop the same number of
+        // items from their queues to keep them in sync, so we can only avoid
+        // re-reading the cached blocks.
+        vtkMultiProcessController* controller =
+          vtkMultiProcessController::GetGlobalController();
+        bool skip_cached = (controller == NULL ||
+          controller->GetNumberOfProcesses() <= 1);
+
+        std::vector<int> request_ids;
+        this->Internals->CachedBlocksRequested.clear();
+        int count = 0;
+        while (count < this->StreamingRequestSize &&
+          !this->PriorityQueue->IsEmpty())
           {
-          int cid = static_cast<int>(this->PriorityQueue->Pop());
+          unsigned int cid = this->PriorityQueue->Pop();
           //vtkStreamingStatusMacro(<< this << ": requesting blocks: " << cid);
-          request_ids[jj] = cid;
+          if (this->BlockCache->HasBlock(cid))
+            {
+            this->Internals->CachedBlocksRequested.push_back(cid);
+            count += skip_cached? 0 : 1;
+            }
+          else
+            {
+            request_ids.push_back(static_cast<int>(cid));
+            count++;
+            }
           }
-        // Request the next "group of blocks" to stream.
+        // Request the next "group of blocks" to stream. Note that the request
+        // may be empty if all blocks were found in the cache.
+        int empty_request = 0;
         info->Set(vtkCompositeDataPipeline::LOAD_REQUESTED_BLOCKS(), 1);
         info->Set(vtkCompositeDataPipeline::UPDATE_COMPOSITE_INDICES(),
-          request_ids, this->StreamingRequestSize);
-        delete [] request_ids;
+          request_ids.empty()? &empty_request : &request_ids[0],
+          static_cast<int>(request_ids.size()));
         }
       else
         {
@@ -286,6 +340,10 @@ int vtkAMRStreamingVolumeRepresentation::RequestData(vtkInformation* rqst,
   if (!this->GetInStreamingUpdate())
     {
     this->Resampler->Reset();
+
+    // the input changed, hence the cached blocks are no longer valid.
+    this->BlockCache->Initialize();
+    this->Internals->CachedBlocksRequested.clear();
     }
 
   this->ProcessedPiece = NULL;
@@ -305,6 +363,11 @@ int vtkAMRStreamingVolumeRepresentation::RequestData(vtkInformation* rqst,
       input->GetBounds(bounds);
       this->DataBounds.SetBounds(bounds);
       }
+    else if (this->ResamplingMode == RESAMPLE_USING_VIEW_FRUSTUM &&
+      this->BlockCacheSize > 0)
+      {
+      this->ProcessedPiece = this->UpdateBlockCache(input);
+      }
     else
       {
       this->ProcessedPiece = input;
@@ -370,6 +433,7 @@ bool vtkAMRStreamingVolumeRepresentation::StreamingUpdate(
     // update the priority queue, if needed.
     this->PriorityQueue->Update(view_planes,
       this->Resampler->GetSpatialBounds());
+    std::copy(view_planes, view_planes + 24, this->Internals->ViewPlanes);
 
     this->MarkModified();
     this->Update();
@@ -381,6 +445,54 @@ bool vtkAMRStreamingVolumeRepresentation::StreamingUpdate(
   return false;
 }
 
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkDataObject>
+vtkAMRStreamingVolumeRepresentation::UpdateBlockCache(vtkOverlappingAMR* input)
+{
+  vtkAMRInformation* amrInfo = input->GetAMRInfo();
+
+  // Add the blocks read in this pass to the cache.
+  vtkSmartPointer<vtkUniformGridAMRDataIterator> iter;
+  iter.TakeReference(
+    vtkUniformGridAMRDataIterator::SafeDownCast(input->NewIterator()));
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+    {
+    vtkUniformGrid* grid = vtkUniformGrid::SafeDownCast(
+      iter->GetCurrentDataObject());
+    if (grid)
+      {
+      this->BlockCache->AddBlock(
+        amrInfo->GetIndex(iter->GetCurrentLevel(), iter->GetCurrentIndex()),
+        grid);
+      }
+    }
+
+  vtkSmartPointer<vtkDataObject> piece = input;
+  if (!this->Internals->CachedBlocksRequested.empty())
+    {
+    // Add the blocks that were found in the cache to the piece.
+    vtkSmartPointer<vtkOverlappingAMR> amr =
+      vtkSmartPointer<vtkOverlappingAMR>::New();
+    amr->ShallowCopy(input);
+    for (size_t cc=0; cc < this->Internals->CachedBlocksRequested.size(); cc++)
+      {
+      unsigned int cid = this->Internals->CachedBlocksRequested[cc];
+      unsigned int level=0, index=0;
+      amrInfo->ComputeIndexPair(cid, level, index);
+      amr->SetDataSet(level, index, this->BlockCache->GetBlock(cid));
+      }
+    vtkStreamingStatusMacro(<< this << ": "
+      << this->Internals->CachedBlocksRequested.size()
+      << " blocks provided from the block cache.");
+    this->Internals->CachedBlocksRequested.clear();
+    piece = amr;
+    }
+
+  this->BlockCache->EvictBlocks(this->Internals->ViewPlanes,
+    static_cast<unsigned long>(this->BlockCacheSize) * 1024);
+  return piece;
+}
+
 //----------------------------------------------------------------------------
 bool vtkAMRStreamingVolumeRepresentation::AddToView(vtkView* view)
 {
@@ -25,6 +25,7 @@
 #include "vtkSmartPointer.h" // needed for vtkSmartPointer.
 #include "vtkBoundingBox.h" // needed for vtkBoundingBox.
 
+class vtkAMRStreamingBlockCache;
 class vtkAMRStreamingPriorityQueue;
 class vtkColorTransferFunction;
 class vtkImageData;
@@ -85,6 +86,16 @@ public:
   vtkSetClampMacro(StreamingRequestSize, int, 1, 10000);
   vtkGetMacro(StreamingRequestSize, int);
 
+  // Description:
+  // Set the memory budget (in MB) for the cache of blocks read while streaming
+  // in RESAMPLE_USING_VIEW_FRUSTUM mode. Streaming restarts every time the
+  // camera moves in that mode; blocks found in the cache are then provided
+  // again without being requested from the input pipeline. When the cache
+  // exceeds the budget, blocks farthest from the current view frustum are
+  // evicted first. Set to 0 to disable the cache. Default is 256.
+  vtkSetClampMacro(BlockCacheSize, int, 0, VTK_INT_MAX);
+  vtkGetMacro(BlockCacheSize, int);
+
 
   // Description:
   // Set the input data arrays that this algorithm will process.
@@ -198,6 +209,12 @@ protected:
   // regenerate the outline for the next "piece" of data.
   bool StreamingUpdate(vtkPVRenderView* view, const double view_planes[24]);
 
+  // Description:
+  // Adds the blocks in the input to the block cache and returns the piece to
+  // deliver i.e. the input with blocks found in the cache during
+  // RequestUpdateExtent() added. Evicts blocks when the cache is over budget.
+  vtkSmartPointer<vtkDataObject> UpdateBlockCache(vtkOverlappingAMR* input);
+
   // Description:
   // This is the data object generated processed by the most recent call to
   // RequestData() while not streaming. 
@@ -217,6 +234,11 @@ protected:
   // application and data type.
   vtkSmartPointer<vtkAMRStreamingPriorityQueue> PriorityQueue;
 
+  // Description:
+  // Blocks read while streaming in RESAMPLE_USING_VIEW_FRUSTUM mode, see
+  // BlockCacheSize.
+  vtkSmartPointer<vtkAMRStreamingBlockCache> BlockCache;
+
   // Description:
   // vtkImageData source used to resample an AMR dataset into a uniform grid
   // suitable for volume rendering.
@@ -234,6 +256,7 @@ protected:
 
   int ResamplingMode;
   int StreamingRequestSize;
+  int BlockCacheSize;
 
 private:
   vtkAMRStreamingVolumeRepresentation(const vtkAMRStreamingVolumeRepresentation&); // Not implemented
@@ -254,6 +277,9 @@ private:
   // longer valid.
   bool InStreamingUpdate;
 
+  class vtkInternals;
+  vtkInternals* Internals;
+
 //ETX
 };
 
@@ -239,6 +239,7 @@ int vtkChartRepresentation::RequestData(vtkInformation* request,
       vtkNew<vtkReductionFilter> reductionFilter;
       vtkNew<vtkPVMergeTablesMultiBlock> algo;
       reductionFilter->SetPostGatherHelper(algo.GetPointer());
+      reductionFilter->SetUseTreeReduction(1);
       reductionFilter->SetController(pm->GetGlobalController());
       reductionFilter->SetInputData(data);
       reductionFilter->Update();
@@ -0,0 +1,191 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCompositeStreamingPriorityQueue.h"
+
+#include "vtkBoundingBox.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkInformation.h"
+#include "vtkMath.h"
+#include "vtkMultiProcessController.h"
+#include "vtkObjectFactory.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkStreamingPriorityQueue.h"
+
+#include <assert.h>
+#include <vector>
+
+class vtkCompositeStreamingPriorityQueue::vtkInternals
+{
+public:
+  vtkStreamingPriorityQueue<> PriorityQueue;
+  vtkSmartPointer<vtkCompositeDataSet> Metadata;
+};
+
+namespace
+{
+  // Returns a new iterator over all leaves of the meta-data. Leaves in the
+  // meta-data are typically empty, hence we don't skip empty nodes.
+  vtkCompositeDataIterator* vtkNewLeafIterator(vtkCompositeDataSet* metadata)
+    {
+    vtkCompositeDataIterator* iter = metadata->NewIterator();
+    iter->SkipEmptyNodesOff();
+    return iter;
+    }
+}
+
+vtkStandardNewMacro(vtkCompositeStreamingPriorityQueue);
+vtkCxxSetObjectMacro(vtkCompositeStreamingPriorityQueue, Controller, vtkMultiProcessController);
+//----------------------------------------------------------------------------
+vtkCompositeStreamingPriorityQueue::vtkCompositeStreamingPriorityQueue()
+{
+  this->Internals = new vtkInternals();
+  this->Controller = 0;
+  this->SetController(vtkMultiProcessController::GetGlobalController());
+}
+
+//----------------------------------------------------------------------------
+vtkCompositeStreamingPriorityQueue::~vtkCompositeStreamingPriorityQueue()
+{
+  delete this->Internals;
+  this->Internals = 0;
+  this->SetController(0);
+}
+
+//----------------------------------------------------------------------------
+bool vtkCompositeStreamingPriorityQueue::HasBlockBounds(
+  vtkCompositeDataSet* metadata)
+{
+  if (!metadata)
+    {
+    return false;
+    }
+
+  bool has_leaves = false;
+  bool has_bounds = true;
+  vtkCompositeDataIterator* iter = vtkNewLeafIterator(metadata);
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal() && has_bounds;
+    iter->GoToNextItem())
+    {
+    has_leaves = true;
+    has_bounds = (iter->HasCurrentMetaData() != 0 &&
+      iter->GetCurrentMetaData()->Has(
+        vtkStreamingDemandDrivenPipeline::BOUNDS()) != 0);
+    }
+  iter->Delete();
+  return has_leaves && has_bounds;
+}
+
+//----------------------------------------------------------------------------
+void vtkCompositeStreamingPriorityQueue::Initialize(
+  vtkCompositeDataSet* metadata)
+{
+  delete this->Internals;
+  this->Internals = new vtkInternals();
+  this->Internals->Metadata = metadata;
+  if (!metadata)
+    {
+    return;
+    }
+
+  vtkCompositeDataIterator* iter = vtkNewLeafIterator(metadata);
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+    {
+    vtkStreamingPriorityQueueItem item;
+    item.Identifier = iter->GetCurrentFlatIndex();
+    if (iter->HasCurrentMetaData() &&
+      iter->GetCurrentMetaData()->Has(vtkStreamingDemandDrivenPipeline::BOUNDS()))
+      {
+      double block_bounds[6];
+      iter->GetCurrentMetaData()->Get(
+        vtkStreamingDemandDrivenPipeline::BOUNDS(), block_bounds);
+      item.Bounds.SetBounds(block_bounds);
+      }
+
+    // default priority is to prefer bigger blocks. Thus even without
+    // view-planes we have reasonable priority.
+    item.Priority = item.Bounds.IsValid()? item.Bounds.GetDiagonalLength() : 0;
+    this->Internals->PriorityQueue.push(item);
+    }
+  iter->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkCompositeStreamingPriorityQueue::Reinitialize()
+{
+  if (this->Internals->Metadata)
+    {
+    vtkSmartPointer<vtkCompositeDataSet> info = this->Internals->Metadata;
+    this->Initialize(info);
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkCompositeStreamingPriorityQueue::IsEmpty()
+{
+  return this->Internals->PriorityQueue.empty();
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkCompositeStreamingPriorityQueue::Pop()
+{
+  if (this->IsEmpty())
+    {
+    vtkErrorMacro("Queue is empty!");
+    return 0;
+    }
+
+  int num_procs = this->Controller? this->Controller->GetNumberOfProcesses() : 1;
+  int myid = this->Controller? this->Controller->GetLocalProcessId() : 0;
+  assert(myid < num_procs);
+
+  // Unlike AMR, where asking for the root block again is harmless, requesting
+  // a block twice would duplicate geometry. Hence processes that don't get an
+  // item when the queue empties out in the middle of a pop get 0.
+  std::vector<unsigned int> items(num_procs, 0);
+  for (int cc=0; cc < num_procs && !this->Internals->PriorityQueue.empty(); cc++)
+    {
+    items[cc] = this->Internals->PriorityQueue.top().Identifier;
+    this->Internals->PriorityQueue.pop();
+    }
+  return items[myid];
+}
+
+//----------------------------------------------------------------------------
+void vtkCompositeStreamingPriorityQueue::Update(const double view_planes[24])
+{
+  double clamp_bounds[6];
+  vtkMath::UninitializeBounds(clamp_bounds);
+  this->Update(view_planes, clamp_bounds);
+}
+
+//----------------------------------------------------------------------------
+void vtkCompositeStreamingPriorityQueue::Update(const double view_planes[24],
+  const double clamp_bounds[6])
+{
+  if (!this->Internals->Metadata)
+    {
+    return;
+    }
+  this->Internals->PriorityQueue.UpdatePriorities(view_planes, clamp_bounds);
+}
+
+//----------------------------------------------------------------------------
+void vtkCompositeStreamingPriorityQueue::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Controller: " << this->Controller << endl;
+}
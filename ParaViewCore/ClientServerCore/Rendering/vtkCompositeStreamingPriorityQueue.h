@@ -0,0 +1,109 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkCompositeStreamingPriorityQueue - implements a coverage based
+// priority queue for the leaves of a composite dataset.
+// .SECTION Description
+// vtkCompositeStreamingPriorityQueue is used by representations supporting
+// streaming of (non-AMR) composite datasets, e.g. multi-piece unstructured
+// meshes, to determine the order in which the leaf blocks are requested. This
+// class relies on the vtkStreamingDemandDrivenPipeline::BOUNDS() provided for
+// every leaf in the meta-data produced by the input pipeline (see
+// vtkCompositeDataPipeline::COMPOSITE_DATA_META_DATA()). Blocks are
+// prioritized by their screen coverage, as determined by the view planes
+// (returned by vtkCamera::GetFrustumPlanes()) passed to Update(). Until
+// Update() is called, larger blocks are preferred.
+//
+// This implementation is based on vtkAMRStreamingPriorityQueue.
+// .SECTION See Also
+// vtkGeometryRepresentation, vtkAMRStreamingPriorityQueue
+
+#ifndef __vtkCompositeStreamingPriorityQueue_h
+#define __vtkCompositeStreamingPriorityQueue_h
+
+#include "vtkPVClientServerCoreRenderingModule.h" // for export macros
+#include "vtkObject.h"
+
+class vtkCompositeDataSet;
+class vtkMultiProcessController;
+
+class VTKPVCLIENTSERVERCORERENDERING_EXPORT vtkCompositeStreamingPriorityQueue : public vtkObject
+{
+public:
+  static vtkCompositeStreamingPriorityQueue* New();
+  vtkTypeMacro(vtkCompositeStreamingPriorityQueue, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // If the controller is specified, the queue can be used in parallel. So long
+  // as Initialize(), Update() and Pop() methods are called on all processes
+  // (need not be synchronized) and all process get the same meta-data and
+  // view_planes (which is generally true with ParaView), the blocks are
+  // distributed among the processes.
+  // By default, this is set to the
+  // vtkMultiProcessController::GetGlobalController();
+  void SetController(vtkMultiProcessController*);
+  vtkGetObjectMacro(Controller, vtkMultiProcessController);
+
+  // Description:
+  // Returns true if every leaf in the meta-data provides
+  // vtkStreamingDemandDrivenPipeline::BOUNDS(). Blocks without bounds cannot be
+  // prioritized, hence such meta-data should not be used for streaming.
+  static bool HasBlockBounds(vtkCompositeDataSet* metadata);
+
+  // Description:
+  // Initializes the queue. All information about items in the is lost. Only
+  // the meta-data is looked at i.e. none of the heavy data is needed.
+  void Initialize(vtkCompositeDataSet* metadata);
+
+  // Description:
+  // Re-initializes the priority queue using the meta-data given to the most
+  // recent call to Initialize().
+  void Reinitialize();
+
+  // Description:
+  // Updates the priorities of blocks based on the new view frustum planes.
+  // Information about blocks "popped" from the queue is preserved and those
+  // blocks are not reinserted in the queue.
+  void Update(const double view_planes[24], const double clamp_bounds[6]);
+  void Update(const double view_planes[24]);
+
+  // Description:
+  // Returns if the queue is empty.
+  bool IsEmpty();
+
+  // Description:
+  // Pops and returns the composite id (flat index) for the block at the top
+  // of the queue for this process. Returns 0 (which is the index of the root,
+  // never of a leaf) when the queue ran out of blocks before this process got
+  // one. Test if the queue is empty before calling this method.
+  unsigned int Pop();
+
+//BTX
+protected:
+  vtkCompositeStreamingPriorityQueue();
+  ~vtkCompositeStreamingPriorityQueue();
+
+  vtkMultiProcessController* Controller;
+
+private:
+  vtkCompositeStreamingPriorityQueue(const vtkCompositeStreamingPriorityQueue&); // Not implemented
+  void operator=(const vtkCompositeStreamingPriorityQueue&); // Not implemented
+
+  class vtkInternals;
+  vtkInternals* Internals;
+//ETX
+};
+
+#endif
@@ -20,10 +20,13 @@
 # include "vtkShadowMapBakerPass.h"
 #endif
 #include "vtkAlgorithmOutput.h"
+#include "vtkAppendPolyData.h"
 #include "vtkBoundingBox.h"
 #include "vtkCommand.h"
 #include "vtkCompositeDataDisplayAttributes.h"
 #include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataPipeline.h"
+#include "vtkCompositeStreamingPriorityQueue.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
@@ -33,11 +36,14 @@
 #include "vtkMultiProcessController.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
+#include "vtkPolyData.h"
 #include "vtkProperty.h"
 #include "vtkPVCacheKeeper.h"
 #include "vtkPVGeometryFilter.h"
 #include "vtkPVLODActor.h"
+#include "vtkPVLODPyramid.h"
 #include "vtkPVRenderView.h"
+#include "vtkPVStreamingMacros.h"
 #include "vtkPVTrivialProducer.h"
 #include "vtkPVUpdateSuppressor.h"
 #include "vtkQuadricClustering.h"
@@ -51,6 +57,8 @@
 
 #include <vtksys/SystemTools.hxx>
 
+#include <assert.h>
+
 //*****************************************************************************
 // This is used to convert a vtkPolyData to a vtkMultiBlockDataSet. If input is
 // vtkMultiBlockDataSet, then this is simply a pass-through filter. This makes
@@ -93,6 +101,38 @@ protected:
 vtkStandardNewMacro(vtkGeometryRepresentationMultiBlockMaker);
 
 //*****************************************************************************
+namespace
+{
+  // Returns a shallow copy of the data object so that it is not affected when
+  // the internal pipeline re-executes.
+  vtkSmartPointer<vtkDataObject> vtkCloneDataObject(vtkDataObject* data)
+    {
+    vtkSmartPointer<vtkDataObject> clone;
+    if (data)
+      {
+      clone.TakeReference(data->NewInstance());
+      clone->ShallowCopy(data);
+      }
+    return clone;
+    }
+
+  // Adds the bounds for all blocks in the streaming meta-data to bbox.
+  void vtkAddMetaDataBounds(vtkCompositeDataSet* metadata, vtkBoundingBox& bbox)
+    {
+    vtkCompositeDataIterator* iter = metadata->NewIterator();
+    iter->SkipEmptyNodesOff();
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+      {
+      if (iter->HasCurrentMetaData() && iter->GetCurrentMetaData()->Has(
+          vtkStreamingDemandDrivenPipeline::BOUNDS()))
+        {
+        bbox.AddBounds(iter->GetCurrentMetaData()->Get(
+            vtkStreamingDemandDrivenPipeline::BOUNDS()));
+        }
+      }
+    iter->Delete();
+    }
+}
 
 
 vtkStandardNewMacro(vtkGeometryRepresentation);
@@ -103,7 +143,9 @@ vtkGeometryRepresentation::vtkGeometryRepresentation()
   this->CacheKeeper = vtkPVCacheKeeper::New();
   this->MultiBlockMaker = vtkGeometryRepresentationMultiBlockMaker::New();
   this->Decimator = vtkQuadricClustering::New();
+  this->LODPyramid = vtkPVLODPyramid::New();
   this->LODOutlineFilter = vtkPVGeometryFilter::New();
+  this->PriorityQueue = vtkCompositeStreamingPriorityQueue::New();
 
   // setup the selection mapper so that we don't need to make any selection
   // conversions after rendering.
@@ -139,6 +181,8 @@ vtkGeometryRepresentation::vtkGeometryRepresentation()
   this->Representation = SURFACE;
 
   this->SuppressLOD = false;
+  this->StreamingCapablePipeline = false;
+  this->InStreamingUpdate = false;
   this->DebugString = 0;
   this->SetDebugString(this->GetClassName());
 
@@ -155,7 +199,9 @@ vtkGeometryRepresentation::~vtkGeometryRepresentation()
   this->GeometryFilter->Delete();
   this->MultiBlockMaker->Delete();
   this->Decimator->Delete();
+  this->LODPyramid->Delete();
   this->LODOutlineFilter->Delete();
+  this->PriorityQueue->Delete();
   this->Mapper->Delete();
   this->LODMapper->Delete();
   this->Actor->Delete();
@@ -257,8 +303,21 @@ int vtkGeometryRepresentation::ProcessViewRequest(
     // to provide a place-holder dataset of the right type. This is essential
     // since the vtkPVRenderView uses the type specified to decide on the
     // delivery mechanism, among other things.
-    vtkPVRenderView::SetPiece(inInfo, this,
-      this->CacheKeeper->GetOutputDataObject(0));
+    // When streaming, the cache-keeper's output is replaced by every streamed
+    // piece, hence we provide the data generated before streaming started.
+    if (this->GetStreamingCapablePipeline())
+      {
+      vtkPVRenderView::SetPiece(inInfo, this, this->ProcessedData);
+      }
+    else
+      {
+      vtkPVRenderView::SetPiece(inInfo, this,
+        this->CacheKeeper->GetOutputDataObject(0));
+      }
+
+    // Let the view know if this representation is streaming capable (or not).
+    vtkPVRenderView::SetStreamable(inInfo, this,
+      this->GetStreamingCapablePipeline());
 
     // Since we are rendering polydata, it can be redistributed when ordered
     // compositing is needed. So let the view know that it can feel free to
@@ -303,11 +362,23 @@ int vtkGeometryRepresentation::ProcessViewRequest(
         vtkPVRenderView::SetPieceLOD(inInfo, this,
           this->LODOutlineFilter->GetOutputDataObject(0));
         }
+      else if (inInfo->Has(vtkPVRenderView::LOD_PYRAMID_LEVEL()) &&
+        this->UpdateLODPyramid(inInfo->Get(vtkPVRenderView::LOD_RESOLUTION())))
+        {
+        // The view picked a level of the precomputed pyramid; no decimation
+        // is needed unless the data or the resolution changed.
+        this->Decimator->Modified();
+        this->LODOutlineFilter->Modified();
+
+        vtkPVRenderView::SetPieceLOD(inInfo, this, this->LODPyramid->GetLevel(
+            inInfo->Get(vtkPVRenderView::LOD_PYRAMID_LEVEL())));
+        }
       else
         {
         // HACK to ensure that when Decimator is next employed, it delivers a
         // new geometry.
         this->LODOutlineFilter->Modified();
+        this->LODPyramid->Initialize();
 
         if (inInfo->Has(vtkPVRenderView::LOD_RESOLUTION()))
           {
@@ -329,20 +400,153 @@ int vtkGeometryRepresentation::ProcessViewRequest(
     {
     vtkAlgorithmOutput* producerPort = vtkPVRenderView::GetPieceProducer(inInfo, this);
     vtkAlgorithmOutput* producerPortLOD = vtkPVRenderView::GetPieceProducerLOD(inInfo, this);
-    this->Mapper->SetInputConnection(0, producerPort);
+    if (this->RenderedData)
+      {
+      this->Mapper->SetInputDataObject(0, this->RenderedData);
+      }
+    else
+      {
+      this->Mapper->SetInputConnection(0, producerPort);
+      }
     this->LODMapper->SetInputConnection(0, producerPortLOD);
 
     // This is called just before the vtk-level render. In this pass, we simply
-    // pick the correct rendering mode and rendering parameters.
-    bool lod = this->SuppressLOD? false :
+    // pick the correct rendering mode and rendering parameters. Once pieces
+    // have been streamed in, the LOD geometry no longer covers all the data
+    // being rendered, so we don't use it.
+    bool lod = (this->SuppressLOD || this->RenderedData)? false :
       (inInfo->Has(vtkPVRenderView::USE_LOD()) == 1);
     this->Actor->SetEnableLOD(lod? 1 : 0);
     this->UpdateColoringParameters();
     }
+  else if (request_type == vtkPVRenderView::REQUEST_STREAMING_UPDATE())
+    {
+    if (this->GetStreamingCapablePipeline())
+      {
+      // This is a streaming update request, request next piece.
+      double view_planes[24];
+      inInfo->Get(vtkPVRenderView::VIEW_PLANES(), view_planes);
+      if (this->StreamingUpdate(view_planes))
+        {
+        // since we indeed "had" a next piece to produce, give it to the view
+        // so it can deliver it to the rendering nodes.
+        vtkPVRenderView::SetNextStreamedPiece(
+          inInfo, this, this->ProcessedPiece);
+        }
+      }
+    }
+  else if (request_type == vtkPVRenderView::REQUEST_PROCESS_STREAMED_PIECE())
+    {
+    vtkDataObject* piece = vtkPVRenderView::GetCurrentStreamedPiece(inInfo, this);
+    if (piece)
+      {
+      if (this->RenderedData == NULL)
+        {
+        vtkStreamingStatusMacro(<< this << ": cloning delivered data.");
+        vtkAlgorithmOutput* producerPort =
+          vtkPVRenderView::GetPieceProducer(inInfo, this);
+        vtkMultiBlockDataSet* delivered = vtkMultiBlockDataSet::SafeDownCast(
+          producerPort->GetProducer()->GetOutputDataObject(
+            producerPort->GetIndex()));
+        this->RenderedData = vtkSmartPointer<vtkMultiBlockDataSet>::New();
+        if (delivered)
+          {
+          this->RenderedData->ShallowCopy(delivered);
+          }
+        }
+      vtkStreamingStatusMacro( << this << ": received new piece.");
+      this->MergeStreamedPiece(piece);
+      this->Mapper->SetInputDataObject(0, this->RenderedData);
+      }
+    }
 
   return 1;
 }
 
+//----------------------------------------------------------------------------
+void vtkGeometryRepresentation::MergeStreamedPiece(vtkDataObject* piece)
+{
+  vtkMultiBlockDataSet* pieceMB = vtkMultiBlockDataSet::SafeDownCast(piece);
+  if (!pieceMB || !this->RenderedData)
+    {
+    return;
+    }
+  if (this->RenderedData->GetNumberOfBlocks() == 0)
+    {
+    // nothing was delivered before streaming started on this node.
+    this->RenderedData->CopyStructure(pieceMB);
+    }
+
+  // Streamed pieces have the same structure as the full data, with only the
+  // blocks that were requested non-empty. Since different blocks are requested
+  // in every pass, we simply move them over. Blocks may still be non-empty in
+  // both, when the pieces from several processes end up on the same node, in
+  // which case they are appended.
+  vtkCompositeDataIterator* iter = pieceMB->NewIterator();
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+    {
+    vtkPolyData* block = vtkPolyData::SafeDownCast(iter->GetCurrentDataObject());
+    if (!block || block->GetNumberOfPoints() == 0)
+      {
+      continue;
+      }
+    vtkPolyData* current = vtkPolyData::SafeDownCast(
+      this->RenderedData->GetDataSet(iter));
+    if (current && current->GetNumberOfPoints() > 0)
+      {
+      vtkNew<vtkAppendPolyData> appender;
+      appender->AddInputData(current);
+      appender->AddInputData(block);
+      appender->Update();
+      this->RenderedData->SetDataSet(iter, appender->GetOutputDataObject(0));
+      }
+    else
+      {
+      this->RenderedData->SetDataSet(iter, block);
+      }
+    }
+  iter->Delete();
+  this->RenderedData->Modified();
+}
+
+//----------------------------------------------------------------------------
+bool vtkGeometryRepresentation::UpdateLODPyramid(double resolution)
+{
+  this->CacheKeeper->Update();
+  if (this->LODPyramid->Build(this->CacheKeeper->GetOutputDataObject(0),
+      resolution, vtkPVRenderView::GetNumberOfLODPyramidLevels()))
+    {
+    vtkDebugMacro(<< "Built LOD pyramid with "
+      << this->LODPyramid->GetNumberOfLevels() << " levels.");
+    }
+  return this->LODPyramid->GetNumberOfLevels() > 0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkGeometryRepresentation::StreamingUpdate(const double view_planes[24])
+{
+  assert(this->InStreamingUpdate == false);
+  if (!this->PriorityQueue->IsEmpty())
+    {
+    this->InStreamingUpdate = true;
+    vtkStreamingStatusMacro(<< this << ": doing streaming-update.");
+
+    // update the priority queue, if needed.
+    this->PriorityQueue->Update(view_planes);
+
+    // This ensure that the representation re-executes.
+    this->MarkModified();
+
+    // Execute the pipeline.
+    this->Update();
+
+    this->InStreamingUpdate = false;
+    return true;
+    }
+
+  return false;
+}
+
 //----------------------------------------------------------------------------
 bool vtkGeometryRepresentation::DoRequestGhostCells(vtkInformation* info)
 {
@@ -370,6 +574,39 @@ bool vtkGeometryRepresentation::DoRequestGhostCells(vtkInformation* info)
   return false;
 }
 
+//----------------------------------------------------------------------------
+int vtkGeometryRepresentation::RequestInformation(vtkInformation* request,
+  vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  // Determine if the input is streaming capable. A pipeline is streaming
+  // capable if it provides us with COMPOSITE_DATA_META_DATA() in the
+  // RequestInformation() pass, with bounds for every block. It implies that we
+  // can request arbitrary blocks from the input pipeline and prioritize them
+  // based on the view.
+  if (!this->InStreamingUpdate)
+    {
+    this->StreamingCapablePipeline = false;
+    if (inputVector[0]->GetNumberOfInformationObjects() == 1 &&
+      vtkPVView::GetEnableStreaming())
+      {
+      vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+      vtkCompositeDataSet* metadata = vtkCompositeDataSet::SafeDownCast(
+        inInfo->Get(vtkCompositeDataPipeline::COMPOSITE_DATA_META_DATA()));
+      if (vtkCompositeStreamingPriorityQueue::HasBlockBounds(metadata))
+        {
+        this->StreamingCapablePipeline = true;
+        this->PriorityQueue->Initialize(metadata);
+        }
+      }
+
+    vtkStreamingStatusMacro(
+      << this << ": streaming capable input pipeline? "
+      << (this->StreamingCapablePipeline? "yes" : "no"));
+    }
+  return this->Superclass::RequestInformation(request, inputVector, outputVector);
+}
+
 //----------------------------------------------------------------------------
 int vtkGeometryRepresentation::RequestUpdateExtent(vtkInformation* request,
   vtkInformationVector** inputVector,
@@ -377,6 +614,14 @@ int vtkGeometryRepresentation::RequestUpdateExtent(vtkInformation* request,
 {
   this->Superclass::RequestUpdateExtent(request, inputVector, outputVector);
 
+  if (this->StreamingCapablePipeline && !this->InStreamingUpdate)
+    {
+    // The input is re-executing for non-streaming reasons, so start streaming
+    // over. The first block is requested right away instead of the whole
+    // dataset so that something can be shown quickly.
+    this->PriorityQueue->Reinitialize();
+    }
+
   // ensure that the ghost-level information is setup correctly to avoid
   // internal faces for unstructured grids.
   for (int cc=0; cc < this->GetNumberOfInputPorts(); cc++)
@@ -392,6 +637,23 @@ int vtkGeometryRepresentation::RequestUpdateExtent(vtkInformation* request,
         ghostLevels++;
         }
       vtkStreamingDemandDrivenPipeline::SetUpdateGhostLevel(inInfo, ghostLevels);
+
+      if (this->StreamingCapablePipeline)
+        {
+        // Request the next block for this process. When the queue has run out
+        // of blocks for this process, we request none at all.
+        int cid = this->PriorityQueue->IsEmpty()? 0 :
+          static_cast<int>(this->PriorityQueue->Pop());
+        vtkStreamingStatusMacro(<< this << ": requesting blocks: " << cid);
+        inInfo->Set(vtkCompositeDataPipeline::LOAD_REQUESTED_BLOCKS(), 1);
+        inInfo->Set(vtkCompositeDataPipeline::UPDATE_COMPOSITE_INDICES(),
+          &cid, cid > 0? 1 : 0);
+        }
+      else
+        {
+        inInfo->Remove(vtkCompositeDataPipeline::LOAD_REQUESTED_BLOCKS());
+        inInfo->Remove(vtkCompositeDataPipeline::UPDATE_COMPOSITE_INDICES());
+        }
       }
     }
 
@@ -404,10 +666,15 @@ int vtkGeometryRepresentation::RequestData(vtkInformation* request,
 {
   // cout << this << ":" << this->DebugString << ":RequestData" << endl;
 
-  vtkMath::UninitializeBounds(this->DataBounds);
+  if (!this->InStreamingUpdate)
+    {
+    vtkMath::UninitializeBounds(this->DataBounds);
+    }
 
-  // Pass caching information to the cache keeper.
-  this->CacheKeeper->SetCachingEnabled(this->GetUseCache());
+  // Pass caching information to the cache keeper. Streamed pieces are never
+  // cached.
+  this->CacheKeeper->SetCachingEnabled(
+    this->GetUseCache() && !this->StreamingCapablePipeline);
   this->CacheKeeper->SetCacheTime(this->GetCacheKey());
 
   if (inputVector[0]->GetNumberOfInformationObjects()==1)
@@ -436,9 +703,42 @@ int vtkGeometryRepresentation::RequestData(vtkInformation* request,
     }
   this->CacheKeeper->Update();
 
+  this->ProcessedPiece = 0;
+  if (this->InStreamingUpdate)
+    {
+    this->ProcessedPiece =
+      vtkCloneDataObject(this->CacheKeeper->GetOutputDataObject(0));
+    return this->Superclass::RequestData(request, inputVector, outputVector);
+    }
+
   // Determine data bounds.
   this->GetBounds(this->CacheKeeper->GetOutputDataObject(0),
     this->DataBounds);
+
+  this->ProcessedData = 0;
+  if (this->StreamingCapablePipeline)
+    {
+    this->ProcessedData =
+      vtkCloneDataObject(this->CacheKeeper->GetOutputDataObject(0));
+
+    // Only the first block has been read, hence use the meta-data to determine
+    // the bounds for the entire dataset.
+    vtkBoundingBox bbox;
+    if (vtkMath::AreBoundsInitialized(this->DataBounds))
+      {
+      bbox.AddBounds(this->DataBounds);
+      }
+    vtkAddMetaDataBounds(vtkCompositeDataSet::SafeDownCast(
+        inputVector[0]->GetInformationObject(0)->Get(
+          vtkCompositeDataPipeline::COMPOSITE_DATA_META_DATA())), bbox);
+    if (bbox.IsValid())
+      {
+      bbox.GetBounds(this->DataBounds);
+      }
+    }
+
+  // The input changed, so whatever was streamed so far is no longer valid.
+  this->RenderedData = 0;
   return this->Superclass::RequestData(request, inputVector, outputVector);
 }
 
@@ -487,6 +787,10 @@ vtkDataObject* vtkGeometryRepresentation::GetRenderedDataObject(int port)
   (void) port;
   if (this->GeometryFilter->GetNumberOfInputConnections(0) > 0)
     {
+    if (this->StreamingCapablePipeline)
+      {
+      return this->ProcessedData;
+      }
     return this->CacheKeeper->GetOutputDataObject(0);
     }
   return NULL;
@@ -681,6 +985,8 @@ void vtkGeometryRepresentation::SetVisibility(bool val)
 void vtkGeometryRepresentation::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "StreamingCapablePipeline: " << this->StreamingCapablePipeline
+    << endl;
 }
 
 //****************************************************************************
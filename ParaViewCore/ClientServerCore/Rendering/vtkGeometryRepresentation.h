@@ -28,12 +28,16 @@
 #include "vtkPVClientServerCoreRenderingModule.h" //needed for exports
 #include "vtkPVDataRepresentation.h"
 #include "vtkProperty.h" // needed for VTK_POINTS etc.
+#include "vtkSmartPointer.h" // needed for vtkSmartPointer.
 
 class vtkCompositePolyDataMapper2;
+class vtkCompositeStreamingPriorityQueue;
 class vtkMapper;
+class vtkMultiBlockDataSet;
 class vtkPVCacheKeeper;
 class vtkPVGeometryFilter;
 class vtkPVLODActor;
+class vtkPVLODPyramid;
 class vtkQuadricClustering;
 class vtkScalarsToColors;
 class vtkTexture;
@@ -231,8 +235,19 @@ protected:
   virtual int RequestData(vtkInformation*,
     vtkInformationVector**, vtkInformationVector*);
 
+  // Description:
+  // Overridden to check if the input pipeline is streaming capable i.e.
+  // streaming is enabled (vtkPVView::GetEnableStreaming()) and the input
+  // provides composite meta-data with bounds for every block. When not in
+  // StreamingUpdate, this also initializes the priority queue since the input
+  // may have totally changed, including its structure.
+  virtual int RequestInformation(vtkInformation* request,
+    vtkInformationVector** inputVector, vtkInformationVector* outputVector);
+
   // Description:
   // Overridden to request correct ghost-level to avoid internal surfaces.
+  // When the input pipeline is streaming capable, this also requests the
+  // blocks for this process in the order determined by the priority queue.
   virtual int RequestUpdateExtent(vtkInformation* request,
     vtkInformationVector** inputVector, vtkInformationVector* outputVector);
 
@@ -265,10 +280,41 @@ protected:
   // Overridden to check with the vtkPVCacheKeeper to see if the key is cached.
   virtual bool IsCached(double cache_key);
 
+  // Description:
+  // Returns true when the input pipeline supports streaming. It is set in
+  // RequestInformation(). Note that in client-server mode, this is valid only
+  // on the data-server nodes since all other nodes don't have input pipelines
+  // connected.
+  vtkGetMacro(StreamingCapablePipeline, bool);
+
+  // Description:
+  // Returns true when StreamingUpdate() is being processed.
+  vtkGetMacro(InStreamingUpdate, bool);
+
+  // Description:
+  // Returns true if this representation has a "next piece" that it streamed.
+  // This method will update the PriorityQueue using the view planes specified
+  // and then call Update() on the representation, making it reexecute and
+  // regenerate the geometry for the next blocks.
+  bool StreamingUpdate(const double view_planes[24]);
+
+  // Description:
+  // Called on the rendering nodes to add a streamed piece to RenderedData.
+  // Blocks are moved over from the piece, so the cost is proportional to the
+  // size of the piece rather than that of the data rendered so far.
+  void MergeStreamedPiece(vtkDataObject* piece);
+
+  // Description:
+  // Builds the LOD pyramid for the current data at the given resolution,
+  // unless it is up to date. Returns false if the pyramid cannot be used for
+  // the current data, in which case the Decimator is used instead.
+  bool UpdateLODPyramid(double resolution);
+
   vtkAlgorithm* GeometryFilter;
   vtkAlgorithm* MultiBlockMaker;
   vtkPVCacheKeeper* CacheKeeper;
   vtkQuadricClustering* Decimator;
+  vtkPVLODPyramid* LODPyramid;
   vtkPVGeometryFilter* LODOutlineFilter;
 
   vtkMapper* Mapper;
@@ -284,12 +330,33 @@ protected:
   bool RequestGhostCellsIfNeeded;
   double DataBounds[6];
 
+  // Description:
+  // Used to compute the order in which blocks are requested from a streaming
+  // capable input pipeline.
+  vtkCompositeStreamingPriorityQueue* PriorityQueue;
+
+  // Description:
+  // When streaming, this is the geometry generated by the most recent call to
+  // RequestData() while not streaming, and ProcessedPiece is the geometry
+  // generated by the most recent StreamingUpdate(). These are non-empty only on
+  // the data-server nodes.
+  vtkSmartPointer<vtkDataObject> ProcessedData;
+  vtkSmartPointer<vtkDataObject> ProcessedPiece;
+
+  // Description:
+  // Delivered data with all streamed pieces merged in. This is non-empty only
+  // on the rendering nodes after the first streamed piece was received.
+  vtkSmartPointer<vtkMultiBlockDataSet> RenderedData;
+
 private:
   vtkGeometryRepresentation(const vtkGeometryRepresentation&); // Not implemented
   void operator=(const vtkGeometryRepresentation&); // Not implemented
 
   friend class vtkSelectionRepresentation;
   char* DebugString;
+
+  bool StreamingCapablePipeline;
+  bool InStreamingUpdate;
   vtkSetStringMacro(DebugString);
 //ETX
 };
@@ -38,12 +38,13 @@
 #include "vtkPolyData.h"
 #include "vtkProcessModule.h"
 #include "vtkPVConfig.h"
+#include "vtkPVDataDeliveryCache.h"
+#include "vtkPVEventTraceLog.h"
 #include "vtkPVSession.h"
 #include "vtkSmartPointer.h"
 #include "vtkSocketCommunicator.h"
 #include "vtkSocketController.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
-#include "vtkTimerLog.h"
 #include "vtkToolkits.h"
 #include "vtkUndirectedGraph.h"
 #include "vtkUnstructuredGrid.h"
@@ -76,6 +77,7 @@ vtkStandardNewMacro(vtkMPIMoveData);
 vtkCxxSetObjectMacro(vtkMPIMoveData,Controller, vtkMultiProcessController);
 vtkCxxSetObjectMacro(vtkMPIMoveData,ClientDataServerSocketController, vtkMultiProcessController);
 vtkCxxSetObjectMacro(vtkMPIMoveData,MPIMToNSocketConnection, vtkMPIMToNSocketConnection);
+vtkCxxSetObjectMacro(vtkMPIMoveData,DeliveryCache, vtkPVDataDeliveryCache);
 //-----------------------------------------------------------------------------
 vtkMPIMoveData::vtkMPIMoveData()
 {
@@ -105,6 +107,7 @@ vtkMPIMoveData::vtkMPIMoveData()
   this->UpdatePiece = 0;
 
   this->SkipDataServerGatherToZero = false;
+  this->DeliveryCache = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -113,6 +116,7 @@ vtkMPIMoveData::~vtkMPIMoveData()
   this->SetController(0);
   this->SetClientDataServerSocketController(0);
   this->SetMPIMToNSocketConnection(0);
+  this->SetDeliveryCache(0);
   this->ClearBuffer();
 }
 
@@ -689,7 +693,7 @@ void vtkMPIMoveData::DataServerGatherToZero(vtkDataObject* input,
     return;
     }
 
-    vtkTimerLog::MarkStartEvent("Dataserver gathering to 0");
+    vtkPVEventTraceLog::MarkStartEvent("Dataserver gathering to 0");
 
 #ifdef PARAVIEW_USE_MPI
   int idx;
@@ -753,7 +757,7 @@ void vtkMPIMoveData::DataServerGatherToZero(vtkDataObject* input,
   inBuffer = NULL;
 #endif
 
-  vtkTimerLog::MarkEndEvent("Dataserver gathering to 0");
+  vtkPVEventTraceLog::MarkEndEvent("Dataserver gathering to 0");
 }
 
 //-----------------------------------------------------------------------------
@@ -888,9 +892,28 @@ void vtkMPIMoveData::DataServerSendToClient(vtkDataObject* output)
 
   if (myId == 0)
     {
-    vtkTimerLog::MarkStartEvent("Dataserver sending to client");
+    vtkPVEventTraceLog::MarkStartEvent("Dataserver sending to client");
     this->ClearBuffer();
     this->MarshalDataToBuffer(output);
+    if (this->DeliveryCache)
+      {
+      // send the key first, the client tells us if it needs the data.
+      std::string key = vtkPVDataDeliveryCache::ComputeKey(
+        this->Buffers, this->BufferTotalLength);
+      this->ClientDataServerSocketController->Send(
+        &this->BufferTotalLength, 1, 1, 23493);
+      this->ClientDataServerSocketController->Send(key.c_str(),
+        static_cast<vtkIdType>(key.size() + 1), 1, 23494);
+      int hit = 0;
+      this->ClientDataServerSocketController->Receive(&hit, 1, 1, 23495);
+      this->DeliveryCache->RecordDelivery(hit != 0, this->BufferTotalLength);
+      if (hit)
+        {
+        this->ClearBuffer();
+        vtkPVEventTraceLog::MarkEndEvent("Dataserver sending to client");
+        return;
+        }
+      }
     this->ClientDataServerSocketController->Send(
                                      &(this->NumberOfBuffers), 1, 1, 23490);
     this->ClientDataServerSocketController->Send(this->BufferLengths,
@@ -898,7 +921,7 @@ void vtkMPIMoveData::DataServerSendToClient(vtkDataObject* output)
     this->ClientDataServerSocketController->Send(this->Buffers,
                                      this->BufferTotalLength, 1, 23492);
     this->ClearBuffer();
-    vtkTimerLog::MarkEndEvent("Dataserver sending to client");
+    vtkPVEventTraceLog::MarkEndEvent("Dataserver sending to client");
     }
 }
 
@@ -914,6 +937,27 @@ void vtkMPIMoveData::ClientReceiveFromDataServer(vtkDataObject* output)
     }
 
   this->ClearBuffer();
+  std::string key;
+  if (this->DeliveryCache)
+    {
+    vtkIdType length = 0;
+    com->Receive(&length, 1, 1, 23493);
+    char digest[33];
+    com->Receive(digest, 33, 1, 23494);
+    digest[32] = 0;
+    key = digest;
+
+    vtkDataObject* cached = this->DeliveryCache->Find(key);
+    int hit = cached? 1 : 0;
+    com->Send(&hit, 1, 1, 23495);
+    this->DeliveryCache->RecordDelivery(hit != 0, length);
+    if (cached)
+      {
+      output->ShallowCopy(cached);
+      return;
+      }
+    }
+
   com->Receive(&(this->NumberOfBuffers), 1, 1, 23490);
   this->BufferLengths = new vtkIdType[this->NumberOfBuffers];
   com->Receive(this->BufferLengths, this->NumberOfBuffers,
@@ -931,6 +975,10 @@ void vtkMPIMoveData::ClientReceiveFromDataServer(vtkDataObject* output)
                                   1, 23492);
   this->ReconstructDataFromBuffer(output);
   this->ClearBuffer();
+  if (this->DeliveryCache)
+    {
+    this->DeliveryCache->Add(key, output);
+    }
 }
 
 
@@ -1060,7 +1108,7 @@ void vtkMPIMoveData::MarshalDataToBuffer(vtkDataObject* data)
 
   if (vtkMPIMoveData::UseZLibCompression)
     {
-    vtkTimerLog::MarkStartEvent("Zlib compress");
+    vtkPVEventTraceLog::MarkStartEvent("Zlib compress");
     // Use z-lib compression.
     uLongf out_size =compressBound(writer->GetOutputStringLength());
     buffer = new char[out_size + 8]; 
@@ -1070,7 +1118,7 @@ void vtkMPIMoveData::MarshalDataToBuffer(vtkDataObject* data)
       &out_size,
       reinterpret_cast<const Bytef*>(writer->GetOutputString()),
       writer->GetOutputStringLength(), /* compression_level */ Z_DEFAULT_COMPRESSION);
-    vtkTimerLog::MarkEndEvent("Zlib compress");
+    vtkPVEventTraceLog::MarkEndEvent("Zlib compress");
     int in_size = static_cast<int>(writer->GetOutputStringLength());
     for (int cc=0; cc < 4; cc++)
       {
@@ -1134,10 +1182,10 @@ void vtkMPIMoveData::ReconstructDataFromBuffer(vtkDataObject* data)
       // using zlib compression.
       realBuffer = new char[uncompressed_length];
       uLongf destLen = uncompressed_length;
-      vtkTimerLog::MarkStartEvent("Zlib uncompress");
+      vtkPVEventTraceLog::MarkStartEvent("Zlib uncompress");
       uncompress(reinterpret_cast<Bytef*>(realBuffer), &destLen,
         reinterpret_cast<const Bytef*>(bufferArray+8), compressed_length);
-      vtkTimerLog::MarkEndEvent("Zlib uncompress");
+      vtkPVEventTraceLog::MarkEndEvent("Zlib uncompress");
 
       bufferArray = realBuffer;
       bufferLength = uncompressed_length;
@@ -1201,6 +1249,7 @@ void vtkMPIMoveData::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "MoveMode: " << this->MoveMode << endl;
   os << indent << "SkipDataServerGatherToZero: " <<
     this->SkipDataServerGatherToZero << endl;
+  os << indent << "DeliveryCache: " << this->DeliveryCache << endl;
   os << indent << "OutputDataType: ";
   if (this->OutputDataType == VTK_POLY_DATA)
     {
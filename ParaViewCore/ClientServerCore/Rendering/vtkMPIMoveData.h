@@ -29,6 +29,7 @@
 class vtkMultiProcessController;
 class vtkSocketController;
 class vtkMPIMToNSocketConnection;
+class vtkPVDataDeliveryCache;
 class vtkDataSet;
 class vtkIndent;
 
@@ -110,6 +111,14 @@ public:
   vtkSetMacro(SkipDataServerGatherToZero, bool);
   vtkGetMacro(SkipDataServerGatherToZero, bool);
 
+  // Description:
+  // When set, data is sent from the data-server to the client only if the
+  // client doesn't have it in this cache yet (see vtkPVDataDeliveryCache).
+  // Since the client and the data-server exchange the key of the data first,
+  // the cache must be set on both or on neither.
+  void SetDeliveryCache(vtkPVDataDeliveryCache*);
+  vtkGetObjectMacro(DeliveryCache, vtkPVDataDeliveryCache);
+
 //BTX
   enum MoveModes {
     PASS_THROUGH=0,
@@ -161,6 +170,8 @@ protected:
   int Server;
 
   bool SkipDataServerGatherToZero;
+
+  vtkPVDataDeliveryCache* DeliveryCache;
 //BTX
   enum Servers {
     CLIENT=0,
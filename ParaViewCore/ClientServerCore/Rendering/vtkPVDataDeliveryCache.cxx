@@ -0,0 +1,192 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVDataDeliveryCache.h"
+
+#include "vtkDataObject.h"
+#include "vtkObjectFactory.h"
+#include "vtkSmartPointer.h"
+
+#include <vtksys/MD5.h>
+
+#include <algorithm>
+#include <list>
+#include <map>
+
+class vtkPVDataDeliveryCache::vtkInternals
+{
+public:
+  struct vtkEntry
+    {
+    vtkSmartPointer<vtkDataObject> Data;
+    unsigned long Size;
+    std::list<std::string>::iterator Position;
+    };
+
+  typedef std::map<std::string, vtkEntry> EntriesType;
+  EntriesType Entries;
+
+  // Keys, most recently used first.
+  std::list<std::string> RecentlyUsed;
+};
+
+vtkStandardNewMacro(vtkPVDataDeliveryCache);
+//----------------------------------------------------------------------------
+vtkPVDataDeliveryCache::vtkPVDataDeliveryCache()
+  : MaximumSize(262144),
+  Size(0),
+  NumberOfHits(0),
+  NumberOfMisses(0),
+  BytesAvoided(0),
+  BytesDelivered(0),
+  Internals(new vtkInternals())
+{
+}
+
+//----------------------------------------------------------------------------
+vtkPVDataDeliveryCache::~vtkPVDataDeliveryCache()
+{
+  delete this->Internals;
+  this->Internals = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDataDeliveryCache::SetMaximumSize(unsigned long size)
+{
+  if (this->MaximumSize != size)
+    {
+    this->MaximumSize = size;
+    this->Shrink();
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDataDeliveryCache::Clear()
+{
+  this->Internals->Entries.clear();
+  this->Internals->RecentlyUsed.clear();
+  this->Size = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDataDeliveryCache::ResetCounters()
+{
+  this->NumberOfHits = 0;
+  this->NumberOfMisses = 0;
+  this->BytesAvoided = 0;
+  this->BytesDelivered = 0;
+}
+
+//----------------------------------------------------------------------------
+std::string vtkPVDataDeliveryCache::ComputeKey(
+  const char* buffer, vtkIdType length)
+{
+  vtksysMD5* md5 = vtksysMD5_New();
+  vtksysMD5_Initialize(md5);
+  // vtksysMD5_Append() takes an int length.
+  const vtkIdType blockSize = 1 << 30;
+  for (vtkIdType offset = 0; offset < length; offset += blockSize)
+    {
+    vtkIdType count = std::min(blockSize, length - offset);
+    vtksysMD5_Append(md5,
+      reinterpret_cast<const unsigned char*>(buffer + offset),
+      static_cast<int>(count));
+    }
+  char digest[32];
+  vtksysMD5_FinalizeHex(md5, digest);
+  vtksysMD5_Delete(md5);
+  return std::string(digest, 32);
+}
+
+//----------------------------------------------------------------------------
+vtkDataObject* vtkPVDataDeliveryCache::Find(const std::string& key)
+{
+  vtkInternals::EntriesType::iterator iter =
+    this->Internals->Entries.find(key);
+  if (iter == this->Internals->Entries.end())
+    {
+    return NULL;
+    }
+
+  // move the key to the front of the recently used list.
+  this->Internals->RecentlyUsed.splice(this->Internals->RecentlyUsed.begin(),
+    this->Internals->RecentlyUsed, iter->second.Position);
+  return iter->second.Data;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDataDeliveryCache::Add(const std::string& key, vtkDataObject* data)
+{
+  if (data == NULL || this->Find(key) != NULL)
+    {
+    return;
+    }
+
+  unsigned long size = data->GetActualMemorySize();
+  if (size > this->MaximumSize)
+    {
+    return;
+    }
+
+  vtkInternals::vtkEntry& entry = this->Internals->Entries[key];
+  entry.Data.TakeReference(data->NewInstance());
+  entry.Data->ShallowCopy(data);
+  entry.Size = size;
+  this->Internals->RecentlyUsed.push_front(key);
+  entry.Position = this->Internals->RecentlyUsed.begin();
+  this->Size += size;
+  this->Shrink();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDataDeliveryCache::Shrink()
+{
+  while (this->Size > this->MaximumSize &&
+    !this->Internals->RecentlyUsed.empty())
+    {
+    vtkInternals::EntriesType::iterator iter =
+      this->Internals->Entries.find(this->Internals->RecentlyUsed.back());
+    this->Size -= iter->second.Size;
+    this->Internals->Entries.erase(iter);
+    this->Internals->RecentlyUsed.pop_back();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDataDeliveryCache::RecordDelivery(bool hit, vtkIdType length)
+{
+  if (hit)
+    {
+    this->NumberOfHits++;
+    this->BytesAvoided += length;
+    }
+  else
+    {
+    this->NumberOfMisses++;
+    this->BytesDelivered += length;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDataDeliveryCache::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "MaximumSize: " << this->MaximumSize << endl;
+  os << indent << "Size: " << this->Size << endl;
+  os << indent << "NumberOfHits: " << this->NumberOfHits << endl;
+  os << indent << "NumberOfMisses: " << this->NumberOfMisses << endl;
+  os << indent << "BytesAvoided: " << this->BytesAvoided << endl;
+  os << indent << "BytesDelivered: " << this->BytesDelivered << endl;
+}
@@ -0,0 +1,122 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVDataDeliveryCache - content-addressed cache for geometry
+// delivered to the client.
+// .SECTION Description
+// vtkPVDataDeliveryCache is used by vtkMPIMoveData to avoid sending geometry
+// the client already has. Before sending data to the client, the data-server
+// computes a key from the content of the marshalled data (its MD5 digest) and
+// sends the key alone. The client looks the key up in its cache and only if
+// it is missing is the data sent. Delivered data is added to the client's
+// cache and the least recently used data is discarded when the cache grows
+// beyond MaximumSize.
+//
+// Thus geometry that is delivered again without having changed, e.g. after
+// toggling the visibility of a representation, switching between
+// representation types, or undo/redo, is not transferred again.
+//
+// vtkPVDataDeliveryManager has one such cache for each view. Both the client
+// and the data-server keep counters of the deliveries that were avoided.
+// .SECTION See Also
+// vtkPVDataDeliveryManager, vtkMPIMoveData
+
+#ifndef __vtkPVDataDeliveryCache_h
+#define __vtkPVDataDeliveryCache_h
+
+#include "vtkPVClientServerCoreRenderingModule.h" // for export macros
+#include "vtkObject.h"
+//BTX
+#include <string> // for std::string
+//ETX
+
+class vtkDataObject;
+
+class VTKPVCLIENTSERVERCORERENDERING_EXPORT vtkPVDataDeliveryCache : public vtkObject
+{
+public:
+  static vtkPVDataDeliveryCache* New();
+  vtkTypeMacro(vtkPVDataDeliveryCache, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Maximum size of the data kept in the cache, in kibibytes. Default is
+  // 262144 i.e. 256 MiB. Set to 0 to disable caching.
+  void SetMaximumSize(unsigned long size);
+  vtkGetMacro(MaximumSize, unsigned long);
+
+  // Description:
+  // Returns the size of the data currently in the cache, in kibibytes.
+  vtkGetMacro(Size, unsigned long);
+
+  // Description:
+  // Removes all the data from the cache.
+  void Clear();
+
+  // Description:
+  // Counters for the deliveries since the last call to ResetCounters().
+  // NumberOfHits is the number of deliveries skipped since the data was in
+  // the cache, and BytesAvoided the number of bytes they would have
+  // transferred. NumberOfMisses and BytesDelivered are the same for
+  // deliveries that happened.
+  vtkGetMacro(NumberOfHits, vtkIdType);
+  vtkGetMacro(NumberOfMisses, vtkIdType);
+  vtkGetMacro(BytesAvoided, vtkIdType);
+  vtkGetMacro(BytesDelivered, vtkIdType);
+  void ResetCounters();
+
+//BTX
+  // Description:
+  // Returns the key for marshalled data i.e. the hexadecimal MD5 digest of
+  // the buffer.
+  static std::string ComputeKey(const char* buffer, vtkIdType length);
+
+  // Description:
+  // Returns the data cached for the key, or NULL.
+  vtkDataObject* Find(const std::string& key);
+
+  // Description:
+  // Adds a shallow copy of the data to the cache.
+  void Add(const std::string& key, vtkDataObject* data);
+
+  // Description:
+  // Updates the counters for a delivery of `length` bytes that was avoided
+  // (hit) or not.
+  void RecordDelivery(bool hit, vtkIdType length);
+
+protected:
+  vtkPVDataDeliveryCache();
+  ~vtkPVDataDeliveryCache();
+
+  // Discards the least recently used data until the cache fits in
+  // MaximumSize.
+  void Shrink();
+
+  unsigned long MaximumSize;
+  unsigned long Size;
+  vtkIdType NumberOfHits;
+  vtkIdType NumberOfMisses;
+  vtkIdType BytesAvoided;
+  vtkIdType BytesDelivered;
+
+private:
+  vtkPVDataDeliveryCache(const vtkPVDataDeliveryCache&); // Not implemented
+  void operator=(const vtkPVDataDeliveryCache&); // Not implemented
+
+  class vtkInternals;
+  vtkInternals* Internals;
+//ETX
+};
+
+#endif
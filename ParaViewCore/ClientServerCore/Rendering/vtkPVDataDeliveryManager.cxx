@@ -24,13 +24,14 @@
 #include "vtkObjectFactory.h"
 #include "vtkOrderedCompositeDistributor.h"
 #include "vtkPKdTree.h"
+#include "vtkPVDataDeliveryCache.h"
 #include "vtkPVDataRepresentation.h"
+#include "vtkPVEventTraceLog.h"
 #include "vtkPVRenderView.h"
 #include "vtkPVStreamingMacros.h"
 #include "vtkPVTrivialProducer.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
-#include "vtkTimerLog.h"
 #include "vtkWeakPointer.h"
 
 #include <assert.h>
@@ -230,7 +231,9 @@ public:
 vtkStandardNewMacro(vtkPVDataDeliveryManager);
 //----------------------------------------------------------------------------
 vtkPVDataDeliveryManager::vtkPVDataDeliveryManager()
-  : Internals(new vtkInternals())
+  : KdTreeManager(vtkSmartPointer<vtkKdTreeManager>::New()),
+  DeliveryCache(vtkSmartPointer<vtkPVDataDeliveryCache>::New()),
+  Internals(new vtkInternals())
 {
 }
 
@@ -253,6 +256,12 @@ vtkPVRenderView* vtkPVDataDeliveryManager::GetRenderView()
   return this->RenderView;
 }
 
+//----------------------------------------------------------------------------
+vtkPVDataDeliveryCache* vtkPVDataDeliveryManager::GetDeliveryCache()
+{
+  return this->DeliveryCache;
+}
+
 //----------------------------------------------------------------------------
 unsigned long vtkPVDataDeliveryManager::GetVisibleDataSize(bool low_res)
 {
@@ -487,7 +496,7 @@ void vtkPVDataDeliveryManager::Deliver(int use_lod, unsigned int size, unsigned
   // This method will be implemented in "view-specific" subclasses since how the
   // data is delivered is very view specific.
 
-  vtkTimerLog::MarkStartEvent(use_lod?
+  vtkPVEventTraceLog::MarkStartEvent(use_lod?
     "LowRes Data Migration" : "FullRes Data Migration");
 
   bool using_remote_rendering =
@@ -533,6 +542,8 @@ void vtkPVDataDeliveryManager::Deliver(int use_lod, unsigned int size, unsigned
       dataMover->SetSkipDataServerGatherToZero(
         item->GatherBeforeDeliveringToClient == false);
       }
+    // geometry the client already has isn't sent again.
+    dataMover->SetDeliveryCache(this->DeliveryCache);
     dataMover->SetInputData(data);
 
     if (dataMover->GetOutputGeneratedOnProcess())
@@ -547,7 +558,7 @@ void vtkPVDataDeliveryManager::Deliver(int use_lod, unsigned int size, unsigned
       }
     }
 
-  vtkTimerLog::MarkEndEvent(use_lod?
+  vtkPVEventTraceLog::MarkEndEvent(use_lod?
     "LowRes Data Migration" : "FullRes Data Migration");
 }
 
@@ -557,11 +568,16 @@ void vtkPVDataDeliveryManager::RedistributeDataForOrderedCompositing(
 {
   if (this->RenderView->GetUpdateTimeStamp() > this->RedistributionTimeStamp)
     {
-    vtkTimerLog::MarkStartEvent("Regenerate Kd-Tree");
-    // need to re-generate the kd-tree.
+    vtkPVEventTraceLog::MarkStartEvent("Regenerate Kd-Tree");
+    // need to re-generate the kd-tree. The kd-tree manager keeps the
+    // previous kd-tree (with its cuts and MTime) as long as it suits the
+    // data, in which case only the representations whose data changed are
+    // redistributed below.
     this->RedistributionTimeStamp.Modified();
 
-    vtkNew<vtkKdTreeManager> cutsGenerator;
+    vtkKdTreeManager* cutsGenerator = this->KdTreeManager;
+    cutsGenerator->RemoveAllDataObjects();
+    bool has_structured_data_information = false;
     vtkInternals::ItemsMapType::iterator iter;
     for (iter = this->Internals->ItemsMap.begin();
       iter != this->Internals->ItemsMap.end(); ++iter)
@@ -578,6 +594,7 @@ void vtkPVDataDeliveryManager::RedistributeDataForOrderedCompositing(
             item.OrderedCompositingInfo;
           cutsGenerator->SetStructuredDataInformation(info.Translator,
             info.WholeExtent, info.Origin, info.Spacing);
+          has_structured_data_information = true;
           }
         else if (item.Redistributable)
           {
@@ -585,10 +602,14 @@ void vtkPVDataDeliveryManager::RedistributeDataForOrderedCompositing(
           }
         }
       }
+    if (!has_structured_data_information)
+      {
+      cutsGenerator->RemoveStructuredDataInformation();
+      }
     cutsGenerator->GenerateKdTree();
     this->KdTree = cutsGenerator->GetKdTree();
 
-    vtkTimerLog::MarkEndEvent("Regenerate Kd-Tree");
+    vtkPVEventTraceLog::MarkEndEvent("Regenerate Kd-Tree");
     }
 
   if (this->KdTree == NULL)
@@ -596,7 +617,7 @@ void vtkPVDataDeliveryManager::RedistributeDataForOrderedCompositing(
     return;
     }
 
-  vtkTimerLog::MarkStartEvent("Redistributing Data for Ordered Compositing");
+  vtkPVEventTraceLog::MarkStartEvent("Redistributing Data for Ordered Compositing");
   vtkInternals::ItemsMapType::iterator iter;
   for (iter = this->Internals->ItemsMap.begin();
     iter != this->Internals->ItemsMap.end(); ++iter)
@@ -639,7 +660,7 @@ void vtkPVDataDeliveryManager::RedistributeDataForOrderedCompositing(
     redistributor->Update();
     item.SetRedistributedDataObject(redistributor->GetOutputDataObject(0));
     }
-  vtkTimerLog::MarkEndEvent("Redistributing Data for Ordered Compositing");
+  vtkPVEventTraceLog::MarkEndEvent("Redistributing Data for Ordered Compositing");
 }
 
 //----------------------------------------------------------------------------
@@ -757,6 +778,8 @@ void vtkPVDataDeliveryManager::DeliverStreamedPieces(
 void vtkPVDataDeliveryManager::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "DeliveryCache: " << endl;
+  this->DeliveryCache->PrintSelf(os, indent.GetNextIndent());
 }
 
 //----------------------------------------------------------------------------
@@ -32,7 +32,9 @@
 class vtkAlgorithmOutput;
 class vtkDataObject;
 class vtkExtentTranslator;
+class vtkKdTreeManager;
 class vtkPKdTree;
+class vtkPVDataDeliveryCache;
 class vtkPVDataRepresentation;
 class vtkPVRenderView;
 
@@ -150,8 +152,17 @@ public:
 
   // Description:
   // Triggers delivery for the geometries of indicated representations.
+  // Geometry delivered to the client is looked up in the DeliveryCache
+  // first, so geometry the client already received is not sent again even
+  // when NeedsDelivery() reports it as modified.
   void Deliver(int use_low_res, unsigned int size, unsigned int *keys);
 
+  // Description:
+  // Provides access to the content-addressed cache used by Deliver(), e.g.
+  // to change its size or to get the number of bytes whose delivery was
+  // avoided.
+  vtkPVDataDeliveryCache* GetDeliveryCache();
+
   // *******************************************************************
   // UNDER CONSTRUCTION STREAMING API
   // *******************************************************************
@@ -191,6 +202,8 @@ protected:
 
   vtkWeakPointer<vtkPVRenderView> RenderView;
   vtkSmartPointer<vtkPKdTree> KdTree;
+  vtkSmartPointer<vtkKdTreeManager> KdTreeManager;
+  vtkSmartPointer<vtkPVDataDeliveryCache> DeliveryCache;
 
   vtkTimeStamp RedistributionTimeStamp;
 private:
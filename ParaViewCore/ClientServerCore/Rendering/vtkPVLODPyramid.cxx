@@ -0,0 +1,495 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVLODPyramid.h"
+
+#include "vtkBoundingBox.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSMPTools.h"
+#include "vtkWeakPointer.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+class vtkPVLODPyramid::vtkInternals
+{
+public:
+  std::vector<vtkSmartPointer<vtkDataObject> > Levels;
+  vtkWeakPointer<vtkDataObject> Input;
+  unsigned long InputMTime;
+  double Resolution;
+
+  vtkInternals() : InputMTime(0), Resolution(-1) {}
+};
+
+namespace
+{
+  // A vertex, line segment or triangle of the decimated output. Key holds the
+  // (clustered) point ids sorted so that duplicates can be detected, Ids the
+  // point ids in the original order to preserve orientation.
+  struct vtkClusteredCell
+    {
+    vtkIdType Ids[3];
+    vtkIdType Key[3];
+    vtkIdType SourceId;
+
+    bool operator<(const vtkClusteredCell& other) const
+      {
+      for (int cc=0; cc < 3; cc++)
+        {
+        if (this->Key[cc] != other.Key[cc])
+          {
+          return this->Key[cc] < other.Key[cc];
+          }
+        }
+      return this->SourceId < other.SourceId;
+      }
+
+    bool HasSameKey(const vtkClusteredCell& other) const
+      {
+      return this->Key[0] == other.Key[0] && this->Key[1] == other.Key[1] &&
+        this->Key[2] == other.Key[2];
+      }
+    };
+
+  typedef std::vector<vtkClusteredCell> vtkClusteredCells;
+
+  // Adds a cell with the given (input) point ids unless it collapses once the
+  // points are replaced by their clusters.
+  void vtkAddClusteredCell(vtkClusteredCells& cells,
+    const std::vector<vtkIdType>& pointMap, const vtkIdType* ids, int npts,
+    vtkIdType sourceId)
+    {
+    vtkClusteredCell cell;
+    cell.SourceId = sourceId;
+    cell.Ids[1] = cell.Ids[2] = -1;
+    for (int cc=0; cc < npts; cc++)
+      {
+      cell.Ids[cc] = pointMap[ids[cc]];
+      }
+    std::copy(cell.Ids, cell.Ids + 3, cell.Key);
+    std::sort(cell.Key, cell.Key + npts);
+    for (int cc=1; cc < npts; cc++)
+      {
+      if (cell.Key[cc] == cell.Key[cc-1])
+        {
+        return;
+        }
+      }
+    cells.push_back(cell);
+    }
+
+  // Sorts the cells and removes duplicates, keeping the ones that come first
+  // in the input.
+  void vtkRemoveDuplicateCells(vtkClusteredCells& cells)
+    {
+    std::sort(cells.begin(), cells.end());
+    size_t count = 0;
+    for (size_t cc=0; cc < cells.size(); cc++)
+      {
+      if (count == 0 || !cells[cc].HasSameKey(cells[count-1]))
+        {
+        cells[count++] = cells[cc];
+        }
+      }
+    cells.resize(count);
+    }
+
+  // Decimates the polydata by clustering its points in a grid with the given
+  // number of divisions spanning the given bounds. Only uses thread safe
+  // (read-only) API on the input.
+  vtkPolyData* vtkClusterPolyData(vtkPolyData* input, const double bounds[6],
+    int divisions)
+    {
+    vtkPolyData* output = vtkPolyData::New();
+    vtkPoints* inPts = input->GetPoints();
+    vtkIdType numPts = input->GetNumberOfPoints();
+    if (inPts == NULL || numPts == 0)
+      {
+      return output;
+      }
+
+    int dims[3];
+    double spacing[3];
+    for (int cc=0; cc < 3; cc++)
+      {
+      double length = bounds[2*cc+1] - bounds[2*cc];
+      dims[cc] = length > 0? divisions : 1;
+      spacing[cc] = length > 0? length / divisions : 1.0;
+      }
+
+    // Sort the points by the bin they fall into.
+    std::vector<std::pair<vtkIdType, vtkIdType> > order(numPts);
+    double x[3];
+    for (vtkIdType cc=0; cc < numPts; cc++)
+      {
+      inPts->GetPoint(cc, x);
+      vtkIdType bin = 0;
+      for (int axis=2; axis >= 0; axis--)
+        {
+        int index = static_cast<int>((x[axis] - bounds[2*axis]) / spacing[axis]);
+        index = std::max(0, std::min(dims[axis] - 1, index));
+        bin = bin * dims[axis] + index;
+        }
+      order[cc] = std::make_pair(bin, cc);
+      }
+    std::sort(order.begin(), order.end());
+
+    // Each run of points in the same bin is a cluster, represented by the
+    // point closest to the centroid of the run.
+    std::vector<vtkIdType> pointMap(numPts);
+    std::vector<vtkIdType> representatives;
+    for (vtkIdType begin=0, end=0; begin < numPts; begin = end)
+      {
+      double centroid[3] = { 0, 0, 0 };
+      for (end = begin; end < numPts && order[end].first == order[begin].first; end++)
+        {
+        inPts->GetPoint(order[end].second, x);
+        centroid[0] += x[0]; centroid[1] += x[1]; centroid[2] += x[2];
+        }
+      centroid[0] /= (end - begin);
+      centroid[1] /= (end - begin);
+      centroid[2] /= (end - begin);
+
+      vtkIdType best = order[begin].second;
+      double bestDistance = VTK_DOUBLE_MAX;
+      for (vtkIdType cc=begin; cc < end; cc++)
+        {
+        inPts->GetPoint(order[cc].second, x);
+        double distance = vtkMath::Distance2BetweenPoints(x, centroid);
+        if (distance < bestDistance)
+          {
+          best = order[cc].second;
+          bestDistance = distance;
+          }
+        pointMap[order[cc].second] = static_cast<vtkIdType>(representatives.size());
+        }
+      representatives.push_back(best);
+      }
+
+    // Replace the points of the cells, splitting lines in segments and
+    // polygons and strips in triangles as vtkQuadricClustering does.
+    // Cells are accessed through the raw connectivity since traversal of
+    // vtkCellArray is not thread safe.
+    vtkClusteredCells verts, lines, polys;
+    vtkCellArray* arrays[4] = { input->GetVerts(), input->GetLines(),
+      input->GetPolys(), input->GetStrips() };
+    vtkIdType cellId = 0;
+    for (int type=0; type < 4; type++)
+      {
+      vtkIdType numCells = arrays[type]? arrays[type]->GetNumberOfCells() : 0;
+      const vtkIdType* connectivity = numCells > 0? arrays[type]->GetPointer() : NULL;
+      for (vtkIdType cc=0; cc < numCells; cc++, cellId++)
+        {
+        int npts = static_cast<int>(*connectivity);
+        const vtkIdType* ids = connectivity + 1;
+        connectivity += npts + 1;
+        switch (type)
+          {
+        case 0:
+          for (int kk=0; kk < npts; kk++)
+            {
+            vtkAddClusteredCell(verts, pointMap, ids + kk, 1, cellId);
+            }
+          break;
+
+        case 1:
+          for (int kk=0; kk + 1 < npts; kk++)
+            {
+            vtkAddClusteredCell(lines, pointMap, ids + kk, 2, cellId);
+            }
+          break;
+
+        case 2:
+          for (int kk=1; kk + 1 < npts; kk++)
+            {
+            vtkIdType triangle[3] = { ids[0], ids[kk], ids[kk+1] };
+            vtkAddClusteredCell(polys, pointMap, triangle, 3, cellId);
+            }
+          break;
+
+        default:
+          for (int kk=0; kk + 2 < npts; kk++)
+            {
+            // every other triangle of a strip has flipped orientation.
+            vtkIdType triangle[3] = { ids[kk], ids[kk+1], ids[kk+2] };
+            if (kk % 2 == 1)
+              {
+              std::swap(triangle[0], triangle[1]);
+              }
+            vtkAddClusteredCell(polys, pointMap, triangle, 3, cellId);
+            }
+          break;
+          }
+        }
+      }
+    vtkRemoveDuplicateCells(verts);
+    vtkRemoveDuplicateCells(lines);
+    vtkRemoveDuplicateCells(polys);
+
+    // Only pass the clusters that are used by some cell.
+    vtkClusteredCells* cellSets[3] = { &verts, &lines, &polys };
+    std::vector<vtkIdType> outputIds(representatives.size(), -1);
+    vtkIdType numOutPts = 0;
+    for (int type=0; type < 3; type++)
+      {
+      const vtkClusteredCells& cells = *cellSets[type];
+      for (size_t cc=0; cc < cells.size(); cc++)
+        {
+        for (int kk=0; kk < 3 && cells[cc].Ids[kk] >= 0; kk++)
+          {
+          if (outputIds[cells[cc].Ids[kk]] < 0)
+            {
+            outputIds[cells[cc].Ids[kk]] = numOutPts++;
+            }
+          }
+        }
+      }
+
+    vtkNew<vtkPoints> outPts;
+    outPts->SetDataType(inPts->GetDataType());
+    outPts->SetNumberOfPoints(numOutPts);
+    vtkPointData* outPD = output->GetPointData();
+    outPD->CopyAllocate(input->GetPointData(), numOutPts);
+    for (size_t cc=0; cc < representatives.size(); cc++)
+      {
+      if (outputIds[cc] >= 0)
+        {
+        inPts->GetPoint(representatives[cc], x);
+        outPts->SetPoint(outputIds[cc], x);
+        outPD->CopyData(input->GetPointData(), representatives[cc], outputIds[cc]);
+        }
+      }
+    output->SetPoints(outPts.GetPointer());
+
+    vtkCellData* outCD = output->GetCellData();
+    outCD->CopyAllocate(input->GetCellData(),
+      static_cast<vtkIdType>(verts.size() + lines.size() + polys.size()));
+    vtkIdType outCellId = 0;
+    for (int type=0; type < 3; type++)
+      {
+      const vtkClusteredCells& cells = *cellSets[type];
+      if (cells.empty())
+        {
+        continue;
+        }
+      int npts = type + 1;
+      vtkNew<vtkCellArray> outCells;
+      outCells->Allocate(static_cast<vtkIdType>(cells.size() * (npts + 1)));
+      for (size_t cc=0; cc < cells.size(); cc++, outCellId++)
+        {
+        vtkIdType ids[3];
+        for (int kk=0; kk < npts; kk++)
+          {
+          ids[kk] = outputIds[cells[cc].Ids[kk]];
+          }
+        outCells->InsertNextCell(npts, ids);
+        outCD->CopyData(input->GetCellData(), cells[cc].SourceId, outCellId);
+        }
+      switch (type)
+        {
+      case 0: output->SetVerts(outCells.GetPointer()); break;
+      case 1: output->SetLines(outCells.GetPointer()); break;
+      default: output->SetPolys(outCells.GetPointer()); break;
+        }
+      }
+    output->Squeeze();
+    return output;
+    }
+
+  // Decimates every (level, leaf) pair of the pyramid.
+  class vtkClusterFunctor
+    {
+  public:
+    const std::vector<vtkPolyData*>& Leaves;
+    const double* Bounds;
+    double Resolution;
+    std::vector<vtkSmartPointer<vtkPolyData> >& Outputs;
+
+    vtkClusterFunctor(const std::vector<vtkPolyData*>& leaves,
+      const double bounds[6], double resolution,
+      std::vector<vtkSmartPointer<vtkPolyData> >& outputs)
+      : Leaves(leaves), Bounds(bounds), Resolution(resolution), Outputs(outputs)
+      {
+      }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      vtkIdType numLeaves = static_cast<vtkIdType>(this->Leaves.size());
+      for (vtkIdType cc=begin; cc < end; cc++)
+        {
+        int level = static_cast<int>(cc / numLeaves);
+        this->Outputs[cc].TakeReference(vtkClusterPolyData(
+            this->Leaves[cc % numLeaves], this->Bounds,
+            vtkPVLODPyramid::GetNumberOfDivisions(this->Resolution, level)));
+        }
+      }
+    };
+}
+
+vtkStandardNewMacro(vtkPVLODPyramid);
+//----------------------------------------------------------------------------
+vtkPVLODPyramid::vtkPVLODPyramid()
+{
+  this->Internals = new vtkInternals();
+}
+
+//----------------------------------------------------------------------------
+vtkPVLODPyramid::~vtkPVLODPyramid()
+{
+  delete this->Internals;
+  this->Internals = 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVLODPyramid::GetNumberOfDivisions(double resolution, int level)
+{
+  // Level 0 matches the divisions vtkGeometryRepresentation uses for its
+  // Decimator.
+  return static_cast<int>(150 * resolution / (1 << level)) + 10;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVLODPyramid::Initialize()
+{
+  delete this->Internals;
+  this->Internals = new vtkInternals();
+}
+
+//----------------------------------------------------------------------------
+int vtkPVLODPyramid::GetNumberOfLevels()
+{
+  return static_cast<int>(this->Internals->Levels.size());
+}
+
+//----------------------------------------------------------------------------
+vtkDataObject* vtkPVLODPyramid::GetLevel(int level)
+{
+  int numLevels = this->GetNumberOfLevels();
+  if (numLevels == 0)
+    {
+    return NULL;
+    }
+  level = std::max(0, std::min(numLevels - 1, level));
+  return this->Internals->Levels[level];
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVLODPyramid::Build(
+  vtkDataObject* input, double resolution, int numberOfLevels)
+{
+  numberOfLevels = std::max(1, numberOfLevels);
+  vtkInternals& internals = *this->Internals;
+  if (input != NULL && internals.Input == input &&
+    internals.InputMTime == input->GetMTime() &&
+    internals.Resolution == resolution &&
+    this->GetNumberOfLevels() == numberOfLevels)
+    {
+    return false;
+    }
+
+  this->Initialize();
+  this->Internals->Input = input;
+  this->Internals->InputMTime = input? input->GetMTime() : 0;
+  this->Internals->Resolution = resolution;
+
+  // Collect the polygonal leaves and their combined bounds. The bounds are
+  // computed here since vtkPolyData::GetBounds() is not thread safe.
+  std::vector<vtkPolyData*> leaves;
+  vtkCompositeDataSet* cd = vtkCompositeDataSet::SafeDownCast(input);
+  if (cd)
+    {
+    vtkCompositeDataIterator* iter = cd->NewIterator();
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+      {
+      if (vtkPolyData* pd = vtkPolyData::SafeDownCast(iter->GetCurrentDataObject()))
+        {
+        leaves.push_back(pd);
+        }
+      }
+    iter->Delete();
+    }
+  else if (vtkPolyData* pd = vtkPolyData::SafeDownCast(input))
+    {
+    leaves.push_back(pd);
+    }
+  if (leaves.empty())
+    {
+    return true;
+    }
+
+  vtkBoundingBox bbox;
+  for (size_t cc=0; cc < leaves.size(); cc++)
+    {
+    if (leaves[cc]->GetNumberOfPoints() > 0)
+      {
+      bbox.AddBounds(leaves[cc]->GetBounds());
+      }
+    }
+  double bounds[6] = { 0, 0, 0, 0, 0, 0 };
+  if (bbox.IsValid())
+    {
+    bbox.GetBounds(bounds);
+    }
+
+  vtkIdType numLeaves = static_cast<vtkIdType>(leaves.size());
+  std::vector<vtkSmartPointer<vtkPolyData> > outputs(numLeaves * numberOfLevels);
+  vtkClusterFunctor functor(leaves, bounds, resolution, outputs);
+  vtkSMPTools::For(0, numLeaves * numberOfLevels, 1, functor);
+
+  for (int level=0; level < numberOfLevels; level++)
+    {
+    if (!cd)
+      {
+      this->Internals->Levels.push_back(outputs[level]);
+      continue;
+      }
+
+    // Leaves that are not polygonal are left empty.
+    vtkSmartPointer<vtkCompositeDataSet> output;
+    output.TakeReference(cd->NewInstance());
+    output->CopyStructure(cd);
+    vtkIdType index = level * numLeaves;
+    vtkCompositeDataIterator* iter = cd->NewIterator();
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+      {
+      if (vtkPolyData::SafeDownCast(iter->GetCurrentDataObject()))
+        {
+        output->SetDataSet(iter, outputs[index++]);
+        }
+      }
+    iter->Delete();
+    this->Internals->Levels.push_back(output);
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVLODPyramid::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfLevels: " << this->GetNumberOfLevels() << endl;
+  os << indent << "Resolution: " << this->Internals->Resolution << endl;
+}
@@ -0,0 +1,90 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVLODPyramid - precomputed multiresolution LOD geometry.
+// .SECTION Description
+// vtkPVLODPyramid generates several decimated versions of polygonal data (or
+// of a composite dataset with polygonal leaves) at once, so that a
+// representation can switch between levels of detail without decimating
+// again. Level 0 is the finest level and is built with the same number of
+// divisions vtkGeometryRepresentation uses for quadric clustering at the given
+// LOD resolution; every subsequent level is built at half the resolution of
+// the previous one.
+//
+// Decimation uses vertex clustering: the points are sorted by the bin of a
+// regular grid spanning the bounds of the input that they fall into and every
+// bin is replaced by the input point closest to the centroid of its points
+// (as with vtkQuadricClustering::UseInputPoints). Cells that collapse are
+// discarded, as are duplicates. Point and cell data are passed through. All
+// the levels and leaves are decimated concurrently using vtkSMPTools.
+//
+// The pyramid is only rebuilt when the input or the resolution changes.
+// .SECTION See Also
+// vtkGeometryRepresentation, vtkPVRenderView::SetUseLODPyramid
+
+#ifndef __vtkPVLODPyramid_h
+#define __vtkPVLODPyramid_h
+
+#include "vtkPVClientServerCoreRenderingModule.h" // for export macros
+#include "vtkObject.h"
+
+class vtkDataObject;
+
+class VTKPVCLIENTSERVERCORERENDERING_EXPORT vtkPVLODPyramid : public vtkObject
+{
+public:
+  static vtkPVLODPyramid* New();
+  vtkTypeMacro(vtkPVLODPyramid, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Builds the pyramid for the data, unless it was already built for the same
+  // data (unmodified since) and resolution. The resolution has the same
+  // meaning as vtkPVRenderView::GetLODResolution(). Returns true if the
+  // pyramid was (re)built.
+  bool Build(vtkDataObject* input, double resolution, int numberOfLevels);
+
+  // Description:
+  // Returns the number of levels in the pyramid.
+  int GetNumberOfLevels();
+
+  // Description:
+  // Returns the decimated data for a level, clamped to the available levels.
+  // Returns NULL if the pyramid is empty.
+  vtkDataObject* GetLevel(int level);
+
+  // Description:
+  // Releases the pyramid.
+  void Initialize();
+
+  // Description:
+  // Returns the number of divisions along each axis used for a level of a
+  // pyramid at the given resolution.
+  static int GetNumberOfDivisions(double resolution, int level);
+
+//BTX
+protected:
+  vtkPVLODPyramid();
+  ~vtkPVLODPyramid();
+
+private:
+  vtkPVLODPyramid(const vtkPVLODPyramid&); // Not implemented
+  void operator=(const vtkPVLODPyramid&); // Not implemented
+
+  class vtkInternals;
+  vtkInternals* Internals;
+//ETX
+};
+
+#endif
@@ -50,6 +50,7 @@
 #include "vtkPVDataDeliveryManager.h"
 #include "vtkPVDataRepresentation.h"
 #include "vtkPVDisplayInformation.h"
+#include "vtkPVEventTraceLog.h"
 #include "vtkPVHardwareSelector.h"
 #include "vtkPVInteractorStyle.h"
 #include "vtkPVOptions.h"
@@ -85,6 +86,7 @@
 #include "vtkPistonMapper.h"
 #endif
 
+#include <algorithm>
 #include <assert.h>
 #include <vector>
 #include <set>
@@ -141,6 +143,7 @@ vtkStandardNewMacro(vtkPVRenderView);
 vtkInformationKeyMacro(vtkPVRenderView, USE_LOD, Integer);
 vtkInformationKeyMacro(vtkPVRenderView, USE_OUTLINE_FOR_LOD, Integer);
 vtkInformationKeyMacro(vtkPVRenderView, LOD_RESOLUTION, Double);
+vtkInformationKeyMacro(vtkPVRenderView, LOD_PYRAMID_LEVEL, Integer);
 vtkInformationKeyMacro(vtkPVRenderView, NEED_ORDERED_COMPOSITING, Integer);
 vtkInformationKeyMacro(vtkPVRenderView, RENDER_EMPTY_IMAGES, Integer);
 vtkInformationKeyMacro(vtkPVRenderView, REQUEST_STREAMING_UPDATE, Request);
@@ -180,6 +183,10 @@ vtkPVRenderView::vtkPVRenderView()
   this->LODRenderingThreshold = 0;
   this->LODResolution = 0.5;
   this->UseOutlineForLODRendering = false;
+  this->UseLODPyramid = false;
+  this->LODPyramidFrameRate = 10.0;
+  this->LODPyramidLevel = 0;
+  this->LODPyramidGeometrySize = -1;
   this->UseLightKit = false;
   this->Interactor = 0;
   this->InteractorStyle = 0;
@@ -1005,7 +1012,7 @@ void vtkPVRenderView::SynchronizeForCollaboration()
 //----------------------------------------------------------------------------
 void vtkPVRenderView::Update()
 {
-  vtkTimerLog::MarkStartEvent("RenderView::Update");
+  vtkPVEventTraceLog::MarkStartEvent("RenderView::Update");
 
   // reset the bounds, so that representations can provide us with bounds
   // information during update.
@@ -1052,6 +1059,14 @@ void vtkPVRenderView::Update()
 
   // Update decisions about lod-rendering and remote-rendering.
   this->UseLODForInteractiveRender = this->ShouldUseLODRendering(local_size);
+  if (this->UseLODForInteractiveRender && this->UseLODPyramid &&
+    local_size != this->LODPyramidGeometrySize)
+    {
+    // Only start over when the geometry changed, otherwise keep the level
+    // tuned by previous interactive renders.
+    this->LODPyramidGeometrySize = local_size;
+    this->SetLODPyramidLevel(this->GetInitialLODPyramidLevel(local_size));
+    }
   this->UseDistributedRenderingForStillRender =
     this->ShouldUseDistributedRendering(local_size, /*using_lod=*/false);
   if (!this->UseLODForInteractiveRender)
@@ -1078,7 +1093,7 @@ void vtkPVRenderView::Update()
   // Synchronize data bounds.
   this->SynchronizeGeometryBounds();
 
-  vtkTimerLog::MarkEndEvent("RenderView::Update");
+  vtkPVEventTraceLog::MarkEndEvent("RenderView::Update");
 
   this->UpdateTimeStamp.Modified();
 }
@@ -1098,7 +1113,7 @@ void vtkPVRenderView::CopyViewUpdateOptions(vtkPVRenderView* otherView)
 //----------------------------------------------------------------------------
 void vtkPVRenderView::UpdateLOD()
 {
-  vtkTimerLog::MarkStartEvent("RenderView::UpdateLOD");
+  vtkPVEventTraceLog::MarkStartEvent("RenderView::UpdateLOD");
 
   // Update LOD geometry.
 
@@ -1107,6 +1122,10 @@ void vtkPVRenderView::UpdateLOD()
     {
     this->RequestInformation->Set(USE_OUTLINE_FOR_LOD(), 1);
     }
+  if (this->UseLODPyramid)
+    {
+    this->RequestInformation->Set(LOD_PYRAMID_LEVEL(), this->LODPyramidLevel);
+    }
 
   // reset flags that representations set in REQUEST_UPDATE_LOD() pass.
   this->DistributedRenderingRequiredLOD = false;
@@ -1132,33 +1151,33 @@ void vtkPVRenderView::UpdateLOD()
     this->InteractiveRenderProcesses = vtkPVSession::CLIENT_AND_SERVERS;
     }
 
-  vtkTimerLog::MarkEndEvent("RenderView::UpdateLOD");
+  vtkPVEventTraceLog::MarkEndEvent("RenderView::UpdateLOD");
 }
 
 //----------------------------------------------------------------------------
 void vtkPVRenderView::StillRender()
 {
-  vtkTimerLog::MarkStartEvent("Still Render");
+  vtkPVEventTraceLog::MarkStartEvent("Still Render");
   this->GetRenderWindow()->SetDesiredUpdateRate(0.002);
 
   this->Internals->PreRender(this->RenderView);
 
   this->Render(false, false);
 
-  vtkTimerLog::MarkEndEvent("Still Render");
+  vtkPVEventTraceLog::MarkEndEvent("Still Render");
 }
 
 //----------------------------------------------------------------------------
 void vtkPVRenderView::InteractiveRender()
 {
-  vtkTimerLog::MarkStartEvent("Interactive Render");
+  vtkPVEventTraceLog::MarkStartEvent("Interactive Render");
   this->GetRenderWindow()->SetDesiredUpdateRate(5.0);
 
   this->Internals->PreRender(this->RenderView);
 
   this->Render(true, false);
 
-  vtkTimerLog::MarkEndEvent("Interactive Render");
+  vtkPVEventTraceLog::MarkEndEvent("Interactive Render");
 }
 
 //----------------------------------------------------------------------------
@@ -1295,7 +1314,13 @@ void vtkPVRenderView::Render(bool interactive, bool skip_rendering)
     vtkProcessModule::GetProcessType() != vtkProcessModule::PROCESS_DATA_SERVER)
     {
     this->AboutToRenderOnLocalProcess(interactive);
+    double start_time = vtkTimerLog::GetUniversalTime();
     this->GetRenderWindow()->Render();
+    if (use_lod_rendering && this->UseLODPyramid &&
+      this->SynchronizedWindows->GetLocalProcessIsDriver())
+      {
+      this->UpdateLODPyramidLevel(vtkTimerLog::GetUniversalTime() - start_time);
+      }
     }
 
   if (!this->MakingSelection)
@@ -1631,6 +1656,47 @@ bool vtkPVRenderView::ShouldUseLODRendering(double geometry_size)
   return this->LODRenderingThreshold <= geometry_size;
 }
 
+//----------------------------------------------------------------------------
+void vtkPVRenderView::SetLODPyramidLevel(int level)
+{
+  level = std::max(0, std::min(level, GetNumberOfLODPyramidLevels() - 1));
+  if (this->LODPyramidLevel != level)
+    {
+    this->LODPyramidLevel = level;
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkPVRenderView::GetInitialLODPyramidLevel(double geometry_size)
+{
+  // Start one level coarser for every 10 fold the geometry exceeds the
+  // threshold by.
+  if (this->LODRenderingThreshold <= 0 ||
+    geometry_size <= this->LODRenderingThreshold)
+    {
+    return 0;
+    }
+  return static_cast<int>(log10(geometry_size / this->LODRenderingThreshold));
+}
+
+//----------------------------------------------------------------------------
+void vtkPVRenderView::UpdateLODPyramidLevel(double render_time)
+{
+  // A level has about a quarter of the triangles of the previous (finer) one,
+  // so only go back to the finer level when well within the frame budget to
+  // avoid flip-flopping between levels.
+  double frame_time = 1.0 / this->LODPyramidFrameRate;
+  if (render_time > frame_time)
+    {
+    this->SetLODPyramidLevel(this->LODPyramidLevel + 1);
+    }
+  else if (render_time < 0.25 * frame_time)
+    {
+    this->SetLODPyramidLevel(this->LODPyramidLevel - 1);
+    }
+}
+
 //----------------------------------------------------------------------------
 bool vtkPVRenderView::GetUseOrderedCompositing()
 {
@@ -1754,7 +1820,7 @@ double vtkPVRenderView::GetZbufferDataAtPoint(int x, int y)
 //----------------------------------------------------------------------------
 void vtkPVRenderView::StreamingUpdate(const double view_planes[24])
 {
-  vtkTimerLog::MarkStartEvent("vtkPVRenderView::StreamingUpdate");
+  vtkPVEventTraceLog::MarkStartEvent("vtkPVRenderView::StreamingUpdate");
 
   // Provide information about the view planes to the representations.
   // Representations are free to ignore them.
@@ -1767,7 +1833,7 @@ void vtkPVRenderView::StreamingUpdate(const double view_planes[24])
   this->CallProcessViewRequest(vtkPVRenderView::REQUEST_STREAMING_UPDATE(),
     this->RequestInformation, this->ReplyInformationVector);
 
-  vtkTimerLog::MarkEndEvent("vtkPVRenderView::StreamingUpdate");
+  vtkPVEventTraceLog::MarkEndEvent("vtkPVRenderView::StreamingUpdate");
 }
 
 //----------------------------------------------------------------------------
@@ -1777,7 +1843,7 @@ void vtkPVRenderView::DeliverStreamedPieces(
   // the plan now is to fetch the piece and then simply give it to the
   // representation as "next piece". Representation can decide what to do with
   // it, including adding to the existing datastructure.
-  vtkTimerLog::MarkStartEvent("vtkPVRenderView::DeliverStreamedPieces");
+  vtkPVEventTraceLog::MarkStartEvent("vtkPVRenderView::DeliverStreamedPieces");
   this->Internals->DeliveryManager->DeliverStreamedPieces(
     size, representation_ids);
 
@@ -1793,7 +1859,7 @@ void vtkPVRenderView::DeliverStreamedPieces(
   this->Internals->DeliveryManager->ClearStreamedPieces();
   //                                  ^--- the most dubious part of this code.
 
-  vtkTimerLog::MarkEndEvent("vtkPVRenderView::DeliverStreamedPieces");
+  vtkPVEventTraceLog::MarkEndEvent("vtkPVRenderView::DeliverStreamedPieces");
 }
 
 //----------------------------------------------------------------------------
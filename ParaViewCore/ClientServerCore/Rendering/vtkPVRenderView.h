@@ -189,6 +189,35 @@ public:
   vtkSetMacro(UseOutlineForLODRendering, bool);
   vtkGetMacro(UseOutlineForLODRendering, bool);
 
+  // Description:
+  // When set to true, representations that support it (e.g.
+  // vtkGeometryRepresentation) build a pyramid of LOD geometries once, with
+  // GetNumberOfLODPyramidLevels() levels starting at LODResolution, and the
+  // view picks the level to use instead of decimating again. The starting
+  // level depends on how much the geometry size exceeds the
+  // LODRenderingThreshold. After every interactive render, the level is
+  // adjusted to keep the frame rate close to LODPyramidFrameRate.
+  // @CallOnAllProcessess
+  vtkSetMacro(UseLODPyramid, bool);
+  vtkGetMacro(UseLODPyramid, bool);
+
+  // Description:
+  // Get/Set the interactive frame rate (in frames per second) aimed at when
+  // choosing the level of the LOD pyramid. Default is 10.
+  vtkSetClampMacro(LODPyramidFrameRate, double, 0.1, 120.0);
+  vtkGetMacro(LODPyramidFrameRate, double);
+
+  // Description:
+  // Get/Set the level of the LOD pyramid to use, 0 being the finest. The level
+  // is chosen on the process driving the rendering; vtkSMRenderViewProxy sets
+  // it on the other processes before updating the LOD.
+  void SetLODPyramidLevel(int level);
+  vtkGetMacro(LODPyramidLevel, int);
+
+  // Description:
+  // Returns the number of levels of the LOD pyramids.
+  static int GetNumberOfLODPyramidLevels() { return 4; }
+
   // Description:
   // Passes the compressor configuration to the client-server synchronizer, if
   // any. This affects the image compression used to relay images back to the
@@ -227,6 +256,12 @@ public:
   // pass.
   static vtkInformationIntegerKey* USE_OUTLINE_FOR_LOD();
 
+  // Description:
+  // Indicates the level of the LOD pyramid to use in REQUEST_UPDATE_LOD()
+  // pass. Only set when UseLODPyramid is true. Representations without
+  // support for LOD pyramids simply decimate at LOD_RESOLUTION().
+  static vtkInformationIntegerKey* LOD_PYRAMID_LEVEL();
+
   // Description:
   // Representation can publish this key in their REQUEST_INFORMATION()
   // pass to indicate that the representation needs to disable
@@ -611,6 +646,15 @@ protected:
   // Returns true if LOD rendering should be used based on the geometry size.
   bool ShouldUseLODRendering(double geometry);
 
+  // Description:
+  // Returns the level of the LOD pyramid to start with for the geometry size.
+  int GetInitialLODPyramidLevel(double geometry_size);
+
+  // Description:
+  // Adjusts LODPyramidLevel based on the time taken by the last interactive
+  // render.
+  void UpdateLODPyramidLevel(double render_time);
+
   // Description:
   // Synchronizes bounds information on all nodes.
   // @CallOnAllProcessess
@@ -711,6 +755,10 @@ protected:
   bool UsedLODForLastRender;
   bool UseLODForInteractiveRender;
   bool UseOutlineForLODRendering;
+  bool UseLODPyramid;
+  double LODPyramidFrameRate;
+  int LODPyramidLevel;
+  double LODPyramidGeometrySize;
   bool UseDistributedRenderingForStillRender;
   bool UseDistributedRenderingForInteractiveRender;
 
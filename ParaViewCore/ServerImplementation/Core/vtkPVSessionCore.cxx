@@ -25,6 +25,7 @@
 #include "vtkMultiProcessStream.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVInformation.h"
+#include "vtkPVInformationCodec.h"
 #include "vtkPVInstantiator.h"
 #include "vtkPVOptions.h"
 #include "vtkPVSession.h"
@@ -41,6 +42,7 @@
 #include <fstream>
 #include <set>
 #include <string>
+#include <vector>
 #include <vtksys/ios/sstream>
 
 
@@ -965,17 +967,14 @@ bool vtkPVSessionCore::CollectInformation(vtkPVInformation* info)
     offSet    = new vtkIdType[ nranks ];
     } // END if rank == 0
 
-  // STEP 2: Serialize the vtkPVInformation object
-  vtkClientServerStream stream;
-  info->CopyToStream( &stream );
-
-  const unsigned char* data;
-  size_t length;
+  // STEP 2: Serialize the vtkPVInformation object in the compact columnar
+  // format, which is much smaller than the raw stream for information
+  // objects with many blocks and arrays.
+  std::vector<unsigned char> buffer;
+  vtkPVInformationCodec::CopyToBuffer( info, buffer );
 
-  // Get pointer to the raw stream data. Note, this is a shallow copy, no
-  // need to delete the data.
-  stream.GetData( &data, &length);
-  vtkIdType local_length = static_cast<vtkIdType>( length );
+  const unsigned char* data = buffer.empty()? NULL : &buffer[0];
+  vtkIdType local_length = static_cast<vtkIdType>( buffer.size() );
 
   // STEP 3: Get number of bytes that each process will send
   this->ParallelController->Gather(&local_length,rcvcounts,1,0);
@@ -1007,13 +1006,18 @@ bool vtkPVSessionCore::CollectInformation(vtkPVInformation* info)
   // the information object associated with rank 0.
   if( rank == 0 )
     {
-    vtkClientServerStream rcvStream;
     for( int i=1; i < nranks; ++i )
       {
-      rcvStream.SetData( &rcvbuffer[ offSet[i] ],rcvcounts[ i ] );
       vtkPVInformation* tempInfo = info->NewInstance();
-      tempInfo->CopyFromStream( &rcvStream );
-      info->AddInformation( tempInfo );
+      if ( vtkPVInformationCodec::CopyFromBuffer( tempInfo,
+          &rcvbuffer[ offSet[i] ], rcvcounts[ i ] ) )
+        {
+        info->AddInformation( tempInfo );
+        }
+      else
+        {
+        vtkErrorMacro("Failed to decode information from rank " << i);
+        }
       tempInfo->Delete();
       } // END for all remote ranks
     } // END if rank == 0
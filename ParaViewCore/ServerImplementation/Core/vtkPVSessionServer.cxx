@@ -25,6 +25,7 @@
 #include "vtkProcessModule.h"
 #include "vtkPVConfig.h"
 #include "vtkPVInformation.h"
+#include "vtkPVInformationCodec.h"
 #include "vtkPVInstantiator.h"
 #include "vtkPVServerOptions.h"
 #include "vtkPVSessionCore.h"
@@ -209,6 +210,9 @@ public:
     this->NotifyOtherClients(&proxyDefinitionManagerState);
     }
 
+  // Keeps the information last sent to the clients to send deltas.
+  vtkNew<vtkPVInformationCodec> InformationCodec;
+
 private:
   vtkNew<vtkCompositeMultiProcessController> CompositeMultiProcessController;
   vtkWeakPointer<vtkPVSessionServer> Owner;
@@ -563,10 +567,10 @@ void vtkPVSessionServer::OnClientServerMessageRMI(void* message, int message_len
   case vtkPVSessionServer::GATHER_INFORMATION:
       {
       std::string classname;
-      vtkTypeUInt32 location, globalid;
-      stream >> location >> classname >> globalid;
+      vtkTypeUInt32 location, globalid, cachedVersion;
+      stream >> location >> classname >> globalid >> cachedVersion;
       this->GatherInformationInternal(location, classname.c_str(), globalid,
-        stream);
+        cachedVersion, stream);
       }
     break;
     }
@@ -593,7 +597,7 @@ void vtkPVSessionServer::SendLastResultToClient()
 //----------------------------------------------------------------------------
 void vtkPVSessionServer::GatherInformationInternal(
   vtkTypeUInt32 location, const char* classname, vtkTypeUInt32 globalid,
-  vtkMultiProcessStream& stream)
+  vtkTypeUInt32 cachedVersion, vtkMultiProcessStream& stream)
 {
   vtkSmartPointer<vtkObject> o;
   o.TakeReference(vtkPVInstantiator::CreateInstance(classname));
@@ -607,16 +611,17 @@ void vtkPVSessionServer::GatherInformationInternal(
 
     this->GatherInformation(location, info, globalid);
 
-    vtkClientServerStream css;
-    info->CopyToStream(&css);
-    size_t length;
-    const unsigned char* data;
-    css.GetData(&data, &length);
-    int len = static_cast<int>(length);
+    // Only the changes since the version the client has are sent, when
+    // possible.
+    std::vector<unsigned char> reply;
+    this->Internal->InformationCodec->EncodeReply(
+      vtkPVInformationCodec::GetRequestKey(info, location, globalid),
+      cachedVersion, info, reply);
+    int len = static_cast<int>(reply.size());
     this->Internal->GetActiveController()->Send(&len, 1, 1,
       vtkPVSessionServer::REPLY_GATHER_INFORMATION_TAG);
-    this->Internal->GetActiveController()->Send(const_cast<unsigned char*>(data),
-      length, 1, vtkPVSessionServer::REPLY_GATHER_INFORMATION_TAG);
+    this->Internal->GetActiveController()->Send(&reply[0],
+      reply.size(), 1, vtkPVSessionServer::REPLY_GATHER_INFORMATION_TAG);
     }
   else
     {
@@ -111,9 +111,11 @@ protected:
 
   // Description:
   // Called when client triggers GatherInformation().
+  // \c cachedVersion is the version of the information the client already
+  // has (see vtkPVInformationCodec), or 0.
   void GatherInformationInternal(
     vtkTypeUInt32 location, const char* classname, vtkTypeUInt32 globalid,
-    vtkMultiProcessStream&);
+    vtkTypeUInt32 cachedVersion, vtkMultiProcessStream&);
 
   // Description:
   // Sends the last result to client.
@@ -25,12 +25,12 @@
 #include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
 #include "vtkProcessModule.h"
+#include "vtkPVEventTraceLog.h"
 #include "vtkPVInstantiator.h"
 #include "vtkPVPostFilter.h"
 #include "vtkPVXMLElement.h"
 #include "vtkSMMessage.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
-#include "vtkTimerLog.h"
 #include "vtkUnstructuredGrid.h"
 
 #include <vector>
@@ -317,7 +317,7 @@ void vtkSISourceProxy::MarkStartEvent()
     << "Execute "
     << (this->GetVTKClassName()?  this->GetVTKClassName() : this->GetClassName())
     << " id: " << this->GetGlobalID();
-  vtkTimerLog::MarkStartEvent(filterName.str().c_str());
+  vtkPVEventTraceLog::MarkStartEvent(filterName.str().c_str());
 }
 
 //----------------------------------------------------------------------------
@@ -328,7 +328,7 @@ void vtkSISourceProxy::MarkEndEvent()
     << "Execute "
     << (this->GetVTKClassName()?  this->GetVTKClassName() : this->GetClassName())
     << " id: " << this->GetGlobalID();
-  vtkTimerLog::MarkEndEvent(filterName.str().c_str());
+  vtkPVEventTraceLog::MarkEndEvent(filterName.str().c_str());
 }
 
 //----------------------------------------------------------------------------
@@ -24,6 +24,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkProcessModule.h"
 #include "vtkPVConfig.h"
+#include "vtkPVInformationCodec.h"
 #include "vtkPVMultiClientsInformation.h"
 #include "vtkPVOptions.h"
 #include "vtkPVServerInformation.h"
@@ -83,6 +84,7 @@ vtkSMSessionClient::vtkSMSessionClient() : Superclass(false)
   this->RenderServerInformation = vtkPVServerInformation::New();
   this->ServerInformation = vtkPVServerInformation::New();
   this->ServerLastInvokeResult = new vtkClientServerStream();
+  this->InformationCodec = vtkPVInformationCodec::New();
 
   // Register server state locator for that specific session
   vtkNew<vtkSMServerStateLocator> serverStateLocator;
@@ -111,6 +113,7 @@ vtkSMSessionClient::~vtkSMSessionClient()
   this->DataServerInformation->Delete();
   this->RenderServerInformation->Delete();
   this->ServerInformation->Delete();
+  this->InformationCodec->Delete();
   if(this->CollaborationCommunicator)
     {
     this->CollaborationCommunicator->Delete();
@@ -784,15 +787,6 @@ bool vtkSMSessionClient::GatherInformation(
     add_local_info = true;
     }
 
-  vtkMultiProcessStream stream;
-  stream << static_cast<int>(vtkPVSessionServer::GATHER_INFORMATION)
-    << location
-    << information->GetClassName()
-    << globalid;
-  information->CopyParametersToStream(stream);
-  std::vector<unsigned char> raw_message;
-  stream.GetRawData(raw_message);
-
   vtkMultiProcessController* controller = NULL;
 
   if ( (location & vtkPVSession::DATA_SERVER) != 0 ||
@@ -810,41 +804,82 @@ bool vtkSMSessionClient::GatherInformation(
 
   if (controller)
     {
-    controller->TriggerRMIOnAllChildren(
-      &raw_message[0], static_cast<int>(raw_message.size()),
-      vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+    std::string key =
+      vtkPVInformationCodec::GetRequestKey(information, location, globalid);
 
-    int length2 = 0;
-    controller->Receive(&length2, 1, 1, vtkPVSessionServer::REPLY_GATHER_INFORMATION_TAG);
-    if (length2 <= 0)
+    // Tell the server which version of this information we already have so
+    // that it can send only what changed. If the reply cannot be decoded
+    // (e.g. the delta does not apply to our cached version), the cache entry
+    // is discarded and the full information is requested again.
+    bool decoded = false;
+    vtkTypeUInt32 version = this->InformationCodec->GetCachedVersion(key);
+    for (int attempt = 0; attempt < 2 && !decoded; ++attempt)
       {
-      vtkErrorMacro("Server failed to gather information.");
-      this->EndBusyWork();
-      return false;
-      }
-    unsigned char* data2 = new unsigned char[length2];
-    if (!controller->Receive((char*)data2, length2, 1,
-        vtkPVSessionServer::REPLY_GATHER_INFORMATION_TAG))
-      {
-      vtkErrorMacro("Failed to receive information correctly.");
+      if (attempt > 0)
+        {
+        if (version == 0)
+          {
+          break;
+          }
+        vtkWarningMacro("Failed to decode information delta for "
+          << information->GetClassName() << ", requesting it in full.");
+        version = 0;
+        }
+
+      vtkMultiProcessStream stream;
+      stream << static_cast<int>(vtkPVSessionServer::GATHER_INFORMATION)
+        << location
+        << information->GetClassName()
+        << globalid
+        << version;
+      information->CopyParametersToStream(stream);
+      std::vector<unsigned char> raw_message;
+      stream.GetRawData(raw_message);
+
+      controller->TriggerRMIOnAllChildren(
+        &raw_message[0], static_cast<int>(raw_message.size()),
+        vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+
+      int length2 = 0;
+      controller->Receive(&length2, 1, 1, vtkPVSessionServer::REPLY_GATHER_INFORMATION_TAG);
+      if (length2 <= 0)
+        {
+        vtkErrorMacro("Server failed to gather information.");
+        this->EndBusyWork();
+        return false;
+        }
+      unsigned char* data2 = new unsigned char[length2];
+      if (!controller->Receive((char*)data2, length2, 1,
+          vtkPVSessionServer::REPLY_GATHER_INFORMATION_TAG))
+        {
+        vtkErrorMacro("Failed to receive information correctly.");
+        delete [] data2;
+        this->EndBusyWork();
+        return false;
+        }
+      if (add_local_info)
+        {
+        vtkPVInformation* tempInfo = information->NewInstance();
+        decoded = this->InformationCodec->DecodeReply(
+          key, data2, length2, tempInfo);
+        if (decoded)
+          {
+          information->AddInformation(tempInfo);
+          }
+        tempInfo->Delete();
+        }
+      else
+        {
+        decoded = this->InformationCodec->DecodeReply(
+          key, data2, length2, information);
+        }
       delete [] data2;
-      this->EndBusyWork();
-      return false;
-      }
-    vtkClientServerStream csstream;
-    csstream.SetData(data2, length2);
-    if (add_local_info)
-      {
-      vtkPVInformation* tempInfo = information->NewInstance();
-      tempInfo->CopyFromStream(&csstream);
-      information->AddInformation(tempInfo);
-      tempInfo->Delete();
       }
-    else
+    if (!decoded)
       {
-      information->CopyFromStream(&csstream);
+      vtkErrorMacro("Failed to decode " << information->GetClassName()
+        << " received from the server.");
       }
-    delete [] data2;
     }
   this->EndBusyWork();
   return false;
@@ -25,6 +25,7 @@
 #include "vtkSMSession.h"
 
 class vtkMultiProcessController;
+class vtkPVInformationCodec;
 class vtkPVServerInformation;
 class vtkSMCollaborationManager;
 class vtkSMProxyLocator;
@@ -223,6 +224,10 @@ protected:
   // Field used to communicate with other clients
   vtkSMCollaborationManager* CollaborationCommunicator;
 
+  // Keeps the information last received from the server so that the server
+  // only needs to send what changed.
+  vtkPVInformationCodec* InformationCodec;
+
   // Description:
   // Callback when any vtkMultiProcessController subclass fires a WrongTagEvent.
   // Return true if the event was handle locally.
@@ -97,6 +97,7 @@ vtkSMRenderViewProxy::vtkSMRenderViewProxy()  :
   this->NewMasterObserverId = 0;
   this->DeliveryManager = NULL;
   this->NeedsUpdateLOD = true;
+  this->LODPyramidLevel = -1;
   this->InteractorHelper->SetViewProxy(this);
 }
 
@@ -202,7 +203,20 @@ void vtkSMRenderViewProxy::UpdateLOD()
 {
   if (this->ObjectsCreated && this->NeedsUpdateLOD)
     {
+    vtkPVRenderView* view = vtkPVRenderView::SafeDownCast(
+      this->GetClientSideObject());
     vtkClientServerStream stream;
+    if (view->GetUseLODPyramid())
+      {
+      // The level of the LOD pyramid is chosen on the client, based on the
+      // time taken by interactive renders. Pass it along to the servers.
+      stream << vtkClientServerStream::Invoke
+             << VTKOBJECT(this)
+             << "SetLODPyramidLevel"
+             << view->GetLODPyramidLevel()
+             << vtkClientServerStream::End;
+      }
+    this->LODPyramidLevel = view->GetLODPyramidLevel();
     stream << vtkClientServerStream::Invoke
            << VTKOBJECT(this)
            << "UpdateLOD"
@@ -273,7 +287,14 @@ vtkTypeUInt32 vtkSMRenderViewProxy::PreRender(bool interactive)
   if (interactive && rv->GetUseLODForInteractiveRender())
     {
     // for interactive renders, we need to determine if we are going to use LOD.
-    // If so, we may need to update the LOD geometries.
+    // If so, we may need to update the LOD geometries. When using LOD
+    // pyramids, the view may have picked another level after the previous
+    // interactive render, which only requires passing along that level.
+    if (rv->GetUseLODPyramid() &&
+      rv->GetLODPyramidLevel() != this->LODPyramidLevel)
+      {
+      this->NeedsUpdateLOD = true;
+      }
     this->UpdateLOD();
     }
   this->DeliveryManager->Deliver(interactive);
@@ -241,6 +241,9 @@ protected:
   vtkSMDataDeliveryManager* DeliveryManager;
   bool NeedsUpdateLOD;
 
+  // The level of the LOD pyramid used by the most recent UpdateLOD().
+  int LODPyramidLevel;
+
 private:
   vtkSMRenderViewProxy(const vtkSMRenderViewProxy&); // Not implemented
   void operator=(const vtkSMRenderViewProxy&); // Not implemented
@@ -0,0 +1,121 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVEventTraceLog.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Records nested scopes from several threads with vtkPVEventTraceLog and
+// checks the number of events, the ring buffer overflow accounting and the
+// process description written to the trace.
+
+#include "vtkMultiThreader.h"
+#include "vtkNew.h"
+#include "vtkPVEventTraceLog.h"
+
+#include <vtksys/ios/sstream>
+
+#include <iostream>
+#include <string>
+
+namespace
+{
+  const int NumberOfThreads = 4;
+  const int ScopesPerThread = 100;
+
+  VTK_THREAD_RETURN_TYPE RecordScopes(void*)
+    {
+    for (int cc = 0; cc < ScopesPerThread; ++cc)
+      {
+      vtkPVEventTraceScope outer("Outer");
+      vtkPVEventTraceLog::BeginScope("Inner");
+      vtkPVEventTraceLog::EndScope("Inner");
+      }
+    return VTK_THREAD_RETURN_VALUE;
+    }
+
+  bool Contains(const std::string& str, const char* pattern)
+    {
+    return str.find(pattern) != std::string::npos;
+    }
+}
+
+int TestPVEventTraceLog(int, char*[])
+{
+  // Nothing is recorded while disabled.
+  vtkPVEventTraceLog::BeginScope("Disabled");
+  vtkPVEventTraceLog::EndScope("Disabled");
+  if (vtkPVEventTraceLog::GetNumberOfEvents() != 0)
+    {
+    std::cerr << "Events recorded while disabled." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkPVEventTraceLog::SetRank(3);
+  vtkPVEventTraceLog::SetProcessType(1, "server");
+  vtkPVEventTraceLog::SetEnabled(true);
+
+  vtkNew<vtkMultiThreader> threader;
+  threader->SetNumberOfThreads(NumberOfThreads);
+  threader->SetSingleMethod(RecordScopes, NULL);
+  threader->SingleMethodExecute();
+
+  const int expected = NumberOfThreads * ScopesPerThread * 2;
+  if (vtkPVEventTraceLog::GetNumberOfEvents() != expected ||
+    vtkPVEventTraceLog::GetNumberOfDroppedEvents() != 0)
+    {
+    std::cerr << "Expected " << expected << " events, got "
+              << vtkPVEventTraceLog::GetNumberOfEvents() << " and "
+              << vtkPVEventTraceLog::GetNumberOfDroppedEvents()
+              << " dropped." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Ending an outer scope also ends the scopes nested in it, ending a scope
+  // that was never begun does nothing.
+  vtkPVEventTraceLog::Reset();
+  vtkPVEventTraceLog::BeginScope("A");
+  vtkPVEventTraceLog::BeginScope("B");
+  vtkPVEventTraceLog::EndScope("A");
+  vtkPVEventTraceLog::EndScope("C");
+  if (vtkPVEventTraceLog::GetNumberOfEvents() != 2)
+    {
+    std::cerr << "Unbalanced scopes were not recovered." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  vtksys_ios::ostringstream trace;
+  vtkPVEventTraceLog::WriteChromeTrace(trace);
+  const std::string json = trace.str();
+  if (vtkPVEventTraceLog::GetTraceProcessId() != 100003 ||
+    !Contains(json, "\"pid\":100003") || !Contains(json, "\"server 3\"") ||
+    !Contains(json, "\"name\":\"B\"") || !Contains(json, "\"depth\":1"))
+    {
+    std::cerr << "Unexpected trace:" << std::endl << json << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Each thread keeps its newest events once its buffer is full.
+  vtkPVEventTraceLog::SetMaximumNumberOfEvents(50);
+  threader->SingleMethodExecute();
+  if (vtkPVEventTraceLog::GetNumberOfEvents() > NumberOfThreads * 50 ||
+    vtkPVEventTraceLog::GetNumberOfEvents() +
+    vtkPVEventTraceLog::GetNumberOfDroppedEvents() != expected)
+    {
+    std::cerr << "Ring buffer overflow not accounted for: "
+              << vtkPVEventTraceLog::GetNumberOfEvents() << " events, "
+              << vtkPVEventTraceLog::GetNumberOfDroppedEvents()
+              << " dropped." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkPVEventTraceLog::SetEnabled(false);
+  return EXIT_SUCCESS;
+}
@@ -7,6 +7,10 @@ vtk_module(vtkPVVTKExtensionsCore
     vtkPVCommon
   PRIVATE_DEPENDS
     vtksys
+  TEST_DEPENDS
+    vtkTestingCore
+  TEST_LABELS
+    PARAVIEW
   KIT
     vtkPVExtensions
 )
@@ -23,6 +23,7 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkInformationObjectBaseKey.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
+#include "vtkPVEventTraceLog.h"
 #include "vtkPVPostFilterExecutive.h"
 
 #include <assert.h>
@@ -97,6 +98,19 @@ void vtkPVCompositeDataPipeline::ResetPipelineInformation(
   this->Superclass::ResetPipelineInformation(port, info);
 }
 
+//----------------------------------------------------------------------------
+int vtkPVCompositeDataPipeline::ExecuteData(vtkInformation* request,
+  vtkInformationVector** inInfoVec, vtkInformationVector* outInfoVec)
+{
+  if (!vtkPVEventTraceLog::GetEnabled())
+    {
+    return this->Superclass::ExecuteData(request, inInfoVec, outInfoVec);
+    }
+
+  vtkPVEventTraceScope scope(this->Algorithm->GetClassName());
+  return this->Superclass::ExecuteData(request, inInfoVec, outInfoVec);
+}
+
 //----------------------------------------------------------------------------
 void vtkPVCompositeDataPipeline::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -0,0 +1,514 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVEventTraceLog.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVEventTraceLog.h"
+
+#include "vtkMultiThreader.h"
+#include "vtkObjectFactory.h"
+#include "vtkSimpleCriticalSection.h"
+#include "vtkTimerLog.h"
+
+#include <vtksys/ios/fstream>
+#include <vtksys/ios/sstream>
+
+#include <iomanip>
+#include <map>
+#include <string>
+#include <vector>
+
+// Each thread records into its own buffer, found through a thread-local
+// pointer, so that recording does not contend on a global lock. When the
+// compiler does not support thread-local storage, the buffer is looked up in
+// the list of buffers under the global lock instead.
+#if defined(_MSC_VER)
+# define VTK_TRACE_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__) || defined(__clang__) || defined(__INTEL_COMPILER)
+# define VTK_TRACE_THREAD_LOCAL __thread
+#endif
+
+namespace
+{
+  struct vtkTraceEvent
+    {
+    int Name;
+    int Depth;
+    double Start;
+    double Duration;
+    };
+
+  struct vtkTraceScope
+    {
+    int Name;
+    double Start;
+    };
+
+  // Events recorded by one thread. The lock is only contended while the
+  // trace is written or reset.
+  class vtkTraceThread
+    {
+  public:
+    vtkSimpleCriticalSection Lock;
+    vtkMultiThreaderIDType Id;
+    int Index;
+    std::vector<vtkTraceScope> Stack;
+    std::vector<vtkTraceEvent> Events;
+    size_t Capacity;
+    size_t Next;
+    vtkIdType Dropped;
+    std::vector<std::string> Names;
+    std::map<std::string, int> NameIds;
+
+    vtkTraceThread(vtkMultiThreaderIDType id, int index, size_t capacity)
+      : Id(id), Index(index), Capacity(capacity), Next(0), Dropped(0)
+      {
+      }
+
+    // Must be called with the lock held.
+    int GetNameId(const char* name)
+      {
+      std::string key(name? name : "");
+      std::map<std::string, int>::iterator iter = this->NameIds.find(key);
+      if (iter != this->NameIds.end())
+        {
+        return iter->second;
+        }
+      int id = static_cast<int>(this->Names.size());
+      this->Names.push_back(key);
+      this->NameIds[key] = id;
+      return id;
+      }
+
+    // Must be called with the lock held. The ring buffer grows on demand up
+    // to its capacity so that short-lived threads stay cheap.
+    void Record(const vtkTraceEvent& event)
+      {
+      if (this->Capacity == 0)
+        {
+        return;
+        }
+      if (this->Events.size() < this->Capacity)
+        {
+        this->Events.push_back(event);
+        return;
+        }
+      this->Dropped++;
+      this->Events[this->Next] = event;
+      this->Next = (this->Next + 1) % this->Capacity;
+      }
+
+    // Must be called with the lock held.
+    void Clear(size_t capacity)
+      {
+      this->Events.clear();
+      this->Stack.clear();
+      this->Capacity = capacity;
+      this->Next = 0;
+      this->Dropped = 0;
+      }
+    };
+
+  class vtkTraceInternals
+    {
+  public:
+    // Protects Threads, Capacity and the process description.
+    vtkSimpleCriticalSection Lock;
+    int Rank;
+    int ProcessTypeIndex;
+    std::string ProcessTypeName;
+    size_t Capacity;
+    std::vector<vtkTraceThread*> Threads;
+
+    vtkTraceInternals()
+      : Rank(0), ProcessTypeIndex(0), ProcessTypeName("process"),
+      Capacity(65536)
+      {
+      }
+
+    // Returns the buffer of the calling thread. Threads are numbered in the
+    // order in which they first record an event. The buffer of a thread that
+    // exited is reused by a new thread that gets the same id, which bounds
+    // the number of buffers for codes that keep spawning worker threads.
+    vtkTraceThread* GetThread()
+      {
+#ifdef VTK_TRACE_THREAD_LOCAL
+      static VTK_TRACE_THREAD_LOCAL vtkTraceThread* current = NULL;
+      if (current)
+        {
+        return current;
+        }
+#endif
+      vtkMultiThreaderIDType self = vtkMultiThreader::GetCurrentThreadID();
+      vtkTraceThread* thread = NULL;
+      this->Lock.Lock();
+      for (size_t cc = 0; cc < this->Threads.size() && !thread; ++cc)
+        {
+        if (vtkMultiThreader::ThreadsEqual(self, this->Threads[cc]->Id))
+          {
+          thread = this->Threads[cc];
+          }
+        }
+      if (!thread)
+        {
+        thread = new vtkTraceThread(self,
+          static_cast<int>(this->Threads.size()), this->Capacity);
+        this->Threads.push_back(thread);
+        }
+      this->Lock.Unlock();
+#ifdef VTK_TRACE_THREAD_LOCAL
+      current = thread;
+#endif
+      return thread;
+      }
+
+    // Returns the "pid" written for all events of this process.
+    int GetTraceProcessId()
+      {
+      return this->ProcessTypeIndex * 100000 + this->Rank;
+      }
+    };
+
+  vtkTraceInternals* GetInternals()
+    {
+    // Intentionally leaked so that events can be recorded and written during
+    // static destruction.
+    static vtkTraceInternals* internals = new vtkTraceInternals();
+    return internals;
+    }
+
+  void WriteJSONString(ostream& os, const std::string& str)
+    {
+    os << "\"";
+    for (size_t cc = 0; cc < str.size(); ++cc)
+      {
+      char c = str[cc];
+      switch (c)
+        {
+      case '"': os << "\\\""; break;
+      case '\\': os << "\\\\"; break;
+      case '\n': os << "\\n"; break;
+      case '\t': os << "\\t"; break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20)
+          {
+          os << " ";
+          }
+        else
+          {
+          os << c;
+          }
+        }
+      }
+    os << "\"";
+    }
+}
+
+bool vtkPVEventTraceLog::Enabled = false;
+
+vtkStandardNewMacro(vtkPVEventTraceLog);
+//----------------------------------------------------------------------------
+vtkPVEventTraceLog::vtkPVEventTraceLog()
+{
+}
+
+//----------------------------------------------------------------------------
+vtkPVEventTraceLog::~vtkPVEventTraceLog()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkPVEventTraceLog::SetEnabled(bool val)
+{
+  // make sure the internals exist before any thread records an event.
+  GetInternals();
+  vtkPVEventTraceLog::Enabled = val;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVEventTraceLog::SetRank(int rank)
+{
+  vtkTraceInternals* internals = GetInternals();
+  internals->Lock.Lock();
+  internals->Rank = rank;
+  internals->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+int vtkPVEventTraceLog::GetRank()
+{
+  return GetInternals()->Rank;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVEventTraceLog::SetProcessType(int index, const char* name)
+{
+  vtkTraceInternals* internals = GetInternals();
+  internals->Lock.Lock();
+  internals->ProcessTypeIndex = index;
+  internals->ProcessTypeName = name? name : "process";
+  internals->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+int vtkPVEventTraceLog::GetProcessTypeIndex()
+{
+  return GetInternals()->ProcessTypeIndex;
+}
+
+//----------------------------------------------------------------------------
+const char* vtkPVEventTraceLog::GetProcessTypeName()
+{
+  return GetInternals()->ProcessTypeName.c_str();
+}
+
+//----------------------------------------------------------------------------
+int vtkPVEventTraceLog::GetTraceProcessId()
+{
+  return GetInternals()->GetTraceProcessId();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVEventTraceLog::SetMaximumNumberOfEvents(int num)
+{
+  vtkTraceInternals* internals = GetInternals();
+  internals->Lock.Lock();
+  internals->Capacity = num > 0? static_cast<size_t>(num) : 0;
+  for (size_t cc = 0; cc < internals->Threads.size(); ++cc)
+    {
+    vtkTraceThread* thread = internals->Threads[cc];
+    thread->Lock.Lock();
+    thread->Clear(internals->Capacity);
+    thread->Lock.Unlock();
+    }
+  internals->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+int vtkPVEventTraceLog::GetMaximumNumberOfEvents()
+{
+  return static_cast<int>(GetInternals()->Capacity);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVEventTraceLog::BeginScope(const char* name)
+{
+  if (!vtkPVEventTraceLog::Enabled)
+    {
+    return;
+    }
+
+  vtkTraceScope scope;
+  scope.Start = vtkTimerLog::GetUniversalTime();
+
+  vtkTraceThread* thread = GetInternals()->GetThread();
+  thread->Lock.Lock();
+  scope.Name = thread->GetNameId(name);
+  thread->Stack.push_back(scope);
+  thread->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVEventTraceLog::EndScope(const char* name)
+{
+  if (!vtkPVEventTraceLog::Enabled)
+    {
+    return;
+    }
+
+  double end = vtkTimerLog::GetUniversalTime();
+
+  vtkTraceThread* thread = GetInternals()->GetThread();
+  thread->Lock.Lock();
+  std::vector<vtkTraceScope>& stack = thread->Stack;
+  if (!stack.empty())
+    {
+    // Normally the innermost scope is ended. If the calls are unbalanced, end
+    // the innermost scope with a matching name along with those nested in it,
+    // and ignore end events for scopes that were never begun.
+    size_t depth = stack.size();
+    if (name)
+      {
+      int nameId = thread->GetNameId(name);
+      for (size_t cc = stack.size(); cc > 0; --cc)
+        {
+        if (stack[cc-1].Name == nameId)
+          {
+          depth = cc - 1;
+          break;
+          }
+        }
+      }
+    else
+      {
+      depth = stack.size() - 1;
+      }
+    while (stack.size() > depth)
+      {
+      vtkTraceEvent event;
+      event.Name = stack.back().Name;
+      event.Depth = static_cast<int>(stack.size() - 1);
+      event.Start = stack.back().Start;
+      event.Duration = end - event.Start;
+      thread->Record(event);
+      stack.pop_back();
+      }
+    }
+  thread->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVEventTraceLog::MarkStartEvent(const char* name)
+{
+  vtkTimerLog::MarkStartEvent(name);
+  vtkPVEventTraceLog::BeginScope(name);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVEventTraceLog::MarkEndEvent(const char* name)
+{
+  vtkPVEventTraceLog::EndScope(name);
+  vtkTimerLog::MarkEndEvent(name);
+}
+
+//----------------------------------------------------------------------------
+int vtkPVEventTraceLog::GetNumberOfEvents()
+{
+  vtkTraceInternals* internals = GetInternals();
+  size_t count = 0;
+  internals->Lock.Lock();
+  for (size_t cc = 0; cc < internals->Threads.size(); ++cc)
+    {
+    vtkTraceThread* thread = internals->Threads[cc];
+    thread->Lock.Lock();
+    count += thread->Events.size();
+    thread->Lock.Unlock();
+    }
+  internals->Lock.Unlock();
+  return static_cast<int>(count);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkPVEventTraceLog::GetNumberOfDroppedEvents()
+{
+  vtkTraceInternals* internals = GetInternals();
+  vtkIdType dropped = 0;
+  internals->Lock.Lock();
+  for (size_t cc = 0; cc < internals->Threads.size(); ++cc)
+    {
+    vtkTraceThread* thread = internals->Threads[cc];
+    thread->Lock.Lock();
+    dropped += thread->Dropped;
+    thread->Lock.Unlock();
+    }
+  internals->Lock.Unlock();
+  return dropped;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVEventTraceLog::Reset()
+{
+  vtkTraceInternals* internals = GetInternals();
+  internals->Lock.Lock();
+  for (size_t cc = 0; cc < internals->Threads.size(); ++cc)
+    {
+    vtkTraceThread* thread = internals->Threads[cc];
+    thread->Lock.Lock();
+    thread->Clear(internals->Capacity);
+    thread->Lock.Unlock();
+    }
+  internals->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVEventTraceLog::WriteChromeTrace(ostream& os)
+{
+  vtkTraceInternals* internals = GetInternals();
+  internals->Lock.Lock();
+
+  // Lock all the threads so that the trace is a consistent snapshot.
+  vtkIdType dropped = 0;
+  for (size_t cc = 0; cc < internals->Threads.size(); ++cc)
+    {
+    internals->Threads[cc]->Lock.Lock();
+    dropped += internals->Threads[cc]->Dropped;
+    }
+
+  const int pid = internals->GetTraceProcessId();
+  const int rank = internals->Rank;
+  os << "{\"traceEvents\":[\n";
+  vtksys_ios::ostringstream processName;
+  processName << internals->ProcessTypeName << " " << rank;
+  os << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+     << ",\"tid\":0,\"args\":{\"name\":";
+  WriteJSONString(os, processName.str());
+  os << "}},\n";
+  os << "{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":" << pid
+     << ",\"tid\":0,\"args\":{\"sort_index\":" << pid << "}},\n";
+  os << "{\"name\":\"dropped_events\",\"ph\":\"M\",\"pid\":" << pid
+     << ",\"tid\":0,\"args\":{\"count\":" << dropped << "}}";
+
+  // timestamps are written in microseconds, relative to the epoch, so that
+  // traces from different processes line up when merged.
+  os << std::fixed << std::setprecision(3);
+  for (size_t tt = 0; tt < internals->Threads.size(); ++tt)
+    {
+    vtkTraceThread* thread = internals->Threads[tt];
+    const size_t count = thread->Events.size();
+    // once the ring buffer wrapped, Next is the oldest event.
+    const size_t first = count == thread->Capacity? thread->Next : 0;
+    for (size_t cc = 0; cc < count; ++cc)
+      {
+      const vtkTraceEvent& event = thread->Events[(first + cc) % count];
+      os << ",\n{\"name\":";
+      WriteJSONString(os, thread->Names[event.Name]);
+      os << ",\"cat\":\"paraview\",\"ph\":\"X\",\"ts\":" << event.Start * 1.0e6
+         << ",\"dur\":" << event.Duration * 1.0e6
+         << ",\"pid\":" << pid << ",\"tid\":" << thread->Index
+         << ",\"args\":{\"depth\":" << event.Depth << "}}";
+      }
+    }
+  os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+  for (size_t cc = 0; cc < internals->Threads.size(); ++cc)
+    {
+    internals->Threads[cc]->Lock.Unlock();
+    }
+  internals->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVEventTraceLog::WriteChromeTrace(const char* filename)
+{
+  vtksys_ios::ofstream ofs(filename);
+  if (!ofs)
+    {
+    vtkGenericWarningMacro("Failed to open '" << filename << "' for writing.");
+    return false;
+    }
+  vtkPVEventTraceLog::WriteChromeTrace(ofs);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVEventTraceLog::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Enabled: " << vtkPVEventTraceLog::Enabled << endl;
+  os << indent << "Rank: " << vtkPVEventTraceLog::GetRank() << endl;
+  os << indent << "ProcessType: " << vtkPVEventTraceLog::GetProcessTypeName()
+     << " (" << vtkPVEventTraceLog::GetProcessTypeIndex() << ")" << endl;
+  os << indent << "NumberOfEvents: "
+     << vtkPVEventTraceLog::GetNumberOfEvents() << endl;
+  os << indent << "NumberOfDroppedEvents: "
+     << vtkPVEventTraceLog::GetNumberOfDroppedEvents() << endl;
+}
@@ -0,0 +1,154 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVEventTraceLog.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVEventTraceLog - low-overhead per-rank event trace recorder.
+// .SECTION Description
+// vtkPVEventTraceLog records nested, timed scopes into fixed size ring
+// buffers and writes them out in the Chrome trace-event JSON format (which is
+// also understood by Perfetto). Every thread records into its own buffer so
+// that threads do not contend while tracing. Each event carries a process id
+// (the "pid", derived from the process type and the rank) and a small integer
+// thread id (the "tid") so that traces from all processes can be merged into
+// a single timeline using Utilities/Scripts/merge-event-traces.py.
+//
+// Unlike vtkTimerLog, which is collected as free-form text by
+// vtkPVTimerInformation, the trace is never shipped to the client: each rank
+// writes its own file. When disabled (the default), BeginScope()/EndScope()
+// cost a single branch.
+//
+// MarkStartEvent()/MarkEndEvent() forward to the vtkTimerLog methods of the
+// same name and additionally record a scope, so existing timer events can be
+// traced by simply switching the class used to mark them.
+//
+// vtkProcessModule enables tracing when the PV_EVENT_TRACE_PREFIX
+// environment variable is set and writes the trace for rank N of a process
+// of type T (e.g. "client", "server") to "<PV_EVENT_TRACE_PREFIX>.T.N.json"
+// when finalized.
+//
+// .SECTION See Also
+// vtkTimerLog vtkPVTimerInformation
+
+#ifndef __vtkPVEventTraceLog_h
+#define __vtkPVEventTraceLog_h
+
+#include "vtkObject.h"
+#include "vtkPVVTKExtensionsCoreModule.h" // needed for export macro
+
+class VTKPVVTKEXTENSIONSCORE_EXPORT vtkPVEventTraceLog : public vtkObject
+{
+public:
+  static vtkPVEventTraceLog* New();
+  vtkTypeMacro(vtkPVEventTraceLog, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Enable/disable recording. Disabling keeps already recorded events.
+  static void SetEnabled(bool val);
+  static bool GetEnabled()
+    { return vtkPVEventTraceLog::Enabled; }
+
+  // Description:
+  // Get/Set the rank reported for all events of this process.
+  static void SetRank(int rank);
+  static int GetRank();
+
+  // Description:
+  // Get/Set the kind of process this is, as an index and a name, e.g.
+  // vtkProcessModule::PROCESS_SERVER and "server". This tells apart the
+  // traces of processes with the same rank, such as the client and the
+  // first server rank. Default is 0, "process".
+  static void SetProcessType(int index, const char* name);
+  static int GetProcessTypeIndex();
+  static const char* GetProcessTypeName();
+
+  // Description:
+  // Returns the "pid" written for the events of this process, i.e.
+  // ProcessTypeIndex * 100000 + Rank.
+  static int GetTraceProcessId();
+
+  // Description:
+  // Get/Set the capacity of the ring buffer of each thread, in number of
+  // events. When a buffer is full, its oldest events are overwritten.
+  // Changing the capacity discards all recorded events. Default is 65536.
+  static void SetMaximumNumberOfEvents(int num);
+  static int GetMaximumNumberOfEvents();
+
+  // Description:
+  // Begin/end a timed scope on the calling thread. Scopes may be nested; an
+  // event is recorded when the scope ends. The name passed to EndScope() is
+  // used to recover from unbalanced calls and may be NULL.
+  static void BeginScope(const char* name);
+  static void EndScope(const char* name);
+
+  // Description:
+  // Same as vtkTimerLog::MarkStartEvent()/MarkEndEvent() but also
+  // begins/ends a trace scope.
+  static void MarkStartEvent(const char* name);
+  static void MarkEndEvent(const char* name);
+
+  // Description:
+  // Returns the number of events currently held in the ring buffers and the
+  // number of events that were overwritten since the last Reset().
+  static int GetNumberOfEvents();
+  static vtkIdType GetNumberOfDroppedEvents();
+
+  // Description:
+  // Discard all recorded events.
+  static void Reset();
+
+  // Description:
+  // Write the recorded events as a Chrome trace-event JSON document.
+  static void WriteChromeTrace(ostream& os);
+  static bool WriteChromeTrace(const char* filename);
+
+protected:
+  vtkPVEventTraceLog();
+  ~vtkPVEventTraceLog();
+
+  static bool Enabled;
+
+private:
+  vtkPVEventTraceLog(const vtkPVEventTraceLog&); // Not implemented
+  void operator=(const vtkPVEventTraceLog&); // Not implemented
+};
+
+//BTX
+// Description:
+// Helper to trace the lifetime of a C++ scope.
+class VTKPVVTKEXTENSIONSCORE_EXPORT vtkPVEventTraceScope
+{
+public:
+  vtkPVEventTraceScope(const char* name) : Name(name)
+    {
+    if (vtkPVEventTraceLog::GetEnabled())
+      {
+      vtkPVEventTraceLog::BeginScope(name);
+      }
+    }
+  ~vtkPVEventTraceScope()
+    {
+    if (vtkPVEventTraceLog::GetEnabled())
+      {
+      vtkPVEventTraceLog::EndScope(this->Name);
+      }
+    }
+
+private:
+  const char* Name;
+  vtkPVEventTraceScope(const vtkPVEventTraceScope&); // Not implemented
+  void operator=(const vtkPVEventTraceScope&); // Not implemented
+};
+//ETX
+
+#endif
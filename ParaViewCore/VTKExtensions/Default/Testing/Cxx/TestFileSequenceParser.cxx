@@ -0,0 +1,91 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestFileSequenceParser.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the sequence names and indices vtkFileSequenceParser extracts for
+// each of its patterns, including names without digits, against the results
+// of the regular expressions it used to be implemented with.
+
+#include "vtkFileSequenceParser.h"
+#include "vtkNew.h"
+
+#include <iostream>
+#include <string>
+
+namespace
+{
+  struct ExpectedSequence
+    {
+    const char* File;
+    bool Match;
+    const char* Name;
+    int Index;
+    };
+
+  const ExpectedSequence Expected[] =
+    {
+    // "name.N"
+    { "data.0005", true, "data", 5 },
+    { "a.b.12", true, "a.b", 12 },
+    // "name_N.ext", "name.N.ext", "name-N.ext"
+    { "foo_12.vtk", true, "foo_..vtk", 12 },
+    { "foo.7.vtu", true, "foo...vtu", 7 },
+    { "a-1.2.vtk", true, "a-1...vtk", 2 },
+    // "nameN.ext"
+    { "foo12.vtk", true, "foo..vtk", 12 },
+    // "N_name.ext", "Nname.ext"
+    { "12_foo.vtk", true, ".._foo.vtk", 12 },
+    { "3foo.vtk", true, "..foo.vtk", 3 },
+    // last number anywhere
+    { "run5out", true, "run..out", 5 },
+    // names without digits: the sequence numbers may contain dots.
+    { "Z..", true, "Z", 0 },
+    { "a.b..", true, "a.b", 0 },
+    { "...", true, ".", 0 },
+    { ".a.b", true, "..a.b", 0 },
+    { "x_..vtk", true, "x_..vtk", 0 },
+    // not sequences
+    { "readme.txt", false, NULL, 0 },
+    { ".bashrc", false, NULL, 0 },
+    { "12", false, NULL, 0 },
+    { "", false, NULL, 0 },
+    };
+}
+
+int TestFileSequenceParser(int, char*[])
+{
+  vtkNew<vtkFileSequenceParser> parser;
+  int status = EXIT_SUCCESS;
+  for (size_t cc = 0; cc < sizeof(Expected) / sizeof(Expected[0]); ++cc)
+    {
+    const ExpectedSequence& expected = Expected[cc];
+    bool match = parser->ParseFileSequence(expected.File);
+    if (match != expected.Match)
+      {
+      std::cerr << "\"" << expected.File << "\": expected "
+                << (expected.Match? "a match" : "no match") << std::endl;
+      status = EXIT_FAILURE;
+      continue;
+      }
+    if (match && (std::string(parser->GetSequenceName()) != expected.Name ||
+        parser->GetSequenceIndex() != expected.Index))
+      {
+      std::cerr << "\"" << expected.File << "\": expected \""
+                << expected.Name << "\" (" << expected.Index << "), got \""
+                << parser->GetSequenceName() << "\" ("
+                << parser->GetSequenceIndex() << ")" << std::endl;
+      status = EXIT_FAILURE;
+      }
+    }
+  return status;
+}
@@ -0,0 +1,372 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestIntegrateAttributes.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Integrates grids of mixed 3D and mixed 2D cells, large enough to span
+// several of the chunks vtkIntegrateAttributes splits the cells into, with
+// different numbers of vtkSMPTools threads. The results must be bitwise
+// identical. The volume and area are also checked, within round-off, against
+// the serial integration of the previous implementation: every cell is
+// triangulated and the signed volumes of the tetrahedra, or the areas of the
+// triangles, are summed up one after the other.
+//
+// Note that some vtkSMPTools backends (TBB) only honor the first call to
+// vtkSMPTools::Initialize(). The later runs then still schedule the chunks
+// differently, which must not change the result either.
+
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkDummyController.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkIntegrateAttributes.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSMPTools.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+  // Affine, right handed, map of the lattice so that the cells are neither
+  // axis aligned nor regular, but keep planar faces.
+  void LatticePoint(int i, int j, int k, double h, double x[3])
+    {
+    x[0] = h * (1.0 * i + 0.3 * j + 0.1 * k);
+    x[1] = h * (1.1 * j + 0.2 * k);
+    x[2] = h * (0.9 * k - 0.05 * i);
+    }
+
+  void AddArrays(vtkUnstructuredGrid* grid)
+    {
+    vtkNew<vtkDoubleArray> pointValues;
+    pointValues->SetName("PointValue");
+    pointValues->SetNumberOfTuples(grid->GetNumberOfPoints());
+    for (vtkIdType cc = 0; cc < grid->GetNumberOfPoints(); ++cc)
+      {
+      double x[3];
+      grid->GetPoint(cc, x);
+      pointValues->SetValue(cc, cos(3.0 * x[0]) + x[1] * x[2] + 0.1);
+      }
+    grid->GetPointData()->AddArray(pointValues.GetPointer());
+
+    vtkNew<vtkDoubleArray> cellValues;
+    cellValues->SetName("CellValue");
+    cellValues->SetNumberOfComponents(2);
+    cellValues->SetNumberOfTuples(grid->GetNumberOfCells());
+    for (vtkIdType cc = 0; cc < grid->GetNumberOfCells(); ++cc)
+      {
+      cellValues->SetComponent(cc, 0, 0.1 * cc);
+      cellValues->SetComponent(cc, 1, 1.0 / (cc + 3));
+      }
+    grid->GetCellData()->AddArray(cellValues.GetPointer());
+    }
+
+  // Each cell of an n^3 lattice becomes, in turn, a hexahedron, two wedges,
+  // three pyramids or six tetrahedra.
+  void Build3DGrid(vtkUnstructuredGrid* grid, int n)
+    {
+    const double h = 1.0 / n;
+    vtkNew<vtkPoints> points;
+    points->SetDataTypeToDouble();
+    for (int k = 0; k <= n; ++k)
+      {
+      for (int j = 0; j <= n; ++j)
+        {
+        for (int i = 0; i <= n; ++i)
+          {
+          double x[3];
+          LatticePoint(i, j, k, h, x);
+          points->InsertNextPoint(x);
+          }
+        }
+      }
+    grid->SetPoints(points.GetPointer());
+    grid->Allocate(6 * n * n * n);
+
+    const vtkIdType n1 = n + 1;
+    for (int k = 0; k < n; ++k)
+      {
+      for (int j = 0; j < n; ++j)
+        {
+        for (int i = 0; i < n; ++i)
+          {
+          vtkIdType p0 = i + n1 * (j + n1 * k);
+          vtkIdType p[8] = {
+            p0, p0 + 1, p0 + 1 + n1, p0 + n1,
+            p0 + n1 * n1, p0 + 1 + n1 * n1, p0 + 1 + n1 + n1 * n1,
+            p0 + n1 + n1 * n1 };
+          switch ((i + 2 * j + 3 * k) % 4)
+            {
+            case 0:
+              grid->InsertNextCell(VTK_HEXAHEDRON, 8, p);
+              break;
+            case 1:
+              {
+              vtkIdType w0[6] = { p[0], p[2], p[1], p[4], p[6], p[5] };
+              vtkIdType w1[6] = { p[0], p[3], p[2], p[4], p[7], p[6] };
+              grid->InsertNextCell(VTK_WEDGE, 6, w0);
+              grid->InsertNextCell(VTK_WEDGE, 6, w1);
+              }
+              break;
+            case 2:
+              {
+              vtkIdType y0[5] = { p[0], p[1], p[2], p[3], p[6] };
+              vtkIdType y1[5] = { p[0], p[4], p[5], p[1], p[6] };
+              vtkIdType y2[5] = { p[0], p[3], p[7], p[4], p[6] };
+              grid->InsertNextCell(VTK_PYRAMID, 5, y0);
+              grid->InsertNextCell(VTK_PYRAMID, 5, y1);
+              grid->InsertNextCell(VTK_PYRAMID, 5, y2);
+              }
+              break;
+            default:
+              {
+              const int tets[6][4] = {
+                { 0, 1, 2, 6 }, { 0, 2, 3, 6 }, { 0, 3, 7, 6 },
+                { 0, 7, 4, 6 }, { 0, 4, 5, 6 }, { 0, 5, 1, 6 } };
+              for (int cc = 0; cc < 6; ++cc)
+                {
+                vtkIdType t[4] = { p[tets[cc][0]], p[tets[cc][1]],
+                  p[tets[cc][2]], p[tets[cc][3]] };
+                grid->InsertNextCell(VTK_TETRA, 4, t);
+                }
+              }
+            }
+          }
+        }
+      }
+    AddArrays(grid);
+    }
+
+  // Each cell of an n^2 lattice on a tilted plane becomes, in turn, a quad,
+  // two triangles, a triangle strip, a polygon or a quadratic triangle and a
+  // triangle. The lattice is padded with a few vertices, ignored when
+  // integrating areas.
+  void Build2DGrid(vtkUnstructuredGrid* grid, int n)
+    {
+    const double h = 1.0 / n;
+    vtkNew<vtkPoints> points;
+    points->SetDataTypeToFloat();
+    for (int j = 0; j <= n; ++j)
+      {
+      for (int i = 0; i <= n; ++i)
+        {
+        double x[3];
+        LatticePoint(i, j, 0, h, x);
+        points->InsertNextPoint(x);
+        }
+      }
+    grid->SetPoints(points.GetPointer());
+    grid->Allocate(2 * n * n + 4);
+
+    for (vtkIdType cc = 0; cc < 4; ++cc)
+      {
+      grid->InsertNextCell(VTK_VERTEX, 1, &cc);
+      }
+
+    const vtkIdType n1 = n + 1;
+    for (int j = 0; j < n; ++j)
+      {
+      for (int i = 0; i < n; ++i)
+        {
+        vtkIdType p0 = i + n1 * j;
+        vtkIdType p[4] = { p0, p0 + 1, p0 + 1 + n1, p0 + n1 };
+        switch ((i + 3 * j) % 5)
+          {
+          case 0:
+            grid->InsertNextCell(VTK_QUAD, 4, p);
+            break;
+          case 1:
+            {
+            vtkIdType t0[3] = { p[0], p[1], p[2] };
+            vtkIdType t1[3] = { p[0], p[2], p[3] };
+            grid->InsertNextCell(VTK_TRIANGLE, 3, t0);
+            grid->InsertNextCell(VTK_TRIANGLE, 3, t1);
+            }
+            break;
+          case 2:
+            {
+            vtkIdType s[4] = { p[0], p[1], p[3], p[2] };
+            grid->InsertNextCell(VTK_TRIANGLE_STRIP, 4, s);
+            }
+            break;
+          case 3:
+            grid->InsertNextCell(VTK_POLYGON, 4, p);
+            break;
+          default:
+            {
+            // the mid-edge points of the quadratic triangle.
+            double x0[3], x1[3], x2[3], m[3];
+            grid->GetPoint(p[0], x0);
+            grid->GetPoint(p[1], x1);
+            grid->GetPoint(p[2], x2);
+            vtkIdType q[6] = { p[0], p[1], p[2], 0, 0, 0 };
+            for (int c = 0; c < 3; ++c) { m[c] = 0.5 * (x0[c] + x1[c]); }
+            q[3] = points->InsertNextPoint(m);
+            for (int c = 0; c < 3; ++c) { m[c] = 0.5 * (x1[c] + x2[c]); }
+            q[4] = points->InsertNextPoint(m);
+            for (int c = 0; c < 3; ++c) { m[c] = 0.5 * (x2[c] + x0[c]); }
+            q[5] = points->InsertNextPoint(m);
+            grid->InsertNextCell(VTK_QUADRATIC_TRIANGLE, 6, q);
+            vtkIdType t[3] = { p[0], p[2], p[3] };
+            grid->InsertNextCell(VTK_TRIANGLE, 3, t);
+            }
+          }
+        }
+      }
+    AddArrays(grid);
+    }
+
+  // The previous, serial, integration of the volume or area.
+  double IntegrateSerially(vtkUnstructuredGrid* grid, int dimension)
+    {
+    vtkNew<vtkGenericCell> cell;
+    vtkNew<vtkIdList> ptIds;
+    vtkNew<vtkPoints> cellPoints;
+    double sum = 0.0;
+    for (vtkIdType cellId = 0; cellId < grid->GetNumberOfCells(); ++cellId)
+      {
+      grid->GetCell(cellId, cell.GetPointer());
+      if (cell->GetCellDimension() != dimension)
+        {
+        continue;
+        }
+      cell->Triangulate(1, ptIds.GetPointer(), cellPoints.GetPointer());
+      for (vtkIdType cc = 0; cc + dimension < ptIds->GetNumberOfIds();
+        cc += dimension + 1)
+        {
+        double pts[4][3];
+        for (int p = 0; p <= dimension; ++p)
+          {
+          grid->GetPoint(ptIds->GetId(cc + p), pts[p]);
+          }
+        double a[3], b[3], n[3];
+        for (int i = 0; i < 3; ++i)
+          {
+          a[i] = pts[1][i] - pts[0][i];
+          b[i] = pts[2][i] - pts[0][i];
+          }
+        vtkMath::Cross(a, b, n);
+        if (dimension == 2)
+          {
+          sum += vtkMath::Norm(n) * 0.5;
+          }
+        else
+          {
+          double c[3];
+          for (int i = 0; i < 3; ++i)
+            {
+            c[i] = pts[3][i] - pts[0][i];
+            }
+          sum += vtkMath::Dot(c, n) / 6.0;
+          }
+        }
+      }
+    return sum;
+    }
+
+  // All the values of the output, point and cell arrays.
+  std::vector<double> Integrate(vtkUnstructuredGrid* grid, int numThreads)
+    {
+    vtkSMPTools::Initialize(numThreads);
+
+    vtkNew<vtkDummyController> controller;
+    vtkNew<vtkIntegrateAttributes> integrator;
+    integrator->SetController(controller.GetPointer());
+    integrator->SetInputData(grid);
+    integrator->Update();
+
+    vtkUnstructuredGrid* output = integrator->GetOutput();
+    std::vector<double> values;
+    vtkDataSetAttributes* dsas[2] = {
+      output->GetPointData(), output->GetCellData() };
+    for (int cc = 0; cc < 2; ++cc)
+      {
+      for (int i = 0; i < dsas[cc]->GetNumberOfArrays(); ++i)
+        {
+        vtkDataArray* array = dsas[cc]->GetArray(i);
+        for (int j = 0; j < array->GetNumberOfComponents(); ++j)
+          {
+          values.push_back(array->GetComponent(0, j));
+          }
+        }
+      }
+    double x[3];
+    output->GetPoint(0, x);
+    values.insert(values.end(), x, x + 3);
+    return values;
+    }
+
+  bool CheckGrid(vtkUnstructuredGrid* grid, int dimension, const char* name)
+    {
+    // the most threads first, for backends that only honor the first
+    // vtkSMPTools::Initialize().
+    const int threads[4] = { 8, 3, 2, 1 };
+    std::vector<double> reference = Integrate(grid, threads[0]);
+    for (int cc = 0; cc < 4; ++cc)
+      {
+      // twice per thread count, the chunks may be scheduled differently.
+      for (int repeat = 0; repeat < 2; ++repeat)
+        {
+        if (Integrate(grid, threads[cc]) != reference)
+          {
+          cerr << "The integrals of " << name << " with " << threads[cc]
+            << " threads differ from those with " << threads[0] << " threads."
+            << endl;
+          return false;
+          }
+        }
+      }
+
+    vtkNew<vtkDummyController> controller;
+    vtkNew<vtkIntegrateAttributes> integrator;
+    integrator->SetController(controller.GetPointer());
+    integrator->SetInputData(grid);
+    integrator->Update();
+    vtkDataArray* sum = integrator->GetOutput()->GetCellData()->GetArray(
+      dimension == 2? "Area" : "Volume");
+    double expected = IntegrateSerially(grid, dimension);
+    if (!sum || fabs(sum->GetComponent(0, 0) - expected) >
+      4 * VTK_DBL_EPSILON * grid->GetNumberOfCells() * fabs(expected))
+      {
+      cerr.precision(17);
+      cerr << "The " << (dimension == 2? "area" : "volume") << " of " << name
+        << " is " << (sum? sum->GetComponent(0, 0) : 0.0) << " instead of "
+        << expected << "." << endl;
+      return false;
+      }
+    return true;
+    }
+}
+
+int TestIntegrateAttributes(int, char*[])
+{
+  // more than 16384 cells in both, hence several chunks.
+  vtkNew<vtkUnstructuredGrid> grid3D;
+  Build3DGrid(grid3D.GetPointer(), 24);
+  vtkNew<vtkUnstructuredGrid> grid2D;
+  Build2DGrid(grid2D.GetPointer(), 120);
+
+  if (!CheckGrid(grid3D.GetPointer(), 3, "mixed 3D cells") ||
+    !CheckGrid(grid2D.GetPointer(), 2, "mixed 2D cells"))
+    {
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
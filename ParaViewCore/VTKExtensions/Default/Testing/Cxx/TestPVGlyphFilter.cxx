@@ -0,0 +1,184 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVGlyphFilter.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Glyphs a point cloud with the SPATIALLY_UNIFORM_DISTRIBUTION mode and checks
+// the glyphed points against a brute-force search for the closest point to
+// each sample point. The points are then moved, slightly and then a lot, and
+// the filter, which keeps its point locator between executions, is checked
+// again.
+
+#include "vtkBoundingBox.h"
+#include "vtkMath.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPVGlyphFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+  const int NumberOfSamplePoints = 500;
+  const int Seed = 7;
+
+  // Ids of the points vtkPVGlyphFilter is expected to glyph: for each sample
+  // point, the closest point within the search radius, ties going to the
+  // smallest id.
+  std::vector<vtkIdType> GetExpectedIds(vtkPoints* points)
+    {
+    vtkBoundingBox bounds(points->GetBounds());
+    double side = std::sqrt(bounds.GetDiagonalLength());
+    double delta = std::pow(side * side * side / NumberOfSamplePoints, 1.0/3.0);
+    double radius = std::pow(2 * delta, 1.0/2.0) / 2.0;
+
+    vtkNew<vtkMinimalStandardRandomSequence> random;
+    random->SetSeed(Seed);
+    std::vector<vtkIdType> ids;
+    for (int cc = 0; cc < NumberOfSamplePoints; ++cc)
+      {
+      double sample[3];
+      for (int i = 0; i < 3; ++i)
+        {
+        random->Next();
+        sample[i] = random->GetRangeValue(
+          bounds.GetMinPoint()[i], bounds.GetMaxPoint()[i]);
+        }
+      double best = radius * radius;
+      vtkIdType bestId = -1;
+      for (vtkIdType ptId = 0; ptId < points->GetNumberOfPoints(); ++ptId)
+        {
+        double dist2 =
+          vtkMath::Distance2BetweenPoints(points->GetPoint(ptId), sample);
+        if (dist2 < best || (bestId == -1 && dist2 == best))
+          {
+          best = dist2;
+          bestId = ptId;
+          }
+        }
+      if (bestId >= 0)
+        {
+        ids.push_back(bestId);
+        }
+      }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    return ids;
+    }
+
+  // The glyph is a single point at the origin, so the output points are the
+  // glyphed input points, in increasing id order.
+  bool CheckGlyphs(vtkPVGlyphFilter* glyph, vtkPoints* points, const char* step)
+    {
+    glyph->Update();
+    vtkPolyData* output = vtkPolyData::SafeDownCast(glyph->GetOutput());
+    std::vector<vtkIdType> expected = GetExpectedIds(points);
+    if (expected.empty() ||
+      output->GetNumberOfPoints() != static_cast<vtkIdType>(expected.size()))
+      {
+      std::cerr << step << ": expected " << expected.size() << " glyphs, got "
+                << output->GetNumberOfPoints() << std::endl;
+      return false;
+      }
+    for (size_t cc = 0; cc < expected.size(); ++cc)
+      {
+      double actual[3], point[3];
+      output->GetPoint(static_cast<vtkIdType>(cc), actual);
+      points->GetPoint(expected[cc], point);
+      if (actual[0] != point[0] || actual[1] != point[1] ||
+        actual[2] != point[2])
+        {
+        std::cerr << step << ": glyph " << cc << " is not at point "
+                  << expected[cc] << std::endl;
+        return false;
+        }
+      }
+    return true;
+    }
+}
+
+int TestPVGlyphFilter(int, char*[])
+{
+  // points on a lattice, so that many are equally close to a sample point.
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+  for (int cc = 0; cc < 20000; ++cc)
+    {
+    double pt[3];
+    for (int i = 0; i < 3; ++i)
+      {
+      random->Next();
+      pt[i] = std::floor(random->GetRangeValue(0, 40)) * 0.25;
+      }
+    points->InsertNextPoint(pt);
+    }
+  vtkNew<vtkPolyData> input;
+  input->SetPoints(points.GetPointer());
+
+  vtkNew<vtkPoints> glyphPoints;
+  glyphPoints->InsertNextPoint(0, 0, 0);
+  vtkNew<vtkPolyData> glyphSource;
+  glyphSource->SetPoints(glyphPoints.GetPointer());
+
+  vtkNew<vtkPVGlyphFilter> glyph;
+  glyph->SetInputData(input.GetPointer());
+  glyph->SetSourceData(glyphSource.GetPointer());
+  glyph->SetGlyphMode(vtkPVGlyphFilter::SPATIALLY_UNIFORM_DISTRIBUTION);
+  glyph->SetMaximumNumberOfSamplePoints(NumberOfSamplePoints);
+  glyph->SetSeed(Seed);
+
+  if (!CheckGlyphs(glyph.GetPointer(), points.GetPointer(), "initial"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // re-executing without changing the points reuses the locator.
+  glyph->Modified();
+  if (!CheckGlyphs(glyph.GetPointer(), points.GetPointer(), "re-execution"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // small moves, most points stay in their bins.
+  for (vtkIdType cc = 0; cc < points->GetNumberOfPoints(); ++cc)
+    {
+    double pt[3];
+    points->GetPoint(cc, pt);
+    pt[0] += (cc % 3) * 0.01;
+    points->SetPoint(cc, pt);
+    }
+  points->Modified();
+  if (!CheckGlyphs(glyph.GetPointer(), points.GetPointer(), "small moves"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // large moves, changing the bounds and the bins of most points.
+  for (vtkIdType cc = 0; cc < points->GetNumberOfPoints(); ++cc)
+    {
+    double pt[3];
+    points->GetPoint(cc, pt);
+    points->SetPoint(cc, pt[1] * 2.0, pt[2], pt[0] * 0.5 - 3.0);
+    }
+  points->Modified();
+  if (!CheckGlyphs(glyph.GetPointer(), points.GetPointer(), "large moves"))
+    {
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,304 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestParallelSerialWriterIOGroups.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Writes one small polydata per process with vtkParallelSerialWriter for
+// several IO group configurations and checks that every group wrote its own
+// file holding exactly the data of its processes, and that the reported
+// number of bytes written matches the files.
+
+#include "vtkAppendPolyData.h"
+#include "vtkCellArray.h"
+#include "vtkClientServerInterpreter.h"
+#include "vtkClientServerStream.h"
+#include "vtkIntArray.h"
+#include "vtkMPIController.h"
+#include "vtkNew.h"
+#include "vtkParallelSerialWriter.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkTestUtilities.h"
+#include "vtkXMLPolyDataReader.h"
+#include "vtkXMLPolyDataWriter.h"
+
+#include <vtksys/ios/sstream>
+#include <vtksys/SystemInformation.hxx>
+#include <vtksys/SystemTools.hxx>
+
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+  const int MaxHostNameLength = 256;
+
+  // Stands in for the client-server wrapping of the internal writer, which
+  // vtkParallelSerialWriter invokes through an interpreter.
+  int WriterCommand(vtkClientServerInterpreter*, vtkObjectBase* ptr,
+    const char* method, const vtkClientServerStream& msg,
+    vtkClientServerStream&, void*)
+  {
+    vtkXMLPolyDataWriter* writer = vtkXMLPolyDataWriter::SafeDownCast(ptr);
+    if (writer && strcmp(method, "SetFileName") == 0)
+      {
+      const char* fname = NULL;
+      if (msg.GetArgument(0, 2, &fname))
+        {
+        writer->SetFileName(fname);
+        return 1;
+        }
+      }
+    else if (writer && strcmp(method, "Write") == 0)
+      {
+      writer->Write();
+      return 1;
+      }
+    return 0;
+  }
+
+  // rank+1 vertices, all with a "Rank" point array set to the rank.
+  void MakeLocalData(vtkPolyData* pd, int rank)
+  {
+    vtkNew<vtkPoints> points;
+    vtkNew<vtkCellArray> verts;
+    vtkNew<vtkIntArray> ranks;
+    ranks->SetName("Rank");
+    for (int cc = 0; cc <= rank; ++cc)
+      {
+      vtkIdType id = points->InsertNextPoint(rank, cc, 0);
+      verts->InsertNextCell(1, &id);
+      ranks->InsertNextValue(rank);
+      }
+    pd->SetPoints(points.GetPointer());
+    pd->SetVerts(verts.GetPointer());
+    pd->GetPointData()->AddArray(ranks.GetPointer());
+  }
+
+  std::string GetFileName(const std::string& prefix, int group, int numGroups)
+  {
+    vtksys_ios::ostringstream fname;
+    fname << prefix;
+    if (numGroups > 1)
+      {
+      fname << "_" << group;
+      }
+    fname << ".vtp";
+    return fname.str();
+  }
+
+  void RemoveFiles(const std::string& prefix, int numProcs)
+  {
+    vtksys::SystemTools::RemoveFile(GetFileName(prefix, 0, 1).c_str());
+    for (int cc = 0; cc <= numProcs; ++cc)
+      {
+      vtksys::SystemTools::RemoveFile(
+        GetFileName(prefix, cc, numProcs + 1).c_str());
+      }
+  }
+
+  // Checks the file written by a group on the root process.
+  bool CheckFile(const std::string& fname, const std::vector<int>& ranks)
+  {
+    if (!vtksys::SystemTools::FileExists(fname.c_str(), true))
+      {
+      cerr << "Missing file " << fname << endl;
+      return false;
+      }
+    vtkNew<vtkXMLPolyDataReader> reader;
+    reader->SetFileName(fname.c_str());
+    reader->Update();
+    vtkPolyData* pd = reader->GetOutput();
+    vtkIntArray* array = vtkIntArray::SafeDownCast(
+      pd->GetPointData()->GetArray("Rank"));
+
+    // every process contributes rank+1 points.
+    std::map<int, vtkIdType> expected;
+    vtkIdType expectedPoints = 0;
+    for (size_t cc = 0; cc < ranks.size(); ++cc)
+      {
+      expected[ranks[cc]] = ranks[cc] + 1;
+      expectedPoints += ranks[cc] + 1;
+      }
+    if (array == NULL || pd->GetNumberOfPoints() != expectedPoints)
+      {
+      cerr << fname << ": expected " << expectedPoints << " points, got "
+        << pd->GetNumberOfPoints() << endl;
+      return false;
+      }
+    std::map<int, vtkIdType> found;
+    for (vtkIdType cc = 0; cc < array->GetNumberOfTuples(); ++cc)
+      {
+      found[array->GetValue(cc)]++;
+      }
+    if (found != expected)
+      {
+      cerr << fname << " does not hold the data of the expected processes."
+        << endl;
+      return false;
+      }
+    return true;
+  }
+
+  // Writes with the given configuration and checks that the processes of
+  // `groups[i]` were written to the i-th file.
+  bool TestConfiguration(vtkMultiProcessController* controller,
+    vtkPolyData* localData, const std::string& prefix, int numberOfIOGroups,
+    int groupByNode, const std::vector<std::vector<int> >& groups)
+  {
+    int rank = controller->GetLocalProcessId();
+    int numProcs = controller->GetNumberOfProcesses();
+    if (rank == 0)
+      {
+      RemoveFiles(prefix, numProcs);
+      }
+    controller->Barrier();
+
+    vtkNew<vtkClientServerInterpreter> interpreter;
+    interpreter->AddCommandFunction("vtkXMLPolyDataWriter", WriterCommand);
+    vtkNew<vtkXMLPolyDataWriter> internalWriter;
+    vtkNew<vtkAppendPolyData> append;
+
+    vtkNew<vtkParallelSerialWriter> writer;
+    writer->SetInterpreter(interpreter.GetPointer());
+    writer->SetWriter(internalWriter.GetPointer());
+    writer->SetPostGatherHelper(append.GetPointer());
+    writer->SetFileNameMethod("SetFileName");
+    writer->SetFileName((prefix + ".vtp").c_str());
+    writer->SetPiece(rank);
+    writer->SetNumberOfPieces(numProcs);
+    writer->SetNumberOfIOGroups(numberOfIOGroups);
+    writer->SetGroupByNode(groupByNode);
+    writer->SetInputData(localData);
+    writer->Write();
+    controller->Barrier();
+
+    int status = 1;
+    if (rank == 0)
+      {
+      int numGroups = static_cast<int>(groups.size());
+      double bytes = 0.0;
+      for (int cc = 0; cc < numGroups && status; ++cc)
+        {
+        std::string fname = GetFileName(prefix, cc, numGroups);
+        status = CheckFile(fname, groups[cc]);
+        bytes += static_cast<double>(
+          vtksys::SystemTools::FileLength(fname.c_str()));
+        }
+      // no other file may have been written.
+      std::string extra = numGroups > 1?
+        GetFileName(prefix, numGroups, numGroups) : GetFileName(prefix, 0, 2);
+      if (status && (vtksys::SystemTools::FileExists(extra.c_str(), true) ||
+          (numGroups > 1 && vtksys::SystemTools::FileExists(
+              GetFileName(prefix, 0, 1).c_str(), true))))
+        {
+        cerr << "Unexpected files were written." << endl;
+        status = 0;
+        }
+      if (status && writer->GetLastBytesWritten() != bytes)
+        {
+        cerr << "Reported " << writer->GetLastBytesWritten()
+          << " bytes written instead of " << bytes << endl;
+        status = 0;
+        }
+      if (!status)
+        {
+        cerr << "Failed with NumberOfIOGroups=" << numberOfIOGroups
+          << " and GroupByNode=" << groupByNode << endl;
+        }
+      RemoveFiles(prefix, numProcs);
+      }
+    controller->Broadcast(&status, 1, 0);
+    return status != 0;
+  }
+
+  // Contiguous ranks split in min(numberOfIOGroups, numProcs) groups.
+  std::vector<std::vector<int> > RankGroups(int numProcs, int numberOfIOGroups)
+  {
+    int numGroups = numberOfIOGroups < numProcs? numberOfIOGroups : numProcs;
+    std::vector<std::vector<int> > groups(numGroups);
+    for (int cc = 0; cc < numProcs; ++cc)
+      {
+      groups[(cc * numGroups) / numProcs].push_back(cc);
+      }
+    return groups;
+  }
+
+  // One group per host, in the order of the first process of each host.
+  std::vector<std::vector<int> > NodeGroups(
+    vtkMultiProcessController* controller)
+  {
+    int numProcs = controller->GetNumberOfProcesses();
+    vtksys::SystemInformation sysinfo;
+    std::vector<char> hostname(MaxHostNameLength, '\0');
+    strncpy(&hostname[0], sysinfo.GetHostname(), MaxHostNameLength - 1);
+    std::vector<char> hostnames(MaxHostNameLength * numProcs);
+    controller->AllGather(&hostname[0], &hostnames[0], MaxHostNameLength);
+
+    std::vector<std::string> hosts;
+    std::vector<std::vector<int> > groups;
+    for (int cc = 0; cc < numProcs; ++cc)
+      {
+      std::string host = &hostnames[cc * MaxHostNameLength];
+      size_t node = 0;
+      while (node < hosts.size() && hosts[node] != host)
+        {
+        node++;
+        }
+      if (node == hosts.size())
+        {
+        hosts.push_back(host);
+        groups.push_back(std::vector<int>());
+        }
+      groups[node].push_back(cc);
+      }
+    return groups;
+  }
+}
+
+int TestParallelSerialWriterIOGroups(int argc, char* argv[])
+{
+  vtkMPIController* controller = vtkMPIController::New();
+  controller->Initialize(&argc, &argv, 0);
+  vtkMultiProcessController::SetGlobalController(controller);
+
+  int rank = controller->GetLocalProcessId();
+  int numProcs = controller->GetNumberOfProcesses();
+
+  char* tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  std::string prefix = std::string(tempDir) + "/TestParallelSerialWriterIOGroups";
+  delete [] tempDir;
+
+  vtkNew<vtkPolyData> localData;
+  MakeLocalData(localData.GetPointer(), rank);
+
+  bool success =
+    // everything in a single file, as before.
+    TestConfiguration(controller, localData.GetPointer(), prefix, 1, 0,
+      RankGroups(numProcs, 1)) &&
+    TestConfiguration(controller, localData.GetPointer(), prefix, 2, 0,
+      RankGroups(numProcs, 2)) &&
+    // more groups than processes: one file per process.
+    TestConfiguration(controller, localData.GetPointer(), prefix,
+      numProcs + 3, 0, RankGroups(numProcs, numProcs + 3)) &&
+    // one file per node.
+    TestConfiguration(controller, localData.GetPointer(), prefix, 0, 1,
+      NodeGroups(controller));
+
+  controller->Finalize();
+  controller->Delete();
+  return success? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -25,6 +25,10 @@ vtk_module(vtkPVVTKExtensionsDefault
     vtknetcdf
     vtksys
     vtkChartsCore
+  TEST_DEPENDS
+    vtkTestingCore
+  TEST_LABELS
+    PARAVIEW
   KIT
     vtkPVExtensions
 )
@@ -21,6 +21,7 @@
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkReductionFilter.h"
 #include "vtkSmartPointer.h"
 #include "vtkTable.h"
 #include "vtkDataArray.h"
@@ -35,6 +36,9 @@ vtkAttributeDataReductionFilter::vtkAttributeDataReductionFilter()
   this->AttributeType = vtkAttributeDataReductionFilter::POINT_DATA |
     vtkAttributeDataReductionFilter::CELL_DATA |
     vtkAttributeDataReductionFilter::ROW_DATA;
+
+  // sum, max and min are all associative, see vtkReductionFilter.
+  this->GetInformation()->Set(vtkReductionFilter::ASSOCIATIVE(), 1);
 }
 
 //-----------------------------------------------------------------------------
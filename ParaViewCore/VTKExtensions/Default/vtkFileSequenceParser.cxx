@@ -16,30 +16,149 @@
 
 #include "vtkObjectFactory.h"
 
-#include <vtksys/SystemTools.hxx>
-#include <vtksys/RegularExpression.hxx>
-#include <set>
+#include <stdlib.h>
 #include <string>
 
+namespace
+{
+  inline bool IsSequenceChar(char c)
+    {
+    return (c >= '0' && c <= '9') || c == '.';
+    }
+
+  inline bool IsDigit(char c)
+    {
+    return c >= '0' && c <= '9';
+    }
+
+  inline bool IsAlpha(char c)
+    {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+
+  inline bool IsSeparator(char c)
+    {
+    return c == '.' || c == '_' || c == '-';
+    }
+
+  // Each of the following matches a file name against one of the sequence
+  // patterns (see vtkFileSequenceParser::ParseFileSequence()) in a single
+  // scan, with the same (leftmost, greedy) results as the equivalent regular
+  // expressions.
+
+  // "^(.*)\.([0-9.]+)$"
+  bool MatchTrailingNumber(const std::string& file, std::string& name,
+    std::string& index)
+    {
+    size_t n = file.size();
+    size_t start = n;
+    while (start > 0 && IsSequenceChar(file[start-1]))
+      {
+      --start;
+      }
+    for (size_t pos = n; pos > start + 1; --pos)
+      {
+      if (file[pos - 2] == '.')
+        {
+        name = file.substr(0, pos - 2);
+        index = file.substr(pos - 1);
+        return true;
+        }
+      }
+    return false;
+    }
+
+  // "^(.*)(X)([0-9.]+)\.(.*)$" where X is a separator (`alpha` false) or a
+  // letter (`alpha` true).
+  bool MatchNumberBeforeExtension(const std::string& file, bool alpha,
+    std::string& name, std::string& index)
+    {
+    size_t n = file.size();
+    // end of the run of sequence characters starting at each position.
+    std::string::size_type runEnd = n;
+    for (size_t pos = n; pos > 0; --pos)
+      {
+      size_t sep = pos - 1;
+      // runEnd is the end of the run starting at sep + 1.
+      if (sep + 1 < n && !IsSequenceChar(file[sep + 1]))
+        {
+        runEnd = sep + 1;
+        }
+      if (alpha? !IsAlpha(file[sep]) : !IsSeparator(file[sep]))
+        {
+        continue;
+        }
+      // the number ends at the last '.' in the run, leaving at least one
+      // character of number.
+      for (size_t dot = runEnd; dot > sep + 2; --dot)
+        {
+        if (file[dot - 1] == '.')
+          {
+          name = file.substr(0, sep + 1) + ".." + file.substr(dot);
+          index = file.substr(sep + 1, dot - 1 - (sep + 1));
+          return true;
+          }
+        }
+      }
+    return false;
+    }
+
+  // "^([0-9.]+)(X)(.*)\.(.*)$" where X is a separator (`alpha` false) or a
+  // letter (`alpha` true).
+  bool MatchNumberAtStart(const std::string& file, bool alpha,
+    std::string& name, std::string& index)
+    {
+    size_t n = file.size();
+    size_t runEnd = 0;
+    while (runEnd < n && IsSequenceChar(file[runEnd]))
+      {
+      ++runEnd;
+      }
+    size_t lastDot = file.rfind('.');
+    if (lastDot == std::string::npos)
+      {
+      return false;
+      }
+    for (size_t sep = runEnd; sep >= 1; --sep)
+      {
+      if (sep < n && (alpha? IsAlpha(file[sep]) : IsSeparator(file[sep])) &&
+        lastDot > sep)
+        {
+        name = ".." + file.substr(sep, lastDot - sep) + file.substr(lastDot);
+        index = file.substr(0, sep);
+        return true;
+        }
+      }
+    return false;
+    }
+
+  // "^(.*[^0-9])([0-9]+)([^0-9]+)$"
+  bool MatchLastNumber(const std::string& file, std::string& name,
+    std::string& index)
+    {
+    size_t end = file.size();
+    while (end > 0 && !IsDigit(file[end - 1]))
+      {
+      --end;
+      }
+    size_t start = end;
+    while (start > 0 && IsDigit(file[start - 1]))
+      {
+      --start;
+      }
+    if (end == file.size() || start == end || start == 0)
+      {
+      return false;
+      }
+    name = file.substr(0, start) + ".." + file.substr(end);
+    index = file.substr(start, end - start);
+    return true;
+    }
+}
+
 vtkStandardNewMacro(vtkFileSequenceParser);
 //-----------------------------------------------------------------------------
 vtkFileSequenceParser::vtkFileSequenceParser() :
-  // sequence ending with numbers.
-  reg_ex( new vtksys::RegularExpression("^(.*)\\.([0-9.]+)$")),
-  // sequence ending with extension.
-  reg_ex2( new vtksys::RegularExpression("^(.*)(\\.|_|-)([0-9.]+)\\.(.*)$")),
-  // sequence ending with extension, but with no ". or _" before
-  // the series number.
-  reg_ex3( new vtksys::RegularExpression("^(.*)([a-zA-Z])([0-9.]+)\\.(.*)$")),
-  // sequence ending with extension, and starting with series number
-  // followed by ". or _".
-  reg_ex4( new vtksys::RegularExpression("^([0-9.]+)(\\.|_|-)(.*)\\.(.*)$")),
-  // sequence ending with extension, and starting with series number,
-  // but not followed by ". or _".
-  reg_ex5( new vtksys::RegularExpression("^([0-9.]+)([a-zA-Z])(.*)\\.(.*)$")),
-  // fallback: any sequence with a number in the middle (taking the last number
-  // if multiple exist).
-  reg_ex_last( new vtksys::RegularExpression("^(.*[^0-9])([0-9]+)([^0-9]+)$")),
   SequenceIndex(-1),
   SequenceName(NULL)
 {
@@ -48,58 +167,43 @@ vtkFileSequenceParser::vtkFileSequenceParser() :
 //-----------------------------------------------------------------------------
 vtkFileSequenceParser::~vtkFileSequenceParser()
 {
-  delete this->reg_ex;
-  delete this->reg_ex2;
-  delete this->reg_ex3;
-  delete this->reg_ex4;
-  delete this->reg_ex5;
-  delete this->reg_ex_last;
-
   this->SetSequenceName(NULL);
 }
 
-
 //-----------------------------------------------------------------------------
-bool vtkFileSequenceParser::ParseFileSequence(char * file)
+bool vtkFileSequenceParser::ParseFileSequence(const char * file)
 {
-  bool match = false;
-  if (this->reg_ex->find(file))
-    {
-    this->SetSequenceName(this->reg_ex->match(1).c_str());
-    this->SequenceIndex = atoi(reg_ex->match(2).c_str());
-    match = true;
-    }
-  else if (this->reg_ex2->find(file))
-    {
-    this->SetSequenceName(std::string(this->reg_ex2->match(1) + this->reg_ex2->match(2) + ".." + this->reg_ex2->match(4)).c_str());
-    this->SequenceIndex = atoi(reg_ex2->match(3).c_str());
-    match = true;
-    }
-  else if (this->reg_ex3->find(file))
+  if (!file)
     {
-    this->SetSequenceName(std::string(this->reg_ex3->match(1) + this->reg_ex3->match(2) + ".." + this->reg_ex3->match(4)).c_str());
-    this->SequenceIndex = atoi(reg_ex3->match(3).c_str());
-    match = true;
+    return false;
     }
-  else if (this->reg_ex4->find(file))
-    {
-    this->SetSequenceName(std::string(".." + this->reg_ex4->match(2) + this->reg_ex4->match(3) + "." + this->reg_ex4->match(4)).c_str());
-    this->SequenceIndex = atoi(reg_ex4->match(1).c_str());
-    match = true;
-    }
-  else if (this->reg_ex5->find(file))
+
+  // without a digit, only names containing ".." or starting with a '.'
+  // followed by another '.' can match (e.g. "Z..", ".a.b"): [0-9.]+ also
+  // matches dots. Most names that are not part of a sequence are rejected
+  // here.
+  const std::string filename(file);
+  if (filename.find_first_of("0123456789") == std::string::npos &&
+    filename.find("..") == std::string::npos &&
+    (filename[0] != '.' || filename.find('.', 1) == std::string::npos))
     {
-    this->SetSequenceName(std::string(".." + this->reg_ex5->match(2) + this->reg_ex5->match(3) + "." + this->reg_ex5->match(4)).c_str());
-    this->SequenceIndex = atoi(reg_ex5->match(1).c_str());
-    match = true;
+    return false;
     }
-  else if (this->reg_ex_last->find(file))
+
+  std::string name;
+  std::string index;
+  if (MatchTrailingNumber(filename, name, index) ||
+    MatchNumberBeforeExtension(filename, false, name, index) ||
+    MatchNumberBeforeExtension(filename, true, name, index) ||
+    MatchNumberAtStart(filename, false, name, index) ||
+    MatchNumberAtStart(filename, true, name, index) ||
+    MatchLastNumber(filename, name, index))
     {
-    this->SetSequenceName(std::string(this->reg_ex_last->match(1) + ".." + this->reg_ex_last->match(3)).c_str());
-    this->SequenceIndex = atoi(reg_ex_last->match(2).c_str());
-    match = true;
+    this->SetSequenceName(name.c_str());
+    this->SequenceIndex = atoi(index.c_str());
+    return true;
     }
-  return match;
+  return false;
 }
 
 //-----------------------------------------------------------------------------
@@ -27,11 +27,6 @@
 #include "vtkPVVTKExtensionsDefaultModule.h" //needed for exports
 #include "vtkObject.h"
 
-namespace vtksys {
-  class RegularExpression;
-}
-
-
 class VTKPVVTKEXTENSIONSDEFAULT_EXPORT vtkFileSequenceParser : public vtkObject
 {
 public:
@@ -43,7 +38,13 @@ public:
   // Extract base file name sequence from the file.
   // Returns true if a sequence is detected and
   // sets SequenceName and SequenceIndex.
-  bool ParseFileSequence(char * file);
+  // The name is matched, in order, against patterns for a number at the end
+  // ("name.N"), before the extension ("name_N.ext", "nameN.ext"), at the
+  // start ("N_name.ext", "Nname.ext") and finally the last number anywhere in
+  // the name. Each pattern is checked in a single scan of the name. As the
+  // sequence numbers may contain dots, names without digits such as "Z.."
+  // (index 0) also match.
+  bool ParseFileSequence(const char * file);
 
   vtkGetStringMacro(SequenceName);
   vtkGetMacro(SequenceIndex, int);
@@ -52,13 +53,6 @@ protected:
   vtkFileSequenceParser();
   ~vtkFileSequenceParser();
 
-  vtksys::RegularExpression * reg_ex;
-  vtksys::RegularExpression * reg_ex2;
-  vtksys::RegularExpression * reg_ex3;
-  vtksys::RegularExpression * reg_ex4;
-  vtksys::RegularExpression * reg_ex5;
-  vtksys::RegularExpression * reg_ex_last;
-
   // Used internall so char * allocations are done automatically.
   vtkSetStringMacro(SequenceName);
 
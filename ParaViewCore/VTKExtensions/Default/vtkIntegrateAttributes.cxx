@@ -19,8 +19,10 @@
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataPipeline.h"
 #include "vtkCompositeDataSet.h"
+#include "vtkDataArrayTemplate.h"
 #include "vtkDataSet.h"
 #include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
@@ -28,12 +30,16 @@
 #include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
-#include "vtkPointData.h"
-#include "vtkPolygon.h"
-#include "vtkTriangle.h"
+#include "vtkPoints.h"
+#include "vtkPointSet.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 vtkStandardNewMacro(vtkIntegrateAttributes);
 
@@ -46,6 +52,686 @@ public:
       { this->vtkDataSetAttributes::FieldList::SetFieldIndex(i, index); }
 };
 
+namespace
+{
+  // Cells are integrated in chunks of this size. Each chunk has its own
+  // partial sums which are added in chunk order, hence the result does not
+  // depend on the number of threads.
+  const vtkIdType vtkIntegrationChunkSize = 16384;
+
+  // Running sum with a correction term for the rounding error of every
+  // addition (Neumaier's variant of Kahan summation). Summing millions of
+  // cell contributions that way gives results close to the exactly rounded
+  // sum regardless of the order in which they are added.
+  class vtkCompensatedSum
+  {
+  public:
+    vtkCompensatedSum(double value = 0.0) : Sum(value), Correction(0.0) {}
+
+    void Add(double value)
+      {
+      double t = this->Sum + value;
+      if (fabs(this->Sum) >= fabs(value))
+        {
+        this->Correction += (this->Sum - t) + value;
+        }
+      else
+        {
+        this->Correction += (value - t) + this->Sum;
+        }
+      this->Sum = t;
+      }
+
+    void Add(const vtkCompensatedSum& other)
+      {
+      this->Add(other.Sum);
+      this->Correction += other.Correction;
+      }
+
+    double GetValue() const { return this->Sum + this->Correction; }
+
+  private:
+    double Sum;
+    double Correction;
+  };
+
+  // The integrated quantities: length, area or volume, the weighted center
+  // and all the components of the output point (0) and cell (1) arrays, in
+  // the order of the arrays in the output.
+  class vtkIntegrals
+  {
+  public:
+    vtkIntegrals() : Dimension(0), NumberOfSkippedCells(0) {}
+
+    void Initialize(size_t numPointValues, size_t numCellValues)
+      {
+      this->Attributes[0].resize(numPointValues);
+      this->Attributes[1].resize(numCellValues);
+      this->Dimension = 0;
+      this->NumberOfSkippedCells = 0;
+      this->Zero();
+      }
+
+    void Zero()
+      {
+      this->Sum = vtkCompensatedSum();
+      for (int i = 0; i < 3; ++i)
+        {
+        this->SumCenter[i] = vtkCompensatedSum();
+        }
+      for (int i = 0; i < 2; ++i)
+        {
+        std::fill(this->Attributes[i].begin(), this->Attributes[i].end(),
+          vtkCompensatedSum());
+        }
+      }
+
+    // Same as vtkIntegrateAttributes::CompareIntegrationDimension().
+    bool CompareIntegrationDimension(int dim)
+      {
+      if (this->Dimension < dim)
+        {
+        this->Zero();
+        this->Dimension = dim;
+        return true;
+        }
+      return (this->Dimension == dim);
+      }
+
+    // Adds the integrals of another set of cells. The higher dimension
+    // prevails.
+    void Add(const vtkIntegrals& other)
+      {
+      this->NumberOfSkippedCells += other.NumberOfSkippedCells;
+      if (!this->CompareIntegrationDimension(other.Dimension))
+        {
+        return;
+        }
+      this->Sum.Add(other.Sum);
+      for (int i = 0; i < 3; ++i)
+        {
+        this->SumCenter[i].Add(other.SumCenter[i]);
+        }
+      for (int i = 0; i < 2; ++i)
+        {
+        for (size_t j = 0; j < this->Attributes[i].size(); ++j)
+          {
+          this->Attributes[i][j].Add(other.Attributes[i][j]);
+          }
+        }
+      }
+
+    int Dimension;
+    vtkCompensatedSum Sum;
+    vtkCompensatedSum SumCenter[3];
+    std::vector<vtkCompensatedSum> Attributes[2];
+    vtkIdType NumberOfSkippedCells;
+  };
+
+  // An input array to integrate. Pointer is the raw data of the array, if it
+  // has a contiguous layout, and Offset the position of its first component
+  // in vtkIntegrals::Attributes.
+  struct vtkFieldArray
+  {
+    vtkDataArray* Array;
+    void* Pointer;
+    int DataType;
+    int NumberOfComponents;
+    size_t Offset;
+  };
+
+  //---------------------------------------------------------------------------
+  template <class T>
+  void* vtkGetArrayPointer(vtkDataArray* array, T*)
+    {
+    vtkDataArrayTemplate<T>* typedArray =
+      dynamic_cast<vtkDataArrayTemplate<T>*>(array);
+    return typedArray? typedArray->GetPointer(0) : NULL;
+    }
+
+  //---------------------------------------------------------------------------
+  void* vtkGetArrayPointer(vtkDataArray* array)
+    {
+    switch (array->GetDataType())
+      {
+      vtkTemplateMacro(
+        return vtkGetArrayPointer(array, static_cast<VTK_TT*>(NULL)));
+      }
+    return NULL;
+    }
+
+  //---------------------------------------------------------------------------
+  // Returns the total number of components of the arrays in `dsa`.
+  size_t vtkCountValues(vtkDataSetAttributes* dsa)
+    {
+    size_t count = 0;
+    for (int i = 0; i < dsa->GetNumberOfArrays(); ++i)
+      {
+      vtkDataArray* array = dsa->GetArray(i);
+      count += array? array->GetNumberOfComponents() : 0;
+      }
+    return count;
+    }
+
+  //---------------------------------------------------------------------------
+  // Collects the arrays of `inda` listed in `fieldList`, with the position
+  // of their components among the values of the output arrays in `outda`.
+  void vtkCollectFieldArrays(vtkDataSetAttributes* inda,
+    vtkDataSetAttributes* outda, vtkDataSetAttributes::FieldList& fieldList,
+    int index, std::vector<vtkFieldArray>& arrays)
+    {
+    std::vector<size_t> offsets(outda->GetNumberOfArrays() + 1, 0);
+    for (int i = 0; i < outda->GetNumberOfArrays(); ++i)
+      {
+      vtkDataArray* outArray = outda->GetArray(i);
+      offsets[i + 1] = offsets[i] +
+        (outArray? outArray->GetNumberOfComponents() : 0);
+      }
+
+    arrays.clear();
+    for (int i = 0; i < fieldList.GetNumberOfFields(); ++i)
+      {
+      int outIndex = fieldList.GetFieldIndex(i);
+      if (outIndex < 0)
+        {
+        continue;
+        }
+      vtkDataArray* inArray = inda->GetArray(fieldList.GetDSAIndex(index, i));
+      if (!inArray)
+        {
+        continue;
+        }
+      vtkFieldArray field;
+      field.Array = inArray;
+      field.Pointer = vtkGetArrayPointer(inArray);
+      field.DataType = field.Pointer? inArray->GetDataType() : VTK_VOID;
+      field.NumberOfComponents = inArray->GetNumberOfComponents();
+      field.Offset = offsets[outIndex];
+      arrays.push_back(field);
+      }
+    }
+
+  //---------------------------------------------------------------------------
+  // Adds `k` times the average of the tuples `ids` of an array to `sums`.
+  template <class T>
+  void vtkIntegrateValues(const T* data, int numComps,
+    const vtkIdType* ids, int numIds, double k, vtkCompensatedSum* sums)
+    {
+    for (int j = 0; j < numComps; ++j)
+      {
+      double v = 0.0;
+      for (int p = 0; p < numIds; ++p)
+        {
+        v += static_cast<double>(data[ids[p]*numComps + j]);
+        }
+      sums[j].Add(v / numIds * k);
+      }
+    }
+
+  //---------------------------------------------------------------------------
+  void vtkIntegrateValues(vtkDataArray* array, int numComps,
+    const vtkIdType* ids, int numIds, double k, vtkCompensatedSum* sums)
+    {
+    for (int j = 0; j < numComps; ++j)
+      {
+      double v = 0.0;
+      for (int p = 0; p < numIds; ++p)
+        {
+        v += array->GetComponent(ids[p], j);
+        }
+      sums[j].Add(v / numIds * k);
+      }
+    }
+
+  // Five tetrahedra filling a hexahedron.
+  const int vtkHexahedronTetras[5][4] = {
+    {0, 1, 3, 4}, {1, 2, 3, 6}, {1, 4, 5, 6}, {3, 4, 6, 7}, {1, 3, 4, 6} };
+
+  // Integrates the cells of a dataset, one chunk of vtkIntegrationChunkSize
+  // cells at a time. The dataset is only read, with per thread scratch
+  // objects, hence chunks can be integrated concurrently.
+  class vtkIntegrateCellsFunctor
+  {
+  public:
+    vtkIntegrateCellsFunctor(vtkDataSet* input,
+      const std::vector<vtkFieldArray>& pointArrays,
+      const std::vector<vtkFieldArray>& cellArrays,
+      size_t numPointValues, size_t numCellValues,
+      std::vector<vtkIntegrals>& chunks) :
+      Input(input),
+      Ghosts(input->GetCellGhostArray()),
+      FloatPoints(NULL),
+      DoublePoints(NULL),
+      PointArrays(pointArrays),
+      CellArrays(cellArrays),
+      NumberOfPointValues(numPointValues),
+      NumberOfCellValues(numCellValues),
+      Chunks(chunks)
+      {
+      // Read the coordinates of point sets directly.
+      vtkPointSet* ps = vtkPointSet::SafeDownCast(input);
+      if (ps && ps->GetPoints())
+        {
+        vtkDataArray* coords = ps->GetPoints()->GetData();
+        if (coords->GetDataType() == VTK_FLOAT)
+          {
+          this->FloatPoints = static_cast<float*>(
+            vtkGetArrayPointer(coords, static_cast<float*>(NULL)));
+          }
+        else if (coords->GetDataType() == VTK_DOUBLE)
+          {
+          this->DoublePoints = static_cast<double*>(
+            vtkGetArrayPointer(coords, static_cast<double*>(NULL)));
+          }
+        }
+      }
+
+    //-------------------------------------------------------------------------
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      vtkIdList* ptIds = this->PointIds.Local();
+      vtkGenericCell* cell = this->Cell.Local();
+      vtkPoints* cellPoints = this->CellPoints.Local();
+      vtkIdType numCells = this->Input->GetNumberOfCells();
+      for (vtkIdType chunk = begin; chunk < end; ++chunk)
+        {
+        vtkIntegrals& sums = this->Chunks[chunk];
+        sums.Initialize(this->NumberOfPointValues, this->NumberOfCellValues);
+        vtkIdType last = std::min(numCells, (chunk + 1)*vtkIntegrationChunkSize);
+        for (vtkIdType cellId = chunk*vtkIntegrationChunkSize; cellId < last;
+          ++cellId)
+          {
+          this->IntegrateCell(sums, cellId, ptIds, cell, cellPoints);
+          }
+        }
+      }
+
+  private:
+    //-------------------------------------------------------------------------
+    void GetPoint(vtkIdType ptId, double x[3]) const
+      {
+      if (this->FloatPoints)
+        {
+        const float* p = this->FloatPoints + 3*ptId;
+        x[0] = p[0]; x[1] = p[1]; x[2] = p[2];
+        }
+      else if (this->DoublePoints)
+        {
+        const double* p = this->DoublePoints + 3*ptId;
+        x[0] = p[0]; x[1] = p[1]; x[2] = p[2];
+        }
+      else
+        {
+        this->Input->GetPoint(ptId, x);
+        }
+      }
+
+    //-------------------------------------------------------------------------
+    void IntegrateData(const std::vector<vtkFieldArray>& arrays,
+      std::vector<vtkCompensatedSum>& sums, const vtkIdType* ids, int numIds,
+      double k) const
+      {
+      for (size_t cc = 0; cc < arrays.size(); ++cc)
+        {
+        const vtkFieldArray& field = arrays[cc];
+        vtkCompensatedSum* fieldSums = &sums[field.Offset];
+        switch (field.DataType)
+          {
+          vtkTemplateMacro(
+            vtkIntegrateValues(static_cast<const VTK_TT*>(field.Pointer),
+              field.NumberOfComponents, ids, numIds, k, fieldSums));
+          default:
+            vtkIntegrateValues(field.Array, field.NumberOfComponents,
+              ids, numIds, k, fieldSums);
+          }
+        }
+      }
+
+    //-------------------------------------------------------------------------
+    void IntegrateCell(vtkIntegrals& sums, vtkIdType cellId, vtkIdList* ptIds,
+      vtkGenericCell* cell, vtkPoints* cellPoints)
+      {
+      // Make sure we are not integrating ghost cells.
+      if (this->Ghosts &&
+        this->Ghosts->GetValue(cellId) & vtkDataSetAttributes::DUPLICATECELL)
+        {
+        return;
+        }
+
+      switch (this->Input->GetCellType(cellId))
+        {
+        // skip empty or 0D Cells
+        case VTK_EMPTY_CELL:
+        case VTK_VERTEX:
+        case VTK_POLY_VERTEX:
+          break;
+
+        case VTK_POLY_LINE:
+        case VTK_LINE:
+          if (sums.CompareIntegrationDimension(1))
+            {
+            this->Input->GetCellPoints(cellId, ptIds);
+            for (vtkIdType i = 0; i + 1 < ptIds->GetNumberOfIds(); ++i)
+              {
+              this->IntegrateLine(sums, cellId,
+                ptIds->GetId(i), ptIds->GetId(i+1));
+              }
+            }
+          break;
+
+        case VTK_TRIANGLE:
+          if (sums.CompareIntegrationDimension(2))
+            {
+            this->Input->GetCellPoints(cellId, ptIds);
+            this->IntegrateTriangle(sums, cellId,
+              ptIds->GetId(0), ptIds->GetId(1), ptIds->GetId(2));
+            }
+          break;
+
+        case VTK_TRIANGLE_STRIP:
+          if (sums.CompareIntegrationDimension(2))
+            {
+            this->Input->GetCellPoints(cellId, ptIds);
+            for (vtkIdType i = 0; i + 2 < ptIds->GetNumberOfIds(); ++i)
+              {
+              this->IntegrateTriangle(sums, cellId,
+                ptIds->GetId(i), ptIds->GetId(i+1), ptIds->GetId(i+2));
+              }
+            }
+          break;
+
+        case VTK_POLYGON:
+          // Works for convex polygons, and interpolation is not correct.
+          if (sums.CompareIntegrationDimension(2))
+            {
+            this->Input->GetCellPoints(cellId, ptIds);
+            for (vtkIdType i = 1; i + 1 < ptIds->GetNumberOfIds(); ++i)
+              {
+              this->IntegrateTriangle(sums, cellId,
+                ptIds->GetId(0), ptIds->GetId(i), ptIds->GetId(i+1));
+              }
+            }
+          break;
+
+        case VTK_PIXEL:
+          if (sums.CompareIntegrationDimension(2))
+            {
+            this->Input->GetCellPoints(cellId, ptIds);
+            this->IntegratePixel(sums, cellId, ptIds);
+            }
+          break;
+
+        case VTK_QUAD:
+          if (sums.CompareIntegrationDimension(2))
+            {
+            this->Input->GetCellPoints(cellId, ptIds);
+            this->IntegrateTriangle(sums, cellId,
+              ptIds->GetId(0), ptIds->GetId(1), ptIds->GetId(2));
+            this->IntegrateTriangle(sums, cellId,
+              ptIds->GetId(0), ptIds->GetId(3), ptIds->GetId(2));
+            }
+          break;
+
+        case VTK_VOXEL:
+          if (sums.CompareIntegrationDimension(3))
+            {
+            this->Input->GetCellPoints(cellId, ptIds);
+            this->IntegrateVoxel(sums, cellId, ptIds);
+            }
+          break;
+
+        case VTK_TETRA:
+          if (sums.CompareIntegrationDimension(3))
+            {
+            this->Input->GetCellPoints(cellId, ptIds);
+            this->IntegrateTetrahedron(sums, cellId, ptIds->GetId(0),
+              ptIds->GetId(1), ptIds->GetId(2), ptIds->GetId(3));
+            }
+          break;
+
+        case VTK_HEXAHEDRON:
+          if (sums.CompareIntegrationDimension(3))
+            {
+            this->Input->GetCellPoints(cellId, ptIds);
+            for (int i = 0; i < 5; ++i)
+              {
+              const int* tet = vtkHexahedronTetras[i];
+              this->IntegrateTetrahedron(sums, cellId,
+                ptIds->GetId(tet[0]), ptIds->GetId(tet[1]),
+                ptIds->GetId(tet[2]), ptIds->GetId(tet[3]));
+              }
+            }
+          break;
+
+        default:
+          this->IntegrateGeneralCell(sums, cellId, ptIds, cell, cellPoints);
+        }
+      }
+
+    //-------------------------------------------------------------------------
+    // Integrates the simplices of the triangulation of any other cell.
+    void IntegrateGeneralCell(vtkIntegrals& sums, vtkIdType cellId,
+      vtkIdList* ptIds, vtkGenericCell* cell, vtkPoints* cellPoints)
+      {
+      this->Input->GetCell(cellId, cell);
+      int cellDim = cell->GetCellDimension();
+      if (cellDim < 1 || cellDim > 3 ||
+        !sums.CompareIntegrationDimension(cellDim))
+        {
+        return;
+        }
+
+      cell->Triangulate(1, ptIds, cellPoints);
+      // There should be 2, 3 or 4 points for each simplex.
+      vtkIdType nPnts = ptIds->GetNumberOfIds();
+      if (nPnts % (cellDim + 1))
+        {
+        sums.NumberOfSkippedCells++;
+        return;
+        }
+
+      const vtkIdType* ids = ptIds->GetPointer(0);
+      for (vtkIdType i = 0; i < nPnts; i += cellDim + 1)
+        {
+        switch (cellDim)
+          {
+          case 1:
+            this->IntegrateLine(sums, cellId, ids[i], ids[i+1]);
+            break;
+          case 2:
+            this->IntegrateTriangle(sums, cellId, ids[i], ids[i+1], ids[i+2]);
+            break;
+          case 3:
+            this->IntegrateTetrahedron(sums, cellId,
+              ids[i], ids[i+1], ids[i+2], ids[i+3]);
+            break;
+          }
+        }
+      }
+
+    //-------------------------------------------------------------------------
+    void IntegrateLine(vtkIntegrals& sums, vtkIdType cellId,
+      vtkIdType pt1Id, vtkIdType pt2Id)
+      {
+      double pt1[3], pt2[3];
+      this->GetPoint(pt1Id, pt1);
+      this->GetPoint(pt2Id, pt2);
+
+      // Compute the length of the line.
+      double length = sqrt(vtkMath::Distance2BetweenPoints(pt1, pt2));
+      sums.Sum.Add(length);
+
+      // Add the middle, which is really just another attribute, weighted to
+      // sumCenter.
+      for (int i = 0; i < 3; ++i)
+        {
+        sums.SumCenter[i].Add((pt1[i]+pt2[i])*0.5*length);
+        }
+
+      // Now integrate the rest of the attributes.
+      const vtkIdType ids[2] = { pt1Id, pt2Id };
+      this->IntegrateData(this->PointArrays, sums.Attributes[0], ids, 2, length);
+      this->IntegrateData(this->CellArrays, sums.Attributes[1], &cellId, 1,
+        length);
+      }
+
+    //-------------------------------------------------------------------------
+    void IntegrateTriangle(vtkIntegrals& sums, vtkIdType cellId,
+      vtkIdType pt1Id, vtkIdType pt2Id, vtkIdType pt3Id)
+      {
+      double pt1[3], pt2[3], pt3[3];
+      double v1[3], v2[3], cross[3];
+      this->GetPoint(pt1Id, pt1);
+      this->GetPoint(pt2Id, pt2);
+      this->GetPoint(pt3Id, pt3);
+
+      // Use the cross product of two legs to compute the area of the
+      // parallelogram.
+      for (int i = 0; i < 3; ++i)
+        {
+        v1[i] = pt2[i] - pt1[i];
+        v2[i] = pt3[i] - pt1[i];
+        }
+      vtkMath::Cross(v1, v2, cross);
+      double k =
+        sqrt(cross[0]*cross[0] + cross[1]*cross[1] + cross[2]*cross[2]) * 0.5;
+      if (k == 0.0)
+        {
+        return;
+        }
+      sums.Sum.Add(k);
+
+      for (int i = 0; i < 3; ++i)
+        {
+        sums.SumCenter[i].Add((pt1[i]+pt2[i]+pt3[i])/3.0*k);
+        }
+
+      const vtkIdType ids[3] = { pt1Id, pt2Id, pt3Id };
+      this->IntegrateData(this->PointArrays, sums.Attributes[0], ids, 3, k);
+      this->IntegrateData(this->CellArrays, sums.Attributes[1], &cellId, 1, k);
+      }
+
+    //-------------------------------------------------------------------------
+    // For axis aligned rectangular cells
+    void IntegratePixel(vtkIntegrals& sums, vtkIdType cellId, vtkIdList* ptIds)
+      {
+      double pts[4][3];
+      for (int i = 0; i < 4; ++i)
+        {
+        this->GetPoint(ptIds->GetId(i), pts[i]);
+        }
+
+      // get the lengths of its 2 orthogonal sides.  Since only 1 coordinate
+      // can be different we can add the differences in all 3 directions
+      double l = (pts[0][0] - pts[1][0]) + (pts[0][1] - pts[1][1]) +
+        (pts[0][2] - pts[1][2]);
+      double w = (pts[0][0] - pts[2][0]) + (pts[0][1] - pts[2][1]) +
+        (pts[0][2] - pts[2][2]);
+      double a = fabs(l*w);
+      sums.Sum.Add(a);
+
+      for (int i = 0; i < 3; ++i)
+        {
+        sums.SumCenter[i].Add(
+          (pts[0][i]+pts[1][i]+pts[2][i]+pts[3][i])*0.25*a);
+        }
+
+      this->IntegrateData(this->PointArrays, sums.Attributes[0],
+        ptIds->GetPointer(0), 4, a);
+      this->IntegrateData(this->CellArrays, sums.Attributes[1], &cellId, 1, a);
+      }
+
+    //-------------------------------------------------------------------------
+    void IntegrateTetrahedron(vtkIntegrals& sums, vtkIdType cellId,
+      vtkIdType pt1Id, vtkIdType pt2Id, vtkIdType pt3Id, vtkIdType pt4Id)
+      {
+      double pts[4][3];
+      this->GetPoint(pt1Id, pts[0]);
+      this->GetPoint(pt2Id, pts[1]);
+      this->GetPoint(pt3Id, pts[2]);
+      this->GetPoint(pt4Id, pts[3]);
+
+      // Compute the principle vectors around pt0 and the centroid
+      double a[3], b[3], c[3], n[3], mid[3];
+      for (int i = 0; i < 3; ++i)
+        {
+        a[i] = pts[1][i] - pts[0][i];
+        b[i] = pts[2][i] - pts[0][i];
+        c[i] = pts[3][i] - pts[0][i];
+        mid[i] = (pts[0][i]+pts[1][i]+pts[2][i]+pts[3][i])*0.25;
+        }
+
+      // Calulate the volume of the tet which is 1/6 * the box product
+      vtkMath::Cross(a, b, n);
+      double v = vtkMath::Dot(c, n) / 6.0;
+      sums.Sum.Add(v);
+
+      for (int i = 0; i < 3; ++i)
+        {
+        sums.SumCenter[i].Add(mid[i]*v);
+        }
+
+      const vtkIdType ids[4] = { pt1Id, pt2Id, pt3Id, pt4Id };
+      this->IntegrateData(this->CellArrays, sums.Attributes[1], &cellId, 1, v);
+      this->IntegrateData(this->PointArrays, sums.Attributes[0], ids, 4, v);
+      }
+
+    //-------------------------------------------------------------------------
+    // For axis aligned hexahedral cells
+    void IntegrateVoxel(vtkIntegrals& sums, vtkIdType cellId, vtkIdList* ptIds)
+      {
+      const vtkIdType* ids = ptIds->GetPointer(0);
+      double pts[8][3];
+      for (int i = 0; i < 8; ++i)
+        {
+        this->GetPoint(ids[i], pts[i]);
+        }
+
+      // Calulate the volume of the voxel
+      double l = pts[1][0] - pts[0][0];
+      double w = pts[2][1] - pts[0][1];
+      double h = pts[4][2] - pts[0][2];
+      double v = fabs(l*w*h);
+      sums.Sum.Add(v);
+
+      for (int i = 0; i < 3; ++i)
+        {
+        double mid = 0.0;
+        for (int j = 0; j < 8; ++j)
+          {
+          mid += pts[j][i];
+          }
+        sums.SumCenter[i].Add(mid*0.125*v);
+        }
+
+      this->IntegrateData(this->CellArrays, sums.Attributes[1], &cellId, 1, v);
+      this->IntegrateData(this->PointArrays, sums.Attributes[0], ids, 8, v);
+      }
+
+    vtkDataSet* Input;
+    vtkUnsignedCharArray* Ghosts;
+    const float* FloatPoints;
+    const double* DoublePoints;
+    const std::vector<vtkFieldArray>& PointArrays;
+    const std::vector<vtkFieldArray>& CellArrays;
+    size_t NumberOfPointValues;
+    size_t NumberOfCellValues;
+    std::vector<vtkIntegrals>& Chunks;
+
+    vtkSMPThreadLocalObject<vtkIdList> PointIds;
+    vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+    vtkSMPThreadLocalObject<vtkPoints> CellPoints;
+  };
+}
+
+class vtkIntegrateAttributes::vtkInternals
+{
+public:
+  // Integrals of the blocks processed by this process so far, plus those
+  // received from the others on process 0.
+  vtkIntegrals Totals;
+};
+
 //-----------------------------------------------------------------------------
 vtkIntegrateAttributes::vtkIntegrateAttributes()
 {
@@ -54,9 +740,7 @@ vtkIntegrateAttributes::vtkIntegrateAttributes()
   this->SumCenter[0] = this->SumCenter[1] = this->SumCenter[2] = 0.0;
   this->Controller = 0;
 
-  this->PointFieldList = 0;
-  this->CellFieldList = 0;
-  this->FieldListIndex = 0;
+  this->Internals = new vtkInternals();
 
   SetController(vtkMultiProcessController::GetGlobalController());
 }
@@ -69,6 +753,8 @@ vtkIntegrateAttributes::~vtkIntegrateAttributes()
     this->Controller->Delete();
     this->Controller = 0;
     }
+  delete this->Internals;
+  this->Internals = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -114,6 +800,7 @@ int vtkIntegrateAttributes::CompareIntegrationDimension(vtkDataSet* output,
     { // Throw out results from lower dimension.
     this->Sum = 0;
     this->SumCenter[0] = this->SumCenter[1] = this->SumCenter[2] = 0.0;
+    this->Internals->Totals.CompareIntegrationDimension(dim);
     this->ZeroAttributes(output->GetPointData());
     this->ZeroAttributes(output->GetCellData());
     this->IntegrationDimension = dim;
@@ -130,180 +817,85 @@ void vtkIntegrateAttributes::ExecuteBlock(
   vtkIntegrateAttributes::vtkFieldList& pdList,
   vtkIntegrateAttributes::vtkFieldList& cdList)
 {
-  vtkUnsignedCharArray* ghostArray = input->GetCellGhostArray();
-
-  // This is sort of a hack since it's incredibly painful to change all the
-  // signatures to take the pdList, cdList and fieldset_index.
-  this->PointFieldList = &pdList;
-  this->CellFieldList = &cdList;
-  this->FieldListIndex = fieldset_index;
-
-  vtkIdList* cellPtIds = vtkIdList::New();
   vtkIdType numCells = input->GetNumberOfCells();
-  vtkIdType cellId;
-  vtkPoints *cellPoints = 0; // needed if we need to split 3D cells
-  int cellType;
-  for (cellId = 0; cellId < numCells; ++cellId)
+  if (numCells == 0)
     {
-    cellType = input->GetCellType(cellId);
-    // Make sure we are not integrating ghost cells.
-    if (ghostArray && 
-        ghostArray->GetValue(cellId) & vtkDataSetAttributes::DUPLICATECELL)
-      {
-      continue;
-      }
-
-    switch (cellType)
-      {
-      // skip empty or 0D Cells
-      case VTK_EMPTY_CELL:
-      case VTK_VERTEX:
-      case VTK_POLY_VERTEX:
-        break;
-
-      case VTK_POLY_LINE:
-      case VTK_LINE:
-      {
-      if (this->CompareIntegrationDimension(output, 1))
-        {
-        input->GetCellPoints(cellId, cellPtIds);
-        this->IntegratePolyLine(input, output, cellId, cellPtIds);
-        }
-      }
-      break;
-
-      case VTK_TRIANGLE:
-      {
-      if (this->CompareIntegrationDimension(output, 2))
-        {
-        input->GetCellPoints(cellId, cellPtIds);
-        this->IntegrateTriangle(input,output,cellId,cellPtIds->GetId(0),
-                                cellPtIds->GetId(1),cellPtIds->GetId(2));
-        }
-      }
-      break;
-
-      case VTK_TRIANGLE_STRIP:
-      {
-      if (this->CompareIntegrationDimension(output, 2))
-        {
-        input->GetCellPoints(cellId, cellPtIds);
-        this->IntegrateTriangleStrip(input, output, cellId, cellPtIds);
-        }
-      }
-      break;
-
-      case VTK_POLYGON:
-      {
-      if (this->CompareIntegrationDimension(output, 2))
-        {
-        input->GetCellPoints(cellId, cellPtIds);
-        this->IntegratePolygon(input, output, cellId, cellPtIds);
-        }
-      }
-      break;
-
-      case VTK_PIXEL:
-      {
-      if (this->CompareIntegrationDimension(output, 2))
-        {
-        input->GetCellPoints(cellId, cellPtIds);
-        this->IntegratePixel(input, output, cellId, cellPtIds);
-        }
-      }
-      break;
+    return;
+    }
 
-      case VTK_QUAD:
-      {
-      if (this->CompareIntegrationDimension(output, 2))
-        {
-        vtkIdType pt1Id, pt2Id, pt3Id;
-        input->GetCellPoints(cellId, cellPtIds);
-        pt1Id = cellPtIds->GetId(0);
-        pt2Id = cellPtIds->GetId(1);
-        pt3Id = cellPtIds->GetId(2);
-        this->IntegrateTriangle(input, output, cellId, pt1Id, pt2Id, pt3Id);
-        pt2Id = cellPtIds->GetId(3);
-        this->IntegrateTriangle(input, output, cellId, pt1Id, pt2Id, pt3Id);
-        }
-      }
-      break;
+  std::vector<vtkFieldArray> pointArrays;
+  std::vector<vtkFieldArray> cellArrays;
+  vtkCollectFieldArrays(input->GetPointData(), output->GetPointData(),
+    pdList, fieldset_index, pointArrays);
+  vtkCollectFieldArrays(input->GetCellData(), output->GetCellData(),
+    cdList, fieldset_index, cellArrays);
+
+  // Let the dataset build its cell structures (e.g. vtkPolyData's cell map)
+  // before the cells are accessed from several threads.
+  input->GetCellType(0);
+
+  vtkIntegrals& totals = this->Internals->Totals;
+  vtkIdType numChunks =
+    (numCells + vtkIntegrationChunkSize - 1) / vtkIntegrationChunkSize;
+  std::vector<vtkIntegrals> chunks(numChunks);
+  vtkIntegrateCellsFunctor functor(input, pointArrays, cellArrays,
+    totals.Attributes[0].size(), totals.Attributes[1].size(), chunks);
+  vtkSMPTools::For(0, numChunks, 1, functor);
+
+  // Add the chunks in order, the result does not depend on how the chunks
+  // were distributed among the threads.
+  vtkIntegrals block;
+  block.Initialize(totals.Attributes[0].size(), totals.Attributes[1].size());
+  for (vtkIdType cc = 0; cc < numChunks; ++cc)
+    {
+    block.Add(chunks[cc]);
+    }
+  if (block.NumberOfSkippedCells > 0)
+    {
+    vtkWarningMacro("Skipped " << block.NumberOfSkippedCells
+      << " cells with an unexpected number of points in their triangulation.");
+    }
+  block.NumberOfSkippedCells = 0;
 
-      case VTK_VOXEL:
-      {
-      if (this->CompareIntegrationDimension(output, 3))
-        {
-        input->GetCellPoints(cellId, cellPtIds);
-        this->IntegrateVoxel(input, output, cellId, cellPtIds);
-        }
-      }
-      break;
+  if (block.Dimension > 0 &&
+    this->CompareIntegrationDimension(output, block.Dimension))
+    {
+    totals.Add(block);
+    }
+}
 
-      case VTK_TETRA:
-      {
-      if (this->CompareIntegrationDimension(output, 3))
-        {
-        vtkIdType pt1Id, pt2Id, pt3Id, pt4Id;
-        input->GetCellPoints(cellId, cellPtIds);
-        pt1Id = cellPtIds->GetId(0);
-        pt2Id = cellPtIds->GetId(1);
-        pt3Id = cellPtIds->GetId(2);
-        pt4Id = cellPtIds->GetId(3);
-        this->IntegrateTetrahedron(input, output, cellId, pt1Id, pt2Id,
-                                   pt3Id, pt4Id);
-        }
-      }
-      break;
+//-----------------------------------------------------------------------------
+void vtkIntegrateAttributes::UpdateIntegrals(vtkUnstructuredGrid* output)
+{
+  const vtkIntegrals& totals = this->Internals->Totals;
+  this->Sum = totals.Sum.GetValue();
+  for (int i = 0; i < 3; ++i)
+    {
+    this->SumCenter[i] = totals.SumCenter[i].GetValue();
+    }
 
-      default:
+  vtkDataSetAttributes* attributes[2] =
+    { output->GetPointData(), output->GetCellData() };
+  for (int i = 0; i < 2; ++i)
+    {
+    // Arrays past the integrated values, i.e. the length, area or volume
+    // array, are left alone.
+    size_t offset = 0;
+    for (int a = 0; a < attributes[i]->GetNumberOfArrays(); ++a)
       {
-      // We need to explicitly get the cell
-      vtkCell *cell = input->GetCell(cellId);
-      int cellDim = cell->GetCellDimension();
-      if (cellDim == 0)
+      vtkDataArray* array = attributes[i]->GetArray(a);
+      int numComponents = array? array->GetNumberOfComponents() : 0;
+      if (offset + numComponents > totals.Attributes[i].size())
         {
-        continue;
-        }
-      if (!this->CompareIntegrationDimension(output, cellDim))
-        {
-        continue;
-        }
-
-      // We will need a place to store points from the cell's
-      // triangulate function
-      if (!cellPoints)
-        {
-        cellPoints = vtkPoints::New();
+        break;
         }
-
-      cell->Triangulate(1, cellPtIds, cellPoints);
-      switch (cellDim)
+      for (int j = 0; j < numComponents; ++j)
         {
-        case 1:
-          this->IntegrateGeneral1DCell(input, output, cellId, cellPtIds);
-          break;
-        case 2:
-          this->IntegrateGeneral2DCell(input, output, cellId, cellPtIds);
-          break;
-        case 3:
-          this->IntegrateGeneral3DCell(input, output, cellId, cellPtIds);
-          break;
-        default:
-          vtkWarningMacro("Unsupported Cell Dimension = "
-                          << cellDim);
+        array->SetComponent(0, j, totals.Attributes[i][offset + j].GetValue());
         }
+      offset += numComponents;
       }
-      }
-    }
-  cellPtIds->Delete();
-  if (cellPoints)
-    {
-    cellPoints->Delete();
     }
-
-  this->PointFieldList = NULL;
-  this->CellFieldList = NULL;
-  this->FieldListIndex = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -317,6 +909,7 @@ int vtkIntegrateAttributes::RequestData(vtkInformation*,
   this->SumCenter[0] = this->SumCenter[1] = this->SumCenter[2] = 0.0;
 
   this->IntegrationDimension = 0;
+  this->Internals->Totals.Initialize(0, 0);
 
   vtkInformation* info = outputVector->GetInformationObject(0);
   vtkUnstructuredGrid *output = vtkUnstructuredGrid::SafeDownCast(
@@ -399,6 +992,9 @@ int vtkIntegrateAttributes::RequestData(vtkInformation*,
     // Now initialize the output for the intersected set of arrays.
     this->AllocateAttributes(pdList, output->GetPointData());
     this->AllocateAttributes(cdList, output->GetCellData());
+    this->Internals->Totals.Initialize(
+      vtkCountValues(output->GetPointData()),
+      vtkCountValues(output->GetCellData()));
 
     index = 0;
     // Now execute for each block.
@@ -426,6 +1022,9 @@ int vtkIntegrateAttributes::RequestData(vtkInformation*,
     cdList.InitializeFieldList(dsInput->GetCellData());
     this->AllocateAttributes(pdList, output->GetPointData());
     this->AllocateAttributes(cdList, output->GetCellData());
+    this->Internals->Totals.Initialize(
+      vtkCountValues(output->GetPointData()),
+      vtkCountValues(output->GetCellData()));
     this->ExecuteBlock(dsInput, output, 0, pdList, cdList);
     }
   else
@@ -437,6 +1036,7 @@ int vtkIntegrateAttributes::RequestData(vtkInformation*,
       }
     return 0;
     }
+  this->UpdateIntegrals(output);
 
   // Here is the trick:  The satellites need a point and vertex to
   // marshal the attributes.
@@ -515,6 +1115,14 @@ int vtkIntegrateAttributes::RequestData(vtkInformation*,
         this->ReceivePiece (output, id);
         }
       }
+    this->UpdateIntegrals(output);
+    vtkDataArray* sumArray = output->GetCellData()->GetArray(
+      this->IntegrationDimension == 1? "Length" :
+      this->IntegrationDimension == 2? "Area" : "Volume");
+    if (sumArray && sumArray->GetNumberOfComponents() == 1)
+      {
+      sumArray->SetComponent(0, 0, this->Sum);
+      }
 
     // now that we have all of the sums from each process
     // set the point location with the global value
@@ -591,14 +1199,16 @@ void vtkIntegrateAttributes::ReceivePiece (vtkUnstructuredGrid *mergeTo,
                             vtkIntegrateAttributes::IntegrateAttrData);
   if (this->CompareIntegrationDimension(mergeTo, (int)(msg[0])))
     {
-    this->Sum += msg[1];
-    this->SumCenter[0] += msg[2];
-    this->SumCenter[1] += msg[3];
-    this->SumCenter[2] += msg[4];
+    vtkIntegrals& totals = this->Internals->Totals;
+    totals.Sum.Add(msg[1]);
+    totals.SumCenter[0].Add(msg[2]);
+    totals.SumCenter[1].Add(msg[3]);
+    totals.SumCenter[2].Add(msg[4]);
     this->IntegrateSatelliteData(tmp->GetPointData(),
-                                 mergeTo->GetPointData());
+                                 mergeTo->GetPointData(), 0);
     this->IntegrateSatelliteData(tmp->GetCellData(),
-                                 mergeTo->GetCellData());
+                                 mergeTo->GetCellData(), 1);
+    this->UpdateIntegrals(mergeTo);
     }
   tmp->Delete();
   tmp = 0;
@@ -653,147 +1263,13 @@ void vtkIntegrateAttributes::ZeroAttributes(vtkDataSetAttributes* outda)
     }
 }
 //-----------------------------------------------------------------------------
-void vtkIntegrateAttributes::IntegrateData1(vtkDataSetAttributes* inda,
-  vtkDataSetAttributes* outda,
-  vtkIdType pt1Id, double k,
-  vtkIntegrateAttributes::vtkFieldList& fieldList, int index)
-{
-  int numArrays, i, numComponents, j;
-  vtkDataArray* inArray;
-  vtkDataArray* outArray;
-  numArrays = fieldList.GetNumberOfFields();
-  double vIn1, dv, vOut;
-  for (i = 0; i < numArrays; ++i)
-    {
-    if (fieldList.GetFieldIndex(i) < 0)
-      {
-      continue;
-      }
-    // We could template for speed.
-    inArray = inda->GetArray(fieldList.GetDSAIndex(index, i));
-    outArray = outda->GetArray(fieldList.GetFieldIndex(i));
-    numComponents = inArray->GetNumberOfComponents();
-    for (j = 0; j < numComponents; ++j)
-      {
-      vIn1 = inArray->GetComponent(pt1Id, j);
-      vOut = outArray->GetComponent(0, j);
-      dv = vIn1;
-      vOut += dv*k;
-      outArray->SetComponent(0, j, vOut);
-      }
-    }
-}
-//-----------------------------------------------------------------------------
-void vtkIntegrateAttributes::IntegrateData2(vtkDataSetAttributes* inda,
-  vtkDataSetAttributes* outda,
-  vtkIdType pt1Id, vtkIdType pt2Id, double k,
-  vtkIntegrateAttributes::vtkFieldList& fieldList, int index)
-{
-  int numArrays, i, numComponents, j;
-  vtkDataArray* inArray;
-  vtkDataArray* outArray;
-  numArrays = fieldList.GetNumberOfFields();
-  double vIn1, vIn2, dv, vOut;
-  for (i = 0; i < numArrays; ++i)
-    {
-    if (fieldList.GetFieldIndex(i) < 0)
-      {
-      continue;
-      }
-    // We could template for speed.
-    inArray = inda->GetArray(fieldList.GetDSAIndex(index, i));
-    outArray = outda->GetArray(fieldList.GetFieldIndex(i));
-    numComponents = inArray->GetNumberOfComponents();
-    for (j = 0; j < numComponents; ++j)
-      {
-      vIn1 = inArray->GetComponent(pt1Id, j);
-      vIn2 = inArray->GetComponent(pt2Id, j);
-      vOut = outArray->GetComponent(0, j);
-      dv = 0.5*(vIn1+vIn2);
-      vOut += dv*k;
-      outArray->SetComponent(0, j, vOut);
-      }
-    }
-}
-//-----------------------------------------------------------------------------
-// Is the extra performance worth duplicating this code with IntergrateData2.
-void vtkIntegrateAttributes::IntegrateData3(vtkDataSetAttributes* inda,
-  vtkDataSetAttributes* outda,
-  vtkIdType pt1Id, vtkIdType pt2Id,
-  vtkIdType pt3Id, double k,
-  vtkIntegrateAttributes::vtkFieldList& fieldList, int index)
-{
-  int numArrays, i, numComponents, j;
-  vtkDataArray* inArray;
-  vtkDataArray* outArray;
-  numArrays = fieldList.GetNumberOfFields();
-  double vIn1, vIn2, vIn3, dv, vOut;
-  for (i = 0; i < numArrays; ++i)
-    {
-    if (fieldList.GetFieldIndex(i) < 0)
-      {
-      continue;
-      }
-    // We could template for speed.
-    inArray = inda->GetArray(fieldList.GetDSAIndex(index, i));
-    outArray = outda->GetArray(fieldList.GetFieldIndex(i));
-    numComponents = inArray->GetNumberOfComponents();
-    for (j = 0; j < numComponents; ++j)
-      {
-      vIn1 = inArray->GetComponent(pt1Id, j);
-      vIn2 = inArray->GetComponent(pt2Id, j);
-      vIn3 = inArray->GetComponent(pt3Id, j);
-      vOut = outArray->GetComponent(0, j);
-      dv = (vIn1+vIn2+vIn3)/3.0;
-      vOut += dv*k;
-      outArray->SetComponent(0, j, vOut);
-      }
-    }
-}
-
-//-----------------------------------------------------------------------------
-// Is the extra performance worth duplicating this code with IntergrateData2.
-void vtkIntegrateAttributes::IntegrateData4(vtkDataSetAttributes* inda,
-  vtkDataSetAttributes* outda,
-  vtkIdType pt1Id, vtkIdType pt2Id,
-  vtkIdType pt3Id, vtkIdType pt4Id,
-  double k,
-  vtkIntegrateAttributes::vtkFieldList& fieldList, int index)
-{
-  int numArrays, i, numComponents, j;
-  vtkDataArray* inArray;
-  vtkDataArray* outArray;
-  numArrays = fieldList.GetNumberOfFields();
-  double vIn1, vIn2, vIn3, vIn4, dv, vOut;
-  for (i = 0; i < numArrays; ++i)
-    {
-    if (fieldList.GetFieldIndex(i) < 0)
-      {
-      continue;
-      }
-    // We could template for speed.
-    inArray = inda->GetArray(fieldList.GetDSAIndex(index, i));
-    outArray = outda->GetArray(fieldList.GetFieldIndex(i));
-    numComponents = inArray->GetNumberOfComponents();
-    for (j = 0; j < numComponents; ++j)
-      {
-      vIn1 = inArray->GetComponent(pt1Id, j);
-      vIn2 = inArray->GetComponent(pt2Id, j);
-      vIn3 = inArray->GetComponent(pt3Id, j);
-      vIn4 = inArray->GetComponent(pt4Id, j);
-      vOut = outArray->GetComponent(0, j);
-      dv = (vIn1+vIn2+vIn3+vIn4) * 0.25;
-      vOut += dv*k;
-      outArray->SetComponent(0, j, vOut);
-      }
-    }
-}
-
-//-----------------------------------------------------------------------------
-// Used to sum arrays from all processes.
+// Used to sum arrays from all processes. The sums are accumulated in the
+// point (0) or cell (1) totals, the output arrays are updated by
+// UpdateIntegrals().
 void vtkIntegrateAttributes::IntegrateSatelliteData(
   vtkDataSetAttributes* sendingProcAttributes,
-  vtkDataSetAttributes* proc0Attributes)
+  vtkDataSetAttributes* proc0Attributes,
+  int attributeIndex)
 {
   // if the sending processor has no data
   if (sendingProcAttributes->GetNumberOfArrays() == 0)
@@ -801,11 +1277,23 @@ void vtkIntegrateAttributes::IntegrateSatelliteData(
     return;
     }
 
+  std::vector<vtkCompensatedSum>& sums =
+    this->Internals->Totals.Attributes[attributeIndex];
+
   // when processor 0 that has no data, receives data from the min
   // processor that has data
   if (proc0Attributes->GetNumberOfArrays() == 0)
     {
     proc0Attributes->DeepCopy (sendingProcAttributes);
+    sums.clear();
+    for (int i = 0; i < proc0Attributes->GetNumberOfArrays(); ++i)
+      {
+      vtkDataArray* array = proc0Attributes->GetArray(i);
+      for (int j = 0; array && j < array->GetNumberOfComponents(); ++j)
+        {
+        sums.push_back(vtkCompensatedSum(array->GetComponent(0, j)));
+        }
+      }
     return;
     }
 
@@ -813,449 +1301,32 @@ void vtkIntegrateAttributes::IntegrateSatelliteData(
   vtkDataArray* inArray;
   vtkDataArray* outArray;
   numArrays = proc0Attributes->GetNumberOfArrays();
-  double vIn, vOut;
+  size_t offset = 0;
   for (i = 0; i < numArrays; ++i)
     {
     outArray = proc0Attributes->GetArray(i);
-    numComponents = outArray->GetNumberOfComponents();
+    numComponents = outArray? outArray->GetNumberOfComponents() : 0;
+    if (offset + numComponents > sums.size())
+      {
+      break;
+      }
     // Protect against arrays in a different order.
-    const char* name = outArray->GetName();
+    const char* name = outArray? outArray->GetName() : NULL;
     if (name && name[0] != '\0')
       {
       inArray = sendingProcAttributes->GetArray(name);
       if (inArray && inArray->GetNumberOfComponents() == numComponents)
         {
-        // We could template for speed.
         for (j = 0; j < numComponents; ++j)
           {
-          vIn = inArray->GetComponent(0, j);
-          vOut = outArray->GetComponent(0, j);
-          outArray->SetComponent(0,j,vOut+vIn);
+          sums[offset + j].Add(inArray->GetComponent(0, j));
           }
         }
       }
+    offset += numComponents;
     }
 }
 
-//-----------------------------------------------------------------------------
-void vtkIntegrateAttributes::IntegratePolyLine(vtkDataSet* input,
-                                               vtkUnstructuredGrid* output,
-                                               vtkIdType cellId,
-                                               vtkIdList* ptIds)
-{
-  double length;
-  double pt1[3], pt2[3], mid[3];
-  vtkIdType numLines, lineIdx;
-  vtkIdType pt1Id, pt2Id;
-
-  numLines = ptIds->GetNumberOfIds()-1;
-  for (lineIdx = 0; lineIdx < numLines; ++lineIdx)
-    {
-    pt1Id = ptIds->GetId(lineIdx);
-    pt2Id = ptIds->GetId(lineIdx+1);
-    input->GetPoint(pt1Id, pt1);
-    input->GetPoint(pt2Id,pt2);
-
-    // Compute the length of the line.
-    length = sqrt(vtkMath::Distance2BetweenPoints(pt1, pt2));
-    this->Sum += length;
-
-    // Compute the middle, which is really just another attribute.
-    mid[0] = (pt1[0]+pt2[0])*0.5;
-    mid[1] = (pt1[1]+pt2[1])*0.5;
-    mid[2] = (pt1[2]+pt2[2])*0.5;
-    // Add weighted to sumCenter.
-    this->SumCenter[0] += mid[0]*length;
-    this->SumCenter[1] += mid[1]*length;
-    this->SumCenter[2] += mid[2]*length;
-
-    // Now integrate the rest of the attributes.
-    this->IntegrateData2(input->GetPointData(), output->GetPointData(),
-                         pt1Id, pt2Id, length,
-                         *this->PointFieldList, this->FieldListIndex);
-    this->IntegrateData1(input->GetCellData(), output->GetCellData(),
-                         cellId, length,
-                         *this->CellFieldList, this->FieldListIndex);
-    }
-}
-
-//-----------------------------------------------------------------------------
-void
-vtkIntegrateAttributes::IntegrateGeneral1DCell(vtkDataSet* input,
-                                               vtkUnstructuredGrid* output,
-                                               vtkIdType cellId,
-                                               vtkIdList* ptIds)
-{
-  // Determine the number of lines
-  vtkIdType nPnts = ptIds->GetNumberOfIds();
-  // There should be an even number of points from the triangulation
-  if (nPnts % 2)
-    {
-    vtkWarningMacro("Odd number of points("
-                    << nPnts << ")  encountered - skipping "
-                    << " 1D Cell: " << cellId);
-    return;
-    }
-
-  double length;
-  double pt1[3], pt2[3], mid[3];
-  vtkIdType pid=0;
-  vtkIdType pt1Id, pt2Id;
-
-  while (pid < nPnts)
-    {
-    pt1Id = ptIds->GetId(pid++);
-    pt2Id = ptIds->GetId(pid++);
-    input->GetPoint(pt1Id, pt1);
-    input->GetPoint(pt2Id,pt2);
-
-    // Compute the length of the line.
-    length = sqrt(vtkMath::Distance2BetweenPoints(pt1, pt2));
-    this->Sum += length;
-
-    // Compute the middle, which is really just another attribute.
-    mid[0] = (pt1[0]+pt2[0])*0.5;
-    mid[1] = (pt1[1]+pt2[1])*0.5;
-    mid[2] = (pt1[2]+pt2[2])*0.5;
-    // Add weighted to sumCenter.
-    this->SumCenter[0] += mid[0]*length;
-    this->SumCenter[1] += mid[1]*length;
-    this->SumCenter[2] += mid[2]*length;
-
-    // Now integrate the rest of the attributes.
-    this->IntegrateData2(input->GetPointData(), output->GetPointData(),
-                         pt1Id, pt2Id, length,
-                         *this->PointFieldList, this->FieldListIndex);
-    this->IntegrateData1(input->GetCellData(), output->GetCellData(),
-                         cellId, length,
-                         *this->CellFieldList, this->FieldListIndex);
-    }
-}
-
-//-----------------------------------------------------------------------------
-void vtkIntegrateAttributes::IntegrateTriangleStrip(vtkDataSet* input,
-                                                    vtkUnstructuredGrid* output,
-                                                    vtkIdType cellId,
-                                                    vtkIdList* ptIds)
-{
-  vtkIdType numTris, triIdx;
-  vtkIdType pt1Id, pt2Id, pt3Id;
-
-  numTris = ptIds->GetNumberOfIds()-2;
-  for (triIdx = 0; triIdx < numTris; ++triIdx)
-    {
-    pt1Id = ptIds->GetId(triIdx);
-    pt2Id = ptIds->GetId(triIdx+1);
-    pt3Id = ptIds->GetId(triIdx+2);
-    this->IntegrateTriangle(input, output, cellId, pt1Id, pt2Id, pt3Id);
-    }
-}
-
-//-----------------------------------------------------------------------------
-// Works for convex polygons, and interpoaltion is not correct.
-void vtkIntegrateAttributes::IntegratePolygon(vtkDataSet* input,
-                                              vtkUnstructuredGrid* output,
-                                              vtkIdType cellId,
-                                              vtkIdList* ptIds)
-{
-  vtkIdType numTris, triIdx;
-  vtkIdType pt1Id, pt2Id, pt3Id;
-
-  numTris = ptIds->GetNumberOfIds()-2;
-  pt1Id = ptIds->GetId(0);
-  for (triIdx = 0; triIdx < numTris; ++triIdx)
-    {
-    pt2Id = ptIds->GetId(triIdx+1);
-    pt3Id = ptIds->GetId(triIdx+2);
-    this->IntegrateTriangle(input, output, cellId, pt1Id, pt2Id, pt3Id);
-    }
-}
-
-//-----------------------------------------------------------------------------
-// For axis alligned rectangular cells
-void vtkIntegrateAttributes::IntegratePixel(vtkDataSet* input,
-                                            vtkUnstructuredGrid* output,
-                                            vtkIdType cellId,
-                                            vtkIdList* cellPtIds)
-{
-  vtkIdType pt1Id, pt2Id, pt3Id, pt4Id;
-  double pts[4][3];
-  pt1Id = cellPtIds->GetId(0);
-  pt2Id = cellPtIds->GetId(1);
-  pt3Id = cellPtIds->GetId(2);
-  pt4Id = cellPtIds->GetId(3);
-  input->GetPoint(pt1Id,pts[0]);
-  input->GetPoint(pt2Id,pts[1]);
-  input->GetPoint(pt3Id,pts[2]);
-  input->GetPoint(pt4Id,pts[3]);
-
-  double l, w, a, mid[3];
-
-  // get the lengths of its 2 orthogonal sides.  Since only 1 coordinate
-  // can be different we can add the differences in all 3 directions
-  l = (pts[0][0] - pts[1][0]) + (pts[0][1] - pts[1][1]) +
-      (pts[0][2] - pts[1][2]);
-
-  w = (pts[0][0] - pts[2][0]) + (pts[0][1] - pts[2][1]) +
-      (pts[0][2] - pts[2][2]);
-
-  a = fabs(l*w);
-  this->Sum += a;
-  // Compute the middle, which is really just another attribute.
-  mid[0] = (pts[0][0]+pts[1][0]+pts[2][0]+pts[3][0])*0.25;
-  mid[1] = (pts[0][1]+pts[1][1]+pts[2][1]+pts[3][1])*0.25;
-  mid[2] = (pts[0][2]+pts[1][2]+pts[2][2]+pts[3][2])*0.25;
-  // Add weighted to sumCenter.
-  this->SumCenter[0] += mid[0]*a;
-  this->SumCenter[1] += mid[1]*a;
-  this->SumCenter[2] += mid[2]*a;
-
-  // Now integrate the rest of the attributes.
-  this->IntegrateData4(input->GetPointData(), output->GetPointData(),
-                       pt1Id, pt2Id, pt3Id, pt4Id, a,
-                       *this->PointFieldList, this->FieldListIndex);
-  this->IntegrateData1(input->GetCellData(), output->GetCellData(), cellId, a,
-    *this->CellFieldList, this->FieldListIndex);
-}
-
-//-----------------------------------------------------------------------------
-void vtkIntegrateAttributes::IntegrateTriangle(vtkDataSet* input,
-                                               vtkUnstructuredGrid* output,
-                                               vtkIdType cellId,
-                                               vtkIdType pt1Id,
-                                               vtkIdType pt2Id,
-                                               vtkIdType pt3Id)
-{
-  double pt1[3], pt2[3], pt3[3];
-  double mid[3], v1[3], v2[3];
-  double cross[3];
-  double k;
-
-  input->GetPoint(pt1Id,pt1);
-  input->GetPoint(pt2Id,pt2);
-  input->GetPoint(pt3Id,pt3);
-
-  // Compute two legs.
-  v1[0] = pt2[0] - pt1[0];
-  v1[1] = pt2[1] - pt1[1];
-  v1[2] = pt2[2] - pt1[2];
-  v2[0] = pt3[0] - pt1[0];
-  v2[1] = pt3[1] - pt1[1];
-  v2[2] = pt3[2] - pt1[2];
-
-  // Use the cross product to compute the area of the parallelogram.
-  vtkMath::Cross(v1,v2,cross);
-  k = sqrt(cross[0]*cross[0] + cross[1]*cross[1] + cross[2]*cross[2]) * 0.5;
-
-  if (k == 0.0)
-    {
-    return;
-    }
-  this->Sum += k;
-
-  // Compute the middle, which is really just another attribute.
-  mid[0] = (pt1[0]+pt2[0]+pt3[0])/3.0;
-  mid[1] = (pt1[1]+pt2[1]+pt3[1])/3.0;
-  mid[2] = (pt1[2]+pt2[2]+pt3[2])/3.0;
-  // Add weighted to sumCenter.
-  this->SumCenter[0] += mid[0]*k;
-  this->SumCenter[1] += mid[1]*k;
-  this->SumCenter[2] += mid[2]*k;
-
-  // Now integrate the rest of the attributes.
-  this->IntegrateData3(input->GetPointData(), output->GetPointData(),
-                       pt1Id, pt2Id, pt3Id, k,
-                       *this->PointFieldList, this->FieldListIndex);
-  this->IntegrateData1(input->GetCellData(), output->GetCellData(), cellId, k,
-    *this->CellFieldList, this->FieldListIndex);
-}
-
-//-----------------------------------------------------------------------------
-void
-vtkIntegrateAttributes::IntegrateGeneral2DCell(vtkDataSet* input,
-                                               vtkUnstructuredGrid* output,
-                                               vtkIdType cellId,
-                                               vtkIdList* ptIds)
-{
-  vtkIdType nPnts = ptIds->GetNumberOfIds();
-  // There should be a number of points that is a multiple of 3
-  // from the triangulation
-  if (nPnts % 3)
-    {
-    vtkWarningMacro("Number of points ("
-                    << nPnts << ") is not divisiable by 3 - skipping "
-                    << " 2D Cell: " << cellId);
-    return;
-    }
-
-  vtkIdType triIdx = 0;
-  vtkIdType pt1Id, pt2Id, pt3Id;
-
-  while (triIdx < nPnts)
-    {
-    pt1Id = ptIds->GetId(triIdx++);
-    pt2Id = ptIds->GetId(triIdx++);
-    pt3Id = ptIds->GetId(triIdx++);
-    this->IntegrateTriangle(input, output, cellId, pt1Id, pt2Id, pt3Id);
-    }
-}
-
-//-----------------------------------------------------------------------------
-// For Tetrahedral cells
-void vtkIntegrateAttributes::IntegrateTetrahedron(vtkDataSet* input,
-                                                  vtkUnstructuredGrid* output,
-                                                  vtkIdType cellId,
-                                                  vtkIdType pt1Id,
-                                                  vtkIdType pt2Id,
-                                                  vtkIdType pt3Id,
-                                                  vtkIdType pt4Id)
-{
-  double pts[4][3];
-  input->GetPoint(pt1Id,pts[0]);
-  input->GetPoint(pt2Id,pts[1]);
-  input->GetPoint(pt3Id,pts[2]);
-  input->GetPoint(pt4Id,pts[3]);
-
-  double a[3], b[3], c[3], n[3], v, mid[3];
-  int i;
-  // Compute the principle vectors around pt0 and the
-  // centroid
-  for (i = 0; i < 3; i++)
-    {
-    a[i] = pts[1][i] - pts[0][i];
-    b[i] = pts[2][i] - pts[0][i];
-    c[i] = pts[3][i] - pts[0][i];
-    mid[i] = (pts[0][i]+pts[1][i]+pts[2][i]+pts[3][i])*0.25;
-    }
-
-
-  // Calulate the volume of the tet which is 1/6 * the box product
-  vtkMath::Cross(a,b,n);
-  v = vtkMath::Dot(c, n) / 6.0;
-  this->Sum += v;
-
-  // Add weighted to sumCenter.
-  this->SumCenter[0] += mid[0]*v;
-  this->SumCenter[1] += mid[1]*v;
-  this->SumCenter[2] += mid[2]*v;
-
-  // Integrate the attributes on the cell itself
-  this->IntegrateData1(input->GetCellData(), output->GetCellData(), cellId, v,
-    *this->CellFieldList, this->FieldListIndex);
-
-  // Integrate the attributes associated with the points
-  this->IntegrateData4(input->GetPointData(), output->GetPointData(),
-                       pt1Id, pt2Id, pt3Id, pt4Id, v,
-                       *this->PointFieldList, this->FieldListIndex);
-
-}
-
-//-----------------------------------------------------------------------------
-// For axis alligned hexahedral cells
-void vtkIntegrateAttributes::IntegrateVoxel(vtkDataSet* input,
-                                            vtkUnstructuredGrid* output,
-                                            vtkIdType cellId,
-                                            vtkIdList* cellPtIds)
-{
-  vtkIdType pt1Id, pt2Id, pt3Id, pt4Id, pt5Id;
-  double pts[5][3];
-  pt1Id = cellPtIds->GetId(0);
-  pt2Id = cellPtIds->GetId(1);
-  pt3Id = cellPtIds->GetId(2);
-  pt4Id = cellPtIds->GetId(3);
-  pt5Id = cellPtIds->GetId(4);
-  input->GetPoint(pt1Id,pts[0]);
-  input->GetPoint(pt2Id,pts[1]);
-  input->GetPoint(pt3Id,pts[2]);
-  input->GetPoint(pt4Id,pts[3]);
-  input->GetPoint(pt5Id,pts[4]);
-
-  double l, w, h, v, mid[3];
-
-  // Calulate the volume of the voxel
-  l = pts[1][0] - pts[0][0];
-  w = pts[2][1] - pts[0][1];
-  h = pts[4][2] - pts[0][2];
-  v = fabs(l*w*h);
-  this->Sum += v;
-
-  // Partially Compute the middle, which is really just another attribute.
-  mid[0] = (pts[0][0]+pts[1][0]+pts[2][0]+pts[3][0])*0.125;
-  mid[1] = (pts[0][1]+pts[1][1]+pts[2][1]+pts[3][1])*0.125;
-  mid[2] = (pts[0][2]+pts[1][2]+pts[2][2]+pts[3][2])*0.125;
-
-  // Integrate the attributes on the cell itself
-  this->IntegrateData1(input->GetCellData(), output->GetCellData(), cellId, v,
-    *this->CellFieldList, this->FieldListIndex);
-
-  // Integrate the attributes associated with the points on the bottom face
-  // note that since IntegrateData4 is going to weigh everything by 1/4
-  // we need to pass down 1/2 the volume so they will be weighted by 1/8
-
-  this->IntegrateData4(input->GetPointData(), output->GetPointData(),
-                       pt1Id, pt2Id, pt3Id, pt4Id, v*0.5,
-                       *this->PointFieldList, this->FieldListIndex);
-
-  // Now process the top face points
-  pt1Id = cellPtIds->GetId(5);
-  pt2Id = cellPtIds->GetId(6);
-  pt3Id = cellPtIds->GetId(7);
-  input->GetPoint(pt1Id,pts[0]);
-  input->GetPoint(pt2Id,pts[1]);
-  input->GetPoint(pt3Id,pts[2]);
-  // Finish Computing the middle, which is really just another attribute.
-  mid[0] += (pts[0][0]+pts[1][0]+pts[2][0]+pts[4][0])*0.125;
-  mid[1] += (pts[0][1]+pts[1][1]+pts[2][1]+pts[4][1])*0.125;
-  mid[2] += (pts[0][2]+pts[1][2]+pts[2][2]+pts[4][2])*0.125;
-
-
-  // Add weighted to sumCenter.
-  this->SumCenter[0] += mid[0]*v;
-  this->SumCenter[1] += mid[1]*v;
-  this->SumCenter[2] += mid[2]*v;
-
-  // Integrate the attributes associated with the points on the top face
-  // note that since IntegrateData4 is going to weigh everything by 1/4
-  // we need to pass down 1/2 the volume so they will be weighted by 1/8
-  this->IntegrateData4(input->GetPointData(), output->GetPointData(),
-                       pt1Id, pt2Id, pt3Id, pt5Id, v*0.5,
-                       *this->PointFieldList, this->FieldListIndex);
-}
-
-//-----------------------------------------------------------------------------
-void
-vtkIntegrateAttributes::IntegrateGeneral3DCell(vtkDataSet* input,
-                                               vtkUnstructuredGrid* output,
-                                               vtkIdType cellId,
-                                               vtkIdList* ptIds)
-{
-
-  vtkIdType nPnts = ptIds->GetNumberOfIds();
-  // There should be a number of points that is a multiple of 4
-  // from the triangulation
-  if (nPnts % 4)
-    {
-    vtkWarningMacro("Number of points ("
-                    << nPnts << ") is not divisiable by 4 - skipping "
-                    << " 3D Cell: " << cellId);
-    return;
-    }
-
-  vtkIdType tetIdx = 0;
-  vtkIdType pt1Id, pt2Id, pt3Id, pt4Id;
-
-  while (tetIdx < nPnts)
-    {
-    pt1Id = ptIds->GetId(tetIdx++);
-    pt2Id = ptIds->GetId(tetIdx++);
-    pt3Id = ptIds->GetId(tetIdx++);
-    pt4Id = ptIds->GetId(tetIdx++);
-    this->IntegrateTetrahedron(input, output, cellId, pt1Id, pt2Id, pt3Id,
-                               pt4Id);
-    }
-}
-
-
 //-----------------------------------------------------------------------------
 void vtkIntegrateAttributes::PrintSelf(ostream& os, vtkIndent indent)
 {
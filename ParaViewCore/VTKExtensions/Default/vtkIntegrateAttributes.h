@@ -21,6 +21,12 @@
 // The output of this filter is a single point and vertex.  The attributes
 // for this point and cell will contain the integration results
 // for the corresponding input attributes.
+//
+// Cells are integrated concurrently using vtkSMPTools. The contributions of
+// the cells are added with compensated summation, in an order that does not
+// depend on the number of threads, hence results are identical whatever the
+// number of threads and differ by no more than a few rounding errors between
+// different numbers of processes.
 
 #ifndef __vtkIntegrateAttributes_h
 #define __vtkIntegrateAttributes_h
@@ -29,7 +35,6 @@
 #include "vtkUnstructuredGridAlgorithm.h"
 
 class vtkDataSet;
-class vtkIdList;
 class vtkInformation;
 class vtkInformationVector;
 class vtkDataSetAttributes;
@@ -69,44 +74,9 @@ protected:
   // ToCompute the location of the output point.
   double SumCenter[3];
 
-  void IntegratePolyLine(vtkDataSet* input,
-                         vtkUnstructuredGrid* output,
-                         vtkIdType cellId, vtkIdList* cellPtIds);
-  void IntegratePolygon(vtkDataSet* input,
-                         vtkUnstructuredGrid* output,
-                         vtkIdType cellId, vtkIdList* cellPtIds);
-  void IntegrateTriangleStrip(vtkDataSet* input,
-                         vtkUnstructuredGrid* output,
-                         vtkIdType cellId, vtkIdList* cellPtIds);
-  void IntegrateTriangle(vtkDataSet* input,
-                         vtkUnstructuredGrid* output,
-                         vtkIdType cellId, vtkIdType pt1Id,
-                         vtkIdType pt2Id, vtkIdType pt3Id);
-  void IntegrateTetrahedron(vtkDataSet* input,
-                            vtkUnstructuredGrid* output,
-                            vtkIdType cellId, vtkIdType pt1Id,
-                            vtkIdType pt2Id, vtkIdType pt3Id,
-                            vtkIdType pt4Id);
-  void IntegratePixel(vtkDataSet* input,
-                      vtkUnstructuredGrid* output,
-                      vtkIdType cellId, vtkIdList* cellPtIds);
-  void IntegrateVoxel(vtkDataSet* input,
-                      vtkUnstructuredGrid* output,
-                      vtkIdType cellId, vtkIdList* cellPtIds);
-  void IntegrateGeneral1DCell(vtkDataSet* input,
-                              vtkUnstructuredGrid* output,
-                              vtkIdType cellId,
-                              vtkIdList* cellPtIds);
-  void IntegrateGeneral2DCell(vtkDataSet* input,
-                              vtkUnstructuredGrid* output,
-                              vtkIdType cellId,
-                              vtkIdList* cellPtIds);
-  void IntegrateGeneral3DCell(vtkDataSet* input,
-                              vtkUnstructuredGrid* output,
-                              vtkIdType cellId,
-                              vtkIdList* cellPtIds);
   void IntegrateSatelliteData(vtkDataSetAttributes* inda,
-                              vtkDataSetAttributes* outda);
+                              vtkDataSetAttributes* outda,
+                              int attributeIndex);
   void ZeroAttributes(vtkDataSetAttributes* outda);
   int PieceNodeMinToNode0 (vtkUnstructuredGrid *data);
   void SendPiece(vtkUnstructuredGrid *src);
@@ -117,36 +87,19 @@ private:
   void operator=(const vtkIntegrateAttributes&);  // Not implemented.
 
   class vtkFieldList;
-  vtkFieldList* CellFieldList;
-  vtkFieldList* PointFieldList;
-  int FieldListIndex;
+
+  class vtkInternals;
+  vtkInternals* Internals;
 
   void AllocateAttributes(
     vtkFieldList& fieldList, vtkDataSetAttributes* outda);
   void ExecuteBlock(vtkDataSet* input, vtkUnstructuredGrid* output,
     int fieldset_index, vtkFieldList& pdList, vtkFieldList& cdList);
 
-  void IntegrateData1(vtkDataSetAttributes* inda,
-                      vtkDataSetAttributes* outda,
-                      vtkIdType pt1Id, double k,
-                      vtkFieldList& fieldlist,
-                      int fieldlist_index);
-  void IntegrateData2(vtkDataSetAttributes* inda,
-                      vtkDataSetAttributes* outda,
-                      vtkIdType pt1Id, vtkIdType pt2Id, double k,
-                      vtkFieldList& fieldlist,
-                      int fieldlist_index);
-  void IntegrateData3(vtkDataSetAttributes* inda,
-                      vtkDataSetAttributes* outda, vtkIdType pt1Id,
-                      vtkIdType pt2Id, vtkIdType pt3Id, double k,
-                      vtkFieldList& fieldlist,
-                      int fieldlist_index);
-  void IntegrateData4(vtkDataSetAttributes* inda,
-                      vtkDataSetAttributes* outda, vtkIdType pt1Id,
-                      vtkIdType pt2Id, vtkIdType pt3Id, vtkIdType pt4Id,
-                      double k,
-                      vtkFieldList& fieldlist,
-                      int fieldlist_index);
+  // Copies the accumulated integrals to Sum, SumCenter and the output
+  // arrays.
+  void UpdateIntegrals(vtkUnstructuredGrid* output);
+
 public:
   enum CommunicationIds
    {
@@ -104,15 +104,15 @@ int vtkPExtractHistogram::RequestData(vtkInformation *request,
   reduceFilter->SetController(this->Controller);
 
   bool isRoot = (this->Controller->GetLocalProcessId() ==0);
-  if (isRoot)
-    {
-    // PostGatherHelper needs to be set only on the root node.
-    vtkSmartPointer<vtkAttributeDataReductionFilter> rf = 
-      vtkSmartPointer<vtkAttributeDataReductionFilter>::New();
-    rf->SetAttributeType(vtkAttributeDataReductionFilter::ROW_DATA);
-    rf->SetReductionType(vtkAttributeDataReductionFilter::ADD);
-    reduceFilter->SetPostGatherHelper(rf);
-    }
+
+  // The PostGatherHelper is set on all nodes so that the bins can be summed
+  // along a tree rather than all on the root.
+  vtkSmartPointer<vtkAttributeDataReductionFilter> rf = 
+    vtkSmartPointer<vtkAttributeDataReductionFilter>::New();
+  rf->SetAttributeType(vtkAttributeDataReductionFilter::ROW_DATA);
+  rf->SetReductionType(vtkAttributeDataReductionFilter::ADD);
+  reduceFilter->SetPostGatherHelper(rf);
+  reduceFilter->SetUseTreeReduction(1);
 
   vtkSmartPointer<vtkTable> copy = vtkSmartPointer<vtkTable>::New();
   copy->ShallowCopy(output);
@@ -21,18 +21,21 @@
 #include "vtkDataSet.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMath.h"
 #include "vtkMinimalStandardRandomSequence.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkMultiProcessController.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPointSet.h"
 #include "vtkPolyData.h"
 #include "vtkSmartPointer.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkUniformGrid.h"
 #include "vtkTuple.h"
-#include "vtkOctreePointLocator.h"
 
 // C/C++ includes
 #include <vector>
@@ -40,6 +43,288 @@
 #include <set>
 #include <algorithm>
 #include <cmath>
+#include <cstdlib>
+
+namespace
+{
+  // Points of a dataset sorted into a uniform grid of bins, i.e. a counting
+  // sort of the point ids by bin, used to find the point closest to each
+  // sample point. The grid only depends on the points, so the locator is kept
+  // between executions and only rebuilt when the points are modified (e.g. for
+  // time-varying particle data), and the sort is only redone when points move
+  // to other bins.
+  class vtkBinnedPointLocator
+  {
+  public:
+    vtkBinnedPointLocator() : DataSet(NULL), Points(NULL), PointsMTime(0)
+      {
+      this->Origin[0] = this->Origin[1] = this->Origin[2] = 0.0;
+      this->Spacing[0] = this->Spacing[1] = this->Spacing[2] = 1.0;
+      this->Dimensions[0] = this->Dimensions[1] = this->Dimensions[2] = 0;
+      }
+
+    //-------------------------------------------------------------------------
+    // Bins the points of `ds` in a grid covering their bounds, with about
+    // as many bins as points. Nothing is done if the points were not modified
+    // since the last call.
+    void Update(vtkDataSet* ds)
+      {
+      // the points of point sets may be shared by successive outputs of the
+      // upstream pipeline; other datasets are identified by themselves.
+      vtkPointSet* ps = vtkPointSet::SafeDownCast(ds);
+      vtkObject* points = ps && ps->GetPoints()?
+        static_cast<vtkObject*>(ps->GetPoints()) : ds;
+      vtkIdType numPts = ds->GetNumberOfPoints();
+      this->DataSet = ds;
+      if (points == this->Points && points->GetMTime() == this->PointsMTime &&
+        static_cast<vtkIdType>(this->PointBins.size()) == numPts)
+        {
+        return;
+        }
+      this->Points = points;
+      this->PointsMTime = points->GetMTime();
+
+      double origin[3], spacing[3];
+      int dims[3];
+      vtkBinnedPointLocator::ComputeGrid(vtkBoundingBox(ps && ps->GetPoints()?
+          ps->GetPoints()->GetBounds() : ds->GetBounds()),
+        std::max<vtkIdType>(numPts, 1024), origin, spacing, dims);
+      bool sameGrid = std::equal(origin, origin + 3, this->Origin) &&
+        std::equal(spacing, spacing + 3, this->Spacing) &&
+        std::equal(dims, dims + 3, this->Dimensions);
+      std::copy(origin, origin + 3, this->Origin);
+      std::copy(spacing, spacing + 3, this->Spacing);
+      std::copy(dims, dims + 3, this->Dimensions);
+
+      std::vector<vtkIdType> bins(numPts);
+      ComputeBinsFunctor functor(this, ds, bins);
+      vtkSMPTools::For(0, numPts, functor);
+      if (sameGrid && bins == this->PointBins)
+        {
+        // no point moved to another bin, the sorted ids are still valid.
+        return;
+        }
+      this->PointBins.swap(bins);
+
+      // counting sort of the point ids by bin. Points in a bin stay in
+      // increasing id order.
+      vtkIdType numBins = static_cast<vtkIdType>(dims[0]) * dims[1] * dims[2];
+      this->BinOffsets.assign(numBins + 1, 0);
+      for (vtkIdType cc = 0; cc < numPts; ++cc)
+        {
+        this->BinOffsets[this->PointBins[cc] + 1]++;
+        }
+      for (vtkIdType cc = 0; cc < numBins; ++cc)
+        {
+        this->BinOffsets[cc + 1] += this->BinOffsets[cc];
+        }
+      std::vector<vtkIdType> next(this->BinOffsets.begin(),
+        this->BinOffsets.end() - 1);
+      this->PointIds.resize(numPts);
+      for (vtkIdType cc = 0; cc < numPts; ++cc)
+        {
+        this->PointIds[next[this->PointBins[cc]]++] = cc;
+        }
+      }
+
+    //-------------------------------------------------------------------------
+    // Returns the id of the point closest to `x` within `radius`, or -1. Ties
+    // are resolved to the smallest id. The bins are visited in shells of
+    // increasing distance around the bin of `x`, stopping as soon as the
+    // remaining shells cannot hold a closer point. Safe to call from multiple
+    // threads.
+    vtkIdType FindClosestPointWithinRadius(double radius, const double x[3]) const
+      {
+      int center[3], lo[3], hi[3];
+      int maxLevel = 0;
+      double minSpacing = VTK_DOUBLE_MAX;
+      for (int i = 0; i < 3; ++i)
+        {
+        center[i] = this->GetBin(x[i], i);
+        lo[i] = this->GetBin(x[i] - radius, i);
+        hi[i] = this->GetBin(x[i] + radius, i);
+        maxLevel = std::max(maxLevel,
+          std::max(center[i] - lo[i], hi[i] - center[i]));
+        if (this->Dimensions[i] > 1)
+          {
+          minSpacing = std::min(minSpacing, this->Spacing[i]);
+          }
+        }
+
+      double radius2 = radius * radius;
+      double best = VTK_DOUBLE_MAX;
+      vtkIdType bestId = -1;
+      for (int level = 0; level <= maxLevel; ++level)
+        {
+        // points in this shell and the following ones are at least
+        // (level - 1) * minSpacing away. Equally close points may still have
+        // smaller ids.
+        if (bestId >= 0 && level > 0 &&
+          best < (level - 1) * minSpacing * (level - 1) * minSpacing)
+          {
+          break;
+          }
+        int klo = std::max(lo[2], center[2] - level);
+        int khi = std::min(hi[2], center[2] + level);
+        int jlo = std::max(lo[1], center[1] - level);
+        int jhi = std::min(hi[1], center[1] + level);
+        for (int k = klo; k <= khi; ++k)
+          {
+          for (int j = jlo; j <= jhi; ++j)
+            {
+            if (std::abs(k - center[2]) == level ||
+              std::abs(j - center[1]) == level)
+              {
+              int ilo = std::max(lo[0], center[0] - level);
+              int ihi = std::min(hi[0], center[0] + level);
+              for (int i = ilo; i <= ihi; ++i)
+                {
+                this->SearchBin(i, j, k, x, radius2, best, bestId);
+                }
+              }
+            else
+              {
+              // inside the shell along j and k: only its two faces along i.
+              if (center[0] - level >= lo[0])
+                {
+                this->SearchBin(center[0] - level, j, k, x, radius2, best,
+                  bestId);
+                }
+              if (level > 0 && center[0] + level <= hi[0])
+                {
+                this->SearchBin(center[0] + level, j, k, x, radius2, best,
+                  bestId);
+                }
+              }
+            }
+          }
+        }
+      return bestId;
+      }
+
+  private:
+    vtkDataSet* DataSet;
+    vtkObject* Points; // identifies the points that were binned.
+    unsigned long PointsMTime;
+    double Origin[3];
+    double Spacing[3];
+    int Dimensions[3];
+    std::vector<vtkIdType> PointBins;  // bin of each point.
+    std::vector<vtkIdType> BinOffsets; // start of each bin in PointIds.
+    std::vector<vtkIdType> PointIds;   // point ids sorted by bin.
+
+    void SearchBin(int i, int j, int k, const double x[3], double radius2,
+      double& best, vtkIdType& bestId) const
+      {
+      vtkIdType bin = i + this->Dimensions[0] *
+        (j + static_cast<vtkIdType>(this->Dimensions[1]) * k);
+      for (vtkIdType cc = this->BinOffsets[bin];
+        cc < this->BinOffsets[bin + 1]; ++cc)
+        {
+        vtkIdType ptId = this->PointIds[cc];
+        double pt[3];
+        this->DataSet->GetPoint(ptId, pt);
+        double dist2 = vtkMath::Distance2BetweenPoints(pt, x);
+        if (dist2 <= radius2 &&
+          (dist2 < best || (dist2 == best && ptId < bestId)))
+          {
+          best = dist2;
+          bestId = ptId;
+          }
+        }
+      }
+
+    static void ComputeGrid(const vtkBoundingBox& bounds, vtkIdType maxBins,
+      double origin[3], double spacing[3], int dims[3])
+      {
+      double length[3];
+      bounds.GetMinPoint(origin[0], origin[1], origin[2]);
+      bounds.GetLengths(length);
+      double size = bounds.GetMaxLength() * 1.0e-6;
+      if (size <= 0.0)
+        {
+        size = 1.0;
+        }
+      for (;;)
+        {
+        double numBins = 1.0;
+        for (int i = 0; i < 3; ++i)
+          {
+          dims[i] = static_cast<int>(std::max(1.0,
+            std::min(std::ceil(length[i] / size), 65535.0)));
+          numBins *= dims[i];
+          }
+        if (numBins <= maxBins)
+          {
+          break;
+          }
+        size *= std::pow(numBins / maxBins, 1.0 / 3.0) * 1.01;
+        }
+      for (int i = 0; i < 3; ++i)
+        {
+        spacing[i] = length[i] > 0.0? length[i] / dims[i] : 1.0;
+        }
+      }
+
+    int GetBin(double x, int axis) const
+      {
+      double bin = std::floor((x - this->Origin[axis]) / this->Spacing[axis]);
+      return static_cast<int>(std::max(0.0,
+        std::min(bin, static_cast<double>(this->Dimensions[axis] - 1))));
+      }
+
+    struct ComputeBinsFunctor
+      {
+      const vtkBinnedPointLocator* Self;
+      vtkDataSet* DataSet;
+      std::vector<vtkIdType>& Bins;
+
+      ComputeBinsFunctor(const vtkBinnedPointLocator* self, vtkDataSet* ds,
+        std::vector<vtkIdType>& bins) : Self(self), DataSet(ds), Bins(bins)
+        {
+        }
+
+      void operator()(vtkIdType begin, vtkIdType end)
+        {
+        const int* dims = this->Self->Dimensions;
+        for (vtkIdType cc = begin; cc < end; ++cc)
+          {
+          double pt[3];
+          this->DataSet->GetPoint(cc, pt);
+          this->Bins[cc] = this->Self->GetBin(pt[0], 0) + dims[0] *
+            (this->Self->GetBin(pt[1], 1) +
+             static_cast<vtkIdType>(dims[1]) * this->Self->GetBin(pt[2], 2));
+          }
+        }
+      };
+    friend struct ComputeBinsFunctor;
+  };
+
+  // Finds the closest point for each sample point in parallel.
+  struct FindClosestPointsFunctor
+    {
+    const vtkBinnedPointLocator& Locator;
+    const std::vector<vtkTuple<double, 3> >& Points;
+    double Radius;
+    std::vector<vtkIdType>& Result;
+
+    FindClosestPointsFunctor(const vtkBinnedPointLocator& locator,
+      const std::vector<vtkTuple<double, 3> >& points, double radius,
+      std::vector<vtkIdType>& result) :
+      Locator(locator), Points(points), Radius(radius), Result(result)
+      {
+      }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      for (vtkIdType cc = begin; cc < end; ++cc)
+        {
+        this->Result[cc] = this->Locator.FindClosestPointWithinRadius(
+          this->Radius, this->Points[cc].GetData());
+        }
+      }
+    };
+}
 
 class vtkPVGlyphFilter::vtkInternals
 {
@@ -49,40 +334,86 @@ class vtkPVGlyphFilter::vtkInternals
   std::vector<vtkIdType> PointIds;
   size_t NextPointId;
 
-  vtkNew<vtkOctreePointLocator>Locator;
+  // Locators are kept across executions, one per input block.
+  std::map<unsigned int, vtkBinnedPointLocator> Locators;
+  std::set<unsigned int> UsedBlocks;
+  unsigned int CurrentBlock;
+  vtkDataSet* CurrentDataSet;
 
   void SetupLocator(vtkDataSet* ds)
     {
-    if (this->Locator->GetDataSet() == ds) { return; }
-
-    this->Locator->Initialize();
-    this->Locator->SetDataSet(ds);
-    this->Locator->BuildLocator();
+    if (this->CurrentDataSet == ds) { return; }
+    this->CurrentDataSet = ds;
+    this->UsedBlocks.insert(this->CurrentBlock);
 
     this->PointIds.clear();
-    std::set<vtkIdType> pointset;
-    for (std::vector<vtkTuple<double, 3> >::iterator iter=this->Points.begin(), end=this->Points.end();
-      iter != end; ++iter)
+    this->NextPointId = 0;
+    if (this->Points.empty())
       {
-      double dist2;
-      vtkIdType ptId = this->Locator->FindClosestPointWithinRadius(
-        this->NearestPointRadius, iter->GetData(), dist2);
-      if (ptId >= 0)
-        {
-        pointset.insert(ptId);
-        }
+      return;
       }
-    this->PointIds.insert(this->PointIds.begin(), pointset.begin(), pointset.end());
-    this->NextPointId = 0;
+
+    vtkBinnedPointLocator& locator = this->Locators[this->CurrentBlock];
+    locator.Update(ds);
+
+    std::vector<vtkIdType> closest(this->Points.size());
+    FindClosestPointsFunctor functor(
+      locator, this->Points, this->NearestPointRadius, closest);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(this->Points.size()), functor);
+
+    // sorted, unique ids of the points to glyph, independent of the number
+    // of threads.
+    std::sort(closest.begin(), closest.end());
+    std::vector<vtkIdType>::iterator first =
+      std::upper_bound(closest.begin(), closest.end(), -1);
+    std::vector<vtkIdType>::iterator last =
+      std::unique(first, closest.end());
+    this->PointIds.assign(first, last);
     }
 
 public:
+  vtkInternals() : NearestPointRadius(0.0), NextPointId(0), CurrentBlock(0),
+    CurrentDataSet(NULL)
+    {
+    }
+
   void Reset()
     {
     this->Bounds.Reset();
     this->Points.clear();
-    this->Locator->Initialize();
-    this->Locator->SetDataSet(NULL);
+    this->PointIds.clear();
+    this->CurrentBlock = 0;
+    this->CurrentDataSet = NULL;
+    }
+
+  //---------------------------------------------------------------------------
+  // Sets the block of the input that subsequent IsPointVisible() calls refer
+  // to. Used to select the locator to reuse.
+  void SetCurrentBlock(unsigned int block)
+    {
+    this->CurrentBlock = block;
+    this->CurrentDataSet = NULL;
+    }
+
+  //---------------------------------------------------------------------------
+  // Discards the locators of blocks that were not glyphed in the last
+  // execution.
+  void PruneLocators()
+    {
+    std::map<unsigned int, vtkBinnedPointLocator>::iterator iter =
+      this->Locators.begin();
+    while (iter != this->Locators.end())
+      {
+      if (this->UsedBlocks.find(iter->first) == this->UsedBlocks.end())
+        {
+        this->Locators.erase(iter++);
+        }
+      else
+        {
+        ++iter;
+        }
+      }
+    this->UsedBlocks.clear();
     }
 
   //---------------------------------------------------------------------------
@@ -330,7 +661,10 @@ int vtkPVGlyphFilter::RequestData(
 
     vtkPolyData* outputPD = vtkPolyData::GetData(outputVector);
     assert(outputPD);
-    return this->Execute(ds, sourceVector, outputPD)? 1 : 0;
+    int retVal = this->Execute(ds, sourceVector, outputPD)? 1 : 0;
+    this->Internals->PruneLocators();
+    this->Internals->Reset();
+    return retVal;
     }
   else if (cds)
     {
@@ -357,6 +691,7 @@ int vtkPVGlyphFilter::RequestData(
       if (currentDS)
         {
         vtkNew<vtkPolyData> outputPD;
+        this->Internals->SetCurrentBlock(iter->GetCurrentFlatIndex());
         if (!this->Execute(currentDS, sourceVector, outputPD.GetPointer()))
           {
           vtkErrorMacro("Glyph generation failed for block: " << iter->GetCurrentFlatIndex());
@@ -366,6 +701,7 @@ int vtkPVGlyphFilter::RequestData(
         outputMD->SetDataSet(iter, outputPD.GetPointer());
         }
       }
+    this->Internals->PruneLocators();
     }
   this->Internals->Reset();
   return 1;
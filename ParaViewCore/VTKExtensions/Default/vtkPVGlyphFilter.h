@@ -32,7 +32,11 @@
 // can be used to limit the number of sample points used for random sampling. This
 // doesn't not equal the number of points actually glyphed, since that depends on
 // several factors. In parallel, this filter ensures that spatial bounds are collected
-// across all ranks for generating identical sample points.
+// across all ranks for generating identical sample points. The points of each
+// input block are binned in a uniform grid that is kept across executions and
+// only rebuilt when the points are modified; the closest point to each sample
+// is then found using vtkSMPTools. The glyphed points only depend on
+// the input and \c Seed, not on the number of threads.
 
 #ifndef __vtkPVGlyphFilter_h
 #define __vtkPVGlyphFilter_h
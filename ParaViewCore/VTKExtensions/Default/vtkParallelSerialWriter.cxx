@@ -17,6 +17,7 @@
 #include "vtkClientServerInterpreter.h"
 #include "vtkClientServerInterpreterInitializer.h"
 #include "vtkClientServerStream.h"
+#include "vtkCommunicator.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataSet.h"
 #include "vtkDataSet.h"
@@ -27,12 +28,17 @@
 #include "vtkReductionFilter.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTimerLog.h"
 #include "vtkTrivialProducer.h"
 
 #include <vtksys/ios/sstream>
+#include <vtksys/SystemInformation.hxx>
 #include <vtksys/SystemTools.hxx>
 
+#include <algorithm>
+#include <map>
 #include <string>
+#include <vector>
 
 vtkStandardNewMacro(vtkParallelSerialWriter);
 vtkCxxSetObjectMacro(vtkParallelSerialWriter, Writer, vtkAlgorithm);
@@ -59,6 +65,17 @@ vtkParallelSerialWriter::vtkParallelSerialWriter()
   this->NumberOfTimeSteps = 0;
   this->CurrentTimeIndex = 0;
 
+  this->NumberOfIOGroups = 1;
+  this->GroupByNode = 0;
+  this->LastWriteTime = 0.0;
+  this->LastBytesWritten = 0.0;
+
+  this->GroupController = 0;
+  this->PartitionedController = 0;
+  this->GroupId = 0;
+  this->NumberOfGroups = 1;
+  this->GroupConfiguration[0] = this->GroupConfiguration[1] = -1;
+
   this->Interpreter = 0;
   this->SetInterpreter(vtkClientServerInterpreterInitializer::GetGlobalInterpreter());
 }
@@ -72,6 +89,10 @@ vtkParallelSerialWriter::~vtkParallelSerialWriter()
   this->SetPreGatherHelper(0);
   this->SetPostGatherHelper(0);
   this->SetInterpreter(0);
+  if (this->GroupController)
+    {
+    this->GroupController->Delete();
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -167,6 +188,12 @@ int vtkParallelSerialWriter::RequestData(
     this->CurrentTimeIndex = 0;
     }
 
+  if (!write_all || this->CurrentTimeIndex == 0)
+    {
+    this->LastWriteTime = 0.0;
+    this->LastBytesWritten = 0.0;
+    }
+
   vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
   vtkDataObject* input = inInfo->Get(vtkDataObject::DATA_OBJECT());
   this->WriteATimestep(input);
@@ -227,8 +254,12 @@ void vtkParallelSerialWriter::WriteAFile(const char* filename, vtkDataObject* in
   vtkMultiProcessController* controller =
     vtkMultiProcessController::GetGlobalController();
 
+  double startTime = vtkTimerLog::GetUniversalTime();
+  double bytesWritten = 0.0;
+  vtkMultiProcessController* groupController = this->UpdateGroups(controller);
+
   vtkSmartPointer<vtkReductionFilter> md = vtkSmartPointer<vtkReductionFilter>::New();
-  md->SetController(controller);
+  md->SetController(groupController);
   md->SetPreGatherHelper(this->PreGatherHelper);
   md->SetPostGatherHelper(this->PostGatherHelper);
   if (input)
@@ -251,7 +282,7 @@ void vtkParallelSerialWriter::WriteAFile(const char* filename, vtkDataObject* in
     this->GhostLevel);
   md->Update();
 
-  if (controller->GetLocalProcessId() == 0)
+  if (groupController->GetLocalProcessId() == 0)
     {
     vtkDataObject* output = md->GetOutputDataObject(0);
     if (vtkDataSet::SafeDownCast(output) == 0 ||
@@ -262,7 +293,7 @@ void vtkParallelSerialWriter::WriteAFile(const char* filename, vtkDataObject* in
       outputCopy->ShallowCopy(output);
 
       vtksys_ios::ostringstream fname;
-      if (this->WriteAllTimeSteps)
+      if (this->WriteAllTimeSteps || this->NumberOfGroups > 1)
         {
         std::string path =
           vtksys::SystemTools::GetFilenamePath(filename);
@@ -270,7 +301,16 @@ void vtkParallelSerialWriter::WriteAFile(const char* filename, vtkDataObject* in
           vtksys::SystemTools::GetFilenameWithoutLastExtension(filename);
         std::string ext =
           vtksys::SystemTools::GetFilenameLastExtension(filename);
-        fname << path << "/" << fnamenoext << "." << this->CurrentTimeIndex << ext;
+        fname << path << "/" << fnamenoext;
+        if (this->NumberOfGroups > 1)
+          {
+          fname << "_" << this->GroupId;
+          }
+        if (this->WriteAllTimeSteps)
+          {
+          fname << "." << this->CurrentTimeIndex;
+          }
+        fname << ext;
         }
       else
         {
@@ -283,8 +323,120 @@ void vtkParallelSerialWriter::WriteAFile(const char* filename, vtkDataObject* in
       this->SetWriterFileName(fname.str().c_str());
       this->WriteInternal();
       this->Writer->SetInputConnection(0);
+      bytesWritten = static_cast<double>(
+        vtksys::SystemTools::FileLength(fname.str().c_str()));
       }
     }
+
+  double elapsed = vtkTimerLog::GetUniversalTime() - startTime;
+  double maxElapsed = elapsed;
+  double totalBytes = bytesWritten;
+  if (controller->GetNumberOfProcesses() > 1)
+    {
+    controller->AllReduce(&elapsed, &maxElapsed, 1, vtkCommunicator::MAX_OP);
+    controller->AllReduce(&bytesWritten, &totalBytes, 1, vtkCommunicator::SUM_OP);
+    }
+  this->LastWriteTime += maxElapsed;
+  this->LastBytesWritten += totalBytes;
+}
+
+//----------------------------------------------------------------------------
+vtkMultiProcessController* vtkParallelSerialWriter::UpdateGroups(
+  vtkMultiProcessController* controller)
+{
+  int numProcs = controller->GetNumberOfProcesses();
+  if (numProcs <= 1 || (this->NumberOfIOGroups == 1 && !this->GroupByNode))
+    {
+    this->GroupId = 0;
+    this->NumberOfGroups = 1;
+    return controller;
+    }
+
+  if (this->GroupController && this->PartitionedController == controller &&
+    this->GroupConfiguration[0] == this->NumberOfIOGroups &&
+    this->GroupConfiguration[1] == this->GroupByNode)
+    {
+    return this->GroupController;
+    }
+
+  int rank = controller->GetLocalProcessId();
+  int numGroups = 1;
+  int groupId = 0;
+  if (this->GroupByNode)
+    {
+    // identify nodes by their host name, numbered in the order of their
+    // first process.
+    vtksys::SystemInformation sysinfo;
+    std::string hostname = sysinfo.GetHostname();
+    vtkIdType length = static_cast<vtkIdType>(hostname.size());
+    std::vector<vtkIdType> lengths(numProcs);
+    controller->AllGather(&length, &lengths[0], 1);
+    std::vector<vtkIdType> offsets(numProcs);
+    vtkIdType totalLength = 0;
+    for (int cc = 0; cc < numProcs; ++cc)
+      {
+      offsets[cc] = totalLength;
+      totalLength += lengths[cc];
+      }
+    std::vector<char> hostnames(totalLength + 1);
+    controller->AllGatherV(hostname.c_str(), &hostnames[0], length,
+      &lengths[0], &offsets[0]);
+
+    std::map<std::string, int> nodeIds;
+    for (int cc = 0; cc < numProcs; ++cc)
+      {
+      std::string name(&hostnames[offsets[cc]], lengths[cc]);
+      if (nodeIds.find(name) == nodeIds.end())
+        {
+        int nodeId = static_cast<int>(nodeIds.size());
+        nodeIds[name] = nodeId;
+        }
+      }
+    int numNodes = static_cast<int>(nodeIds.size());
+    numGroups = this->NumberOfIOGroups > 0?
+      std::min(this->NumberOfIOGroups, numNodes) : numNodes;
+    groupId = static_cast<int>(
+      (static_cast<vtkIdType>(nodeIds[hostname]) * numGroups) / numNodes);
+    }
+  else
+    {
+    numGroups = std::min(std::max(this->NumberOfIOGroups, 1), numProcs);
+    groupId = static_cast<int>(
+      (static_cast<vtkIdType>(rank) * numGroups) / numProcs);
+    }
+
+  if (this->GroupController)
+    {
+    this->GroupController->Delete();
+    this->GroupController = 0;
+    }
+  this->GroupId = 0;
+  this->NumberOfGroups = 1;
+  if (numGroups <= 1)
+    {
+    return controller;
+    }
+
+  this->GroupController = controller->PartitionController(groupId, rank);
+  if (!this->GroupController)
+    {
+    vtkWarningMacro("Failed to split the processes in groups. "
+      "Data will be written to a single file.");
+    return controller;
+    }
+  this->PartitionedController = controller;
+  this->GroupConfiguration[0] = this->NumberOfIOGroups;
+  this->GroupConfiguration[1] = this->GroupByNode;
+  this->GroupId = groupId;
+  this->NumberOfGroups = numGroups;
+  return this->GroupController;
+}
+
+//----------------------------------------------------------------------------
+double vtkParallelSerialWriter::GetLastWriteThroughput()
+{
+  return this->LastWriteTime > 0.0?
+    this->LastBytesWritten / (1024.0 * 1024.0 * this->LastWriteTime) : 0.0;
 }
 
 //----------------------------------------------------------------------------
@@ -336,4 +488,8 @@ void vtkParallelSerialWriter::SetWriterFileName(const char* fname)
 void vtkParallelSerialWriter::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfIOGroups: " << this->NumberOfIOGroups << endl;
+  os << indent << "GroupByNode: " << this->GroupByNode << endl;
+  os << indent << "LastWriteTime: " << this->LastWriteTime << endl;
+  os << indent << "LastBytesWritten: " << this->LastBytesWritten << endl;
 }
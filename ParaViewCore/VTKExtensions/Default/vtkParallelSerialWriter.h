@@ -20,6 +20,13 @@
 // and PostGatherHelper.
 // This also makes it possible to write time-series for temporal datasets using
 // simple non-time-aware writers.
+//
+// Instead of gathering everything to the 1st node, the processes can be
+// split into NumberOfIOGroups groups (N-to-M aggregation). The data of each
+// group is gathered to the first process of the group, which writes it to
+// a file of its own, in parallel with the other groups. With GroupByNode,
+// groups are made of whole nodes, so that the gather only involves
+// processes sharing a node.
 
 #ifndef __vtkParallelSerialWriter_h
 #define __vtkParallelSerialWriter_h
@@ -28,6 +35,7 @@
 #include "vtkDataObjectAlgorithm.h"
 
 class vtkClientServerInterpreter;
+class vtkMultiProcessController;
 
 class VTKPVVTKEXTENSIONSDEFAULT_EXPORT vtkParallelSerialWriter : public vtkDataObjectAlgorithm
 {
@@ -97,6 +105,30 @@ public:
   vtkSetMacro(WriteAllTimeSteps, int);
   vtkBooleanMacro(WriteAllTimeSteps, int);
 
+  // Description:
+  // Number of files written in parallel. When greater than 1, the file
+  // written by group i is named after FileName with "_i" appended before
+  // the extension. With GroupByNode, 0 means one group per node. Default
+  // is 1, i.e. all data is written to a single file.
+  vtkSetClampMacro(NumberOfIOGroups, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfIOGroups, int);
+
+  // Description:
+  // When set, processes running on the same host always belong to the same
+  // group and groups are made of consecutive nodes. Off by default.
+  vtkSetMacro(GroupByNode, int);
+  vtkGetMacro(GroupByNode, int);
+  vtkBooleanMacro(GroupByNode, int);
+
+  // Description:
+  // Statistics about the last call to Write(), for all processes: the time
+  // spent gathering and writing (the maximum over all processes, in
+  // seconds), the number of bytes written to all files and the resulting
+  // throughput in MB/s.
+  vtkGetMacro(LastWriteTime, double);
+  vtkGetMacro(LastBytesWritten, double);
+  double GetLastWriteThroughput();
+
 //BTX
   // Description:
   // Get/Set the interpreter to use to call methods on the writer.
@@ -127,6 +159,11 @@ private:
   void SetWriterFileName(const char* fname);
   void WriteInternal();
 
+  // Split the processes in groups. Returns the controller the data is
+  // gathered on, either the global controller or the group's one.
+  vtkMultiProcessController* UpdateGroups(
+    vtkMultiProcessController* controller);
+
   vtkAlgorithm* PreGatherHelper;
   vtkAlgorithm* PostGatherHelper;
 
@@ -140,6 +177,19 @@ private:
   int NumberOfTimeSteps;
   int CurrentTimeIndex;
 
+  int NumberOfIOGroups;
+  int GroupByNode;
+  double LastWriteTime;
+  double LastBytesWritten;
+
+  // Group of this process, valid for the controller and configuration it
+  // was computed for.
+  vtkMultiProcessController* GroupController;
+  vtkMultiProcessController* PartitionedController;
+  int GroupId;
+  int NumberOfGroups;
+  int GroupConfiguration[2];
+
   // The name of the output file.
   char* FileName;
 
@@ -0,0 +1,139 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestKdTreeManager.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Moves a point cloud on every process and checks when vtkKdTreeManager
+// rebuilds the KdTree: only for the first build, when data falls outside of
+// the KdTree or when the data would be too unevenly distributed. Reusing the
+// KdTree must not modify it, and the KdTree must not keep the datasets once
+// it is built.
+
+#include "vtkCellArray.h"
+#include "vtkKdTreeManager.h"
+#include "vtkMPIController.h"
+#include "vtkNew.h"
+#include "vtkPKdTree.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+
+namespace
+{
+  // 10x10x10 vertices with x in [x0, x0 + width] and y, z in [0, 1].
+  void SetPoints(vtkPolyData* data, double x0, double width)
+    {
+    vtkNew<vtkPoints> points;
+    points->SetDataTypeToDouble();
+    for (int k = 0; k < 10; ++k)
+      {
+      for (int j = 0; j < 10; ++j)
+        {
+        for (int i = 0; i < 10; ++i)
+          {
+          points->InsertNextPoint(x0 + width * (i + 0.5) / 10,
+            (j + 0.5) / 10, (k + 0.5) / 10);
+          }
+        }
+      }
+    data->SetPoints(points.GetPointer());
+    if (data->GetNumberOfVerts() == 0)
+      {
+      vtkNew<vtkCellArray> verts;
+      for (vtkIdType cc = 0; cc < points->GetNumberOfPoints(); ++cc)
+        {
+        verts->InsertNextCell(1, &cc);
+        }
+      data->SetVerts(verts.GetPointer());
+      }
+    }
+
+  // Generates the KdTree and checks whether it was rebuilt.
+  bool TestGenerate(vtkMultiProcessController* controller,
+    vtkKdTreeManager* manager, bool expectRebuild, const char* what)
+    {
+    vtkPKdTree* tree = manager->GetKdTree();
+    unsigned long mtime = tree->GetMTime();
+    manager->GenerateKdTree();
+    bool rebuilt = tree->GetMTime() > mtime;
+
+    int status = 1;
+    if (rebuilt != expectRebuild)
+      {
+      cerr << what << ": the KdTree should "
+        << (expectRebuild? "" : "not ") << "have been rebuilt." << endl;
+      status = 0;
+      }
+    if (tree->GetNumberOfDataSets() != 0)
+      {
+      cerr << what << ": the KdTree still holds "
+        << tree->GetNumberOfDataSets() << " datasets." << endl;
+      status = 0;
+      }
+    if (tree->GetNumberOfRegions() < controller->GetNumberOfProcesses())
+      {
+      cerr << what << ": the KdTree has only " << tree->GetNumberOfRegions()
+        << " regions." << endl;
+      status = 0;
+      }
+    int allStatus = 0;
+    controller->AllReduce(&status, &allStatus, 1, vtkCommunicator::MIN_OP);
+    return allStatus != 0;
+    }
+}
+
+int TestKdTreeManager(int argc, char* argv[])
+{
+  vtkMPIController* controller = vtkMPIController::New();
+  controller->Initialize(&argc, &argv, 0);
+  vtkMultiProcessController::SetGlobalController(controller);
+
+  int rank = controller->GetLocalProcessId();
+  int numProcs = controller->GetNumberOfProcesses();
+
+  // The manager uses the global controller, it must be created after it.
+  vtkNew<vtkKdTreeManager> manager;
+  manager->SetMaximumLoadImbalance(1.5);
+  vtkNew<vtkPolyData> data;
+  SetPoints(data.GetPointer(), rank, 1.0);
+  manager->AddDataObject(data.GetPointer());
+
+  bool success = TestGenerate(controller, manager.GetPointer(), true,
+    "First build");
+  success = success && TestGenerate(controller, manager.GetPointer(), false,
+    "Unchanged data");
+
+  // Every process keeps its cells, the load is unchanged.
+  SetPoints(data.GetPointer(), rank + 0.1, 0.8);
+  success = success && TestGenerate(controller, manager.GetPointer(), false,
+    "Balanced data");
+
+  // All the cells end up in the regions of the first process.
+  SetPoints(data.GetPointer(), 0.1, 0.8);
+  success = success && TestGenerate(controller, manager.GetPointer(),
+    numProcs > 1, "Unbalanced data");
+  success = success && TestGenerate(controller, manager.GetPointer(), false,
+    "Unchanged data after rebuild");
+
+  SetPoints(data.GetPointer(), numProcs + 1, 1.0);
+  success = success && TestGenerate(controller, manager.GetPointer(), true,
+    "Data outside of the KdTree");
+
+  // Any change rebuilds the KdTree.
+  manager->SetMaximumLoadImbalance(1.0);
+  data->Modified();
+  success = success && TestGenerate(controller, manager.GetPointer(), true,
+    "MaximumLoadImbalance=1");
+
+  controller->Finalize();
+  controller->Delete();
+  return success? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,188 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestReductionFilterTree.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Reduces one small table per process with vtkReductionFilter and checks that
+// the tree reduction produces the same table, in the same order, as the flat
+// gather while never handing more than TreeFanIn inputs to the
+// PostGatherHelper on the root. A helper that is not associative on every
+// process must fall back to the flat gather.
+
+#include "vtkDoubleArray.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkIntArray.h"
+#include "vtkMPIController.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPVMergeTables.h"
+#include "vtkReductionFilter.h"
+#include "vtkTable.h"
+#include "vtkTrivialProducer.h"
+
+namespace
+{
+  // vtkPVMergeTables recording the largest number of inputs it reduced at
+  // once.
+  class vtkCountingMergeTables : public vtkPVMergeTables
+  {
+  public:
+    static vtkCountingMergeTables* New();
+    vtkTypeMacro(vtkCountingMergeTables, vtkPVMergeTables);
+
+    int MaximumNumberOfInputs;
+
+  protected:
+    vtkCountingMergeTables() : MaximumNumberOfInputs(0) {}
+
+    virtual int RequestData(vtkInformation* request,
+      vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+      {
+      int numInputs = inputVector[0]->GetNumberOfInformationObjects();
+      if (numInputs > this->MaximumNumberOfInputs)
+        {
+        this->MaximumNumberOfInputs = numInputs;
+        }
+      return this->Superclass::RequestData(request, inputVector, outputVector);
+      }
+  };
+  vtkStandardNewMacro(vtkCountingMergeTables);
+
+  // rank+1 rows with the rank and a value unique to the row.
+  void MakeLocalTable(vtkTable* table, int rank)
+    {
+    vtkNew<vtkIntArray> ranks;
+    ranks->SetName("Rank");
+    vtkNew<vtkDoubleArray> values;
+    values->SetName("Value");
+    for (int cc = 0; cc <= rank; ++cc)
+      {
+      ranks->InsertNextValue(rank);
+      values->InsertNextValue(100.0 * rank + cc);
+      }
+    table->AddColumn(ranks.GetPointer());
+    table->AddColumn(values.GetPointer());
+    }
+
+  // The rows of all processes, in the order of the processes.
+  bool CheckTable(vtkTable* table, int numProcs)
+    {
+    vtkIntArray* ranks = vtkIntArray::SafeDownCast(
+      table->GetColumnByName("Rank"));
+    vtkDoubleArray* values = vtkDoubleArray::SafeDownCast(
+      table->GetColumnByName("Value"));
+    vtkIdType expectedRows = numProcs * (numProcs + 1) / 2;
+    if (ranks == NULL || values == NULL ||
+      table->GetNumberOfRows() != expectedRows)
+      {
+      cerr << "Expected " << expectedRows << " rows, got "
+        << table->GetNumberOfRows() << endl;
+      return false;
+      }
+    vtkIdType row = 0;
+    for (int rank = 0; rank < numProcs; ++rank)
+      {
+      for (int cc = 0; cc <= rank; ++cc, ++row)
+        {
+        if (ranks->GetValue(row) != rank ||
+          values->GetValue(row) != 100.0 * rank + cc)
+          {
+          cerr << "Row " << row << " holds (" << ranks->GetValue(row) << ", "
+            << values->GetValue(row) << ") instead of (" << rank << ", "
+            << 100.0 * rank + cc << ")" << endl;
+          return false;
+          }
+        }
+      }
+    return true;
+    }
+
+  // Reduces the local table and checks the result on the root, where the
+  // helper must have reduced between `minInputs` and `maxInputs` inputs in its
+  // largest execution.
+  bool TestConfiguration(vtkMultiProcessController* controller,
+    vtkTable* localTable, int useTree, int fanIn, bool associative,
+    int minInputs, int maxInputs)
+    {
+    int rank = controller->GetLocalProcessId();
+    int numProcs = controller->GetNumberOfProcesses();
+
+    vtkNew<vtkCountingMergeTables> helper;
+    if (!associative && rank == 1)
+      {
+      helper->GetInformation()->Remove(vtkReductionFilter::ASSOCIATIVE());
+      }
+
+    vtkNew<vtkTrivialProducer> producer;
+    producer->SetOutput(localTable);
+    vtkNew<vtkReductionFilter> reducer;
+    reducer->SetController(controller);
+    reducer->SetPostGatherHelper(helper.GetPointer());
+    reducer->SetUseTreeReduction(useTree);
+    reducer->SetTreeFanIn(fanIn);
+    reducer->SetInputConnection(producer->GetOutputPort());
+    reducer->Update();
+
+    int status = 1;
+    if (rank == 0)
+      {
+      vtkTable* output = vtkTable::SafeDownCast(reducer->GetOutputDataObject(0));
+      status = (output != NULL && CheckTable(output, numProcs))? 1 : 0;
+      if (status && (helper->MaximumNumberOfInputs < minInputs ||
+          helper->MaximumNumberOfInputs > maxInputs))
+        {
+        cerr << "The root reduced up to " << helper->MaximumNumberOfInputs
+          << " inputs at once, expected between " << minInputs << " and "
+          << maxInputs << endl;
+        status = 0;
+        }
+      if (!status)
+        {
+        cerr << "Failed with UseTreeReduction=" << useTree << ", TreeFanIn="
+          << fanIn << " and an associative helper on "
+          << (associative? "all processes" : "all processes but one") << endl;
+        }
+      }
+    controller->Broadcast(&status, 1, 0);
+    return status != 0;
+    }
+}
+
+int TestReductionFilterTree(int argc, char* argv[])
+{
+  vtkMPIController* controller = vtkMPIController::New();
+  controller->Initialize(&argc, &argv, 0);
+  vtkMultiProcessController::SetGlobalController(controller);
+
+  int numProcs = controller->GetNumberOfProcesses();
+  vtkNew<vtkTable> localTable;
+  MakeLocalTable(localTable.GetPointer(), controller->GetLocalProcessId());
+
+  bool success =
+    // flat gather, the reference.
+    TestConfiguration(controller, localTable.GetPointer(), 0, 2, true,
+      numProcs, numProcs) &&
+    // binary tree.
+    TestConfiguration(controller, localTable.GetPointer(), 1, 2, true,
+      2, 2) &&
+    // groups that do not divide the number of processes.
+    TestConfiguration(controller, localTable.GetPointer(), 1, 3, true,
+      3, 3) &&
+    // one process without an associative helper.
+    TestConfiguration(controller, localTable.GetPointer(), 1, 2, false,
+      numProcs, numProcs);
+
+  controller->Finalize();
+  controller->Delete();
+  return success? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,195 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestResampledAMRImageSourceBlocks.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Resamples a two level AMR built in memory and checks every sample of the
+// resampled image against the donor cell expected from the geometry: the
+// finest block containing the sample. The level 1 block is also provided
+// before the level 0 one to check that coarser data never overwrites finer
+// data.
+#include "vtkAMRBox.h"
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkOverlappingAMR.h"
+#include "vtkPointData.h"
+#include "vtkResampledAMRImageSource.h"
+#include "vtkStructuredData.h"
+#include "vtkUniformGrid.h"
+
+#include <cmath>
+
+namespace
+{
+  // Both levels have 8 cells along each axis. Level 0 covers [0, 1]^3 and
+  // level 1 covers [0.25, 0.75]^3.
+  const int NumberOfCells = 8;
+  const double Spacing[2] = { 1.0 / 8.0, 1.0 / 16.0 };
+  const double Origin[2] = { 0.0, 0.25 };
+
+  double PointValue(const double x[3])
+    {
+    return x[0] + 2.0 * x[1] + 4.0 * x[2];
+    }
+
+  vtkUniformGrid* NewGrid(int level)
+    {
+    vtkUniformGrid* grid = vtkUniformGrid::New();
+    grid->SetOrigin(Origin[level], Origin[level], Origin[level]);
+    grid->SetSpacing(Spacing[level], Spacing[level], Spacing[level]);
+    grid->SetDimensions(NumberOfCells + 1, NumberOfCells + 1, NumberOfCells + 1);
+
+    vtkNew<vtkDoubleArray> cellValues;
+    cellValues->SetName("CellValue");
+    cellValues->SetNumberOfTuples(grid->GetNumberOfCells());
+    for (vtkIdType cc = 0; cc < grid->GetNumberOfCells(); cc++)
+      {
+      cellValues->SetValue(cc, 1000.0 * level + cc);
+      }
+    grid->GetCellData()->AddArray(cellValues.GetPointer());
+
+    vtkNew<vtkDoubleArray> pointValues;
+    pointValues->SetName("PointValue");
+    pointValues->SetNumberOfTuples(grid->GetNumberOfPoints());
+    for (vtkIdType cc = 0; cc < grid->GetNumberOfPoints(); cc++)
+      {
+      double x[3];
+      grid->GetPoint(cc, x);
+      pointValues->SetValue(cc, PointValue(x));
+      }
+    grid->GetPointData()->AddArray(pointValues.GetPointer());
+    return grid;
+    }
+
+  // AMR with the level 0 and/or the level 1 block.
+  void InitializeAMR(vtkOverlappingAMR* amr, bool coarse, bool fine)
+    {
+    int blocksPerLevel[2] = { 1, 1 };
+    double globalOrigin[3] = { 0.0, 0.0, 0.0 };
+    amr->Initialize(2, blocksPerLevel);
+    amr->SetOrigin(globalOrigin);
+    amr->SetGridDescription(VTK_XYZ_GRID);
+    for (int level = 0; level < 2; level++)
+      {
+      double spacing[3] = { Spacing[level], Spacing[level], Spacing[level] };
+      double origin[3] = { Origin[level], Origin[level], Origin[level] };
+      int dims[3] = { NumberOfCells + 1, NumberOfCells + 1, NumberOfCells + 1 };
+      amr->SetSpacing(level, spacing);
+      vtkAMRBox box(origin, dims, spacing, globalOrigin, VTK_XYZ_GRID);
+      amr->SetAMRBox(level, 0, box);
+      if ((level == 0 && coarse) || (level == 1 && fine))
+        {
+        vtkUniformGrid* grid = NewGrid(level);
+        amr->SetDataSet(level, 0, grid);
+        grid->Delete();
+        }
+      }
+    }
+
+  // The output is the dual of the resampled grid, so its points are the
+  // centers of the resampled cells.
+  bool Validate(vtkResampledAMRImageSource* resampler)
+    {
+    vtkImageData* output =
+      vtkImageData::SafeDownCast(resampler->GetOutputDataObject(0));
+    if (output == NULL)
+      {
+      cerr << "No resampled image." << endl;
+      return false;
+      }
+    vtkDataArray* cellValues = output->GetPointData()->GetArray("CellValue");
+    vtkDataArray* pointValues = output->GetPointData()->GetArray("PointValue");
+    if (cellValues == NULL || pointValues == NULL ||
+      output->GetNumberOfPoints() != 16 * 16 * 16)
+      {
+      cerr << "Unexpected resampled image." << endl;
+      return false;
+      }
+
+    for (vtkIdType cc = 0; cc < output->GetNumberOfPoints(); cc++)
+      {
+      double x[3];
+      output->GetPoint(cc, x);
+      int level = 0;
+      if (x[0] > 0.25 && x[0] < 0.75 && x[1] > 0.25 && x[1] < 0.75 &&
+        x[2] > 0.25 && x[2] < 0.75)
+        {
+        level = 1;
+        }
+      int ijk[3];
+      double center[3];
+      for (int axis = 0; axis < 3; axis++)
+        {
+        ijk[axis] = static_cast<int>(
+          std::floor((x[axis] - Origin[level]) / Spacing[level]));
+        center[axis] = Origin[level] + (ijk[axis] + 0.5) * Spacing[level];
+        }
+      int cellDims[3] = { NumberOfCells, NumberOfCells, NumberOfCells };
+      vtkIdType donorId = vtkStructuredData::ComputePointId(cellDims, ijk);
+
+      double expected = 1000.0 * level + donorId;
+      if (cellValues->GetTuple1(cc) != expected)
+        {
+        cerr << "CellValue at " << x[0] << ", " << x[1] << ", " << x[2]
+          << " is " << cellValues->GetTuple1(cc) << " instead of "
+          << expected << endl;
+        return false;
+        }
+      // point data is the average over the donor cell, i.e. the value at its
+      // center for a linear field.
+      if (std::fabs(pointValues->GetTuple1(cc) - PointValue(center)) > 1e-12)
+        {
+        cerr << "PointValue at " << x[0] << ", " << x[1] << ", " << x[2]
+          << " is " << pointValues->GetTuple1(cc) << " instead of "
+          << PointValue(center) << endl;
+        return false;
+        }
+      }
+    return true;
+    }
+}
+
+int TestResampledAMRImageSourceBlocks(int, char*[])
+{
+  // all blocks at once.
+  vtkNew<vtkOverlappingAMR> amr;
+  InitializeAMR(amr.GetPointer(), true, true);
+
+  vtkNew<vtkResampledAMRImageSource> resampler;
+  resampler->SetMaxDimensions(16, 16, 16);
+  resampler->UpdateResampledVolume(amr.GetPointer());
+  if (!Validate(resampler.GetPointer()))
+    {
+    cerr << "Failed to resample all blocks at once." << endl;
+    return EXIT_FAILURE;
+    }
+
+  // the fine block first, then the coarse one.
+  vtkNew<vtkOverlappingAMR> fine;
+  InitializeAMR(fine.GetPointer(), false, true);
+  vtkNew<vtkOverlappingAMR> coarse;
+  InitializeAMR(coarse.GetPointer(), true, false);
+
+  vtkNew<vtkResampledAMRImageSource> incremental;
+  incremental->SetMaxDimensions(16, 16, 16);
+  incremental->UpdateResampledVolume(fine.GetPointer());
+  incremental->UpdateResampledVolume(coarse.GetPointer());
+  if (!Validate(incremental.GetPointer()))
+    {
+    cerr << "Failed to resample the fine block before the coarse one." << endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
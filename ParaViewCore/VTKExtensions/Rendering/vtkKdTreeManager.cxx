@@ -28,12 +28,47 @@
 #include "vtkSphereSource.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
 #include <set>
 #include <vector>
 
 class vtkKdTreeManager::vtkDataObjectSet : 
   public std::set<vtkSmartPointer<vtkDataObject> > {};
 
+class vtkKdTreeManager::vtkDataObjectKeys :
+  public std::set<vtkDataObject*> {};
+
+namespace
+{
+  // Maximum number of cells per dataset located in the KdTree to estimate
+  // the load imbalance.
+  const vtkIdType vtkKdTreeManagerMaximumSamples = 100000;
+
+  void vtkCollectDataSets(vtkDataObject* data, std::vector<vtkDataSet*>& datasets)
+    {
+    vtkCompositeDataSet* mbs = vtkCompositeDataSet::SafeDownCast(data);
+    if (!mbs)
+      {
+      if (vtkDataSet* ds = vtkDataSet::SafeDownCast(data))
+        {
+        datasets.push_back(ds);
+        }
+      return;
+      }
+
+    vtkCompositeDataIterator* iter = mbs->NewIterator();
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+      iter->GoToNextItem())
+      {
+      if (vtkDataSet* ds = vtkDataSet::SafeDownCast(iter->GetCurrentDataObject()))
+        {
+        datasets.push_back(ds);
+        }
+      }
+    iter->Delete();
+    }
+}
+
 vtkStandardNewMacro(vtkKdTreeManager);
 //----------------------------------------------------------------------------
 vtkKdTreeManager::vtkKdTreeManager()
@@ -45,7 +80,9 @@ vtkKdTreeManager::vtkKdTreeManager()
     vtkWarningMacro("No global controller");
     }
   this->DataObjects = new vtkDataObjectSet();
+  this->GeneratedDataObjects = new vtkDataObjectKeys();
   this->KdTree = 0;
+  this->MaximumLoadImbalance = 1.5;
   this->NumberOfPieces = globalController?
     globalController->GetNumberOfProcesses() : 1;
   this->KdTreeInitialized = false;
@@ -69,6 +106,7 @@ vtkKdTreeManager::~vtkKdTreeManager()
   this->SetKdTree(0);
 
   delete this->DataObjects;
+  delete this->GeneratedDataObjects;
 }
 
 //----------------------------------------------------------------------------
@@ -101,16 +139,155 @@ void vtkKdTreeManager::SetStructuredDataInformation(
   const int whole_extent[6],
   const double origin[3], const double spacing[3])
 {
-  this->ExtentTranslator = translator;
+  unsigned long mtime = this->GetMTime();
   this->SetWholeExtent(const_cast<int*>(whole_extent));
   this->SetOrigin(const_cast<double*>(origin));
   this->SetSpacing(const_cast<double*>(spacing));
+  if (this->ExtentTranslator != translator || this->GetMTime() > mtime)
+    {
+    this->ExtentTranslator = translator;
+    this->StructuredDataInformationTime.Modified();
+    }
   this->Modified();
 }
 
+//----------------------------------------------------------------------------
+void vtkKdTreeManager::RemoveStructuredDataInformation()
+{
+  if (this->ExtentTranslator)
+    {
+    this->ExtentTranslator = NULL;
+    this->StructuredDataInformationTime.Modified();
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkKdTreeManager::CanReuseKdTree()
+{
+  vtkMultiProcessController* controller = this->KdTree->GetController();
+  int numProcs = controller? controller->GetNumberOfProcesses() : 1;
+
+  // First, find out if the KdTree must be rebuilt anyways, if any data
+  // changed and if all data is within the bounds of the KdTree, since cells
+  // outside of it cannot be assigned to any process. All processes must take
+  // the same decision, hence the flags are reduced.
+  bool rebuild = !this->KdTreeInitialized ||
+    this->StructuredDataInformationTime > this->GenerateTime ||
+    (this->ExtentTranslator &&
+     this->ExtentTranslator->GetMTime() > this->GenerateTime);
+  bool changed = (this->DataObjects->size() != this->GeneratedDataObjects->size());
+  std::vector<vtkDataSet*> datasets;
+  for (vtkDataObjectSet::iterator iter = this->DataObjects->begin();
+    iter != this->DataObjects->end(); ++iter)
+    {
+    changed = changed ||
+      this->GeneratedDataObjects->count(iter->GetPointer()) == 0 ||
+      (*iter)->GetMTime() > this->GenerateTime;
+    vtkCollectDataSets(iter->GetPointer(), datasets);
+    }
+
+  double bounds[6] = { 1, -1, 1, -1, 1, -1 };
+  this->KdTree->GetBounds(bounds);
+  vtkBoundingBox treeBBox(bounds);
+  bool outside = false;
+  for (size_t cc=0; cc < datasets.size() && !outside; cc++)
+    {
+    if (datasets[cc]->GetNumberOfCells() > 0)
+      {
+      datasets[cc]->GetBounds(bounds);
+      outside = !treeBBox.ContainsPoint(bounds[0], bounds[2], bounds[4]) ||
+        !treeBBox.ContainsPoint(bounds[1], bounds[3], bounds[5]);
+      }
+    }
+
+  double flags[3] = { rebuild? 1.0 : 0.0, changed? 1.0 : 0.0,
+    outside? 1.0 : 0.0 };
+  if (controller && numProcs > 1)
+    {
+    double local[3] = { flags[0], flags[1], flags[2] };
+    controller->AllReduce(local, flags, 3, vtkCommunicator::MAX_OP);
+    }
+  if (flags[0] != 0.0)
+    {
+    return false;
+    }
+  if (flags[1] == 0.0)
+    {
+    return true;
+    }
+  if (flags[2] != 0.0)
+    {
+    return false;
+    }
+
+  // Structured cuts follow the partitioning of the structured data and
+  // wouldn't change by rebuilding.
+  if (this->ExtentTranslator)
+    {
+    return true;
+    }
+  if (this->MaximumLoadImbalance <= 1.0)
+    {
+    return false;
+    }
+
+  // Estimate the number of cells each process would end up with after
+  // redistribution, locating (a sample of) the cell centers in the KdTree.
+  std::vector<double> loads(numProcs, 0.0);
+  for (size_t cc=0; cc < datasets.size(); cc++)
+    {
+    vtkDataSet* ds = datasets[cc];
+    vtkIdType numCells = ds->GetNumberOfCells();
+    vtkIdType stride = std::max<vtkIdType>(1,
+      numCells / vtkKdTreeManagerMaximumSamples);
+    for (vtkIdType cellId=0; cellId < numCells; cellId += stride)
+      {
+      ds->GetCellBounds(cellId, bounds);
+      int region = this->KdTree->GetRegionContainingPoint(
+        0.5*(bounds[0] + bounds[1]), 0.5*(bounds[2] + bounds[3]),
+        0.5*(bounds[4] + bounds[5]));
+      int proc = region >= 0? this->KdTree->GetProcessAssignedToRegion(region) : -1;
+      if (proc >= 0 && proc < numProcs)
+        {
+        loads[proc] += stride;
+        }
+      }
+    }
+  if (controller && numProcs > 1)
+    {
+    std::vector<double> local(loads);
+    controller->AllReduce(&local[0], &loads[0], numProcs, vtkCommunicator::SUM_OP);
+    }
+
+  double total = 0.0, maximum = 0.0;
+  for (int cc=0; cc < numProcs; cc++)
+    {
+    total += loads[cc];
+    maximum = std::max(maximum, loads[cc]);
+    }
+  return total <= 0.0 ||
+    maximum <= this->MaximumLoadImbalance * total / numProcs;
+}
+
 //----------------------------------------------------------------------------
 void vtkKdTreeManager::GenerateKdTree()
 {
+  bool reuse = this->CanReuseKdTree();
+  this->GeneratedDataObjects->clear();
+  for (vtkDataObjectSet::iterator iter = this->DataObjects->begin();
+    iter != this->DataObjects->end(); ++iter)
+    {
+    this->GeneratedDataObjects->insert(iter->GetPointer());
+    }
+  this->GenerateTime.Modified();
+  if (reuse)
+    {
+    // Keep the cuts (and the MTime) of the current KdTree so that only the
+    // data that changed needs to be redistributed.
+    return;
+    }
+
   this->KdTree->RemoveAllDataSets();
   if (!this->KdTreeInitialized)
     {
@@ -171,6 +348,11 @@ void vtkKdTreeManager::GenerateKdTree()
 
   this->KdTree->BuildLocator();
   //this->KdTree->PrintTree();
+
+  // Only the cuts and the region assignments are used once the locator is
+  // built. Release the datasets now, since the KdTree may be reused for a long
+  // time. This is the last change to the KdTree, reusing it won't modify it.
+  this->KdTree->RemoveAllDataSets();
 }
 
 //-----------------------------------------------------------------------------
@@ -289,6 +471,7 @@ void vtkKdTreeManager::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
   os << indent << "KdTree: " << this->KdTree << endl;
   os << indent << "NumberOfPieces: " << this->NumberOfPieces << endl;
+  os << indent << "MaximumLoadImbalance: " << this->MaximumLoadImbalance << endl;
 }
 
 
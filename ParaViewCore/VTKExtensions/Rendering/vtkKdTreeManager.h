@@ -21,6 +21,15 @@
 // translator. This class manages this logic. When structure data's extent
 // translator is to be used, it simply uses vtkKdTreeGenerator. Otherwise, it
 // lets the vtkPKdTree build the optimal partitioning for the data.
+//
+// Since changing the cuts requires all data to be redistributed, the KdTree
+// is only rebuilt by GenerateKdTree() when the cuts no longer suit the data:
+// when the structured data information changed, when some data falls outside
+// of the KdTree or when the data would be too unevenly distributed among the
+// processes (see MaximumLoadImbalance). Otherwise the KdTree is left
+// untouched, hence its MTime doesn't change either. The datasets are removed
+// from the KdTree once it is built, so that it doesn't keep the data alive
+// while it is reused.
 
 #ifndef __vtkKdTreeManager_h
 #define __vtkKdTreeManager_h
@@ -49,11 +58,12 @@ public:
 
   // Description:
   // Set the optional extent translator to use to get aid in building the
-  // KdTree.
+  // KdTree. RemoveStructuredDataInformation() removes it.
   void SetStructuredDataInformation(
     vtkExtentTranslator* translator,
     const int whole_extent[6],
     const double origin[3], const double spacing[3]);
+  void RemoveStructuredDataInformation();
 
   // Description:
   // Get/Set the KdTree managed by this manager.
@@ -68,7 +78,16 @@ public:
   vtkGetMacro(NumberOfPieces, int);
 
   // Description:
-  // Rebuilds the KdTree.
+  // Get/Set the largest ratio between the number of cells of the most loaded
+  // process and the average number of cells per process for which the cuts
+  // of the current KdTree are kept when data changes. Set to 1 or less to
+  // rebuild the KdTree whenever data changes. Default is 1.5.
+  vtkSetMacro(MaximumLoadImbalance, double);
+  vtkGetMacro(MaximumLoadImbalance, double);
+
+  // Description:
+  // Rebuilds the KdTree, unless the cuts of the current KdTree can be kept
+  // for the data. This is a collective operation.
   void GenerateKdTree();
 
 //BTX
@@ -79,9 +98,20 @@ protected:
   void AddDataObjectToKdTree(vtkDataObject *data);
   void AddDataSetToKdTree(vtkDataSet *data);
 
+  // Description:
+  // Returns true if the cuts of the current KdTree can be used for the data
+  // objects. This is a collective operation.
+  bool CanReuseKdTree();
+
   bool KdTreeInitialized;
   vtkPKdTree* KdTree;
   int NumberOfPieces;
+  double MaximumLoadImbalance;
+
+  // Time of the last GenerateKdTree() and of the last change to the
+  // structured data information.
+  vtkTimeStamp GenerateTime;
+  vtkTimeStamp StructuredDataInformationTime;
 
   vtkSmartPointer<vtkExtentTranslator> ExtentTranslator;
   double Origin[3];
@@ -99,6 +129,11 @@ private:
   class vtkDataObjectSet;
   vtkDataObjectSet* DataObjects;
 
+  // The data objects the KdTree was last generated for. Only used for
+  // comparison, hence the data objects are not referenced.
+  class vtkDataObjectKeys;
+  vtkDataObjectKeys* GeneratedDataObjects;
+
 //ETX
 };
 
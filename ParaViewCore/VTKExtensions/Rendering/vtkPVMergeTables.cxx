@@ -20,6 +20,7 @@
 #include "vtkInformationVector.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkObjectFactory.h"
+#include "vtkReductionFilter.h"
 #include "vtkSmartPointer.h"
 #include "vtkTable.h"
 #include "vtkVariant.h"
@@ -28,6 +29,8 @@ vtkStandardNewMacro(vtkPVMergeTables);
 //----------------------------------------------------------------------------
 vtkPVMergeTables::vtkPVMergeTables()
 {
+  // appending rows is associative, see vtkReductionFilter.
+  this->GetInformation()->Set(vtkReductionFilter::ASSOCIATIVE(), 1);
 }
 
 //----------------------------------------------------------------------------
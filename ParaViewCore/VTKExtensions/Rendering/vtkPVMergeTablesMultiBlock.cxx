@@ -20,6 +20,7 @@
 #include "vtkInformationVector.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkObjectFactory.h"
+#include "vtkReductionFilter.h"
 #include "vtkSmartPointer.h"
 #include "vtkTable.h"
 #include "vtkVariant.h"
@@ -31,6 +32,9 @@ vtkPVMergeTablesMultiBlock::vtkPVMergeTablesMultiBlock()
 {
   this->SetNumberOfInputPorts(1);
   this->SetNumberOfOutputPorts(1);
+
+  // appending rows is associative, see vtkReductionFilter.
+  this->GetInformation()->Set(vtkReductionFilter::ASSOCIATIVE(), 1);
 }
 
 //----------------------------------------------------------------------------
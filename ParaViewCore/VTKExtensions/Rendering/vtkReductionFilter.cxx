@@ -24,7 +24,9 @@
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationExecutivePortKey.h"
+#include "vtkInformationIntegerKey.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiProcessController.h"
 #include "vtkPVInstantiator.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
@@ -47,6 +49,7 @@ vtkStandardNewMacro(vtkReductionFilter);
 vtkCxxSetObjectMacro(vtkReductionFilter, Controller, vtkMultiProcessController);
 vtkCxxSetObjectMacro(vtkReductionFilter, PreGatherHelper, vtkAlgorithm);
 vtkCxxSetObjectMacro(vtkReductionFilter, PostGatherHelper, vtkAlgorithm);
+vtkInformationKeyMacro(vtkReductionFilter, ASSOCIATIVE, Integer);
 
 //-----------------------------------------------------------------------------
 vtkReductionFilter::vtkReductionFilter()
@@ -57,6 +60,8 @@ vtkReductionFilter::vtkReductionFilter()
   this->PostGatherHelper = 0;
   this->PassThrough = -1;
   this->GenerateProcessIds = 0;
+  this->UseTreeReduction = 0;
+  this->TreeFanIn = 8;
 }
 
 //-----------------------------------------------------------------------------
@@ -356,6 +361,13 @@ void vtkReductionFilter::Reduce(vtkDataObject* input, vtkDataObject* output)
     this->PassThrough = -1;
     }
 
+  if (this->UseTreeReduction && this->PassThrough < 0 &&
+    numProcs > this->TreeFanIn && this->IsPostGatherHelperAssociative())
+    {
+    this->TreeReduce(preOutput, output);
+    return;
+    }
+
   std::vector<vtkSmartPointer<vtkDataObject> > data_sets;
   if (myId == 0)
     {
@@ -403,6 +415,87 @@ void vtkReductionFilter::Reduce(vtkDataObject* input, vtkDataObject* output)
     }
 }
 
+//-----------------------------------------------------------------------------
+bool vtkReductionFilter::IsPostGatherHelperAssociative()
+{
+  int associative = (this->PostGatherHelper &&
+    this->PostGatherHelper->GetInformation()->Get(
+      vtkReductionFilter::ASSOCIATIVE()) != 0)? 1 : 0;
+  int allAssociative = 0;
+  this->Controller->AllReduce(&associative, &allAssociative, 1,
+    vtkCommunicator::MIN_OP);
+  return allAssociative != 0;
+}
+
+//-----------------------------------------------------------------------------
+void vtkReductionFilter::TreeReduce(vtkDataObject* preOutput,
+  vtkDataObject* output)
+{
+  vtkMultiProcessController* controller = this->Controller;
+  int myId = controller->GetLocalProcessId();
+  int numProcs = controller->GetNumberOfProcesses();
+  vtkTypeInt64 fanIn = this->TreeFanIn;
+
+  // At each level, the node at the head of a group of fanIn consecutive
+  // subtrees reduces their results, the others send theirs to the head and
+  // are done.
+  vtkSmartPointer<vtkDataObject> partial = preOutput;
+  bool reduced = false;
+  for (vtkTypeInt64 stride = 1; stride < numProcs; stride *= fanIn)
+    {
+    vtkTypeInt64 groupSize = stride * fanIn;
+    int head = static_cast<int>(myId - myId % groupSize);
+    if (head != myId)
+      {
+      this->Send(head, partial);
+      break;
+      }
+
+    std::vector<vtkSmartPointer<vtkDataObject> > data_sets;
+    if (partial)
+      {
+      data_sets.push_back(partial);
+      }
+    for (vtkTypeInt64 cc = 1; cc < fanIn && myId + cc * stride < numProcs; ++cc)
+      {
+      vtkSmartPointer<vtkDataObject> ds;
+      ds.TakeReference(this->Receive(static_cast<int>(myId + cc * stride),
+          output->GetDataObjectType()));
+      if (ds)
+        {
+        data_sets.push_back(ds);
+        }
+      }
+
+    if (data_sets.size() > 1)
+      {
+      partial.TakeReference(output->NewInstance());
+      this->PostProcess(partial, &data_sets[0],
+        static_cast<unsigned int>(data_sets.size()));
+      reduced = true;
+      }
+    else if (data_sets.size() == 1)
+      {
+      partial = data_sets[0];
+      }
+    }
+
+  // As in the flat reduction, the satellites produce their own result.
+  if (myId == 0 && reduced)
+    {
+    output->ShallowCopy(partial);
+    }
+  else
+    {
+    vtkSmartPointer<vtkDataObject> result = (myId == 0)? partial :
+      vtkSmartPointer<vtkDataObject>(preOutput);
+    if (result)
+      {
+      this->PostProcess(output, &result, 1);
+      }
+    }
+}
+
 //-----------------------------------------------------------------------------
 void vtkReductionFilter::Send(int receiver, vtkDataObject* data)
 {
@@ -459,4 +552,6 @@ void vtkReductionFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Controller: " << this->Controller << endl;
   os << indent << "PassThrough: " << this->PassThrough << endl;
   os << indent << "GenerateProcessIds: " << this->GenerateProcessIds << endl;
+  os << indent << "UseTreeReduction: " << this->UseTreeReduction << endl;
+  os << indent << "TreeFanIn: " << this->TreeFanIn << endl;
 }
@@ -26,6 +26,17 @@
 // In addition to doing reduction the PassThrough variable lets you choose
 // to pass through the results of any one node instead of aggregating all of
 // them together.
+//
+// When UseTreeReduction is set, the intermediate results are reduced along a
+// tree instead of being gathered on the root all at once. Each node of the
+// tree receives the results of up to TreeFanIn - 1 processes, runs the
+// PostGatherHelper on them and its own result, and sends the reduced result
+// up the tree. The root therefore only ever holds TreeFanIn inputs. This is
+// only valid if reducing partial results again gives the same result, so a
+// PostGatherHelper has to declare this by setting ASSOCIATIVE() in its
+// information (vtkAlgorithm::GetInformation()) on all processes. Otherwise
+// the results are gathered to the root as usual. The processes reduced at
+// each node are contiguous, so the order of the inputs is preserved.
 
 #ifndef __vtkReductionFilter_h
 #define __vtkReductionFilter_h
@@ -33,6 +44,7 @@
 #include "vtkDataObjectAlgorithm.h"
 #include "vtkSmartPointer.h" // needed for vtkSmartPointer.
 #include "vtkPVVTKExtensionsRenderingModule.h" // needed for export macro
+class vtkInformationIntegerKey;
 class vtkMultiProcessController;
 
 class VTKPVVTKEXTENSIONSRENDERING_EXPORT vtkReductionFilter : public vtkDataObjectAlgorithm
@@ -78,6 +90,28 @@ public:
   vtkSetMacro(GenerateProcessIds, int);
   vtkGetMacro(GenerateProcessIds, int);
 
+  // Description:
+  // When set, the results are reduced along a tree if the PostGatherHelper
+  // is associative (see ASSOCIATIVE()) and PassThrough is not used.
+  // Default is off.
+  vtkSetMacro(UseTreeReduction, int);
+  vtkGetMacro(UseTreeReduction, int);
+  vtkBooleanMacro(UseTreeReduction, int);
+
+  // Description:
+  // Get/Set the number of processes reduced at each node of the tree,
+  // including the node itself. Default is 8.
+  vtkSetClampMacro(TreeFanIn, int, 2, VTK_INT_MAX);
+  vtkGetMacro(TreeFanIn, int);
+
+  // Description:
+  // Key set to 1 in the information of a PostGatherHelper to indicate that
+  // it is associative, i.e. reducing the results of a contiguous range of
+  // processes and then reducing those partial results gives the same output
+  // as reducing all of the results at once. Applying it to a single input
+  // must return that input unchanged.
+  static vtkInformationIntegerKey* ASSOCIATIVE();
+
 //BTX
   enum Tags {
     TRANSMIT_DATA_OBJECT = 23484
@@ -104,6 +138,15 @@ protected:
     vtkSmartPointer<vtkDataObject> inputs[],
     unsigned int num_inputs);
 
+  // Description:
+  // Reduces the results along a tree, see UseTreeReduction.
+  void TreeReduce(vtkDataObject* preOutput, vtkDataObject* output);
+
+  // Description:
+  // Returns true if the PostGatherHelper is associative on all processes.
+  // This is a collective operation.
+  bool IsPostGatherHelperAssociative();
+
   void Send(int receiver, vtkDataObject*);
   vtkDataObject* Receive(int receiver, int dataobjectType);
 
@@ -112,6 +155,8 @@ protected:
   vtkMultiProcessController* Controller;
   int PassThrough;
   int GenerateProcessIds;
+  int UseTreeReduction;
+  int TreeFanIn;
 
 private:
   vtkReductionFilter(const vtkReductionFilter&); // Not implemented.
@@ -18,7 +18,7 @@
 #include "vtkAMRInformation.h"
 #include "vtkBoundingBox.h"
 #include "vtkCellData.h"
-#include "vtkIdList.h"
+#include "vtkDataArray.h"
 #include "vtkIntArray.h"
 #include "vtkMath.h"
 #include "vtkNew.h"
@@ -26,21 +26,339 @@
 #include "vtkOverlappingAMR.h"
 #include "vtkPointData.h"
 #include "vtkPVStreamingMacros.h"
+#include "vtkSMPTools.h"
+#include "vtkTimerLog.h"
 #include "vtkUniformGridAMRDataIterator.h"
 #include "vtkUniformGrid.h"
-#include "vtkVoxel.h"
 
 #include <algorithm>
 #include <assert.h>
+#include <cmath>
+#include <cstring>
+#include <vector>
 
 namespace
 {
-  static inline vtkIdType FindCell(
-    vtkImageData* image, double point[3])
+  // Receiver cells along one axis mapped to the index of the donor cell
+  // containing their centers, or -1. Only [Begin, End) has valid entries.
+  struct vtkAxisMap
     {
-    double pcoords[3]; int subid=0;
-    return image->vtkImageData::FindCell(
-      point, NULL, -1, 0.1, subid, pcoords, NULL);
+    std::vector<int> Donor;
+    int Begin;
+    int End;
+    };
+
+  // Arrays of a donor paired with the receiver arrays they are copied to.
+  struct vtkArrayPair
+    {
+    vtkAbstractArray* Source;
+    vtkAbstractArray* Target;
+    const unsigned char* SourcePointer;
+    unsigned char* TargetPointer;
+    int TupleSize; // in bytes, 0 for non-numeric arrays.
+    };
+
+  struct vtkDonorBlock
+    {
+    unsigned int Level;
+    int CellDimensions[3];
+    int PointDimensions[3];
+    vtkAxisMap Axis[3];
+    std::vector<vtkArrayPair> CellArrays;
+    std::vector<vtkArrayPair> PointArrays;
+    };
+
+  //---------------------------------------------------------------------------
+  // Pairs the arrays in `source` with the arrays of the same name (or at the
+  // same index, for unnamed arrays) in `target`.
+  void PairArrays(vtkFieldData* source, vtkFieldData* target,
+    std::vector<vtkArrayPair>& pairs)
+    {
+    for (int cc=0; cc < source->GetNumberOfArrays(); cc++)
+      {
+      vtkAbstractArray* src = source->GetAbstractArray(cc);
+      vtkAbstractArray* tgt = (src && src->GetName())?
+        target->GetAbstractArray(src->GetName()) :
+        target->GetAbstractArray(cc);
+      if (src == NULL || tgt == NULL ||
+        src->GetNumberOfComponents() != tgt->GetNumberOfComponents())
+        {
+        continue;
+        }
+      bool numeric = vtkDataArray::SafeDownCast(src) != NULL;
+      if (numeric != (vtkDataArray::SafeDownCast(tgt) != NULL) ||
+        (numeric && src->GetDataType() != tgt->GetDataType()))
+        {
+        // all blocks are expected to have the same arrays.
+        continue;
+        }
+      vtkArrayPair pair;
+      pair.Source = src;
+      pair.Target = tgt;
+      pair.SourcePointer = NULL;
+      pair.TargetPointer = NULL;
+      pair.TupleSize = 0;
+      if (numeric)
+        {
+        pair.SourcePointer =
+          static_cast<const unsigned char*>(src->GetVoidPointer(0));
+        pair.TargetPointer = static_cast<unsigned char*>(tgt->GetVoidPointer(0));
+        pair.TupleSize = src->GetNumberOfComponents() * src->GetDataTypeSize();
+        }
+      pairs.push_back(pair);
+      }
+    }
+
+  //---------------------------------------------------------------------------
+  // Determines the receiver cells covered by `donor` from the origin and
+  // spacing of both grids. Returns false if the donor covers none.
+  bool InitializeDonorBlock(vtkImageData* receiver, vtkPointData* receiverPD,
+    vtkImageData* donor, unsigned int level, vtkDonorBlock& block)
+    {
+    double rOrigin[3], rSpacing[3], dOrigin[3], dSpacing[3];
+    int rDims[3], dExtent[6];
+    receiver->GetOrigin(rOrigin);
+    receiver->GetSpacing(rSpacing);
+    receiver->GetDimensions(rDims);
+    donor->GetOrigin(dOrigin);
+    donor->GetSpacing(dSpacing);
+    donor->GetExtent(dExtent);
+    donor->GetDimensions(block.PointDimensions);
+    block.Level = level;
+
+    for (int axis=0; axis < 3; axis++)
+      {
+      int rCells = rDims[axis] - 1;
+      int dCells = std::max(block.PointDimensions[axis] - 1, 1);
+      double dMin = dOrigin[axis] + dExtent[2*axis] * dSpacing[axis];
+      block.CellDimensions[axis] = dCells;
+
+      vtkAxisMap& map = block.Axis[axis];
+      map.Donor.resize(rCells);
+      map.Begin = rCells;
+      map.End = 0;
+      for (int cc=0; cc < rCells; cc++)
+        {
+        double center = rOrigin[axis] + (cc + 0.5) * rSpacing[axis];
+        int index = 0;
+        if (block.PointDimensions[axis] > 1)
+          {
+          index = static_cast<int>(
+            std::floor((center - dMin) / dSpacing[axis]));
+          }
+        if (index < 0 || index >= dCells)
+          {
+          map.Donor[cc] = -1;
+          continue;
+          }
+        map.Donor[cc] = index;
+        map.Begin = std::min(map.Begin, cc);
+        map.End = std::max(map.End, cc + 1);
+        }
+      if (map.Begin >= map.End)
+        {
+        return false;
+        }
+      }
+
+    PairArrays(donor->GetCellData(), receiver->GetCellData(),
+      block.CellArrays);
+    if (receiverPD)
+      {
+      PairArrays(donor->GetPointData(), receiverPD, block.PointArrays);
+      }
+    return true;
+    }
+
+  //---------------------------------------------------------------------------
+  template <class T>
+  void AveragePoints(const T* source, T* target, int numComps,
+    const vtkIdType* ptIds, int numPts, vtkIdType targetId)
+    {
+    for (int comp=0; comp < numComps; comp++)
+      {
+      double sum = 0.0;
+      for (int cc=0; cc < numPts; cc++)
+        {
+        sum += static_cast<double>(source[ptIds[cc]*numComps + comp]);
+        }
+      target[targetId*numComps + comp] = static_cast<T>(sum / numPts);
+      }
+    }
+
+  //---------------------------------------------------------------------------
+  // Resamples the donor blocks into the receiver. The receiver is split
+  // along Z so that every cell is written by a single thread, which applies
+  // the blocks in order.
+  class vtkResampleFunctor
+    {
+  public:
+    vtkResampleFunctor(const std::vector<vtkDonorBlock>& blocks,
+      vtkImageData* receiver, vtkIntArray* donorLevel)
+      : Blocks(blocks), DonorLevel(donorLevel->GetPointer(0))
+      {
+      receiver->GetDimensions(this->Dimensions);
+      this->Dimensions[0] -= 1;
+      this->Dimensions[1] -= 1;
+      this->Dimensions[2] -= 1;
+      this->SliceChanged.resize(this->Dimensions[2], 0);
+      }
+
+    bool GetSomethingChanged() const
+      {
+      return std::find(this->SliceChanged.begin(), this->SliceChanged.end(),
+        1) != this->SliceChanged.end();
+      }
+
+    void operator()(vtkIdType kBegin, vtkIdType kEnd)
+      {
+      for (size_t cc=0; cc < this->Blocks.size(); cc++)
+        {
+        const vtkDonorBlock& block = this->Blocks[cc];
+        int begin = std::max(static_cast<int>(kBegin), block.Axis[2].Begin);
+        int end = std::min(static_cast<int>(kEnd), block.Axis[2].End);
+        for (int k=begin; k < end; k++)
+          {
+          if (block.Axis[2].Donor[k] >= 0)
+            {
+            this->ResampleSlice(block, k);
+            }
+          }
+        }
+      }
+
+  private:
+    void ResampleSlice(const vtkDonorBlock& block, int k)
+      {
+      const int level = static_cast<int>(block.Level);
+      const std::vector<int>& iMap = block.Axis[0].Donor;
+      const int iBegin = block.Axis[0].Begin;
+      const int iEnd = block.Axis[0].End;
+      const vtkIdType dk = block.Axis[2].Donor[k];
+      for (int j=block.Axis[1].Begin; j < block.Axis[1].End; j++)
+        {
+        const vtkIdType dj = block.Axis[1].Donor[j];
+        if (dj < 0)
+          {
+          continue;
+          }
+        const vtkIdType rowOffset = this->Dimensions[0] *
+          (j + static_cast<vtkIdType>(this->Dimensions[1]) * k);
+        const vtkIdType donorRowOffset = block.CellDimensions[0] *
+          (dj + static_cast<vtkIdType>(block.CellDimensions[1]) * dk);
+        for (int i=iBegin; i < iEnd;)
+          {
+          vtkIdType receiverId = rowOffset + i;
+          if (iMap[i] < 0 || this->DonorLevel[receiverId] > level)
+            {
+            ++i;
+            continue;
+            }
+          // extend the run while consecutive receiver cells map to
+          // consecutive donor cells.
+          int run = 1;
+          while (i + run < iEnd && iMap[i + run] == iMap[i] + run &&
+            this->DonorLevel[receiverId + run] <= level)
+            {
+            ++run;
+            }
+          this->CopyRun(block, donorRowOffset + iMap[i], receiverId, run);
+          std::fill(this->DonorLevel + receiverId,
+            this->DonorLevel + receiverId + run, level);
+          this->SliceChanged[k] = 1;
+          i += run;
+          }
+        }
+      }
+
+    void CopyRun(const vtkDonorBlock& block, vtkIdType donorId,
+      vtkIdType receiverId, int run)
+      {
+      for (size_t cc=0; cc < block.CellArrays.size(); cc++)
+        {
+        const vtkArrayPair& pair = block.CellArrays[cc];
+        if (pair.TupleSize > 0)
+          {
+          memcpy(pair.TargetPointer + receiverId * pair.TupleSize,
+            pair.SourcePointer + donorId * pair.TupleSize,
+            static_cast<size_t>(run) * pair.TupleSize);
+          }
+        else
+          {
+          for (int r=0; r < run; r++)
+            {
+            pair.Target->SetTuple(receiverId + r, donorId + r, pair.Source);
+            }
+          }
+        }
+
+      if (block.PointArrays.empty())
+        {
+        return;
+        }
+
+      // point data is passed as the average of the points of the donor cell.
+      const int* pdims = block.PointDimensions;
+      const int* cdims = block.CellDimensions;
+      for (int r=0; r < run; r++)
+        {
+        vtkIdType cellId = donorId + r;
+        vtkIdType ijk[3];
+        ijk[0] = cellId % cdims[0];
+        ijk[1] = (cellId / cdims[0]) % cdims[1];
+        ijk[2] = cellId / (static_cast<vtkIdType>(cdims[0]) * cdims[1]);
+
+        vtkIdType ptIds[8];
+        int numPts = 0;
+        for (int c=0; c <= (pdims[2] > 1? 1 : 0); c++)
+          {
+          for (int b=0; b <= (pdims[1] > 1? 1 : 0); b++)
+            {
+            for (int a=0; a <= (pdims[0] > 1? 1 : 0); a++)
+              {
+              ptIds[numPts++] = (ijk[0] + a) + pdims[0] *
+                ((ijk[1] + b) + static_cast<vtkIdType>(pdims[1]) * (ijk[2] + c));
+              }
+            }
+          }
+
+        for (size_t cc=0; cc < block.PointArrays.size(); cc++)
+          {
+          const vtkArrayPair& pair = block.PointArrays[cc];
+          if (pair.TupleSize == 0)
+            {
+            continue;
+            }
+          int numComps = pair.Source->GetNumberOfComponents();
+          switch (pair.Source->GetDataType())
+            {
+            vtkTemplateMacro(
+              AveragePoints(
+                reinterpret_cast<const VTK_TT*>(pair.SourcePointer),
+                reinterpret_cast<VTK_TT*>(pair.TargetPointer),
+                numComps, ptIds, numPts, receiverId + r));
+            }
+          }
+        }
+      }
+
+    const std::vector<vtkDonorBlock>& Blocks;
+    int* DonorLevel;
+    int Dimensions[3];
+    std::vector<char> SliceChanged;
+    };
+
+  //---------------------------------------------------------------------------
+  bool ResampleBlocks(const std::vector<vtkDonorBlock>& blocks,
+    vtkImageData* receiver, vtkIntArray* donorLevel)
+    {
+    if (blocks.empty())
+      {
+      return false;
+      }
+    vtkResampleFunctor functor(blocks, receiver, donorLevel);
+    vtkSMPTools::For(0, receiver->GetDimensions()[2] - 1, functor);
+    return functor.GetSomethingChanged();
     }
 }
 
@@ -50,6 +368,7 @@ vtkResampledAMRImageSource::vtkResampledAMRImageSource()
 {
   this->MaxDimensions[0] = this->MaxDimensions[1] = this->MaxDimensions[2] = 32;
   vtkMath::UninitializeBounds(this->SpatialBounds);
+  this->LastResampleTime = 0.0;
 }
 
 //----------------------------------------------------------------------------
@@ -77,10 +396,11 @@ void vtkResampledAMRImageSource::UpdateResampledVolume(
       }
     }
 
-  // Now, fill in values from datasets in the amr.
+  vtkTimerLog::MarkStartEvent("vtkResampledAMRImageSource::Resample");
+  double startTime = vtkTimerLog::GetUniversalTime();
 
-  bool something_changed = false;
-  const vtkAMRInformation* amrInfo = amr->GetAMRInfo();
+  // Now, fill in values from datasets in the amr.
+  std::vector<vtkDonorBlock> blocks;
   vtkSmartPointer<vtkUniformGridAMRDataIterator> iter;
   iter.TakeReference(vtkUniformGridAMRDataIterator::SafeDownCast(
       amr->NewIterator()));
@@ -88,18 +408,26 @@ void vtkResampledAMRImageSource::UpdateResampledVolume(
     iter->GoToNextItem())
     {
     // note: this iteration "naturally" goes from datasets at lower levels to
-    // those at higher levels.
+    // those at higher levels. The blocks are applied in the same order.
     vtkImageData* data = vtkImageData::SafeDownCast(iter->GetCurrentDataObject());
     assert(data != NULL);
 
-    unsigned int level = iter->GetCurrentLevel();
-    unsigned int index = iter->GetCurrentIndex();
-
-    const vtkAMRBox& box = amrInfo->GetAMRBox(level, index);
-    bool val = this->UpdateResampledVolume(level, index, box, data);
-    something_changed |= val;
+    vtkDonorBlock block;
+    if (InitializeDonorBlock(this->ResampledAMR, this->ResampledAMRPointData,
+        data, iter->GetCurrentLevel(), block))
+      {
+      blocks.push_back(block);
+      }
     }
 
+  vtkStreamingStatusMacro("Resampling " << blocks.size() << " blocks");
+  bool something_changed =
+    ResampleBlocks(blocks, this->ResampledAMR, this->DonorLevel);
+
+  this->LastResampleTime = vtkTimerLog::GetUniversalTime() - startTime;
+  vtkTimerLog::MarkEndEvent("vtkResampledAMRImageSource::Resample");
+  vtkStreamingStatusMacro("Resample time: " << this->LastResampleTime << "s");
+
   if (something_changed)
     {
     // mark data modified, otherwise mappers are confused.
@@ -239,6 +567,7 @@ bool vtkResampledAMRImageSource::Initialize(vtkOverlappingAMR* amr)
   // Add point arrays in the output that correspond to the cell arrays in the
   // input.
   output->GetCellData()->CopyAllocate(reference->GetCellData(), numCells);
+  this->AllocateArrays(output->GetCellData(), numCells);
 
   if (reference->GetPointData()->GetNumberOfArrays() > 0)
     {
@@ -248,6 +577,7 @@ bool vtkResampledAMRImageSource::Initialize(vtkOverlappingAMR* amr)
     // the dualGrid directly.
     this->ResampledAMRPointData = vtkSmartPointer<vtkPointData>::New();
     this->ResampledAMRPointData->InterpolateAllocate(reference->GetPointData(), numCells);
+    this->AllocateArrays(this->ResampledAMRPointData, numCells);
     }
   else
     {
@@ -318,78 +648,37 @@ bool vtkResampledAMRImageSource::UpdateResampledVolume(
   (void)index;
   vtkStreamingStatusMacro("Updating with block at " << level << "," << index);
 
-  vtkBoundingBox donorBounds(donor->GetBounds());
-  vtkBoundingBox receiverBounds(this->ResampledAMR->GetBounds());
-
-  vtkBoundingBox updateBounds(receiverBounds);
-  if (!updateBounds.IntersectBox(donorBounds))
+  std::vector<vtkDonorBlock> blocks(1);
+  if (!InitializeDonorBlock(this->ResampledAMR, this->ResampledAMRPointData,
+      donor, level, blocks[0]))
     {
     // this block is skipped since it doesn't intersect our region on interest.
     return false;
     }
+  return ResampleBlocks(blocks, this->ResampledAMR, this->DonorLevel);
+}
 
-  bool something_changed = false;
-  double receiver_spacing[3];
-  this->ResampledAMR->GetSpacing(receiver_spacing);
-
-  vtkNew<vtkIdList> cellPoints;
-
-  for (double z = updateBounds.GetMinPoint()[2] ;
-    z <= updateBounds.GetMaxPoint()[2]; z+= receiver_spacing[2])
+//----------------------------------------------------------------------------
+void vtkResampledAMRImageSource::AllocateArrays(
+  vtkFieldData* fd, vtkIdType numTuples)
+{
+  // the resampled values are written directly into the arrays, so they are
+  // sized upfront. Cells not covered by any block are zero.
+  for (int cc=0; cc < fd->GetNumberOfArrays(); cc++)
     {
-    for (double y = updateBounds.GetMinPoint()[1];
-      y <= updateBounds.GetMaxPoint()[1]; y+= receiver_spacing[1])
+    vtkAbstractArray* array = fd->GetAbstractArray(cc);
+    array->SetNumberOfTuples(numTuples);
+    if (vtkDataArray::SafeDownCast(array) && numTuples > 0)
       {
-      for (double x = updateBounds.GetMinPoint()[0];
-        x < updateBounds.GetMaxPoint()[0]; x+= receiver_spacing[0])
-        {
-        double sample_point[3] = {x, y, z};
-        vtkIdType receiver_cellid = FindCell(this->ResampledAMR, sample_point);
-        if (receiver_cellid == -1 ||
-          receiver_cellid >= this->DonorLevel->GetNumberOfTuples()||
-          this->DonorLevel->GetValue(receiver_cellid) > static_cast<int>(level))
-          {
-          continue;
-          }
-        vtkIdType donor_cellId = FindCell(donor, sample_point);
-        if (donor_cellId == -1)
-          {
-          // the sample_point is not in the donor grid. This cannot happen since
-          // we have intersected the two boxes, but just in case.
-          continue;
-          }
-        this->ResampledAMR->GetCellData()->CopyData(
-          donor->GetCellData(), donor_cellId, receiver_cellid);
-        if (this->ResampledAMRPointData)
-          {
-          donor->GetCellPoints(donor_cellId, cellPoints.GetPointer());
-          vtkIdType numPoints = cellPoints->GetNumberOfIds();
-          assert(numPoints <= 8);
-          if (numPoints > 0)
-            {
-            double weight, weights[8];
-            weight = 1.0 / numPoints;
-            for (vtkIdType cc=0; cc < numPoints; cc++)
-              {
-              weights[cc] = weight;
-              }
-
-            this->ResampledAMRPointData->InterpolatePoint(
-              donor->GetPointData(), receiver_cellid, cellPoints.GetPointer(),
-              weights);
-            }
-          }
-        something_changed = true;
-        this->DonorLevel->SetValue(receiver_cellid, static_cast<int>(level));
-        }
+      memset(array->GetVoidPointer(0), 0, static_cast<size_t>(numTuples) *
+        array->GetNumberOfComponents() * array->GetDataTypeSize());
       }
     }
-  return something_changed;
 }
 
-
 //----------------------------------------------------------------------------
 void vtkResampledAMRImageSource::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "LastResampleTime: " << this->LastResampleTime << endl;
 }
@@ -23,6 +23,13 @@
 // input AMR have exactly the same point/cell arrays in same order. If they are
 // different we will end up with weird runtime issues that may be hard to debug.
 //
+// The donor cell for each cell of the resampled image is found from the
+// origin and spacing of the two grids, i.e. the cell containing the center of
+// the resampled cell. Tuples are copied directly between the raw arrays and
+// the resampled volume is split among threads (using vtkSMPTools) along the
+// Z axis. Blocks are applied in order of increasing level so that data from
+// a finer level is never overwritten by data from a coarser one.
+//
 // .SECTION Notes
 // We subclass vtkTrivialProducer since it deals with all the meta-data that
 // needs to be passed down the pipeline for image data, keeping the code here
@@ -36,6 +43,7 @@
 #include "vtkSmartPointer.h" // needed for vtkSmartPointer
 
 class vtkAMRBox;
+class vtkFieldData;
 class vtkImageData;
 class vtkIntArray;
 class vtkOverlappingAMR;
@@ -78,6 +86,11 @@ public:
   bool NeedsInitialization() const
     { return (this->MTime > this->InitializationTime); }
 
+  // Description:
+  // Returns the time, in seconds, taken by the last call to
+  // UpdateResampledVolume().
+  vtkGetMacro(LastResampleTime, double);
+
 //BTX
 protected:
   vtkResampledAMRImageSource();
@@ -87,8 +100,13 @@ protected:
   bool UpdateResampledVolume(const unsigned int &level,
     const unsigned& index, const vtkAMRBox& box, vtkImageData* data);
 
+  // Description:
+  // Sizes the arrays in fd to numTuples and fills them with zeros.
+  void AllocateArrays(vtkFieldData* fd, vtkIdType numTuples);
+
   int MaxDimensions[3];
   double SpatialBounds[6];
+  double LastResampleTime;
 
   vtkSmartPointer<vtkImageData> ResampledAMR;
   vtkSmartPointer<vtkPointData> ResampledAMRPointData;
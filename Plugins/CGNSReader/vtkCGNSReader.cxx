@@ -20,6 +20,7 @@
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkDataArraySelection.h"
+#include "vtkExtentTranslator.h"
 #include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
@@ -29,6 +30,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkStructuredGrid.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnsignedIntArray.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkVertex.h"
@@ -74,6 +76,94 @@ namespace
     private:
       int pair[2];
   };
+
+  // Add ghost point and cell arrays (vtkDataSetAttributes::GhostArrayName())
+  // to a piece of a split zone. ownedExtent is the point extent of the piece
+  // without ghost levels and wholeExtent the extent of the zone. Cells outside
+  // the owned extent are marked DUPLICATECELL. Points outside it are marked
+  // DUPLICATEPOINT, as are the points the piece shares with the next piece
+  // along an axis, so that every point is owned by exactly one piece.
+  void AddGhostArrays(vtkStructuredGrid* sgrid, const int ownedExtent[6],
+    const int wholeExtent[6])
+  {
+    int ext[6];
+    sgrid->GetExtent(ext);
+
+    // last owned point index along each axis.
+    int ownedPointExt[6];
+    for (int n = 0; n < 3; ++n)
+      {
+      ownedPointExt[2*n] = ownedExtent[2*n];
+      ownedPointExt[2*n+1] = ownedExtent[2*n+1];
+      if (ownedExtent[2*n+1] < wholeExtent[2*n+1])
+        {
+        ownedPointExt[2*n+1]--;
+        }
+      }
+
+    vtkUnsignedCharArray* pointGhosts = vtkUnsignedCharArray::New();
+    pointGhosts->SetName(vtkDataSetAttributes::GhostArrayName());
+    pointGhosts->SetNumberOfTuples(sgrid->GetNumberOfPoints());
+    unsigned char* ptr = pointGhosts->GetPointer(0);
+    for (int k = ext[4]; k <= ext[5]; ++k)
+      {
+      for (int j = ext[2]; j <= ext[3]; ++j)
+        {
+        for (int i = ext[0]; i <= ext[1]; ++i)
+          {
+          const int ijk[3] = {i, j, k};
+          unsigned char ghost = 0;
+          for (int n = 0; n < 3; ++n)
+            {
+            if (ijk[n] < ownedPointExt[2*n] || ijk[n] > ownedPointExt[2*n+1])
+              {
+              ghost = vtkDataSetAttributes::DUPLICATEPOINT;
+              }
+            }
+          *ptr++ = ghost;
+          }
+        }
+      }
+    sgrid->GetPointData()->AddArray(pointGhosts);
+    pointGhosts->Delete();
+
+    // Cells are indexed by their lowest corner point. A dimension without
+    // cells (flat zones) has a single cell layer at the extent's origin.
+    int cellExt[6];
+    int ownedCellExt[6];
+    for (int n = 0; n < 3; ++n)
+      {
+      cellExt[2*n] = ext[2*n];
+      cellExt[2*n+1] = std::max(ext[2*n], ext[2*n+1] - 1);
+      ownedCellExt[2*n] = ownedExtent[2*n];
+      ownedCellExt[2*n+1] = std::max(ownedExtent[2*n], ownedExtent[2*n+1] - 1);
+      }
+    vtkUnsignedCharArray* cellGhosts = vtkUnsignedCharArray::New();
+    cellGhosts->SetName(vtkDataSetAttributes::GhostArrayName());
+    cellGhosts->SetNumberOfTuples(sgrid->GetNumberOfCells());
+    ptr = cellGhosts->GetPointer(0);
+    for (int k = cellExt[4]; k <= cellExt[5]; ++k)
+      {
+      for (int j = cellExt[2]; j <= cellExt[3]; ++j)
+        {
+        for (int i = cellExt[0]; i <= cellExt[1]; ++i)
+          {
+          const int ijk[3] = {i, j, k};
+          unsigned char ghost = 0;
+          for (int n = 0; n < 3; ++n)
+            {
+            if (ijk[n] < ownedCellExt[2*n] || ijk[n] > ownedCellExt[2*n+1])
+              {
+              ghost = vtkDataSetAttributes::DUPLICATECELL;
+              }
+            }
+          *ptr++ = ghost;
+          }
+        }
+      }
+    sgrid->GetCellData()->AddArray(cellGhosts);
+    cellGhosts->Delete();
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -86,6 +176,7 @@ vtkCGNSReader::vtkCGNSReader()
   this->ActualTimeStep = 0;
   this->DoublePrecisionMesh = 1;
   this->CreateEachSolutionAsBlock = 0;
+  this->StructuredZoneSplitThreshold = 1000000;
 
   this->PointDataArraySelection = vtkDataArraySelection::New();
   this->CellDataArraySelection = vtkDataArraySelection::New();
@@ -564,7 +655,8 @@ int vtkCGNSReader::AttachReferenceValue(const int base, vtkDataSet* ds)
 int vtkCGNSReader::GetCurvilinearZone(int base, int zone,
                                       int cellDim, int physicalDim,
                                       cgsize_t *zsize,
-                                      vtkMultiBlockDataSet *mbase)
+                                      vtkMultiBlockDataSet *mbase,
+                                      const int* pieceExtent)
 {
   int rind[6];
   int n;
@@ -597,25 +689,29 @@ int vtkCGNSReader::GetCurvilinearZone(int base, int zone,
   this->getCoordsIdAndFillRind(GridCoordName, physicalDim,
                                nCoordsArray, gridChildId, rind);
 
+  // Point extent of the zone to read, either the whole zone or the piece
+  // of a zone split among processes (hyperslab read).
+  int extent[6] = {0,0,0,0,0,0};
+  for (n = 0; n < cellDim; n++)
+    {
+    extent[2*n]   = pieceExtent ? pieceExtent[2*n] : 0;
+    extent[2*n+1] = pieceExtent ? pieceExtent[2*n+1] :
+                                  static_cast<int>(zsize[n]) - 1;
+    }
+
   // Rind was parsed (or not) then populate dimensions :
   // Compute structured grid coordinate range
   for (n = 0; n < cellDim; n++)
     {
-    srcStart[n] = rind[2*n] + 1;
-    srcEnd[n]   = rind[2*n] + zsize[n];
-    memEnd[n]   = zsize[n];
-    memDims[n]  = zsize[n];
+    srcStart[n] = rind[2*n] + 1 + extent[2*n];
+    srcEnd[n]   = rind[2*n] + 1 + extent[2*n+1];
+    memEnd[n]   = extent[2*n+1] - extent[2*n] + 1;
+    memDims[n]  = memEnd[n];
     }
 
   // Compute number of points
   nPts = static_cast<vtkIdType>(memEnd[0]*memEnd[1]*memEnd[2]);
 
-  // Populate the extent array
-  int extent[6] = {0,0,0,0,0,0};
-  extent[1] = memEnd[0]-1;
-  extent[3] = memEnd[1]-1;
-  extent[5] = memEnd[2]-1;
-
   // wacky hack ...
   // memory aliasing is done
   // since in vtk points array stores XYZ contiguously
@@ -726,10 +822,11 @@ int vtkCGNSReader::GetCurvilinearZone(int base, int zone,
 
         for (n = 0; n < cellDim; ++n)
           {
-          fieldSrcStart[n] = rind[2*n] + 1;
-          fieldSrcEnd[n]   = rind[2*n] + zsize[n+nsc];
-          fieldMemEnd[n]   = zsize[n+nsc];
-          fieldMemDims[n]  = zsize[n+nsc];
+          // nsc != 0: one cell less than points in every direction
+          fieldSrcStart[n] = rind[2*n] + 1 + extent[2*n];
+          fieldMemEnd[n]   = extent[2*n+1] - extent[2*n] + (nsc ? 0 : 1);
+          fieldSrcEnd[n]   = fieldSrcStart[n] + fieldMemEnd[n] - 1;
+          fieldMemDims[n]  = fieldMemEnd[n];
           }
 
         // compute number of field values
@@ -918,10 +1015,11 @@ int vtkCGNSReader::GetCurvilinearZone(int base, int zone,
 
         for (n = 0; n < cellDim; ++n)
           {
-          fieldSrcStart[n] = rind[2*n] + 1;
-          fieldSrcEnd[n]   = rind[2*n] + zsize[n+nsc];
-          fieldMemEnd[n]   = zsize[n+nsc];
-          fieldMemDims[n]  = zsize[n+nsc];
+          // nsc != 0: one cell less than points in every direction
+          fieldSrcStart[n] = rind[2*n] + 1 + extent[2*n];
+          fieldMemEnd[n]   = extent[2*n+1] - extent[2*n] + (nsc ? 0 : 1);
+          fieldSrcEnd[n]   = fieldSrcStart[n] + fieldMemEnd[n] - 1;
+          fieldMemDims[n]  = fieldMemEnd[n];
           }
 
         // compute number of field values
@@ -1102,10 +1200,11 @@ int vtkCGNSReader::GetCurvilinearZone(int base, int zone,
 
         for (n = 0; n < cellDim; ++n)
           {
-          fieldSrcStart[n] = rind[2*n] + 1;
-          fieldSrcEnd[n]   = rind[2*n] + zsize[n+nsc];
-          fieldMemEnd[n]   = zsize[n+nsc];
-          fieldMemDims[n]  = zsize[n+nsc];
+          // nsc != 0: one cell less than points in every direction
+          fieldSrcStart[n] = rind[2*n] + 1 + extent[2*n];
+          fieldMemEnd[n]   = extent[2*n+1] - extent[2*n] + (nsc ? 0 : 1);
+          fieldSrcEnd[n]   = fieldSrcStart[n] + fieldMemEnd[n] - 1;
+          fieldMemDims[n]  = fieldMemEnd[n];
           }
 
         // compute number of field values
@@ -2253,6 +2352,19 @@ int vtkCGNSReader::RequestData(vtkInformation *vtkNotUsed(request),
     this->LoadBndPatch = 0;
     this->CreateEachSolutionAsBlock = 0;
     }
+
+  // Structured zones larger than StructuredZoneSplitThreshold are not
+  // assigned to a single process but split into IJK sub-extents, one per
+  // process, each read with hyperslab requests.
+  const bool splitZones =
+      (numProcessors > 1 && this->StructuredZoneSplitThreshold > 0);
+  int ghostLevels = 0;
+  if (outInfo->Has(
+        vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_GHOST_LEVELS()))
+    {
+    ghostLevels = outInfo->Get(
+          vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_GHOST_LEVELS());
+    }
 #endif
 
   if (!this->Internal.Parse(this->FileName))
@@ -2447,8 +2559,12 @@ int vtkCGNSReader::RequestData(vtkInformation *vtkNotUsed(request),
 #ifdef PARAVIEW_USE_MPI
     int zonemin = baseToZoneRange[numBase][0];
     int zonemax = baseToZoneRange[numBase][1];
-    for (int zone = zonemin; zone < zonemax; ++zone)
+    // When zones may be split, every process has to look at every zone to
+    // find out whether it gets a piece of it.
+    for (int zone = (splitZones ? 0 : zonemin);
+         zone < (splitZones ? nzones : zonemax); ++zone)
       {
+      const bool ownZone = (zone >= zonemin && zone < zonemax);
 #else
     for (int zone = 0; zone < nzones; ++zone)
       {
@@ -2544,6 +2660,45 @@ int vtkCGNSReader::RequestData(vtkInformation *vtkNotUsed(request),
           }
         }
 
+#ifdef PARAVIEW_USE_MPI
+      int pieceExtent[6] = {0,0,0,0,0,0};
+      int ownedExtent[6] = {0,0,0,0,0,0};
+      int wholeExtent[6] = {0,0,0,0,0,0};
+      bool splitZone = false;
+      if (splitZones && zt == CGNS_ENUMV(Structured))
+        {
+        vtkIdType nPts = 1;
+        for (int n = 0; n < cellDim; ++n)
+          {
+          nPts *= static_cast<vtkIdType>(zsize[n]);
+          wholeExtent[2*n+1] = static_cast<int>(zsize[n]) - 1;
+          }
+        splitZone = (nPts >= this->StructuredZoneSplitThreshold);
+        if (splitZone)
+          {
+          // Pieces are split by cells so that neighbouring pieces share
+          // their boundary points, as in other structured readers.
+          vtkExtentTranslator::PieceToExtentThreadSafe(
+                processNumber, numProcessors, 0, wholeExtent, ownedExtent,
+                vtkExtentTranslator::BLOCK_MODE, 0);
+          vtkExtentTranslator::PieceToExtentThreadSafe(
+                processNumber, numProcessors, ghostLevels, wholeExtent,
+                pieceExtent, vtkExtentTranslator::BLOCK_MODE, 0);
+          if (pieceExtent[0] > pieceExtent[1] ||
+              pieceExtent[2] > pieceExtent[3] ||
+              pieceExtent[4] > pieceExtent[5])
+            {
+            // more processes than cells: nothing to read here.
+            continue;
+            }
+          }
+        }
+      if (!splitZone && !ownZone)
+        {
+        continue;
+        }
+#endif
+
       switch (zt)
         {
         case CGNS_ENUMV(ZoneTypeNull):
@@ -2552,7 +2707,24 @@ int vtkCGNSReader::RequestData(vtkInformation *vtkNotUsed(request),
           break;
         case CGNS_ENUMV(Structured):
           {
-          ier = GetCurvilinearZone(numBase, zone, cellDim, physicalDim, zsize, mbase);
+#ifdef PARAVIEW_USE_MPI
+          if (splitZone)
+            {
+            ier = GetCurvilinearZone(numBase, zone, cellDim, physicalDim,
+                                     zsize, mbase, pieceExtent);
+            vtkStructuredGrid* piece =
+                vtkStructuredGrid::SafeDownCast(mbase->GetBlock(zone));
+            if (ier == CG_OK && piece)
+              {
+              AddGhostArrays(piece, ownedExtent, wholeExtent);
+              }
+            }
+          else
+#endif
+            {
+            ier = GetCurvilinearZone(numBase, zone, cellDim, physicalDim,
+                                     zsize, mbase);
+            }
           if (ier != CG_OK)
             {
             vtkErrorMacro(<< "Error Reading file");
@@ -2696,6 +2868,8 @@ void vtkCGNSReader::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "File Name: "
      << (this->FileName ? this->FileName : "(none)") << "\n";
+  os << indent << "StructuredZoneSplitThreshold: "
+     << this->StructuredZoneSplitThreshold << "\n";
 }
 
 //------------------------------------------------------------------------------
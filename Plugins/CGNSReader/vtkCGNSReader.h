@@ -100,6 +100,17 @@ public:
   vtkGetMacro(CreateEachSolutionAsBlock,int);
   vtkBooleanMacro(CreateEachSolutionAsBlock,int);
 
+  // Description:
+  // When running in parallel, structured zones with at least this many
+  // points are not assigned to a single process. Instead, every process
+  // reads an IJK sub-extent of them (plus the requested ghost levels). The
+  // points and cells a piece does not own are flagged in
+  // vtkDataSetAttributes::GhostArrayName() arrays.
+  // Smaller zones and unstructured zones are distributed whole among
+  // processes. A value of 0 disables splitting. Default is 1000000.
+  vtkSetClampMacro(StructuredZoneSplitThreshold, vtkIdType, 0, VTK_ID_MAX);
+  vtkGetMacro(StructuredZoneSplitThreshold, vtkIdType);
+
 #ifdef PARAVIEW_USE_MPI
   // Description:
   // Set/get the communication object used to relay a list of files
@@ -141,9 +152,12 @@ protected:
   static void SelectionModifiedCallback(vtkObject* caller, unsigned long eid,
                                         void* clientdata, void* calldata);
 
+  // Read a structured zone. If pieceExtent is given, only that (point)
+  // extent of the zone is read; the resulting grid uses zone indices.
   int GetCurvilinearZone(int  base, int zone,
                          int cell_dim, int phys_dim, cgsize_t *zsize,
-                         vtkMultiBlockDataSet *mbase);
+                         vtkMultiBlockDataSet *mbase,
+                         const int* pieceExtent = 0);
 
   int GetUnstructuredZone(int  base, int zone,
                           int cell_dim, int phys_dim, cgsize_t *zsize,
@@ -194,6 +208,7 @@ private:
   int LoadBndPatch; // option to set section loading for unstructured grid
   int DoublePrecisionMesh; // option to set mesh loading to double precision
   int CreateEachSolutionAsBlock; // debug option to create
+  vtkIdType StructuredZoneSplitThreshold; // min #points of a split zone
 
   // For internal cgio calls (low level IO)
   int cgioNum; // cgio file reference
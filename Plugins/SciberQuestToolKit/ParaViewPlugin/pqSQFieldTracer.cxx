@@ -24,15 +24,17 @@ pqSQFieldTracer::pqSQFieldTracer(
   std::cerr << ":::::pqSQFieldTracer::pqSQFieldTracer" << std::endl;
   #endif
 
-  // master and worker block sizes are only relevant if
-  // dynamic scheduling is selected. If it is not selected
-  // then disable master, and worker block entries.
+  // master and worker block sizes and work stealing are only
+  // relevant if dynamic scheduling is selected. If it is not
+  // selected then disable master, worker block and work stealing
+  // entries.
 
   QCheckBox *dynSched
     = this->findChild<QCheckBox*>("UseDynamicScheduler");
 
   QWidget *masterBlock=this->findChild<QWidget*>("MasterBlockSize");
   QWidget *workerBlock=this->findChild<QWidget*>("WorkerBlockSize");
+  QWidget *workStealing=this->findChild<QWidget*>("UseWorkStealing");
 
   // disable signals during construction. PV 3.16 will create/destroy
   // the panel as the object is selected/unselected in the browser.
@@ -40,23 +42,27 @@ pqSQFieldTracer::pqSQFieldTracer(
   dynSched->blockSignals(true);
   masterBlock->blockSignals(true);
   workerBlock->blockSignals(true);
+  workStealing->blockSignals(true);
 
   // initialize based on current state, set by PV SM.
   if (!dynSched->isChecked())
     {
     masterBlock->setEnabled(false);
     workerBlock->setEnabled(false);
+    workStealing->setEnabled(false);
     }
 
   // sync dyanmic load balancing toggle and its assoiciated items
   connect(dynSched,SIGNAL(clicked(bool)),masterBlock,SLOT(setEnabled(bool)));
   connect(dynSched,SIGNAL(clicked(bool)),workerBlock,SLOT(setEnabled(bool)));
+  connect(dynSched,SIGNAL(clicked(bool)),workStealing,SLOT(setEnabled(bool)));
 
   // enable signals now that things are setup.
   this->blockSignals(false);
   dynSched->blockSignals(false);
   masterBlock->blockSignals(false);
   workerBlock->blockSignals(false);
+  workStealing->blockSignals(false);
 }
 
 //-----------------------------------------------------------------------------
@@ -52,6 +52,11 @@ public:
   virtual int GetNumberOfComponents() const = 0;
   virtual MPI_File GetComponentFile(int comp=0) const = 0;
 
+  /**
+  Get the component memory maps, 0 if the file isn't mapped.
+  */
+  virtual const MemoryMappedFile *GetComponentMappedFile(int comp=0) const = 0;
+
   /**
   Get the array name.
   */
@@ -99,6 +104,14 @@ public: \
     { \
     return this->Step->name##s[this->Idx]->GetComponentFile(comp); \
     } \
+\
+  /** \
+  Get the component memory maps.\
+  */ \
+  virtual const MemoryMappedFile *GetComponentMappedFile(int comp=0) const \
+    { \
+    return this->Step->name##s[this->Idx]->GetComponentMappedFile(comp); \
+    } \
 \
   /** \
   Get the array name.\
@@ -22,11 +22,13 @@ Copyright 2012 SciberQuest Inc.
 #include "BOVArrayImageIterator.h"
 #include "CartesianDataBlockIODescriptor.h"
 #include "CartesianDataBlockIODescriptorIterator.h"
+#include "MemoryMappedFile.h"
 #include "MPIRawArrayIO.hxx"
 #include "SQMacros.h"
 #include "PrintUtils.h"
 
 #include <sstream>
+#include <cstring>
 
 #ifdef WIN32
   #define PATH_SEP "\\"
@@ -46,6 +48,47 @@ Copyright 2012 SciberQuest Inc.
   #include "vtkSQLog.h"
 #endif
 
+//-----------------------------------------------------------------------------
+template<typename T>
+void CopyMappedRegion(
+      const T *file,
+      const CartesianExtent &fileExt,
+      const CartesianExtent &fileRegion,
+      const CartesianExtent &memExt,
+      const CartesianExtent &memRegion,
+      T *mem)
+{
+  // copy i-runs of the region from the file into memory. This is
+  // what MPI-IO does with the subarray views of the descriptor.
+  size_t nFile[3];
+  fileExt.Size(nFile);
+
+  size_t nMem[3];
+  memExt.Size(nMem);
+
+  size_t nReg[3];
+  fileRegion.Size(nReg);
+
+  size_t nRun=nReg[0]*sizeof(T);
+
+  for (size_t k=0; k<nReg[2]; ++k)
+    {
+    size_t fk=fileRegion[4]-fileExt[4]+k;
+    size_t mk=memRegion[4]-memExt[4]+k;
+
+    for (size_t j=0; j<nReg[1]; ++j)
+      {
+      size_t fj=fileRegion[2]-fileExt[2]+j;
+      size_t mj=memRegion[2]-memExt[2]+j;
+
+      size_t fi=(fk*nFile[1]+fj)*nFile[0]+fileRegion[0]-fileExt[0];
+      size_t mi=(mk*nMem[1]+mj)*nMem[0]+memRegion[0]-memExt[0];
+
+      memcpy(mem+mi,file+fi,nRun);
+      }
+    }
+}
+
 //-----------------------------------------------------------------------------
 BOVReader::BOVReader()
       :
@@ -53,7 +96,9 @@ BOVReader::BOVReader()
   NGhost(1),
   ProcId(-1),
   NProcs(0),
-  VectorProjection(VECTOR_PROJECT_NONE)
+  VectorProjection(VECTOR_PROJECT_NONE),
+  UseMemoryMap(0),
+  BytesRead(0)
 {
   #ifdef SQTK_WITHOUT_MPI
   // don't report this error since the reader get's constructed
@@ -106,6 +151,7 @@ const BOVReader &BOVReader::operator=(const BOVReader &other)
   this->SetMetaData(other.GetMetaData());
   this->NGhost=other.NGhost;
   this->VectorProjection=other.VectorProjection;
+  this->UseMemoryMap=other.UseMemoryMap;
 
   return *this;
 }
@@ -380,22 +426,11 @@ int BOVReader::ReadScalarArray(
   scal->Delete();
   float *pScal=scal->GetPointer(0);
 
-  CartesianDataBlockIODescriptorIterator ioit(descr);
-  for (; ioit.Ok(); ioit.Next())
+  if (!this->ReadRegions(fhit.GetFile(),fhit.GetMappedFile(),descr,pScal))
     {
-    if (!ReadDataArray(
-            fhit.GetFile(),
-            this->Hints,
-            ioit.GetMemView(),
-            ioit.GetFileView(),
-            pScal))
-      {
-      sqErrorMacro(std::cerr,
-        << "ReadDataArray "<< fhit.GetName()
-        << " views " << ioit
-        << " failed.");
-      return 0;
-      }
+    sqErrorMacro(std::cerr,
+      << "ReadRegions "<< fhit.GetName() << " failed.");
+    return 0;
     }
 
   #if defined BOVReaderTIME
@@ -509,8 +544,6 @@ int BOVReader::ReadVectorArray(
   vec->Delete();
   float *pVec=vec->GetPointer(0);
 
-  CartesianDataBlockIODescriptorIterator ioit(descr);
-
   for (int q=0; q<nComps; ++q)
     {
     // if a projection is requested then we zero out
@@ -526,23 +559,18 @@ int BOVReader::ReadVectorArray(
       }
 
     // read the qth component
-    for (ioit.Initialize(); ioit.Ok(); ioit.Next())
-      {
-      if (!ReadDataArray(
-              fhit.GetComponentFile(q),
-              this->Hints,
-              ioit.GetMemView(),
-              ioit.GetFileView(),
-              buf))
-        {
-        sqErrorMacro(std::cerr,
-          << "ReadDataArray "<< fhit.GetName()
-          << " component " << q
-          << " views " << ioit
-          << " failed.");
-        free(buf);
-        return 0;
-        }
+    if (!this->ReadRegions(
+            fhit.GetComponentFile(q),
+            fhit.GetComponentMappedFile(q),
+            descr,
+            buf))
+      {
+      sqErrorMacro(std::cerr,
+        << "ReadRegions "<< fhit.GetName()
+        << " component " << q
+        << " failed.");
+      free(buf);
+      return 0;
       }
 
     for (size_t i=0; i<nPts; ++i)
@@ -662,30 +690,23 @@ int BOVReader::ReadSymetricTensorArray(
   vec->Delete();
   float *pVec=vec->GetPointer(0);
 
-  CartesianDataBlockIODescriptorIterator ioit(descr);
-
   // maps file component to memory component
   int memComp[6]={0,1,2,4,5,8};
 
   for (int q=0; q<6; ++q)
     {
-    for (ioit.Initialize(); ioit.Ok(); ioit.Next())
+    if (!this->ReadRegions(
+            fhit.GetComponentFile(q),
+            fhit.GetComponentMappedFile(q),
+            descr,
+            buf))
       {
-      if (!ReadDataArray(
-              fhit.GetComponentFile(q),
-              this->Hints,
-              ioit.GetMemView(),
-              ioit.GetFileView(),
-              buf))
-        {
-        sqErrorMacro(std::cerr,
-          << "ReadDataArray "<< fhit.GetName()
-          << " component " << q
-          << " views " << ioit
-          << " failed.");
-        free(buf);
-        return 0;
-        }
+      sqErrorMacro(std::cerr,
+        << "ReadRegions "<< fhit.GetName()
+        << " component " << q
+        << " failed.");
+      free(buf);
+      return 0;
       }
 
     for (size_t i=0; i<nPts; ++i)
@@ -733,6 +754,30 @@ BOVTimeStepImage *BOVReader::OpenTimeStep(int stepNo)
   BOVTimeStepImage *image
     = new BOVTimeStepImage(this->Comm,this->Hints,stepNo,this->GetMetaData());
 
+  if (this->UseMemoryMap)
+    {
+    int mapped=image->MapFiles();
+    #ifndef SQTK_WITHOUT_MPI
+    // the reads are collective, all processes have to take
+    // the same path.
+    if (this->NProcs>1)
+      {
+      int allMapped=0;
+      MPI_Allreduce(&mapped,&allMapped,1,MPI_INT,MPI_MIN,this->Comm);
+      mapped=allMapped;
+      }
+    #endif
+    if (!mapped)
+      {
+      sqWarningMacro(std::cerr,
+        << "Failed to memory map time step " << stepNo
+        << ". Falling back to MPI-IO.");
+      delete image;
+      image=new BOVTimeStepImage(
+            this->Comm,this->Hints,stepNo,this->GetMetaData());
+      }
+    }
+
   #if defined BOVReaderTIME
   log->EndEvent("BOVReader::OpenTimeStep");
   #endif
@@ -740,6 +785,131 @@ BOVTimeStepImage *BOVReader::OpenTimeStep(int stepNo)
   return image;
 }
 
+//-----------------------------------------------------------------------------
+int BOVReader::ReadRegions(
+      MPI_File file,
+      const MemoryMappedFile *map,
+      const CartesianDataBlockIODescriptor *descr,
+      float *buf)
+{
+  const CartesianExtent &fileExt=descr->GetFileExtent();
+  const CartesianExtent &memExt=descr->GetMemExtent();
+
+  if (map && (map->GetSize()<fileExt.Size()*sizeof(float)))
+    {
+    sqErrorMacro(std::cerr,
+      << "The mapped file is smaller than the extent " << fileExt << ".");
+    return 0;
+    }
+
+  CartesianDataBlockIODescriptorIterator ioit(descr);
+  for (; ioit.Ok(); ioit.Next())
+    {
+    if (map)
+      {
+      CopyMappedRegion<float>(
+            reinterpret_cast<const float*>(map->GetData()),
+            fileExt,
+            ioit.GetFileRegion(),
+            memExt,
+            ioit.GetMemRegion(),
+            buf);
+      }
+    else
+    if (!ReadDataArray(
+            file,
+            this->Hints,
+            ioit.GetMemView(),
+            ioit.GetFileView(),
+            buf))
+      {
+      sqErrorMacro(std::cerr,
+        << "ReadDataArray views " << ioit << " failed.");
+      return 0;
+      }
+
+    this->BytesRead+=ioit.GetFileRegion().Size()*sizeof(float);
+    }
+
+  return 1;
+}
+
+//-----------------------------------------------------------------------------
+static
+void PrefetchRegions(
+      const MemoryMappedFile *map,
+      const CartesianDataBlockIODescriptor *descr)
+{
+  if (!map)
+    {
+    return;
+    }
+
+  const CartesianExtent &fileExt=descr->GetFileExtent();
+  size_t nFile[3];
+  fileExt.Size(nFile);
+
+  // one hint per k-plane of each region. The hint covers whole
+  // rows when the region is narrower than the file, which is
+  // cheaper than a system call per i-run.
+  CartesianDataBlockIODescriptorIterator ioit(descr);
+  for (; ioit.Ok(); ioit.Next())
+    {
+    const CartesianExtent &reg=ioit.GetFileRegion();
+    for (int k=reg[4]; k<=reg[5]; ++k)
+      {
+      size_t fk=k-fileExt[4];
+      size_t lo=(fk*nFile[1]+reg[2]-fileExt[2])*nFile[0]+reg[0]-fileExt[0];
+      size_t hi=(fk*nFile[1]+reg[3]-fileExt[2])*nFile[0]+reg[1]-fileExt[0];
+      map->Prefetch(lo*sizeof(float),(hi-lo+1)*sizeof(float));
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void BOVReader::PrefetchTimeStep(
+      const BOVTimeStepImage *step,
+      const CartesianDataBlockIODescriptor *descr)
+{
+  if (!this->UseMemoryMap)
+    {
+    return;
+    }
+
+  BOVScalarImageIterator sIt(step);
+  for (;sIt.Ok();sIt.Next())
+    {
+    PrefetchRegions(sIt.GetMappedFile(),descr);
+    }
+
+  BOVVectorImageIterator vIt(step);
+  for (;vIt.Ok();vIt.Next())
+    {
+    for (int q=0; q<vIt.GetNumberOfComponents(); ++q)
+      {
+      PrefetchRegions(vIt.GetComponentMappedFile(q),descr);
+      }
+    }
+
+  BOVTensorImageIterator tIt(step);
+  for (;tIt.Ok();tIt.Next())
+    {
+    for (int q=0; q<tIt.GetNumberOfComponents(); ++q)
+      {
+      PrefetchRegions(tIt.GetComponentMappedFile(q),descr);
+      }
+    }
+
+  BOVSymetricTensorImageIterator stIt(step);
+  for (;stIt.Ok();stIt.Next())
+    {
+    for (int q=0; q<stIt.GetNumberOfComponents(); ++q)
+      {
+      PrefetchRegions(stIt.GetComponentMappedFile(q),descr);
+      }
+    }
+}
+
 //-----------------------------------------------------------------------------
 void BOVReader::CloseTimeStep(BOVTimeStepImage *handle)
 {
@@ -998,7 +1168,9 @@ void BOVReader::PrintSelf(ostream &os)
     << "  NGhost: " << this->NGhost << std::endl
     << "  ProcId: " << this->ProcId << std::endl
     << "  NProcs: " << this->NProcs << std::endl
-    << "  VectorProjection: " << this->VectorProjection << std::endl;
+    << "  VectorProjection: " << this->VectorProjection << std::endl
+    << "  UseMemoryMap: " << this->UseMemoryMap << std::endl
+    << "  BytesRead: " << this->BytesRead << std::endl;
 
   #ifndef SQTK_WITHOUT_MPI
   if (this->Hints!=MPI_INFO_NULL)
@@ -12,9 +12,10 @@ Copyright 2012 SciberQuest Inc.
 #ifdef SQTK_WITHOUT_MPI
 typedef void *MPI_Comm;
 typedef void *MPI_Info;
+typedef void *MPI_File;
 #else
 #include "SQMPICHWarningSupression.h" // for suppressing MPI warnings
-#include <mpi.h> // for MPI_Comm and MPI_Info
+#include <mpi.h> // for MPI_Comm, MPI_Info, and MPI_File
 #endif
 
 #include "RefCountedPointer.h" // for RefCountedPointer
@@ -26,6 +27,7 @@ class BOVScalarImageIterator;
 class BOVArrayImageIterator;
 class BOVTimeStepImage;
 class CartesianDataBlockIODescriptor;
+class MemoryMappedFile;
 
 /// Low level reader for BOV files with domain decomposition capability.
 /**
@@ -163,6 +165,34 @@ public:
   void SetVectorProjection(int mode){ this->VectorProjection=mode; }
   int GetVectorProjection(){ return this->VectorProjection; }
 
+  /**
+  When set the files of each time step are memory mapped in
+  OpenTimeStep and blocks read through an IO descriptor are
+  copied out of the map rather than read with MPI-IO. The OS
+  then only pages in the parts of the file that are touched,
+  and pages stay cached across blocks, time steps and the
+  processes of a node. If any of the files of a time step can't
+  be mapped, MPI-IO is used. Default is off.
+  */
+  void SetUseMemoryMap(int mode){ this->UseMemoryMap=mode; }
+  int GetUseMemoryMap() const { return this->UseMemoryMap; }
+
+  /**
+  Advise the OS to page in the file regions described by the
+  IO descriptor. The call returns immediately, it's a no-op
+  when the time step isn't memory mapped.
+  */
+  void PrefetchTimeStep(
+        const BOVTimeStepImage *handle,
+        const CartesianDataBlockIODescriptor *descr);
+
+  /**
+  Number of bytes read through IO descriptors since the last
+  reset, including ghost cells.
+  */
+  unsigned long long GetBytesRead() const { return this->BytesRead; }
+  void ResetBytesRead(){ this->BytesRead=0; }
+
   /**
   Print internal state.
   */
@@ -201,6 +231,16 @@ private:
         const CartesianDataBlockIODescriptor *descr,
         vtkDataSet *grid);
 
+  /**
+  Read the regions described by the IO descriptor from either the
+  memory map, when one is given, or the MPI file handle.
+  */
+  int ReadRegions(
+        MPI_File file,
+        const MemoryMappedFile *map,
+        const CartesianDataBlockIODescriptor *descr,
+        float *buf);
+
 private:
   BOVMetaData *MetaData;     // Object that knows how to interpret dataset.
   int NGhost;                // Number of ghost nodes, default is 1.
@@ -209,6 +249,8 @@ private:
   MPI_Comm Comm;             // Communicator handle
   MPI_Info Hints;            // MPI-IO file hints.
   int VectorProjection;      // Option to project onto axis aligned plane.
+  int UseMemoryMap;          // Read blocks from memory mapped files.
+  unsigned long long BytesRead; // Bytes read through IO descriptors.
 };
 
 #endif
@@ -8,8 +8,23 @@ Copyright 2012 SciberQuest Inc.
 */
 #include "BOVScalarImage.h"
 
+#include "MemoryMappedFile.h"
 #include "SQMacros.h"
 
+//-----------------------------------------------------------------------------
+static
+std::string CleanFileName(const char *fileName)
+{
+  // added this to deal with vpic data arrays which use spaces.
+  std::string cleanFileName=fileName;
+  size_t fileNameLen=cleanFileName.size();
+  for (size_t i=0; i<fileNameLen; ++i)
+    {
+    if (cleanFileName[i]==' ') cleanFileName[i]='-';
+    }
+  return cleanFileName;
+}
+
 //-----------------------------------------------------------------------------
 MPI_File Open(MPI_Comm comm, MPI_Info hints, const char *fileName, int mode)
 {
@@ -20,13 +35,7 @@ MPI_File Open(MPI_Comm comm, MPI_Info hints, const char *fileName, int mode)
   (void)mode;
   return 0;
   #else
-  // added this to deal with vpic data arrays which use spaces.
-  std::string cleanFileName=fileName;
-  size_t fileNameLen=cleanFileName.size();
-  for (size_t i=0; i<fileNameLen; ++i)
-    {
-    if (cleanFileName[i]==' ') cleanFileName[i]='-';
-    }
+  std::string cleanFileName=CleanFileName(fileName);
 
   MPI_File file=0;
   int iErr;
@@ -57,6 +66,8 @@ BOVScalarImage::BOVScalarImage(
     MPI_Info hints,
     const char *fileName,
     int mode)
+      :
+  Map(0)
 {
   this->File=Open(comm,hints,fileName,mode);
   this->FileName=fileName;
@@ -69,6 +80,8 @@ BOVScalarImage::BOVScalarImage(
       const char *fileName,
       const char *name,
       int mode)
+      :
+  Map(0)
 {
   this->File=Open(comm,hints,fileName,mode);
   this->FileName=fileName;
@@ -78,6 +91,7 @@ BOVScalarImage::BOVScalarImage(
 //-----------------------------------------------------------------------------
 BOVScalarImage::~BOVScalarImage()
 {
+  this->UnmapFile();
   #ifndef SQTK_WITHOUT_MPI
   if (this->File)
     {
@@ -86,6 +100,32 @@ BOVScalarImage::~BOVScalarImage()
   #endif
 }
 
+//-----------------------------------------------------------------------------
+int BOVScalarImage::MapFile()
+{
+  if (this->Map)
+    {
+    return 1;
+    }
+
+  MemoryMappedFile *map=new MemoryMappedFile;
+  if (!map->Open(CleanFileName(this->FileName.c_str()).c_str()))
+    {
+    delete map;
+    return 0;
+    }
+  this->Map=map;
+
+  return 1;
+}
+
+//-----------------------------------------------------------------------------
+void BOVScalarImage::UnmapFile()
+{
+  delete this->Map;
+  this->Map=0;
+}
+
 //-----------------------------------------------------------------------------
 std::ostream &operator<<(std::ostream &os, const BOVScalarImage &si)
 {
@@ -21,6 +21,8 @@ typedef void * MPI_File;
 #include <string> // for string
 #include <iostream> // for ostream
 
+class MemoryMappedFile;
+
 /// Handle to file containing a scalar array.
 class BOVScalarImage
 {
@@ -44,8 +46,22 @@ public:
   const char *GetName() const { return this->Name.c_str(); }
   const char *GetFileName() const { return this->FileName.c_str(); }
 
+  /**
+  Map the file into memory, in addition to the MPI handle. Returns 0
+  if the file could not be mapped, in which case reads should go
+  through the MPI handle.
+  */
+  int MapFile();
+  void UnmapFile();
+
+  /**
+  Get the memory map, or 0 if the file isn't mapped.
+  */
+  const MemoryMappedFile *GetMappedFile() const { return this->Map; }
+
 private:
   MPI_File File;
+  MemoryMappedFile *Map;
   std::string FileName;
   std::string Name;
 
@@ -49,6 +49,14 @@ public:
     return this->Step->Scalars[this->Idx]->GetFile();
     }
 
+  /**
+  Access the memory map, 0 if the file isn't mapped.
+  */
+  virtual const MemoryMappedFile *GetMappedFile() const
+    {
+    return this->Step->Scalars[this->Idx]->GetMappedFile();
+    }
+
   /**
   Get array name.
   */
@@ -205,6 +205,38 @@ BOVTimeStepImage::~BOVTimeStepImage()
     }
 }
 
+//-----------------------------------------------------------------------------
+int BOVTimeStepImage::MapFiles()
+{
+  int ok=1;
+
+  size_t nScalars=this->Scalars.size();
+  for (size_t i=0; i<nScalars; ++i)
+    {
+    ok&=this->Scalars[i]->MapFile();
+    }
+
+  size_t nVectors=this->Vectors.size();
+  for (size_t i=0; i<nVectors; ++i)
+    {
+    ok&=this->Vectors[i]->MapFiles();
+    }
+
+  size_t nTensors=this->Tensors.size();
+  for (size_t i=0; i<nTensors; ++i)
+    {
+    ok&=this->Tensors[i]->MapFiles();
+    }
+
+  size_t nSymetricTensors=this->SymetricTensors.size();
+  for (size_t i=0; i<nSymetricTensors; ++i)
+    {
+    ok&=this->SymetricTensors[i]->MapFiles();
+    }
+
+  return ok;
+}
+
 //-----------------------------------------------------------------------------
 std::ostream &operator<<(std::ostream &os, const BOVTimeStepImage &si)
 {
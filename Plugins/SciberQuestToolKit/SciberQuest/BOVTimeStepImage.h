@@ -56,6 +56,14 @@ public:
       this->SymetricTensors.size();
     }
 
+  /**
+  Map all of the files into memory so that they may be read
+  without going through MPI-IO. Returns 0 if any of the files
+  could not be mapped, files that could not be mapped are read
+  through their MPI handle.
+  */
+  int MapFiles();
+
 private:
   std::vector<BOVScalarImage*> Scalars;
   std::vector<BOVVectorImage*> Vectors;
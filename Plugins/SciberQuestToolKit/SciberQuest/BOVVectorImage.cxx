@@ -47,6 +47,21 @@ void BOVVectorImage::SetComponentFile(
   this->ComponentFiles[i] = new BOVScalarImage(comm,hints,fileName,mode);
 }
 
+//-----------------------------------------------------------------------------
+int BOVVectorImage::MapFiles()
+{
+  int ok=1;
+  int nComps=(int)this->ComponentFiles.size();
+  for (int i=0; i<nComps; ++i)
+    {
+    if (!this->ComponentFiles[i]->MapFile())
+      {
+      ok=0;
+      }
+    }
+  return ok;
+}
+
 //-----------------------------------------------------------------------------
 void BOVVectorImage::SetNumberOfComponents(int nComps)
 {
@@ -45,6 +45,17 @@ public:
     return this->ComponentFiles[i]->GetFile();
     }
 
+  const MemoryMappedFile *GetComponentMappedFile(int i) const
+    {
+    return this->ComponentFiles[i]->GetMappedFile();
+    }
+
+  /**
+  Map each of the component files into memory. Returns 0 if
+  any of the files could not be mapped.
+  */
+  int MapFiles();
+
   void SetNumberOfComponents(int nComps);
   int GetNumberOfComponents() const { return (int)this->ComponentFiles.size(); }
 
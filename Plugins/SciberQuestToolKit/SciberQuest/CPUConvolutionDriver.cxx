@@ -16,9 +16,11 @@ Copyright 2012 SciberQuest Inc.
 #include "MemOrder.hxx"
 #include "Numerics.hxx"
 #include "SQMacros.h"
+#include "ThreadedExecute.h"
 #include "postream.h"
 
 #include "vtkDataArray.h"
+#include "vtkMultiThreader.h"
 
 #include <iostream>
 #include <vector>
@@ -26,10 +28,201 @@ Copyright 2012 SciberQuest Inc.
 
 //#define CPUConvolutionDriverDEBUG
 
+namespace
+{
+/// ConvolutionWork - the arguments of a convolution shared by the threads
+template<typename T>
+struct ConvolutionWork
+{
+  int *Input;
+  int *Output;
+  int *Kernel;
+  int Direction;  // direction of a separable pass, or -1 for the full kernel
+  int NumberOfComponents;
+  int Mode;
+  T *V;
+  T *W;
+  float *K;
+};
+
+//-----------------------------------------------------------------------------
+template<typename T>
+VTK_THREAD_RETURN_TYPE ConvolutionThread(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info
+    = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+
+  ConvolutionWork<T> *work=static_cast<ConvolutionWork<T>*>(info->UserData);
+  int *output=work->Output;
+  int nComp=work->NumberOfComponents;
+
+  size_t rowBeg;
+  size_t rowEnd;
+
+  if (work->Direction>=0)
+    {
+    // separable pass, threads get a contiguous range of output rows.
+    size_t nRows=(output[3]-output[2]+1)*(output[5]-output[4]+1);
+    rowBeg=(nRows*info->ThreadID)/info->NumberOfThreads;
+    rowEnd=(nRows*(info->ThreadID+1))/info->NumberOfThreads;
+    ::SeparableConvolution<T>(
+        work->Input,
+        output,
+        work->Kernel,
+        work->Direction,
+        nComp,
+        rowBeg,
+        rowEnd,
+        work->V,
+        work->W,
+        work->K);
+    }
+  else
+    {
+    // full kernel, threads get a slab of the output along the slowest
+    // varying direction. slabs are contiguous in the output array.
+    int slowDim=2;
+    while ((slowDim>0) && (output[2*slowDim]==output[2*slowDim+1]))
+      {
+      --slowDim;
+      }
+    size_t slabSize=nComp;
+    for (int q=0; q<slowDim; ++q)
+      {
+      slabSize*=output[2*q+1]-output[2*q]+1;
+      }
+    size_t nSlabs=output[2*slowDim+1]-output[2*slowDim]+1;
+    rowBeg=(nSlabs*info->ThreadID)/info->NumberOfThreads;
+    rowEnd=(nSlabs*(info->ThreadID+1))/info->NumberOfThreads;
+    if (rowBeg<rowEnd)
+      {
+      CartesianExtent slab(output);
+      slab[2*slowDim]=output[2*slowDim]+(int)rowBeg;
+      slab[2*slowDim+1]=output[2*slowDim]+(int)rowEnd-1;
+      ::Convolution<T>(
+          work->Input,
+          slab.GetData(),
+          work->Kernel,
+          nComp,
+          work->Mode,
+          work->V,
+          work->W+slabSize*rowBeg,
+          work->K);
+      }
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//-----------------------------------------------------------------------------
+template<typename T>
+void ThreadedConvolution(
+      int nThreads,
+      int *input,
+      int *output,
+      int *kernel,
+      int nComp,
+      int mode,
+      T *V,
+      T *W,
+      float *K)
+{
+  ConvolutionWork<T> work;
+  work.Input=input;
+  work.Output=output;
+  work.Kernel=kernel;
+  work.Direction=-1;
+  work.NumberOfComponents=nComp;
+  work.Mode=mode;
+  work.V=V;
+  work.W=W;
+  work.K=K;
+
+  ThreadedExecute(ConvolutionThread<T>,&work,nThreads);
+}
+
+//-----------------------------------------------------------------------------
+template<typename T>
+int ThreadedSeparableConvolution(
+      int nThreads,
+      int *input,
+      int *output,
+      int *kernel,
+      int nComp,
+      int mode,
+      T *V,
+      T *W,
+      float *K1)
+{
+  // a pass is made in each direction the kernel spans. in the others
+  // the input and output have to coincide.
+  int nPasses=0;
+  int passDir[3];
+  for (int q=0; q<3; ++q)
+    {
+    if (kernel[2*q]<kernel[2*q+1])
+      {
+      passDir[nPasses]=q;
+      ++nPasses;
+      }
+    else
+    if ((input[2*q]!=output[2*q]) || (input[2*q+1]!=output[2*q+1]))
+      {
+      return -1;
+      }
+    }
+  if (nPasses==0)
+    {
+    return -1;
+    }
+
+  // intermediate results, the last pass writes into W.
+  std::vector<T> buffer[2];
+
+  CartesianExtent passInput(input);
+  T *passV=V;
+
+  for (int p=0; p<nPasses; ++p)
+    {
+    int dir=passDir[p];
+
+    CartesianExtent passOutput(passInput);
+    passOutput[2*dir]=output[2*dir];
+    passOutput[2*dir+1]=output[2*dir+1];
+
+    T *passW=W;
+    if (p<(nPasses-1))
+      {
+      buffer[p%2].resize(nComp*passOutput.Size());
+      passW=&buffer[p%2][0];
+      }
+
+    ConvolutionWork<T> work;
+    work.Input=passInput.GetData();
+    work.Output=passOutput.GetData();
+    work.Kernel=kernel;
+    work.Direction=dir;
+    work.NumberOfComponents=nComp;
+    work.Mode=mode;
+    work.V=passV;
+    work.W=passW;
+    work.K=K1;
+
+    ThreadedExecute(ConvolutionThread<T>,&work,nThreads);
+
+    passInput=passOutput;
+    passV=passW;
+    }
+
+  return 0;
+}
+}
+
 //-----------------------------------------------------------------------------
 CPUConvolutionDriver::CPUConvolutionDriver()
         :
-    Optimization(OPT_NONE)
+    Optimization(OPT_NONE),
+    NumberOfThreads(1)
 {}
 
 //-----------------------------------------------------------------------------
@@ -41,7 +234,8 @@ int CPUConvolutionDriver::Convolution(
     int mode,
     vtkDataArray *V,
     vtkDataArray *W,
-    float *K)
+    float *K,
+    float *K1)
 {
   // TODO - make sure nothing is leaked if an error occurs!
 
@@ -98,14 +292,45 @@ int CPUConvolutionDriver::Convolution(
   pCerr() << "nW=(" << nW[fastDim] <<  ", " << nW[slowDim] << ")" << std::endl;
   #endif
 
-  switch (this->Optimization)
+  int optimization=this->Optimization;
+
+  if (optimization==OPT_SEPARABLE)
+    {
+    int ierr=-1;
+    if (K1)
+      {
+      switch (V->GetDataType())
+        {
+        vtkFloatTemplateMacro(
+          ierr=ThreadedSeparableConvolution<VTK_TT>(
+              this->NumberOfThreads,
+              extV.GetData(),
+              extW.GetData(),
+              extK.GetData(),
+              nComp,
+              mode,
+              (VTK_TT*)V->GetVoidPointer(0),
+              (VTK_TT*)W->GetVoidPointer(0),
+              K1));
+        }
+      }
+    if (!ierr)
+      {
+      return 0;
+      }
+    // the kernel isn't separable, use the full kernel.
+    optimization=OPT_NONE;
+    }
+
+  switch (optimization)
     {
     ///
     case OPT_NONE:
       switch (V->GetDataType())
         {
         vtkFloatTemplateMacro(
-          ::Convolution<VTK_TT>(
+          ThreadedConvolution<VTK_TT>(
+              this->NumberOfThreads,
               extV.GetData(),
               extW.GetData(),
               extK.GetData(),
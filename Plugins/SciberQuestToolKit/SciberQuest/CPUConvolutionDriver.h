@@ -26,12 +26,24 @@ public:
   enum{
     OPT_NONE=0,
     OPT_FLATTEN_VTK=1,
-    OPT_Z_ORDER=2
+    OPT_Z_ORDER=2,
+    OPT_SEPARABLE=3
   };
   void SetOptimization(int opt){ this->Optimization=opt; }
   int GetOptimization(){ return this->Optimization; }
 
-  /// Invoke the kernel
+  /**
+  Set the number of threads used by OPT_NONE and OPT_SEPARABLE.
+  The output is split in slabs along its slowest varying direction.
+  */
+  void SetNumberOfThreads(int n){ this->NumberOfThreads=(n<1?1:n); }
+  int GetNumberOfThreads(){ return this->NumberOfThreads; }
+
+  /**
+  Invoke the kernel. K1 is optional, when given K must be the outer
+  product of K1 with itself, and OPT_SEPARABLE convolves with K1 once
+  in each direction. Otherwise OPT_SEPARABLE falls back to OPT_NONE.
+  */
   int Convolution(
       CartesianExtent &extV,
       CartesianExtent &extW,
@@ -40,10 +52,12 @@ public:
       int mode,
       vtkDataArray *V,
       vtkDataArray *W,
-      float *K);
+      float *K,
+      float *K1=0);
 
 private:
   int Optimization;
+  int NumberOfThreads;
 };
 
 #endif
@@ -33,6 +33,8 @@ CartesianDataBlockIODescriptor::CartesianDataBlockIODescriptor(
   this->Mode
     = CartesianExtent::GetDimensionMode(fileExt,nGhosts);
 
+  this->FileExtent=fileExt;
+
   // Determine the true memory extents. Start by assuming that the
   // block is on the interior of the domain decomposition. Strip edge
   // and face ghost cells, if the block lies on the exterior of the
@@ -86,12 +88,14 @@ CartesianDataBlockIODescriptor::CartesianDataBlockIODescriptor(
           {
           CreateCartesianView<float>(fileExt,fileRegion,view);
           this->FileViews.push_back(view);
+          this->FileRegions.push_back(fileRegion);
 
           CartesianExtent memRegion(fileRegion);
           memRegion.Shift(-i*nFileExt[0],-j*nFileExt[1],-k*nFileExt[2]);
 
           CreateCartesianView<float>(memExt,memRegion,view);
           this->MemViews.push_back(view);
+          this->MemRegions.push_back(memRegion);
 
           #ifdef CartesianDataBlockIODescriptorDEBUG
           int regSize[3];
@@ -133,6 +137,8 @@ void CartesianDataBlockIODescriptor::Clear()
     }
   this->FileViews.clear();
   #endif
+  this->FileRegions.clear();
+  this->MemRegions.clear();
 }
 
 //-----------------------------------------------------------------------------
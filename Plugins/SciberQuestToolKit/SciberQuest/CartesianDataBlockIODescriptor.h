@@ -27,6 +27,8 @@ read in a cartesian block of data with ghost cells. Here
 the ghost cells are filled directly from disk as
 no other blocks are assumed to be in memory. The views
 are accessed via CartesianDataBlockIODescriptorIterator.
+The extents the views were built from are kept as well
+for readers that copy from a memory mapped file.
 */
 class CartesianDataBlockIODescriptor
 {
@@ -59,6 +61,17 @@ public:
   */
   const CartesianExtent &GetMemExtent() const { return this->MemExtent; }
 
+  /**
+  Get the extent of the file the views index into.
+  */
+  const CartesianExtent &GetFileExtent() const { return this->FileExtent; }
+
+  /**
+  Access to the regions the views describe.
+  */
+  const CartesianExtent &GetMemRegion(int i) const { return this->MemRegions[i]; }
+  const CartesianExtent &GetFileRegion(int i) const { return this->FileRegions[i]; }
+
 private:
   /// \Section NotImplemented \@{
   CartesianDataBlockIODescriptor();
@@ -72,8 +85,11 @@ private:
 private:
   int Mode;
   CartesianExtent MemExtent;
+  CartesianExtent FileExtent;
   std::vector<MPI_Datatype> FileViews;
   std::vector<MPI_Datatype> MemViews;
+  std::vector<CartesianExtent> FileRegions;
+  std::vector<CartesianExtent> MemRegions;
 };
 
 std::ostream &operator<<(std::ostream &os,const CartesianDataBlockIODescriptor &descr);
@@ -43,6 +43,12 @@ public:
   MPI_Datatype GetMemView() const { return this->Descriptor->MemViews[this->At]; }
   MPI_Datatype GetFileView() const { return this->Descriptor->FileViews[this->At]; }
 
+  /**
+  Access to the regions described by the views.
+  */
+  const CartesianExtent &GetMemRegion() const { return this->Descriptor->MemRegions[this->At]; }
+  const CartesianExtent &GetFileRegion() const { return this->Descriptor->FileRegions[this->At]; }
+
 private:
   /// \Section NotImplemented \@{
   CartesianDataBlockIODescriptorIterator();
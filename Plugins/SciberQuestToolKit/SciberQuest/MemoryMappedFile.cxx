@@ -0,0 +1,184 @@
+/*
+   ____    _ __           ____               __    ____
+  / __/___(_) /  ___ ____/ __ \__ _____ ___ / /_  /  _/__  ____
+ _\ \/ __/ / _ \/ -_) __/ /_/ / // / -_|_-</ __/ _/ // _ \/ __/
+/___/\__/_/_.__/\__/_/  \___\_\_,_/\__/___/\__/ /___/_//_/\__(_)
+
+Copyright 2012 SciberQuest Inc.
+*/
+#include "MemoryMappedFile.h"
+
+#include "SQMacros.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+//-----------------------------------------------------------------------------
+MemoryMappedFile::MemoryMappedFile()
+      :
+  Data(0),
+  Size(0)
+{
+  #ifdef WIN32
+  this->FileHandle=INVALID_HANDLE_VALUE;
+  this->MapHandle=0;
+  #endif
+}
+
+//-----------------------------------------------------------------------------
+MemoryMappedFile::~MemoryMappedFile()
+{
+  this->Close();
+}
+
+//-----------------------------------------------------------------------------
+int MemoryMappedFile::Open(const char *fileName)
+{
+  this->Close();
+
+  #ifdef WIN32
+  HANDLE file=CreateFile(
+        fileName,
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        NULL,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL|FILE_FLAG_RANDOM_ACCESS,
+        NULL);
+  if (file==INVALID_HANDLE_VALUE)
+    {
+    sqErrorMacro(std::cerr,
+      << "Failed to open " << fileName << " for mapping.");
+    return 0;
+    }
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file,&size) || (size.QuadPart==0))
+    {
+    CloseHandle(file);
+    return 0;
+    }
+
+  HANDLE map=CreateFileMapping(file,NULL,PAGE_READONLY,0,0,NULL);
+  if (map==NULL)
+    {
+    sqErrorMacro(std::cerr,
+      << "Failed to create a mapping of " << fileName << ".");
+    CloseHandle(file);
+    return 0;
+    }
+
+  void *data=MapViewOfFile(map,FILE_MAP_READ,0,0,0);
+  if (data==NULL)
+    {
+    sqErrorMacro(std::cerr,
+      << "Failed to map " << fileName << ".");
+    CloseHandle(map);
+    CloseHandle(file);
+    return 0;
+    }
+
+  this->FileHandle=file;
+  this->MapHandle=map;
+  this->Data=static_cast<char*>(data);
+  this->Size=static_cast<size_t>(size.QuadPart);
+  #else
+  int fd=open(fileName,O_RDONLY);
+  if (fd<0)
+    {
+    sqErrorMacro(std::cerr,
+      << "Failed to open " << fileName << " for mapping. "
+      << strerror(errno));
+    return 0;
+    }
+
+  struct stat s;
+  if ((fstat(fd,&s)!=0) || (s.st_size==0))
+    {
+    close(fd);
+    return 0;
+    }
+
+  void *data=mmap(0,s.st_size,PROT_READ,MAP_SHARED,fd,0);
+  // the map holds its own reference to the file.
+  close(fd);
+  if (data==MAP_FAILED)
+    {
+    sqErrorMacro(std::cerr,
+      << "Failed to map " << fileName << ". "
+      << strerror(errno));
+    return 0;
+    }
+
+  // blocks are read in small i-runs scattered through the file,
+  // read-ahead would mostly bring in data that isn't used.
+  madvise(data,s.st_size,MADV_RANDOM);
+
+  this->Data=static_cast<char*>(data);
+  this->Size=static_cast<size_t>(s.st_size);
+  #endif
+
+  return 1;
+}
+
+//-----------------------------------------------------------------------------
+void MemoryMappedFile::Close()
+{
+  #ifdef WIN32
+  if (this->Data)
+    {
+    UnmapViewOfFile(this->Data);
+    }
+  if (this->MapHandle)
+    {
+    CloseHandle(this->MapHandle);
+    this->MapHandle=0;
+    }
+  if (this->FileHandle!=INVALID_HANDLE_VALUE)
+    {
+    CloseHandle(this->FileHandle);
+    this->FileHandle=INVALID_HANDLE_VALUE;
+    }
+  #else
+  if (this->Data)
+    {
+    munmap(this->Data,this->Size);
+    }
+  #endif
+  this->Data=0;
+  this->Size=0;
+}
+
+//-----------------------------------------------------------------------------
+void MemoryMappedFile::Prefetch(size_t offset, size_t length) const
+{
+  if (!this->Data || (offset>=this->Size))
+    {
+    return;
+    }
+
+  if (offset+length>this->Size)
+    {
+    length=this->Size-offset;
+    }
+
+  #ifdef WIN32
+  // PrefetchVirtualMemory is not available on all supported
+  // versions of windows. Pages are brought in on first access.
+  (void)length;
+  #else
+  // madvise requires a page aligned address.
+  size_t pageSize=static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  size_t start=offset-offset%pageSize;
+  madvise(this->Data+start,length+(offset-start),MADV_WILLNEED);
+  #endif
+}
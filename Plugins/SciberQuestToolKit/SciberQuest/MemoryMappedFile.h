@@ -0,0 +1,74 @@
+/*
+   ____    _ __           ____               __    ____
+  / __/___(_) /  ___ ____/ __ \__ _____ ___ / /_  /  _/__  ____
+ _\ \/ __/ / _ \/ -_) __/ /_/ / // / -_|_-</ __/ _/ // _ \/ __/
+/___/\__/_/_.__/\__/_/  \___\_\_,_/\__/___/\__/ /___/_//_/\__(_)
+
+Copyright 2012 SciberQuest Inc.
+*/
+#ifndef __MemoryMappedFile_h
+#define __MemoryMappedFile_h
+
+#include <cstddef> // for size_t
+
+/// Read-only memory map of a file.
+/**
+Maps an entire file read-only into the address space of the
+process. Pages are brought in by the OS on first access, so
+that only the parts of the file that are touched are read.
+Every Open creates its own mapping, mappings are not shared
+between objects. Only the OS page cache is shared, so pages
+read through one mapping or process on a node are not read
+from disk again by the others.
+*/
+class MemoryMappedFile
+{
+public:
+  MemoryMappedFile();
+  ~MemoryMappedFile();
+
+  /**
+  Map the named file. Returns 0 if the file could not be
+  mapped, in which case the caller should fall back to
+  regular I/O.
+  */
+  int Open(const char *fileName);
+
+  /**
+  Unmap the file.
+  */
+  void Close();
+
+  /**
+  Returns true if a file is mapped.
+  */
+  bool IsOpen() const { return this->Data!=0; }
+
+  /**
+  Access to the mapped bytes.
+  */
+  const char *GetData() const { return this->Data; }
+  size_t GetSize() const { return this->Size; }
+
+  /**
+  Advise the OS that the given range will be accessed soon
+  so that it can be paged in asynchronously.
+  */
+  void Prefetch(size_t offset, size_t length) const;
+
+private:
+  MemoryMappedFile(const MemoryMappedFile &);
+  void operator=(const MemoryMappedFile &);
+
+private:
+  char *Data;
+  size_t Size;
+  #ifdef WIN32
+  void *FileHandle;
+  void *MapHandle;
+  #endif
+};
+
+#endif
+
+// VTK-HeaderTest-Exclude: MemoryMappedFile.h
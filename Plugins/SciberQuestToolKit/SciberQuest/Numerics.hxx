@@ -14,6 +14,8 @@ Copyright 2012 SciberQuest Inc.
 #include <cstdlib>
 #include <cmath>
 #include <complex>
+#include <vector>
+#include <algorithm>
 
 #include "SQPOSIXOnWindowsWarningSupression.h"
 #include "SQPosixOnWindows.h"
@@ -837,6 +839,83 @@ void Convolution(
     }
 }
 
+// One pass of a separable convolution, applies the 1D kernel K1 along
+// direction dir. The output patch is the input patch narrowed to the
+// output in direction dir, in the other directions they match. Rows
+// (i.e. the x-lines of the output indexed by j+nj*k) rowBeg to rowEnd-1
+// are computed, so that the work can be split among threads. Both the
+// output and the shifted input rows are contiguous in vtk's interleaved
+// order so the inner loop is a unit stride multiply-add that compilers
+// vectorize.
+//
+// input  -> patch input array is defined on
+// output -> patch output array is defined on
+// kernel -> kernel extent, only direction dir is used
+// dir    -> 0, 1 or 2 for x, y, or z
+// V      -> scalar or vector field
+// nComp  -> number of components in V
+// W      -> convolution of V and K1 along dir
+// K1     -> 1D kernel (vector whose sum is 1)
+//*****************************************************************************
+template <typename T>
+void SeparableConvolution(
+      int *input,
+      int *output,
+      int *kernel,
+      int dir,
+      int nComp,
+      size_t rowBeg,
+      size_t rowEnd,
+      T* __restrict__  V,
+      T* __restrict__  W,
+      float * __restrict__ K1)
+{
+  // input array bounds.
+  const size_t ni=input[1]-input[0]+1;
+  const size_t nj=input[3]-input[2]+1;
+
+  // output array bounds
+  const size_t _ni=output[1]-output[0]+1;
+  const size_t _nj=output[3]-output[2]+1;
+  const size_t rowLen=nComp*_ni;
+
+  // offset of the output patch in the input patch, shifted to the
+  // first kernel entry in the direction of the pass.
+  int shift[3]={output[0]-input[0], output[2]-input[2], output[4]-input[4]};
+  shift[dir]+=kernel[2*dir];
+  const size_t off[3]={(size_t)shift[0], (size_t)shift[1], (size_t)shift[2]};
+
+  // distance between neighbors in the direction of the pass
+  const size_t stride[3]={(size_t)nComp, nComp*ni, nComp*ni*nj};
+
+  const int kn=kernel[2*dir+1]-kernel[2*dir]+1;
+
+  for (size_t r=rowBeg; r<rowEnd; ++r)
+    {
+    const size_t _k=r/_nj;
+    const size_t _j=r-_k*_nj;
+
+    T * __restrict__ w=W+rowLen*r;
+    T * __restrict__ v
+      = V+nComp*(off[0]+ni*(_j+off[1])+ni*nj*(_k+off[2]));
+
+    for (size_t q=0; q<rowLen; ++q)
+      {
+      w[q]=((T)0);
+      }
+
+    for (int f=0; f<kn; ++f)
+      {
+      const T kf=((T)K1[f]);
+      const T * __restrict__ vf=v+f*stride[dir];
+      for (size_t q=0; q<rowLen; ++q)
+        {
+        w[q]+=kf*vf[q];
+        }
+      }
+    }
+}
+
 /**
 This implementation is written so that adjacent threads access adjacent
 memory locations. This requires that vtk vectors/tensors etc be split.
@@ -1094,122 +1173,322 @@ private:
 };
 
 /**
-This implementation is written so that adjacent threads access adjacent
-memory locations. This requires that vtk vectors/tensors etc be split.
+Functor for comparing one component of an interleaved array by tuple
+index.
 */
-//*****************************************************************************
 template<typename T>
-void ScalarMedianFilter2D(
-      //int worldRank,
-      size_t vni,
-      size_t wni,
-      size_t wnij,
-      size_t kni,
-      size_t knij,
-      size_t nGhost,
-      T * __restrict__ V,
-      T * __restrict__ W)
+class StridedCompare
 {
-  (void)nGhost;
+public:
+  //
+  StridedCompare() : Data(0), Stride(1) {}
+  StridedCompare(T *data, int stride) : Data(data), Stride(stride) {}
 
-  size_t *ids=0;
-  posix_memalign((void**)&ids,16,knij*sizeof(size_t));
+  // compare data at the given tuple indices
+  bool operator()(size_t l, size_t r)
+  { return this->Data[this->Stride*l]<this->Data[this->Stride*r]; }
 
-  IndirectCompare<T> comp(V);
+private:
+  T *Data;
+  size_t Stride;
+};
 
-  // get a tuple from the current flat index in the output
-  // index space
-  for (size_t wi=0; wi<wnij; ++wi)
+/**
+Sort one component of an interleaved array. On return order[r] is
+the index of the tuple with rank r and rank[i] is the rank of tuple
+i. Ranks are unique, ties are broken arbitrarily.
+*/
+//*****************************************************************************
+template<typename T>
+void RankOrder(
+      size_t n,
+      int nComp,
+      int comp,
+      T *V,
+      size_t *order,
+      size_t *rank)
+{
+  for (size_t i=0; i<n; ++i)
     {
-    size_t i,j;
-    j=wi/wni;
-    i=wi-j*wni;
+    order[i]=i;
+    }
 
-    // setup search space
-    size_t ki=0;
-    for (size_t g=0; g<kni; ++g)
+  std::sort(order,order+n,StridedCompare<T>(V+comp,nComp));
+
+  for (size_t r=0; r<n; ++r)
+    {
+    rank[order[r]]=r;
+    }
+}
+
+/**
+A set of ranks (see RankOrder) with counts kept for blocks of 64
+and 4096 ranks, so that the neighbors of a rank in the set are found
+by skipping over empty blocks.
+*/
+class RankHistogram
+{
+public:
+  RankHistogram(size_t n)
+        :
+    Fine(((n>>6)+1)<<6,0),
+    Coarse(((((n>>6)+1)>>6)+1)<<6,0),
+    Super((((n>>6)+1)>>6)+1,0)
+  {}
+
+  // add/remove a rank
+  void Insert(size_t r)
+  {
+    this->Fine[r]=1;
+    ++this->Coarse[r>>6];
+    ++this->Super[r>>12];
+  }
+
+  void Remove(size_t r)
+  {
+    this->Fine[r]=0;
+    --this->Coarse[r>>6];
+    --this->Super[r>>12];
+  }
+
+  // smallest rank in the set larger or equal to r, there must be one.
+  size_t Next(size_t r) const
+  {
+    // rest of the block
+    size_t b=r>>6;
+    for (size_t e=(b+1)<<6; r<e; ++r)
       {
-      size_t q=vni*(j+g)+i;
-      for (size_t f=0; f<kni; ++f)
+      if (this->Fine[r])
         {
-        size_t vi=q+f;
-        ids[ki]=vi;
-        ++ki;
+        return r;
         }
       }
+    // rest of the super block
+    ++b;
+    while ((b&63) && !this->Coarse[b])
+      {
+      ++b;
+      }
+    // following super blocks
+    if (!(b&63))
+      {
+      size_t s=b>>6;
+      while (!this->Super[s])
+        {
+        ++s;
+        }
+      b=s<<6;
+      while (!this->Coarse[b])
+        {
+        ++b;
+        }
+      }
+    r=b<<6;
+    while (!this->Fine[r])
+      {
+      ++r;
+      }
+    return r;
+  }
+
+  // largest rank in the set smaller than r, there must be one.
+  size_t Prev(size_t r) const
+  {
+    // rest of the block
+    size_t b=r>>6;
+    for (size_t e=b<<6; r>e;)
+      {
+      --r;
+      if (this->Fine[r])
+        {
+        return r;
+        }
+      }
+    // rest of the super block
+    size_t e=(b>>6)<<6;
+    while ((b>e) && !this->Coarse[b-1])
+      {
+      --b;
+      }
+    // preceding super blocks
+    if (b==e)
+      {
+      size_t s=e>>6;
+      do
+        {
+        --s;
+        }
+      while (!this->Super[s]);
+      b=(s+1)<<6;
+      while (!this->Coarse[b-1])
+        {
+        --b;
+        }
+      }
+    r=b<<6;
+    do
+      {
+      --r;
+      }
+    while (!this->Fine[r]);
+    return r;
+  }
 
-    // sort
-    //std::sort(ids,ids+knij,comp);
-    std::partial_sort(ids,ids+knij/2+1,ids+knij,comp);
-
-    // std::cerr << wi << " " << V[ids[0]] << " " << V[ids[knij/2]] << " " << V[ids[knij-1]] << std::endl;
-
-    // median
-    W[wi]=V[ids[knij/2]];
-    }
-
-  free(ids);
-}
+private:
+  std::vector<unsigned char> Fine;
+  std::vector<unsigned int> Coarse;
+  std::vector<unsigned int> Super;
+};
 
+/**
+Median filter of one component of an interleaved array. The stencil
+slides along the rows of the output (x-lines indexed by j+nj*k), at
+each step the column of the stencil left behind is removed from the
+histogram and the one entered is added. The median is tracked
+incrementally in rank space so the cost per point is proportional to
+the size of a column of the stencil rather than to the full stencil.
+Rows rowBeg to rowEnd-1 are computed, so that the work can be split
+among threads.
+
+input  -> patch input array is defined on
+output -> patch output array is defined on
+kernel -> stencil extent
+V      -> scalar or vector field
+nComp  -> number of components in V
+comp   -> component to filter
+order  -> tuple indices sorted by value (see RankOrder)
+rank   -> rank of each tuple (see RankOrder)
+hist   -> empty histogram sized for the input, it's empty on return
+W      -> median of V
+*/
 //*****************************************************************************
 template<typename T>
-void ScalarMedianFilter3D(
-      size_t vni,
-      size_t vnij,
-      size_t wni,
-      size_t wnij,
-      size_t wnijk,
-      size_t kni,
-      size_t knij,
-      size_t knijk,
-      size_t nGhost,
+void SlidingMedianFilter(
+      int *input,
+      int *output,
+      int *kernel,
+      int nComp,
+      int comp,
+      size_t rowBeg,
+      size_t rowEnd,
       T * __restrict__ V,
+      size_t *order,
+      size_t *rank,
+      RankHistogram &hist,
       T * __restrict__ W)
 {
-  (void)knij;
-  (void)nGhost;
+  // input array bounds.
+  const size_t ni=input[1]-input[0]+1;
+  const size_t nj=input[3]-input[2]+1;
+  const size_t nij=ni*nj;
+
+  // output array bounds
+  const size_t _ni=output[1]-output[0]+1;
+  const size_t _nj=output[3]-output[2]+1;
 
-  size_t *ids=0;
-  posix_memalign((void**)&ids,16,knijk*sizeof(size_t));
+  // stencil
+  const size_t kni=kernel[1]-kernel[0]+1;
+  const size_t knj=kernel[3]-kernel[2]+1;
+  const size_t knk=kernel[5]-kernel[4]+1;
+  const size_t kn=kni*knj*knk;
+  const size_t h=kn/2;
 
-  IndirectCompare<T> comp(V);
+  // offset of the first stencil point of the output in the input
+  const size_t off[3]={
+    (size_t)(output[0]-input[0]+kernel[0]),
+    (size_t)(output[2]-input[2]+kernel[2]),
+    (size_t)(output[4]-input[4]+kernel[4])};
 
-  // visit each output element
-  for (size_t wi=0; wi<wnijk; ++wi)
+  std::vector<size_t> win(kn);
+
+  for (size_t r=rowBeg; r<rowEnd; ++r)
     {
-    size_t i,j,k;
-    k=wi/wnij;
-    j=(wi-k*wnij)/wni;
-    i=wi-k*wnij-j*wni;
+    const size_t _k=r/_nj;
+    const size_t _j=r-_k*_nj;
 
-    // set up search space
-    size_t ki=0;
-    for (size_t h=0; h<kni; ++h)
+    T *w=W+nComp*_ni*r+comp;
+
+    const size_t v0=off[0]+ni*(_j+off[1])+nij*(_k+off[2]);
+
+    // fill the stencil for the first point of the row
+    size_t q=0;
+    for (size_t c=0; c<knk; ++c)
       {
-      size_t r=vnij*(k+h);
-      for (size_t g=0; g<kni; ++g)
+      for (size_t b=0; b<knj; ++b)
         {
-        size_t q=r+vni*(j+g)+i;
-        for (size_t f=0; f<kni; ++f)
+        const size_t vi=v0+ni*b+nij*c;
+        for (size_t a=0; a<kni; ++a)
           {
-          size_t vi=q+f;
-          ids[ki]=vi;
-          ++ki;
+          const size_t rk=rank[vi+a];
+          hist.Insert(rk);
+          win[q]=rk;
+          ++q;
           }
         }
       }
+    std::nth_element(win.begin(),win.begin()+h,win.end());
 
-    // sort
-    //std::sort(ids,ids+knijk,comp);
-    std::partial_sort(ids,ids+knijk/2+1,ids+knijk,comp);
+    // m is the median rank and below is the number of ranks
+    // in the stencil smaller than m.
+    size_t m=win[h];
+    size_t below=h;
+    w[0]=V[nComp*order[m]+comp];
 
-    // median
-    W[wi]=V[ids[knijk/2]];
-    }
+    for (size_t i=1; i<_ni; ++i)
+      {
+      // slide the stencil
+      for (size_t c=0; c<knk; ++c)
+        {
+        for (size_t b=0; b<knj; ++b)
+          {
+          const size_t vi=v0+ni*b+nij*c+i-1;
 
-  free(ids);
-}
+          const size_t ro=rank[vi];
+          hist.Remove(ro);
+          if (ro<m)
+            {
+            --below;
+            }
+
+          const size_t ri=rank[vi+kni];
+          hist.Insert(ri);
+          if (ri<m)
+            {
+            ++below;
+            }
+          }
+        }
+
+      // move to the new median
+      while (below>h)
+        {
+        m=hist.Prev(m);
+        --below;
+        }
+      m=hist.Next(m);
+      while (below<h)
+        {
+        m=hist.Next(m+1);
+        ++below;
+        }
 
+      w[nComp*i]=V[nComp*order[m]+comp];
+      }
+
+    // empty the histogram for the next row
+    for (size_t c=0; c<knk; ++c)
+      {
+      for (size_t b=0; b<knj; ++b)
+        {
+        const size_t vi=v0+ni*b+nij*c+_ni-1;
+        for (size_t a=0; a<kni; ++a)
+          {
+          hist.Remove(rank[vi+a]);
+          }
+        }
+      }
+    }
+}
 
 //*****************************************************************************
 template <typename T>
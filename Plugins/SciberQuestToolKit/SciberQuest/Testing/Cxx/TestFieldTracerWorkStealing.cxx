@@ -0,0 +1,213 @@
+/*
+   ____    _ __           ____               __    ____
+  / __/___(_) /  ___ ____/ __ \__ _____ ___ / /_  /  _/__  ____
+ _\ \/ __/ / _ \/ -_) __/ /_/ / // / -_|_-</ __/ _/ // _ \/ __/
+/___/\__/_/_.__/\__/_/  \___\_\_,_/\__/___/\__/ /___/_//_/\__(_)
+
+Copyright 2012 SciberQuest Inc.
+*/
+#include "vtkMultiProcessController.h"
+#include "vtkSQLog.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkSQBOVMetaReader.h"
+#include "vtkSQFieldTracer.h"
+#include "vtkSQPlaneSource.h"
+#include "vtkSphereSource.h"
+#include "vtkDataArray.h"
+#include "vtkCellData.h"
+#include "vtkIdList.h"
+#include "vtkPolyData.h"
+#include "TestUtils.h"
+
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+Maps the field topology of a plane of seeds with the static scheduler,
+the master/worker scheduler and the work stealing scheduler (with one
+and two threads per process). The maps are gathered on rank 0, where
+every seed must be present exactly once and classified the same way
+by all schedulers.
+*/
+namespace
+{
+// seed cells are identified by their centroid
+typedef std::vector<long long> SeedKey;
+typedef std::map<SeedKey,double> TopologyMap;
+
+int MapTopology(
+      vtkMultiProcessController *controller,
+      const std::string &fileName,
+      int dynamic,
+      int workStealing,
+      int nThreads,
+      TopologyMap &topology)
+{
+  int worldRank=controller->GetLocalProcessId();
+  int worldSize=controller->GetNumberOfProcesses();
+
+  vtkSQBOVMetaReader *r=vtkSQBOVMetaReader::New();
+  r->SetFileName(fileName.c_str());
+  r->SetPointArrayStatus("vi",1);
+  r->SetBlockSize(8,8,8);
+  r->SetBlockCacheSize(1);
+
+  vtkSphereSource *s1=vtkSphereSource::New();
+  s1->SetCenter(3.5,6.0,1.5);
+  s1->SetRadius(1.0);
+
+  vtkSphereSource *s2=vtkSphereSource::New();
+  s2->SetCenter(3.5,1.0,6.0);
+  s2->SetRadius(0.8);
+
+  vtkSQPlaneSource *p=vtkSQPlaneSource::New();
+  p->SetOrigin(1.0,3.5,0.25);
+  p->SetPoint1(6.0,3.5,0.25);
+  p->SetPoint2(1.0,3.5,4.75);
+  p->SetXResolution(24);
+  p->SetYResolution(24);
+
+  vtkSQFieldTracer *ftm=vtkSQFieldTracer::New();
+  ftm->SetMode(vtkSQFieldTracer::MODE_TOPOLOGY);
+  ftm->SetIntegratorType(vtkSQFieldTracer::INTEGRATOR_RK45);
+  ftm->SetMinStep(1.0e-8);
+  ftm->SetMaxStep(0.1);
+  ftm->SetMaxError(0.001);
+  ftm->SetMaxNumberOfSteps(10000);
+  ftm->SetMaxLineLength(70);
+  ftm->SetNullThreshold(0.001);
+  ftm->SetSqueezeColorMap(0);
+  ftm->SetForwardOnly(0);
+  ftm->SetUseDynamicScheduler(dynamic);
+  ftm->SetUseWorkStealing(workStealing);
+  ftm->SetNumberOfThreads(nThreads);
+  ftm->SetMasterBlockSize(0);
+  // small blocks so that the processes steal from each other
+  ftm->SetWorkerBlockSize(4);
+  ftm->AddInputConnection(0,r->GetOutputPort(0));
+  ftm->AddInputConnection(1,p->GetOutputPort(0));
+  ftm->AddInputConnection(2,s1->GetOutputPort(0));
+  ftm->AddInputConnection(2,s2->GetOutputPort(0));
+  ftm->SetInputArrayToProcess(0,0,0,vtkDataObject::FIELD_ASSOCIATION_POINTS,"vi");
+
+  r->Delete();
+  p->Delete();
+  s1->Delete();
+  s2->Delete();
+
+  GetParallelExec(worldRank, worldSize, ftm, 0.0);
+  ftm->Update();
+
+  vtkPolyData *local=vtkPolyData::SafeDownCast(ftm->GetOutputDataObject(0));
+  vtkPolyData *all=Gather(controller,0,local);
+  ftm->Delete();
+
+  int failed=0;
+  if (worldRank==0)
+    {
+    vtkDataArray *color=all->GetCellData()->GetArray("IntersectColor");
+    if (!color)
+      {
+      std::cerr << "IntersectColor is missing." << std::endl;
+      failed=1;
+      }
+    vtkIdType nCells=failed?0:all->GetNumberOfCells();
+    vtkIdList *ids=vtkIdList::New();
+    for (vtkIdType i=0; i<nCells; ++i)
+      {
+      all->GetCellPoints(i,ids);
+      double c[3]={0.0,0.0,0.0};
+      vtkIdType nIds=ids->GetNumberOfIds();
+      for (vtkIdType j=0; j<nIds; ++j)
+        {
+        double *x=all->GetPoint(ids->GetId(j));
+        c[0]+=x[0];
+        c[1]+=x[1];
+        c[2]+=x[2];
+        }
+      SeedKey key(3);
+      for (int q=0; q<3; ++q)
+        {
+        key[q]=static_cast<long long>(floor(1.0e6*c[q]/nIds+0.5));
+        }
+      if (!topology.insert(std::make_pair(key,color->GetTuple1(i))).second)
+        {
+        std::cerr << "Seed " << i << " was integrated more than once." << std::endl;
+        failed=1;
+        break;
+        }
+      }
+    ids->Delete();
+    all->Delete();
+    }
+  controller->Broadcast(&failed,1,0);
+
+  return failed;
+}
+}
+
+int TestFieldTracerWorkStealing(int argc, char *argv[])
+{
+  vtkMultiProcessController *controller=Initialize(&argc,&argv);
+  int worldRank=controller->GetLocalProcessId();
+
+  // configure
+  std::string dataRoot;
+  std::string tempDir;
+  std::string baseline;
+  BroadcastConfiguration(controller,argc,argv,dataRoot,tempDir,baseline);
+
+  std::string inputFileName;
+  inputFileName=NativePath(dataRoot+"/SciberQuestToolKit/SmallVector/SmallVector.bovm");
+
+  std::string logFileName;
+  logFileName=NativePath(tempDir+"/SciberQuestToolKit-TestFieldTracerWorkStealing.log");
+  vtkSQLog::GetGlobalInstance()->SetFileName(logFileName.c_str());
+  vtkSQLog::GetGlobalInstance()->SetGlobalLevel(1);
+
+  const size_t nSeeds=24*24;
+
+  // reference, static scheduler
+  TopologyMap ref;
+  int aTestFailed=MapTopology(controller,inputFileName,0,0,1,ref);
+  if (!aTestFailed && (worldRank==0) && (ref.size()!=nSeeds))
+    {
+    std::cerr
+      << "The static scheduler mapped " << ref.size()
+      << " seeds out of " << nSeeds << std::endl;
+    aTestFailed=1;
+    }
+  controller->Broadcast(&aTestFailed,1,0);
+
+  const int nConfigs=3;
+  const int configs[nConfigs][2]={
+    {0,1},    // master/worker
+    {1,1},    // work stealing
+    {1,2}};   // work stealing, two threads per process
+  for (int i=0; (i<nConfigs) && !aTestFailed; ++i)
+    {
+    TopologyMap topology;
+    aTestFailed=MapTopology(
+          controller,
+          inputFileName,
+          1,
+          configs[i][0],
+          configs[i][1],
+          topology);
+    if (!aTestFailed && (worldRank==0) && (topology!=ref))
+      {
+      std::cerr
+        << "UseWorkStealing=" << configs[i][0]
+        << " NumberOfThreads=" << configs[i][1]
+        << " mapped " << topology.size() << " seeds, which differ"
+        << " from the static scheduler's map." << std::endl;
+      aTestFailed=1;
+      }
+    controller->Broadcast(&aTestFailed,1,0);
+    }
+
+  return Finalize(controller,aTestFailed);
+}
@@ -0,0 +1,218 @@
+/*
+   ____    _ __           ____               __    ____
+  / __/___(_) /  ___ ____/ __ \__ _____ ___ / /_  /  _/__  ____
+ _\ \/ __/ / _ \/ -_) __/ /_/ / // / -_|_-</ __/ _/ // _ \/ __/
+/___/\__/_/_.__/\__/_/  \___\_\_,_/\__/___/\__/ /___/_//_/\__(_)
+
+Copyright 2012 SciberQuest Inc.
+*/
+#include "vtkMultiProcessController.h"
+#include "vtkSQMedianFilter.h"
+#include "vtkTrivialProducer.h"
+#include "vtkImageData.h"
+#include "vtkPointData.h"
+#include "vtkDataObject.h"
+#include "vtkFloatArray.h"
+#include "vtkDoubleArray.h"
+#include "TestUtils.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+/**
+Compares vtkSQMedianFilter to a brute force median, computed by sorting
+the stencil of every output point, on 2D and 3D images with one and
+several threads. The inputs take only a few distinct values so that
+most stencils have ties. The input is built in memory so that every
+process runs the same serial comparison.
+*/
+namespace
+{
+// float scalar and double vector fields with few distinct values.
+vtkImageData *NewImage(int nx, int ny, int nz)
+{
+  vtkImageData *im=vtkImageData::New();
+  im->SetExtent(0,nx-1,0,ny-1,0,nz-1);
+
+  vtkIdType n=im->GetNumberOfPoints();
+
+  vtkFloatArray *s=vtkFloatArray::New();
+  s->SetName("s");
+  s->SetNumberOfTuples(n);
+
+  vtkDoubleArray *v=vtkDoubleArray::New();
+  v->SetName("v");
+  v->SetNumberOfComponents(3);
+  v->SetNumberOfTuples(n);
+
+  for (int k=0; k<nz; ++k)
+    {
+    for (int j=0; j<ny; ++j)
+      {
+      for (int i=0; i<nx; ++i)
+        {
+        vtkIdType q=i+nx*(j+ny*k);
+        s->SetValue(q,(float)((7*i+3*j+5*k)%5)-1.5f);
+        v->SetComponent(q,0,(i*j+k)%3);
+        v->SetComponent(q,1,-0.25*((i+2*j*k)%4));
+        v->SetComponent(q,2,(i/2+j/3+k)%2);
+        }
+      }
+    }
+
+  im->GetPointData()->AddArray(s);
+  im->GetPointData()->AddArray(v);
+  s->Delete();
+  v->Delete();
+
+  return im;
+}
+
+vtkImageData *MedianFilter(
+      vtkImageData *input,
+      const char *name,
+      int kernelWidth,
+      int nThreads)
+{
+  vtkTrivialProducer *tp=vtkTrivialProducer::New();
+  tp->SetOutput(input);
+
+  vtkSQMedianFilter *mf=vtkSQMedianFilter::New();
+  mf->SetKernelType(vtkSQMedianFilter::KERNEL_TYPE_MEDIAN);
+  mf->SetKernelWidth(kernelWidth);
+  mf->SetNumberOfThreads(nThreads);
+  mf->SetInputArrayToProcess(0,0,0,vtkDataObject::FIELD_ASSOCIATION_POINTS,name);
+  mf->SetInputConnection(0,tp->GetOutputPort(0));
+  mf->Update();
+
+  vtkImageData *output=vtkImageData::New();
+  output->ShallowCopy(mf->GetOutputDataObject(0));
+
+  mf->Delete();
+  tp->Delete();
+
+  return output;
+}
+
+// returns the number of output values that differ from the median of
+// the sorted stencil.
+int Compare(vtkImageData *input, vtkImageData *output, const char *name, int kernelWidth)
+{
+  vtkDataArray *V=input->GetPointData()->GetArray(name);
+  vtkDataArray *W=output->GetPointData()->GetArray(name);
+
+  int inExt[6];
+  input->GetExtent(inExt);
+  int outExt[6];
+  output->GetExtent(outExt);
+
+  int h=kernelWidth/2;
+  int hk=inExt[4]==inExt[5]?0:h;
+
+  size_t nOut=(outExt[1]-outExt[0]+1)*(outExt[3]-outExt[2]+1)*(outExt[5]-outExt[4]+1);
+  if (!W || (W->GetNumberOfTuples()!=(vtkIdType)nOut)
+    || (W->GetNumberOfComponents()!=V->GetNumberOfComponents()))
+    {
+    std::cerr << "Array " << name << " is missing or has the wrong size." << std::endl;
+    return 1;
+    }
+
+  int ni=inExt[1]-inExt[0]+1;
+  int nj=inExt[3]-inExt[2]+1;
+  int _ni=outExt[1]-outExt[0]+1;
+  int _nj=outExt[3]-outExt[2]+1;
+  int nComp=V->GetNumberOfComponents();
+
+  int nErrors=0;
+  std::vector<double> stencil;
+  for (int k=outExt[4]; k<=outExt[5]; ++k)
+    {
+    for (int j=outExt[2]; j<=outExt[3]; ++j)
+      {
+      for (int i=outExt[0]; i<=outExt[1]; ++i)
+        {
+        vtkIdType w=(i-outExt[0])+_ni*((j-outExt[2])+_nj*(k-outExt[4]));
+        for (int q=0; q<nComp; ++q)
+          {
+          stencil.clear();
+          for (int c=k-hk; c<=k+hk; ++c)
+            {
+            for (int b=j-h; b<=j+h; ++b)
+              {
+              for (int a=i-h; a<=i+h; ++a)
+                {
+                vtkIdType v=(a-inExt[0])+ni*((b-inExt[2])+nj*(c-inExt[4]));
+                stencil.push_back(V->GetComponent(v,q));
+                }
+              }
+            }
+          size_t m=stencil.size()/2;
+          std::nth_element(stencil.begin(),stencil.begin()+m,stencil.end());
+          if (W->GetComponent(w,q)!=stencil[m])
+            {
+            if (nErrors<10)
+              {
+              std::cerr
+                << "median of " << name << "[" << q << "] at "
+                << i << "," << j << "," << k << " is " << W->GetComponent(w,q)
+                << " instead of " << stencil[m] << std::endl;
+              }
+            ++nErrors;
+            }
+          }
+        }
+      }
+    }
+
+  return nErrors;
+}
+}
+
+int TestMedianFilter(int argc, char *argv[])
+{
+  vtkMultiProcessController *controller=Initialize(&argc,&argv);
+
+  const int nDims=2;
+  vtkImageData *input[nDims]={
+    NewImage(23,19,1),   // 2D
+    NewImage(15,13,11)}; // 3D
+
+  const int kernelWidth[3]={3,5,7};
+  const int nThreads[2]={1,3};
+  const char *arrays[2]={"s","v"};
+
+  int aTestFailed=0;
+  for (int d=0; (d<nDims) && !aTestFailed; ++d)
+    {
+    for (int w=0; (w<3) && !aTestFailed; ++w)
+      {
+      for (int t=0; (t<2) && !aTestFailed; ++t)
+        {
+        for (int a=0; a<2; ++a)
+          {
+          vtkImageData *output
+            = MedianFilter(input[d],arrays[a],kernelWidth[w],nThreads[t]);
+
+          int nErrors=Compare(input[d],output,arrays[a],kernelWidth[w]);
+          if (nErrors)
+            {
+            std::cerr
+              << nErrors << " wrong medians of " << arrays[a]
+              << " with " << (d?"3D":"2D")
+              << " KernelWidth=" << kernelWidth[w]
+              << " NumberOfThreads=" << nThreads[t] << std::endl;
+            aTestFailed=1;
+            }
+
+          output->Delete();
+          }
+        }
+      }
+    }
+
+  input[0]->Delete();
+  input[1]->Delete();
+
+  return Finalize(controller,aTestFailed);
+}
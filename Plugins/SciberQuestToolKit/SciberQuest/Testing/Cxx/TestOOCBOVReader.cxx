@@ -0,0 +1,211 @@
+/*
+   ____    _ __           ____               __    ____
+  / __/___(_) /  ___ ____/ __ \__ _____ ___ / /_  /  _/__  ____
+ _\ \/ __/ / _ \/ -_) __/ /_/ / // / -_|_-</ __/ _/ // _ \/ __/
+/___/\__/_/_.__/\__/_/  \___\_\_,_/\__/___/\__/ /___/_//_/\__(_)
+
+Copyright 2012 SciberQuest Inc.
+*/
+#include "vtkMultiProcessController.h"
+#include "vtkInformation.h"
+#include "vtkDataArray.h"
+#include "vtkDataSet.h"
+#include "vtkPointData.h"
+#include "vtkPVInformationKeys.h"
+#include "vtkSQLog.h"
+#include "vtkSQBOVMetaReader.h"
+#include "vtkSQOOCBOVReader.h"
+#include "CartesianBounds.h"
+#include "TestUtils.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+Walks along the x-axis through the domain and back with a small block cache,
+reading the block around each point with the out-of-core reader. The
+values found at each point must be the same whether the brick files
+are memory mapped or read with MPI-IO and whether or not the
+neighboring blocks are prefetched. The cache statistics must account
+for every access and the prefetcher must have been used.
+*/
+namespace
+{
+struct OOCWalk
+{
+  std::vector<double> Values;
+  long long Hits;
+  long long Misses;
+  long long Prefetches;
+  long long PrefetchHits;
+  unsigned long long BytesRead;
+  unsigned long long BytesUsed;
+};
+
+int Walk(
+      const std::string &fileName,
+      int useMemoryMap,
+      int prefetchBlocks,
+      int nSteps,
+      OOCWalk &walk)
+{
+  vtkSQBOVMetaReader *mr=vtkSQBOVMetaReader::New();
+  mr->SetFileName(fileName.c_str());
+  mr->SetPointArrayStatus("b",1);
+  mr->SetBlockSize(8,8,8);
+  mr->SetBlockCacheSize(2);
+  mr->SetUseMemoryMap(useMemoryMap);
+  mr->SetPrefetchBlocks(prefetchBlocks);
+  mr->Update();
+
+  vtkInformation *info=mr->GetOutputInformation(0);
+  vtkSQOOCReader *oocr
+    = info->Has(vtkSQOOCReader::READER())
+    ? dynamic_cast<vtkSQOOCReader*>(info->Get(vtkSQOOCReader::READER()))
+    : 0;
+  vtkSQOOCBOVReader *reader=dynamic_cast<vtkSQOOCBOVReader*>(oocr);
+  if (!reader || !info->Has(vtkPVInformationKeys::WHOLE_BOUNDING_BOX()))
+    {
+    std::cerr << "The meta reader did not provide an OOC reader." << std::endl;
+    mr->Delete();
+    return 1;
+    }
+  double bounds[6];
+  info->Get(vtkPVInformationKeys::WHOLE_BOUNDING_BOX(),bounds);
+
+  reader->Register(0);
+  reader->DeActivateAllArrays();
+  reader->ActivateArray("b");
+  reader->SetCommunicator(MPI_COMM_SELF);
+  reader->Open();
+
+  int failed=0;
+  int nAccess=0;
+  walk.Values.clear();
+  for (int i=0; (i<2*nSteps) && !failed; ++i)
+    {
+    // there and back again
+    double s=(i<nSteps?i:2*nSteps-1-i)/(nSteps-1.0);
+    double pt[3]={
+      bounds[0]+(0.05+0.9*s)*(bounds[1]-bounds[0]),
+      0.5*(bounds[2]+bounds[3]),
+      0.5*(bounds[4]+bounds[5])};
+
+    CartesianBounds workingDomain;
+    vtkDataSet *data=reader->ReadNeighborhood(pt,workingDomain);
+    nAccess+=1;
+    vtkDataArray *b=data?data->GetPointData()->GetArray("b"):0;
+    vtkIdType pid=data?data->FindPoint(pt):-1;
+    if (!b || (pid<0))
+      {
+      std::cerr
+        << "Failed to read the neighborhood of "
+        << pt[0] << ", " << pt[1] << ", " << pt[2] << std::endl;
+      failed=1;
+      break;
+      }
+    int nComps=b->GetNumberOfComponents();
+    for (int q=0; q<nComps; ++q)
+      {
+      walk.Values.push_back(b->GetComponent(pid,q));
+      }
+    }
+
+  walk.Hits=reader->GetCacheHitCount();
+  walk.Misses=reader->GetCacheMissCount();
+  walk.Prefetches=reader->GetPrefetchCount();
+  walk.PrefetchHits=reader->GetPrefetchHitCount();
+  walk.BytesRead=reader->GetBytesRead();
+  walk.BytesUsed=reader->GetBytesUsed();
+
+  if (!failed && (walk.Hits+walk.Misses!=nAccess))
+    {
+    std::cerr
+      << "Cache statistics account for " << walk.Hits+walk.Misses
+      << " accesses out of " << nAccess << std::endl;
+    failed=1;
+    }
+  if (!failed && ((walk.BytesUsed==0) || (walk.BytesUsed>walk.BytesRead)))
+    {
+    std::cerr
+      << "Bad byte counts, read " << walk.BytesRead
+      << " used " << walk.BytesUsed << std::endl;
+    failed=1;
+    }
+
+  reader->Close();
+  reader->Delete();
+  mr->Delete();
+
+  return failed;
+}
+}
+
+int TestOOCBOVReader(int argc, char *argv[])
+{
+  vtkMultiProcessController *controller=Initialize(&argc,&argv);
+
+  // configure
+  std::string dataRoot;
+  std::string tempDir;
+  std::string baseline;
+  BroadcastConfiguration(controller,argc,argv,dataRoot,tempDir,baseline);
+
+  std::string inputFileName;
+  inputFileName=dataRoot+"/SciberQuestToolKit/MagneticIslands/MagneticIslands.bov";
+
+  std::string logFileName;
+  logFileName=NativePath(tempDir+"/SciberQuestToolKit-TestOOCBOVReader.log");
+  vtkSQLog::GetGlobalInstance()->SetFileName(logFileName.c_str());
+  vtkSQLog::GetGlobalInstance()->SetGlobalLevel(1);
+
+  const int nSteps=200;
+  int aTestFailed=0;
+
+  // reference, MPI-IO without prefetch
+  OOCWalk ref;
+  aTestFailed=Walk(inputFileName,0,0,nSteps,ref);
+
+  for (int useMemoryMap=0; (useMemoryMap<2) && !aTestFailed; ++useMemoryMap)
+    {
+    for (int prefetch=0; (prefetch<2) && !aTestFailed; ++prefetch)
+      {
+      if (!useMemoryMap && !prefetch)
+        {
+        continue;
+        }
+      OOCWalk walk;
+      aTestFailed=Walk(inputFileName,useMemoryMap,prefetch,nSteps,walk);
+      if (!aTestFailed && (walk.Values!=ref.Values))
+        {
+        std::cerr << "Values differ from the reference";
+        aTestFailed=1;
+        }
+      if (!aTestFailed && prefetch && (walk.Prefetches==0))
+        {
+        std::cerr << "Nothing was prefetched";
+        aTestFailed=1;
+        }
+      // without a memory map, prefetched blocks are read into the cache
+      // so walking in a straight line must hit them.
+      if (!aTestFailed && prefetch && !useMemoryMap
+        && ((walk.PrefetchHits==0) || (walk.Misses>=ref.Misses)))
+        {
+        std::cerr
+          << "Prefetching did not save any read (" << walk.PrefetchHits
+          << " prefetch hits, " << walk.Misses << " misses vs "
+          << ref.Misses << ")";
+        aTestFailed=1;
+        }
+      if (aTestFailed)
+        {
+        std::cerr
+          << " with UseMemoryMap=" << useMemoryMap
+          << " PrefetchBlocks=" << prefetch << std::endl;
+        }
+      }
+    }
+
+  return Finalize(controller,aTestFailed);
+}
@@ -0,0 +1,186 @@
+/*
+   ____    _ __           ____               __    ____
+  / __/___(_) /  ___ ____/ __ \__ _____ ___ / /_  /  _/__  ____
+ _\ \/ __/ / _ \/ -_) __/ /_/ / // / -_|_-</ __/ _/ // _ \/ __/
+/___/\__/_/_.__/\__/_/  \___\_\_,_/\__/___/\__/ /___/_//_/\__(_)
+
+Copyright 2012 SciberQuest Inc.
+*/
+#include "vtkMultiProcessController.h"
+#include "vtkSQKernelConvolution.h"
+#include "vtkTrivialProducer.h"
+#include "vtkImageData.h"
+#include "vtkPointData.h"
+#include "vtkFloatArray.h"
+#include "vtkDoubleArray.h"
+#include "CPUConvolutionDriver.h"
+#include "TestUtils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+/**
+Convolves a scalar and a vector field with the separable kernel
+optimization and compares the results to those of the full kernel,
+for Gaussian and constant kernels on 2D and 3D images and with one
+and several threads. The input is built in memory so that every
+process runs the same serial comparison.
+*/
+namespace
+{
+// scalar (float) and vector (double) fields that vary in every direction.
+vtkImageData *NewImage(int nx, int ny, int nz)
+{
+  vtkImageData *im=vtkImageData::New();
+  im->SetExtent(0,nx-1,0,ny-1,0,nz-1);
+  im->SetOrigin(0.0,0.0,0.0);
+  im->SetSpacing(1.0,1.0,1.0);
+
+  vtkIdType n=im->GetNumberOfPoints();
+
+  vtkFloatArray *s=vtkFloatArray::New();
+  s->SetName("s");
+  s->SetNumberOfTuples(n);
+
+  vtkDoubleArray *v=vtkDoubleArray::New();
+  v->SetName("v");
+  v->SetNumberOfComponents(3);
+  v->SetNumberOfTuples(n);
+
+  for (vtkIdType i=0; i<n; ++i)
+    {
+    double x[3];
+    im->GetPoint(i,x);
+    s->SetValue(i,(float)(sin(0.7*x[0])*cos(0.3*x[1])+0.1*x[2]*x[2]));
+    v->SetComponent(i,0,cos(0.5*x[0]+x[1]));
+    v->SetComponent(i,1,x[0]*x[1]-x[2]);
+    v->SetComponent(i,2,sin(x[0]-0.2*x[2]));
+    }
+
+  im->GetPointData()->AddArray(s);
+  im->GetPointData()->AddArray(v);
+  s->Delete();
+  v->Delete();
+
+  return im;
+}
+
+vtkImageData *Convolve(
+      vtkImageData *input,
+      int kernelType,
+      int kernelWidth,
+      int optimization,
+      int nThreads)
+{
+  vtkTrivialProducer *tp=vtkTrivialProducer::New();
+  tp->SetOutput(input);
+
+  vtkSQKernelConvolution *kc=vtkSQKernelConvolution::New();
+  kc->SetKernelType(kernelType);
+  kc->SetKernelWidth(kernelWidth);
+  kc->SetCPUDriverOptimization(optimization);
+  kc->SetNumberOfThreads(nThreads);
+  kc->AddInputArray("s");
+  kc->AddInputArray("v");
+  kc->SetInputConnection(0,tp->GetOutputPort(0));
+  kc->Update();
+
+  vtkImageData *output=vtkImageData::New();
+  output->ShallowCopy(kc->GetOutputDataObject(0));
+
+  kc->Delete();
+  tp->Delete();
+
+  return output;
+}
+
+// returns the largest difference relative to the largest magnitude.
+double Compare(vtkImageData *ref, vtkImageData *im, const char *name)
+{
+  vtkDataArray *a=ref->GetPointData()->GetArray(name);
+  vtkDataArray *b=im->GetPointData()->GetArray(name);
+  if (!a || !b
+    || (a->GetNumberOfTuples()==0)
+    || (a->GetNumberOfTuples()!=b->GetNumberOfTuples())
+    || (a->GetNumberOfComponents()!=b->GetNumberOfComponents()))
+    {
+    std::cerr << "Array " << name << " is missing or has the wrong size." << std::endl;
+    return 1.0;
+    }
+  double maxDiff=0.0;
+  double maxVal=0.0;
+  vtkIdType n=a->GetNumberOfTuples()*a->GetNumberOfComponents();
+  for (vtkIdType i=0; i<n; ++i)
+    {
+    double va=a->GetComponent(i/a->GetNumberOfComponents(),i%a->GetNumberOfComponents());
+    double vb=b->GetComponent(i/b->GetNumberOfComponents(),i%b->GetNumberOfComponents());
+    maxDiff=std::max(maxDiff,fabs(va-vb));
+    maxVal=std::max(maxVal,fabs(va));
+    }
+  return maxVal>0.0?maxDiff/maxVal:maxDiff;
+}
+}
+
+int TestSeparableConvolution(int argc, char *argv[])
+{
+  vtkMultiProcessController *controller=Initialize(&argc,&argv);
+
+  const int nDims=2;
+  vtkImageData *input[nDims]={
+    NewImage(40,33,1),   // 2D
+    NewImage(24,21,19)}; // 3D
+
+  const int nKernels=2;
+  const int kernelType[nKernels]={
+    vtkSQKernelConvolution::KERNEL_TYPE_GAUSSIAN,
+    vtkSQKernelConvolution::KERNEL_TYPE_CONSTANT};
+  const int kernelWidth[3]={3,5,9};
+  const int nThreads[2]={1,3};
+
+  // the scalar is float, tolerate float round-off accumulated over
+  // the kernel.
+  const double tol[2]={1.0e-5,1.0e-12};
+  const char *arrays[2]={"s","v"};
+
+  int aTestFailed=0;
+  for (int d=0; (d<nDims) && !aTestFailed; ++d)
+    {
+    for (int k=0; (k<nKernels) && !aTestFailed; ++k)
+      {
+      for (int w=0; (w<3) && !aTestFailed; ++w)
+        {
+        vtkImageData *ref
+          = Convolve(input[d],kernelType[k],kernelWidth[w],CPUConvolutionDriver::OPT_NONE,1);
+
+        for (int t=0; (t<2) && !aTestFailed; ++t)
+          {
+          vtkImageData *sep
+            = Convolve(input[d],kernelType[k],kernelWidth[w],CPUConvolutionDriver::OPT_SEPARABLE,nThreads[t]);
+          for (int a=0; a<2; ++a)
+            {
+            double err=Compare(ref,sep,arrays[a]);
+            if (err>tol[a])
+              {
+              std::cerr
+                << "OPT_SEPARABLE differs from OPT_NONE by " << err
+                << " for array " << arrays[a]
+                << " with " << (d?"3D":"2D")
+                << " KernelType=" << kernelType[k]
+                << " KernelWidth=" << kernelWidth[w]
+                << " NumberOfThreads=" << nThreads[t] << std::endl;
+              aTestFailed=1;
+              }
+            }
+          sep->Delete();
+          }
+        ref->Delete();
+        }
+      }
+    }
+
+  input[0]->Delete();
+  input[1]->Delete();
+
+  return Finalize(controller,aTestFailed);
+}
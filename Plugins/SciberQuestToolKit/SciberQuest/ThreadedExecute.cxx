@@ -0,0 +1,33 @@
+/*
+   ____    _ __           ____               __    ____
+  / __/___(_) /  ___ ____/ __ \__ _____ ___ / /_  /  _/__  ____
+ _\ \/ __/ / _ \/ -_) __/ /_/ / // / -_|_-</ __/ _/ // _ \/ __/
+/___/\__/_/_.__/\__/_/  \___\_\_,_/\__/___/\__/ /___/_//_/\__(_)
+
+Copyright 2012 SciberQuest Inc.
+*/
+#include "ThreadedExecute.h"
+
+//-----------------------------------------------------------------------------
+void ThreadedExecute(vtkThreadFunctionType method, void *data, int nThreads)
+{
+  if (nThreads>1)
+    {
+    vtkMultiThreader *threader=vtkMultiThreader::New();
+    threader->SetNumberOfThreads(nThreads);
+    threader->SetSingleMethod(method,data);
+    threader->SingleMethodExecute();
+    threader->Delete();
+    }
+  else
+    {
+    // avoid the cost of starting a thread.
+    vtkMultiThreader::ThreadInfo info;
+    info.ThreadID=0;
+    info.NumberOfThreads=1;
+    info.ActiveFlag=0;
+    info.ActiveFlagLock=0;
+    info.UserData=data;
+    (*method)(&info);
+    }
+}
@@ -0,0 +1,23 @@
+/*
+   ____    _ __           ____               __    ____
+  / __/___(_) /  ___ ____/ __ \__ _____ ___ / /_  /  _/__  ____
+ _\ \/ __/ / _ \/ -_) __/ /_/ / // / -_|_-</ __/ _/ // _ \/ __/
+/___/\__/_/_.__/\__/_/  \___\_\_,_/\__/___/\__/ /___/_//_/\__(_)
+
+Copyright 2012 SciberQuest Inc.
+*/
+#ifndef __ThreadedExecute_h
+#define __ThreadedExecute_h
+
+#include "vtkMultiThreader.h" // for vtkThreadFunctionType
+
+/**
+Run method on nThreads threads of a vtkMultiThreader. The method gets a
+vtkMultiThreader::ThreadInfo whose UserData is data. When nThreads is 1
+the method is called directly in the calling thread.
+*/
+void ThreadedExecute(vtkThreadFunctionType method, void *data, int nThreads);
+
+#endif
+
+// VTK-HeaderTest-Exclude: ThreadedExecute.h
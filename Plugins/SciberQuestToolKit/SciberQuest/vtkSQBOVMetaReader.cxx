@@ -95,6 +95,8 @@ vtkSQBOVMetaReader::vtkSQBOVMetaReader()
   this->DecompDims[2]=1;
   this->BlockCacheSize=10;
   this->ClearCachedBlocks=1;
+  this->UseMemoryMap=0;
+  this->PrefetchBlocks=0;
   this->BlockSize[0]=
   this->BlockSize[1]=
   this->BlockSize[2]=96;
@@ -128,6 +130,8 @@ void vtkSQBOVMetaReader::Clear()
   this->DecompDims[2]=1;
   this->BlockCacheSize=10;
   this->ClearCachedBlocks=1;
+  this->UseMemoryMap=0;
+  this->PrefetchBlocks=0;
   this->BlockSize[0]=
   this->BlockSize[1]=
   this->BlockSize[2]=96;
@@ -206,6 +210,14 @@ int vtkSQBOVMetaReader::Initialize(
     this->SetClearCachedBlocks(0);
     }
 
+  int use_mmap=0;
+  GetOptionalAttribute<int,1>(elem,"use_mmap",&use_mmap);
+  this->SetUseMemoryMap(use_mmap);
+
+  int prefetch=0;
+  GetOptionalAttribute<int,1>(elem,"prefetch",&prefetch);
+  this->SetPrefetchBlocks(prefetch);
+
   this->SetUseCollectiveIO(vtkSQBOVMetaReader::HINT_DISABLED);
 
   vtkSQLog *log=vtkSQLog::GetGlobalInstance();
@@ -220,7 +232,9 @@ int vtkSQBOVMetaReader::Initialize(
       << "#   block_cache_size=" << this->BlockCacheSize << "\n"
       << "#   periodic_bc=" << Tuple<int>(this->PeriodicBC,3) << "\n"
       << "#   n_ghosts=" << this->NGhosts << "\n"
-      << "#   clear_cache=" << this->ClearCachedBlocks << "\n";
+      << "#   clear_cache=" << this->ClearCachedBlocks << "\n"
+      << "#   use_mmap=" << this->UseMemoryMap << "\n"
+      << "#   prefetch=" << this->PrefetchBlocks << "\n";
     }
 
   return 0;
@@ -885,12 +899,15 @@ int vtkSQBOVMetaReader::RequestData(
 
   // Put a reader into the pipeline, downstream filters can
   // the read on demand.
+  this->Reader->SetUseMemoryMap(this->UseMemoryMap);
+
   vtkSQOOCBOVReader *OOCReader=vtkSQOOCBOVReader::New();
   OOCReader->SetReader(this->Reader);
   OOCReader->SetTimeIndex(stepId);
   OOCReader->SetDomainDecomp(ddecomp);
   OOCReader->SetBlockCacheSize(this->BlockCacheSize);
   OOCReader->SetCloseClearsCachedBlocks(this->ClearCachedBlocks);
+  OOCReader->SetPrefetchBlocks(this->PrefetchBlocks);
   OOCReader->InitializeBlockCache();
   OOCReader->SetLogLevel(this->LogLevel);
   info->Set(vtkSQOOCReader::READER(),OOCReader);
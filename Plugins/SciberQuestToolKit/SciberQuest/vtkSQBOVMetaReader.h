@@ -96,6 +96,20 @@ public:
   vtkSetMacro(ClearCachedBlocks,int);
   vtkGetMacro(ClearCachedBlocks,int);
 
+  // Description:
+  // If set the brick files are memory mapped and blocks are
+  // copied out of the map, letting the OS manage paging, rather
+  // than read with MPI-IO.
+  vtkSetMacro(UseMemoryMap,int);
+  vtkGetMacro(UseMemoryMap,int);
+
+  // Description:
+  // If set the neighbor block in the direction of travel is
+  // prefetched when a block is entered during out-of-core
+  // operation.
+  vtkSetMacro(PrefetchBlocks,int);
+  vtkGetMacro(PrefetchBlocks,int);
+
 protected:
   virtual int RequestInformation(
         vtkInformation *req,
@@ -134,6 +148,8 @@ private:
   int DecompDims[3];       // subset split into an LxMxN cartesian decomposition
   int BlockCacheSize;      // number of blocks to cache during ooc oepration
   int ClearCachedBlocks;   // control persistence of cahce
+  int UseMemoryMap;        // read blocks from memory mapped files
+  int PrefetchBlocks;      // prefetch blocks along the direction of travel
   int BlockSize[3];        // size of block in the decomp
   double BlockCacheRamFactor; // % of per-core ram to use for the block cache
   long long ProcRam;       // ram available on this host for all ranks.
@@ -45,6 +45,9 @@ Copyright 2012 SciberQuest Inc.
 #include "vtkRungeKutta4.h"
 #include "vtkRungeKutta45.h"
 #include "vtkMultiProcessController.h"
+#include "vtkMutexLock.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkTimerLog.h"
 #include "vtkMath.h"
 
 #include "vtkPVInformationKeys.h"
@@ -65,6 +68,7 @@ Copyright 2012 SciberQuest Inc.
 #include "UnstructuredFieldDisplacementMap.h"
 #include "StreamlineData.h"
 #include "PoincareMapData.h"
+#include "ThreadedExecute.h"
 #include "XMLUtils.h"
 #include "Tuple.hxx"
 #include "postream.h"
@@ -98,6 +102,50 @@ Copyright 2012 SciberQuest Inc.
 
 const double vtkSQFieldTracer::EPSILON = 1.0E-12;
 
+/// Per-thread state for integrating the lines of a block in parallel.
+/**
+Each thread has its own integrator, termination condition (the cell
+locators used for surface intersection are not thread safe) and
+private shallow copy of the last neighborhood read.
+*/
+class FieldTracerThread
+{
+public:
+  FieldTracerThread() : Integrator(0), Cache(0) {}
+  ~FieldTracerThread()
+    {
+    if (this->Integrator)
+      {
+      this->Integrator->Delete();
+      }
+    if (this->Cache)
+      {
+      this->Cache->Delete();
+      }
+    }
+
+  vtkInitialValueProblemSolver *Integrator;
+  TerminationCondition Tcon;
+  vtkDataSet *Cache;
+
+private:
+  FieldTracerThread(const FieldTracerThread &); // not implemented
+  void operator=(const FieldTracerThread &); // not implemented
+};
+
+/// The lines of a block shared by the integration threads.
+class FieldTracerWork
+{
+public:
+  vtkSQFieldTracer *Tracer;
+  FieldTraceData *TraceData;
+  vtkSQOOCReader *Reader;
+  const char *FieldName;
+  vtkIdType NumberOfLines;
+  vtkIdType NextLine;
+  vtkSimpleMutexLock LineLock;
+};
+
 //-----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSQFieldTracer);
 
@@ -107,8 +155,17 @@ vtkSQFieldTracer::vtkSQFieldTracer()
   WorldSize(1),
   WorldRank(0),
   UseDynamicScheduler(0),
+  UseWorkStealing(0),
   WorkerBlockSize(16),
   MasterBlockSize(256),
+  NumberOfThreads(1),
+  ReadLock(0),
+  IntegrationTime(0.0),
+  IdleTime(0.0),
+  NumberOfSeedsIntegrated(0),
+  NumberOfStealAttempts(0),
+  NumberOfSteals(0),
+  NumberOfSeedsStolen(0),
   ForwardOnly(0),
   StepUnit(ARC_LENGTH),
   MinStep(1.0E-8),
@@ -149,6 +206,7 @@ vtkSQFieldTracer::vtkSQFieldTracer()
   #endif
 
   this->TermCon=new TerminationCondition;
+  this->ReadLock=vtkMutexLock::New();
 
   this->SetNumberOfInputPorts(3);
   this->SetNumberOfOutputPorts(1);
@@ -165,6 +223,8 @@ vtkSQFieldTracer::~vtkSQFieldTracer()
     this->Integrator->Delete();
     }
   delete this->TermCon;
+  this->ClearThreads();
+  this->ReadLock->Delete();
 }
 
 //-----------------------------------------------------------------------------
@@ -255,6 +315,20 @@ int vtkSQFieldTracer::Initialize(vtkPVXMLElement *root)
     this->SetUseDynamicScheduler(dynamicScheduler);
     }
 
+  int workStealing=-1;
+  GetOptionalAttribute<int,1>(elem,"work_stealing",&workStealing);
+  if (workStealing>=0)
+    {
+    this->SetUseWorkStealing(workStealing);
+    }
+
+  int nThreads=-1;
+  GetOptionalAttribute<int,1>(elem,"n_threads",&nThreads);
+  if (nThreads>0)
+    {
+    this->SetNumberOfThreads(nThreads);
+    }
+
   int masterBlockSize=-1;
   GetOptionalAttribute<int,1>(elem,"master_block_size",&masterBlockSize);
   if (masterBlockSize>=0)
@@ -294,6 +368,8 @@ int vtkSQFieldTracer::Initialize(vtkPVXMLElement *root)
       << "#   nullThreshold=" << this->GetNullThreshold() << "\n"
       << "#   forwardOnly=" << this->GetForwardOnly() << "\n"
       << "#   dynamicScheduler=" << this->GetUseDynamicScheduler() << "\n"
+      << "#   workStealing=" << this->GetUseWorkStealing() << "\n"
+      << "#   nThreads=" << this->GetNumberOfThreads() << "\n"
       << "#   masterBlockSize=" << this->GetMasterBlockSize() << "\n"
       << "#   workerBlockSize=" << this->GetWorkerBlockSize() << "\n"
       << "#   squeezeColorMap=" << this->GetSqueezeColorMap() << "\n";
@@ -858,25 +934,53 @@ int vtkSQFieldTracer::RequestData(
     }
   tcon->InitializeColorMapper();
 
+  // Threads, if any, get their own copy of the termination condition.
+  this->InitializeThreads(pDomain,periodicBC,inputVector[2]);
+
+  this->IntegrationTime=0.0;
+  this->IdleTime=0.0;
+  this->NumberOfSeedsIntegrated=0;
+  this->NumberOfStealAttempts=0;
+  this->NumberOfSteals=0;
+  this->NumberOfSeedsStolen=0;
+  double workStart=vtkTimerLog::GetUniversalTime();
+
   /// Work loops
   if (this->UseDynamicScheduler)
     {
-    #if vtkSQFieldTracerDEBUG>1
-    pCerr() << "Starting dynamic scheduler." << std::endl;
-    #endif
     // This requires all process to have all the seed source data
     // present.
     vtkIdType nSourceCells
       = (sourceGen!=0?sourceGen->GetNumberOfCells():source->GetNumberOfCells());
 
-    this->IntegrateDynamic(
-          this->WorldRank,
-          this->WorldSize,
-          nSourceCells,
-          fieldName,
-          oocr.GetPointer(),
-          oocrCache,
-          traceData);
+    if (this->UseWorkStealing)
+      {
+      #if vtkSQFieldTracerDEBUG>1
+      pCerr() << "Starting work stealing scheduler." << std::endl;
+      #endif
+      this->IntegrateWorkStealing(
+            this->WorldRank,
+            this->WorldSize,
+            nSourceCells,
+            fieldName,
+            oocr.GetPointer(),
+            oocrCache,
+            traceData);
+      }
+    else
+      {
+      #if vtkSQFieldTracerDEBUG>1
+      pCerr() << "Starting dynamic scheduler." << std::endl;
+      #endif
+      this->IntegrateDynamic(
+            this->WorldRank,
+            this->WorldSize,
+            nSourceCells,
+            fieldName,
+            oocr.GetPointer(),
+            oocrCache,
+            traceData);
+      }
     }
   else
     {
@@ -893,6 +997,17 @@ int vtkSQFieldTracer::RequestData(
           traceData);
     }
 
+  // time not spent integrating is spent waiting for or distributing work.
+  double workTime=vtkTimerLog::GetUniversalTime()-workStart;
+  this->IdleTime=std::max(0.0,workTime-this->IntegrationTime);
+
+  if (this->LogLevel || globalLogLevel)
+    {
+    this->ReportLoadBalance();
+    }
+
+  this->ClearThreads();
+
   /// Remove segments where a periodic bc was applied.
   if ( (this->Mode==MODE_STREAM)
     && this->CullPeriodicTransitions
@@ -1126,6 +1241,323 @@ int vtkSQFieldTracer::IntegrateDynamic(
   return 1;
 }
 
+//-----------------------------------------------------------------------------
+int vtkSQFieldTracer::IntegrateWorkStealing(
+      int procId,
+      int nProcs,
+      vtkIdType nCells,
+      const char *fieldName,
+      vtkSQOOCReader *oocr,
+      vtkDataSet *&oocrCache,
+      FieldTraceData *traceData)
+{
+  #if defined vtkSQFieldTracerTIME
+  vtkSQLog *log=vtkSQLog::GetGlobalInstance();
+  log->StartEvent("vtkSQFieldTracer::IntegrateWorkStealing");
+  #endif
+
+  #ifdef SQTK_WITHOUT_MPI
+  (void)procId;
+  (void)nProcs;
+  (void)nCells;
+  (void)fieldName;
+  (void)oocr;
+  (void)oocrCache;
+  (void)traceData;
+  #else
+  const int STEAL_REQ=12346;
+  const int STEAL_REP=12347;
+  const int DONE_REQ=12348;
+  const int TERM_REQ=12349;
+  // proc 0 counts the completed seeds and detects termination, it does
+  // not hand out work.
+  const int counterProcId=0;
+
+  // Each process starts with a contiguous share of the seeds.
+  unsigned long long nTotal=(unsigned long long)nCells;
+  IdBlock local;
+  local.first()=nTotal*procId/nProcs;
+  local.size()=nTotal*(procId+1)/nProcs-local.first();
+
+  unsigned long long workerBlockSize
+    = (unsigned long long)std::max(this->WorkerBlockSize,1);
+
+  vtkMinimalStandardRandomSequence *rng
+    = vtkMinimalStandardRandomSequence::New();
+  rng->SetSeed(procId+1);
+
+  // Messages are sent without blocking, the buffers are kept alive
+  // until all of the sends complete.
+  std::vector<MPI_Request> reqs;
+  std::vector<IdBlock*> sentBlocks;
+  std::vector<unsigned long long*> sentCounts;
+  std::vector<int> nStealReqSent(nProcs,0);
+  int nStealReqRecvd=0;
+
+  unsigned long long nDone=0;      // completed, not yet reported
+  unsigned long long nDoneTotal=0; // completed on all procs (counter only)
+  int terminated=(nTotal==0);
+  int victim=-1;                   // set while a steal request is pending
+
+  while (!terminated)
+    {
+    // give half of the remaining seeds to any process asking for work.
+    int pendingReq=0;
+    do
+      {
+      MPI_Status stat;
+      MPI_Iprobe(MPI_ANY_SOURCE,STEAL_REQ,MPI_COMM_WORLD,&pendingReq,&stat);
+      if (pendingReq)
+        {
+        int buf;
+        int thief=stat.MPI_SOURCE;
+        MPI_Recv(&buf,0,MPI_INT,thief,STEAL_REQ,MPI_COMM_WORLD,&stat);
+        ++nStealReqRecvd;
+
+        // the back half is given away. If there is less than two seeds
+        // left an empty block is sent and the thief tries elsewhere.
+        IdBlock *loot=new IdBlock;
+        if (local.size()>1)
+          {
+          unsigned long long n=local.size()/2;
+          loot->first()=local.last()-n;
+          loot->size()=n;
+          local.size()-=n;
+          this->NumberOfSeedsStolen+=n;
+          }
+        MPI_Request req;
+        MPI_Isend(
+            loot->data(),
+            (int)loot->dataSize(),
+            MPI_UNSIGNED_LONG_LONG,
+            thief,
+            STEAL_REP,
+            MPI_COMM_WORLD,
+            &req);
+        reqs.push_back(req);
+        sentBlocks.push_back(loot);
+        #if vtkSQFieldTracerDEBUG>0
+        pCerr() << procId << " gave " << *loot << " to " << thief << std::endl;
+        #endif
+        }
+      }
+    while (pendingReq);
+
+    // check for global completion.
+    if (procId==counterProcId)
+      {
+      nDoneTotal+=nDone;
+      nDone=0;
+      int pendingDone=0;
+      do
+        {
+        MPI_Status stat;
+        MPI_Iprobe(MPI_ANY_SOURCE,DONE_REQ,MPI_COMM_WORLD,&pendingDone,&stat);
+        if (pendingDone)
+          {
+          unsigned long long n=0;
+          MPI_Recv(
+              &n,
+              1,
+              MPI_UNSIGNED_LONG_LONG,
+              stat.MPI_SOURCE,
+              DONE_REQ,
+              MPI_COMM_WORLD,
+              &stat);
+          nDoneTotal+=n;
+          }
+        }
+      while (pendingDone);
+
+      if (nDoneTotal>=nTotal)
+        {
+        int buf=0;
+        for (int i=0; i<nProcs; ++i)
+          {
+          if (i==procId) continue;
+          MPI_Request req;
+          MPI_Isend(&buf,0,MPI_INT,i,TERM_REQ,MPI_COMM_WORLD,&req);
+          reqs.push_back(req);
+          }
+        terminated=1;
+        break;
+        }
+      }
+    else
+      {
+      MPI_Status stat;
+      MPI_Iprobe(counterProcId,TERM_REQ,MPI_COMM_WORLD,&terminated,&stat);
+      if (terminated)
+        {
+        int buf;
+        MPI_Recv(&buf,0,MPI_INT,counterProcId,TERM_REQ,MPI_COMM_WORLD,&stat);
+        break;
+        }
+      }
+
+    // integrate a block of the local seeds.
+    if (!local.empty())
+      {
+      IdBlock sourceIds;
+      sourceIds.first()=local.first();
+      sourceIds.size()=std::min(workerBlockSize,local.size());
+      local.first()+=sourceIds.size();
+      local.size()-=sourceIds.size();
+
+      #if vtkSQFieldTracerDEBUG>0
+      pCerr() << procId << " integrating " << sourceIds << std::endl;
+      #endif
+      this->IntegrateBlock(
+              &sourceIds,
+              traceData,
+              fieldName,
+              oocr,
+              oocrCache);
+      nDone+=sourceIds.size();
+
+      double prog
+        = std::min(1.0,(double)this->NumberOfSeedsIntegrated*nProcs/(double)nTotal);
+      this->UpdateProgress(prog);
+      continue;
+      }
+
+    // out of work. report what has been completed so that the
+    // counter can detect termination.
+    if (nDone && (procId!=counterProcId))
+      {
+      unsigned long long *n=new unsigned long long(nDone);
+      MPI_Request req;
+      MPI_Isend(
+          n,
+          1,
+          MPI_UNSIGNED_LONG_LONG,
+          counterProcId,
+          DONE_REQ,
+          MPI_COMM_WORLD,
+          &req);
+      reqs.push_back(req);
+      sentCounts.push_back(n);
+      nDone=0;
+      }
+
+    if (nProcs<2)
+      {
+      continue;
+      }
+
+    // try to steal from a randomly chosen process.
+    if (victim<0)
+      {
+      victim=(int)(rng->GetValue()*(nProcs-1));
+      rng->Next();
+      victim=std::min(victim,nProcs-2);
+      if (victim>=procId)
+        {
+        ++victim;
+        }
+      MPI_Request req;
+      MPI_Isend(&procId,0,MPI_INT,victim,STEAL_REQ,MPI_COMM_WORLD,&req);
+      reqs.push_back(req);
+      nStealReqSent[victim]+=1;
+      this->NumberOfStealAttempts+=1;
+      }
+    else
+      {
+      int pendingRep=0;
+      MPI_Status stat;
+      MPI_Iprobe(victim,STEAL_REP,MPI_COMM_WORLD,&pendingRep,&stat);
+      if (pendingRep)
+        {
+        MPI_Recv(
+            local.data(),
+            (int)local.dataSize(),
+            MPI_UNSIGNED_LONG_LONG,
+            victim,
+            STEAL_REP,
+            MPI_COMM_WORLD,
+            &stat);
+        if (!local.empty())
+          {
+          this->NumberOfSteals+=1;
+          #if vtkSQFieldTracerDEBUG>0
+          pCerr() << procId << " stole " << local << " from " << victim << std::endl;
+          #endif
+          }
+        victim=-1;
+        }
+      }
+    }
+
+  // Drain the steal requests and replies still in flight. All of the
+  // seeds have been integrated so the replies are empty.
+  std::vector<int> nStealReq(nProcs,0);
+  MPI_Allreduce(
+        &nStealReqSent[0],
+        &nStealReq[0],
+        nProcs,
+        MPI_INT,
+        MPI_SUM,
+        MPI_COMM_WORLD);
+
+  for (; nStealReqRecvd<nStealReq[procId]; ++nStealReqRecvd)
+    {
+    int buf;
+    MPI_Status stat;
+    MPI_Recv(&buf,0,MPI_INT,MPI_ANY_SOURCE,STEAL_REQ,MPI_COMM_WORLD,&stat);
+    IdBlock *loot=new IdBlock;
+    MPI_Request req;
+    MPI_Isend(
+        loot->data(),
+        (int)loot->dataSize(),
+        MPI_UNSIGNED_LONG_LONG,
+        stat.MPI_SOURCE,
+        STEAL_REP,
+        MPI_COMM_WORLD,
+        &req);
+    reqs.push_back(req);
+    sentBlocks.push_back(loot);
+    }
+
+  if (victim>=0)
+    {
+    IdBlock empty;
+    MPI_Status stat;
+    MPI_Recv(
+        empty.data(),
+        (int)empty.dataSize(),
+        MPI_UNSIGNED_LONG_LONG,
+        victim,
+        STEAL_REP,
+        MPI_COMM_WORLD,
+        &stat);
+    }
+
+  if (reqs.size())
+    {
+    MPI_Waitall((int)reqs.size(),&reqs[0],MPI_STATUSES_IGNORE);
+    }
+
+  size_t n=sentBlocks.size();
+  for (size_t i=0; i<n; ++i)
+    {
+    delete sentBlocks[i];
+    }
+  n=sentCounts.size();
+  for (size_t i=0; i<n; ++i)
+    {
+    delete sentCounts[i];
+    }
+
+  rng->Delete();
+  #endif
+
+  #if defined vtkSQFieldTracerTIME
+  log->EndEvent("vtkSQFieldTracer::IntegrateWorkStealing");
+  #endif
+
+  return 1;
+}
+
 //-----------------------------------------------------------------------------
 int vtkSQFieldTracer::IntegrateBlock(
       IdBlock *sourceIds,
@@ -1147,25 +1579,49 @@ int vtkSQFieldTracer::IntegrateBlock(
 
   TerminationCondition *tcon=traceData->GetTerminationCondition();
 
-  for (vtkIdType i=0; i<nLines; ++i) //, prog+=progInc)
+  double startTime=vtkTimerLog::GetUniversalTime();
+
+  if (this->Threads.size()>1)
     {
-    // progress report for static load balance. the report
-    // for dunamic load balance is done once for each block.
-    if (!this->UseDynamicScheduler && !(i%10))
+    // the lines are handed out one at a time to the threads.
+    FieldTracerWork work;
+    work.Tracer=this;
+    work.TraceData=traceData;
+    work.Reader=oocr;
+    work.FieldName=fieldName;
+    work.NumberOfLines=nLines;
+    work.NextLine=0;
+
+    ThreadedExecute(
+        vtkSQFieldTracer::IntegrateThread,
+        &work,
+        (int)this->Threads.size());
+    }
+  else
+    {
+    for (vtkIdType i=0; i<nLines; ++i) //, prog+=progInc)
       {
-      double prog=(double)i/(double)nLines;
-      this->UpdateProgress(prog);
-      }
+      // progress report for static load balance. the report
+      // for dunamic load balance is done once for each block.
+      if (!this->UseDynamicScheduler && !(i%10))
+        {
+        double prog=(double)i/(double)nLines;
+        this->UpdateProgress(prog);
+        }
 
-    // trace a stream line
-    FieldLine *line=traceData->GetFieldLine(i);
-    this->IntegrateOne(oocr,oocrCache,fieldName,line,tcon);
+      // trace a stream line
+      FieldLine *line=traceData->GetFieldLine(i);
+      this->IntegrateOne(oocr,oocrCache,fieldName,line,tcon,this->Integrator);
 
-    #if vtkSQFieldTracerDEBUG>=0
-    cstd::err << ".";
-    #endif
+      #if vtkSQFieldTracerDEBUG>=0
+      cstd::err << ".";
+      #endif
+      }
     }
 
+  this->IntegrationTime+=vtkTimerLog::GetUniversalTime()-startTime;
+  this->NumberOfSeedsIntegrated+=sourceIds->size();
+
   // sync results to output. free resources in preparation
   // for the next pass.
   #if defined vtkSQFieldTracerTIME
@@ -1187,7 +1643,9 @@ void vtkSQFieldTracer::IntegrateOne(
       vtkDataSet *&oocRCache,
       const char *fieldName,
       FieldLine *line,
-      TerminationCondition *tcon)
+      TerminationCondition *tcon,
+      vtkInitialValueProblemSolver *integrator,
+      vtkMutexLock *readLock)
 {
   #if defined vtkSQFieldTracerTIME
   vtkSQLog *log=vtkSQLog::GetGlobalInstance();
@@ -1237,8 +1695,8 @@ void vtkSQFieldTracer::IntegrateOne(
     double p2[3]={0.0};                     // integrated point, non-periodic coordinate space.
     double s0[3]={0.0};                     // segment start point
     int bcSurf=0;                           // set when a periodic boundary condition has been applied.
-    static                                  // interpolator
-    vtkInterpolatedVelocityField *interp=0;
+    vtkInterpolatedVelocityField *interp    // interpolator
+      = static_cast<vtkInterpolatedVelocityField*>(integrator->GetFunctionSet());
     #if vtkSQFieldTracerDEBUG>1
     double minStepTaken=VTK_DOUBLE_MAX;
     double maxStepTaken=VTK_DOUBLE_MIN;
@@ -1265,7 +1723,30 @@ void vtkSQFieldTracer::IntegrateOne(
         log->EndEvent("vtkSQFieldTracer::Integrate");
         log->StartEvent("vtkSQFieldTracer::LoadBlock");
         #endif
-        oocRCache=oocR->ReadNeighborhood(p0,tcon->GetWorkingDomain());
+        if (readLock)
+          {
+          // The reader and its cache are shared by all threads. Keep
+          // a private shallow copy of the neighborhood so that it
+          // survives eviction from the reader's cache. The interpolator
+          // referencing the previous copy is replaced below.
+          readLock->Lock();
+          vtkDataSet *nhood=oocR->ReadNeighborhood(p0,tcon->GetWorkingDomain());
+          if (oocRCache)
+            {
+            oocRCache->Delete();
+            oocRCache=0;
+            }
+          if (nhood)
+            {
+            oocRCache=nhood->NewInstance();
+            oocRCache->ShallowCopy(nhood);
+            }
+          readLock->Unlock();
+          }
+        else
+          {
+          oocRCache=oocR->ReadNeighborhood(p0,tcon->GetWorkingDomain());
+          }
         if (!oocRCache)
           {
           vtkErrorMacro("Read neighborhood failed.");
@@ -1275,7 +1756,7 @@ void vtkSQFieldTracer::IntegrateOne(
         interp=vtkInterpolatedVelocityField::New();
         interp->AddDataSet(oocRCache);
         interp->SelectVectors(vtkDataObject::FIELD_ASSOCIATION_POINTS,fieldName);
-        this->Integrator->SetFunctionSet(interp);
+        integrator->SetFunctionSet(interp);
         interp->Delete();
         #if defined vtkSQFieldTracerTIME
         log->EndEvent("vtkSQFieldTracer::LoadBlock");
@@ -1339,7 +1820,7 @@ void vtkSQFieldTracer::IntegrateOne(
       interp->SetNormalizeVector(true);
       double error=0.0;
       double stepTaken=0.0;
-      int iErr=this->Integrator->ComputeNextStep(
+      int iErr=integrator->ComputeNextStep(
           p0,p1,0,
           stepSize,
           stepTaken,
@@ -1613,6 +2094,159 @@ void vtkSQFieldTracer::IntegrateOne(
   return;
 }
 
+//-----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkSQFieldTracer::IntegrateThread(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info
+    = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+
+  FieldTracerWork *work=static_cast<FieldTracerWork*>(info->UserData);
+  vtkSQFieldTracer *tracer=work->Tracer;
+  FieldTracerThread *thread=tracer->Threads[info->ThreadID];
+
+  while (1)
+    {
+    work->LineLock.Lock();
+    vtkIdType i=work->NextLine;
+    work->NextLine+=1;
+    work->LineLock.Unlock();
+
+    if (i>=work->NumberOfLines)
+      {
+      break;
+      }
+
+    FieldLine *line=work->TraceData->GetFieldLine(i);
+    tracer->IntegrateOne(
+          work->Reader,
+          thread->Cache,
+          work->FieldName,
+          line,
+          &thread->Tcon,
+          thread->Integrator,
+          tracer->ReadLock);
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSQFieldTracer::InitializeThreads(
+      const double pDomain[6],
+      const int periodicBC[3],
+      vtkInformationVector *surfaces)
+{
+  this->ClearThreads();
+
+  int nThreads=this->NumberOfThreads;
+
+  #ifndef SQTK_WITHOUT_MPI
+  // The reader makes MPI calls from the integration threads.
+  if (nThreads>1)
+    {
+    int threadLevel=MPI_THREAD_SINGLE;
+    MPI_Query_thread(&threadLevel);
+    if (threadLevel<MPI_THREAD_SERIALIZED)
+      {
+      vtkWarningMacro(
+        << "MPI was not initialized with MPI_THREAD_SERIALIZED. "
+        << "Integrating with a single thread.");
+      nThreads=1;
+      }
+    }
+  #endif
+
+  if (nThreads<2)
+    {
+    return;
+    }
+
+  int nSurf=surfaces->GetNumberOfInformationObjects();
+  for (int j=0; j<nThreads; ++j)
+    {
+    FieldTracerThread *thread=new FieldTracerThread;
+    thread->Integrator=this->Integrator->NewInstance();
+    thread->Tcon.SetProblemDomain(pDomain,periodicBC);
+    for (int i=0; i<nSurf; ++i)
+      {
+      vtkInformation *info=surfaces->GetInformationObject(i);
+      vtkPolyData *pd=
+      dynamic_cast<vtkPolyData*>(info->Get(vtkDataObject::DATA_OBJECT()));
+      if (pd==0)
+        {
+        continue;
+        }
+      const char *surfName=0;
+      if (info->Has(vtkSQMetaDataKeys::DESCRIPTIVE_NAME()))
+        {
+        surfName=info->Get(vtkSQMetaDataKeys::DESCRIPTIVE_NAME());
+        }
+      thread->Tcon.PushTerminationSurface(pd,surfName);
+      }
+    this->Threads.push_back(thread);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkSQFieldTracer::ClearThreads()
+{
+  size_t nThreads=this->Threads.size();
+  for (size_t i=0; i<nThreads; ++i)
+    {
+    delete this->Threads[i];
+    }
+  this->Threads.clear();
+}
+
+//-----------------------------------------------------------------------------
+void vtkSQFieldTracer::ReportLoadBalance()
+{
+  #ifndef SQTK_WITHOUT_MPI
+  const int nStats=5;
+  double localStats[nStats]={
+        (double)this->NumberOfSeedsIntegrated,
+        this->IntegrationTime,
+        this->IdleTime,
+        (double)this->NumberOfStealAttempts,
+        (double)this->NumberOfSteals};
+  double minStats[nStats]={0.0};
+  double maxStats[nStats]={0.0};
+  double sumStats[nStats]={0.0};
+  MPI_Reduce(localStats,minStats,nStats,MPI_DOUBLE,MPI_MIN,0,MPI_COMM_WORLD);
+  MPI_Reduce(localStats,maxStats,nStats,MPI_DOUBLE,MPI_MAX,0,MPI_COMM_WORLD);
+  MPI_Reduce(localStats,sumStats,nStats,MPI_DOUBLE,MPI_SUM,0,MPI_COMM_WORLD);
+
+  vtkSQLog *log=vtkSQLog::GetGlobalInstance();
+  log->GetBody()
+    << this->WorldRank
+    << " vtkSQFieldTracer::LoadBalance"
+    << " nSeeds=" << this->NumberOfSeedsIntegrated
+    << " integrationTime=" << this->IntegrationTime
+    << " idleTime=" << this->IdleTime
+    << " nStealAttempts=" << this->NumberOfStealAttempts
+    << " nSteals=" << this->NumberOfSteals
+    << " nSeedsStolen=" << this->NumberOfSeedsStolen
+    << "\n";
+
+  if (this->WorldRank==0)
+    {
+    // imbalance is the ratio of the slowest process to the average.
+    double avgTime=sumStats[1]/this->WorldSize;
+    double imbalance=(avgTime>0.0?maxStats[1]/avgTime:1.0);
+    log->GetBody()
+      << this->WorldRank
+      << " vtkSQFieldTracer::GlobalLoadBalance"
+      << " nSeeds=" << minStats[0] << "," << maxStats[0] << "," << sumStats[0]
+      << " integrationTime=" << minStats[1] << "," << maxStats[1] << "," << sumStats[1]
+      << " idleTime=" << minStats[2] << "," << maxStats[2] << "," << sumStats[2]
+      << " nStealAttempts=" << sumStats[3]
+      << " nSteals=" << sumStats[4]
+      << " imbalance=" << imbalance
+      << "\n";
+    }
+  #endif
+}
+
 //-----------------------------------------------------------------------------
 unsigned long vtkSQFieldTracer::GetGlobalCellId(vtkDataSet *data)
 {
@@ -19,8 +19,14 @@ Copyright 2012 SciberQuest Inc.
 
 #include "vtkSciberQuestModule.h" // for export macro
 #include "vtkDataSetAlgorithm.h"
+#include "vtkMultiThreader.h" // for VTK_THREAD_RETURN_TYPE
+
+//BTX
+#include <vector> // for vector
+//ETX
 
 class vtkUnstructuredGrid;
+class vtkMutexLock;
 class vtkSQOOCReader;
 class vtkMultiProcessController;
 class vtkInitialValueProblemSolver;
@@ -31,6 +37,7 @@ class IdBlock;
 class FieldLine;
 class FieldTraceData;
 class TerminationCondition;
+class FieldTracerThread;
 //ETX
 
 
@@ -186,6 +193,25 @@ public:
   vtkSetMacro(UseDynamicScheduler,int);
   vtkGetMacro(UseDynamicScheduler,int);
 
+  // Description:
+  // When set along with the dynamic scheduler, work is distributed by
+  // work stealing rather than by a master process. Each process starts
+  // with an equal share of the seeds, processes that run out of work
+  // steal half of the remaining seeds of a randomly chosen process.
+  // WorkerBlockSize is the number of seeds integrated between checks
+  // for steal requests. MasterBlockSize is not used.
+  vtkSetMacro(UseWorkStealing,int);
+  vtkGetMacro(UseWorkStealing,int);
+
+  // Description:
+  // Set the number of threads used to integrate the field lines of
+  // each block of seeds. Out-of-core reads are serialized. Using more
+  // than one thread requires that MPI was initialized with at least
+  // MPI_THREAD_SERIALIZED, otherwise a single thread is used. Default
+  // is 1.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
   // Description:
   // Set the log level.
   // 0 -- no logging
@@ -232,6 +258,19 @@ private:
       vtkDataSet *&oocrCache,
       FieldTraceData *topoMap);
 
+  // Description:
+  // Distribute the work load by work stealing. All seed cells must be
+  // present on all processes. Each process starts with a contiguous
+  // share of the cell ids, and idle processes steal from random victims.
+  int IntegrateWorkStealing(
+      int procId,
+      int nProcs,
+      vtkIdType nCells,
+      const char *fieldName,
+      vtkSQOOCReader *oocr,
+      vtkDataSet *&oocrCache,
+      FieldTraceData *topoMap);
+
   // Description:
   // Integrate field lines seeded from a block of consecutive cell ids.
   int IntegrateBlock(
@@ -247,14 +286,35 @@ private:
   // reader. As segments are generated they are tested using the stermination
   // condition and terminated imediately. The last neighborhood read is stored
   // in the nhood parameter. It is up to the caller to delete this.
+  // If readLock is given the reads are serialized through it and the
+  // neighborhood is a shallow copy owned by the caller.
   void IntegrateOne(
         vtkSQOOCReader *oocR,
         vtkDataSet *&oocRCache,
         const char *fieldName,
         FieldLine *line,
-        TerminationCondition *tcon);
+        TerminationCondition *tcon,
+        vtkInitialValueProblemSolver *integrator,
+        vtkMutexLock *readLock=0);
+
+  // Description:
+  // Entry point for the threads integrating the lines of a block.
+  static VTK_THREAD_RETURN_TYPE IntegrateThread(void *arg);
+
+  // Description:
+  // Create the per-thread integrators and termination conditions.
+  void InitializeThreads(
+        const double pDomain[6],
+        const int periodicBC[3],
+        vtkInformationVector *surfaces);
+  void ClearThreads();
   //ETX
 
+  // Description:
+  // Gather the load balance statistics and log them on rank 0.
+  // Requires a global communication.
+  void ReportLoadBalance();
+
   // Description:
   // Determine the start id of the cells in data relative
   // to the cells on all other processes in COMM_WORLD.
@@ -284,9 +344,25 @@ private:
 
   // Parameter controlling load balance
   int UseDynamicScheduler;
+  int UseWorkStealing;
   int WorkerBlockSize;
   int MasterBlockSize;
 
+  // Intra-process threading
+  int NumberOfThreads;
+  vtkMutexLock *ReadLock;
+  //BTX
+  std::vector<FieldTracerThread*> Threads;
+  //ETX
+
+  // Load balance statistics
+  double IntegrationTime;
+  double IdleTime;
+  vtkIdType NumberOfSeedsIntegrated;
+  int NumberOfStealAttempts;
+  int NumberOfSteals;
+  vtkIdType NumberOfSeedsStolen;
+
   // Parameters controlling integration
   int ForwardOnly;
   int StepUnit;
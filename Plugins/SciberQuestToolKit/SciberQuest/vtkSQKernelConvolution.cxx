@@ -87,6 +87,7 @@ vtkSQKernelConvolution::vtkSQKernelConvolution()
   KernelWidth(3),
   KernelType(KERNEL_TYPE_GAUSSIAN),
   Kernel(0),
+  Kernel1D(0),
   KernelModified(1),
   Mode(CartesianExtent::DIM_MODE_3D),
   NumberOfCUDADevices(0),
@@ -238,6 +239,9 @@ vtkSQKernelConvolution::~vtkSQKernelConvolution()
     this->Kernel=0;
     }
 
+  delete [] this->Kernel1D;
+  this->Kernel1D=0;
+
   delete this->CPUDriver;
   delete this->CUDADriver;
 }
@@ -299,6 +303,13 @@ int vtkSQKernelConvolution::Initialize(vtkPVXMLElement *root)
     this->SetCPUDriverOptimization(CPUDriverOptimization);
     }
 
+  int nThreads=-1;
+  GetOptionalAttribute<int,1>(elem,"n_threads",&nThreads);
+  if (nThreads>0)
+    {
+    this->SetNumberOfThreads(nThreads);
+    }
+
   int numberOfMPIRanksToUseCUDA=0;
   GetOptionalAttribute<int,1>(elem,"number_of_mpi_ranks_to_use_cuda",&numberOfMPIRanksToUseCUDA);
 
@@ -311,6 +322,7 @@ int vtkSQKernelConvolution::Initialize(vtkPVXMLElement *root)
       << "#   stencilWidth=" << stencilWidth << "\n"
       << "#   kernelType=" << kernelType << "\n"
       << "#   CPUDriverOptimization=" << CPUDriverOptimization << "\n"
+      << "#   nThreads=" << this->GetNumberOfThreads() << "\n"
       << "#   numberOfMPIRanksToUseCUDA=" << numberOfMPIRanksToUseCUDA << "\n"
       << "#   input_arrays=";
     std::set<std::string>::iterator it=this->InputArrays.begin();
@@ -451,6 +463,28 @@ int vtkSQKernelConvolution::GetCPUDriverOptimization()
   return this->CPUDriver->GetOptimization();
 }
 
+//-----------------------------------------------------------------------------
+void vtkSQKernelConvolution::SetNumberOfThreads(int nThreads)
+{
+  #ifdef SQTK_DEBUG
+  pCerr()
+    << "=====vtkSQKernelConvolution::SetNumberOfThreads"
+    << " " << nThreads << std::endl;
+  #endif
+  if (nThreads==this->CPUDriver->GetNumberOfThreads())
+    {
+    return;
+    }
+  this->CPUDriver->SetNumberOfThreads(nThreads);
+  this->Modified();
+}
+
+//-----------------------------------------------------------------------------
+int vtkSQKernelConvolution::GetNumberOfThreads()
+{
+  return this->CPUDriver->GetNumberOfThreads();
+}
+
 //-----------------------------------------------------------------------------
 void vtkSQKernelConvolution::SetAllMPIRanksToUseCUDA(int allUse)
 {
@@ -703,6 +737,9 @@ int vtkSQKernelConvolution::UpdateKernel()
     this->Kernel=0;
     }
 
+  delete [] this->Kernel1D;
+  this->Kernel1D=0;
+
   int nk2 = this->KernelWidth/2;
   CartesianExtent ext(-nk2, nk2, -nk2, nk2, -nk2, nk2);
   switch(this->Mode)
@@ -756,6 +793,22 @@ int vtkSQKernelConvolution::UpdateKernel()
           }
         }
       }
+
+    // the Gaussian is separable, the kernel is the outer product
+    // of the 1D kernel with itself.
+    this->Kernel1D=new float[this->KernelWidth];
+    float kernel1DNorm=0.0f;
+    for (int i=0; i<this->KernelWidth; ++i)
+      {
+      float x[3]={X[i],0.0f,0.0f};
+      this->Kernel1D[i]=Gaussian(x,a,B,c);
+      kernel1DNorm+=this->Kernel1D[i];
+      }
+    for (int i=0; i<this->KernelWidth; ++i)
+      {
+      this->Kernel1D[i]/=kernel1DNorm;
+      }
+
     delete [] X;
     }
   else
@@ -796,6 +849,12 @@ int vtkSQKernelConvolution::UpdateKernel()
       {
       this->Kernel[i]=1.0f;
       }
+
+    this->Kernel1D=new float[this->KernelWidth];
+    for (int i=0; i<this->KernelWidth; ++i)
+      {
+      this->Kernel1D[i]=1.0f/((float)this->KernelWidth);
+      }
     }
   else
     {
@@ -1170,7 +1229,8 @@ int vtkSQKernelConvolution::RequestData(
             this->Mode,
             V,
             W,
-            this->Kernel);
+            this->Kernel,
+            this->Kernel1D);
         }
 
       if (this->LogLevel || globalLogLevel)
@@ -136,6 +136,12 @@ public:
   void SetCPUDriverOptimization(int opt);
   int GetCPUDriverOptimization();
 
+  // Description:
+  // Set the number of threads used by the CPU driver on each
+  // process.
+  void SetNumberOfThreads(int nThreads);
+  int GetNumberOfThreads();
+
   // Description:
   // Set the log level.
   // 0 -- no logging
@@ -173,6 +179,7 @@ private:
   int KernelType;
   CartesianExtent KernelExt;
   float *Kernel;
+  float *Kernel1D;
   int KernelModified;
   //
   int Mode;
@@ -23,9 +23,11 @@ Copyright 2012 SciberQuest Inc.
 #include "XMLUtils.h"
 #include "postream.h"
 #include "SQMacros.h"
+#include "ThreadedExecute.h"
 
 #include "vtkObjectFactory.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkMultiThreader.h"
 
 #include "vtkImageData.h"
 #include "vtkRectilinearGrid.h"
@@ -45,6 +47,99 @@ Copyright 2012 SciberQuest Inc.
 #include <utility>
 #include <algorithm>
 
+namespace
+{
+/// MedianFilterWork - the arguments of a median filter shared by the threads
+template<typename T>
+struct MedianFilterWork
+{
+  int *Input;
+  int *Output;
+  int *Kernel;
+  int NumberOfComponents;
+  int Component;
+  T *V;
+  T *W;
+  size_t *Order;
+  size_t *Rank;
+  size_t NumberOfInputTuples;
+  size_t NumberOfRows;
+};
+
+//-----------------------------------------------------------------------------
+template<typename T>
+VTK_THREAD_RETURN_TYPE MedianFilterThread(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info
+    = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+
+  MedianFilterWork<T> *work=static_cast<MedianFilterWork<T>*>(info->UserData);
+
+  // threads get a contiguous range of output rows.
+  size_t nRows=work->NumberOfRows;
+  size_t rowBeg=(nRows*info->ThreadID)/info->NumberOfThreads;
+  size_t rowEnd=(nRows*(info->ThreadID+1))/info->NumberOfThreads;
+  if (rowBeg<rowEnd)
+    {
+    RankHistogram hist(work->NumberOfInputTuples);
+    ::SlidingMedianFilter<T>(
+        work->Input,
+        work->Output,
+        work->Kernel,
+        work->NumberOfComponents,
+        work->Component,
+        rowBeg,
+        rowEnd,
+        work->V,
+        work->Order,
+        work->Rank,
+        hist,
+        work->W);
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//-----------------------------------------------------------------------------
+template<typename T>
+void MedianFilter(
+      int nThreads,
+      int *input,
+      int *output,
+      int *kernel,
+      int nComp,
+      T *V,
+      T *W)
+{
+  size_t vnijk=CartesianExtent(input).Size();
+  std::vector<size_t> order(vnijk);
+  std::vector<size_t> rank(vnijk);
+
+  MedianFilterWork<T> work;
+  work.Input=input;
+  work.Output=output;
+  work.Kernel=kernel;
+  work.NumberOfComponents=nComp;
+  work.V=V;
+  work.W=W;
+  work.Order=&order[0];
+  work.Rank=&rank[0];
+  work.NumberOfInputTuples=vnijk;
+  work.NumberOfRows=(output[3]-output[2]+1)*(output[5]-output[4]+1);
+
+  for (int q=0; q<nComp; ++q)
+    {
+    // the stencil is filtered in rank space, so that the median
+    // can be tracked incrementally as the stencil slides.
+    ::RankOrder<T>(vnijk,nComp,q,V,&order[0],&rank[0]);
+
+    work.Component=q;
+
+    ThreadedExecute(MedianFilterThread<T>,&work,nThreads);
+    }
+}
+}
+
 vtkStandardNewMacro(vtkSQMedianFilter);
 
 //-----------------------------------------------------------------------------
@@ -59,6 +154,7 @@ vtkSQMedianFilter::vtkSQMedianFilter()
   //Kernel(0),
   KernelModified(1),
   Mode(CartesianExtent::DIM_MODE_3D),
+  NumberOfThreads(1),
   //NumberOfCUDADevices(0),
   //NumberOfActiveCUDADevices(0),
   //CUDADeviceId(-1),
@@ -243,6 +339,13 @@ int vtkSQMedianFilter::Initialize(vtkPVXMLElement *root)
     this->SetKernelType(kernelType);
     }
 
+  int nThreads=-1;
+  GetOptionalAttribute<int,1>(elem,"n_threads",&nThreads);
+  if (nThreads>0)
+    {
+    this->SetNumberOfThreads(nThreads);
+    }
+
   /*
   int CPUDriverOptimization=-1;
   GetOptionalAttribute<int,1>(elem,"CPUDriverOptimization",&CPUDriverOptimization);
@@ -263,7 +366,8 @@ int vtkSQMedianFilter::Initialize(vtkPVXMLElement *root)
     log->GetHeader()
       << "# ::vtkSQMedianFilter" << "\n"
       << "#   stencilWidth=" << stencilWidth << "\n"
-      << "#   kernelType=" << kernelType << "\n";
+      << "#   kernelType=" << kernelType << "\n"
+      << "#   nThreads=" << this->GetNumberOfThreads() << "\n";
       //<< "#   CPUDriverOptimization=" << CPUDriverOptimization << "\n"
       //<< "#   numberOfMPIRanksToUseCUDA=" << numberOfMPIRanksToUseCUDA << "\n";
     }
@@ -904,121 +1008,23 @@ int vtkSQMedianFilter::RequestData(
     W->SetNumberOfTuples(outputTups);
     W->SetName(V->GetName());
 
-    int nV[3];
-    extV.Size(nV);
-    size_t vnijk=extV.Size();
-
-    int nW[3];
-    extW.Size(nW);
-    size_t wnijk=extW.Size();
-    size_t nComp=W->GetNumberOfComponents();
-
-    int nK[3];
-    this->KernelExt.Size(nK);
-    size_t knijk=this->KernelExt.Size();
-
-    int fastDim=0;
-    int slowDim=1;
-    switch (this->Mode)
-      {
-      case CartesianExtent::DIM_MODE_2D_XY:
-        fastDim=0;
-        slowDim=1;
-        break;
-      case CartesianExtent::DIM_MODE_2D_XZ:
-        fastDim=0;
-        slowDim=2;
-        break;
-      case CartesianExtent::DIM_MODE_2D_YZ:
-        fastDim=1;
-        slowDim=2;
-        break;
-      case CartesianExtent::DIM_MODE_3D:
-        fastDim=0;
-        slowDim=1;
-        break;
-      default:
-        sqErrorMacro(std::cerr,"Bad dim mode.");
-        return -1;
-      }
-
     #ifdef SQTK_DEBUG
-    pCerr() << "wnijk=" << wnijk << std::endl;
-    pCerr() << "fastDim=" << fastDim << std::endl;
-    pCerr() << "slowDim=" << slowDim << std::endl;
     pCerr() << "extV=" << extV << std::endl;
-    pCerr() << "nV=(" << nV[fastDim] <<  ", " << nV[slowDim] << ")" << std::endl;
     pCerr() << "extW=" << extW << std::endl;
-    pCerr() << "nW=(" << nW[fastDim] <<  ", " << nW[slowDim] << ")" << std::endl;
+    pCerr() << "KernelExt=" << this->KernelExt << std::endl;
     #endif
 
     switch (V->GetDataType())
       {
-      // TODO -- replace with vtkTemplateMacro
-      case VTK_FLOAT:
-        {
-        std::vector<float*> sV(nComp,0);
-        std::vector<float*> sW(nComp,0);
-        for (unsigned long q=0; q<nComp; ++q)
-          {
-          posix_memalign((void**)&sV[q],16,vnijk*sizeof(float));
-          posix_memalign((void**)&sW[q],16,wnijk*sizeof(float));
-          }
-
-        // convert vtk vectors/tensors into scalar component arrays
-        float *hV=(float*)V->GetVoidPointer(0);
-        Split<float>(vnijk,hV,sV);
-
-        // apply convolution
-        for (unsigned long q=0; q<nComp; ++q)
-          {
-          if ((this->Mode==CartesianExtent::DIM_MODE_2D_XY)
-            ||(this->Mode==CartesianExtent::DIM_MODE_2D_XZ)
-            ||(this->Mode==CartesianExtent::DIM_MODE_2D_YZ))
-            {
-            ::ScalarMedianFilter2D(
-                  nV[fastDim],
-                  nW[fastDim],
-                  wnijk,
-                  nK[fastDim],
-                  knijk,
-                  nGhost,
-                  sV[q],
-                  sW[q]);
-            }
-          else
-            {
-            ::ScalarMedianFilter3D(
-                  nV[fastDim],
-                  nV[fastDim]*nV[slowDim],
-                  nW[fastDim],
-                  nW[fastDim]*nW[slowDim],
-                  wnijk,
-                  nK[fastDim],
-                  nK[fastDim]*nK[slowDim],
-                  knijk,
-                  nGhost,
-                  sV[q],
-                  sW[q]);
-            }
-          }
-
-        // put results in vtk order
-        float *hW=(float*)W->GetVoidPointer(0);
-        Interleave(wnijk,sW,hW);
-
-        // clean up
-        for (unsigned long q=0; q<nComp; ++q)
-          {
-          free(sW[q]);
-          free(sV[q]);
-          }
-        }
-        break;
-      default:
-        // TODO
-        sqErrorMacro(std::cerr,"Not currently using vtkTemplateMacro");
-        return -1;
+      vtkFloatTemplateMacro(
+        MedianFilter<VTK_TT>(
+            this->NumberOfThreads,
+            extV.GetData(),
+            extW.GetData(),
+            this->KernelExt.GetData(),
+            nComps,
+            (VTK_TT*)V->GetVoidPointer(0),
+            (VTK_TT*)W->GetVoidPointer(0)));
       }
 
     outImData->GetPointData()->AddArray(W);
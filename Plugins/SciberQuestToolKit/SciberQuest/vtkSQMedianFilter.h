@@ -12,6 +12,7 @@ Copyright 2012 SciberQuest Inc.
 
 #include "vtkSciberQuestModule.h" // for export macro
 #include "vtkDataSetAlgorithm.h"
+#include "vtkMultiThreader.h" // for VTK_MAX_THREADS
 #include "CartesianExtent.h" // for Cartesian extent
 
 class vtkPVXMLElement;
@@ -66,6 +67,12 @@ public:
   void SetKernelWidth(int width);
   vtkGetMacro(KernelWidth,int);
 
+  // Description:
+  // Set the number of threads used on each process. The rows of
+  // the output are split among the threads.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
   /*
   // Description:
   // Query properties of the current device and available devices.
@@ -160,6 +167,8 @@ private:
   int KernelModified;
   //
   int Mode;
+  //
+  int NumberOfThreads;
 
   /*
   //
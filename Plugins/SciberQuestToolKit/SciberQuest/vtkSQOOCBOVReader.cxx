@@ -33,6 +33,7 @@ Copyright 2012 SciberQuest Inc.
 #include <sstream>
 #include <iostream>
 #include <iomanip>
+#include <cmath>
 
 #ifndef SQTK_WITHOUT_MPI
 #include "SQMPICHWarningSupression.h"
@@ -104,9 +105,16 @@ vtkSQOOCBOVReader::vtkSQOOCBOVReader()
   CloseClearsCachedBlocks(1),
   CacheHitCount(0),
   CacheMissCount(0),
+  PrefetchBlocks(0),
+  HaveLastPoint(0),
+  PrefetchCount(0),
+  PrefetchHitCount(0),
+  BytesRead(0),
+  BytesUsed(0),
   LogLevel(0)
 {
   this->LRUQueue=new PriorityQueue<unsigned long int>;
+  this->LastPoint[0]=this->LastPoint[1]=this->LastPoint[2]=0.0;
 }
 
 //-----------------------------------------------------------------------------
@@ -135,6 +143,9 @@ void vtkSQOOCBOVReader::InitializeBlockCache()
 
   this->CacheHit.assign(nBlocks,0);
   this->CacheMiss.assign(nBlocks,0);
+  this->BlockBytes.assign(nBlocks,0);
+  this->BlockUsed.assign(nBlocks,0);
+  this->BlockPrefetched.assign(nBlocks,0);
 }
 
 //-----------------------------------------------------------------------------
@@ -145,6 +156,12 @@ void vtkSQOOCBOVReader::ClearBlockCache()
   this->CacheHitCount=0;
   this->CacheMissCount=0;
 
+  this->HaveLastPoint=0;
+  this->PrefetchCount=0;
+  this->PrefetchHitCount=0;
+  this->BytesRead=0;
+  this->BytesUsed=0;
+
   while (!this->LRUQueue->Empty())
     {
     CartesianDataBlock *block
@@ -156,6 +173,9 @@ void vtkSQOOCBOVReader::ClearBlockCache()
   int nBlocks=(int)this->DomainDecomp->GetNumberOfBlocks();
   this->CacheHit.assign(nBlocks,0);
   this->CacheMiss.assign(nBlocks,0);
+  this->BlockBytes.assign(nBlocks,0);
+  this->BlockUsed.assign(nBlocks,0);
+  this->BlockPrefetched.assign(nBlocks,0);
 }
 
 //-----------------------------------------------------------------------------
@@ -267,6 +287,11 @@ void vtkSQOOCBOVReader::Close()
       << " nUniqueBlocks=" << nUsed
       << " HitCount=" << this->CacheHitCount
       << " MissCount=" << this->CacheMissCount
+      << " HitRate=" << this->GetCacheHitRate()
+      << " PrefetchCount=" << this->PrefetchCount
+      << " PrefetchHitCount=" << this->PrefetchHitCount
+      << " BytesRead=" << this->BytesRead
+      << " BytesUsed=" << this->BytesUsed
       << "\n";
     }
 
@@ -322,8 +347,6 @@ vtkDataSet *vtkSQOOCBOVReader::ReadNeighborhood(
     // The data is locally cached. Update the LRU queue with the block's
     // new access time, and return the cached dataset.
     this->LRUQueue->Update(block->GetIndex(),++this->BlockAccessTime);
-
-    return data;
     }
   else
     {
@@ -334,125 +357,273 @@ vtkDataSet *vtkSQOOCBOVReader::ReadNeighborhood(
     this->CacheMissCount+=1;
     this->CacheMiss[block->GetIndex()]+=1;
 
-    // The data is not cached. If the cache is full then remove
-    // the least recently used block and delete it's dataset. Insert
-    // the requested block into the cache, load and return it's
-    // associated dataset.
-    if ((this->BlockCacheSize>0) && this->LRUQueue->Full())
+    data=this->LoadBlock(block);
+    if (!data)
       {
-      // get the oldest cahched block and delete it's associated data.
-      CartesianDataBlock *lruBlock
-        = this->DomainDecomp->GetBlock(this->LRUQueue->Pop());
+      return 0;
+      }
+    }
 
-      lruBlock->SetData(0);
+  this->MarkBlockUsed(block);
 
-      #if vtkSQOOCBOVReaderDEBUG>1
-      std::cerr << "\tRemoved " << Tuple<int>(lruBlock->GetId(),4);
-      #endif
-      }
+  if (this->PrefetchBlocks)
+    {
+    this->PrefetchNeighbor(block,pt);
+    }
 
-    // configure a new dataset and read with ghost cells. Note: working
-    // domain is smaller than the bounds of the dataset that is read.
-    CartesianDataBlockIODescriptor *descr
-      = this->DomainDecomp->GetBlockIODescriptor(block->GetIndex());
+  this->LastPoint[0]=pt[0];
+  this->LastPoint[1]=pt[1];
+  this->LastPoint[2]=pt[2];
+  this->HaveLastPoint=1;
 
-    const CartesianExtent &blockExt=descr->GetMemExtent();
+  return data;
+}
 
-    if (this->Reader->DataSetTypeIsImage())
-      {
-      ImageDecomp *idec=dynamic_cast<ImageDecomp*>(this->DomainDecomp);
-      double *X0=idec->GetOrigin();
-      double *dX=idec->GetSpacing();
+//-----------------------------------------------------------------------------
+vtkDataSet *vtkSQOOCBOVReader::LoadBlock(CartesianDataBlock *block)
+{
+  // If the cache is full then remove the least recently used block
+  // and delete it's dataset. Insert the requested block into the
+  // cache, load and return it's associated dataset.
+  if ((this->BlockCacheSize>0) && this->LRUQueue->Full())
+    {
+    // get the oldest cahched block and delete it's associated data.
+    CartesianDataBlock *lruBlock
+      = this->DomainDecomp->GetBlock(this->LRUQueue->Pop());
 
-      int nPoints[3];
-      blockExt.Size(nPoints);
+    lruBlock->SetData(0);
 
-      double blockX0[3];
-      blockExt.GetLowerBound(X0,dX,blockX0);
+    #if vtkSQOOCBOVReaderDEBUG>1
+    std::cerr << "\tRemoved " << Tuple<int>(lruBlock->GetId(),4);
+    #endif
+    }
 
-      vtkImageData *idata=vtkImageData::New();
-      idata->SetDimensions(nPoints);
-      idata->SetOrigin(blockX0);
-      idata->SetSpacing(dX);
+  // configure a new dataset and read with ghost cells. Note: working
+  // domain is smaller than the bounds of the dataset that is read.
+  CartesianDataBlockIODescriptor *descr
+    = this->DomainDecomp->GetBlockIODescriptor(block->GetIndex());
 
-      data=idata;
-      }
-    else
-    if (this->Reader->DataSetTypeIsRectilinear())
-      {
-      RectilinearDecomp *rdec=dynamic_cast<RectilinearDecomp*>(this->DomainDecomp);
+  const CartesianExtent &blockExt=descr->GetMemExtent();
 
-      int nPoints[3];
-      blockExt.Size(nPoints);
+  vtkDataSet *data=0;
+  if (this->Reader->DataSetTypeIsImage())
+    {
+    ImageDecomp *idec=dynamic_cast<ImageDecomp*>(this->DomainDecomp);
+    double *X0=idec->GetOrigin();
+    double *dX=idec->GetSpacing();
 
-      vtkRectilinearGrid *rdata=vtkRectilinearGrid::New();
-      rdata->SetExtent(const_cast<int*>(blockExt.GetData()));
+    int nPoints[3];
+    blockExt.Size(nPoints);
 
-      vtkFloatArray *fa;
-      fa=vtkFloatArray::New();
-      fa->SetArray(rdec->SubsetCoordinate(0,blockExt),nPoints[0],0);
-      rdata->SetXCoordinates(fa);
-      fa->Delete();
+    double blockX0[3];
+    blockExt.GetLowerBound(X0,dX,blockX0);
 
-      fa=vtkFloatArray::New();
-      fa->SetArray(rdec->SubsetCoordinate(1,blockExt),nPoints[1],0);
-      rdata->SetYCoordinates(fa);
-      fa->Delete();
+    vtkImageData *idata=vtkImageData::New();
+    idata->SetDimensions(nPoints);
+    idata->SetOrigin(blockX0);
+    idata->SetSpacing(dX);
 
-      fa=vtkFloatArray::New();
-      fa->SetArray(rdec->SubsetCoordinate(2,blockExt),nPoints[2],0);
-      rdata->SetZCoordinates(fa);
-      fa->Delete();
+    data=idata;
+    }
+  else
+  if (this->Reader->DataSetTypeIsRectilinear())
+    {
+    RectilinearDecomp *rdec=dynamic_cast<RectilinearDecomp*>(this->DomainDecomp);
 
-      data=rdata;
-      }
-    else
-    if (this->Reader->DataSetTypeIsStructured())
-      {
-      vtkErrorMacro("Path for vtkSturcturedData not implemented.");
-      return 0;
-      }
-    else
-      {
-      vtkErrorMacro("Unsupported dataset type \"" << this->Reader->GetDataSetType() << "\".");
-      return 0;
-      }
+    int nPoints[3];
+    blockExt.Size(nPoints);
+
+    vtkRectilinearGrid *rdata=vtkRectilinearGrid::New();
+    rdata->SetExtent(const_cast<int*>(blockExt.GetData()));
+
+    vtkFloatArray *fa;
+    fa=vtkFloatArray::New();
+    fa->SetArray(rdec->SubsetCoordinate(0,blockExt),nPoints[0],0);
+    rdata->SetXCoordinates(fa);
+    fa->Delete();
+
+    fa=vtkFloatArray::New();
+    fa->SetArray(rdec->SubsetCoordinate(1,blockExt),nPoints[1],0);
+    rdata->SetYCoordinates(fa);
+    fa->Delete();
+
+    fa=vtkFloatArray::New();
+    fa->SetArray(rdec->SubsetCoordinate(2,blockExt),nPoints[2],0);
+    rdata->SetZCoordinates(fa);
+    fa->Delete();
+
+    data=rdata;
+    }
+  else
+  if (this->Reader->DataSetTypeIsStructured())
+    {
+    vtkErrorMacro("Path for vtkSturcturedData not implemented.");
+    return 0;
+    }
+  else
+    {
+    vtkErrorMacro("Unsupported dataset type \"" << this->Reader->GetDataSetType() << "\".");
+    return 0;
+    }
+
+  unsigned long long bytesRead=this->Reader->GetBytesRead();
+
+  int ok=this->Reader->ReadTimeStep(this->Image,descr,data,(vtkAlgorithm*)0);
+  if (!ok)
+    {
+    data->Delete();
+    vtkErrorMacro("Read failed.");
+    return 0;
+    }
+
+  bytesRead=this->Reader->GetBytesRead()-bytesRead;
+  this->BytesRead+=bytesRead;
+
+  int idx=block->GetIndex();
+  this->BlockBytes[idx]=bytesRead;
+  this->BlockUsed[idx]=0;
+  this->BlockPrefetched[idx]=0;
+
+  // cache the dataset
+  if (this->BlockCacheSize>0)
+    {
+    #if vtkSQOOCBOVReaderDEBUG>1
+    std::cerr << "\tInserted " << Tuple<int>(block->GetId(),4) << std::endl;
+    #endif
 
-    int ok=this->Reader->ReadTimeStep(this->Image,descr,data,(vtkAlgorithm*)0);
-    if (!ok)
+    // cache the newly read dataset, and insert this block into
+    // the lru queue.
+    block->SetData(data);
+    data->Delete();
+    this->LRUQueue->Push(idx,++this->BlockAccessTime);
+    }
+
+  #if vtkSQOOCBOVReaderDEBUG>2
+  // data->Print(std::cerr);
+  vtkDataSetWriter *idw=vtkDataSetWriter::New();
+  std::ostringstream oss;
+  oss << "block." << idx << ".vtk";
+  idw->SetFileName(oss.str().c_str());
+  idw->SetInput(data);
+  idw->Write();
+  idw->Delete();
+  #endif
+
+  return data;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSQOOCBOVReader::MarkBlockUsed(CartesianDataBlock *block)
+{
+  int idx=block->GetIndex();
+  if (this->BlockUsed[idx])
+    {
+    return;
+    }
+  this->BlockUsed[idx]=1;
+
+  if (this->BlockPrefetched[idx])
+    {
+    this->PrefetchHitCount+=1;
+    }
+
+  // only the block's interior is used, the ghost cells are
+  // also read as part of its neighbors.
+  size_t nLoaded
+    = this->DomainDecomp->GetBlockIODescriptor(idx)->GetMemExtent().Size();
+  if (nLoaded)
+    {
+    size_t nInterior=block->GetExtent().Size();
+    this->BytesUsed+=this->BlockBytes[idx]*nInterior/nLoaded;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkSQOOCBOVReader::PrefetchNeighbor(
+      CartesianDataBlock *block,
+      const double pt[3])
+{
+  if (!this->HaveLastPoint)
+    {
+    return;
+    }
+
+  // the direction of travel is estimated from the last two requests,
+  // the neighbor across the face in the dominant direction is the
+  // most likely to be requested next.
+  int dir=-1;
+  double maxDelta=0.0;
+  for (int q=0; q<3; ++q)
+    {
+    double delta=fabs(pt[q]-this->LastPoint[q]);
+    if (delta>maxDelta)
       {
-      data->Delete();
-      vtkErrorMacro("Read failed.");
-      return 0;
+      maxDelta=delta;
+      dir=q;
       }
+    }
+  if (dir<0)
+    {
+    return;
+    }
 
-    // cache the dataset
-    if (this->BlockCacheSize>0)
+  int I[3]={block->GetId()[0],block->GetId()[1],block->GetId()[2]};
+  I[dir]+=(pt[dir]>this->LastPoint[dir])?1:-1;
+
+  const int *nBlocks=this->DomainDecomp->GetDecompDimensions();
+  if ((I[dir]<0) || (I[dir]>=nBlocks[dir]))
+    {
+    if (!this->DomainDecomp->GetPeriodicBC()[dir])
       {
-      #if vtkSQOOCBOVReaderDEBUG>1
-      std::cerr << "\tInserted " << Tuple<int>(block->GetId(),4) << std::endl;
-      #endif
-
-      // cache the newly read dataset, and insert this block into
-      // the lru queue.
-      block->SetData(data);
-      data->Delete();
-      this->LRUQueue->Push(block->GetIndex(),++this->BlockAccessTime);
+      return;
       }
+    I[dir]=(I[dir]+nBlocks[dir])%nBlocks[dir];
+    }
 
-    #if vtkSQOOCBOVReaderDEBUG>2
-    // data->Print(std::cerr);
-    vtkDataSetWriter *idw=vtkDataSetWriter::New();
-    std::ostringstream oss;
-    oss << "block." << block->GetIndex() << ".vtk";
-    idw->SetFileName(oss.str().c_str());
-    idw->SetInput(data);
-    idw->Write();
-    idw->Delete();
-    #endif
+  CartesianDataBlock *next=this->DomainDecomp->GetBlock(I);
+  if ((next==block) || next->GetData())
+    {
+    return;
     }
 
-  return data;
+  if (this->Reader->GetUseMemoryMap())
+    {
+    // ask the OS to page the block in, the copy into the cache
+    // is done if and when it is requested.
+    this->Reader->PrefetchTimeStep(
+          this->Image,
+          this->DomainDecomp->GetBlockIODescriptor(next->GetIndex()));
+    this->PrefetchCount+=1;
+    return;
+    }
+
+  // without a memory map the block is read into the cache. Don't
+  // evict the block we are in.
+  if (this->BlockCacheSize<2)
+    {
+    return;
+    }
+
+  #if vtkSQOOCBOVReaderDEBUG>1
+  std::cerr << "Prefetching " << Tuple<int>(next->GetId(),4);
+  #endif
+
+  if (this->LoadBlock(next))
+    {
+    this->BlockPrefetched[next->GetIndex()]=1;
+    this->PrefetchCount+=1;
+    }
+}
+
+//-----------------------------------------------------------------------------
+double vtkSQOOCBOVReader::GetCacheHitRate() const
+{
+  long long nAccess=this->CacheHitCount+this->CacheMissCount;
+  if (nAccess==0)
+    {
+    return 0.0;
+    }
+  return static_cast<double>(this->CacheHitCount)/static_cast<double>(nAccess);
 }
 
 //-----------------------------------------------------------------------------
@@ -482,6 +653,11 @@ void vtkSQOOCBOVReader::DeActivateAllArrays()
 void vtkSQOOCBOVReader::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->vtkObject::PrintSelf(os,indent.GetNextIndent());
+  os << indent << "BlockCacheSize: " << this->BlockCacheSize << std::endl;
+  os << indent << "PrefetchBlocks: " << this->PrefetchBlocks << std::endl;
+  os << indent << "CacheHitRate: " << this->GetCacheHitRate() << std::endl;
+  os << indent << "BytesRead: " << this->BytesRead << std::endl;
+  os << indent << "BytesUsed: " << this->BytesUsed << std::endl;
   os << indent << "Reader: " << std::endl;
   this->Reader->PrintSelf(os);
   os << std::endl;
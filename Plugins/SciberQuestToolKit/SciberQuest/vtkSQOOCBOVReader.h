@@ -88,6 +88,30 @@ public:
   vtkSetMacro(CloseClearsCachedBlocks,int);
   vtkGetMacro(CloseClearsCachedBlocks,int);
 
+  /**
+  If set, when a block is entered the next block along the
+  direction of travel (estimated from the last two requested
+  points) is prefetched. When the reader memory maps its files
+  the prefetch is an asynchronous paging hint to the OS, otherwise
+  the neighbor is read into the cache. The default is unset.
+  */
+  vtkSetMacro(PrefetchBlocks,int);
+  vtkGetMacro(PrefetchBlocks,int);
+
+  /**
+  Cache statistics since the last time the cache was cleared.
+  Bytes read include ghost cells, repeated reads of evicted
+  blocks and prefetched blocks. Bytes used count the interior
+  of each loaded block the first time it's accessed.
+  */
+  long long GetCacheHitCount() const { return this->CacheHitCount; }
+  long long GetCacheMissCount() const { return this->CacheMissCount; }
+  double GetCacheHitRate() const;
+  long long GetPrefetchCount() const { return this->PrefetchCount; }
+  long long GetPrefetchHitCount() const { return this->PrefetchHitCount; }
+  unsigned long long GetBytesRead() const { return this->BytesRead; }
+  unsigned long long GetBytesUsed() const { return this->BytesUsed; }
+
   /// \@}
 
 
@@ -140,6 +164,22 @@ private:
   vtkSQOOCBOVReader(const vtkSQOOCBOVReader&); // Not implemented
   void operator=(const vtkSQOOCBOVReader&); // Not implemented
 
+  /**
+  Read the block's data, evicting the least recently used block
+  if the cache is full. The block is inserted into the cache.
+  */
+  vtkDataSet *LoadBlock(CartesianDataBlock *block);
+
+  /**
+  Prefetch the neighbor of block in the direction of travel.
+  */
+  void PrefetchNeighbor(CartesianDataBlock *block, const double pt[3]);
+
+  /**
+  Account for an access to a loaded block.
+  */
+  void MarkBlockUsed(CartesianDataBlock *block);
+
 private:
   BOVReader *Reader;                            // reader
   BOVTimeStepImage *Image;                      // file handle
@@ -154,6 +194,17 @@ private:
   long long CacheHitCount;                      // track block cache hits
   long long CacheMissCount;                     // track block cache misses
 
+  int PrefetchBlocks;                           // prefetch along the direction of travel
+  double LastPoint[3];                          // last requested point
+  int HaveLastPoint;                            // set when LastPoint is valid
+  std::vector<unsigned long long> BlockBytes;   // bytes read for each cached block
+  std::vector<char> BlockUsed;                  // set when a loaded block has been accessed
+  std::vector<char> BlockPrefetched;            // set when a block was loaded by prefetch
+  long long PrefetchCount;                      // number of prefetched blocks
+  long long PrefetchHitCount;                   // prefetched blocks later accessed
+  unsigned long long BytesRead;                 // bytes read from disk
+  unsigned long long BytesUsed;                 // interior bytes of accessed blocks
+
   int LogLevel;                                 // enable logging
 };
 
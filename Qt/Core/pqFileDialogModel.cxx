@@ -36,8 +36,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <QStyle>
 #include <QDir>
+#include <QHash>
 #include <QApplication>
 #include <QMessageBox>
+#include <QTimer>
 
 #include <pqServer.h>
 #include <vtkClientServerStream.h>
@@ -243,8 +245,12 @@ class pqFileDialogModel::pqImplementation
 public:
   pqImplementation(pqServer* server) :
     Separator(0),
+    ListingOffset(0),
+    GroupRowsValid(false),
     Server(server)
   {
+    this->PageTimer.setSingleShot(true);
+    this->PageTimer.setInterval(0);
 
     // if we are doing remote browsing
     if(server)
@@ -290,16 +296,21 @@ public:
   /// query the file system for information
   vtkPVFileInformation* GetData(bool dirListing,
                                 const QString& path,
-                                bool specialDirs)
+                                bool specialDirs,
+                                int offset = 0,
+                                int pageSize = 0)
     {
-    return this->GetData(dirListing, this->CurrentPath, path, specialDirs);
+    return this->GetData(dirListing, this->CurrentPath, path, specialDirs,
+      offset, pageSize);
     }
 
   /// query the file system for information
   vtkPVFileInformation* GetData(bool dirListing,
                                 const QString& workingDir,
                                 const QString& path,
-                                bool specialDirs)
+                                bool specialDirs,
+                                int offset = 0,
+                                int pageSize = 0)
     {
     if(this->FileInformationHelperProxy)
       {
@@ -313,6 +324,10 @@ public:
         helper->GetProperty("Path"), path.toLatin1().data());
       pqSMAdaptor::setElementProperty(
         helper->GetProperty("SpecialDirectories"), specialDirs);
+      pqSMAdaptor::setElementProperty(
+        helper->GetProperty("DirectoryListingOffset"), offset);
+      pqSMAdaptor::setElementProperty(
+        helper->GetProperty("DirectoryListingPageSize"), pageSize);
       helper->UpdateVTKObjects();
 
       // get data from server
@@ -327,6 +342,8 @@ public:
       helper->SetPath(path.toLatin1().data());
       helper->SetSpecialDirectories(specialDirs);
       helper->SetWorkingDirectory(workingDir.toLatin1().data());
+      helper->SetDirectoryListingOffset(offset);
+      helper->SetDirectoryListingPageSize(pageSize);
       this->FileInformation->CopyFromObject(helper);
       }
     return this->FileInformation;
@@ -337,10 +354,27 @@ public:
     {
     this->CurrentPath = path;
     this->FileList.clear();
+    this->GroupRowsValid = false;
 
     QList<pqFileDialogModelFileInfo> dirs;
     QList<pqFileDialogModelFileInfo> files;
+    this->GetEntries(dir, dirs, files);
+    for(int i = 0; i != dirs.size(); ++i)
+      {
+      this->FileList.push_back(dirs[i]);
+      }
+    for(int i = 0; i != files.size(); ++i)
+      {
+      this->FileList.push_back(files[i]);
+      }
+    }
 
+  /// get the sorted directories and files of queried information (e.g. a
+  /// page of a directory listing)
+  void GetEntries(vtkPVFileInformation* dir,
+    QList<pqFileDialogModelFileInfo>& dirs,
+    QList<pqFileDialogModelFileInfo>& files)
+    {
     vtkSmartPointer<vtkCollectionIterator> iter;
     iter.TakeReference(dir->GetContents()->NewIterator());
 
@@ -387,15 +421,24 @@ public:
 
     qSort(dirs.begin(), dirs.end(), CaseInsensitiveSort);
     qSort(files.begin(), files.end(), CaseInsensitiveSort);
+    }
 
-    for(int i = 0; i != dirs.size(); ++i)
-      {
-      this->FileList.push_back(dirs[i]);
-      }
-    for(int i = 0; i != files.size(); ++i)
+  /// row of the group that contains the files of a child index
+  int GetGroupRow(const pqFileDialogModelFileInfo* group) const
+    {
+    if (!this->GroupRowsValid)
       {
-      this->FileList.push_back(files[i]);
+      this->GroupRows.clear();
+      for(int i = 0; i != this->FileList.size(); ++i)
+        {
+        if (this->FileList[i].isGroup())
+          {
+          this->GroupRows.insert(&this->FileList[i], i);
+          }
+        }
+      this->GroupRowsValid = true;
       }
+    return this->GroupRows.value(group, -1);
     }
 
   QStringList getFilePaths(const QModelIndex& Index)
@@ -459,10 +502,26 @@ public:
   /// Path separator for the connected server's filesystem.
   char Separator;
 
+  /// Number of directory entries requested at a time when listing a
+  /// directory.
+  static const int PageSize = 5000;
+
+  /// Full path of the directory whose listing is being fetched, and offset of
+  /// the next page to request.
+  QString ListingPath;
+  int ListingOffset;
+  /// Fetches the remaining pages of a listing from the event loop.
+  QTimer PageTimer;
+
   /// Current path being displayed (server's filesystem).
   QString CurrentPath;
   /// Caches information about the set of files within the current path.
-  QVector<pqFileDialogModelFileInfo> FileList;  // adjacent memory occupation for QModelIndex
+  /// QList keeps the address of each entry when rows are inserted, child
+  /// indices point to the entry of their group.
+  QList<pqFileDialogModelFileInfo> FileList;
+  /// Rows of the groups in FileList, rebuilt after rows are inserted.
+  mutable QHash<const pqFileDialogModelFileInfo*, int> GroupRows;
+  mutable bool GroupRowsValid;
 
   const pqFileDialogModelFileInfo* infoForIndex(const QModelIndex& idx) const
     {
@@ -500,6 +559,8 @@ pqFileDialogModel::pqFileDialogModel(pqServer* _server, QObject* Parent) :
   base(Parent),
   Implementation(new pqImplementation(_server))
 {
+  QObject::connect(&this->Implementation->PageTimer, SIGNAL(timeout()),
+    this, SLOT(fetchNextPage()));
 }
 
 pqFileDialogModel::~pqFileDialogModel()
@@ -514,12 +575,93 @@ pqServer* pqFileDialogModel::server() const
 
 void pqFileDialogModel::setCurrentPath(const QString& Path)
 {
+  this->populate(this->Implementation->cleanPath(Path));
+}
+
+void pqFileDialogModel::populate(const QString& cPath)
+{
+  // Large directories are listed one page at a time: the first page is shown
+  // right away, the following ones are fetched from the event loop and added
+  // to the view as they arrive.
+  pqImplementation* impl = this->Implementation;
+  impl->PageTimer.stop();
   this->beginResetModel();
-  QString cPath = this->Implementation->cleanPath(Path);
   vtkPVFileInformation* info;
-  info = this->Implementation->GetData(true, cPath, false);
-  this->Implementation->Update(cPath, info);
+  info = impl->GetData(true, cPath, false, 0, pqImplementation::PageSize);
+  impl->ListingPath = info->GetFullPath();
+  impl->ListingOffset = info->GetNextPageOffset();
+  impl->Update(cPath, info);
   this->endResetModel();
+
+  if (impl->ListingOffset < info->GetTotalNumberOfEntries())
+    {
+    impl->PageTimer.start();
+    }
+}
+
+void pqFileDialogModel::fetchNextPage()
+{
+  pqImplementation* impl = this->Implementation;
+  int offset = impl->ListingOffset;
+  vtkPVFileInformation* info = impl->GetData(
+    true, impl->ListingPath, false, offset, pqImplementation::PageSize);
+  impl->ListingOffset = info->GetNextPageOffset();
+  if (impl->ListingOffset <= offset)
+    {
+    return;
+    }
+
+  // Merge the directories and then the files of the page with the listed
+  // ones, keeping each sorted. Rows are inserted rather than the model reset
+  // so that the view keeps its selection and scroll position. The pages come
+  // in about the same order, so each part is usually a single range of rows.
+  QList<pqFileDialogModelFileInfo> parts[2];
+  impl->GetEntries(info, parts[0], parts[1]);
+  QList<pqFileDialogModelFileInfo>& list = impl->FileList;
+  int begin = 0;
+  int end = 0;
+  while (end < list.size() &&
+    vtkPVFileInformation::IsDirectory(list[end].type()))
+    {
+    ++end;
+    }
+  for (int part = 0; part < 2; ++part)
+    {
+    const QList<pqFileDialogModelFileInfo>& entries = parts[part];
+    int cc = 0;
+    while (cc < entries.size())
+      {
+      // entries[cc] goes after the listed entries that do not sort after it,
+      // and so do the next entries that sort before the one at that row.
+      int row = std::upper_bound(list.begin() + begin, list.begin() + end,
+        entries[cc], CaseInsensitiveSort) - list.begin();
+      int last = cc + 1;
+      while (last < entries.size() &&
+        (row == end || CaseInsensitiveSort(entries[last], list[row])))
+        {
+        ++last;
+        }
+
+      this->beginInsertRows(QModelIndex(), row, row + last - cc - 1);
+      for (int i = cc; i < last; ++i)
+        {
+        list.insert(row + i - cc, entries[i]);
+        }
+      impl->GroupRowsValid = false;
+      this->endInsertRows();
+
+      begin = row + last - cc;
+      end += last - cc;
+      cc = last;
+      }
+    begin = end;
+    end = list.size();
+    }
+
+  if (impl->ListingOffset < info->GetTotalNumberOfEntries())
+    {
+    impl->PageTimer.start();
+    }
 }
 
 QString pqFileDialogModel::getCurrentPath()
@@ -611,12 +753,7 @@ bool pqFileDialogModel::mkdir(const QString& dirName)
     ret = (vtkDirectory::MakeDirectory(dirPath.toLatin1().data()) != 0);
     }
 
-  this->beginResetModel();
-  QString cPath = this->Implementation->cleanPath(this->getCurrentPath());
-  vtkPVFileInformation* info;
-  info = this->Implementation->GetData(true, cPath, false);
-  this->Implementation->Update(cPath, info);
-  this->endResetModel();
+  this->populate(this->Implementation->cleanPath(this->getCurrentPath()));
 
   return ret;
 }
@@ -648,12 +785,7 @@ bool pqFileDialogModel::rmdir(const QString& dirName)
     ret = (vtkDirectory::DeleteDirectory(dirPath.toLatin1().data()) != 0);
     }
 
-  this->beginResetModel();
-  QString cPath = this->Implementation->cleanPath(this->getCurrentPath());
-  vtkPVFileInformation* info;
-  info = this->Implementation->GetData(true, cPath, false);
-  this->Implementation->Update(cPath, info);
-  this->endResetModel();
+  this->populate(this->Implementation->cleanPath(this->getCurrentPath()));
 
 
   return ret;
@@ -709,11 +841,7 @@ bool pqFileDialogModel::rename(const QString& oldname, const QString& newname)
                                 newPath.toLatin1().data()) != 0);
     }
 
-  this->beginResetModel();
-  QString cPath = this->Implementation->cleanPath(this->getCurrentPath());
-  info = this->Implementation->GetData(true, cPath, false);
-  this->Implementation->Update(cPath, info);
-  this->endResetModel();
+  this->populate(this->Implementation->cleanPath(this->getCurrentPath()));
 
   return ret;
 }
@@ -833,7 +961,11 @@ QModelIndex pqFileDialogModel::parent(const QModelIndex& idx) const
     }
 
   const pqFileDialogModelFileInfo* ptr = reinterpret_cast<pqFileDialogModelFileInfo*>(idx.internalPointer());
-  int row = ptr - &this->Implementation->FileList.first();
+  int row = this->Implementation->GetGroupRow(ptr);
+  if (row < 0)
+    {
+    return QModelIndex();
+    }
   return this->createIndex(row, idx.column());
 }
 
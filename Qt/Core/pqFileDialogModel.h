@@ -130,7 +130,15 @@ public:
   /// returns flags for item
   Qt::ItemFlags flags(const QModelIndex& idx) const;
 
+private slots:
+  /// adds the next page of the directory being listed to the model.
+  void fetchNextPage();
+
 private:
+  /// lists the first page of the given directory into the model, and
+  /// schedules the fetching of the others.
+  void populate(const QString& path);
+
   class pqImplementation;
   pqImplementation* const Implementation;
 };
@@ -0,0 +1,89 @@
+#!/usr/bin/env python
+"""
+Measure the run time of the SciberQuest kernel convolution for the different
+CPU optimizations (see CPUConvolutionDriver), kernel widths and numbers of
+threads.
+
+Run with pvbatch, e.g.:
+  mpirun -np 4 pvbatch kernel-convolution-benchmark.py \\
+      --plugin /path/to/libSciberQuestToolKit.so --extent 63 \\
+      --widths 3 9 19 --threads 1 4
+
+A wavelet of the given extent is generated and its ghost cells exchanged
+once. Each configuration then convolves RTData with a new filter, so that
+only the convolution is timed. The best time over the repeats is printed by
+the first process.
+"""
+
+import argparse
+import time
+
+from paraview.simple import *
+
+# CPUDriverOptimization values, see the enumeration in
+# SciberQuestToolKitSMFilters.xml.
+OPTIMIZATIONS = { "none" : 0, "flatten" : 1, "separable" : 3 }
+KERNELS = { "gaussian" : 0, "constant" : 2 }
+
+#-----------------------------------------------------------------------------
+def main():
+  parser = argparse.ArgumentParser(
+    description="Benchmark the CPU optimizations of SQ Kernel Convolution.")
+  parser.add_argument("--plugin", required=True,
+    help="path to the SciberQuestToolKit plugin library")
+  parser.add_argument("--extent", type=int, default=63,
+    help="the wavelet has (2*extent+1)^3 points")
+  parser.add_argument("--2d", dest="flat", action="store_true",
+    help="use a single z slice, i.e. a 2D kernel")
+  parser.add_argument("--kernels", nargs="+", default=["gaussian"],
+    choices=sorted(KERNELS.keys()), help="kernel types to benchmark")
+  parser.add_argument("--widths", type=int, nargs="+", default=[3, 9, 19],
+    help="kernel widths to benchmark")
+  parser.add_argument("--optimizations", nargs="+",
+    default=["none", "flatten", "separable"],
+    choices=sorted(OPTIMIZATIONS.keys()), help="CPU optimizations to benchmark")
+  parser.add_argument("--threads", type=int, nargs="+", default=[1],
+    help="values of NumberOfThreads to benchmark (flatten is single threaded)")
+  parser.add_argument("--repeat", type=int, default=3,
+    help="number of runs per configuration")
+  args = parser.parse_args()
+
+  LoadPlugin(args.plugin, ns=globals())
+
+  e = args.extent
+  ez = 0 if args.flat else e
+  source = Wavelet(WholeExtent=[-e, e, -e, e, -ez, ez])
+  ghosts = SQImageGhosts(Input=source)
+  ghosts.UpdatePipeline()
+
+  pm = servermanager.vtkProcessModule.GetProcessModule()
+  rank = pm.GetPartitionId()
+
+  if rank == 0:
+    print "%10s %6s %10s %8s %12s" % (
+      "kernel", "width", "opt", "threads", "time (s)")
+  for kernel in args.kernels:
+    for width in args.widths:
+      for opt in args.optimizations:
+        threads = [1] if opt == "flatten" else args.threads
+        for nThreads in threads:
+          best = None
+          for cc in range(args.repeat):
+            conv = SQKernelConvolution(Input=ghosts,
+              ArraysToFilter=["RTData"],
+              KernelType=KERNELS[kernel],
+              KernelWidth=width,
+              CPUDriverOptimization=OPTIMIZATIONS[opt],
+              NumberOfThreads=nThreads)
+            start = time.time()
+            conv.UpdatePipeline()
+            elapsed = time.time() - start
+            Delete(conv)
+            if best is None or elapsed < best:
+              best = elapsed
+          if rank == 0:
+            print "%10s %6d %10s %8d %12.3f" % (kernel, width, opt, nThreads,
+              best)
+
+if __name__ == "__main__":
+  main()
@@ -0,0 +1,80 @@
+#!/usr/bin/env python
+"""
+Merge the per-process Chrome trace-event files written by vtkPVEventTraceLog
+(i.e. when running paraview/pvserver/pvbatch with PV_EVENT_TRACE_PREFIX set)
+into a single file that can be loaded in chrome://tracing or ui.perfetto.dev.
+The files are named <prefix>.<process type>.<rank>.json, e.g.
+prefix.client.0.json and prefix.server.3.json.
+
+Usage:
+  merge-event-traces.py -o merged.json prefix.server.0.json ...
+  merge-event-traces.py -o merged.json --prefix prefix
+
+Optionally, --min-duration drops events shorter than the given number of
+milliseconds, which keeps traces of large runs loadable.
+"""
+
+import argparse
+import glob
+import json
+import re
+import sys
+
+#-----------------------------------------------------------------------------
+def sort_key(filename):
+  match = re.search(r"\.([^.]+)\.(\d+)\.json$", filename)
+  return (match.group(1), int(match.group(2))) if match else ("", -1)
+
+#-----------------------------------------------------------------------------
+def main():
+  parser = argparse.ArgumentParser(
+    description="Merge per-process ParaView event traces.")
+  parser.add_argument("files", nargs="*", help="per-process trace files")
+  parser.add_argument("--prefix",
+    help="merge all files named <prefix>.<process type>.<rank>.json")
+  parser.add_argument("-o", "--output", required=True,
+    help="merged trace file to write")
+  parser.add_argument("--min-duration", type=float, default=0.0,
+    help="drop events shorter than this many milliseconds")
+  args = parser.parse_args()
+
+  files = list(args.files)
+  if args.prefix:
+    files += glob.glob(args.prefix + ".*.json")
+  files = sorted(set(files), key=sort_key)
+  if not files:
+    sys.stderr.write("No trace files to merge.\n")
+    return 1
+
+  min_duration = args.min_duration * 1000.0
+  events = []
+  dropped = 0
+  for filename in files:
+    with open(filename) as f:
+      trace = json.load(f)
+    for event in trace.get("traceEvents", []):
+      if event.get("ph") == "M" and event.get("name") == "dropped_events":
+        dropped += event.get("args", {}).get("count", 0)
+      if event.get("ph") == "X" and event.get("dur", 0) < min_duration:
+        continue
+      events.append(event)
+
+  # Shift timestamps so that the timeline starts at zero.
+  starts = [e["ts"] for e in events if "ts" in e]
+  origin = min(starts) if starts else 0
+  for event in events:
+    if "ts" in event:
+      event["ts"] -= origin
+
+  with open(args.output, "w") as f:
+    json.dump({"traceEvents": events, "displayTimeUnit": "ms"}, f)
+
+  sys.stdout.write("Merged %d events from %d files into %s\n" %
+    (len(events), len(files), args.output))
+  if dropped:
+    sys.stdout.write("Warning: %d events were dropped by full ring buffers.\n"
+      % dropped)
+  return 0
+
+if __name__ == "__main__":
+  sys.exit(main())
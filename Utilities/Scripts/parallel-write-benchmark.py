@@ -0,0 +1,67 @@
+#!/usr/bin/env python
+"""
+Measure the write throughput of vtkParallelSerialWriter based writers for
+different aggregation settings (see NumberOfIOGroups and GroupByNode).
+
+Run with pvbatch, e.g.:
+  mpirun -np 64 pvbatch --symmetric parallel-write-benchmark.py \\
+      -o /scratch/bench/wavelet.vtk --extent 255 --groups 1 4 16 --by-node
+
+A wavelet of the given extent is generated, converted to unstructured data
+and written once per configuration. The time, size and throughput reported
+by the writer are printed by the first process.
+"""
+
+import argparse
+
+from paraview.simple import *
+
+#-----------------------------------------------------------------------------
+def main():
+  parser = argparse.ArgumentParser(
+    description="Benchmark parallel writes with vtkParallelSerialWriter.")
+  parser.add_argument("-o", "--output", required=True,
+    help="file name passed to the writer")
+  parser.add_argument("--extent", type=int, default=127,
+    help="the wavelet has (2*extent+1)^3 points")
+  parser.add_argument("--groups", type=int, nargs="+", default=[1],
+    help="values of NumberOfIOGroups to benchmark")
+  parser.add_argument("--by-node", action="store_true",
+    help="also benchmark each value with GroupByNode on")
+  parser.add_argument("--repeat", type=int, default=3,
+    help="number of writes per configuration")
+  args = parser.parse_args()
+
+  e = args.extent
+  source = Wavelet(WholeExtent=[-e, e, -e, e, -e, e])
+  data = Tetrahedralize(Input=source)
+  data.UpdatePipeline()
+
+  writer = CreateWriter(args.output, data)
+  pm = servermanager.vtkProcessModule.GetProcessModule()
+  rank = pm.GetPartitionId()
+
+  configurations = [(groups, 0) for groups in args.groups]
+  if args.by_node:
+    configurations += [(groups, 1) for groups in args.groups]
+
+  if rank == 0:
+    print "%8s %8s %12s %12s %12s" % (
+      "groups", "by-node", "time (s)", "size (MB)", "MB/s")
+  for groups, byNode in configurations:
+    writer.NumberOfIOGroups = groups
+    writer.GroupByNode = byNode
+    best = None
+    for cc in range(args.repeat):
+      writer.UpdatePipeline()
+      impl = writer.GetClientSideObject()
+      result = (impl.GetLastWriteTime(), impl.GetLastBytesWritten(),
+        impl.GetLastWriteThroughput())
+      if best is None or result[0] < best[0]:
+        best = result
+    if rank == 0:
+      print "%8d %8d %12.3f %12.1f %12.1f" % (groups, byNode, best[0],
+        best[1] / (1024.0 * 1024.0), best[2])
+
+if __name__ == "__main__":
+  main()
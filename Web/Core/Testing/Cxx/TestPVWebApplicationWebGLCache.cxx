@@ -0,0 +1,233 @@
+/*=========================================================================
+
+Program:   ParaView
+Module:    TestPVWebApplicationWebGLCache.cxx
+
+Copyright (c) Kitware, Inc.
+All rights reserved.
+See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests the content cache of the WebGL parts exported by vtkPVWebApplication:
+// parts are reachable from the md5 reported in the scene meta-data, objects
+// that did not change are not copied again when the scene is exported again,
+// and objects no longer part of the scene are evicted.
+
+#include "vtkBase64Utilities.h"
+#include "vtkInitializationHelper.h"
+#include "vtkNew.h"
+#include "vtkProcessModule.h"
+#include "vtkPVWebApplication.h"
+#include "vtkSMParaViewPipelineController.h"
+#include "vtkSMPropertyHelper.h"
+#include "vtkSMSession.h"
+#include "vtkSMSessionProxyManager.h"
+#include "vtkSmartPointer.h"
+#include "vtkSMViewProxy.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <map>
+#include <set>
+#include <string>
+
+namespace
+{
+typedef std::map<std::string, vtkUnsignedCharArray*> PartsType;
+
+// Returns the md5 of all the objects listed in the scene meta-data.
+std::set<std::string> GetMD5s(const char* metaData)
+{
+  std::set<std::string> md5s;
+  std::string json = metaData? metaData : "";
+  size_t pos = 0;
+  while ((pos = json.find("\"md5\"", pos)) != std::string::npos)
+    {
+    size_t begin = json.find('"', json.find(':', pos) + 1);
+    size_t end = json.find('"', begin + 1);
+    if (begin == std::string::npos || end == std::string::npos)
+      {
+      break;
+      }
+    md5s.insert(json.substr(begin + 1, end - begin - 1));
+    pos = end;
+    }
+  return md5s;
+}
+
+// Checks that the first part of every object is available, raw and base64
+// encoded, and returns the raw parts.
+bool GetParts(vtkPVWebApplication* app, const std::set<std::string>& md5s,
+  PartsType& parts)
+{
+  parts.clear();
+  for (std::set<std::string>::const_iterator iter = md5s.begin();
+    iter != md5s.end(); ++iter)
+    {
+    vtkUnsignedCharArray* raw =
+      app->GetWebGLRawBinaryDataByHash(iter->c_str(), 0);
+    const char* encoded = app->GetWebGLBinaryDataByHash(iter->c_str(), 0);
+    if (raw == NULL || encoded == NULL)
+      {
+      cerr << "Missing part for object " << *iter << endl;
+      return false;
+      }
+    unsigned long size = static_cast<unsigned long>(raw->GetNumberOfTuples());
+    std::string expected;
+    if (size > 0)
+      {
+      unsigned char* output = new unsigned char[size*2];
+      unsigned long length = vtkBase64Utilities::Encode(
+        raw->GetPointer(0), size, output, false);
+      expected = std::string(reinterpret_cast<const char*>(output), length);
+      delete[] output;
+      }
+    if (expected != encoded)
+      {
+      cerr << "Base64 part does not match the raw part of " << *iter << endl;
+      return false;
+      }
+    parts[*iter] = raw;
+    }
+  return true;
+}
+
+vtkSMProxy* Show(vtkSMParaViewPipelineController* controller,
+  vtkSMSessionProxyManager* pxm, vtkSMViewProxy* view, const char* name)
+{
+  vtkSmartPointer<vtkSMProxy> source;
+  source.TakeReference(pxm->NewProxy("sources", name));
+  controller->PreInitializeProxy(source);
+  controller->PostInitializeProxy(source);
+  controller->RegisterPipelineProxy(source);
+
+  vtkSmartPointer<vtkSMProxy> repr;
+  repr.TakeReference(view->CreateDefaultRepresentation(source, 0));
+  controller->PreInitializeProxy(repr);
+  vtkSMPropertyHelper(repr, "Input").Set(source);
+  controller->PostInitializeProxy(repr);
+  controller->RegisterRepresentationProxy(repr);
+  vtkSMPropertyHelper(view, "Representations").Add(repr);
+  view->UpdateVTKObjects();
+  return source;
+}
+}
+
+int TestPVWebApplicationWebGLCache(int, char* argv[])
+{
+  vtkInitializationHelper::Initialize(argv[0], vtkProcessModule::PROCESS_CLIENT);
+
+  vtkNew<vtkSMParaViewPipelineController> controller;
+  vtkSMSession* session = vtkSMSession::New();
+  vtkSMSessionProxyManager* pxm = session->GetSessionProxyManager();
+  if (!controller->InitializeSession(session))
+    {
+    cerr << "Failed to initialize ParaView session." << endl;
+    return EXIT_FAILURE;
+    }
+
+  int status = EXIT_SUCCESS;
+  vtkPVWebApplication* app = vtkPVWebApplication::New();
+    {
+    vtkSmartPointer<vtkSMProxy> viewProxy;
+    viewProxy.TakeReference(pxm->NewProxy("views", "RenderView"));
+    controller->PreInitializeProxy(viewProxy);
+    controller->PostInitializeProxy(viewProxy);
+    controller->RegisterViewProxy(viewProxy);
+    vtkSMViewProxy* view = vtkSMViewProxy::SafeDownCast(viewProxy);
+
+    Show(controller.GetPointer(), pxm, view, "SphereSource");
+    vtkSMProxy* cone = Show(controller.GetPointer(), pxm, view, "ConeSource");
+    view->StillRender();
+
+    std::set<std::string> md5s = GetMD5s(app->GetWebGLSceneMetaData(view));
+    PartsType parts;
+    if (md5s.size() < 2 || !GetParts(app, md5s, parts))
+      {
+      cerr << "Bad initial export (" << md5s.size() << " objects)." << endl;
+      status = EXIT_FAILURE;
+      }
+
+    // Unknown objects or parts.
+    if (status == EXIT_SUCCESS &&
+      (app->GetWebGLRawBinaryDataByHash("not-an-md5", 0) != NULL ||
+       app->GetWebGLBinaryDataByHash("not-an-md5", 0) != NULL ||
+       app->GetWebGLRawBinaryDataByHash(md5s.begin()->c_str(), -1) != NULL ||
+       app->GetWebGLRawBinaryDataByHash(md5s.begin()->c_str(), 1000) != NULL))
+      {
+      cerr << "Unknown objects or parts should not be found." << endl;
+      status = EXIT_FAILURE;
+      }
+
+    // Exporting the same scene again should not copy any part.
+    if (status == EXIT_SUCCESS)
+      {
+      std::set<std::string> again = GetMD5s(app->GetWebGLSceneMetaData(view));
+      PartsType againParts;
+      if (again != md5s || !GetParts(app, again, againParts) ||
+        againParts != parts)
+        {
+        cerr << "Unchanged objects were exported again." << endl;
+        status = EXIT_FAILURE;
+        }
+      }
+
+    // Changing the cone should only replace the cone.
+    if (status == EXIT_SUCCESS)
+      {
+      vtkSMPropertyHelper(cone, "Resolution").Set(12);
+      cone->UpdateVTKObjects();
+      view->StillRender();
+
+      std::set<std::string> changed = GetMD5s(app->GetWebGLSceneMetaData(view));
+      PartsType changedParts;
+      if (!GetParts(app, changed, changedParts))
+        {
+        status = EXIT_FAILURE;
+        }
+      int kept = 0, removed = 0, added = 0;
+      for (PartsType::iterator iter = parts.begin(); iter != parts.end(); ++iter)
+        {
+        PartsType::iterator match = changedParts.find(iter->first);
+        if (match == changedParts.end())
+          {
+          removed++;
+          if (app->GetWebGLRawBinaryDataByHash(iter->first.c_str(), 0) != NULL)
+            {
+            cerr << "Object " << iter->first << " was not evicted." << endl;
+            status = EXIT_FAILURE;
+            }
+          }
+        else if (match->second != iter->second)
+          {
+          cerr << "Unchanged object " << iter->first << " was copied again."
+            << endl;
+          status = EXIT_FAILURE;
+          }
+        else
+          {
+          kept++;
+          }
+        }
+      for (PartsType::iterator iter = changedParts.begin();
+        iter != changedParts.end(); ++iter)
+        {
+        added += parts.find(iter->first) == parts.end()? 1 : 0;
+        }
+      if (kept == 0 || removed == 0 || added == 0)
+        {
+        cerr << "Expected the sphere to be kept and the cone to be replaced "
+          << "(kept " << kept << ", removed " << removed << ", added "
+          << added << ")." << endl;
+        status = EXIT_FAILURE;
+        }
+      }
+    }
+  app->Delete();
+  session->Delete();
+  vtkInitializationHelper::Finalize();
+  return status;
+}
@@ -7,6 +7,7 @@ vtk_module(vtkParaViewWebCore
     vtkPVServerManagerDefault
   TEST_DEPENDS
     vtkImagingSources
+    vtkTestingCore
   TEST_LABELS
     PARAVIEW
     PARAVIEWWEB
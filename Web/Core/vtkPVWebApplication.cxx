@@ -14,17 +14,23 @@
 =========================================================================*/
 #include "vtkPVWebApplication.h"
 
+#include "vtkActor.h"
+#include "vtkActorCollection.h"
 #include "vtkBase64Utilities.h"
 #include "vtkCamera.h"
 #include "vtkCommand.h"
-#include "vtkDataEncoder.h"
+#include "vtkConditionVariable.h"
 #include "vtkImageData.h"
 #include "vtkJPEGWriter.h"
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPNGWriter.h"
 #include "vtkPointData.h"
+#include "vtkPVLODActor.h"
 #include "vtkPVRenderView.h"
+#include "vtkRenderer.h"
 #include "vtkRendererCollection.h"
 #include "vtkRenderWindow.h"
 #include "vtkRenderWindowInteractor.h"
@@ -39,9 +45,13 @@
 #include "vtkWebGLObject.h"
 #include "vtkWebInteractionEvent.h"
 
-#include <assert.h>
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <deque>
 #include <map>
+#include <set>
+#include <vector>
 
 class vtkPVWebApplication::vtkInternals
 {
@@ -52,9 +62,11 @@ public:
     vtkSmartPointer<vtkUnsignedCharArray> Data;
     bool NeedsRender;
     bool HasImagesBeingProcessed;
+    int Encoding;
+    int Compression;
     vtkObject* ViewPointer;
     unsigned long ObserverId;
-    ImageCacheValueType() : NeedsRender(true), HasImagesBeingProcessed(false), ViewPointer(NULL), ObserverId(0) { }
+    ImageCacheValueType() : NeedsRender(true), HasImagesBeingProcessed(false), Encoding(-1), Compression(-1), ViewPointer(NULL), ObserverId(0) { }
 
     void SetListener(vtkObject* view)
     {
@@ -96,21 +108,379 @@ public:
   typedef std::map<void*, unsigned int > ButtonStatesType;
   ButtonStatesType ButtonStates;
 
-  vtkNew<vtkDataEncoder> Encoder;
+  // Image compression. Every view has a slot holding the frame waiting to be
+  // compressed and the last compressed image. Slots are never removed, so
+  // references to them remain valid while encoder threads run.
+  struct FrameStatisticsType
+    {
+    int FramesEncoded;
+    int FramesDropped;
+    double LastCaptureTime;
+    double LastLatency;
+    double TotalLatency;
+    double MaximumLatency;
+    double TotalEncodeTime;
+    FrameStatisticsType() : FramesEncoded(0), FramesDropped(0),
+      LastCaptureTime(0), LastLatency(0), TotalLatency(0), MaximumLatency(0),
+      TotalEncodeTime(0) { }
+    };
+  struct FrameSlotType
+    {
+    vtkSmartPointer<vtkImageData> Pending;
+    int Quality;
+    int Compression;
+    int Encoding;
+    double PushTime;
+    bool Queued;
+    bool Busy;
+    vtkSmartPointer<vtkUnsignedCharArray> Output;
+    FrameStatisticsType Statistics;
+    FrameSlotType() : Quality(100), Compression(COMPRESSION_JPEG),
+      Encoding(ENCODING_BASE64), PushTime(0), Queued(false),
+      Busy(false) { }
+    };
+  typedef std::map<vtkTypeUInt32, FrameSlotType> FrameSlotsType;
+
+  // All of the following are protected by Mutex once encoder threads run.
+  FrameSlotsType FrameSlots;
+  std::deque<vtkTypeUInt32> ReadyViews;
+  bool Stop;
+
+  vtkNew<vtkMultiThreader> Threader;
+  vtkNew<vtkMutexLock> Mutex;
+  vtkNew<vtkConditionVariable> FrameQueued;
+  vtkNew<vtkConditionVariable> FrameEncoded;
+  std::vector<int> ThreadIds;
+
+  vtkInternals() : Stop(false) { }
+
+  ~vtkInternals()
+    {
+    this->Mutex->Lock();
+    this->Stop = true;
+    this->Mutex->Unlock();
+    this->FrameQueued->Broadcast();
+    this->FrameEncoded->Broadcast();
+    for (size_t cc = 0; cc < this->ThreadIds.size(); ++cc)
+      {
+      this->Threader->TerminateThread(this->ThreadIds[cc]);
+      }
+    }
+
+  void StartEncoderThreads(int numThreads)
+    {
+    for (int cc = 0; cc < numThreads; ++cc)
+      {
+      this->ThreadIds.push_back(this->Threader->SpawnThread(
+          &vtkInternals::EncoderThread, this));
+      }
+    }
+
+  // Hand over a captured frame to the encoder threads. A frame of the same
+  // view that no thread picked up yet is dropped.
+  void Push(vtkTypeUInt32 key, vtkImageData* image, int quality,
+    int compression, int encoding, double captureTime)
+    {
+    this->Mutex->Lock();
+    FrameSlotType& slot = this->FrameSlots[key];
+    if (slot.Pending)
+      {
+      slot.Statistics.FramesDropped++;
+      }
+    slot.Pending.TakeReference(image);
+    slot.Quality = quality;
+    slot.Compression = compression;
+    slot.Encoding = encoding;
+    slot.PushTime = vtkTimerLog::GetUniversalTime();
+    slot.Statistics.LastCaptureTime = captureTime;
+    // a view is compressed by one thread at a time; the thread requeues it
+    // when done if a new frame arrived meanwhile.
+    bool ready = !slot.Queued && !slot.Busy;
+    if (ready)
+      {
+      slot.Queued = true;
+      this->ReadyViews.push_back(key);
+      }
+    this->Mutex->Unlock();
+    if (ready)
+      {
+      this->FrameQueued->Signal();
+      }
+    }
+
+  // Wait till the frames pushed for the view have been compressed.
+  void Flush(vtkTypeUInt32 key)
+    {
+    this->Mutex->Lock();
+    FrameSlotType& slot = this->FrameSlots[key];
+    while ((slot.Pending || slot.Busy) && !this->Stop)
+      {
+      this->FrameEncoded->Wait(this->Mutex.GetPointer());
+      }
+    this->Mutex->Unlock();
+    }
+
+  // Get the last compressed image of the view. Returns true if it is the
+  // image of the last frame pushed.
+  bool GetLatestOutput(vtkTypeUInt32 key,
+    vtkSmartPointer<vtkUnsignedCharArray>& data)
+    {
+    this->Mutex->Lock();
+    FrameSlotType& slot = this->FrameSlots[key];
+    if (slot.Output)
+      {
+      data = slot.Output;
+      }
+    bool latest = !slot.Pending && !slot.Busy;
+    this->Mutex->Unlock();
+    return latest;
+    }
+
+  FrameStatisticsType GetStatistics(vtkTypeUInt32 key)
+    {
+    this->Mutex->Lock();
+    FrameStatisticsType stats = this->FrameSlots[key].Statistics;
+    this->Mutex->Unlock();
+    return stats;
+    }
+
+  void ResetStatistics(vtkTypeUInt32 key)
+    {
+    this->Mutex->Lock();
+    this->FrameSlots[key].Statistics = FrameStatisticsType();
+    this->Mutex->Unlock();
+    }
+
+  static vtkUnsignedCharArray* EncodeImage(vtkImageData* image,
+    int quality, int compression, int encoding,
+    vtkJPEGWriter* jpegWriter, vtkPNGWriter* pngWriter)
+    {
+    // the writers reuse their result array, so the compressed data is always
+    // copied into a new array, which is never modified once published.
+    const unsigned char* data = NULL;
+    vtkIdType size = 0;
+    vtkUnsignedCharArray* compressed = NULL;
+    if (compression == COMPRESSION_JPEG)
+      {
+      jpegWriter->SetQuality(quality);
+      jpegWriter->SetInputData(image);
+      jpegWriter->Write();
+      jpegWriter->SetInputData(NULL);
+      compressed = jpegWriter->GetResult();
+      }
+    else if (compression == COMPRESSION_PNG)
+      {
+      pngWriter->SetInputData(image);
+      pngWriter->Write();
+      pngWriter->SetInputData(NULL);
+      compressed = pngWriter->GetResult();
+      }
+    else
+      {
+      compressed = vtkUnsignedCharArray::SafeDownCast(
+        image->GetPointData()->GetScalars());
+      }
+    if (compressed)
+      {
+      data = compressed->GetPointer(0);
+      size = compressed->GetNumberOfTuples() *
+        compressed->GetNumberOfComponents();
+      }
+
+    vtkUnsignedCharArray* output = vtkUnsignedCharArray::New();
+    if (encoding == ENCODING_BASE64)
+      {
+      // keep the null terminator in the array for StillRenderToString().
+      output->SetNumberOfTuples(((size + 2) / 3) * 4 + 1);
+      unsigned long length = vtkBase64Utilities::Encode(data,
+        static_cast<unsigned long>(size), output->GetPointer(0), 0);
+      output->SetValue(static_cast<vtkIdType>(length), 0);
+      output->SetNumberOfTuples(static_cast<vtkIdType>(length) + 1);
+      }
+    else
+      {
+      output->SetNumberOfTuples(size);
+      if (size > 0)
+        {
+        memcpy(output->GetPointer(0), data, size);
+        }
+      }
+    return output;
+    }
+
+  static VTK_THREAD_RETURN_TYPE EncoderThread(void* arg)
+    {
+    vtkMultiThreader::ThreadInfo* info =
+      static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    vtkInternals* self = static_cast<vtkInternals*>(info->UserData);
+
+    vtkNew<vtkJPEGWriter> jpegWriter;
+    jpegWriter->WriteToMemoryOn();
+    vtkNew<vtkPNGWriter> pngWriter;
+    pngWriter->WriteToMemoryOn();
+
+    self->Mutex->Lock();
+    while (true)
+      {
+      while (self->ReadyViews.empty() && !self->Stop)
+        {
+        self->FrameQueued->Wait(self->Mutex.GetPointer());
+        }
+      if (self->Stop)
+        {
+        break;
+        }
+      vtkTypeUInt32 key = self->ReadyViews.front();
+      self->ReadyViews.pop_front();
+      FrameSlotType& slot = self->FrameSlots[key];
+      slot.Queued = false;
+      slot.Busy = true;
+      vtkSmartPointer<vtkImageData> image = slot.Pending;
+      slot.Pending = NULL;
+      int quality = slot.Quality;
+      int compression = slot.Compression;
+      int encoding = slot.Encoding;
+      double pushTime = slot.PushTime;
+      self->Mutex->Unlock();
+
+      double startTime = vtkTimerLog::GetUniversalTime();
+      vtkSmartPointer<vtkUnsignedCharArray> output;
+      output.TakeReference(EncodeImage(image, quality, compression, encoding,
+          jpegWriter.GetPointer(), pngWriter.GetPointer()));
+      image = NULL;
+      double endTime = vtkTimerLog::GetUniversalTime();
+
+      self->Mutex->Lock();
+      slot.Busy = false;
+      slot.Output = output;
+      FrameStatisticsType& stats = slot.Statistics;
+      stats.FramesEncoded++;
+      stats.LastLatency = endTime - pushTime;
+      stats.TotalLatency += stats.LastLatency;
+      stats.MaximumLatency = std::max(stats.MaximumLatency, stats.LastLatency);
+      stats.TotalEncodeTime += endTime - startTime;
+      if (slot.Pending)
+        {
+        slot.Queued = true;
+        self->ReadyViews.push_back(key);
+        self->FrameQueued->Signal();
+        }
+      self->FrameEncoded->Broadcast();
+      }
+    self->Mutex->Unlock();
+    return VTK_THREAD_RETURN_VALUE;
+    }
 
   // WebGL related struct
   struct WebGLObjCacheValue
     {
     public:
       int ObjIndex;
-      std::map<int, std::string> BinaryParts;
+      std::string MD5;
     };
   // map for <vtkWebGLExporter, <webgl-objID, WebGLObjCacheValue> >
   typedef std::map<std::string, WebGLObjCacheValue> WebGLObjId2IndexMap;
   std::map<vtkWebGLExporter*, WebGLObjId2IndexMap> WebGLExporterObjIdMap;
-  // map for <vtkSMViewProxy, vtkWebGLExporter>
-  std::map<vtkSMViewProxy*, vtkSmartPointer<vtkWebGLExporter> > ViewWebGLMap;
-  std::string LastAllWebGLBinaryObjects;
+  // map for <<vtkSMViewProxy, lod>, vtkWebGLExporter>
+  typedef std::pair<vtkSMViewProxy*, int> WebGLExporterKey;
+  std::map<WebGLExporterKey, vtkSmartPointer<vtkWebGLExporter> > ViewWebGLMap;
+  // exporter that parsed the scene of a view most recently
+  std::map<vtkSMViewProxy*, vtkWebGLExporter*> LastWebGLExporter;
+
+  // Binary parts of the exported objects, shared by all exporters and keyed
+  // by the md5 of the object. Only objects present in the last scene of
+  // some exporter are kept.
+  struct WebGLPartsCacheValue
+    {
+    std::vector<vtkSmartPointer<vtkUnsignedCharArray> > Parts;
+    std::map<int, std::string> Base64Parts;
+    };
+  typedef std::map<std::string, WebGLPartsCacheValue> WebGLPartsCacheType;
+  WebGLPartsCacheType WebGLPartsCache;
+
+  void UpdateWebGLPartsCache(vtkWebGLExporter* exporter)
+    {
+    WebGLObjId2IndexMap& objects = this->WebGLExporterObjIdMap[exporter];
+    for (WebGLObjId2IndexMap::iterator iter = objects.begin();
+      iter != objects.end(); ++iter)
+      {
+      if (this->WebGLPartsCache.find(iter->second.MD5) !=
+        this->WebGLPartsCache.end())
+        {
+        continue;
+        }
+      vtkWebGLObject* obj = exporter->GetWebGLObject(iter->second.ObjIndex);
+      WebGLPartsCacheValue& value = this->WebGLPartsCache[iter->second.MD5];
+      for (int part = 0; part < obj->GetNumberOfParts(); ++part)
+        {
+        vtkNew<vtkUnsignedCharArray> data;
+        data->SetNumberOfTuples(obj->GetBinarySize(part));
+        if (obj->GetBinarySize(part) > 0)
+          {
+          memcpy(data->GetPointer(0), obj->GetBinaryData(part),
+            obj->GetBinarySize(part));
+          }
+        value.Parts.push_back(data.GetPointer());
+        }
+      }
+
+    // discard objects no longer part of any scene.
+    std::set<std::string> used;
+    std::map<vtkWebGLExporter*, WebGLObjId2IndexMap>::iterator eiter;
+    for (eiter = this->WebGLExporterObjIdMap.begin();
+      eiter != this->WebGLExporterObjIdMap.end(); ++eiter)
+      {
+      for (WebGLObjId2IndexMap::iterator iter = eiter->second.begin();
+        iter != eiter->second.end(); ++iter)
+        {
+        used.insert(iter->second.MD5);
+        }
+      }
+    for (WebGLPartsCacheType::iterator iter = this->WebGLPartsCache.begin();
+      iter != this->WebGLPartsCache.end();)
+      {
+      if (used.find(iter->first) == used.end())
+        {
+        this->WebGLPartsCache.erase(iter++);
+        }
+      else
+        {
+        ++iter;
+        }
+      }
+    }
+
+  vtkUnsignedCharArray* GetWebGLPart(const std::string& md5, int part)
+    {
+    WebGLPartsCacheType::iterator iter = this->WebGLPartsCache.find(md5);
+    if (iter == this->WebGLPartsCache.end() || part < 0 ||
+      part >= static_cast<int>(iter->second.Parts.size()))
+      {
+      return NULL;
+      }
+    return iter->second.Parts[part];
+    }
+
+  const char* GetWebGLBase64Part(const std::string& md5, int part)
+    {
+    vtkUnsignedCharArray* data = this->GetWebGLPart(md5, part);
+    if (data == NULL)
+      {
+      return NULL;
+      }
+    std::string& encoded = this->WebGLPartsCache[md5].Base64Parts[part];
+    if (encoded.empty() && data->GetNumberOfTuples() > 0)
+      {
+      unsigned long size =
+        static_cast<unsigned long>(data->GetNumberOfTuples());
+      unsigned char* output = new unsigned char[size*2];
+      unsigned long length = vtkBase64Utilities::Encode(
+        data->GetPointer(0), size, output, false);
+      encoded = std::string(reinterpret_cast<const char*>(output), length);
+      delete[] output;
+      }
+    return encoded.c_str();
+    }
 };
 
 vtkStandardNewMacro(vtkPVWebApplication);
@@ -118,6 +488,7 @@ vtkStandardNewMacro(vtkPVWebApplication);
 vtkPVWebApplication::vtkPVWebApplication():
   ImageEncoding(ENCODING_BASE64),
   ImageCompression(COMPRESSION_JPEG),
+  NumberOfEncoderThreads(3),
   Internals(new vtkPVWebApplication::vtkInternals())
 {
 }
@@ -151,6 +522,13 @@ void vtkPVWebApplication::InvalidateCache(vtkSMViewProxy* view)
 
 //----------------------------------------------------------------------------
 vtkUnsignedCharArray* vtkPVWebApplication::StillRender(vtkSMViewProxy* view, int quality)
+{
+  return this->StillRender(view, quality, this->ImageEncoding);
+}
+
+//----------------------------------------------------------------------------
+vtkUnsignedCharArray* vtkPVWebApplication::StillRender(
+  vtkSMViewProxy* view, int quality, int encoding)
 {
   if (!view)
     {
@@ -163,10 +541,12 @@ vtkUnsignedCharArray* vtkPVWebApplication::StillRender(vtkSMViewProxy* view, int
 
   if (value.NeedsRender == false &&
     value.Data != NULL &&
+    value.Encoding == encoding &&
+    value.Compression == this->ImageCompression &&
     view->GetNeedsUpdate() == false)
     {
     //cout <<  "Reusing cache" << endl;
-    bool latest = this->Internals->Encoder->GetLatestOutput(view->GetGlobalID(), value.Data);
+    bool latest = this->Internals->GetLatestOutput(view->GetGlobalID(), value.Data);
     value.HasImagesBeingProcessed = !latest;
     return value.Data;
     }
@@ -179,24 +559,36 @@ vtkUnsignedCharArray* vtkPVWebApplication::StillRender(vtkSMViewProxy* view, int
 
   // TODO: We should add logic to check if a new rendering needs to be done and
   // then alone do a new rendering otherwise use the cached image.
+  double captureStart = vtkTimerLog::GetUniversalTime();
   vtkImageData* image = view->CaptureWindow(1);
+  double captureTime = vtkTimerLog::GetUniversalTime() - captureStart;
   //vtkTimerLog::MarkEndEvent("CaptureWindow");
 
   //vtkTimerLog::MarkEndEvent("StillRenderToString");
   //vtkTimerLog::DumpLogWithIndents(&cout, 0.0);
 
-  this->Internals->Encoder->PushAndTakeReference(view->GetGlobalID(), image, quality);
-  assert(image == NULL);
-
-  if (value.Data == NULL)
+  if (this->Internals->ThreadIds.empty())
+    {
+    this->Internals->StartEncoderThreads(this->NumberOfEncoderThreads);
+    }
+  this->Internals->Push(view->GetGlobalID(), image, quality,
+    this->ImageCompression, encoding, captureTime);
+  image = NULL;
+
+  // the frame pending in the encoder (if any) may be in another format, so
+  // wait for this one if the format changed for this view.
+  if (value.Data == NULL || value.Encoding != encoding ||
+    value.Compression != this->ImageCompression)
     {
     // we need to wait till output is processed.
     //cout << "Flushing" << endl;
-    this->Internals->Encoder->Flush(view->GetGlobalID());
+    this->Internals->Flush(view->GetGlobalID());
     //cout << "Done Flushing" << endl;
     }
+  value.Encoding = encoding;
+  value.Compression = this->ImageCompression;
 
-  bool latest = this->Internals->Encoder->GetLatestOutput(view->GetGlobalID(), value.Data);
+  bool latest = this->Internals->GetLatestOutput(view->GetGlobalID(), value.Data);
   value.HasImagesBeingProcessed = !latest;
   value.NeedsRender = false;
   return value.Data;
@@ -205,7 +597,7 @@ vtkUnsignedCharArray* vtkPVWebApplication::StillRender(vtkSMViewProxy* view, int
 //----------------------------------------------------------------------------
 const char* vtkPVWebApplication::StillRenderToString(vtkSMViewProxy* view, unsigned long time, int quality)
 {
-  vtkUnsignedCharArray* array = this->StillRender(view, quality);
+  vtkUnsignedCharArray* array = this->StillRender(view, quality, ENCODING_BASE64);
   if (array && array->GetMTime() != time)
     {
     this->LastStillRenderToStringMTime = array->GetMTime();
@@ -215,6 +607,89 @@ const char* vtkPVWebApplication::StillRenderToString(vtkSMViewProxy* view, unsig
   return NULL;
 }
 
+//----------------------------------------------------------------------------
+vtkUnsignedCharArray* vtkPVWebApplication::StillRenderToBinary(
+  vtkSMViewProxy* view, unsigned long time, int quality)
+{
+  vtkUnsignedCharArray* array = this->StillRender(view, quality, ENCODING_NONE);
+  if (array && array->GetMTime() != time)
+    {
+    this->LastStillRenderToStringMTime = array->GetMTime();
+    return array;
+    }
+  return NULL;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVWebApplication::GetNumberOfFramesEncoded(vtkSMViewProxy* view)
+{
+  return view?
+    this->Internals->GetStatistics(view->GetGlobalID()).FramesEncoded : 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVWebApplication::GetNumberOfFramesDropped(vtkSMViewProxy* view)
+{
+  return view?
+    this->Internals->GetStatistics(view->GetGlobalID()).FramesDropped : 0;
+}
+
+//----------------------------------------------------------------------------
+double vtkPVWebApplication::GetLastCaptureTime(vtkSMViewProxy* view)
+{
+  return view?
+    this->Internals->GetStatistics(view->GetGlobalID()).LastCaptureTime : 0.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkPVWebApplication::GetLastFrameLatency(vtkSMViewProxy* view)
+{
+  return view?
+    this->Internals->GetStatistics(view->GetGlobalID()).LastLatency : 0.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkPVWebApplication::GetAverageFrameLatency(vtkSMViewProxy* view)
+{
+  if (!view)
+    {
+    return 0.0;
+    }
+  vtkInternals::FrameStatisticsType stats =
+    this->Internals->GetStatistics(view->GetGlobalID());
+  return stats.FramesEncoded > 0?
+    stats.TotalLatency / stats.FramesEncoded : 0.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkPVWebApplication::GetMaximumFrameLatency(vtkSMViewProxy* view)
+{
+  return view?
+    this->Internals->GetStatistics(view->GetGlobalID()).MaximumLatency : 0.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkPVWebApplication::GetAverageEncodeTime(vtkSMViewProxy* view)
+{
+  if (!view)
+    {
+    return 0.0;
+    }
+  vtkInternals::FrameStatisticsType stats =
+    this->Internals->GetStatistics(view->GetGlobalID());
+  return stats.FramesEncoded > 0?
+    stats.TotalEncodeTime / stats.FramesEncoded : 0.0;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVWebApplication::ResetImageStatistics(vtkSMViewProxy* view)
+{
+  if (view)
+    {
+    this->Internals->ResetStatistics(view->GetGlobalID());
+    }
+}
+
 //----------------------------------------------------------------------------
 bool vtkPVWebApplication::HandleInteractionEvent(
   vtkSMViewProxy* view, vtkWebInteractionEvent* event)
@@ -291,7 +766,8 @@ bool vtkPVWebApplication::HandleInteractionEvent(
 }
 
 // ---------------------------------------------------------------------------
-const char* vtkPVWebApplication::GetWebGLSceneMetaData(vtkSMViewProxy* view)
+const char* vtkPVWebApplication::GetWebGLSceneMetaData(
+  vtkSMViewProxy* view, int lod)
 {
   if (!view)
     {
@@ -309,22 +785,59 @@ const char* vtkPVWebApplication::GetWebGLSceneMetaData(vtkSMViewProxy* view)
     return NULL;
     }
 
+  // An interactive render makes the representations switch to their LOD
+  // geometry when the view decides it is large enough. Otherwise make sure
+  // the full resolution geometry is exported even if the last render was an
+  // interactive one.
+  if (lod)
+    {
+    view->InteractiveRender();
+    }
+  std::vector<std::pair<vtkPVLODActor*, int> > lodActors;
+  vtkCollectionSimpleIterator rit;
+  vtkRendererCollection* renderers = renWin->GetRenderers();
+  renderers->InitTraversal(rit);
+  while (vtkRenderer* renderer = renderers->GetNextRenderer(rit))
+    {
+    vtkActorCollection* actors = renderer->GetActors();
+    vtkCollectionSimpleIterator ait;
+    actors->InitTraversal(ait);
+    while (vtkActor* actor = actors->GetNextActor(ait))
+      {
+      vtkPVLODActor* lodActor = vtkPVLODActor::SafeDownCast(actor);
+      if (lodActor)
+        {
+        lodActors.push_back(std::make_pair(lodActor,
+            lodActor->GetEnableLOD()));
+        lodActor->SetEnableLOD(lod && lodActor->GetEnableLOD()? 1 : 0);
+        }
+      }
+    }
+
   // We use the camera focal point to be the center of rotation
   double centerOfRotation[3];
   vtkCamera *cam = pvRenderView->GetActiveCamera();
   cam->GetFocalPoint(centerOfRotation);
 
-  if(this->Internals->ViewWebGLMap.find(view) ==
+  // Each level of detail has its own exporter so that switching between
+  // them does not make the exporter parse the actors again.
+  vtkInternals::WebGLExporterKey key(view, lod? 1 : 0);
+  if(this->Internals->ViewWebGLMap.find(key) ==
     this->Internals->ViewWebGLMap.end())
     {
-    this->Internals->ViewWebGLMap[view] =
+    this->Internals->ViewWebGLMap[key] =
       vtkSmartPointer<vtkWebGLExporter>::New();
     }
 
-  vtkWebGLExporter* webglExporter = this->Internals->ViewWebGLMap[view];
+  vtkWebGLExporter* webglExporter = this->Internals->ViewWebGLMap[key];
   webglExporter->parseScene(
     renWin->GetRenderers(), view->GetGlobalIDAsString(),VTK_PARSEALL);
 
+  for (size_t cc = 0; cc < lodActors.size(); ++cc)
+    {
+    lodActors[cc].first->SetEnableLOD(lodActors[cc].second);
+    }
+
   vtkInternals::WebGLObjId2IndexMap webglMap;
   for(int i=0; i<webglExporter->GetNumberOfObjects(); ++i)
     {
@@ -333,14 +846,13 @@ const char* vtkPVWebApplication::GetWebGLSceneMetaData(vtkSMViewProxy* view)
       {
       vtkInternals::WebGLObjCacheValue val;
       val.ObjIndex = i;
-      for(int j=0; j<wObj->GetNumberOfParts(); ++j)
-        {
-        val.BinaryParts[j] = "";
-        }
+      val.MD5 = wObj->GetMD5();
       webglMap[wObj->GetId()] = val;
       }
     }
   this->Internals->WebGLExporterObjIdMap[webglExporter] = webglMap;
+  this->Internals->LastWebGLExporter[view] = webglExporter;
+  this->Internals->UpdateWebGLPartsCache(webglExporter);
   webglExporter->SetCenterOfRotation(
         static_cast<float>(centerOfRotation[0]),
       static_cast<float>(centerOfRotation[1]),
@@ -357,8 +869,8 @@ const char* vtkPVWebApplication::GetWebGLBinaryData(
     vtkErrorMacro("No view specified.");
     return NULL;
     }
-  if(this->Internals->ViewWebGLMap.find(view) ==
-    this->Internals->ViewWebGLMap.end())
+  if(this->Internals->LastWebGLExporter.find(view) ==
+    this->Internals->LastWebGLExporter.end())
     {
     if(this->GetWebGLSceneMetaData(view) == NULL)
       {
@@ -367,46 +879,44 @@ const char* vtkPVWebApplication::GetWebGLBinaryData(
       }
     }
 
-  vtkWebGLExporter* webglExporter = this->Internals->ViewWebGLMap[view];
+  vtkWebGLExporter* webglExporter = this->Internals->LastWebGLExporter[view];
   if(webglExporter == NULL)
     {
     vtkErrorMacro("There is no cached WebGL Exporter for: " << view);
     return NULL;
     }
 
-  if(this->Internals->WebGLExporterObjIdMap[webglExporter].size() > 0 &&
-    this->Internals->WebGLExporterObjIdMap[webglExporter].find(id) !=
-    this->Internals->WebGLExporterObjIdMap[webglExporter].end())
+  vtkInternals::WebGLObjId2IndexMap& webglMap =
+    this->Internals->WebGLExporterObjIdMap[webglExporter];
+  vtkInternals::WebGLObjId2IndexMap::iterator iter = webglMap.find(id);
+  if (iter != webglMap.end())
     {
-    vtkInternals::WebGLObjCacheValue* cachedVal =
-      &(this->Internals->WebGLExporterObjIdMap[webglExporter][id]);
-    if(cachedVal->BinaryParts.find(part) != cachedVal->BinaryParts.end())
-      {
-      if(cachedVal->BinaryParts[part].empty())
-        {
-        vtkWebGLObject* obj = webglExporter->GetWebGLObject(cachedVal->ObjIndex);
-        if(obj && obj->isVisible())
-          {
-          // Manage Base64
-          vtkNew<vtkBase64Utilities> base64;
-          unsigned char* output = new unsigned char[obj->GetBinarySize(part)*2];
-          int size = base64->Encode(
-            obj->GetBinaryData(part), obj->GetBinarySize(part), output, false);
-          cachedVal->BinaryParts[part] = std::string((const char *)output, size);
-          delete[] output;
-          }
-        }
-      return cachedVal->BinaryParts[part].c_str();
-      }
+    return this->Internals->GetWebGLBase64Part(iter->second.MD5, part);
     }
 
   return NULL;
 }
 
+//----------------------------------------------------------------------------
+const char* vtkPVWebApplication::GetWebGLBinaryDataByHash(
+  const char* md5, int part)
+{
+  return md5? this->Internals->GetWebGLBase64Part(md5, part) : NULL;
+}
+
+//----------------------------------------------------------------------------
+vtkUnsignedCharArray* vtkPVWebApplication::GetWebGLRawBinaryDataByHash(
+  const char* md5, int part)
+{
+  return md5? this->Internals->GetWebGLPart(md5, part) : NULL;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVWebApplication::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "ImageEncoding: " << this->ImageEncoding << endl;
   os << indent << "ImageCompression: " << this->ImageCompression << endl;
+  os << indent << "NumberOfEncoderThreads: "
+     << this->NumberOfEncoderThreads << endl;
 }
@@ -17,6 +17,13 @@
 // vtkPVWebApplication defines the core interface for a ParaViewWeb application.
 // This exposes methods that make it easier to manage views and rendered images
 // from views.
+//
+// Rendered images are compressed (and encoded) by a pool of worker threads
+// shared by all views. Each view has at most one frame waiting to be
+// compressed: when a newer frame for the same view is pushed before the
+// waiting one was picked up by a worker, the stale frame is dropped. Per-view
+// statistics about the delivered frames are available through
+// GetNumberOfFramesEncoded(), GetAverageFrameLatency(), etc.
 
 #ifndef __vtkPVWebApplication_h
 #define __vtkPVWebApplication_h
@@ -36,7 +43,10 @@ public:
   void PrintSelf(ostream& os, vtkIndent indent);
 
   // Description:
-  // Set the encoding to be used for rendered images.
+  // Set the encoding to be used for images returned by StillRender() and
+  // InteractiveRender(). StillRenderToString() and StillRenderToBinary()
+  // always use ENCODING_BASE64 and ENCODING_NONE respectively, whatever this
+  // is set to, so that clients needing different encodings can share views.
   enum
     {
     ENCODING_NONE=0,
@@ -56,12 +66,29 @@ public:
   vtkSetClampMacro(ImageCompression, int, COMPRESSION_NONE, COMPRESSION_JPEG);
   vtkGetMacro(ImageCompression, int);
 
+  // Description:
+  // Set the number of threads used to compress rendered images. The threads
+  // are started when the first image is rendered, so changing this value
+  // afterwards has no effect. Default is 3.
+  vtkSetClampMacro(NumberOfEncoderThreads, int, 1, 64);
+  vtkGetMacro(NumberOfEncoderThreads, int);
+
   // Description:
   // Render a view and obtain the rendered image.
   vtkUnsignedCharArray* StillRender(vtkSMViewProxy* view, int quality = 100);
   vtkUnsignedCharArray* InteractiveRender(vtkSMViewProxy* view, int quality = 50);
+
+  // Description:
+  // Render a view and obtain the base64 encoded image, or NULL if the image
+  // MTime matches `time`.
   const char* StillRenderToString(vtkSMViewProxy* view, unsigned long time = 0, int quality = 100);
 
+  // Description:
+  // Same as StillRenderToString() but returns the raw (not encoded) image
+  // array itself, to deliver binary images which cannot be returned as
+  // strings.
+  vtkUnsignedCharArray* StillRenderToBinary(vtkSMViewProxy* view, unsigned long time = 0, int quality = 100);
+
   // Description:
   // StillRenderToString() need not necessary returns the most recently rendered
   // image. Use this method to get whether there are any pending images being
@@ -78,6 +105,20 @@ public:
   // Invalidate view cache
   void InvalidateCache(vtkSMViewProxy* view);
 
+  // Description:
+  // Image delivery statistics of a view. The latency of a frame is the time
+  // between the end of its capture and the availability of the compressed
+  // image. Times are in seconds. Dropped frames are frames that were
+  // replaced by a newer frame before being compressed.
+  int GetNumberOfFramesEncoded(vtkSMViewProxy* view);
+  int GetNumberOfFramesDropped(vtkSMViewProxy* view);
+  double GetLastCaptureTime(vtkSMViewProxy* view);
+  double GetLastFrameLatency(vtkSMViewProxy* view);
+  double GetAverageFrameLatency(vtkSMViewProxy* view);
+  double GetMaximumFrameLatency(vtkSMViewProxy* view);
+  double GetAverageEncodeTime(vtkSMViewProxy* view);
+  void ResetImageStatistics(vtkSMViewProxy* view);
+
   // Description:
   // Return the MTime of the last array exported by StillRenderToString.
   vtkGetMacro(LastStillRenderToStringMTime, unsigned long);
@@ -86,7 +127,10 @@ public:
   // Return the Meta data description of the input scene in JSON format.
   // This is using the vtkWebGLExporter to parse the scene.
   // NOTE: This should be called before getting the webGL binary data.
-  const char* GetWebGLSceneMetaData(vtkSMViewProxy* view);
+  // When lod is non-zero, the scene is exported with the decimated geometry
+  // the view uses for interactive renders of large data (see
+  // vtkPVRenderView::LODThreshold) instead of the full resolution one.
+  const char* GetWebGLSceneMetaData(vtkSMViewProxy* view, int lod = 0);
 
   // Description:
   // Return the binary data given the part index
@@ -94,13 +138,30 @@ public:
   const char* GetWebGLBinaryData(
     vtkSMViewProxy* view, const char* id, int partIndex);
 
+  // Description:
+  // Return the data of a part of a WebGL object given the md5 of the object
+  // reported in the scene meta data. Parts are cached by content for all
+  // views, so objects that did not change since a previous export are
+  // neither exported nor encoded again and clients that kept them do not
+  // need to request them. GetWebGLBinaryDataByHash() returns the part base64
+  // encoded while GetWebGLRawBinaryDataByHash() returns the raw bytes.
+  const char* GetWebGLBinaryDataByHash(const char* md5, int partIndex);
+  vtkUnsignedCharArray* GetWebGLRawBinaryDataByHash(
+    const char* md5, int partIndex);
+
 //BTX
 protected:
   vtkPVWebApplication();
   ~vtkPVWebApplication();
 
+  // Description:
+  // Renders the view and returns the image with the given encoding. Only the
+  // cached image of that view is affected by the encoding.
+  vtkUnsignedCharArray* StillRender(vtkSMViewProxy* view, int quality, int encoding);
+
   int ImageEncoding;
   int ImageCompression;
+  int NumberOfEncoderThreads;
   unsigned long LastStillRenderToStringMTime;
 
 private:
@@ -44,10 +44,28 @@ class ParaViewWebProtocol(vtk_protocols.vtkWebProtocol):
 
     def __init__(self):
         self.Application = None
+        self.session = None
         self.multiRoot = False
         self.baseDirectory = ''
         self.baseDirectoryMap = {}
 
+    def setSession(self, session):
+        """
+        Keep track of the WAMP session (server protocol) this protocol is
+        registered with.
+        """
+        self.session = session
+
+    def canSendBinary(self):
+        """
+        Returns True if raw bytes can be sent to the client, which is only the
+        case when the WebSocket subprotocol negotiated with the client uses
+        msgpack. JSON serializers cannot carry binary payloads.
+        """
+        session = getattr(self, 'session', None)
+        subprotocol = getattr(session, 'websocket_protocol_in_use', None)
+        return bool(subprotocol) and 'msgpack' in subprotocol
+
     def mapIdToProxy(self, id):
         """
         Maps global-id for a proxy to the proxy instance. May return None if the
@@ -278,13 +296,28 @@ class ParaViewWebViewPortImageDelivery(ParaViewWebProtocol):
         localTime = 0
         if options and options.has_key("localTime"):
             localTime = options["localTime"]
+        binary = False
+        if options and options.has_key("binary"):
+            binary = options["binary"]
         reply = {}
         app = self.getApplication()
-        reply["image"] = app.StillRenderToString(view.SMProxy, t, quality)
+        compression = app.GetImageCompression()
+        if compression == app.COMPRESSION_JPEG:
+            imageFormat = "jpeg"
+        elif compression == app.COMPRESSION_PNG:
+            imageFormat = "png"
+        else:
+            imageFormat = "rgb"
+        if binary and self.canSendBinary():
+            image = app.StillRenderToBinary(view.SMProxy, t, quality)
+            reply["image"] = str(buffer(image)) if image else None
+            reply["format"] = imageFormat
+        else:
+            reply["image"] = app.StillRenderToString(view.SMProxy, t, quality)
+            reply["format"] = imageFormat + ";base64"
         reply["stale"] = app.GetHasImagesBeingProcessed(view.SMProxy)
         reply["mtime"] = app.GetLastStillRenderToStringMTime()
         reply["size"] = [view.ViewSize[0], view.ViewSize[1]]
-        reply["format"] = "jpeg;base64"
         reply["global_id"] = view.GetGlobalIDAsString()
         reply["localTime"] = localTime
 
@@ -293,6 +326,27 @@ class ParaViewWebViewPortImageDelivery(ParaViewWebProtocol):
 
         return reply
 
+    # RpcName: getImageStatistics => viewport.image.statistics
+    @exportRpc("viewport.image.statistics")
+    def getImageStatistics(self, options):
+        """
+        RPC Callback to obtain the image delivery statistics of a view.
+        Times are in milliseconds.
+        """
+        view = self.getView(options["view"])
+        app = self.getApplication()
+        stats = {}
+        stats["encoded"] = app.GetNumberOfFramesEncoded(view.SMProxy)
+        stats["dropped"] = app.GetNumberOfFramesDropped(view.SMProxy)
+        stats["captureTime"] = 1000 * app.GetLastCaptureTime(view.SMProxy)
+        stats["latency"] = 1000 * app.GetLastFrameLatency(view.SMProxy)
+        stats["averageLatency"] = 1000 * app.GetAverageFrameLatency(view.SMProxy)
+        stats["maximumLatency"] = 1000 * app.GetMaximumFrameLatency(view.SMProxy)
+        stats["averageEncodeTime"] = 1000 * app.GetAverageEncodeTime(view.SMProxy)
+        if options.has_key("reset") and options["reset"]:
+            app.ResetImageStatistics(view.SMProxy)
+        return stats
+
 
 # =============================================================================
 #
@@ -309,9 +363,9 @@ class ParaViewWebViewPortGeometryDelivery(ParaViewWebProtocol):
 
     # RpcName: getSceneMetaData => viewport.webgl.metadata
     @exportRpc("viewport.webgl.metadata")
-    def getSceneMetaData(self, view_id):
+    def getSceneMetaData(self, view_id, lod=False):
         view  = self.getView(view_id);
-        data = self.getApplication().GetWebGLSceneMetaData(view.SMProxy)
+        data = self.getApplication().GetWebGLSceneMetaData(view.SMProxy, 1 if lod else 0)
         return data
 
     # RpcName: getWebGLData => viewport.webgl.data
@@ -321,6 +375,21 @@ class ParaViewWebViewPortGeometryDelivery(ParaViewWebProtocol):
         data = self.getApplication().GetWebGLBinaryData(view.SMProxy, str(object_id), part-1)
         return data
 
+    # RpcName: getWebGLDataByHash => viewport.webgl.data.hash
+    @exportRpc("viewport.webgl.data.hash")
+    def getWebGLDataByHash(self, md5, part, binary=False):
+        """
+        Return a part of an object given the md5 reported in the scene
+        meta-data. Clients should only request objects whose md5 they do not
+        already have. With binary=True the raw bytes are returned instead of
+        their base64 encoding, provided the client negotiated msgpack.
+        """
+        app = self.getApplication()
+        if binary and self.canSendBinary():
+            data = app.GetWebGLRawBinaryDataByHash(str(md5), part-1)
+            return str(buffer(data)) if data else None
+        return app.GetWebGLBinaryDataByHash(str(md5), part-1)
+
     # RpcName: getCachedWebGLData => viewport.webgl.cached.data
     @exportRpc("viewport.webgl.cached.data")
     def getCachedWebGLData(self, sha):
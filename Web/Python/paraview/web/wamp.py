@@ -8,3 +8,8 @@ from vtkParaViewWebCorePython import vtkPVWebApplication
 class PVServerProtocol(wamp.ServerProtocol):
     def initApplication(self):
         return vtkPVWebApplication()
+
+    def registerVtkWebProtocol(self, protocol):
+        wamp.ServerProtocol.registerVtkWebProtocol(self, protocol)
+        if hasattr(protocol, 'setSession'):
+            protocol.setSession(self)